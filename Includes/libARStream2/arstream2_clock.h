@@ -0,0 +1,37 @@
+/**
+ * @file arstream2_clock.h
+ * @brief Parrot Streaming Library - Clock
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_CLOCK_H_
+#define _ARSTREAM2_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#include <inttypes.h>
+
+
+/**
+ * @brief Clock callback function.
+ *
+ * The function replaces the monotonic clock as the time source of an
+ * instance, e.g. to drive simulated time in tests. It must return a
+ * monotonic time in microseconds and can be called concurrently from all
+ * the threads of the instance.
+ *
+ * @param userPtr Clock callback user pointer
+ *
+ * @return the current time in microseconds
+ */
+typedef uint64_t (*ARSTREAM2_Clock_GetTimeCallback_t)(void *userPtr);
+
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* _ARSTREAM2_CLOCK_H_ */
@@ -0,0 +1,153 @@
+/**
+ * @file arstream2_h264_generator.h
+ * @brief Parrot Streaming Library - H.264 Generator
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_H264_GENERATOR_H_
+#define _ARSTREAM2_H264_GENERATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#include <inttypes.h>
+#include <libARStream2/arstream2_error.h>
+#include <libARStream2/arstream2_stream_sender.h>
+
+
+/**
+ * @brief Default I-frame to P-frame size ratio
+ */
+#define ARSTREAM2_H264_GENERATOR_DEFAULT_I_FRAME_SIZE_RATIO (4.0f)
+
+
+/**
+ * @brief H.264 Generator instance handle.
+ */
+typedef void* ARSTREAM2_H264Generator_Handle;
+
+
+/**
+ * @brief H.264 Generator configuration for initialization.
+ *
+ * The generated stream is a valid constrained baseline profile stream:
+ * IDR frames made of gray I-slices followed by P-frames made of skipped
+ * P-slices. Filler data NAL units are added after each slice to reach the
+ * target bitrate.
+ */
+typedef struct
+{
+    int width;                              /**< picture width in pixels */
+    int height;                             /**< picture height in pixels */
+    float framerate;                        /**< framerate in frames per second */
+    int bitrate;                            /**< target bitrate in bit/s (optional, 0 for no padding) */
+    int sliceCount;                         /**< number of slices per frame (optional, 0 for 1) */
+    int gopLength;                          /**< IDR frame period in frames (optional, 0 for a single IDR frame at the start) */
+    int refFrameInterval;                   /**< one P-frame out of refFrameInterval is a reference frame, the others are non-reference frames (optional, 0 for all reference frames) */
+    float iFrameSizeRatio;                  /**< I-frame to P-frame size ratio (optional, 0 for the default value) */
+    int userDataSeiSize;                    /**< size of the user data unregistered SEI in each access unit, including the 16-byte UUID (optional, 0 for no SEI) */
+    int streamingInfoSei;                   /**< add a "Parrot Streaming" v1 user data SEI with the slice layout in each access unit (at most ARSTREAM2_H264_SEI_PARROT_STREAMING_MAX_SLICE_COUNT slices) */
+    int naluPrefix;                         /**< write a NAL unit start code before each NALU in the output buffer */
+
+} ARSTREAM2_H264Generator_Config_t;
+
+
+/**
+ * @brief Initialize an H.264 generator instance.
+ *
+ * The library allocates the required resources. The user must call ARSTREAM2_H264Generator_Free() to free the resources.
+ *
+ * @param generatorHandle Pointer to the handle used in future calls to the library.
+ * @param config The instance configuration.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_Init(ARSTREAM2_H264Generator_Handle* generatorHandle, const ARSTREAM2_H264Generator_Config_t* config);
+
+
+/**
+ * @brief Free an H.264 generator instance.
+ *
+ * The library frees the allocated resources.
+ *
+ * @param generatorHandle Instance handle.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_Free(ARSTREAM2_H264Generator_Handle generatorHandle);
+
+
+/**
+ * @brief Get the maximum access unit size.
+ *
+ * The values are the buffer size and NAL unit descriptor count to provide to
+ * ARSTREAM2_H264Generator_GenerateAu().
+ *
+ * @param[in] generatorHandle Instance handle.
+ * @param[out] maxAuSize Optional pointer to the maximum access unit size in bytes
+ * @param[out] maxNaluCount Optional pointer to the maximum number of NAL units in an access unit
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GetMaxAuSize(ARSTREAM2_H264Generator_Handle generatorHandle, unsigned int *maxAuSize, unsigned int *maxNaluCount);
+
+
+/**
+ * @brief Get the SPS and PPS buffers.
+ *
+ * The buffers are filled by the function and must be provided by the user. The size of the buffers are given
+ * by a first call to the function with both buffer pointers null.
+ * When the buffer pointers are not null the size pointers must point to the values of the user-allocated buffer sizes.
+ * The SPS and PPS are returned without start code.
+ *
+ * @param generatorHandle Instance handle.
+ * @param spsBuffer SPS buffer pointer.
+ * @param spsSize pointer to the SPS size.
+ * @param ppsBuffer PPS buffer pointer.
+ * @param ppsSize pointer to the PPS size.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return ARSTREAM2_ERROR_BAD_PARAMETERS if arguments are invalid.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GetSpsPps(ARSTREAM2_H264Generator_Handle generatorHandle, uint8_t *spsBuffer, int *spsSize, uint8_t *ppsBuffer, int *ppsSize);
+
+
+/**
+ * @brief Generate the next access unit.
+ *
+ * The access unit is written to the output buffer; with the naluPrefix configuration
+ * flag the output is a byte stream that can be written directly to a file.
+ * If nalu is not NULL the NAL unit descriptors are filled so that the access unit
+ * can be sent using ARSTREAM2_StreamSender_SendNNewNalu(); the descriptors point
+ * to the NAL units in the output buffer, without start code.
+ * IDR access units start with the SPS and PPS.
+ *
+ * @param[in] generatorHandle Instance handle.
+ * @param[in] auTimestamp Access unit timestamp in microseconds
+ * @param[in] pbOutputBuf Bitstream output buffer
+ * @param[in] outputBufSize Bitstream output buffer size
+ * @param[out] outputSize Bitstream output size
+ * @param[out] nalu Optional NAL unit descriptor array
+ * @param[in] maxNaluCount NAL unit descriptor array size
+ * @param[out] naluCount Optional pointer to the NAL unit count
+ * @param[out] isIdr Optional pointer to a boolean-like flag set if the access unit is an IDR picture
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return ARSTREAM2_ERROR_BAD_PARAMETERS if arguments are invalid or if the output buffer or descriptor array is too small.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GenerateAu(ARSTREAM2_H264Generator_Handle generatorHandle, uint64_t auTimestamp,
+                                                    uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize,
+                                                    ARSTREAM2_StreamSender_H264NaluDesc_t *nalu, unsigned int maxNaluCount,
+                                                    unsigned int *naluCount, int *isIdr);
+
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef _ARSTREAM2_H264_GENERATOR_H_ */
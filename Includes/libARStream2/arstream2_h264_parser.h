@@ -30,6 +30,7 @@ typedef struct
 {
     int extractUserDataSei;                 /**< enable user data SEI extraction, see ARSTREAM2_H264Parser_GetUserDataSei() */
     int printLogs;                          /**< output parsing logs to stdout */
+    int lazyParsing;                        /**< only parse the syntax elements needed for access unit filtering, see ARSTREAM2_H264Parser_ParseNalu() */
 
 } ARSTREAM2_H264Parser_Config_t;
 
@@ -110,6 +111,53 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_Free(ARSTREAM2_H264Parser_Handle parserHan
 eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_file(ARSTREAM2_H264Parser_Handle parserHandle, FILE* fp, unsigned long long fileSize, unsigned int *naluSize);
 
 
+/**
+ * @brief Open a file for memory-mapped input.
+ *
+ * The file is mapped in memory (as a whole on 64-bit systems, or by sliding windows otherwise) with sequential
+ * access advice. NAL units are then read using the ARSTREAM2_H264Parser_ReadNextNalu_mappedFile() function,
+ * without any copy. The file must be closed using the ARSTREAM2_H264Parser_CloseMappedFile() function.
+ * While a file is opened, the ARSTREAM2_H264Parser_ReadNextNalu_file() and ARSTREAM2_H264Parser_ReadNextNalu_buffer()
+ * functions cannot be used.
+ *
+ * @param parserHandle Instance handle.
+ * @param fileName Path of the file to open.
+ * @param fileSize Optional pointer to the total file size.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_OpenMappedFile(ARSTREAM2_H264Parser_Handle parserHandle, const char *fileName, unsigned long long *fileSize);
+
+
+/**
+ * @brief Close a memory-mapped input file.
+ *
+ * @param parserHandle Instance handle.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_CloseMappedFile(ARSTREAM2_H264Parser_Handle parserHandle);
+
+
+/**
+ * @brief Read the next NAL unit from a memory-mapped file.
+ *
+ * The function finds the next NALU start and end in the file opened with ARSTREAM2_H264Parser_OpenMappedFile().
+ * The NALU shall then be parsed using the ARSTREAM2_H264Parser_ParseNalu() function.
+ *
+ * @param parserHandle Instance handle.
+ * @param naluSize Optional pointer to the NAL unit size.
+ * @param naluPosition Optional pointer to the NAL unit position in the file (following the start code).
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return ARSTREAM2_ERROR_NOT_FOUND if no start code has been found.
+ * @return an eARSTREAM2_ERROR error code if another error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_mappedFile(ARSTREAM2_H264Parser_Handle parserHandle, unsigned int *naluSize, unsigned long long *naluPosition);
+
+
 /**
  * @brief Read the next NAL unit from a buffer.
  *
@@ -148,8 +196,10 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_SetupNalu_buffer(ARSTREAM2_H264Parser_Hand
 /**
  * @brief Parse the NAL unit.
  *
- * The function parses the current NAL unit. A call either to ARSTREAM2_H264Parser_ReadNextNalu_file() or ARSTREAM2_H264Parser_ReadNextNalu_buffer() must have been made 
- * prior to calling this function.
+ * The function parses the current NAL unit. A call either to ARSTREAM2_H264Parser_ReadNextNalu_file(), ARSTREAM2_H264Parser_ReadNextNalu_mappedFile()
+ * or ARSTREAM2_H264Parser_ReadNextNalu_buffer() must have been made prior to calling this function.
+ * If lazyParsing is enabled in the configuration, the slice header parsing stops after frame_num and only the recovery point
+ * and user data SEI payloads are parsed; the rest of the slice header is then parsed on demand by ARSTREAM2_H264Parser_GetSliceContext().
  *
  * @param parserHandle Instance handle.
  * @param readBytes Optional pointer to the number of bytes read.
@@ -178,6 +228,7 @@ uint8_t ARSTREAM2_H264Parser_GetLastNaluType(ARSTREAM2_H264Parser_Handle parserH
  *
  * The function returns the slice info of the last parsed slice. A call to ARSTREAM2_H264Parser_ParseNalu() must have been made prior to calling this function. 
  * This function must only be called if the last NALU type is either 1 or 5 (coded slice).
+ * If the slice header was lazily parsed, the idr_pic_id, slice_qp_delta and disable_deblocking_filter_idc fields are not available.
  *
  * @param parserHandle Instance handle.
  * @param sliceInfo Pointer to the slice info structure to fill.
@@ -263,6 +314,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_GetSpsPpsContext(ARSTREAM2_H264Parser_Hand
  *
  * The function exports the last processed slice context from an H.264 parser.
  * This function must only be called if the last NALU type is either 1 or 5 (coded slice).
+ * If the slice header was lazily parsed, it is fully parsed again on the first call; the NAL unit buffer must therefore
+ * still be valid.
  *
  * @param[in] parserHandle Instance handle.
  * @param[out] sliceContext Pointer to the slice context
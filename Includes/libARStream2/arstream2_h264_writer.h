@@ -72,6 +72,69 @@ typedef struct
 } ARSTREAM2_H264Writer_RecoveryPointSei_t;
 
 
+/**
+ * @brief Sequence parameter set syntax elements.
+ *
+ * num_slice_groups and pic_order_cnt_type 1 are not supported; with the
+ * high profiles the SPS has 8-bit depth and no scaling matrices, and the
+ * VUI only carries the timing info.
+ */
+typedef struct
+{
+    unsigned int profileIdc;                /**< profile_idc syntax element */
+    unsigned int constraintSetFlags;        /**< constraint_set0_flag (MSB) to constraint_set5_flag syntax elements */
+    unsigned int levelIdc;                  /**< level_idc syntax element */
+    unsigned int seqParameterSetId;         /**< seq_parameter_set_id syntax element */
+    unsigned int chromaFormatIdc;           /**< chroma_format_idc syntax element (high profiles only) */
+    unsigned int log2MaxFrameNumMinus4;     /**< log2_max_frame_num_minus4 syntax element */
+    unsigned int picOrderCntType;           /**< pic_order_cnt_type syntax element */
+    unsigned int log2MaxPicOrderCntLsbMinus4; /**< log2_max_pic_order_cnt_lsb_minus4 syntax element */
+    unsigned int maxNumRefFrames;           /**< max_num_ref_frames syntax element */
+    unsigned int gapsInFrameNumValueAllowedFlag; /**< gaps_in_frame_num_value_allowed_flag syntax element */
+    unsigned int picWidthInMbsMinus1;       /**< pic_width_in_mbs_minus1 syntax element */
+    unsigned int picHeightInMapUnitsMinus1; /**< pic_height_in_map_units_minus1 syntax element */
+    unsigned int frameMbsOnlyFlag;          /**< frame_mbs_only_flag syntax element */
+    unsigned int mbAdaptiveFrameFieldFlag;  /**< mb_adaptive_frame_field_flag syntax element */
+    unsigned int direct8x8InferenceFlag;    /**< direct_8x8_inference_flag syntax element */
+    unsigned int frameCroppingFlag;         /**< frame_cropping_flag syntax element */
+    unsigned int frameCropLeftOffset;       /**< frame_crop_left_offset syntax element */
+    unsigned int frameCropRightOffset;      /**< frame_crop_right_offset syntax element */
+    unsigned int frameCropTopOffset;        /**< frame_crop_top_offset syntax element */
+    unsigned int frameCropBottomOffset;     /**< frame_crop_bottom_offset syntax element */
+    unsigned int vuiParametersPresentFlag;  /**< vui_parameters_present_flag syntax element */
+    unsigned int timingInfoPresentFlag;     /**< timing_info_present_flag syntax element */
+    unsigned int numUnitsInTick;            /**< num_units_in_tick syntax element */
+    unsigned int timeScale;                 /**< time_scale syntax element */
+    unsigned int fixedFrameRateFlag;        /**< fixed_frame_rate_flag syntax element */
+
+} ARSTREAM2_H264Writer_Sps_t;
+
+
+/**
+ * @brief Picture parameter set syntax elements.
+ *
+ * Slice groups are not supported (num_slice_groups_minus1 is 0).
+ */
+typedef struct
+{
+    unsigned int picParameterSetId;         /**< pic_parameter_set_id syntax element */
+    unsigned int seqParameterSetId;         /**< seq_parameter_set_id syntax element */
+    unsigned int entropyCodingModeFlag;     /**< entropy_coding_mode_flag syntax element */
+    unsigned int bottomFieldPicOrderInFramePresentFlag; /**< bottom_field_pic_order_in_frame_present_flag syntax element */
+    unsigned int numRefIdxL0DefaultActiveMinus1; /**< num_ref_idx_l0_default_active_minus1 syntax element */
+    unsigned int numRefIdxL1DefaultActiveMinus1; /**< num_ref_idx_l1_default_active_minus1 syntax element */
+    unsigned int weightedPredFlag;          /**< weighted_pred_flag syntax element */
+    unsigned int weightedBipredIdc;         /**< weighted_bipred_idc syntax element */
+    int picInitQpMinus26;                   /**< pic_init_qp_minus26 syntax element */
+    int picInitQsMinus26;                   /**< pic_init_qs_minus26 syntax element */
+    int chromaQpIndexOffset;                /**< chroma_qp_index_offset syntax element */
+    unsigned int deblockingFilterControlPresentFlag; /**< deblocking_filter_control_present_flag syntax element */
+    unsigned int constrainedIntraPredFlag;  /**< constrained_intra_pred_flag syntax element */
+    unsigned int redundantPicCntPresentFlag; /**< redundant_pic_cnt_present_flag syntax element */
+
+} ARSTREAM2_H264Writer_Pps_t;
+
+
 /**
  * @brief Initialize an H.264 writer instance.
  *
@@ -103,6 +166,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_Free(ARSTREAM2_H264Writer_Handle writerHan
  * @brief Sets the Writer SPS and PPS context.
  *
  * The function imports SPS and PPS context from an H.264 parser.
+ * The cached gray I-slice and skipped P-slice templates are invalidated.
  *
  * @param[in] writerHandle Instance handle.
  * @param[in] spsContext SPS context to use (from an H.264 parser)
@@ -114,6 +178,46 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_Free(ARSTREAM2_H264Writer_Handle writerHan
 eARSTREAM2_ERROR ARSTREAM2_H264Writer_SetSpsPpsContext(ARSTREAM2_H264Writer_Handle writerHandle, const void *spsContext, const void *ppsContext);
 
 
+/**
+ * @brief Write an SPS NAL unit.
+ *
+ * The function writes a sequence parameter set NAL unit (nal_ref_idc = 3).
+ * The writer SPS context is not changed: use ARSTREAM2_H264Writer_SetSpsPpsContext()
+ * with the context from an H.264 parser to write slices.
+ *
+ * @param[in] writerHandle Instance handle.
+ * @param[in] sps SPS syntax elements
+ * @param[in] pbOutputBuf Bitstream output buffer
+ * @param[in] outputBufSize Bitstream output buffer size
+ * @param[out] outputSize Bitstream output size
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSpsNalu(ARSTREAM2_H264Writer_Handle writerHandle, const ARSTREAM2_H264Writer_Sps_t *sps,
+                                                   uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
+
+
+/**
+ * @brief Write a PPS NAL unit.
+ *
+ * The function writes a picture parameter set NAL unit (nal_ref_idc = 3).
+ * The writer PPS context is not changed: use ARSTREAM2_H264Writer_SetSpsPpsContext()
+ * with the context from an H.264 parser to write slices.
+ *
+ * @param[in] writerHandle Instance handle.
+ * @param[in] pps PPS syntax elements
+ * @param[in] pbOutputBuf Bitstream output buffer
+ * @param[in] outputBufSize Bitstream output buffer size
+ * @param[out] outputSize Bitstream output size
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WritePpsNalu(ARSTREAM2_H264Writer_Handle writerHandle, const ARSTREAM2_H264Writer_Pps_t *pps,
+                                                   uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
+
+
 /**
  * @brief Write a SEI NAL unit.
  *
@@ -144,6 +248,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSeiNalu(ARSTREAM2_H264Writer_Handle w
  * @brief Write a gray I-slice NAL unit.
  *
  * The function writes an entirely gray I-slice NAL unit.
+ * The slice is serialized once per slice context and SPS/PPS and cached;
+ * subsequent calls only patch frame_num, idr_pic_id and pic_order_cnt_lsb.
  *
  * @param[in] writerHandle Instance handle.
  * @param[in] firstMbInSlice Slice first macroblock index
@@ -163,6 +269,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_H
  * @brief Write a skipped P-slice NAL unit.
  *
  * The function writes an entirely skipped P-slice NAL unit.
+ * The slice is serialized once per slice context and SPS/PPS and cached;
+ * subsequent calls only patch frame_num, idr_pic_id and pic_order_cnt_lsb.
  *
  * @param[in] writerHandle Instance handle.
  * @param[in] firstMbInSlice Slice first macroblock index
@@ -178,6 +286,74 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_H
 eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSkippedPSliceNalu(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
 
 
+/**
+ * @brief Write a gray I-slice template.
+ *
+ * The function writes a self-contained template of an entirely gray I-slice NAL unit.
+ * The template can be stored (e.g. on disk) and later output using
+ * ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate() without any SPS/PPS context.
+ *
+ * @param[in] writerHandle Instance handle.
+ * @param[in] firstMbInSlice Slice first macroblock index
+ * @param[in] sliceMbCount Slice macroblock count
+ * @param[in] sliceContext Slice context to use (from an H.264 parser)
+ * @param[in] pbOutputBuf Template output buffer
+ * @param[in] outputBufSize Template output buffer size
+ * @param[out] outputSize Template output size
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceTemplate(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
+
+
+/**
+ * @brief Write a skipped P-slice template.
+ *
+ * The function writes a self-contained template of an entirely skipped P-slice NAL unit.
+ * The template can be output using ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate()
+ * without any SPS/PPS context.
+ *
+ * @param[in] writerHandle Instance handle.
+ * @param[in] firstMbInSlice Slice first macroblock index
+ * @param[in] sliceMbCount Slice macroblock count
+ * @param[in] sliceContext Slice context to use (from an H.264 parser)
+ * @param[in] pbOutputBuf Template output buffer
+ * @param[in] outputBufSize Template output buffer size
+ * @param[out] outputSize Template output size
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSkippedPSliceTemplate(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
+
+
+/**
+ * @brief Write a slice NAL unit from a template.
+ *
+ * The function writes a slice NAL unit from a template created by ARSTREAM2_H264Writer_WriteGrayISliceTemplate()
+ * or ARSTREAM2_H264Writer_WriteSkippedPSliceTemplate(),
+ * patching the frame_num, idr_pic_id and pic_order_cnt_lsb values.
+ * The idr_pic_id Exp-Golomb code length must be the same as in the template.
+ *
+ * @param[in] writerHandle Instance handle.
+ * @param[in] pbTemplate Template buffer
+ * @param[in] templateSize Template size
+ * @param[in] frameNum frame_num value
+ * @param[in] idrPicId idr_pic_id value (IDR slices only)
+ * @param[in] picOrderCntLsb pic_order_cnt_lsb value (pic_order_cnt_type 0 only)
+ * @param[in] pbOutputBuf Bitstream output buffer
+ * @param[in] outputBufSize Bitstream output buffer size
+ * @param[out] outputSize Bitstream output size
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate(ARSTREAM2_H264Writer_Handle writerHandle, const uint8_t *pbTemplate, unsigned int templateSize,
+                                                                unsigned int frameNum, unsigned int idrPicId, unsigned int picOrderCntLsb,
+                                                                uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize);
+
+
 /**
  * @brief Rewrite a non-ref P-slice NAL unit.
  *
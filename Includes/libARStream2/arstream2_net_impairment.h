@@ -0,0 +1,54 @@
+/**
+ * @file arstream2_net_impairment.h
+ * @brief Parrot Streaming Library - Network Impairment Emulation
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_NET_IMPAIRMENT_H_
+#define _ARSTREAM2_NET_IMPAIRMENT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#include <inttypes.h>
+
+
+/**
+ * @brief Default maximum number of packets held by the impairment stage
+ */
+#define ARSTREAM2_NET_IMPAIRMENT_DEFAULT_QUEUE_SIZE (1024)
+
+
+/**
+ * @brief Network impairment emulation configuration.
+ *
+ * The impairments are applied to each packet in order: random loss, burst
+ * loss, duplication, rate limitation, then delay with jitter and reordering.
+ * All random decisions are drawn from a generator initialized with the seed:
+ * the same seed and the same packet sequence give the same impairments.
+ * This is intended for testing and benchmarking only.
+ */
+typedef struct ARSTREAM2_NetImpairment_Config_s
+{
+    uint32_t seed;                                  /**< Random generator seed */
+    float lossProbability;                          /**< Random loss probability for each packet (0.0 to 1.0) */
+    float burstStartProbability;                    /**< Gilbert-Elliott model probability to go from the good to the bad state for each packet (0 to disable burst loss) */
+    float burstEndProbability;                      /**< Gilbert-Elliott model probability to go from the bad to the good state for each packet */
+    float burstLossProbability;                     /**< Gilbert-Elliott model loss probability in the bad state */
+    float duplicateProbability;                     /**< Probability to send a packet twice */
+    uint32_t delayUs;                               /**< Fixed delay in microseconds */
+    uint32_t jitterUs;                              /**< Maximum random delay in microseconds added to the fixed delay; the packet order is kept */
+    float reorderProbability;                       /**< Probability for a packet to skip the delay and overtake the delayed packets (only effective with a delay) */
+    uint32_t rateLimit;                             /**< Link rate in bit/s, the packets are serialized at this rate (optional, 0 for no limit) */
+    uint32_t queueSize;                             /**< Maximum number of packets held, the packets beyond are dropped (optional, 0 for the default value) */
+
+} ARSTREAM2_NetImpairment_Config_t;
+
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* _ARSTREAM2_NET_IMPAIRMENT_H_ */
@@ -15,6 +15,9 @@ extern "C" {
 #include <inttypes.h>
 #include <libARStream2/arstream2_error.h>
 #include <libARStream2/arstream2_stream_stats.h>
+#include <libARStream2/arstream2_net_impairment.h>
+#include <libARStream2/arstream2_clock.h>
+#include <libARStream2/arstream2_stream_receiver_engine.h>
 #include <libARSAL/ARSAL_Socket.h>
 
 
@@ -194,6 +197,7 @@ typedef struct
     int clientStreamPort;                           /**< Client stream port */
     int clientControlPort;                          /**< Client control port */
     eARSAL_SOCKET_CLASS_SELECTOR classSelector;     /**< Type of Service class selector */
+    uint32_t serverSsrc;                            /**< Server stream SSRC (only used with an engine sharded ingest steered by SSRC or with a shared transport) */
 
 } ARSTREAM2_StreamReceiver_NetConfig_t;
 
@@ -229,7 +233,25 @@ typedef struct
     int replaceStartCodesWithNaluSize;              /**< if true, replace the NAL units start code with the NALU size */
     int generateSkippedPSlices;                     /**< if true, generate skipped P slices to replace missing slices for pre-decoder error concealment */
     int generateFirstGrayIFrame;                    /**< if true, generate a first gray IDR frame to initialize the decoding (waitForSync must be enabled) */
+    const char *grayIFrameCachePath;                /**< Optional directory where the gray IDR frame is persisted per SPS/PPS for the next sessions (optional, can be NULL) */
     const char *debugPath;                          /**< Optional path for writing debug files (optional, can be NULL) */
+    int filterThread;                               /**< if true, run the H.264 filter in a dedicated thread fed through a bounded queue instead of in the network thread (not supported with an engine or a shared transport) */
+    int filterQueueMaxSize;                         /**< Maximum number of access units waiting for the filter thread (optional, 0 for the default value) */
+    ARSTREAM2_StreamReceiverEngine_Handle engine;   /**< Engine whose worker threads run the instance (optional, can be NULL; not supported with libmux; filterThread is ignored: the filter runs in the worker) */
+    ARSTREAM2_StreamReceiver_Handle transport;      /**< Instance whose sockets are shared, the streams being demultiplexed by serverSsrc (optional, can be NULL; the net config addresses and ports are then ignored; not supported with an engine or libmux; filterThread is ignored: the filter runs in the transport instance network thread) */
+    int recorderDirectIo;                           /**< if true, the recorder writes the files with direct I/O (O_DIRECT), bypassing the page cache */
+    int recorderWriteBatchSize;                     /**< Recorder write batch size in bytes (optional, 0 for the default value) */
+    int recorderSyncIntervalMs;                     /**< Maximum interval between two recorder data syncs in milliseconds (optional, 0 for the default value, -1 to disable) */
+    int recorderSyncByteBudget;                     /**< Maximum amount of recorded data between two data syncs in bytes (optional, 0 for the default value, -1 to disable) */
+    int recorderSegmentDurationMs;                  /**< Recording segment duration in milliseconds (optional, 0 to disable time-based segmentation) */
+    int recorderSegmentMaxSize;                     /**< Maximum recording segment size in bytes (optional, 0 to disable size-based segmentation) */
+    uint64_t recorderDiskQuota;                     /**< Maximum size of the recording segments kept on disk in bytes, the oldest segments are deleted (optional, 0 for no limit, only used with segmentation) */
+    int recorderPreEventDurationMs;                 /**< Duration of the stream kept in memory while not recording and written at the start of the next recording in milliseconds (optional, 0 to disable) */
+    int recorderPreEventByteBudget;                 /**< Maximum amount of memory held by the pre-event access units in bytes (optional, 0 for the default value) */
+    const char *rtpCaptureFileName;                 /**< pcapng capture file of the received RTP and RTCP packets (optional, NULL to disable) */
+    const ARSTREAM2_NetImpairment_Config_t *impairment;  /**< Network impairment emulation on the received RTP packets, for testing only (optional, can be NULL; ignored with a transport instance) */
+    ARSTREAM2_Clock_GetTimeCallback_t clockCallback;  /**< Time source of the instance, e.g. for simulated-time testing (optional, NULL for the monotonic clock) */
+    void *clockCallbackUserPtr;                     /**< Clock callback user pointer (optional, can be NULL) */
 
 } ARSTREAM2_StreamReceiver_Config_t;
 
@@ -275,6 +297,40 @@ typedef struct ARSTREAM2_StreamReceiver_UntimedMetadata_t
 } ARSTREAM2_StreamReceiver_UntimedMetadata_t;
 
 
+/**
+ * @brief Number of recorder latency histogram buckets.
+ *
+ * Bucket 0 counts the latencies below 1 ms, bucket i counts the latencies
+ * in [2^(i-1), 2^i[ ms and the last bucket counts all the longer latencies.
+ */
+#define ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT (12)
+
+
+/**
+ * @brief ARSTREAM2 StreamReceiver pipeline queue statistics.
+ */
+typedef struct ARSTREAM2_StreamReceiver_PipelineStats_t
+{
+    int filterQueueDepth;                           /**< Number of access units waiting for the filter thread (always 0 if the filter runs in the network thread) */
+    int filterQueuePeakDepth;                       /**< Maximum filter queue depth since the previous call */
+    uint32_t filterQueueDropCount;                  /**< Number of access units dropped because the filter queue was full */
+    int appOutputQueueDepth;                        /**< Number of access units waiting for the application output thread */
+    int appOutputQueuePeakDepth;                    /**< Maximum application output queue depth since the previous call */
+    int recorderQueueDepth;                         /**< Number of access units waiting for the recorder thread */
+    int recorderQueuePeakDepth;                     /**< Maximum recorder queue depth since the previous call */
+    uint64_t recorderBytesWritten;                  /**< Number of bytes written to the record file */
+    int recorderPendingWriteCount;                  /**< Number of record file write batches in progress */
+    int recorderPendingWritePeakCount;              /**< Maximum number of record file write batches in progress since the previous call */
+    uint32_t recorderStallCount;                    /**< Number of times the recorder waited for a write batch to complete */
+    uint32_t recorderWriteLatencyHistogram[ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT];  /**< Record file write batch latency histogram, @see ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT */
+    uint32_t recorderSyncLatencyHistogram[ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT];   /**< Record file data sync latency histogram, @see ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT */
+    int recorderPreEventAuCount;                    /**< Number of access units held in the pre-event buffer */
+    uint32_t recorderPreEventDurationMs;            /**< Duration of the stream held in the pre-event buffer in milliseconds */
+    uint64_t recorderPreEventByteCount;             /**< Size of the access units held in the pre-event buffer in bytes */
+
+} ARSTREAM2_StreamReceiver_PipelineStats_t;
+
+
 /**
  * @brief Initialize a StreamReceiver instance.
  *
@@ -315,6 +371,7 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Stop(ARSTREAM2_StreamReceiver_Handle s
  * @param streamReceiverHandle Pointer to the instance handle.
  *
  * @return ARSTREAM2_OK if no error occurred.
+ * @return ARSTREAM2_ERROR_BUSY if other instances still share the instance transport.
  * @return an eARSTREAM2_ERROR error code if an error occurred.
  */
 eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *streamReceiverHandle);
@@ -324,6 +381,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
  * @brief Run a StreamReceiver stream thread.
  *
  * The instance must be correctly allocated using ARSTREAM2_StreamReceiver_Init().
+ * If the instance is run by an engine or shares the transport of another instance,
+ * the function returns immediately; the transport instance network thread then
+ * also processes the instances sharing its sockets.
  * @warning This function never returns until ARSTREAM2_StreamReceiver_Stop() is called. The tread can then be joined.
  *
  * @param streamReceiverHandle Instance handle casted as (void*).
@@ -333,6 +393,23 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
 void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle);
 
 
+/**
+ * @brief Get the StreamReceiver pipeline queue statistics.
+ *
+ * The function returns the current and peak depths of the queues between the
+ * network, filter, application output and recorder stages, as well as the
+ * recorder file write latencies.
+ * The peak depths are reset on each call.
+ *
+ * @param streamReceiverHandle Instance handle.
+ * @param stats Pointer to the statistics structure to fill.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_GetPipelineStats(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, ARSTREAM2_StreamReceiver_PipelineStats_t *stats);
+
+
 /**
  * @brief Start the application output.
  *
@@ -375,6 +452,12 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StopAppOutput(ARSTREAM2_StreamReceiver
  * @brief Run a StreamReceiver application output thread.
  *
  * The instance must be correctly allocated using ARSTREAM2_StreamReceiver_Init().
+ * If the instance is run by an engine or shares the transport of another
+ * instance the function is optional: when it is not called the application
+ * output callbacks are called from the engine worker thread or the transport
+ * instance network thread (sequentially with the other instances it runs);
+ * when it is called the callbacks are called from this thread and a slow
+ * application only delays this instance.
  * @warning This function never returns until ARSTREAM2_StreamReceiver_Stop() is called. The tread can then be joined.
  *
  * @param streamReceiverHandle Instance handle casted as (void*).
@@ -390,6 +473,14 @@ void* ARSTREAM2_StreamReceiver_RunAppOutputThread(void *streamReceiverHandle);
  * The function starts recording the received stream to a file.
  * The recording can be stopped using ARSTREAM2_StreamReceiver_StopRecording().
  * The filter must be previously started using ARSTREAM2_StreamReceiver_StartAppOutput().
+ * Files with a ".mp4" extension are written as fragmented MP4 files which are readable
+ * while recording; files with a ".264" or ".h264" extension are written as H.264 byte streams.
+ * If segmentation is enabled (recorderSegmentDurationMs or recorderSegmentMaxSize), the
+ * recording is split at sync frames into files named after recordFileName with a segment
+ * index before the extension (e.g. "rec_0000.mp4", "rec_0001.mp4").
+ * If the pre-event buffer is enabled (recorderPreEventDurationMs), the recording starts
+ * with the buffered access units, from the oldest buffered sync frame; the buffered access
+ * units are written by the recorder thread and the function does not wait for the writes.
  * @note Only one recording can be done at a time.
  *
  * @param streamReceiverHandle Instance handle.
@@ -420,6 +511,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StopRecorder(ARSTREAM2_StreamReceiver_
  *
  * The library allocates the required resources. The user must call ARSTREAM2_StreamReceiver_StopResender()
  * to free the resources.
+ * All the resenders share a single thread which sends each received packet to every
+ * destination in one batch: the packets are handed over without copy and late
+ * resenders drop packets instead of slowing down the reception.
  *
  * @param streamReceiverHandle StreamReceiver instance handle.
  * @param streamResenderHandle Pointer to the resender handle used in future calls to the library.
@@ -0,0 +1,102 @@
+/**
+ * @file arstream2_stream_receiver_engine.h
+ * @brief Parrot Streaming Library - Stream Receiver Engine
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_STREAM_RECEIVER_ENGINE_H_
+#define _ARSTREAM2_STREAM_RECEIVER_ENGINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* #ifdef __cplusplus */
+
+#include <inttypes.h>
+#include <libARStream2/arstream2_error.h>
+
+
+/**
+ * @brief ARSTREAM2 StreamReceiverEngine instance handle.
+ *
+ * An engine owns a pool of worker threads shared by several StreamReceiver
+ * instances. Each StreamReceiver registered with an engine (@see the engine
+ * field of ARSTREAM2_StreamReceiver_Config_t) is assigned to one worker for
+ * its whole life; the worker handles its sockets, RTCP timers, H.264 filter
+ * and application output. The number of threads therefore depends on the
+ * number of workers rather than on the number of streams.
+ */
+typedef struct ARSTREAM2_StreamReceiverEngine_s *ARSTREAM2_StreamReceiverEngine_Handle;
+
+
+/**
+ * @brief Sharded ingest steering modes.
+ *
+ * With sharded ingest each worker owns a socket bound with SO_REUSEPORT to the
+ * shared ingest port. A kernel steering program distributes the incoming RTP
+ * packets among the sockets so that all the packets of a stream reach the worker
+ * that runs the corresponding StreamReceiver instance.
+ */
+typedef enum
+{
+    ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SOURCE = 0, /**< Steer by source address and port (serverAddr and serverStreamPort of the receiver net config) */
+    ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SSRC,       /**< Steer by RTP SSRC (serverSsrc of the receiver net config) */
+    ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_MAX,
+
+} eARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING;
+
+
+/**
+ * @brief ARSTREAM2 StreamReceiverEngine configuration for initialization.
+ */
+typedef struct
+{
+    int workerCount;                                /**< Number of worker threads (optional, 0 for the number of online CPUs) */
+    int ingestPort;                                 /**< Shared client stream port for sharded ingest (optional, 0 for one stream socket per receiver) */
+    eARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING ingestSteering; /**< Sharded ingest steering mode (only used if ingestPort is not 0) */
+
+} ARSTREAM2_StreamReceiverEngine_Config_t;
+
+
+/**
+ * @brief Initialize a StreamReceiverEngine instance.
+ *
+ * The library allocates the required resources and starts the worker threads.
+ * The user must call ARSTREAM2_StreamReceiverEngine_Free() to free the resources.
+ *
+ * If an ingest port is configured, the RTP packets of all the receivers registered
+ * with the engine are received on that port (the clientStreamPort of the receivers is
+ * not used) and demultiplexed to the receivers according to the steering mode.
+ * If the kernel steering program cannot be attached, a single ingest socket is used
+ * and all the receivers are run by the first worker.
+ *
+ * @param engineHandle Pointer to the handle used in future calls to the library.
+ * @param config The instance configuration.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiverEngine_Init(ARSTREAM2_StreamReceiverEngine_Handle *engineHandle,
+                                                     const ARSTREAM2_StreamReceiverEngine_Config_t *config);
+
+
+/**
+ * @brief Free a StreamReceiverEngine instance.
+ *
+ * The function stops and joins the worker threads and frees the allocated resources.
+ * All the StreamReceiver instances registered with the engine must have been freed before.
+ * On success the engineHandle is set to NULL.
+ *
+ * @param engineHandle Pointer to the instance handle.
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiverEngine_Free(ARSTREAM2_StreamReceiverEngine_Handle *engineHandle);
+
+
+#ifdef __cplusplus
+}
+#endif /* #ifdef __cplusplus */
+
+#endif /* #ifndef _ARSTREAM2_STREAM_RECEIVER_ENGINE_H_ */
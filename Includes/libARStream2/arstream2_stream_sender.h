@@ -15,6 +15,8 @@ extern "C" {
 #include <inttypes.h>
 #include <libARStream2/arstream2_error.h>
 #include <libARStream2/arstream2_stream_stats.h>
+#include <libARStream2/arstream2_net_impairment.h>
+#include <libARStream2/arstream2_clock.h>
 #include <libARSAL/ARSAL_Socket.h>
 
 
@@ -184,6 +186,11 @@ typedef struct ARSTREAM2_StreamSender_Config_t
     int maxNetworkLatencyMs[ARSTREAM2_STREAM_SENDER_MAX_IMPORTANCE_LEVELS];  /**< Maximum acceptable network latency in milliseconds for each NALU importance level */
     int useRtpHeaderExtensions;                     /**< Boolean-like (0-1) flag: if active insert access unit metadata as RTP header extensions */
     const char *debugPath;                          /**< Optional path for writing debug files (optional, can be NULL) */
+    uint32_t ssrc;                                  /**< RTP synchronization source identifier (optional, 0 for default) */
+    ARSTREAM2_StreamSender_Handle transport;        /**< Instance whose socket pair is shared, the streams being multiplexed by SSRC (optional, can be NULL; the addresses and ports are then ignored) */
+    const ARSTREAM2_NetImpairment_Config_t *impairment;  /**< Network impairment emulation on the sent RTP packets, for testing only (optional, can be NULL; ignored with a transport instance) */
+    ARSTREAM2_Clock_GetTimeCallback_t clockCallback;  /**< Time source of the instance, e.g. for simulated-time testing (the access unit timestamps and input times must use the same timebase) (optional, NULL for the monotonic clock) */
+    void *clockCallbackUserPtr;                     /**< Clock callback user pointer (optional, can be NULL) */
 
 } ARSTREAM2_StreamSender_Config_t;
 
@@ -276,6 +283,7 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Stop(ARSTREAM2_StreamSender_Handle strea
  *
  * @return ARSTREAM2_OK if the sender was deleted
  * @return ARSTREAM2_ERROR_BUSY if the sender is still busy and can not be stopped now (probably because ARSTREAM2_StreamSender_Stop() has not been called yet)
+ * or if other instances still share its transport
  * @return ARSTREAM2_ERROR_BAD_PARAMETERS if sender does not point to a valid ARSTREAM2_StreamSender_t
  *
  * @note The function uses a double pointer, so it can set *sender to NULL after freeing it
@@ -333,6 +341,8 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_FlushNaluQueue(ARSTREAM2_StreamSender_Ha
  * @brief Runs the main loop of the StreamSender
  * @warning This function never returns until ARSTREAM2_StreamSender_Stop() is called. Thus, it should be called on its own thread.
  * @post Stop the Sender by calling ARSTREAM2_StreamSender_Stop() before joining the thread calling this function.
+ * If the instance shares the transport of another instance, the function returns immediately
+ * and the packets are sent from the thread of the transport instance.
  *
  * @param[in] ARSTREAM2_StreamSender_t_Param A valid (ARSTREAM2_StreamSender_t *) casted as a (void *)
  */
@@ -13,8 +13,7 @@ LOCAL_LIBRARIES := \
 
 LOCAL_CONDITIONAL_LIBRARIES := \
 	OPTIONAL:libmux \
-	OPTIONAL:libpomp \
-	OPTIONAL:libARMedia
+	OPTIONAL:libpomp
 
 LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/Includes \
@@ -25,13 +24,19 @@ LOCAL_CFLAGS := \
 
 LOCAL_SRC_FILES := \
 	gen/Sources/arstream2_error.c \
+	src/arstream2_file_writer.c \
 	src/arstream2_h264_filter.c \
 	src/arstream2_h264_filter_error.c \
+	src/arstream2_h264_generator.c \
 	src/arstream2_h264_parser.c \
 	src/arstream2_h264_sei.c \
 	src/arstream2_h264_writer.c \
 	src/arstream2_h264.c \
+	src/arstream2_mp4_writer.c \
+	src/arstream2_net_impairment.c \
+	src/arstream2_pcap.c \
 	src/arstream2_rtp_receiver.c \
+	src/arstream2_rtp_resender.c \
 	src/arstream2_rtp_sender.c \
 	src/arstream2_rtp.c \
 	src/arstream2_rtp_h264.c \
@@ -39,15 +44,20 @@ LOCAL_SRC_FILES := \
 	src/arstream2_stream_recorder.c \
 	src/arstream2_stream_stats.c \
 	src/arstream2_stream_sender.c \
-	src/arstream2_stream_receiver.c
+	src/arstream2_stream_receiver.c \
+	src/arstream2_stream_receiver_engine.c
 
 LOCAL_INSTALL_HEADERS := \
+	Includes/libARStream2/arstream2_clock.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_error.h:usr/include/libARStream2/ \
+	Includes/libARStream2/arstream2_h264_generator.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_h264_parser.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_h264_sei.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_h264_writer.h:usr/include/libARStream2/ \
+	Includes/libARStream2/arstream2_net_impairment.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_stream_sender.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_stream_receiver.h:usr/include/libARStream2/ \
+	Includes/libARStream2/arstream2_stream_receiver_engine.h:usr/include/libARStream2/ \
 	Includes/libARStream2/arstream2_stream_stats.h:usr/include/libARStream2/
 
 
@@ -59,6 +69,7 @@ ifeq ("$(TARGET_OS)","linux")
     endif
   else
     LOCAL_CFLAGS += -DHAS_MMSG
+    LOCAL_CFLAGS += -DHAS_IO_URING
   endif
 endif
 
@@ -0,0 +1,55 @@
+/**
+ * @file arstream2_clock_internal.h
+ * @brief Parrot Streaming Library - Clock
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_CLOCK_INTERNAL_H_
+#define _ARSTREAM2_CLOCK_INTERNAL_H_
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <time.h>
+
+#include <libARSAL/ARSAL_Time.h>
+
+#include <libARStream2/arstream2_clock.h>
+
+
+/**
+ * @brief Time source.
+ *
+ * A zeroed structure selects the monotonic clock.
+ */
+typedef struct ARSTREAM2_Clock_s
+{
+    ARSTREAM2_Clock_GetTimeCallback_t getTime;      /**< Clock callback function (NULL for the monotonic clock) */
+    void *userPtr;                                  /**< Clock callback user pointer */
+
+} ARSTREAM2_Clock_t;
+
+
+/**
+ * @brief Get the current time.
+ *
+ * @param clock The time source
+ *
+ * @return the current time in microseconds
+ */
+static inline uint64_t ARSTREAM2_Clock_GetTime(const ARSTREAM2_Clock_t *clock)
+{
+    struct timespec t1;
+
+    if (clock->getTime)
+    {
+        return clock->getTime(clock->userPtr);
+    }
+
+    ARSAL_Time_GetTime(&t1);
+    return (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+}
+
+
+#endif /* _ARSTREAM2_CLOCK_INTERNAL_H_ */
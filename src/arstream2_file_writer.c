@@ -0,0 +1,941 @@
+/**
+ * @file arstream2_file_writer.c
+ * @brief Parrot Streaming Library - Asynchronous File Writer
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#define __USE_GNU
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(HAS_IO_URING) && !defined(__NR_io_uring_setup)
+#undef HAS_IO_URING
+#endif
+#ifdef HAS_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+
+#include "arstream2_file_writer.h"
+
+
+#define ARSTREAM2_FILE_WRITER_TAG "ARSTREAM2_FileWriter"
+
+/* request index of a data sync, write requests use the batch buffer index */
+#define ARSTREAM2_FILE_WRITER_SYNC_REQUEST (-1)
+
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+
+static uint64_t ARSTREAM2_FileWriter_GetTime(void)
+{
+    struct timespec t1;
+    ARSAL_Time_GetTime(&t1);
+    return (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+}
+
+
+static void ARSTREAM2_FileWriter_UpdateHistogram(uint32_t *histogram, uint64_t latencyUs)
+{
+    uint64_t latencyMs = latencyUs / 1000;
+    int i = 0;
+
+    while ((latencyMs > 0) && (i < ARSTREAM2_FILE_WRITER_LATENCY_BUCKET_COUNT - 1))
+    {
+        latencyMs >>= 1;
+        i++;
+    }
+    histogram[i]++;
+}
+
+
+/* must be called with the mutex held */
+static void ARSTREAM2_FileWriter_Complete(ARSTREAM2_FileWriter_t *writer, int index, int result, uint64_t curTime)
+{
+    if (index == ARSTREAM2_FILE_WRITER_SYNC_REQUEST)
+    {
+        writer->syncInProgress = 0;
+        if (result < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Data sync failed (%d): %s", -result, strerror(-result));
+            writer->error = 1;
+        }
+        else
+        {
+            writer->stats.syncCount++;
+            ARSTREAM2_FileWriter_UpdateHistogram(writer->stats.syncLatencyHistogram, curTime - writer->syncSubmitTime);
+        }
+    }
+    else if ((index >= 0) && (index < writer->bufferCount))
+    {
+        ARSTREAM2_FileWriter_Buffer_t *buffer = &writer->buffer[index];
+        buffer->inProgress = 0;
+        writer->stats.pendingWriteCount--;
+        if (result < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Write failed (%d): %s", -result, strerror(-result));
+            writer->error = 1;
+        }
+        else if ((size_t)result != buffer->writeSize)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Short write (%d bytes out of %zu)", result, buffer->writeSize);
+            writer->error = 1;
+        }
+        else
+        {
+            writer->stats.bytesWritten += buffer->writeSize;
+            writer->stats.writeCount++;
+            ARSTREAM2_FileWriter_UpdateHistogram(writer->stats.writeLatencyHistogram, curTime - buffer->submitTime);
+        }
+    }
+}
+
+
+static int ARSTREAM2_FileWriter_WriteAll(int fd, const uint8_t *data, size_t size, uint64_t offset)
+{
+    size_t written = 0;
+
+    while (written < size)
+    {
+        ssize_t ret = pwrite(fd, data + written, size - written, (off_t)(offset + written));
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -errno;
+        }
+        else if (ret == 0)
+        {
+            return -EIO;
+        }
+        written += ret;
+    }
+
+    return (int)written;
+}
+
+
+#ifdef HAS_IO_URING
+
+static int ARSTREAM2_FileWriter_UringInit(ARSTREAM2_FileWriter_Uring_t *uring, unsigned int entries)
+{
+    struct io_uring_params params;
+    int singleMmap;
+
+    memset(&params, 0, sizeof(params));
+    uring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (uring->fd < 0)
+    {
+        uring->fd = -1;
+        return -errno;
+    }
+
+    uring->sqEntries = params.sq_entries;
+    uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) ? 1 : 0;
+    if (singleMmap)
+    {
+        if (uring->cqRingSize > uring->sqRingSize)
+        {
+            uring->sqRingSize = uring->cqRingSize;
+        }
+        uring->cqRingSize = uring->sqRingSize;
+    }
+
+    uring->sqRing = mmap(NULL, uring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+    if (uring->sqRing == MAP_FAILED)
+    {
+        int err = errno;
+        uring->sqRing = NULL;
+        close(uring->fd);
+        uring->fd = -1;
+        return -err;
+    }
+    if (singleMmap)
+    {
+        uring->cqRing = uring->sqRing;
+    }
+    else
+    {
+        uring->cqRing = mmap(NULL, uring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+        if (uring->cqRing == MAP_FAILED)
+        {
+            int err = errno;
+            uring->cqRing = NULL;
+            munmap(uring->sqRing, uring->sqRingSize);
+            uring->sqRing = NULL;
+            close(uring->fd);
+            uring->fd = -1;
+            return -err;
+        }
+    }
+    uring->sqes = mmap(NULL, uring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+    if (uring->sqes == MAP_FAILED)
+    {
+        int err = errno;
+        uring->sqes = NULL;
+        if (uring->cqRing != uring->sqRing) munmap(uring->cqRing, uring->cqRingSize);
+        munmap(uring->sqRing, uring->sqRingSize);
+        uring->sqRing = uring->cqRing = NULL;
+        close(uring->fd);
+        uring->fd = -1;
+        return -err;
+    }
+
+    uring->sqHead = (unsigned int*)((uint8_t*)uring->sqRing + params.sq_off.head);
+    uring->sqTail = (unsigned int*)((uint8_t*)uring->sqRing + params.sq_off.tail);
+    uring->sqMask = (unsigned int*)((uint8_t*)uring->sqRing + params.sq_off.ring_mask);
+    uring->sqArray = (unsigned int*)((uint8_t*)uring->sqRing + params.sq_off.array);
+    uring->cqHead = (unsigned int*)((uint8_t*)uring->cqRing + params.cq_off.head);
+    uring->cqTail = (unsigned int*)((uint8_t*)uring->cqRing + params.cq_off.tail);
+    uring->cqMask = (unsigned int*)((uint8_t*)uring->cqRing + params.cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe*)((uint8_t*)uring->cqRing + params.cq_off.cqes);
+
+    return 0;
+}
+
+
+static void ARSTREAM2_FileWriter_UringFree(ARSTREAM2_FileWriter_Uring_t *uring)
+{
+    if (uring->sqes) munmap(uring->sqes, uring->sqesSize);
+    if ((uring->cqRing) && (uring->cqRing != uring->sqRing)) munmap(uring->cqRing, uring->cqRingSize);
+    if (uring->sqRing) munmap(uring->sqRing, uring->sqRingSize);
+    if (uring->fd >= 0) close(uring->fd);
+    memset(uring, 0, sizeof(*uring));
+    uring->fd = -1;
+}
+
+
+static int ARSTREAM2_FileWriter_UringSubmit(ARSTREAM2_FileWriter_t *writer, int index)
+{
+    ARSTREAM2_FileWriter_Uring_t *uring = &writer->uring;
+    struct io_uring_sqe *sqe;
+    unsigned int tail, head, idx;
+    int ret;
+
+    tail = *uring->sqTail;
+    head = __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+    if (tail - head >= uring->sqEntries)
+    {
+        return -EBUSY;
+    }
+
+    idx = tail & *uring->sqMask;
+    sqe = &uring->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = writer->fd;
+    sqe->user_data = (uint64_t)(index + 1);
+    if (index == ARSTREAM2_FILE_WRITER_SYNC_REQUEST)
+    {
+        /* the sync only starts once all the previous writes are complete */
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->flags = IOSQE_IO_DRAIN;
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->addr = (uint64_t)(uintptr_t)&writer->buffer[index].iov;
+        sqe->len = 1;
+        sqe->off = writer->buffer[index].offset;
+    }
+    uring->sqArray[idx] = idx;
+    __atomic_store_n(uring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    do
+    {
+        ret = syscall(__NR_io_uring_enter, uring->fd, 1, 0, 0, NULL, 0);
+    }
+    while ((ret < 0) && (errno == EINTR));
+
+    return (ret < 0) ? -errno : 0;
+}
+
+
+static int ARSTREAM2_FileWriter_UringReap(ARSTREAM2_FileWriter_t *writer, int wait)
+{
+    ARSTREAM2_FileWriter_Uring_t *uring = &writer->uring;
+    unsigned int head, tail;
+    uint64_t curTime;
+
+    if (wait)
+    {
+        int ret = syscall(__NR_io_uring_enter, uring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if ((ret < 0) && (errno != EINTR))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "io_uring_enter() failed (%d): %s", errno, strerror(errno));
+            return -1;
+        }
+    }
+
+    head = *uring->cqHead;
+    tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+    if (head == tail)
+    {
+        return 0;
+    }
+
+    curTime = ARSTREAM2_FileWriter_GetTime();
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    for (; head != tail; head++)
+    {
+        struct io_uring_cqe *cqe = &uring->cqes[head & *uring->cqMask];
+        ARSTREAM2_FileWriter_Complete(writer, (int)cqe->user_data - 1, cqe->res, curTime);
+    }
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+    __atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+#endif /* #ifdef HAS_IO_URING */
+
+
+static void* ARSTREAM2_FileWriter_RunThread(void *param)
+{
+    ARSTREAM2_FileWriter_t *writer = (ARSTREAM2_FileWriter_t*)param;
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    while (1)
+    {
+        int index, result;
+
+        while ((writer->requestQueueCount == 0) && (!writer->threadShouldStop))
+        {
+            ARSAL_Cond_Wait(&(writer->requestCond), &(writer->mutex));
+        }
+        if (writer->requestQueueCount == 0)
+        {
+            break;
+        }
+        index = writer->requestQueue[writer->requestQueueHead];
+        ARSAL_Mutex_Unlock(&(writer->mutex));
+
+        /* the request fields are not modified while it is in progress */
+        if (index == ARSTREAM2_FILE_WRITER_SYNC_REQUEST)
+        {
+            result = fdatasync(writer->fd);
+            if (result < 0)
+            {
+                result = -errno;
+            }
+        }
+        else
+        {
+            result = ARSTREAM2_FileWriter_WriteAll(writer->fd, writer->buffer[index].data, writer->buffer[index].writeSize, writer->buffer[index].offset);
+        }
+
+        uint64_t curTime = ARSTREAM2_FileWriter_GetTime();
+        ARSAL_Mutex_Lock(&(writer->mutex));
+        writer->requestQueueHead = (writer->requestQueueHead + 1) % writer->requestQueueSize;
+        writer->requestQueueCount--;
+        ARSTREAM2_FileWriter_Complete(writer, index, result, curTime);
+        ARSAL_Cond_Broadcast(&(writer->completionCond));
+    }
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+
+    return (void*)0;
+}
+
+
+static void ARSTREAM2_FileWriter_SubmitRequest(ARSTREAM2_FileWriter_t *writer, int index)
+{
+    uint64_t curTime = ARSTREAM2_FileWriter_GetTime();
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    if (index == ARSTREAM2_FILE_WRITER_SYNC_REQUEST)
+    {
+        writer->syncInProgress = 1;
+        writer->syncSubmitTime = curTime;
+    }
+    else
+    {
+        writer->buffer[index].inProgress = 1;
+        writer->buffer[index].submitTime = curTime;
+        writer->stats.pendingWriteCount++;
+        if (writer->stats.pendingWriteCount > writer->stats.pendingWritePeakCount)
+        {
+            writer->stats.pendingWritePeakCount = writer->stats.pendingWriteCount;
+        }
+    }
+    if (!writer->useUring)
+    {
+        int tail = (writer->requestQueueHead + writer->requestQueueCount) % writer->requestQueueSize;
+        writer->requestQueue[tail] = index;
+        writer->requestQueueCount++;
+        ARSAL_Cond_Signal(&(writer->requestCond));
+    }
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+
+#ifdef HAS_IO_URING
+    if (writer->useUring)
+    {
+        int ret = ARSTREAM2_FileWriter_UringSubmit(writer, index);
+        if (ret < 0)
+        {
+            ARSAL_Mutex_Lock(&(writer->mutex));
+            ARSTREAM2_FileWriter_Complete(writer, index, ret, curTime);
+            ARSAL_Mutex_Unlock(&(writer->mutex));
+        }
+    }
+#endif
+}
+
+
+static int ARSTREAM2_FileWriter_GetError(ARSTREAM2_FileWriter_t *writer)
+{
+    int error;
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    error = writer->error;
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+
+    return error;
+}
+
+
+/* index is a batch buffer index or ARSTREAM2_FILE_WRITER_SYNC_REQUEST */
+static int ARSTREAM2_FileWriter_Wait(ARSTREAM2_FileWriter_t *writer, int index)
+{
+    int ret = 0, stalled = 0;
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    while (((index == ARSTREAM2_FILE_WRITER_SYNC_REQUEST) && (writer->syncInProgress))
+           || ((index != ARSTREAM2_FILE_WRITER_SYNC_REQUEST) && (writer->buffer[index].inProgress)))
+    {
+        stalled = 1;
+        if (writer->useUring)
+        {
+#ifdef HAS_IO_URING
+            ARSAL_Mutex_Unlock(&(writer->mutex));
+            ret = ARSTREAM2_FileWriter_UringReap(writer, 1);
+            ARSAL_Mutex_Lock(&(writer->mutex));
+            if (ret != 0)
+            {
+                writer->error = 1;
+                break;
+            }
+#endif
+        }
+        else
+        {
+            ARSAL_Cond_Wait(&(writer->completionCond), &(writer->mutex));
+        }
+    }
+    if ((stalled) && (index != ARSTREAM2_FILE_WRITER_SYNC_REQUEST))
+    {
+        writer->stats.stallCount++;
+    }
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+
+    return ret;
+}
+
+
+static int ARSTREAM2_FileWriter_WaitAll(ARSTREAM2_FileWriter_t *writer)
+{
+    int i, ret = 0;
+
+    for (i = 0; i < writer->bufferCount; i++)
+    {
+        if (ARSTREAM2_FileWriter_Wait(writer, i) != 0)
+        {
+            ret = -1;
+        }
+    }
+    if (ARSTREAM2_FileWriter_Wait(writer, ARSTREAM2_FILE_WRITER_SYNC_REQUEST) != 0)
+    {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+
+static void ARSTREAM2_FileWriter_SubmitCurrent(ARSTREAM2_FileWriter_t *writer)
+{
+    ARSTREAM2_FileWriter_Buffer_t *buffer = &writer->buffer[writer->current];
+    ARSTREAM2_FileWriter_Buffer_t *next;
+    size_t writeSize = buffer->size, remaining;
+    int nextIndex;
+
+    /* with direct I/O only whole blocks are written, the remaining data
+     * is moved to the next buffer */
+    if (writer->directIo)
+    {
+        writeSize &= ~((size_t)ARSTREAM2_FILE_WRITER_DIRECT_IO_ALIGNMENT - 1);
+    }
+    if (writeSize == 0)
+    {
+        return;
+    }
+
+    buffer->writeSize = writeSize;
+    buffer->offset = writer->fileOffset;
+    buffer->iov.iov_base = buffer->data;
+    buffer->iov.iov_len = writeSize;
+    ARSTREAM2_FileWriter_SubmitRequest(writer, writer->current);
+
+    nextIndex = (writer->current + 1) % writer->bufferCount;
+    next = &writer->buffer[nextIndex];
+    ARSTREAM2_FileWriter_Wait(writer, nextIndex);
+    remaining = buffer->size - writeSize;
+    if (remaining > 0)
+    {
+        memcpy(next->data, buffer->data + writeSize, remaining);
+    }
+    next->size = remaining;
+
+    writer->fileOffset += writeSize;
+    writer->bytesSinceSync += writeSize;
+    writer->current = nextIndex;
+}
+
+
+static void ARSTREAM2_FileWriter_CheckSync(ARSTREAM2_FileWriter_t *writer, uint64_t curTime)
+{
+    int syncInProgress;
+
+    if (writer->bytesSinceSync == 0)
+    {
+        return;
+    }
+    if (((writer->syncByteBudget == 0) || (writer->bytesSinceSync < writer->syncByteBudget))
+            && ((writer->syncIntervalUs == 0) || (curTime < writer->lastSyncTime + writer->syncIntervalUs)))
+    {
+        return;
+    }
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    syncInProgress = writer->syncInProgress;
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+    if (syncInProgress)
+    {
+        /* the budget is enforced again on the next call */
+        return;
+    }
+
+    ARSTREAM2_FileWriter_SubmitRequest(writer, ARSTREAM2_FILE_WRITER_SYNC_REQUEST);
+    writer->bytesSinceSync = 0;
+    writer->lastSyncTime = curTime;
+}
+
+
+ARSTREAM2_FileWriter_t* ARSTREAM2_FileWriter_New(const ARSTREAM2_FileWriter_Config_t *config, eARSTREAM2_ERROR *error)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_FileWriter_t *writer = NULL;
+    int mutexWasInit = 0, requestCondWasInit = 0, completionCondWasInit = 0;
+    int i;
+
+    /* ARGS Check */
+    if ((config == NULL) || (config->fileName == NULL))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Invalid config");
+        SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+        return NULL;
+    }
+
+    /* Alloc new writer */
+    writer = (ARSTREAM2_FileWriter_t*)malloc(sizeof(ARSTREAM2_FileWriter_t));
+    if (writer == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Allocation failed (size %zu)", sizeof(ARSTREAM2_FileWriter_t));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(writer, 0, sizeof(ARSTREAM2_FileWriter_t));
+        writer->fd = -1;
+        writer->uring.fd = -1;
+        writer->directIo = (config->directIo) ? 1 : 0;
+        writer->batchSize = (config->batchSize > 0) ? (size_t)config->batchSize : ARSTREAM2_FILE_WRITER_DEFAULT_BATCH_SIZE;
+        writer->batchSize = (writer->batchSize + ARSTREAM2_FILE_WRITER_DIRECT_IO_ALIGNMENT - 1) & ~((size_t)ARSTREAM2_FILE_WRITER_DIRECT_IO_ALIGNMENT - 1);
+        writer->bufferCount = (config->bufferCount > 0) ? config->bufferCount : ARSTREAM2_FILE_WRITER_DEFAULT_BUFFER_COUNT;
+        if (writer->bufferCount < 2)
+        {
+            /* a buffer is filled while the other ones are written */
+            writer->bufferCount = 2;
+        }
+        writer->syncIntervalUs = (config->syncIntervalMs > 0) ? (uint64_t)config->syncIntervalMs * 1000 :
+                                 (config->syncIntervalMs == 0) ? (uint64_t)ARSTREAM2_FILE_WRITER_DEFAULT_SYNC_INTERVAL_MS * 1000 : 0;
+        writer->syncByteBudget = (config->syncByteBudget > 0) ? (uint64_t)config->syncByteBudget :
+                                 (config->syncByteBudget == 0) ? (uint64_t)ARSTREAM2_FILE_WRITER_DEFAULT_SYNC_BYTE_BUDGET : 0;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(writer->mutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+    if (ret == ARSTREAM2_OK)
+    {
+        int condInitRet = ARSAL_Cond_Init(&(writer->requestCond));
+        if (condInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Cond creation failed (%d)", condInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            requestCondWasInit = 1;
+        }
+    }
+    if (ret == ARSTREAM2_OK)
+    {
+        int condInitRet = ARSAL_Cond_Init(&(writer->completionCond));
+        if (condInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Cond creation failed (%d)", condInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            completionCondWasInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        if (writer->directIo)
+        {
+            writer->fd = open(config->fileName, flags | O_DIRECT, 0644);
+            if ((writer->fd < 0) && (errno == EINVAL))
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_FILE_WRITER_TAG, "Direct I/O is not supported for file '%s', falling back to buffered I/O", config->fileName);
+                writer->directIo = 0;
+            }
+        }
+        if (!writer->directIo)
+        {
+            writer->fd = open(config->fileName, flags, 0644);
+        }
+        if (writer->fd < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Failed to open file '%s' (%d): %s", config->fileName, errno, strerror(errno));
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        writer->buffer = calloc(writer->bufferCount, sizeof(ARSTREAM2_FileWriter_Buffer_t));
+        if (!writer->buffer)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Allocation failed (size %zu)", writer->bufferCount * sizeof(ARSTREAM2_FileWriter_Buffer_t));
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+    for (i = 0; (ret == ARSTREAM2_OK) && (i < writer->bufferCount); i++)
+    {
+        void *data = NULL;
+        if (posix_memalign(&data, ARSTREAM2_FILE_WRITER_DIRECT_IO_ALIGNMENT, writer->batchSize) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Allocation failed (size %zu)", writer->batchSize);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            writer->buffer[i].data = data;
+        }
+    }
+
+#ifdef HAS_IO_URING
+    if (ret == ARSTREAM2_OK)
+    {
+        /* all the batch buffers and a data sync can be in progress */
+        int uringRet = ARSTREAM2_FileWriter_UringInit(&writer->uring, writer->bufferCount + 1);
+        if (uringRet < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_FILE_WRITER_TAG, "io_uring setup failed (%d): %s, falling back to an I/O thread", -uringRet, strerror(-uringRet));
+        }
+        else
+        {
+            writer->useUring = 1;
+        }
+    }
+#endif
+
+    if ((ret == ARSTREAM2_OK) && (!writer->useUring))
+    {
+        writer->requestQueueSize = writer->bufferCount + 1;
+        writer->requestQueue = malloc(writer->requestQueueSize * sizeof(int));
+        if (!writer->requestQueue)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Allocation failed (size %zu)", writer->requestQueueSize * sizeof(int));
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+    if ((ret == ARSTREAM2_OK) && (!writer->useUring))
+    {
+        int thErr = ARSAL_Thread_Create(&writer->thread, ARSTREAM2_FileWriter_RunThread, (void*)writer);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "I/O thread creation failed (%d)", thErr);
+            writer->thread = NULL;
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        writer->lastSyncTime = ARSTREAM2_FileWriter_GetTime();
+    }
+    else if (writer)
+    {
+#ifdef HAS_IO_URING
+        if (writer->useUring) ARSTREAM2_FileWriter_UringFree(&writer->uring);
+#endif
+        if (writer->buffer)
+        {
+            for (i = 0; i < writer->bufferCount; i++)
+            {
+                free(writer->buffer[i].data);
+            }
+            free(writer->buffer);
+        }
+        free(writer->requestQueue);
+        if (writer->fd >= 0) close(writer->fd);
+        if (mutexWasInit) ARSAL_Mutex_Destroy(&(writer->mutex));
+        if (requestCondWasInit) ARSAL_Cond_Destroy(&(writer->requestCond));
+        if (completionCondWasInit) ARSAL_Cond_Destroy(&(writer->completionCond));
+        free(writer);
+        writer = NULL;
+    }
+
+    SET_WITH_CHECK(error, ret);
+    return writer;
+}
+
+
+int ARSTREAM2_FileWriter_Write(ARSTREAM2_FileWriter_t *writer, const void *data, size_t size)
+{
+    const uint8_t *ptr = (const uint8_t*)data;
+
+    if ((!writer) || ((!data) && (size > 0)))
+    {
+        return -1;
+    }
+    if (ARSTREAM2_FileWriter_GetError(writer))
+    {
+        return -1;
+    }
+
+    while (size > 0)
+    {
+        ARSTREAM2_FileWriter_Buffer_t *buffer = &writer->buffer[writer->current];
+        size_t len = writer->batchSize - buffer->size;
+        if (len > size)
+        {
+            len = size;
+        }
+        memcpy(buffer->data + buffer->size, ptr, len);
+        buffer->size += len;
+        ptr += len;
+        size -= len;
+
+        if (buffer->size == writer->batchSize)
+        {
+            ARSTREAM2_FileWriter_SubmitCurrent(writer);
+        }
+    }
+
+#ifdef HAS_IO_URING
+    if (writer->useUring)
+    {
+        ARSTREAM2_FileWriter_UringReap(writer, 0);
+    }
+#endif
+
+    ARSTREAM2_FileWriter_CheckSync(writer, ARSTREAM2_FileWriter_GetTime());
+
+    return (ARSTREAM2_FileWriter_GetError(writer)) ? -1 : 0;
+}
+
+
+int ARSTREAM2_FileWriter_Poll(ARSTREAM2_FileWriter_t *writer)
+{
+    uint64_t curTime;
+
+    if (!writer)
+    {
+        return -1;
+    }
+
+#ifdef HAS_IO_URING
+    if (writer->useUring)
+    {
+        ARSTREAM2_FileWriter_UringReap(writer, 0);
+    }
+#endif
+
+    if (ARSTREAM2_FileWriter_GetError(writer))
+    {
+        return -1;
+    }
+
+    /* do not keep data in memory for more than the sync interval */
+    curTime = ARSTREAM2_FileWriter_GetTime();
+    if ((writer->syncIntervalUs) && (writer->buffer[writer->current].size > 0)
+            && (curTime >= writer->lastSyncTime + writer->syncIntervalUs))
+    {
+        ARSTREAM2_FileWriter_SubmitCurrent(writer);
+    }
+
+    ARSTREAM2_FileWriter_CheckSync(writer, curTime);
+
+    return (ARSTREAM2_FileWriter_GetError(writer)) ? -1 : 0;
+}
+
+
+int ARSTREAM2_FileWriter_Drain(ARSTREAM2_FileWriter_t *writer)
+{
+    if (!writer)
+    {
+        return -1;
+    }
+
+    ARSTREAM2_FileWriter_WaitAll(writer);
+
+    return (ARSTREAM2_FileWriter_GetError(writer)) ? -1 : 0;
+}
+
+
+void ARSTREAM2_FileWriter_GetStats(ARSTREAM2_FileWriter_t *writer, ARSTREAM2_FileWriter_Stats_t *stats)
+{
+    if ((!writer) || (!stats))
+    {
+        return;
+    }
+
+    ARSAL_Mutex_Lock(&(writer->mutex));
+    memcpy(stats, &writer->stats, sizeof(ARSTREAM2_FileWriter_Stats_t));
+    writer->stats.pendingWritePeakCount = writer->stats.pendingWriteCount;
+    ARSAL_Mutex_Unlock(&(writer->mutex));
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_FileWriter_Delete(ARSTREAM2_FileWriter_t **writer)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_FileWriter_t *w;
+    int i;
+
+    if ((!writer) || (!*writer))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    w = *writer;
+
+    if (!ARSTREAM2_FileWriter_GetError(w))
+    {
+        ARSTREAM2_FileWriter_SubmitCurrent(w);
+    }
+    ARSTREAM2_FileWriter_WaitAll(w);
+
+    if ((!ARSTREAM2_FileWriter_GetError(w)) && (w->buffer[w->current].size > 0))
+    {
+        /* the tail of a direct I/O file is not block-aligned */
+        int flags = fcntl(w->fd, F_GETFL);
+        if ((flags < 0) || (fcntl(w->fd, F_SETFL, flags & ~O_DIRECT) < 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Failed to disable direct I/O (%d): %s", errno, strerror(errno));
+            w->error = 1;
+        }
+        else
+        {
+            int writeRet = ARSTREAM2_FileWriter_WriteAll(w->fd, w->buffer[w->current].data, w->buffer[w->current].size, w->fileOffset);
+            if (writeRet < 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Write failed (%d): %s", -writeRet, strerror(-writeRet));
+                w->error = 1;
+            }
+            else
+            {
+                w->fileOffset += writeRet;
+                w->stats.bytesWritten += writeRet;
+            }
+        }
+    }
+
+    if ((!ARSTREAM2_FileWriter_GetError(w)) && (fdatasync(w->fd) < 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Data sync failed (%d): %s", errno, strerror(errno));
+        w->error = 1;
+    }
+    if (w->error)
+    {
+        ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+    }
+
+    if (w->thread)
+    {
+        ARSAL_Mutex_Lock(&(w->mutex));
+        w->threadShouldStop = 1;
+        ARSAL_Mutex_Unlock(&(w->mutex));
+        ARSAL_Cond_Signal(&(w->requestCond));
+        ARSAL_Thread_Join(w->thread, NULL);
+        ARSAL_Thread_Destroy(&(w->thread));
+    }
+#ifdef HAS_IO_URING
+    if (w->useUring) ARSTREAM2_FileWriter_UringFree(&w->uring);
+#endif
+
+    if (close(w->fd) < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_FILE_WRITER_TAG, "Failed to close file (%d): %s", errno, strerror(errno));
+        ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+    }
+    for (i = 0; i < w->bufferCount; i++)
+    {
+        free(w->buffer[i].data);
+    }
+    free(w->buffer);
+    free(w->requestQueue);
+    ARSAL_Mutex_Destroy(&(w->mutex));
+    ARSAL_Cond_Destroy(&(w->requestCond));
+    ARSAL_Cond_Destroy(&(w->completionCond));
+    free(w);
+    *writer = NULL;
+
+    return ret;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file arstream2_file_writer.h
+ * @brief Parrot Streaming Library - Asynchronous File Writer
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_FILE_WRITER_H_
+#define _ARSTREAM2_FILE_WRITER_H_
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+#include <libARStream2/arstream2_error.h>
+
+
+/**
+ * Default write batch size in bytes
+ */
+#define ARSTREAM2_FILE_WRITER_DEFAULT_BATCH_SIZE (2 * 1024 * 1024)
+
+
+/**
+ * Default number of write batch buffers
+ */
+#define ARSTREAM2_FILE_WRITER_DEFAULT_BUFFER_COUNT (4)
+
+
+/**
+ * Default maximum interval between two data syncs in milliseconds
+ */
+#define ARSTREAM2_FILE_WRITER_DEFAULT_SYNC_INTERVAL_MS (1000)
+
+
+/**
+ * Default maximum amount of written data between two data syncs in bytes
+ */
+#define ARSTREAM2_FILE_WRITER_DEFAULT_SYNC_BYTE_BUDGET (8 * 1024 * 1024)
+
+
+/**
+ * Buffer, offset and size alignment for direct I/O
+ */
+#define ARSTREAM2_FILE_WRITER_DIRECT_IO_ALIGNMENT (4096)
+
+
+/**
+ * Number of latency histogram buckets: bucket 0 counts latencies below 1 ms,
+ * bucket i counts latencies in [2^(i-1), 2^i[ ms and the last bucket counts
+ * all the longer latencies
+ */
+#define ARSTREAM2_FILE_WRITER_LATENCY_BUCKET_COUNT (12)
+
+
+/**
+ * @brief File writer configuration.
+ */
+typedef struct ARSTREAM2_FileWriter_Config_s
+{
+    const char *fileName;                   /**< File name (the file is created or truncated) */
+    int directIo;                           /**< if true, open the file with O_DIRECT (falls back to buffered I/O if unsupported) */
+    int batchSize;                          /**< Write batch size in bytes (optional, 0 for the default value) */
+    int bufferCount;                        /**< Number of write batch buffers (optional, 0 for the default value) */
+    int syncIntervalMs;                     /**< Maximum interval between two data syncs in milliseconds (optional, 0 for the default value, -1 to disable) */
+    int syncByteBudget;                     /**< Maximum amount of written data between two data syncs in bytes (optional, 0 for the default value, -1 to disable) */
+
+} ARSTREAM2_FileWriter_Config_t;
+
+
+/**
+ * @brief File writer statistics.
+ */
+typedef struct ARSTREAM2_FileWriter_Stats_s
+{
+    uint64_t bytesWritten;                  /**< Number of bytes written to the file */
+    uint32_t writeCount;                    /**< Number of completed write batches */
+    uint32_t syncCount;                     /**< Number of completed data syncs */
+    uint32_t stallCount;                    /**< Number of times the caller waited for a free batch buffer */
+    int pendingWriteCount;                  /**< Number of write batches in progress */
+    int pendingWritePeakCount;              /**< Maximum number of write batches in progress */
+    uint32_t writeLatencyHistogram[ARSTREAM2_FILE_WRITER_LATENCY_BUCKET_COUNT];    /**< Write batch latency histogram */
+    uint32_t syncLatencyHistogram[ARSTREAM2_FILE_WRITER_LATENCY_BUCKET_COUNT];     /**< Data sync latency histogram */
+
+} ARSTREAM2_FileWriter_Stats_t;
+
+
+/**
+ * @brief File writer batch buffer.
+ */
+typedef struct ARSTREAM2_FileWriter_Buffer_s
+{
+    uint8_t *data;
+    size_t size;
+    size_t writeSize;
+    uint64_t offset;
+    uint64_t submitTime;
+    int inProgress;
+    struct iovec iov;
+
+} ARSTREAM2_FileWriter_Buffer_t;
+
+
+/**
+ * @brief File writer io_uring instance.
+ */
+typedef struct ARSTREAM2_FileWriter_Uring_s
+{
+    int fd;
+    unsigned int sqEntries;
+    unsigned int *sqHead;
+    unsigned int *sqTail;
+    unsigned int *sqMask;
+    unsigned int *sqArray;
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+
+} ARSTREAM2_FileWriter_Uring_t;
+
+
+/**
+ * @brief File writer.
+ *
+ * The data is copied into large batch buffers which are written asynchronously
+ * (through io_uring when available, otherwise through a dedicated I/O thread)
+ * so that a slow storage device does not block the caller until all the batch
+ * buffers are in progress. Data syncs are issued on a time and byte budget.
+ */
+typedef struct ARSTREAM2_FileWriter_s
+{
+    int fd;
+    int directIo;
+    size_t batchSize;
+    int bufferCount;
+    ARSTREAM2_FileWriter_Buffer_t *buffer;
+    int current;
+    uint64_t fileOffset;
+    int error;
+
+    /* data sync */
+    uint64_t syncIntervalUs;
+    uint64_t syncByteBudget;
+    uint64_t bytesSinceSync;
+    uint64_t lastSyncTime;
+    int syncInProgress;
+    uint64_t syncSubmitTime;
+
+    /* io_uring backend */
+    int useUring;
+    ARSTREAM2_FileWriter_Uring_t uring;
+
+    /* thread backend */
+    ARSAL_Thread_t thread;
+    ARSAL_Cond_t requestCond;
+    ARSAL_Cond_t completionCond;
+    int threadShouldStop;
+    int *requestQueue;
+    int requestQueueSize;
+    int requestQueueHead;
+    int requestQueueCount;
+
+    /* the mutex protects the buffer states and the statistics */
+    ARSAL_Mutex_t mutex;
+    ARSTREAM2_FileWriter_Stats_t stats;
+
+} ARSTREAM2_FileWriter_t;
+
+
+/**
+ * @brief Create a file writer.
+ *
+ * @param[in] config Configuration
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_FileWriter_t, or NULL if an error occured
+ */
+ARSTREAM2_FileWriter_t* ARSTREAM2_FileWriter_New(const ARSTREAM2_FileWriter_Config_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Write data to the file.
+ *
+ * The data is copied; the function only blocks when all the batch buffers are in progress.
+ *
+ * @param writer The file writer instance
+ * @param data Data pointer
+ * @param size Data size in bytes
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred (the error is sticky: all subsequent writes fail).
+ */
+int ARSTREAM2_FileWriter_Write(ARSTREAM2_FileWriter_t *writer, const void *data, size_t size);
+
+
+/**
+ * @brief Process the completed writes and enforce the data sync time budget.
+ *
+ * The function should be called periodically when no data is written.
+ *
+ * @param writer The file writer instance
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_FileWriter_Poll(ARSTREAM2_FileWriter_t *writer);
+
+
+/**
+ * @brief Wait for the completion of all the writes and data syncs in progress.
+ *
+ * With io_uring the requests still in progress are cancelled when the thread
+ * which submitted them exits; the function must therefore be called by the
+ * writing thread before it ends if the writer is deleted from another thread.
+ *
+ * @param writer The file writer instance
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_FileWriter_Drain(ARSTREAM2_FileWriter_t *writer);
+
+
+/**
+ * @brief Get the file writer statistics.
+ *
+ * The function can be called from any thread.
+ * The peak pending write count is reset to the current pending write count.
+ *
+ * @param writer The file writer instance
+ * @param[out] stats Statistics
+ */
+void ARSTREAM2_FileWriter_GetStats(ARSTREAM2_FileWriter_t *writer, ARSTREAM2_FileWriter_Stats_t *stats);
+
+
+/**
+ * @brief Delete a file writer.
+ *
+ * The remaining data is written and synced before the file is closed.
+ *
+ * @param writer Pointer to the file writer instance pointer
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_FileWriter_Delete(ARSTREAM2_FileWriter_t **writer);
+
+
+#endif /* _ARSTREAM2_FILE_WRITER_H_ */
@@ -11,6 +11,12 @@
 #include <string.h>
 #include <libARSAL/ARSAL_Print.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 /**
  * Tag for ARSAL_PRINT
@@ -1289,3 +1295,238 @@ int ARSTREAM2_H264_AuMbStatusCheckSizeRealloc(ARSTREAM2_H264_AccessUnit_t *au, u
 
     return 0;
 }
+
+
+/* Check for a byte value (after masking) at position pos preceded by zeroCount (2 or 3) zero bytes (pos >= zeroCount) */
+#define ARSTREAM2_H264_IS_ZERO_PREFIXED(_buf, _pos, _byteVal, _byteMask, _zeroCount) \
+    ((((_buf)[(_pos)] & (_byteMask)) == (_byteVal)) && ((_buf)[(_pos) - 1] == 0) && ((_buf)[(_pos) - 2] == 0) \
+     && (((_zeroCount) < 3) || ((_buf)[(_pos) - 3] == 0)))
+
+
+/* Find the first position >= pos of a byte value (after masking with byteMask) preceded by zeroCount zero bytes;
+ * the candidate byte and the zero bytes before it are compared many positions at a time
+ * using unaligned loads at pos, pos - 1, pos - 2 (and pos - 3) */
+static inline int ARSTREAM2_H264_FindZeroPrefixedByte(const uint8_t *buf, unsigned int size, unsigned int pos,
+                                                     const uint8_t byteVal, const uint8_t byteMask, const int zeroCount)
+{
+#if defined(__AVX2__)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i val = _mm256_set1_epi8((char)byteVal);
+        const __m256i msk = _mm256_set1_epi8((char)byteMask);
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i z = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(buf + pos - 1)),
+                                        _mm256_loadu_si256((const __m256i*)(buf + pos - 2)));
+            if (zeroCount >= 3)
+            {
+                z = _mm256_or_si256(z, _mm256_loadu_si256((const __m256i*)(buf + pos - 3)));
+            }
+            __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(buf + pos)), msk), val),
+                                         _mm256_cmpeq_epi8(z, zero));
+            uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+            if (mask)
+            {
+                return (int)(pos + __builtin_ctz(mask));
+            }
+        }
+    }
+#elif defined(__SSE2__)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i val = _mm_set1_epi8((char)byteVal);
+        const __m128i msk = _mm_set1_epi8((char)byteMask);
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i z = _mm_or_si128(_mm_loadu_si128((const __m128i*)(buf + pos - 1)),
+                                     _mm_loadu_si128((const __m128i*)(buf + pos - 2)));
+            if (zeroCount >= 3)
+            {
+                z = _mm_or_si128(z, _mm_loadu_si128((const __m128i*)(buf + pos - 3)));
+            }
+            __m128i m = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i*)(buf + pos)), msk), val),
+                                      _mm_cmpeq_epi8(z, zero));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+            if (mask)
+            {
+                return (int)(pos + __builtin_ctz(mask));
+            }
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    {
+        const uint8x16_t zero = vdupq_n_u8(0);
+        const uint8x16_t val = vdupq_n_u8(byteVal);
+        const uint8x16_t msk = vdupq_n_u8(byteMask);
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t z = vorrq_u8(vld1q_u8(buf + pos - 1), vld1q_u8(buf + pos - 2));
+            if (zeroCount >= 3)
+            {
+                z = vorrq_u8(z, vld1q_u8(buf + pos - 3));
+            }
+            uint8x16_t m = vandq_u8(vceqq_u8(vandq_u8(vld1q_u8(buf + pos), msk), val), vceqq_u8(z, zero));
+            uint64x2_t m64 = vreinterpretq_u64_u8(m);
+            if (vgetq_lane_u64(m64, 0) | vgetq_lane_u64(m64, 1))
+            {
+                unsigned int end = pos + 16;
+                for (; pos < end; pos++)
+                {
+                    if (ARSTREAM2_H264_IS_ZERO_PREFIXED(buf, pos, byteVal, byteMask, zeroCount))
+                    {
+                        return (int)pos;
+                    }
+                }
+            }
+        }
+    }
+#else
+    {
+        /* Word at a time: if the 8 bytes before the candidate positions
+         * contain no zero byte, none of the next 8 positions can match */
+        for (; pos + 8 <= size; pos += 8)
+        {
+            uint64_t word;
+            memcpy(&word, buf + pos - 1, sizeof(word));
+            if ((word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL)
+            {
+                unsigned int end = pos + 8;
+                for (; pos < end; pos++)
+                {
+                    if (ARSTREAM2_H264_IS_ZERO_PREFIXED(buf, pos, byteVal, byteMask, zeroCount))
+                    {
+                        return (int)pos;
+                    }
+                }
+                pos -= 8;
+            }
+        }
+    }
+#endif
+
+    for (; pos < size; pos++)
+    {
+        if (ARSTREAM2_H264_IS_ZERO_PREFIXED(buf, pos, byteVal, byteMask, zeroCount))
+        {
+            return (int)pos;
+        }
+    }
+
+    return -2;
+}
+
+
+int ARSTREAM2_H264_FindStartCode(const uint8_t *buf, unsigned int size)
+{
+    int ret;
+
+    if (!buf)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    if (size < ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH)
+    {
+        return -2;
+    }
+
+    ret = ARSTREAM2_H264_FindZeroPrefixedByte(buf, size, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH - 1, 0x01, 0xFF, 3);
+
+    return (ret >= 0) ? ret + 1 : ret;
+}
+
+
+int ARSTREAM2_H264_FindEmulationPreventionByte(const uint8_t *buf, unsigned int size, unsigned int pos)
+{
+    if (!buf)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    if (pos < 2)
+    {
+        pos = 2;
+    }
+
+    return ARSTREAM2_H264_FindZeroPrefixedByte(buf, size, pos, 0x03, 0xFF, 2);
+}
+
+
+int ARSTREAM2_H264_EmulationPrevention(const uint8_t *src, unsigned int srcSize, uint8_t *dst, unsigned int dstBufSize, int *zeroCount)
+{
+    unsigned int pos, copyPos = 0, dstSize = 0, searchPos = 2, len;
+    int zc, match, lastInsert = -1;
+
+    if ((!src) || (!dst) || (!zeroCount))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    /* the first two bytes may be preceded by zero bytes in the previous output */
+    zc = *zeroCount;
+    for (pos = 0; (pos < 2) && (pos < srcSize); pos++)
+    {
+        if ((zc == 2) && (src[pos] <= 3))
+        {
+            len = pos - copyPos;
+            if (dstSize + len + 1 > dstBufSize)
+            {
+                return -1;
+            }
+            memcpy(dst + dstSize, src + copyPos, len);
+            dstSize += len;
+            dst[dstSize++] = 0x03;
+            copyPos = pos;
+            lastInsert = (int)pos;
+            searchPos = pos + 2;
+            zc = 0;
+        }
+        zc = (src[pos] == 0) ? zc + 1 : 0;
+    }
+
+    /* afterwards the zero bytes before a candidate are in the source; after an inserted
+     * 0x03 byte the next candidate needs two new zero bytes, hence the search restarts 2 bytes later */
+    while (searchPos < srcSize)
+    {
+        match = ARSTREAM2_H264_FindZeroPrefixedByte(src, srcSize, searchPos, 0x00, 0xFC, 2);
+        if (match < 0)
+        {
+            break;
+        }
+        len = (unsigned int)match - copyPos;
+        if (dstSize + len + 1 > dstBufSize)
+        {
+            return -1;
+        }
+        memcpy(dst + dstSize, src + copyPos, len);
+        dstSize += len;
+        dst[dstSize++] = 0x03;
+        copyPos = (unsigned int)match;
+        lastInsert = match;
+        searchPos = (unsigned int)match + 2;
+    }
+
+    len = srcSize - copyPos;
+    if (dstSize + len > dstBufSize)
+    {
+        return -1;
+    }
+    memcpy(dst + dstSize, src + copyPos, len);
+    dstSize += len;
+
+    /* trailing zero bytes for the next call */
+    if (srcSize > 2)
+    {
+        zc = 0;
+        for (pos = srcSize; (pos > srcSize - 2) && ((int)pos - 1 >= lastInsert) && (src[pos - 1] == 0); pos--)
+        {
+            zc++;
+        }
+    }
+    *zeroCount = zc;
+
+    return (int)dstSize;
+}
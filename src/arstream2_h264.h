@@ -430,5 +430,36 @@ int ARSTREAM2_H264_AuCheckSizeRealloc(ARSTREAM2_H264_AccessUnit_t *au, unsigned
 
 int ARSTREAM2_H264_AuMbStatusCheckSizeRealloc(ARSTREAM2_H264_AccessUnit_t *au, unsigned int mbCount);
 
+/**
+ * @brief Find the next byte stream start code (00 00 00 01) in a buffer.
+ *
+ * @return the position following the first start code in the buffer
+ * @return -2 if no start code is found
+ * @return -1 on invalid parameters
+ */
+int ARSTREAM2_H264_FindStartCode(const uint8_t *buf, unsigned int size);
+
+/**
+ * @brief Find the next emulation prevention byte (0x03 in a 00 00 03 sequence) in a buffer.
+ *
+ * The search starts at position pos; the bytes before pos are used to check the zero bytes.
+ *
+ * @return the position of the first emulation prevention byte at or after pos
+ * @return -2 if no emulation prevention byte is found
+ * @return -1 on invalid parameters
+ */
+int ARSTREAM2_H264_FindEmulationPreventionByte(const uint8_t *buf, unsigned int size, unsigned int pos);
+
+/**
+ * @brief Copy an RBSP to a NAL unit buffer inserting the emulation prevention bytes.
+ *
+ * The zeroCount value is the number of zero bytes (0 to 2) at the end of the previous output;
+ * it is updated for the next call so that an RBSP can be escaped in several parts.
+ *
+ * @return the output size
+ * @return -1 if the output buffer is too small or on invalid parameters
+ */
+int ARSTREAM2_H264_EmulationPrevention(const uint8_t *src, unsigned int srcSize, uint8_t *dst, unsigned int dstBufSize, int *zeroCount);
+
 
 #endif /* #ifndef _ARSTREAM2_H264_H_ */
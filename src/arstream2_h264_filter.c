@@ -176,13 +176,16 @@ static int ARSTREAM2_H264Filter_ParseNalu(ARSTREAM2_H264Filter_t *filter, ARSTRE
                         {
                             filter->currentAuFrameNum = sliceInfo.frame_num;
                             ARSTREAM2_H264Filter_HandleGapsInFrameNum(filter);
-                            _err = ARSTREAM2_H264Parser_GetSliceContext(filter->parser, (void**)&filter->savedSliceContext);
+                            /* the full slice header is parsed here (lazy parsing), only once per access unit */
+                            void *sliceContext = NULL;
+                            _err = ARSTREAM2_H264Parser_GetSliceContext(filter->parser, &sliceContext);
                             if (_err != ARSTREAM2_OK)
                             {
-                                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_TAG, "ARSTREAM2_H264Parser_GetSliceContext() failed (%d)", err);
+                                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_TAG, "ARSTREAM2_H264Parser_GetSliceContext() failed (%d)", _err);
                             }
                             else
                             {
+                                memcpy(&filter->savedSliceContext, sliceContext, sizeof(filter->savedSliceContext));
                                 filter->savedSliceContextAvailable = 1;
                             }
                         }
@@ -469,8 +472,10 @@ int ARSTREAM2_H264Filter_ProcessAu(ARSTREAM2_H264Filter_t *filter, ARSTREAM2_H26
                     filter->currentAuIncomplete = 1;
                 }
             }
-            else if (filter->sync)
+            else if ((filter->sync) && ((naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SLICE_IDR)
+                                        || (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SLICE)))
             {
+                /* only check the slices: other NAL units (e.g. filler data) can follow a slice */
                 if ((filter->currentAuPreviousSliceIndex < 0) && (filter->currentAuInferredPreviousSliceFirstMb < 0))
                 {
                     if (filter->currentAuCurrentSliceFirstMb > 0)
@@ -585,9 +590,7 @@ int ARSTREAM2_H264Filter_ProcessAu(ARSTREAM2_H264Filter_t *filter, ARSTREAM2_H26
         filter->currentAuOutputIndex++;
     }
 
-    struct timespec t1;
-    ARSAL_Time_GetTime(&t1);
-    uint64_t curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+    uint64_t curTime = ARSTREAM2_Clock_GetTime(&filter->clock);
 
     /* update the stats */
     if (filter->sync)
@@ -781,6 +784,16 @@ eARSTREAM2_ERROR ARSTREAM2_H264Filter_Init(ARSTREAM2_H264Filter_Handle *filterHa
         filter->generateSkippedPSlices = (config->generateSkippedPSlices > 0) ? 1 : 0;
         filter->spsPpsCallback = config->spsPpsCallback;
         filter->spsPpsCallbackUserPtr = config->spsPpsCallbackUserPtr;
+        if (config->clock) filter->clock = *config->clock;
+        if ((config->grayIdrCachePath) && (strlen(config->grayIdrCachePath)))
+        {
+            filter->grayIdrCachePath = strdup(config->grayIdrCachePath);
+            if (!filter->grayIdrCachePath)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_TAG, "String allocation failed");
+                ret = ARSTREAM2_ERROR_ALLOC;
+            }
+        }
         filter->stats.mbStatusZoneCount = ARSTREAM2_H264_MB_STATUS_ZONE_COUNT;
         filter->stats.mbStatusClassCount = ARSTREAM2_H264_MB_STATUS_CLASS_COUNT;
     }
@@ -791,6 +804,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Filter_Init(ARSTREAM2_H264Filter_Handle *filterHa
         memset(&parserConfig, 0, sizeof(parserConfig));
         parserConfig.extractUserDataSei = 1;
         parserConfig.printLogs = 0;
+        parserConfig.lazyParsing = 1;
 
         ret = ARSTREAM2_H264Parser_Init(&(filter->parser), &parserConfig);
         if (ret < 0)
@@ -822,6 +836,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Filter_Init(ARSTREAM2_H264Filter_Handle *filterHa
         {
             if (filter->parser) ARSTREAM2_H264Parser_Free(filter->parser);
             if (filter->writer) ARSTREAM2_H264Writer_Free(filter->writer);
+            free(filter->grayIdrCachePath);
             free(filter);
         }
         *filterHandle = NULL;
@@ -850,6 +865,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Filter_Free(ARSTREAM2_H264Filter_Handle *filterHa
     free(filter->currentAuRefMacroblockStatus);
     free(filter->pSps);
     free(filter->pPps);
+    free(filter->pGrayIdrTemplate);
+    free(filter->grayIdrCachePath);
 
     free(filter);
     *filterHandle = NULL;
@@ -23,6 +23,7 @@
 #include <libARStream2/arstream2_stream_stats.h>
 
 #include "arstream2_h264.h"
+#include "arstream2_clock_internal.h"
 
 
 /*
@@ -49,6 +50,8 @@ typedef struct
     void *spsPpsCallbackUserPtr;
     int outputIncompleteAu;                                         /**< if true, output incomplete access units */
     int generateSkippedPSlices;                                     /**< if true, generate skipped P slices to replace missing slices */
+    const char *grayIdrCachePath;                                   /**< optional directory where the gray IDR slice is persisted per SPS/PPS (can be NULL) */
+    const ARSTREAM2_Clock_t *clock;                                 /**< optional time source for the stats (NULL for the monotonic clock) */
 
 } ARSTREAM2_H264Filter_Config_t;
 
@@ -86,12 +89,21 @@ typedef struct ARSTREAM2_H264Filter_s
 
     /* H.264-level stats */
     ARSTREAM2_H264_VideoStats_t stats;
+    ARSTREAM2_Clock_t clock;
 
     ARSTREAM2_H264Parser_Handle parser;
     ARSTREAM2_H264Writer_Handle writer;
     ARSTREAM2_H264_SliceContext_t savedSliceContext;
     int savedSliceContextAvailable;
 
+    /* gray IDR slice template, see ARSTREAM2_H264Writer_WriteGrayISliceTemplate() */
+    char *grayIdrCachePath;
+    uint8_t *pGrayIdrTemplate;
+    unsigned int grayIdrTemplateBufSize;
+    unsigned int grayIdrTemplateSize;
+    uint64_t grayIdrFingerprint;
+    int grayIdrTemplateValid;
+
     int sync;
     int spsSync;
     int spsSize;
@@ -10,32 +10,193 @@
 
 #define ARSTREAM2_H264_FILTER_ERROR_TAG "ARSTREAM2_H264FilterError"
 
+#define ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_TEMPLATE_MARGIN (1024)
+#define ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_NAME "arstream2_grayidr"
+#define ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_EXT "bin"
 
-int ARSTREAM2_H264FilterError_GenerateGrayIdrFrame(ARSTREAM2_H264Filter_t *filter, ARSTREAM2_H264_AccessUnit_t *nextAu,
-                                                   ARSTREAM2_H264_AuFifoItem_t *auItem)
+
+/* FNV-1a hash of the SPS and PPS NAL units */
+static uint64_t ARSTREAM2_H264FilterError_SpsPpsFingerprint(ARSTREAM2_H264Filter_t *filter)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    int i;
+
+    for (i = 0; i < filter->spsSize; i++)
+    {
+        hash = (hash ^ filter->pSps[i]) * 0x100000001B3ULL;
+    }
+    for (i = 0; i < filter->ppsSize; i++)
+    {
+        hash = (hash ^ filter->pPps[i]) * 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+
+static int ARSTREAM2_H264FilterError_GrayIdrTemplateAlloc(ARSTREAM2_H264Filter_t *filter, unsigned int size)
+{
+    uint8_t *pBuf;
+
+    if (filter->grayIdrTemplateBufSize < size)
+    {
+        pBuf = realloc(filter->pGrayIdrTemplate, size);
+        if (!pBuf)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_ERROR_TAG, "Allocation failed for gray IDR template (size %d)", size);
+            return -1;
+        }
+        filter->pGrayIdrTemplate = pBuf;
+        filter->grayIdrTemplateBufSize = size;
+    }
+
+    return 0;
+}
+
+
+static int ARSTREAM2_H264FilterError_LoadGrayIdrTemplate(ARSTREAM2_H264Filter_t *filter, uint64_t fingerprint)
+{
+    char szFileName[500];
+    FILE *f;
+    long size;
+    int ret = 0;
+
+    snprintf(szFileName, sizeof(szFileName), "%s/%s_%016" PRIx64 ".%s", filter->grayIdrCachePath,
+             ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_NAME, fingerprint, ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_EXT);
+    f = fopen(szFileName, "rb");
+    if (!f)
+    {
+        return -1;
+    }
+
+    if ((fseek(f, 0, SEEK_END) != 0) || ((size = ftell(f)) <= 0)
+            || (size > filter->mbCount + ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_TEMPLATE_MARGIN) || (fseek(f, 0, SEEK_SET) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_H264_FILTER_ERROR_TAG, "Invalid gray IDR file '%s'", szFileName);
+        ret = -1;
+    }
+
+    if (ret == 0)
+    {
+        ret = ARSTREAM2_H264FilterError_GrayIdrTemplateAlloc(filter, (unsigned int)size);
+    }
+
+    if (ret == 0)
+    {
+        if (fread(filter->pGrayIdrTemplate, 1, size, f) != (size_t)size)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_H264_FILTER_ERROR_TAG, "Failed to read gray IDR file '%s'", szFileName);
+            ret = -1;
+        }
+        else
+        {
+            filter->grayIdrTemplateSize = (unsigned int)size;
+            ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_FILTER_ERROR_TAG, "Loaded gray IDR file '%s'", szFileName);
+        }
+    }
+
+    fclose(f);
+
+    return ret;
+}
+
+
+static void ARSTREAM2_H264FilterError_SaveGrayIdrTemplate(ARSTREAM2_H264Filter_t *filter, uint64_t fingerprint)
+{
+    char szFileName[500], szTmpFileName[510];
+    FILE *f;
+    int ok;
+
+    snprintf(szFileName, sizeof(szFileName), "%s/%s_%016" PRIx64 ".%s", filter->grayIdrCachePath,
+             ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_NAME, fingerprint, ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_FILE_EXT);
+    snprintf(szTmpFileName, sizeof(szTmpFileName), "%s.tmp", szFileName);
+
+    /* write to a temporary file first so that a partial file is never loaded */
+    f = fopen(szTmpFileName, "wb");
+    if (!f)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_H264_FILTER_ERROR_TAG, "Unable to open file '%s'", szTmpFileName);
+        return;
+    }
+    ok = (fwrite(filter->pGrayIdrTemplate, 1, filter->grayIdrTemplateSize, f) == filter->grayIdrTemplateSize);
+    ok = ((fclose(f) == 0) && (ok));
+    if ((!ok) || (rename(szTmpFileName, szFileName) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_H264_FILTER_ERROR_TAG, "Failed to write gray IDR file '%s'", szFileName);
+        remove(szTmpFileName);
+    }
+}
+
+
+static int ARSTREAM2_H264FilterError_GetGrayIdrTemplate(ARSTREAM2_H264Filter_t *filter)
 {
-    int ret = 0, _ret;;
     eARSTREAM2_ERROR err = ARSTREAM2_OK;
     ARSTREAM2_H264_SliceContext_t sliceContext;
-    ARSTREAM2_H264_NaluFifoItem_t *naluItem = NULL, *spsItem = NULL, *ppsItem = NULL;
+    uint64_t fingerprint;
+
+    fingerprint = ARSTREAM2_H264FilterError_SpsPpsFingerprint(filter);
+    if ((filter->grayIdrTemplateValid) && (filter->grayIdrFingerprint == fingerprint))
+    {
+        return 0;
+    }
+    filter->grayIdrTemplateValid = 0;
+
+    if ((filter->grayIdrCachePath) && (ARSTREAM2_H264FilterError_LoadGrayIdrTemplate(filter, fingerprint) == 0))
+    {
+        filter->grayIdrFingerprint = fingerprint;
+        filter->grayIdrTemplateValid = 1;
+        return 0;
+    }
 
     if (!filter->savedSliceContextAvailable)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_ERROR_TAG, "No slice context available");
-        ret = -1;
+        return -1;
+    }
+
+    memcpy(&sliceContext, &filter->savedSliceContext, sizeof(sliceContext));
+    sliceContext.nal_ref_idc = 3;
+    sliceContext.nal_unit_type = ARSTREAM2_H264_NALU_TYPE_SLICE_IDR;
+    sliceContext.idrPicFlag = 1;
+    sliceContext.slice_type = ARSTREAM2_H264_SLICE_TYPE_I;
+    sliceContext.frame_num = 0;
+    sliceContext.idr_pic_id = 0;
+    sliceContext.no_output_of_prior_pics_flag = 0;
+    sliceContext.long_term_reference_flag = 0;
+
+    if (ARSTREAM2_H264FilterError_GrayIdrTemplateAlloc(filter, filter->mbCount + ARSTREAM2_H264_FILTER_ERROR_GRAY_IDR_TEMPLATE_MARGIN) != 0)
+    {
+        return -1;
     }
-    else
+
+    err = ARSTREAM2_H264Writer_WriteGrayISliceTemplate(filter->writer, 0, filter->mbCount, (void*)&sliceContext,
+                                                       filter->pGrayIdrTemplate, filter->grayIdrTemplateBufSize, &filter->grayIdrTemplateSize);
+    if (err != ARSTREAM2_OK)
     {
-        memcpy(&sliceContext, &filter->savedSliceContext, sizeof(sliceContext));
-        sliceContext.nal_ref_idc = 3;
-        sliceContext.nal_unit_type = ARSTREAM2_H264_NALU_TYPE_SLICE_IDR;
-        sliceContext.idrPicFlag = 1;
-        sliceContext.slice_type = ARSTREAM2_H264_SLICE_TYPE_I;
-        sliceContext.frame_num = 0;
-        sliceContext.idr_pic_id = 0;
-        sliceContext.no_output_of_prior_pics_flag = 0;
-        sliceContext.long_term_reference_flag = 0;
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_ERROR_TAG, "ARSTREAM2_H264Writer_WriteGrayISliceTemplate() failed (%d)", err);
+        return -1;
     }
+    filter->grayIdrFingerprint = fingerprint;
+    filter->grayIdrTemplateValid = 1;
+
+    if (filter->grayIdrCachePath)
+    {
+        ARSTREAM2_H264FilterError_SaveGrayIdrTemplate(filter, fingerprint);
+    }
+
+    return 0;
+}
+
+
+int ARSTREAM2_H264FilterError_GenerateGrayIdrFrame(ARSTREAM2_H264Filter_t *filter, ARSTREAM2_H264_AccessUnit_t *nextAu,
+                                                   ARSTREAM2_H264_AuFifoItem_t *auItem)
+{
+    int ret = 0, _ret;;
+    eARSTREAM2_ERROR err = ARSTREAM2_OK;
+    ARSTREAM2_H264_NaluFifoItem_t *naluItem = NULL, *spsItem = NULL, *ppsItem = NULL;
+
+    /* the gray IDR slice is generated once per SPS/PPS, only the POC is updated afterwards */
+    ret = ARSTREAM2_H264FilterError_GetGrayIdrTemplate(filter);
 
     if ((ret == 0) && (auItem->au.auSize + filter->spsSize <= auItem->au.buffer->auBufferSize))
     {
@@ -43,7 +204,7 @@ int ARSTREAM2_H264FilterError_GenerateGrayIdrFrame(ARSTREAM2_H264Filter_t *filte
         spsItem = ARSTREAM2_H264_AuNaluFifoPopFreeItem(&auItem->au);
         if (spsItem)
         {
-            ARSTREAM2_H264_NaluReset(&naluItem->nalu);
+            ARSTREAM2_H264_NaluReset(&spsItem->nalu);
             spsItem->nalu.nalu = auItem->au.buffer->auBuffer + auItem->au.auSize;
             memcpy(auItem->au.buffer->auBuffer + auItem->au.auSize, filter->pSps, filter->spsSize);
             spsItem->nalu.naluSize = filter->spsSize;
@@ -62,7 +223,7 @@ int ARSTREAM2_H264FilterError_GenerateGrayIdrFrame(ARSTREAM2_H264Filter_t *filte
         ppsItem = ARSTREAM2_H264_AuNaluFifoPopFreeItem(&auItem->au);
         if (ppsItem)
         {
-            ARSTREAM2_H264_NaluReset(&naluItem->nalu);
+            ARSTREAM2_H264_NaluReset(&ppsItem->nalu);
             ppsItem->nalu.nalu = auItem->au.buffer->auBuffer + auItem->au.auSize;
             memcpy(auItem->au.buffer->auBuffer + auItem->au.auSize, filter->pPps, filter->ppsSize);
             ppsItem->nalu.naluSize = filter->ppsSize;
@@ -86,12 +247,13 @@ int ARSTREAM2_H264FilterError_GenerateGrayIdrFrame(ARSTREAM2_H264Filter_t *filte
 
             unsigned int outputSize;
 
-            err = ARSTREAM2_H264Writer_WriteGrayISliceNalu(filter->writer, 0, filter->mbCount, (void*)&sliceContext,
-                                                           auItem->au.buffer->auBuffer + auItem->au.auSize,
-                                                           auItem->au.buffer->auBufferSize - auItem->au.auSize, &outputSize);
+            err = ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate(filter->writer, filter->pGrayIdrTemplate, filter->grayIdrTemplateSize, 0, 0,
+                                                                 (filter->savedSliceContextAvailable) ? filter->savedSliceContext.pic_order_cnt_lsb : 0,
+                                                                 auItem->au.buffer->auBuffer + auItem->au.auSize,
+                                                                 auItem->au.buffer->auBufferSize - auItem->au.auSize, &outputSize);
             if (err != ARSTREAM2_OK)
             {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_ERROR_TAG, "ARSTREAM2_H264Writer_WriteGrayISliceNalu() failed (%d)", err);
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_FILTER_ERROR_TAG, "ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate() failed (%d)", err);
                 ret = -1;
             }
             else
@@ -0,0 +1,783 @@
+/**
+ * @file arstream2_h264_generator.c
+ * @brief Parrot Streaming Library - H.264 Generator
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <libARStream2/arstream2_h264_generator.h>
+#include <libARStream2/arstream2_h264_parser.h>
+#include <libARStream2/arstream2_h264_writer.h>
+#include <libARStream2/arstream2_h264_sei.h>
+#include "arstream2_h264.h"
+
+#include <libARSAL/ARSAL_Print.h>
+
+#define ARSTREAM2_H264_GENERATOR_TAG "ARSTREAM2_H264Generator"
+
+#define ARSTREAM2_H264_GENERATOR_PARAM_SET_MAX_SIZE (64)
+#define ARSTREAM2_H264_GENERATOR_LOG2_MAX_FRAME_NUM (8)
+#define ARSTREAM2_H264_GENERATOR_LOG2_MAX_POC_LSB (9)
+#define ARSTREAM2_H264_GENERATOR_SLICE_TEMPLATE_OVERHEAD (256) // template header and slice header
+#define ARSTREAM2_H264_GENERATOR_SEI_OVERHEAD (16) // NAL unit header, SEI message header and trailing bits
+#define ARSTREAM2_H264_GENERATOR_FILLER_MIN_SIZE (2) // NAL unit header and trailing bits
+#define ARSTREAM2_H264_GENERATOR_USER_DATA_FILL (0xAA)
+
+
+static const uint8_t ARSTREAM2_H264_GENERATOR_USER_DATA_UUID[16] =
+{
+    0x41, 0x52, 0x53, 0x32, 0x2d, 0x47, 0x45, 0x4e, 0x9b, 0x1c, 0x4e, 0x0f, 0x86, 0x2d, 0x73, 0x35
+};
+
+
+/* Level limits: level_idc, MaxMBPS, MaxFS (ITU-T H.264 table A-1) */
+static const unsigned int ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS[][3] =
+{
+    { 10, 1485, 99 },
+    { 11, 3000, 396 },
+    { 12, 6000, 396 },
+    { 13, 11880, 396 },
+    { 21, 19800, 792 },
+    { 22, 20250, 1620 },
+    { 30, 40500, 1620 },
+    { 31, 108000, 3600 },
+    { 32, 216000, 5120 },
+    { 40, 245760, 8192 },
+    { 42, 522240, 8704 },
+    { 50, 589824, 22080 },
+    { 51, 983040, 36864 },
+    { 52, 2073600, 36864 },
+};
+
+
+typedef struct ARSTREAM2_H264Generator_Slice_s
+{
+    uint8_t *pIdrTemplate;
+    unsigned int idrTemplateSize;
+    uint8_t *pRefPTemplate;
+    unsigned int refPTemplateSize;
+    uint8_t *pNonRefPTemplate;
+    unsigned int nonRefPTemplateSize;
+    unsigned int maxNaluSize;
+
+} ARSTREAM2_H264Generator_Slice_t;
+
+
+typedef struct ARSTREAM2_H264Generator_s
+{
+    ARSTREAM2_H264Generator_Config_t config;
+    ARSTREAM2_H264Writer_Handle writer;
+
+    uint8_t sps[ARSTREAM2_H264_GENERATOR_PARAM_SET_MAX_SIZE];
+    unsigned int spsSize;
+    uint8_t pps[ARSTREAM2_H264_GENERATOR_PARAM_SET_MAX_SIZE];
+    unsigned int ppsSize;
+
+    int mbWidth;
+    int mbHeight;
+    int mbCount;
+    ARSTREAM2_H264Generator_Slice_t *slice;
+    uint8_t *pUserData;
+    uint16_t *sliceMbCount;
+    uint8_t *pStreamingInfo;
+    unsigned int streamingInfoMaxSize;
+
+    // Target slice sizes in bytes (0 for no padding)
+    unsigned int iSliceSize;
+    unsigned int pSliceSize;
+
+    unsigned int maxAuSize;
+    unsigned int maxNaluCount;
+
+    // Picture state
+    uint64_t auCount;
+    unsigned int framesSinceIdr;
+    unsigned int pFramesSinceIdr;
+    unsigned int idrCount;
+    unsigned int prevRefFrameNum;
+
+} ARSTREAM2_H264Generator_t;
+
+
+static unsigned int ARSTREAM2_H264Generator_GetLevel(int mbCount, float framerate)
+{
+    unsigned int i, count = sizeof(ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS) / sizeof(ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS[0]);
+    double mbRate = (double)mbCount * framerate;
+
+    for (i = 0; i < count; i++)
+    {
+        if (((unsigned int)mbCount <= ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS[i][2]) && (mbRate <= ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS[i][1]))
+        {
+            break;
+        }
+    }
+
+    return ARSTREAM2_H264_GENERATOR_LEVEL_LIMITS[(i < count) ? i : count - 1][0];
+}
+
+
+static int ARSTREAM2_H264Generator_WriteSps(ARSTREAM2_H264Generator_t *generator)
+{
+    ARSTREAM2_H264Writer_Sps_t sps;
+    unsigned int cropRight = generator->mbWidth * 16 - generator->config.width;
+    unsigned int cropBottom = generator->mbHeight * 16 - generator->config.height;
+
+    memset(&sps, 0, sizeof(sps));
+    sps.profileIdc = 66;                                                // baseline
+    sps.constraintSetFlags = 0x40;                                      // constraint_set1_flag = 1 (constrained baseline)
+    sps.levelIdc = ARSTREAM2_H264Generator_GetLevel(generator->mbCount, generator->config.framerate);
+    sps.log2MaxFrameNumMinus4 = ARSTREAM2_H264_GENERATOR_LOG2_MAX_FRAME_NUM - 4;
+    sps.picOrderCntType = 0;
+    sps.log2MaxPicOrderCntLsbMinus4 = ARSTREAM2_H264_GENERATOR_LOG2_MAX_POC_LSB - 4;
+    sps.maxNumRefFrames = 1;
+    sps.picWidthInMbsMinus1 = generator->mbWidth - 1;
+    sps.picHeightInMapUnitsMinus1 = generator->mbHeight - 1;
+    sps.frameMbsOnlyFlag = 1;
+    sps.direct8x8InferenceFlag = 1;
+    if ((cropRight) || (cropBottom))
+    {
+        // crop units are 2 pixels in 4:2:0
+        sps.frameCroppingFlag = 1;
+        sps.frameCropRightOffset = cropRight / 2;
+        sps.frameCropBottomOffset = cropBottom / 2;
+    }
+    sps.vuiParametersPresentFlag = 1;
+    sps.timingInfoPresentFlag = 1;
+    sps.numUnitsInTick = 1000;
+    sps.timeScale = (uint32_t)(generator->config.framerate * 2000.f + 0.5f);
+    sps.fixedFrameRateFlag = 1;
+
+    return (ARSTREAM2_H264Writer_WriteSpsNalu(generator->writer, &sps, generator->sps, sizeof(generator->sps), &generator->spsSize) == ARSTREAM2_OK) ? 0 : -1;
+}
+
+
+static int ARSTREAM2_H264Generator_WritePps(ARSTREAM2_H264Generator_t *generator)
+{
+    ARSTREAM2_H264Writer_Pps_t pps;
+
+    // CAVLC, no weighted prediction, QP 26
+    memset(&pps, 0, sizeof(pps));
+    pps.deblockingFilterControlPresentFlag = 1;
+
+    return (ARSTREAM2_H264Writer_WritePpsNalu(generator->writer, &pps, generator->pps, sizeof(generator->pps), &generator->ppsSize) == ARSTREAM2_OK) ? 0 : -1;
+}
+
+
+/* Write the SPS and PPS with the writer and import their context in the writer through a parser */
+static eARSTREAM2_ERROR ARSTREAM2_H264Generator_SetupWriter(ARSTREAM2_H264Generator_t *generator)
+{
+    ARSTREAM2_H264Parser_Handle parser = NULL;
+    ARSTREAM2_H264Parser_Config_t parserConfig;
+    ARSTREAM2_H264Writer_Config_t writerConfig;
+    void *spsContext = NULL, *ppsContext = NULL;
+    eARSTREAM2_ERROR err;
+
+    memset(&writerConfig, 0, sizeof(writerConfig));
+    writerConfig.naluPrefix = 0;
+
+    err = ARSTREAM2_H264Writer_Init(&generator->writer, &writerConfig);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "ARSTREAM2_H264Writer_Init() failed (%d)", err);
+        return err;
+    }
+
+    if ((ARSTREAM2_H264Generator_WriteSps(generator) != 0) || (ARSTREAM2_H264Generator_WritePps(generator) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Failed to write the SPS/PPS");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    memset(&parserConfig, 0, sizeof(parserConfig));
+    err = ARSTREAM2_H264Parser_Init(&parser, &parserConfig);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "ARSTREAM2_H264Parser_Init() failed (%d)", err);
+        return err;
+    }
+
+    err = ARSTREAM2_H264Parser_SetupNalu_buffer(parser, generator->sps, generator->spsSize);
+    if (err == ARSTREAM2_OK)
+    {
+        err = ARSTREAM2_H264Parser_ParseNalu(parser, NULL);
+    }
+    if (err == ARSTREAM2_OK)
+    {
+        err = ARSTREAM2_H264Parser_SetupNalu_buffer(parser, generator->pps, generator->ppsSize);
+    }
+    if (err == ARSTREAM2_OK)
+    {
+        err = ARSTREAM2_H264Parser_ParseNalu(parser, NULL);
+    }
+    if (err == ARSTREAM2_OK)
+    {
+        err = ARSTREAM2_H264Parser_GetSpsPpsContext(parser, &spsContext, &ppsContext);
+    }
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Failed to parse the SPS/PPS (%d)", err);
+    }
+
+    if (err == ARSTREAM2_OK)
+    {
+        err = ARSTREAM2_H264Writer_SetSpsPpsContext(generator->writer, spsContext, ppsContext);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "ARSTREAM2_H264Writer_SetSpsPpsContext() failed (%d)", err);
+        }
+    }
+
+    ARSTREAM2_H264Parser_Free(parser);
+
+    return err;
+}
+
+
+static eARSTREAM2_ERROR ARSTREAM2_H264Generator_WriteTemplate(ARSTREAM2_H264Generator_t *generator, unsigned int firstMb, unsigned int mbCount,
+                                                              int isIdr, int isRef, uint8_t **ppTemplate, unsigned int *templateSize)
+{
+    ARSTREAM2_H264_SliceContext_t sliceContext;
+    unsigned int bufSize = ARSTREAM2_H264_GENERATOR_SLICE_TEMPLATE_OVERHEAD + mbCount;
+    eARSTREAM2_ERROR err;
+
+    *ppTemplate = malloc(bufSize);
+    if (!*ppTemplate)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Allocation failed (size %d)", bufSize);
+        return ARSTREAM2_ERROR_ALLOC;
+    }
+
+    memset(&sliceContext, 0, sizeof(sliceContext));
+    sliceContext.nal_ref_idc = (isIdr) ? 3 : ((isRef) ? 2 : 0);
+    sliceContext.nal_unit_type = (isIdr) ? ARSTREAM2_H264_NALU_TYPE_SLICE_IDR : ARSTREAM2_H264_NALU_TYPE_SLICE;
+    sliceContext.idrPicFlag = (isIdr) ? 1 : 0;
+    sliceContext.slice_type = (isIdr) ? ARSTREAM2_H264_SLICE_TYPE_I_ALL : ARSTREAM2_H264_SLICE_TYPE_P_ALL;
+    sliceContext.sliceTypeMod5 = sliceContext.slice_type % 5;
+    // idr_pic_id alternates between 1 and 2 which have the same Exp-Golomb code length
+    sliceContext.idr_pic_id = 1;
+
+    if (isIdr)
+    {
+        err = ARSTREAM2_H264Writer_WriteGrayISliceTemplate(generator->writer, firstMb, mbCount, &sliceContext, *ppTemplate, bufSize, templateSize);
+    }
+    else
+    {
+        err = ARSTREAM2_H264Writer_WriteSkippedPSliceTemplate(generator->writer, firstMb, mbCount, &sliceContext, *ppTemplate, bufSize, templateSize);
+    }
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Failed to write the slice template (%d)", err);
+    }
+
+    return err;
+}
+
+
+static eARSTREAM2_ERROR ARSTREAM2_H264Generator_SetupSlices(ARSTREAM2_H264Generator_t *generator)
+{
+    ARSTREAM2_H264Generator_Slice_t *slice;
+    unsigned int firstMb, mbCount, maxSize;
+    eARSTREAM2_ERROR err = ARSTREAM2_OK;
+    int i;
+
+    generator->slice = calloc(generator->config.sliceCount, sizeof(ARSTREAM2_H264Generator_Slice_t));
+    generator->sliceMbCount = calloc(generator->config.sliceCount, sizeof(uint16_t));
+    if ((!generator->slice) || (!generator->sliceMbCount))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Allocation failed");
+        return ARSTREAM2_ERROR_ALLOC;
+    }
+
+    for (i = 0; (i < generator->config.sliceCount) && (err == ARSTREAM2_OK); i++)
+    {
+        slice = &generator->slice[i];
+        firstMb = i * generator->mbCount / generator->config.sliceCount;
+        mbCount = (i + 1) * generator->mbCount / generator->config.sliceCount - firstMb;
+        generator->sliceMbCount[i] = (uint16_t)mbCount;
+
+        err = ARSTREAM2_H264Generator_WriteTemplate(generator, firstMb, mbCount, 1, 1, &slice->pIdrTemplate, &slice->idrTemplateSize);
+        if (err == ARSTREAM2_OK)
+        {
+            err = ARSTREAM2_H264Generator_WriteTemplate(generator, firstMb, mbCount, 0, 1, &slice->pRefPTemplate, &slice->refPTemplateSize);
+        }
+        if (err == ARSTREAM2_OK)
+        {
+            err = ARSTREAM2_H264Generator_WriteTemplate(generator, firstMb, mbCount, 0, 0, &slice->pNonRefPTemplate, &slice->nonRefPTemplateSize);
+        }
+
+        // the emulation prevention adds at most one byte every two bytes
+        maxSize = slice->idrTemplateSize;
+        maxSize = (slice->refPTemplateSize > maxSize) ? slice->refPTemplateSize : maxSize;
+        maxSize = (slice->nonRefPTemplateSize > maxSize) ? slice->nonRefPTemplateSize : maxSize;
+        slice->maxNaluSize = maxSize + maxSize / 2;
+    }
+
+    return err;
+}
+
+
+static void ARSTREAM2_H264Generator_SetupFrameSizes(ARSTREAM2_H264Generator_t *generator)
+{
+    double frameSize, iFrameSize, pFrameSize, ratio = generator->config.iFrameSizeRatio;
+    int gopLength = generator->config.gopLength;
+
+    if (generator->config.bitrate <= 0)
+    {
+        generator->iSliceSize = generator->pSliceSize = 0;
+        return;
+    }
+
+    // the I-frames are larger than the P-frames by the ratio, the average frame size matches the bitrate
+    frameSize = (double)generator->config.bitrate / 8. / generator->config.framerate;
+    if (gopLength == 1)
+    {
+        iFrameSize = pFrameSize = frameSize;
+    }
+    else if (gopLength == 0)
+    {
+        pFrameSize = frameSize;
+        iFrameSize = frameSize * ratio;
+    }
+    else
+    {
+        pFrameSize = frameSize * gopLength / (gopLength - 1 + ratio);
+        iFrameSize = pFrameSize * ratio;
+    }
+
+    generator->iSliceSize = (unsigned int)(iFrameSize / generator->config.sliceCount);
+    generator->pSliceSize = (unsigned int)(pFrameSize / generator->config.sliceCount);
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_Init(ARSTREAM2_H264Generator_Handle* generatorHandle, const ARSTREAM2_H264Generator_Config_t* config)
+{
+    ARSTREAM2_H264Generator_t* generator;
+    unsigned int maxSliceSize, maxSeiSize, i;
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+
+    if (!generatorHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Invalid pointer for handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (!config)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Invalid pointer for config");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((config->width <= 0) || (config->height <= 0) || (config->framerate <= 0.f)
+            || (config->bitrate < 0) || (config->sliceCount < 0) || (config->gopLength < 0)
+            || (config->refFrameInterval < 0) || (config->iFrameSizeRatio < 0.f)
+            || ((config->userDataSeiSize > 0) && (config->userDataSeiSize < 16)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Invalid configuration");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    generator = (ARSTREAM2_H264Generator_t*)malloc(sizeof(*generator));
+    if (!generator)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Allocation failed (size %ld)", sizeof(*generator));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(generator, 0, sizeof(*generator));
+        memcpy(&generator->config, config, sizeof(generator->config));
+        generator->mbWidth = (config->width + 15) / 16;
+        generator->mbHeight = (config->height + 15) / 16;
+        generator->mbCount = generator->mbWidth * generator->mbHeight;
+        if (generator->config.sliceCount == 0)
+        {
+            generator->config.sliceCount = 1;
+        }
+        if (generator->config.sliceCount > generator->mbCount)
+        {
+            generator->config.sliceCount = generator->mbCount;
+        }
+        if (generator->config.iFrameSizeRatio == 0.f)
+        {
+            generator->config.iFrameSizeRatio = ARSTREAM2_H264_GENERATOR_DEFAULT_I_FRAME_SIZE_RATIO;
+        }
+        if ((generator->config.streamingInfoSei) && (generator->config.sliceCount > ARSTREAM2_H264_SEI_PARROT_STREAMING_MAX_SLICE_COUNT))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Too many slices for the streaming info SEI (%d)", generator->config.sliceCount);
+            ret = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        // the crop offsets are in units of 2 pixels
+        generator->config.width &= ~1;
+        generator->config.height &= ~1;
+        ARSTREAM2_H264Generator_SetupFrameSizes(generator);
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        ret = ARSTREAM2_H264Generator_SetupWriter(generator);
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        ret = ARSTREAM2_H264Generator_SetupSlices(generator);
+    }
+
+    if ((ret == ARSTREAM2_OK) && (generator->config.userDataSeiSize > 0))
+    {
+        generator->pUserData = malloc(generator->config.userDataSeiSize);
+        if (!generator->pUserData)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Allocation failed (size %d)", generator->config.userDataSeiSize);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            memset(generator->pUserData, ARSTREAM2_H264_GENERATOR_USER_DATA_FILL, generator->config.userDataSeiSize);
+            memcpy(generator->pUserData, ARSTREAM2_H264_GENERATOR_USER_DATA_UUID, sizeof(ARSTREAM2_H264_GENERATOR_USER_DATA_UUID));
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (generator->config.streamingInfoSei))
+    {
+        generator->streamingInfoMaxSize = sizeof(ARSTREAM2_H264Sei_UserDataParrotStreamingV1_t) + generator->config.sliceCount * sizeof(uint16_t);
+        generator->pStreamingInfo = malloc(generator->streamingInfoMaxSize);
+        if (!generator->pStreamingInfo)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_GENERATOR_TAG, "Allocation failed (size %d)", generator->streamingInfoMaxSize);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        // SPS, PPS, SEI, then a slice and a filler data NAL unit per slice
+        generator->maxNaluCount = 3 + 2 * generator->config.sliceCount;
+        maxSeiSize = (generator->config.userDataSeiSize > 0) ? generator->config.userDataSeiSize + generator->config.userDataSeiSize / 2 + ARSTREAM2_H264_GENERATOR_SEI_OVERHEAD : 0;
+        if (generator->pStreamingInfo)
+        {
+            maxSeiSize += generator->streamingInfoMaxSize + generator->streamingInfoMaxSize / 2 + ARSTREAM2_H264_GENERATOR_SEI_OVERHEAD;
+        }
+        maxSliceSize = (generator->iSliceSize > generator->pSliceSize) ? generator->iSliceSize : generator->pSliceSize;
+        generator->maxAuSize = generator->maxNaluCount * ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH
+                + generator->spsSize + generator->ppsSize + maxSeiSize;
+        for (i = 0; i < (unsigned int)generator->config.sliceCount; i++)
+        {
+            generator->maxAuSize += ((generator->slice[i].maxNaluSize > maxSliceSize) ? generator->slice[i].maxNaluSize : maxSliceSize) + ARSTREAM2_H264_GENERATOR_FILLER_MIN_SIZE;
+        }
+
+        *generatorHandle = (ARSTREAM2_H264Generator_Handle*)generator;
+    }
+    else
+    {
+        ARSTREAM2_H264Generator_Free((ARSTREAM2_H264Generator_Handle)generator);
+        *generatorHandle = NULL;
+    }
+
+    return ret;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_Free(ARSTREAM2_H264Generator_Handle generatorHandle)
+{
+    ARSTREAM2_H264Generator_t* generator = (ARSTREAM2_H264Generator_t*)generatorHandle;
+    int i;
+
+    if (!generatorHandle)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (generator->slice)
+    {
+        for (i = 0; i < generator->config.sliceCount; i++)
+        {
+            free(generator->slice[i].pIdrTemplate);
+            free(generator->slice[i].pRefPTemplate);
+            free(generator->slice[i].pNonRefPTemplate);
+        }
+        free(generator->slice);
+    }
+    free(generator->sliceMbCount);
+    free(generator->pUserData);
+    free(generator->pStreamingInfo);
+    if (generator->writer)
+    {
+        ARSTREAM2_H264Writer_Free(generator->writer);
+    }
+
+    free(generator);
+
+    return ARSTREAM2_OK;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GetMaxAuSize(ARSTREAM2_H264Generator_Handle generatorHandle, unsigned int *maxAuSize, unsigned int *maxNaluCount)
+{
+    ARSTREAM2_H264Generator_t* generator = (ARSTREAM2_H264Generator_t*)generatorHandle;
+
+    if (!generatorHandle)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (maxAuSize) *maxAuSize = generator->maxAuSize;
+    if (maxNaluCount) *maxNaluCount = generator->maxNaluCount;
+
+    return ARSTREAM2_OK;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GetSpsPps(ARSTREAM2_H264Generator_Handle generatorHandle, uint8_t *spsBuffer, int *spsSize, uint8_t *ppsBuffer, int *ppsSize)
+{
+    ARSTREAM2_H264Generator_t* generator = (ARSTREAM2_H264Generator_t*)generatorHandle;
+
+    if ((!generatorHandle) || (!spsSize) || (!ppsSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((spsBuffer) && (*spsSize >= (int)generator->spsSize))
+    {
+        memcpy(spsBuffer, generator->sps, generator->spsSize);
+    }
+    *spsSize = generator->spsSize;
+
+    if ((ppsBuffer) && (*ppsSize >= (int)generator->ppsSize))
+    {
+        memcpy(ppsBuffer, generator->pps, generator->ppsSize);
+    }
+    *ppsSize = generator->ppsSize;
+
+    return ARSTREAM2_OK;
+}
+
+
+/* Reserve the space for a NAL unit in the output buffer, writing the start code if needed */
+static uint8_t* ARSTREAM2_H264Generator_StartNalu(ARSTREAM2_H264Generator_t *generator, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *pos, unsigned int naluSize)
+{
+    unsigned int prefixSize = (generator->config.naluPrefix) ? ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH : 0;
+
+    if (*pos + prefixSize + naluSize > outputBufSize)
+    {
+        return NULL;
+    }
+
+    if (prefixSize)
+    {
+        pbOutputBuf[(*pos)++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 24) & 0xFF;
+        pbOutputBuf[(*pos)++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 16) & 0xFF;
+        pbOutputBuf[(*pos)++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 8) & 0xFF;
+        pbOutputBuf[(*pos)++] = ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE & 0xFF;
+    }
+
+    return pbOutputBuf + *pos;
+}
+
+
+static int ARSTREAM2_H264Generator_AddNaluDesc(ARSTREAM2_StreamSender_H264NaluDesc_t *nalu, unsigned int maxNaluCount, unsigned int *naluCount,
+                                               uint8_t *naluBuffer, unsigned int naluSize, uint64_t auTimestamp)
+{
+    if (nalu)
+    {
+        if (*naluCount >= maxNaluCount)
+        {
+            return -1;
+        }
+        memset(&nalu[*naluCount], 0, sizeof(ARSTREAM2_StreamSender_H264NaluDesc_t));
+        nalu[*naluCount].naluBuffer = naluBuffer;
+        nalu[*naluCount].naluSize = naluSize;
+        nalu[*naluCount].auTimestamp = auTimestamp;
+    }
+    (*naluCount)++;
+
+    return 0;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Generator_GenerateAu(ARSTREAM2_H264Generator_Handle generatorHandle, uint64_t auTimestamp,
+                                                    uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize,
+                                                    ARSTREAM2_StreamSender_H264NaluDesc_t *nalu, unsigned int maxNaluCount,
+                                                    unsigned int *naluCount, int *isIdr)
+{
+    ARSTREAM2_H264Generator_t* generator = (ARSTREAM2_H264Generator_t*)generatorHandle;
+    ARSTREAM2_H264Generator_Slice_t *slice;
+    unsigned int pos = 0, count = 0, size, fillerSize, sliceSize, frameNum, idrPicId = 0, pocLsb;
+    const uint8_t *pTemplate;
+    unsigned int templateSize;
+    int idr, ref, i;
+    uint8_t *p;
+    eARSTREAM2_ERROR err;
+
+    if ((!generatorHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    // Picture type, frame_num and POC
+    idr = ((generator->auCount == 0) || ((generator->config.gopLength > 0) && (generator->framesSinceIdr >= (unsigned int)generator->config.gopLength))) ? 1 : 0;
+    if (idr)
+    {
+        ref = 1;
+        frameNum = 0;
+        idrPicId = 1 + (generator->idrCount & 1);
+        generator->framesSinceIdr = 0;
+        generator->pFramesSinceIdr = 0;
+    }
+    else
+    {
+        ref = ((generator->config.refFrameInterval <= 1) || ((generator->pFramesSinceIdr + 1) % generator->config.refFrameInterval == 0)) ? 1 : 0;
+        frameNum = (generator->prevRefFrameNum + 1) & ((1 << ARSTREAM2_H264_GENERATOR_LOG2_MAX_FRAME_NUM) - 1);
+    }
+    pocLsb = (2 * generator->framesSinceIdr) & ((1 << ARSTREAM2_H264_GENERATOR_LOG2_MAX_POC_LSB) - 1);
+
+    // SPS and PPS
+    if (idr)
+    {
+        p = ARSTREAM2_H264Generator_StartNalu(generator, pbOutputBuf, outputBufSize, &pos, generator->spsSize);
+        if ((!p) || (ARSTREAM2_H264Generator_AddNaluDesc(nalu, maxNaluCount, &count, p, generator->spsSize, auTimestamp) != 0))
+        {
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        memcpy(p, generator->sps, generator->spsSize);
+        pos += generator->spsSize;
+
+        p = ARSTREAM2_H264Generator_StartNalu(generator, pbOutputBuf, outputBufSize, &pos, generator->ppsSize);
+        if ((!p) || (ARSTREAM2_H264Generator_AddNaluDesc(nalu, maxNaluCount, &count, p, generator->ppsSize, auTimestamp) != 0))
+        {
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        memcpy(p, generator->pps, generator->ppsSize);
+        pos += generator->ppsSize;
+    }
+
+    // SEI
+    if ((generator->pUserData) || (generator->pStreamingInfo))
+    {
+        const uint8_t *pbUserData[2];
+        unsigned int userDataSize[2], userDataCount = 0;
+
+        if (generator->pStreamingInfo)
+        {
+            ARSTREAM2_H264Sei_ParrotStreamingV1_t streamingInfo;
+
+            streamingInfo.indexInGop = (uint8_t)generator->framesSinceIdr;
+            streamingInfo.sliceCount = (uint8_t)generator->config.sliceCount;
+            if (ARSTREAM2_H264Sei_SerializeUserDataParrotStreamingV1(&streamingInfo, generator->sliceMbCount, generator->pStreamingInfo,
+                                                                     generator->streamingInfoMaxSize, &size) != ARSTREAM2_OK)
+            {
+                return ARSTREAM2_ERROR_INVALID_STATE;
+            }
+            pbUserData[userDataCount] = generator->pStreamingInfo;
+            userDataSize[userDataCount++] = size;
+        }
+
+        if (generator->pUserData)
+        {
+            // the access unit index follows the UUID
+            if (generator->config.userDataSeiSize >= 24)
+            {
+                for (i = 0; i < 8; i++)
+                {
+                    generator->pUserData[16 + i] = (uint8_t)(generator->auCount >> (56 - 8 * i));
+                }
+            }
+            pbUserData[userDataCount] = generator->pUserData;
+            userDataSize[userDataCount++] = generator->config.userDataSeiSize;
+        }
+
+        p = ARSTREAM2_H264Generator_StartNalu(generator, pbOutputBuf, outputBufSize, &pos, 0);
+        if ((!p) || (ARSTREAM2_H264Writer_WriteSeiNalu(generator->writer, NULL, NULL, userDataCount, pbUserData, userDataSize, p, outputBufSize - pos, &size) != 0)
+                || (ARSTREAM2_H264Generator_AddNaluDesc(nalu, maxNaluCount, &count, p, size, auTimestamp) != 0))
+        {
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        pos += size;
+    }
+
+    // Slices, padded to the target size with filler data
+    sliceSize = (idr) ? generator->iSliceSize : generator->pSliceSize;
+    for (i = 0; i < generator->config.sliceCount; i++)
+    {
+        slice = &generator->slice[i];
+        if (idr)
+        {
+            pTemplate = slice->pIdrTemplate;
+            templateSize = slice->idrTemplateSize;
+        }
+        else if (ref)
+        {
+            pTemplate = slice->pRefPTemplate;
+            templateSize = slice->refPTemplateSize;
+        }
+        else
+        {
+            pTemplate = slice->pNonRefPTemplate;
+            templateSize = slice->nonRefPTemplateSize;
+        }
+
+        p = ARSTREAM2_H264Generator_StartNalu(generator, pbOutputBuf, outputBufSize, &pos, 0);
+        if (!p)
+        {
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        err = ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate(generator->writer, pTemplate, templateSize, frameNum, idrPicId, pocLsb,
+                                                              p, outputBufSize - pos, &size);
+        if (err != ARSTREAM2_OK)
+        {
+            return (err == ARSTREAM2_ERROR_INVALID_STATE) ? ARSTREAM2_ERROR_BAD_PARAMETERS : err;
+        }
+        if (ARSTREAM2_H264Generator_AddNaluDesc(nalu, maxNaluCount, &count, p, size, auTimestamp) != 0)
+        {
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        pos += size;
+
+        if (sliceSize >= size + ARSTREAM2_H264_GENERATOR_FILLER_MIN_SIZE)
+        {
+            fillerSize = sliceSize - size;
+            p = ARSTREAM2_H264Generator_StartNalu(generator, pbOutputBuf, outputBufSize, &pos, fillerSize);
+            if ((!p) || (ARSTREAM2_H264Generator_AddNaluDesc(nalu, maxNaluCount, &count, p, fillerSize, auTimestamp) != 0))
+            {
+                return ARSTREAM2_ERROR_BAD_PARAMETERS;
+            }
+            // filler_data_rbsp: 0xFF bytes then rbsp_trailing_bits
+            p[0] = ARSTREAM2_H264_NALU_TYPE_FILLER_DATA;
+            memset(p + 1, 0xFF, fillerSize - 2);
+            p[fillerSize - 1] = 0x80;
+            pos += fillerSize;
+        }
+    }
+
+    if ((nalu) && (count > 0))
+    {
+        nalu[count - 1].isLastNaluInAu = 1;
+    }
+
+    // Update the picture state
+    if (idr)
+    {
+        generator->idrCount++;
+    }
+    else
+    {
+        generator->pFramesSinceIdr++;
+    }
+    if (ref)
+    {
+        generator->prevRefFrameNum = frameNum;
+    }
+    generator->framesSinceIdr++;
+    generator->auCount++;
+
+    *outputSize = pos;
+    if (naluCount) *naluCount = count;
+    if (isIdr) *isIdr = idr;
+
+    return ARSTREAM2_OK;
+}
@@ -14,6 +14,11 @@
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <arpa/inet.h>
 
 #include <libARSAL/ARSAL_Print.h>
@@ -25,6 +30,14 @@
 #define ARSTREAM2_H264_PARSER_TAG "ARSTREAM2_H264Parser"
 
 #define ARSTREAM2_H264_PARSER_MAX_USER_DATA_SEI_COUNT (16)
+#define ARSTREAM2_H264_PARSER_RBSP_CHUNK_SIZE (256)
+/* The first chunk is smaller as most of the time only the NALU header is parsed */
+#define ARSTREAM2_H264_PARSER_RBSP_FIRST_CHUNK_SIZE (32)
+
+/* Mapped file window size when the whole file cannot be mapped (32-bit address space) */
+#define ARSTREAM2_H264_PARSER_MAPPED_FILE_WINDOW_SIZE (64 * 1024 * 1024)
+/* Maximum size of a single start code search in a mapped file */
+#define ARSTREAM2_H264_PARSER_MAPPED_FILE_SEARCH_SIZE (1024 * 1024 * 1024)
 #define log2(x) (log(x) / log(2)) //TODO
 
 
@@ -39,11 +52,24 @@ typedef struct ARSTREAM2_H264Parser_s
     int naluBufManaged;
     unsigned int naluSize;      // in bytes
     unsigned int remNaluSize;   // in bytes
+
+    // Mapped file input
+    int mapFd;
+    uint8_t* pMap;
+    off_t mapOffset;
+    off_t mapSize;
+    off_t mapWindowSize;
+    off_t mapFileSize;
+    off_t mapPos;
     
+    // RBSP buffer (NALU chunk with emulation prevention bytes removed)
+    uint8_t rbspBuf[ARSTREAM2_H264_PARSER_RBSP_CHUNK_SIZE];
+    uint8_t* pRbspBufCur;
+    unsigned int remRbspSize;   // in bytes
+
     // Bitstream cache
-    uint32_t cache;
+    uint64_t cache;
     int cacheLength;   // in bits
-    int oldZeroCount;
 
     // SPS/PPS context
     ARSTREAM2_H264_SpsContext_t spsContext;
@@ -53,6 +79,8 @@ typedef struct ARSTREAM2_H264Parser_s
 
     // Slice context
     ARSTREAM2_H264_SliceContext_t sliceContext;
+    int lazyParsing;
+    int sliceContextPartial;
 
     // User data SEI
     uint8_t* pUserDataBuf[ARSTREAM2_H264_PARSER_MAX_USER_DATA_SEI_COUNT];
@@ -189,215 +217,174 @@ static inline int bitstreamByteAlign(ARSTREAM2_H264Parser_t* _parser)
 }
 
 
-static inline int readBits(ARSTREAM2_H264Parser_t* _parser, unsigned int _numBits, uint32_t *_value, int _emulationPrevention)
+static inline void bitstreamUnescape(ARSTREAM2_H264Parser_t* _parser)
 {
-    unsigned int _count, _remBits = _numBits;
-    uint32_t _val = 0, _bitMask;
-    uint8_t _read8;
+    // Copy the next chunk of the NALU to the RBSP buffer, removing the emulation prevention bytes
+    unsigned int _outSize = 0, _offset, _size, _chunkSize;
+    int _pos;
 
-    while (_parser->cacheLength < (int)_remBits)
+    _chunkSize = (_parser->pNaluBufCur == _parser->pNaluBuf) ? ARSTREAM2_H264_PARSER_RBSP_FIRST_CHUNK_SIZE : ARSTREAM2_H264_PARSER_RBSP_CHUNK_SIZE;
+    while ((_outSize < _chunkSize) && (_parser->remNaluSize))
     {
-        // Not enough bits in the cache
-
-        if (_parser->remNaluSize == 0)
+        _size = _chunkSize - _outSize;
+        if (_size > _parser->remNaluSize)
         {
-            // No more bytes to read
-            return -1;
+            _size = _parser->remNaluSize;
         }
-
-        // Get the cache remaining bits
-        _remBits -= _parser->cacheLength;
-        _val = (_parser->cache >> (32 - _parser->cacheLength)) << _remBits;
-
-        // Read at most 4 bytes in the buffer
-        _parser->cache = 0;
-        _parser->cacheLength = 0;
-        _count = 0;
-        while ((_parser->remNaluSize) && (_count < 4))
+        _offset = (unsigned int)(_parser->pNaluBufCur - _parser->pNaluBuf);
+        _pos = ARSTREAM2_H264_FindEmulationPreventionByte(_parser->pNaluBuf, _offset + _size, _offset);
+        if (_pos >= 0)
         {
-            _read8 = *(_parser->pNaluBufCur++);
-            _parser->remNaluSize--;
-            _parser->cache |= (_read8 << (24 - _parser->cacheLength));
-            _parser->cacheLength += 8;
-            _count++;
+            // Copy up to the 0x03 byte and skip it
+            _size = (unsigned int)_pos - _offset;
+            memcpy(_parser->rbspBuf + _outSize, _parser->pNaluBufCur, _size);
+            _outSize += _size;
+            _parser->pNaluBufCur += _size + 1;
+            _parser->remNaluSize -= _size + 1;
         }
-
-        // Emulation prevention
-        if (_emulationPrevention)
+        else
         {
-            int _zeroCount = _parser->oldZeroCount;
-            int _bitPos = 24; //32 - _parser->cacheLength;
-            uint8_t _byteVal;
-            uint32_t _cacheLeft, _cacheRight;
+            memcpy(_parser->rbspBuf + _outSize, _parser->pNaluBufCur, _size);
+            _outSize += _size;
+            _parser->pNaluBufCur += _size;
+            _parser->remNaluSize -= _size;
+        }
+    }
+
+    _parser->pRbspBufCur = _parser->rbspBuf;
+    _parser->remRbspSize = _outSize;
+}
 
-            while (_bitPos >= 32 - _parser->cacheLength)
+
+static inline void bitstreamRefill(ARSTREAM2_H264Parser_t* _parser)
+{
+    // Fill the cache with whole bytes from the RBSP buffer
+    while (_parser->cacheLength <= 56)
+    {
+        if (!_parser->remRbspSize)
+        {
+            if (!_parser->remNaluSize)
             {
-                _byteVal = ((_parser->cache >> _bitPos) & 0xFF);
-                if ((_zeroCount == 2) && (_byteVal == 0x03))
-                {
-                    // Remove the 0x03 byte
-                    _cacheLeft = (_bitPos < 24) ? (_parser->cache >> (_bitPos + 8)) << (_bitPos + 8) : 0;
-                    _cacheRight = (_bitPos > 0) ? (_parser->cache << (32 - _bitPos)) >> (32 - _bitPos - 8) : 0;
-                    _parser->cache = _cacheLeft | _cacheRight;
-                    _parser->cacheLength -= 8;
-                    _zeroCount = 0;
-                }
-                else if (_byteVal == 0x00)
-                {
-                    _zeroCount++;
-                    _bitPos -= 8;
-                }
-                else
-                {
-                    _zeroCount = 0;
-                    _bitPos -= 8;
-                }
+                break;
+            }
+            bitstreamUnescape(_parser);
+            if (!_parser->remRbspSize)
+            {
+                break;
             }
-            _parser->oldZeroCount = _zeroCount;
         }
+        _parser->cache |= (uint64_t)*(_parser->pRbspBufCur++) << (56 - _parser->cacheLength);
+        _parser->cacheLength += 8;
+        _parser->remRbspSize--;
     }
-
-    // Get the bits from the cache and shift
-    _val |= _parser->cache >> (32 - _remBits);
-    _parser->cache <<= _remBits;
-    _parser->cacheLength -= _remBits;
-
-    _bitMask = (uint32_t)-1 >> (32 - _numBits);
-    if (_value) *_value = _val & _bitMask;
-    return _numBits;
 }
 
 
-static inline int peekBits(ARSTREAM2_H264Parser_t* _parser, unsigned int _numBits, uint32_t *_value, int _emulationPrevention)
+static inline int readBits(ARSTREAM2_H264Parser_t* _parser, unsigned int _numBits, uint32_t *_value)
 {
-    unsigned int _count, _remBits = _numBits;
-    uint32_t _val = 0, _bitMask;
-    uint8_t _read8;
-    int _cacheLength = _parser->cacheLength;
-    int _remNaluSize = _parser->remNaluSize;
-    int _oldZeroCount = _parser->oldZeroCount;
-    int _offset = 0;
-    uint32_t _cache = _parser->cache;
+    uint32_t _val = 0;
 
-    while (_cacheLength < (int)_remBits)
+    if (_numBits > 32)
     {
-        // Not enough bits in the cache
+        return -1;
+    }
 
-        if (_remNaluSize == 0)
+    if (_parser->cacheLength < (int)_numBits)
+    {
+        bitstreamRefill(_parser);
+        if (_parser->cacheLength < (int)_numBits)
         {
             // No more bytes to read
             return -1;
         }
+    }
 
-        // Get the cache remaining bits
-        _remBits -= _cacheLength;
-        _val = (_cache >> (32 - _cacheLength)) << _remBits;
+    if (_numBits)
+    {
+        _val = (uint32_t)(_parser->cache >> (64 - _numBits));
+        _parser->cache <<= _numBits;
+        _parser->cacheLength -= _numBits;
+    }
 
-        // Read at most 4 bytes in the buffer
-        _cache = 0;
-        _cacheLength = 0;
-        _count = 0;
-        while ((_remNaluSize) && (_count < 4))
-        {
-            _read8 = *(_parser->pNaluBufCur + _offset);
-            _offset++;
-            _remNaluSize--;
-            _cache |= (_read8 << (24 - _cacheLength));
-            _cacheLength += 8;
-            _count++;
-        }
+    if (_value) *_value = _val;
+    return _numBits;
+}
 
-        // Emulation prevention
-        if (_emulationPrevention)
-        {
-            int _zeroCount = _oldZeroCount;
-            int _bitPos = 24; //32 - _cacheLength;
-            uint8_t _byteVal;
-            uint32_t _cacheLeft, _cacheRight;
 
-            while (_bitPos >= 32 - _cacheLength)
-            {
-                _byteVal = ((_cache >> _bitPos) & 0xFF);
-                if ((_zeroCount == 2) && (_byteVal == 0x03))
-                {
-                    // Remove the 0x03 byte
-                    _cacheLeft = (_bitPos < 24) ? (_cache >> (_bitPos + 8)) << (_bitPos + 8) : 0;
-                    _cacheRight = (_bitPos > 0) ? (_cache << (32 - _bitPos)) >> (32 - _bitPos - 8) : 0;
-                    _cache = _cacheLeft | _cacheRight;
-                    _cacheLength -= 8;
-                    _zeroCount = 0;
-                }
-                else if (_byteVal == 0x00)
-                {
-                    _zeroCount++;
-                    _bitPos -= 8;
-                }
-                else
-                {
-                    _zeroCount = 0;
-                    _bitPos -= 8;
-                }
-            }
-            _oldZeroCount = _zeroCount;
-        }
+static inline int peekBits(ARSTREAM2_H264Parser_t* _parser, unsigned int _numBits, uint32_t *_value)
+{
+    if (_numBits > 32)
+    {
+        return -1;
     }
 
-    // Get the bits from the cache and shift
-    _val |= _cache >> (32 - _remBits);
-    _cache <<= _remBits;
-    _cacheLength -= _remBits;
+    if (_parser->cacheLength < (int)_numBits)
+    {
+        bitstreamRefill(_parser);
+        if (_parser->cacheLength < (int)_numBits)
+        {
+            // No more bytes to read
+            return -1;
+        }
+    }
 
-    _bitMask = (uint32_t)-1 >> (32 - _numBits);
-    if (_value) *_value = _val & _bitMask;
+    if (_value) *_value = (_numBits) ? (uint32_t)(_parser->cache >> (64 - _numBits)) : 0;
     return _numBits;
 }
 
 
-static inline int readBits_expGolomb_ue(ARSTREAM2_H264Parser_t* _parser, uint32_t *_value, int _emulationPrevention)
+static inline int readBits_expGolomb_code(ARSTREAM2_H264Parser_t* _parser, uint32_t *_value)
 {
-    int _ret, _leadingZeroBits = -1;
-    uint32_t _b, _val;
+    int _leadingZeroBits, _codeLength;
+
+    if (_parser->cacheLength < 32)
+    {
+        bitstreamRefill(_parser);
+    }
 
-    for (_b = 0; !_b; _leadingZeroBits++)
+    // The bits after cacheLength are always 0 in the cache
+    _leadingZeroBits = (_parser->cache) ? __builtin_clzll(_parser->cache) : 64;
+    if ((_leadingZeroBits >= _parser->cacheLength) || (_leadingZeroBits > 31))
     {
-        _ret = readBits(_parser, 1, &_b, _emulationPrevention);
-        if (_ret != 1) return -1;
+        return -1;
     }
 
-    _b = 0;
-    if (_leadingZeroBits)
+    _codeLength = _leadingZeroBits * 2 + 1;
+    if (_codeLength > _parser->cacheLength)
     {
-        _ret = readBits(_parser, _leadingZeroBits, &_b, _emulationPrevention);
-        if (_ret < 0) return -1;
+        // Long code: skip the prefix and read the suffix after a refill
+        uint32_t _suffix;
+        _parser->cache <<= _leadingZeroBits + 1;
+        _parser->cacheLength -= _leadingZeroBits + 1;
+        if (readBits(_parser, _leadingZeroBits, &_suffix) < 0) return -1;
+        *_value = (uint32_t)(((uint64_t)1 << _leadingZeroBits) - 1 + _suffix);
+        return _codeLength;
     }
 
-    _val = (1 << _leadingZeroBits) - 1 + _b;
-    *_value = _val;
-    return _leadingZeroBits * 2 + 1;
+    *_value = (uint32_t)((_parser->cache >> (64 - _codeLength)) - 1);
+    _parser->cache <<= _codeLength;
+    _parser->cacheLength -= _codeLength;
+
+    return _codeLength;
 }
 
 
-static inline int readBits_expGolomb_se(ARSTREAM2_H264Parser_t* _parser, int32_t *_value, int _emulationPrevention)
+static inline int readBits_expGolomb_ue(ARSTREAM2_H264Parser_t* _parser, uint32_t *_value)
 {
-    int _ret, _leadingZeroBits = -1;
-    uint32_t _b, _val;
+    return readBits_expGolomb_code(_parser, _value);
+}
 
-    for (_b = 0; !_b; _leadingZeroBits++)
-    {
-        _ret = readBits(_parser, 1, &_b, _emulationPrevention);
-        if (_ret != 1) return -1;
-    }
 
-    _b = 0;
-    if (_leadingZeroBits)
-    {
-        _ret = readBits(_parser, _leadingZeroBits, &_b, _emulationPrevention);
-        if (_ret < 0) return -1;
-    }
+static inline int readBits_expGolomb_se(ARSTREAM2_H264Parser_t* _parser, int32_t *_value)
+{
+    int _ret;
+    uint32_t _val;
 
-    _val = (1 << _leadingZeroBits) - 1 + _b;
-    *_value = (_val & 1) ? (((int32_t)_val + 1) / 2) : (-((int32_t)_val + 1) / 2);
-    return _leadingZeroBits * 2 + 1;
+    _ret = readBits_expGolomb_code(_parser, &_val);
+    if (_ret < 0) return -1;
+
+    *_value = (_val & 1) ? (int32_t)((_val >> 1) + 1) : -(int32_t)(_val >> 1);
+    return _ret;
 }
 
 
@@ -408,7 +395,7 @@ static inline int skipBytes(ARSTREAM2_H264Parser_t* _parser, int _byteCount)
 
     for (_i = 0; _i < _byteCount; _i++)
     {
-        _ret = readBits(_parser, 8, &_val, 1);
+        _ret = readBits(_parser, 8, &_val);
         if (_ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -426,12 +413,14 @@ static inline int moreRbspData(ARSTREAM2_H264Parser_t* _parser)
     int _ret, _retval = 0;
     uint32_t _val;
 
-    if ((_parser->cacheLength == 0) && (_parser->remNaluSize == 0))
+    bitstreamRefill(_parser);
+
+    if (_parser->cacheLength == 0)
     {
         // No more bits available
         _retval = 0;
     }
-    else if (_parser->cacheLength + _parser->remNaluSize * 8 > 8)
+    else if (_parser->cacheLength > 8)
     {
         // More than 1 byte remaining
         _retval = 1;
@@ -439,10 +428,10 @@ static inline int moreRbspData(ARSTREAM2_H264Parser_t* _parser)
     else
     {
         // 8 bits max remaining
-        int _remaining = _parser->cacheLength + _parser->remNaluSize * 8;
+        int _remaining = _parser->cacheLength;
         int _i = 1;
 
-        _ret = peekBits(_parser, _remaining, &_val, 1);
+        _ret = peekBits(_parser, _remaining, &_val);
         if (_ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -489,7 +478,7 @@ static int ARSTREAM2_H264Parser_ParseScalingList(ARSTREAM2_H264Parser_t* parser,
         if (nextScale != 0)
         {
             // delta_scale
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -517,7 +506,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ hrd_parameters()");
 
     // cpb_cnt_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -528,7 +517,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- cpb_cnt_minus1 = %d", val);
 
     // bit_rate_scale
-    ret = readBits(parser, 4, &val, 1);
+    ret = readBits(parser, 4, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -538,7 +527,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- bit_rate_scale = %d", val);
 
     // cpb_size_scale
-    ret = readBits(parser, 4, &val, 1);
+    ret = readBits(parser, 4, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -550,7 +539,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     for (i = 0; i <= parser->spsContext.cpb_cnt_minus1; i++)
     {
         // bit_rate_value_minus1
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -560,7 +549,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- bit_rate_value_minus1[%d] = %d", i, val);
 
         // cpb_size_value_minus1
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -570,7 +559,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- cpb_size_value_minus1[%d] = %d", i, val);
 
         // cbr_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -581,7 +570,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     }
 
     // initial_cpb_removal_delay_length_minus1
-    ret = readBits(parser, 5, &val, 1);
+    ret = readBits(parser, 5, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -592,7 +581,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- initial_cpb_removal_delay_length_minus1 = %d", val);
 
     // cpb_removal_delay_length_minus1
-    ret = readBits(parser, 5, &val, 1);
+    ret = readBits(parser, 5, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -603,7 +592,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- cpb_removal_delay_length_minus1 = %d", val);
 
     // dpb_output_delay_length_minus1
-    ret = readBits(parser, 5, &val, 1);
+    ret = readBits(parser, 5, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -614,7 +603,7 @@ static int ARSTREAM2_H264Parser_ParseHrdParams(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- dpb_output_delay_length_minus1 = %d", val);
 
     // time_offset_length
-    ret = readBits(parser, 5, &val, 1);
+    ret = readBits(parser, 5, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -638,7 +627,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- vui_parameters()");
 
     // aspect_ratio_info_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -650,7 +639,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // aspect_ratio_idc
-        ret = readBits(parser, 8, &val, 1);
+        ret = readBits(parser, 8, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -662,7 +651,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (val == 255)
         {
             // sar_width
-            ret = readBits(parser, 16, &val, 1);
+            ret = readBits(parser, 16, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -672,7 +661,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ sar_width = %d", val);
 
             // sar_height
-            ret = readBits(parser, 16, &val, 1);
+            ret = readBits(parser, 16, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -684,7 +673,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // overscan_info_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -696,7 +685,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // overscan_appropriate_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -707,7 +696,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // video_signal_type_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -719,7 +708,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // video_format
-        ret = readBits(parser, 3, &val, 1);
+        ret = readBits(parser, 3, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -729,7 +718,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ video_format = %d", val);
 
         // video_full_range_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -739,7 +728,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ video_full_range_flag = %d", val);
 
         // colour_description_present_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -751,7 +740,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (val)
         {
             // colour_primaries
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -761,7 +750,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ colour_primaries = %d", val);
 
             // transfer_characteristics
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -771,7 +760,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ transfer_characteristics = %d", val);
 
             // matrix_coefficients
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -784,7 +773,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // chroma_loc_info_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -796,7 +785,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // chroma_sample_loc_type_top_field
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -806,7 +795,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ chroma_sample_loc_type_top_field = %d", val);
 
         // chroma_sample_loc_type_bottom_field
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -817,7 +806,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // timing_info_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -829,7 +818,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // num_units_in_tick
-        ret = readBits(parser, 32, &val, 1);
+        ret = readBits(parser, 32, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -840,7 +829,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ num_units_in_tick = %d", val);
         
         // time_scale
-        ret = readBits(parser, 32, &val, 1);
+        ret = readBits(parser, 32, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -851,7 +840,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ time_scale = %d", val);
         
         // fixed_frame_rate_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -862,7 +851,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // nal_hrd_parameters_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -885,7 +874,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // vcl_hrd_parameters_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -910,7 +899,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (parser->spsContext.nal_hrd_parameters_present_flag || parser->spsContext.vcl_hrd_parameters_present_flag)
     {
         // low_delay_hrd_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -921,7 +910,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     }
 
     // pic_struct_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -932,7 +921,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ pic_struct_present_flag = %d", val);
     
     // bitstream_restriction_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -944,7 +933,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // motion_vectors_over_pic_boundaries_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -954,7 +943,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ motion_vectors_over_pic_boundaries_flag = %d", val);
 
         // max_bytes_per_pic_denom
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -964,7 +953,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ max_bytes_per_pic_denom = %d", val);
 
         // max_bits_per_mb_denom
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -974,7 +963,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ max_bits_per_mb_denom = %d", val);
 
         // log2_max_mv_length_horizontal
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -984,7 +973,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ log2_max_mv_length_horizontal = %d", val);
 
         // log2_max_mv_length_vertical
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -994,7 +983,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ log2_max_mv_length_vertical = %d", val);
 
         // max_num_reorder_frames
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1004,7 +993,7 @@ static int ARSTREAM2_H264Parser_ParseVui(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ max_num_reorder_frames = %d", val);
 
         // max_dec_frame_buffering
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1031,7 +1020,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     
     // seq_parameter_set_data
 
-    ret = readBits(parser, 24, &val, 1);
+    ret = readBits(parser, 24, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1068,7 +1057,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- level_idc = %d", val & 0xFF);
 
     // seq_parameter_set_id
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1082,7 +1071,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
             || profile_idc == 118 || profile_idc == 128 || profile_idc == 138)
     {
         // chroma_format_idc
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1095,7 +1084,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (val == 3)
         {
             // separate_colour_plane_flag
-            ret = readBits(parser, 1, &val, 1);
+            ret = readBits(parser, 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1107,7 +1096,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         }
 
         // bit_depth_luma_minus8
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1117,7 +1106,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- bit_depth_luma_minus8 = %d", val);
 
         // bit_depth_chroma_minus8
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1127,7 +1116,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- bit_depth_chroma_minus8 = %d", val);
 
         // qpprime_y_zero_transform_bypass_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1137,7 +1126,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- qpprime_y_zero_transform_bypass_flag = %d", val);
 
         // seq_scaling_matrix_present_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1151,7 +1140,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
             for (i = 0; i < ((parser->spsContext.chroma_format_idc != 3) ? 8 : 12); i++)
             {
                 // seq_scaling_list_present_flag
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1175,7 +1164,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // log2_max_frame_num_minus4
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1186,7 +1175,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- log2_max_frame_num_minus4 = %d", val);
 
     // pic_order_cnt_type
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1199,7 +1188,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->spsContext.pic_order_cnt_type == 0)
     {
         // log2_max_pic_order_cnt_lsb_minus4
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1212,7 +1201,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     else if (parser->spsContext.pic_order_cnt_type == 1)
     {
         // delta_pic_order_always_zero_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1223,7 +1212,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- delta_pic_order_always_zero_flag = %d", val);
 
         // offset_for_non_ref_pic
-        ret = readBits_expGolomb_se(parser, &val_se, 1);
+        ret = readBits_expGolomb_se(parser, &val_se);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1233,7 +1222,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- offset_for_non_ref_pic = %d", val_se);
 
         // offset_for_top_to_bottom_field
-        ret = readBits_expGolomb_se(parser, &val_se, 1);
+        ret = readBits_expGolomb_se(parser, &val_se);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1243,7 +1232,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- offset_for_top_to_bottom_field = %d", val_se);
 
         // num_ref_frames_in_pic_order_cnt_cycle
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1256,7 +1245,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         for (i = 0; i < num_ref_frames_in_pic_order_cnt_cycle; i++)
         {
             // offset_for_ref_frame
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1268,7 +1257,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // max_num_ref_frames
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1278,7 +1267,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- max_num_ref_frames = %d", val);
 
     // gaps_in_frame_num_value_allowed_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1288,7 +1277,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- gaps_in_frame_num_value_allowed_flag = %d", val);
 
     // pic_width_in_mbs_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1300,7 +1289,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- pic_width_in_mbs_minus1 = %d (width = %d pixels)", val, width);
 
     // pic_height_in_map_units_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1312,7 +1301,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- pic_height_in_map_units_minus1 = %d", val);
 
     // frame_mbs_only_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1326,7 +1315,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (!val)
     {
         // mb_adaptive_frame_field_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1337,7 +1326,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // direct_8x8_inference_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1347,7 +1336,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- direct_8x8_inference_flag = %d", val);
 
     // frame_cropping_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1359,7 +1348,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     if (val)
     {
         // frame_crop_left_offset
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1369,7 +1358,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- frame_crop_left_offset = %d", val);
 
         // frame_crop_right_offset
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1379,7 +1368,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- frame_crop_right_offset = %d", val);
 
         // frame_crop_top_offset
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1389,7 +1378,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- frame_crop_top_offset = %d", val);
 
         // frame_crop_bottom_offset
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1400,7 +1389,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // vui_parameters_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1422,7 +1411,7 @@ static int ARSTREAM2_H264Parser_ParseSps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // rbsp_trailing_bits
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1456,7 +1445,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-- pic_parameter_set_rbsp()");
 
     // pic_parameter_set_id
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1466,7 +1455,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- pic_parameter_set_id = %d", val);
 
     // seq_parameter_set_id
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1476,7 +1465,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- seq_parameter_set_id = %d", val);
 
     // entropy_coding_mode_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1487,7 +1476,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- entropy_coding_mode_flag = %d", val);
 
     // bottom_field_pic_order_in_frame_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1498,7 +1487,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- bottom_field_pic_order_in_frame_present_flag = %d", val);
 
     // num_slice_groups_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1511,7 +1500,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->ppsContext.num_slice_groups_minus1 > 0)
     {
         // slice_group_map_type
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1526,7 +1515,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
             for (i = 0; i <= parser->ppsContext.num_slice_groups_minus1; i++)
             {
                 // run_length_minus1[i]
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1541,7 +1530,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
             for (i = 0; i < parser->ppsContext.num_slice_groups_minus1; i++)
             {
                 // top_left[i]
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1551,7 +1540,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- top_left[%d] = %d", i, val);
 
                 // bottom_right[i]
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1564,7 +1553,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
         else if ((parser->ppsContext.slice_group_map_type == 3) || (parser->ppsContext.slice_group_map_type == 4) || (parser->ppsContext.slice_group_map_type == 5))
         {
             // slice_group_change_direction_flag
-            ret = readBits(parser, 1, &val, 1);
+            ret = readBits(parser, 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1574,7 +1563,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- slice_group_change_direction_flag = %d", val);
 
             // slice_group_change_rate_minus1
-            ret = readBits_expGolomb_ue(parser, &val, 1);
+            ret = readBits_expGolomb_ue(parser, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1587,7 +1576,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
         else if (parser->ppsContext.slice_group_map_type == 6)
         {
             // pic_size_in_map_units_minus1
-            ret = readBits_expGolomb_ue(parser, &val, 1);
+            ret = readBits_expGolomb_ue(parser, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1601,7 +1590,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
             {
                 // slice_group_id[i]
                 len = (int)ceil(log2(parser->ppsContext.num_slice_groups_minus1 + 1));
-                ret = readBits(parser, len, &val, 1);
+                ret = readBits(parser, len, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1614,7 +1603,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     }
 
     // num_ref_idx_l0_default_active_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1625,7 +1614,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- num_ref_idx_l0_default_active_minus1 = %d", val);
 
     // num_ref_idx_l1_default_active_minus1
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1636,7 +1625,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- num_ref_idx_l1_default_active_minus1 = %d", val);
 
     // weighted_pred_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1647,7 +1636,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- weighted_pred_flag = %d", val);
 
     // weighted_bipred_idc
-    ret = readBits(parser, 2, &val, 1);
+    ret = readBits(parser, 2, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1658,7 +1647,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- weighted_bipred_idc = %d", val);
 
     // pic_init_qp_minus26
-    ret = readBits_expGolomb_se(parser, &val_se, 1);
+    ret = readBits_expGolomb_se(parser, &val_se);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1668,7 +1657,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- pic_init_qp_minus26 = %d", val_se);
 
     // pic_init_qs_minus26
-    ret = readBits_expGolomb_se(parser, &val_se, 1);
+    ret = readBits_expGolomb_se(parser, &val_se);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1678,7 +1667,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- pic_init_qs_minus26 = %d", val_se);
 
     // chroma_qp_index_offset
-    ret = readBits_expGolomb_se(parser, &val_se, 1);
+    ret = readBits_expGolomb_se(parser, &val_se);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1688,7 +1677,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- chroma_qp_index_offset = %d", val_se);
 
     // deblocking_filter_control_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1699,7 +1688,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- deblocking_filter_control_present_flag = %d", val);
 
     // constrained_intra_pred_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1709,7 +1698,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- constrained_intra_pred_flag = %d", val);
 
     // redundant_pic_cnt_present_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1723,7 +1712,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
     if (moreRbspData(parser))
     {
         // transform_8x8_mode_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1734,7 +1723,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- transform_8x8_mode_flag = %d", val);
 
         // pic_scaling_matrix_present_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1748,7 +1737,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
             for (i = 0; i < 6 + ((parser->spsContext.chroma_format_idc != 3) ? 2 : 6) * transform_8x8_mode_flag; i++)
             {
                 // pic_scaling_list_present_flag[i]
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1771,7 +1760,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
         }
 
         // second_chroma_qp_index_offset
-        ret = readBits_expGolomb_se(parser, &val_se, 1);
+        ret = readBits_expGolomb_se(parser, &val_se);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1783,7 +1772,7 @@ static int ARSTREAM2_H264Parser_ParsePps(ARSTREAM2_H264Parser_t* parser)
 
 
     // rbsp_trailing_bits
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1821,7 +1810,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_userDataUnregistered(ARSTREAM2_H
     }
     
     // uuid_iso_iec_11578
-    ret = readBits(parser, 32, &val, 1);
+    ret = readBits(parser, 32, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1829,7 +1818,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_userDataUnregistered(ARSTREAM2_H
     }
     _readBits += ret;
     uuid1 = val;
-    ret = readBits(parser, 32, &val, 1);
+    ret = readBits(parser, 32, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1837,7 +1826,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_userDataUnregistered(ARSTREAM2_H
     }
     _readBits += ret;
     uuid2 = val;
-    ret = readBits(parser, 32, &val, 1);
+    ret = readBits(parser, 32, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1845,7 +1834,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_userDataUnregistered(ARSTREAM2_H
     }
     _readBits += ret;
     uuid3 = val;
-    ret = readBits(parser, 32, &val, 1);
+    ret = readBits(parser, 32, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1886,7 +1875,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_userDataUnregistered(ARSTREAM2_H
         parser->pUserDataBuf[parser->userDataCount][15] = (uint8_t)((uuid4 >> 0) & 0xFF);
         for (i = 16; i < payloadSize; i++)
         {
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1921,7 +1910,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_recoveryPoint(ARSTREAM2_H264Pars
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- SEI: recovery_point");
 
     // recovery_frame_count
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1932,7 +1921,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_recoveryPoint(ARSTREAM2_H264Pars
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ recovery_frame_count = %d", val);
 
     // exact_match_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1943,7 +1932,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_recoveryPoint(ARSTREAM2_H264Pars
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ exact_match_flag = %d", val);
 
     // broken_link_flag
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1954,7 +1943,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_recoveryPoint(ARSTREAM2_H264Pars
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ broken_link_flag = %d", val);
 
     // changing_slice_group_idc
-    ret = readBits(parser, 2, &val, 1);
+    ret = readBits(parser, 2, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1980,7 +1969,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_bufferingPeriod(ARSTREAM2_H264Pa
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- SEI: buffering_period");
 
     // seq_parameter_set_id
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -1994,7 +1983,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_bufferingPeriod(ARSTREAM2_H264Pa
         for (i = 0; i <= parser->spsContext.cpb_cnt_minus1; i++)
         {
             // initial_cpb_removal_delay[i]
-            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val, 1);
+            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2004,7 +1993,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_bufferingPeriod(ARSTREAM2_H264Pa
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ initial_cpb_removal_delay[%d] = %d", i, val);
 
             // initial_cpb_removal_delay_offset[i]
-            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val, 1);
+            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2020,7 +2009,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_bufferingPeriod(ARSTREAM2_H264Pa
         for (i = 0; i <= parser->spsContext.cpb_cnt_minus1; i++)
         {
             // initial_cpb_removal_delay[i]
-            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val, 1);
+            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2030,7 +2019,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_bufferingPeriod(ARSTREAM2_H264Pa
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ initial_cpb_removal_delay[%d] = %d", i, val);
 
             // initial_cpb_removal_delay_offset[i]
-            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val, 1);
+            ret = readBits(parser, parser->spsContext.initial_cpb_removal_delay_length_minus1 + 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2059,7 +2048,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
     if (parser->spsContext.nal_hrd_parameters_present_flag || parser->spsContext.vcl_hrd_parameters_present_flag)
     {
         // cpb_removal_delay
-        ret = readBits(parser, parser->spsContext.cpb_removal_delay_length_minus1 + 1, &val, 1);
+        ret = readBits(parser, parser->spsContext.cpb_removal_delay_length_minus1 + 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2069,7 +2058,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ cpb_removal_delay = %d", val);
 
         // dpb_output_delay
-        ret = readBits(parser, parser->spsContext.dpb_output_delay_length_minus1 + 1, &val, 1);
+        ret = readBits(parser, parser->spsContext.dpb_output_delay_length_minus1 + 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2082,7 +2071,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
     if (parser->spsContext.pic_struct_present_flag)
     {
         // pic_struct
-        ret = readBits(parser, 4, &val, 1);
+        ret = readBits(parser, 4, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2095,7 +2084,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
         for (i = 0; i < ARSTREAM2_H264Parser_picStructToNumClockTS[pic_struct]; i++)
         {
             // clock_timestamp_flag[i]
-            ret = readBits(parser, 1, &val, 1);
+            ret = readBits(parser, 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2107,7 +2096,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
             if (val)
             {
                 // ct_type
-                ret = readBits(parser, 2, &val, 1);
+                ret = readBits(parser, 2, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2117,7 +2106,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ ct_type = %d", val);
 
                 // nuit_field_based_flag
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2128,7 +2117,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ nuit_field_based_flag = %d", val);
 
                 // counting_type
-                ret = readBits(parser, 5, &val, 1);
+                ret = readBits(parser, 5, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2138,7 +2127,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ counting_type = %d", val);
 
                 // full_timestamp_flag
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2149,7 +2138,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ full_timestamp_flag = %d", val);
 
                 // discontinuity_flag
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2159,7 +2148,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ discontinuity_flag = %d", val);
 
                 // cnt_dropped_flag
-                ret = readBits(parser, 1, &val, 1);
+                ret = readBits(parser, 1, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2169,7 +2158,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ cnt_dropped_flag = %d", val);
 
                 // n_frames
-                ret = readBits(parser, 8, &val, 1);
+                ret = readBits(parser, 8, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2182,7 +2171,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (full_timestamp_flag)
                 {
                     // seconds_value
-                    ret = readBits(parser, 6, &val, 1);
+                    ret = readBits(parser, 6, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2193,7 +2182,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ seconds_value = %d", val);
 
                     // minutes_value
-                    ret = readBits(parser, 6, &val, 1);
+                    ret = readBits(parser, 6, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2204,7 +2193,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ minutes_value = %d", val);
 
                     // hours_value
-                    ret = readBits(parser, 5, &val, 1);
+                    ret = readBits(parser, 5, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2217,7 +2206,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 else
                 {
                     // seconds_flag
-                    ret = readBits(parser, 1, &val, 1);
+                    ret = readBits(parser, 1, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2229,7 +2218,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                     if (val)
                     {
                         // seconds_value
-                        ret = readBits(parser, 6, &val, 1);
+                        ret = readBits(parser, 6, &val);
                         if (ret < 0)
                         {
                             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2240,7 +2229,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ seconds_value = %d", val);
 
                         // minutes_flag
-                        ret = readBits(parser, 1, &val, 1);
+                        ret = readBits(parser, 1, &val);
                         if (ret < 0)
                         {
                             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2252,7 +2241,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                         if (val)
                         {
                             // minutes_value
-                            ret = readBits(parser, 6, &val, 1);
+                            ret = readBits(parser, 6, &val);
                             if (ret < 0)
                             {
                                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2263,7 +2252,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ minutes_value = %d", val);
 
                             // hours_flag
-                            ret = readBits(parser, 1, &val, 1);
+                            ret = readBits(parser, 1, &val);
                             if (ret < 0)
                             {
                                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2275,7 +2264,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                             if (val)
                             {
                                 // hours_value
-                                ret = readBits(parser, 5, &val, 1);
+                                ret = readBits(parser, 5, &val);
                                 if (ret < 0)
                                 {
                                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2292,7 +2281,7 @@ static int ARSTREAM2_H264Parser_ParseSeiPayload_picTiming(ARSTREAM2_H264Parser_t
                 if (parser->spsContext.time_offset_length)
                 {
                     // time_offset
-                    ret = readBits(parser, parser->spsContext.time_offset_length, &val, 1); //TODO: signed value
+                    ret = readBits(parser, parser->spsContext.time_offset_length, &val); //TODO: signed value
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2339,7 +2328,7 @@ static int ARSTREAM2_H264Parser_ParseSei(ARSTREAM2_H264Parser_t* parser)
         // last_payload_type_byte
         do
         {
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2354,7 +2343,7 @@ static int ARSTREAM2_H264Parser_ParseSei(ARSTREAM2_H264Parser_t* parser)
         // last_payload_size_byte
         do
         {
-            ret = readBits(parser, 8, &val, 1);
+            ret = readBits(parser, 8, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2366,6 +2355,12 @@ static int ARSTREAM2_H264Parser_ParseSei(ARSTREAM2_H264Parser_t* parser)
         while (val == 0xFF);
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- last_payload_size_byte = %d (payloadSize = %d)", val, payloadSize);
         
+        if ((parser->lazyParsing) && ((payloadType == ARSTREAM2_H264_SEI_PAYLOAD_TYPE_BUFFERING_PERIOD) || (payloadType == ARSTREAM2_H264_SEI_PAYLOAD_TYPE_PIC_TIMING)))
+        {
+            // Buffering period and picture timing are not needed for access unit filtering
+            payloadType = -1;
+        }
+
         // sei_payload
         switch(payloadType)
         {
@@ -2447,7 +2442,7 @@ static int ARSTREAM2_H264Parser_ParseSei(ARSTREAM2_H264Parser_t* parser)
     while (moreRbspData(parser));
 
     // rbsp_trailing_bits
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2478,7 +2473,7 @@ static int ARSTREAM2_H264Parser_ParseAud(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-- access_unit_delimiter_rbsp()");
 
     // primary_pic_type
-    ret = readBits(parser, 3, &val, 1);
+    ret = readBits(parser, 3, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2488,7 +2483,7 @@ static int ARSTREAM2_H264Parser_ParseAud(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- primary_pic_type = %d", val);
 
     // rbsp_trailing_bits
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2536,7 +2531,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
     if ((parser->sliceContext.sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_I) && (parser->sliceContext.sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_SI))
     {
         // ref_pic_list_modification_flag_l0
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2552,7 +2547,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
             do
             {
                 // modification_of_pic_nums_idc
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2565,7 +2560,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
                 if ((modification_of_pic_nums_idc == 0) || (modification_of_pic_nums_idc == 1))
                 {
                     // abs_diff_pic_num_minus1
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2577,7 +2572,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
                 else if (modification_of_pic_nums_idc == 2)
                 {
                     // long_term_pic_num
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2595,7 +2590,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
     if (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
     {
         // ref_pic_list_modification_flag_l1
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2611,7 +2606,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
             {
                 i = 0;
                 // modification_of_pic_nums_idc
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2624,7 +2619,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
                 if ((modification_of_pic_nums_idc == 0) || (modification_of_pic_nums_idc == 1))
                 {
                     // abs_diff_pic_num_minus1
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2636,7 +2631,7 @@ static int ARSTREAM2_H264Parser_ParseRefPicListModification(ARSTREAM2_H264Parser
                 else if (modification_of_pic_nums_idc == 2)
                 {
                     // long_term_pic_num
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2664,7 +2659,7 @@ static int ARSTREAM2_H264Parser_ParsePredWeightTable(ARSTREAM2_H264Parser_t* par
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ pred_weight_table()");
 
     // luma_log2_weight_denom
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2690,7 +2685,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
     if (parser->sliceContext.idrPicFlag)
     {
         // no_output_of_prior_pics_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2701,7 +2696,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
         if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "-------- no_output_of_prior_pics_flag = %d", val);
 
         // long_term_reference_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2714,7 +2709,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
     else
     {
         // adaptive_ref_pic_marking_mode_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2731,7 +2726,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
             do
             {
                 // memory_management_control_operation
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2744,7 +2739,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
                 if ((memory_management_control_operation == 1) || (memory_management_control_operation == 3))
                 {
                     // difference_of_pic_nums_minus1
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2757,7 +2752,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
                 if (memory_management_control_operation == 2)
                 {
                     // long_term_pic_num
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2770,7 +2765,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
                 if ((memory_management_control_operation == 3) || (memory_management_control_operation == 6))
                 {
                     // long_term_frame_idx
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2783,7 +2778,7 @@ static int ARSTREAM2_H264Parser_ParseDecRefPicMarking(ARSTREAM2_H264Parser_t* pa
                 if (memory_management_control_operation == 4)
                 {
                     // max_long_term_frame_idx_plus1
-                    ret = readBits_expGolomb_ue(parser, &val, 1);
+                    ret = readBits_expGolomb_ue(parser, &val);
                     if (ret < 0)
                     {
                         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2820,7 +2815,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "---- slice_header()");
 
     // first_mb_in_slice
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2831,7 +2826,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ first_mb_in_slice = %d", val);
 
     // slice_type
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2843,7 +2838,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ slice_type = %d (%s)", val, (val <= 9) ? ARSTREAM2_H264Parser_sliceTypeStr[val] : "(invalid)");
 
     // pic_parameter_set_id
-    ret = readBits_expGolomb_ue(parser, &val, 1);
+    ret = readBits_expGolomb_ue(parser, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2856,7 +2851,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->spsContext.separate_colour_plane_flag == 1)
     {
         // colour_plane_id
-        ret = readBits(parser, 2, &val, 1);
+        ret = readBits(parser, 2, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2868,7 +2863,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     }
 
     // frame_num
-    ret = readBits(parser, parser->spsContext.log2_max_frame_num_minus4 + 4, &val, 1);
+    ret = readBits(parser, parser->spsContext.log2_max_frame_num_minus4 + 4, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2878,10 +2873,18 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     parser->sliceContext.frame_num = val;
     if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ frame_num = %d", val);
 
+    if (parser->lazyParsing)
+    {
+        // The rest of the slice header is parsed on demand, see ARSTREAM2_H264Parser_GetSliceContext()
+        parser->sliceContextPartial = 1;
+        readBytes += _readBits / 8;
+        return readBytes;
+    }
+
     if (!parser->spsContext.frame_mbs_only_flag)
     {
         // field_pic_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2894,7 +2897,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if (parser->sliceContext.field_pic_flag)
         {
             // bottom_field_flag
-            ret = readBits(parser, 1, &val, 1);
+            ret = readBits(parser, 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2909,7 +2912,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->sliceContext.idrPicFlag)
     {
         // idr_pic_id
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2923,7 +2926,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->spsContext.pic_order_cnt_type == 0)
     {
         // pic_order_cnt_lsb
-        ret = readBits(parser, parser->spsContext.log2_max_pic_order_cnt_lsb_minus4 + 4, &val, 1);
+        ret = readBits(parser, parser->spsContext.log2_max_pic_order_cnt_lsb_minus4 + 4, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2936,7 +2939,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if ((parser->ppsContext.bottom_field_pic_order_in_frame_present_flag) && (!parser->sliceContext.field_pic_flag))
         {
             // delta_pic_order_cnt_bottom
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2951,7 +2954,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if ((parser->spsContext.pic_order_cnt_type == 1) && (!parser->spsContext.delta_pic_order_always_zero_flag))
     {
         // delta_pic_order_cnt[0]
-        ret = readBits_expGolomb_se(parser, &val_se, 1);
+        ret = readBits_expGolomb_se(parser, &val_se);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2964,7 +2967,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if ((parser->ppsContext.bottom_field_pic_order_in_frame_present_flag) && (!parser->sliceContext.field_pic_flag))
         {
             // delta_pic_order_cnt[1]
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2979,7 +2982,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->ppsContext.redundant_pic_cnt_present_flag)
     {
         // redundant_pic_cnt
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -2993,7 +2996,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
     {
         // direct_spatial_mv_pred_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3007,7 +3010,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if ((parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_P) || (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_SP) || (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B))
     {
         // num_ref_idx_active_override_flag
-        ret = readBits(parser, 1, &val, 1);
+        ret = readBits(parser, 1, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3020,7 +3023,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if (val)
         {
             // num_ref_idx_l0_active_minus1
-            ret = readBits_expGolomb_ue(parser, &val, 1);
+            ret = readBits_expGolomb_ue(parser, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3033,7 +3036,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
             if (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
             {
                 // num_ref_idx_l1_active_minus1
-                ret = readBits_expGolomb_ue(parser, &val, 1);
+                ret = readBits_expGolomb_ue(parser, &val);
                 if (ret < 0)
                 {
                     ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3093,7 +3096,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if ((parser->ppsContext.entropy_coding_mode_flag) && (parser->sliceContext.sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_I) && (parser->sliceContext.sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_SI))
     {
         // cabac_init_idc
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3105,7 +3108,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     }
     
     // slice_qp_delta
-    ret = readBits_expGolomb_se(parser, &val_se, 1);
+    ret = readBits_expGolomb_se(parser, &val_se);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3120,7 +3123,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if (parser->sliceContext.sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_SP)
         {
             // sp_for_switch_flag
-            ret = readBits(parser, 1, &val, 1);
+            ret = readBits(parser, 1, &val);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3132,7 +3135,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         }
 
         // slice_qs_delta
-        ret = readBits_expGolomb_se(parser, &val_se, 1);
+        ret = readBits_expGolomb_se(parser, &val_se);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3146,7 +3149,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     if (parser->ppsContext.deblocking_filter_control_present_flag)
     {
         // disable_deblocking_filter_idc
-        ret = readBits_expGolomb_ue(parser, &val, 1);
+        ret = readBits_expGolomb_ue(parser, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3159,7 +3162,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         if (val != 1)
         {
             // slice_alpha_c0_offset_div2
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3170,7 +3173,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
             if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "------ slice_alpha_c0_offset_div2 = %d", val_se);
 
             // slice_beta_offset_div2
-            ret = readBits_expGolomb_se(parser, &val_se, 1);
+            ret = readBits_expGolomb_se(parser, &val_se);
             if (ret < 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3190,7 +3193,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
         n = ceil(log2((picSizeInMapUnits / (parser->ppsContext.slice_group_change_rate_minus1 + 1)) + 1));
 
         // slice_group_change_cycle
-        ret = readBits(parser, n, &val, 1);
+        ret = readBits(parser, n, &val);
         if (ret < 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3206,7 +3209,7 @@ static int ARSTREAM2_H264Parser_ParseSlice(ARSTREAM2_H264Parser_t* parser)
     // rbsp_slice_trailing_bits
 
     // rbsp_trailing_bits
-    ret = readBits(parser, 1, &val, 1);
+    ret = readBits(parser, 1, &val);
     if (ret < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3244,8 +3247,9 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ParseNalu(ARSTREAM2_H264Parser_Handle pars
     }
 
     memset(&parser->sliceContext, 0, sizeof(ARSTREAM2_H264_SliceContext_t));
+    parser->sliceContextPartial = 0;
 
-    ret = readBits(parser, 8, &val, 0);
+    ret = readBits(parser, 8, &val);
     if (ret != 8)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to read from the bitstream");
@@ -3358,6 +3362,12 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_file(ARSTREAM2_H264Parser_Han
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
     
+    if (parser->mapFd >= 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid state");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
     // Search for next NALU start code
     ret = ARSTREAM2_H264Parser_StartcodeMatch_file(parser, fp, fileSize, &startcodePosition);
     if (ret >= 0)
@@ -3419,7 +3429,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_file(ARSTREAM2_H264Parser_Han
             // Reset the cache
             parser->cache = 0;
             parser->cacheLength = 0;
-            parser->oldZeroCount = 0; // NB: this value is wrong when emulation prevention is in use (inside NAL Units)
+            parser->remRbspSize = 0;
         }
         else
         {
@@ -3446,33 +3456,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_file(ARSTREAM2_H264Parser_Han
 
 static int ARSTREAM2_H264Parser_StartcodeMatch_buffer(ARSTREAM2_H264Parser_t* parser, uint8_t* pBuf, unsigned int bufSize)
 {
-    int ret, pos, end;
-    uint32_t shiftVal = 0;
-    uint8_t* ptr = pBuf;
-
-    if (bufSize < 4) return -2;
-
-    pos = 0;
-    end = bufSize;
-
-    do
-    {
-        shiftVal <<= 8;
-        shiftVal |= (*ptr++) & 0xFF;
-        pos++;
-    }
-    while (((shiftVal != ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE) && (pos < end)) || (pos < 4));
-
-    if (shiftVal == ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE)
-    {
-        ret = pos;
-    }
-    else
-    {
-        ret = -2;
-    }
-
-    return ret;
+    return ARSTREAM2_H264_FindStartCode(pBuf, bufSize);
 }
 
 
@@ -3488,7 +3472,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_buffer(ARSTREAM2_H264Parser_H
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
     
-    if (parser->naluBufManaged)
+    if ((parser->naluBufManaged) || (parser->mapFd >= 0))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid state");
         return ARSTREAM2_ERROR_INVALID_STATE;
@@ -3533,7 +3517,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_buffer(ARSTREAM2_H264Parser_H
             // Reset the cache
             parser->cache = 0;
             parser->cacheLength = 0;
-            parser->oldZeroCount = 0; // NB: this value is wrong when emulation prevention is in use (inside NAL Units)
+            parser->remRbspSize = 0;
         }
         else
         {
@@ -3555,7 +3539,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_buffer(ARSTREAM2_H264Parser_H
         // Reset the cache
         parser->cache = 0;
         parser->cacheLength = 0;
-        parser->oldZeroCount = 0; // NB: this value is wrong when emulation prevention is in use (inside NAL Units)
+        parser->remRbspSize = 0;
 
         return ARSTREAM2_ERROR_NOT_FOUND;
     }
@@ -3569,6 +3553,290 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_buffer(ARSTREAM2_H264Parser_H
 }
 
 
+static int ARSTREAM2_H264Parser_MapWindow(ARSTREAM2_H264Parser_t* parser, off_t pos, off_t minSize)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    off_t offset, size;
+    void *map;
+
+    if (pageSize <= 0)
+    {
+        pageSize = 4096;
+    }
+    offset = pos - (pos % pageSize);
+    size = pos - offset + minSize;
+    if (size < parser->mapWindowSize)
+    {
+        size = parser->mapWindowSize;
+    }
+    if (offset + size > parser->mapFileSize)
+    {
+        size = parser->mapFileSize - offset;
+    }
+
+    if ((parser->pMap) && (offset == parser->mapOffset) && (size == parser->mapSize))
+    {
+        return 0;
+    }
+    if ((off_t)(size_t)size != size)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Mapped window too large (%llu bytes)", (unsigned long long)size);
+        return -1;
+    }
+
+    if (parser->pMap)
+    {
+        munmap(parser->pMap, (size_t)parser->mapSize);
+        parser->pMap = NULL;
+        parser->mapOffset = 0;
+        parser->mapSize = 0;
+    }
+
+    map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, parser->mapFd, offset);
+    if (map == MAP_FAILED)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to map file (offset %llu, size %llu)",
+                    (unsigned long long)offset, (unsigned long long)size);
+        return -1;
+    }
+    madvise(map, (size_t)size, MADV_SEQUENTIAL);
+
+    parser->pMap = (uint8_t*)map;
+    parser->mapOffset = offset;
+    parser->mapSize = size;
+
+    return 0;
+}
+
+
+static int ARSTREAM2_H264Parser_StartcodeMatch_mappedFile(ARSTREAM2_H264Parser_t* parser, off_t pos, off_t *startcodeEnd)
+{
+    off_t len;
+    int ret;
+
+    while (pos + ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH <= parser->mapFileSize)
+    {
+        if ((pos < parser->mapOffset) || (pos + ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH > parser->mapOffset + parser->mapSize))
+        {
+            ret = ARSTREAM2_H264Parser_MapWindow(parser, pos, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH);
+            if (ret != 0)
+            {
+                return -1;
+            }
+        }
+
+        len = parser->mapOffset + parser->mapSize - pos;
+        if (len > ARSTREAM2_H264_PARSER_MAPPED_FILE_SEARCH_SIZE)
+        {
+            len = ARSTREAM2_H264_PARSER_MAPPED_FILE_SEARCH_SIZE;
+        }
+
+        ret = ARSTREAM2_H264_FindStartCode(parser->pMap + (pos - parser->mapOffset), (unsigned int)len);
+        if (ret >= 0)
+        {
+            if (startcodeEnd) *startcodeEnd = pos + ret;
+            return 0;
+        }
+        else if (ret != -2)
+        {
+            return ret;
+        }
+
+        if (pos + len >= parser->mapFileSize)
+        {
+            break;
+        }
+
+        /* The next search overlaps so that a start code across the boundary is found */
+        pos += len - (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH - 1);
+    }
+
+    return -2;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_OpenMappedFile(ARSTREAM2_H264Parser_Handle parserHandle, const char *fileName, unsigned long long *fileSize)
+{
+    ARSTREAM2_H264Parser_t* parser = (ARSTREAM2_H264Parser_t*)parserHandle;
+    struct stat st;
+
+    if (!parserHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (!fileName)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid file name");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (parser->mapFd >= 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "A file is already opened");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    parser->mapFd = open(fileName, O_RDONLY);
+    if (parser->mapFd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to open file '%s'", fileName);
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    if (fstat(parser->mapFd, &st) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Failed to get file size for '%s'", fileName);
+        close(parser->mapFd);
+        parser->mapFd = -1;
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    /* The NALU buffer now points to the mapped file */
+    if ((parser->pNaluBuf) && (parser->naluBufManaged))
+    {
+        free(parser->pNaluBuf);
+    }
+    parser->naluBufManaged = 0;
+    parser->pNaluBuf = parser->pNaluBufCur = NULL;
+    parser->naluBufSize = parser->naluSize = parser->remNaluSize = 0;
+
+    parser->pMap = NULL;
+    parser->mapOffset = 0;
+    parser->mapSize = 0;
+    parser->mapFileSize = st.st_size;
+    parser->mapPos = 0;
+    parser->mapWindowSize = (sizeof(void*) >= 8) ? parser->mapFileSize : ARSTREAM2_H264_PARSER_MAPPED_FILE_WINDOW_SIZE;
+
+    if (fileSize) *fileSize = (unsigned long long)parser->mapFileSize;
+
+    return ARSTREAM2_OK;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_CloseMappedFile(ARSTREAM2_H264Parser_Handle parserHandle)
+{
+    ARSTREAM2_H264Parser_t* parser = (ARSTREAM2_H264Parser_t*)parserHandle;
+
+    if (!parserHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (parser->mapFd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "No file opened");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    if (parser->pMap)
+    {
+        munmap(parser->pMap, (size_t)parser->mapSize);
+    }
+    close(parser->mapFd);
+    parser->mapFd = -1;
+    parser->pMap = NULL;
+    parser->mapOffset = 0;
+    parser->mapSize = 0;
+    parser->mapFileSize = 0;
+    parser->mapPos = 0;
+
+    parser->pNaluBuf = parser->pNaluBufCur = NULL;
+    parser->naluBufSize = parser->naluSize = parser->remNaluSize = 0;
+
+    return ARSTREAM2_OK;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Parser_ReadNextNalu_mappedFile(ARSTREAM2_H264Parser_Handle parserHandle, unsigned int *naluSize, unsigned long long *naluPosition)
+{
+    ARSTREAM2_H264Parser_t* parser = (ARSTREAM2_H264Parser_t*)parserHandle;
+    int ret = 0;
+    off_t naluStart, naluEnd, startcodeEnd = 0;
+    unsigned int _naluSize = 0;
+
+    if (!parserHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (parser->mapFd < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "No file opened");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    // Search for next NALU start code
+    ret = ARSTREAM2_H264Parser_StartcodeMatch_mappedFile(parser, parser->mapPos, &startcodeEnd);
+    if (ret == -2)
+    {
+        // No start code found
+        if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "No start code found");
+        return ARSTREAM2_ERROR_NOT_FOUND;
+    }
+    else if (ret < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "ARSTREAM2_H264Parser_StartcodeMatch_mappedFile() failed (%d)", ret);
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    // Start code found
+    naluStart = parser->mapPos = startcodeEnd;
+    if (parser->config.printLogs) ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_H264_PARSER_TAG, "Start code at 0x%08llX", (unsigned long long)(naluStart - 4));
+
+    // Search for NALU end (next NALU start code or end of file)
+    ret = ARSTREAM2_H264Parser_StartcodeMatch_mappedFile(parser, naluStart, &startcodeEnd);
+    if (ret >= 0)
+    {
+        // Start code found
+        naluEnd = startcodeEnd - ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE_LENGTH;
+    }
+    else if (ret == -2)
+    {
+        // No start code found
+        naluEnd = parser->mapFileSize;
+    }
+    else
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "ARSTREAM2_H264Parser_StartcodeMatch_mappedFile() failed (%d)", ret);
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    if ((naluEnd <= naluStart) || (naluEnd - naluStart > UINT_MAX))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "Invalid NALU size");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+    _naluSize = (unsigned int)(naluEnd - naluStart);
+
+    // Make sure the whole NALU is in the mapped window
+    if ((naluStart < parser->mapOffset) || (naluEnd > parser->mapOffset + parser->mapSize))
+    {
+        ret = ARSTREAM2_H264Parser_MapWindow(parser, naluStart, naluEnd - naluStart);
+        if (ret != 0)
+        {
+            return ARSTREAM2_ERROR_INVALID_STATE;
+        }
+    }
+
+    parser->naluSize = parser->remNaluSize = parser->naluBufSize = _naluSize;
+    parser->pNaluBufCur = parser->pNaluBuf = parser->pMap + (naluStart - parser->mapOffset);
+    parser->mapPos = naluEnd;
+
+    // Reset the cache
+    parser->cache = 0;
+    parser->cacheLength = 0;
+    parser->remRbspSize = 0;
+
+    if (naluSize) *naluSize = _naluSize;
+    if (naluPosition) *naluPosition = (unsigned long long)naluStart;
+    return ARSTREAM2_OK;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_H264Parser_SetupNalu_buffer(ARSTREAM2_H264Parser_Handle parserHandle, void* pNaluBuf, unsigned int naluSize)
 {
     ARSTREAM2_H264Parser_t* parser = (ARSTREAM2_H264Parser_t*)parserHandle;
@@ -3592,7 +3860,7 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_SetupNalu_buffer(ARSTREAM2_H264Parser_Hand
     // Reset the cache
     parser->cache = 0;
     parser->cacheLength = 0;
-    parser->oldZeroCount = 0; // NB: this value is wrong when emulation prevention is in use (inside NAL Units)
+    parser->remRbspSize = 0;
 
     return ret;
 }
@@ -3779,6 +4047,25 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_GetSliceContext(ARSTREAM2_H264Parser_Handl
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
+    if (parser->sliceContextPartial)
+    {
+        // Parse the full slice header from the start of the NALU
+        parser->pNaluBufCur = parser->pNaluBuf;
+        parser->remNaluSize = parser->naluSize;
+        parser->cache = 0;
+        parser->cacheLength = 0;
+        parser->remRbspSize = 0;
+        parser->lazyParsing = 0;
+        ret = ARSTREAM2_H264Parser_ParseNalu(parserHandle, NULL);
+        parser->lazyParsing = (parser->config.lazyParsing) ? 1 : 0;
+        if (ret != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_PARSER_TAG, "ARSTREAM2_H264Parser_ParseNalu() failed (%d)", ret);
+            parser->sliceContextPartial = 1;
+            return ret;
+        }
+    }
+
     *sliceContext = &parser->sliceContext;
 
     return ret;
@@ -3813,6 +4100,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_Init(ARSTREAM2_H264Parser_Handle* parserHa
 
     parser->naluBufSize = 0;
     parser->pNaluBuf = NULL;
+    parser->mapFd = -1;
+    parser->lazyParsing = (parser->config.lazyParsing) ? 1 : 0;
 
     parser->spsContext.time_offset_length = 24;
 
@@ -3832,6 +4121,11 @@ eARSTREAM2_ERROR ARSTREAM2_H264Parser_Free(ARSTREAM2_H264Parser_Handle parserHan
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
+    if (parser->mapFd >= 0)
+    {
+        ARSTREAM2_H264Parser_CloseMappedFile(parserHandle);
+    }
+
     if ((parser->pNaluBuf) && (parser->naluBufManaged))
     {
         free(parser->pNaluBuf);
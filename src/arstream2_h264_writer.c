@@ -22,6 +22,43 @@
 
 #define log2(x) (log(x) / log(2)) //TODO
 
+#define ARSTREAM2_H264_WRITER_RBSP_BUFFER_MIN_SIZE (4096)
+#define ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT (32)
+#define ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_HEADER_MAX_SIZE (128)
+#define ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_MAGIC (0x41523254) // "AR2T"
+#define ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_VERSION (1)
+#define ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE (9 * 4)
+
+
+typedef enum
+{
+    ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_SKIPPED_P = 0,
+    ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I,
+
+} eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE;
+
+
+typedef struct ARSTREAM2_H264Writer_SliceTemplate_s
+{
+    int valid;
+    eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE type;
+    ARSTREAM2_H264_SliceContext_t key;  // slice context with the patched fields cleared
+    unsigned int idrPicIdLength;        // in bits
+
+    // NAL unit header and RBSP without emulation prevention
+    uint8_t *pRbspBuf;
+    unsigned int rbspBufSize;
+    unsigned int rbspSize;              // in bytes
+
+    // Patched field positions in bits from the start of the NAL unit (-1 if absent)
+    int frameNumOffset;
+    unsigned int frameNumLength;
+    int idrPicIdOffset;
+    int pocLsbOffset;
+    unsigned int pocLsbLength;
+
+} ARSTREAM2_H264Writer_SliceTemplate_t;
+
 
 typedef struct ARSTREAM2_H264Writer_s
 {
@@ -33,9 +70,15 @@ typedef struct ARSTREAM2_H264Writer_s
     unsigned int naluSize;      // in bytes
 
     // Bitstream cache
-    uint32_t cache;
-    int cacheLength;   // in bits
-    int oldZeroCount;
+    uint64_t cache;
+    unsigned int cacheLength;   // in bits
+
+    // RBSP buffer, emulation prevention is applied when writing to the NALU buffer
+    uint8_t *pRbspBuf;
+    unsigned int rbspBufSize;
+    unsigned int rbspSize;      // in bytes
+    unsigned int rbspMaxSize;
+    int zeroCount;
 
     // Context
     ARSTREAM2_H264_SpsContext_t spsContext;
@@ -43,143 +86,135 @@ typedef struct ARSTREAM2_H264Writer_s
     int isSpsPpsContextValid;
     ARSTREAM2_H264_SliceContext_t sliceContext;
 
+    // Slice header field positions in bits from the start of the slice header (-1 if absent)
+    int frameNumBitOffset;
+    int idrPicIdBitOffset;
+    int pocLsbBitOffset;
+
+    // Concealment slice templates
+    ARSTREAM2_H264Writer_SliceTemplate_t sliceTemplate[ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT];
+    unsigned int nextSliceTemplate;
+
 } ARSTREAM2_H264Writer_t;
 
 
-static inline int writeBits(ARSTREAM2_H264Writer_t* _writer, unsigned int _numBits, uint32_t _value, int _emulationPrevention)
+static inline int bitstreamReserve(ARSTREAM2_H264Writer_t* _writer, unsigned int _size)
 {
-    int _cacheBits, _remBits, _i;
-    uint8_t _write8;
-    uint32_t _bitMask;
+    uint8_t *_pBuf;
+    unsigned int _newSize;
+
+    if (_writer->rbspSize + _size > _writer->rbspBufSize)
+    {
+        if (_writer->rbspSize + _size > _writer->rbspMaxSize)
+        {
+            return -1;
+        }
+        _newSize = (_writer->rbspBufSize) ? _writer->rbspBufSize * 2 : ARSTREAM2_H264_WRITER_RBSP_BUFFER_MIN_SIZE;
+        if (_newSize < _writer->rbspSize + _size)
+        {
+            _newSize = _writer->rbspSize + _size;
+        }
+        _pBuf = realloc(_writer->pRbspBuf, _newSize);
+        if (!_pBuf)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "RBSP buffer allocation failed (size %d)", _newSize);
+            return -1;
+        }
+        _writer->pRbspBuf = _pBuf;
+        _writer->rbspBufSize = _newSize;
+    }
+
+    return 0;
+}
 
-    _remBits = (int)_numBits;
-    _cacheBits = 32 - _writer->cacheLength;
 
-    if (_remBits >= _cacheBits)
+static inline int bitstreamFlushWord(ARSTREAM2_H264Writer_t* _writer)
+{
+    uint8_t *_pBuf;
+
+    if (bitstreamReserve(_writer, 8) < 0)
     {
-        // Write _cacheBits bits to the cache
-        _writer->cache |= (_value >> (_remBits - _cacheBits));
+        return -1;
+    }
 
-        // The cache is full; write 4 bytes in the buffer
-        for (_i = 0; _i < 4; _i++)
-        {
-            _write8 = (_writer->cache >> 24) & 0xFF;
+    // Big-endian word
+    _pBuf = _writer->pRbspBuf + _writer->rbspSize;
+    _pBuf[0] = (uint8_t)(_writer->cache >> 56);
+    _pBuf[1] = (uint8_t)(_writer->cache >> 48);
+    _pBuf[2] = (uint8_t)(_writer->cache >> 40);
+    _pBuf[3] = (uint8_t)(_writer->cache >> 32);
+    _pBuf[4] = (uint8_t)(_writer->cache >> 24);
+    _pBuf[5] = (uint8_t)(_writer->cache >> 16);
+    _pBuf[6] = (uint8_t)(_writer->cache >> 8);
+    _pBuf[7] = (uint8_t)(_writer->cache);
+    _writer->rbspSize += 8;
 
-            // Emulation prevention
-            if (_emulationPrevention)
-            {
-                if ((_writer->oldZeroCount == 2) && (_write8 <= 3))
-                {
-                    // 0x000000 or 0x000001 or 0x000002 or 0x000003 => insert 0x03
-                    if (_writer->naluSize < _writer->naluBufSize)
-                    {
-                        *(_writer->pNaluBuf++) = 0x03;
-                        _writer->naluSize++;
-                    }
-                    else
-                    {
-                        return -1;
-                    }
-                    _writer->oldZeroCount = 0;
-                }
-                if (_write8 == 0)
-                {
-                    _writer->oldZeroCount++;
-                }
-                else
-                {
-                    _writer->oldZeroCount = 0;
-                }
-            }
+    return 0;
+}
 
-            if (_writer->naluSize < _writer->naluBufSize)
-            {
-                *(_writer->pNaluBuf++) = _write8;
-                _writer->naluSize++;
-            }
-            else
-            {
-                return -1;
-            }
-            _writer->cache <<= 8;
-        }
-        _remBits -= _cacheBits;
-        _bitMask = (uint32_t)-1 >> (32 - _remBits);
-        _value &= _bitMask;
 
-        // Reset the chache
-        _writer->cache = 0;
-        _writer->cacheLength = 0;
-        _cacheBits = 32;
+static inline int writeBits(ARSTREAM2_H264Writer_t* _writer, unsigned int _numBits, uint32_t _value)
+{
+    uint64_t _val;
+    unsigned int _remBits;
+
+    if ((_numBits == 0) || (_numBits > 32))
+    {
+        return (_numBits == 0) ? 0 : -1;
     }
 
-    if (_remBits > 0)
+    _val = (uint64_t)_value & (((uint64_t)1 << _numBits) - 1);
+
+    if (_writer->cacheLength + _numBits < 64)
+    {
+        _writer->cache |= _val << (64 - _writer->cacheLength - _numBits);
+        _writer->cacheLength += _numBits;
+    }
+    else
     {
-        _writer->cache |= (_value << (_cacheBits - _remBits));
-        _writer->cacheLength += _remBits;
+        // Fill the cache and write it to the RBSP buffer
+        _remBits = _writer->cacheLength + _numBits - 64;
+        _writer->cache |= _val >> _remBits;
+        if (bitstreamFlushWord(_writer) < 0)
+        {
+            return -1;
+        }
+        _writer->cache = (_remBits) ? _val << (64 - _remBits) : 0;
+        _writer->cacheLength = _remBits;
     }
 
     return _numBits;
 }
 
 
-static inline int bitstreamByteAlign(ARSTREAM2_H264Writer_t* _writer, int _emulationPrevention)
+static inline int bitstreamByteAlign(ARSTREAM2_H264Writer_t* _writer)
 {
-    int _bitsWritten = 0, _i;
-    uint8_t _write8;
+    int _bitsWritten = 0;
+    unsigned int _i;
 
     if (_writer->cacheLength & 7)
     {
-        _bitsWritten = writeBits(_writer, (8 - (_writer->cacheLength & 7)), 0, _emulationPrevention);
+        _bitsWritten = writeBits(_writer, (8 - (_writer->cacheLength & 7)), 0);
+        if (_bitsWritten < 0)
+        {
+            return -1;
+        }
     }
 
     if (_writer->cacheLength)
     {
-        // Write the cache bytes in the buffer
+        // Write the cache bytes in the RBSP buffer
+        if (bitstreamReserve(_writer, _writer->cacheLength / 8) < 0)
+        {
+            return -1;
+        }
         for (_i = 0; _i < _writer->cacheLength / 8; _i++)
         {
-            _write8 = (_writer->cache >> 24) & 0xFF;
-
-            // Emulation prevention
-            if (_emulationPrevention)
-            {
-                if ((_writer->oldZeroCount == 2) && (_write8 <= 3))
-                {
-                    // 0x000000 or 0x000001 or 0x000002 or 0x000003 => insert 0x03
-                    if (_writer->naluSize < _writer->naluBufSize)
-                    {
-                        *(_writer->pNaluBuf++) = 0x03;
-                        _writer->naluSize++;
-                    }
-                    else
-                    {
-                        return -1;
-                    }
-                    _writer->oldZeroCount = 0;
-                }
-                else if (_write8 == 0)
-                {
-                    _writer->oldZeroCount++;
-                }
-                else
-                {
-                    _writer->oldZeroCount = 0;
-                }
-            }
-
-            if (_writer->naluSize < _writer->naluBufSize)
-            {
-                *(_writer->pNaluBuf++) = _write8;
-                _writer->naluSize++;
-            }
-            else
-            {
-                return -1;
-            }
+            _writer->pRbspBuf[_writer->rbspSize++] = (uint8_t)(_writer->cache >> 56);
             _writer->cache <<= 8;
         }
 
-        // Reset the chache
+        // Reset the cache
         _writer->cache = 0;
         _writer->cacheLength = 0;
     }
@@ -188,10 +223,73 @@ static inline int bitstreamByteAlign(ARSTREAM2_H264Writer_t* _writer, int _emula
 }
 
 
-static inline int writeBits_expGolomb_code(ARSTREAM2_H264Writer_t* _writer, uint32_t _value, int _emulationPrevention)
+static inline void bitstreamReset(ARSTREAM2_H264Writer_t* _writer, unsigned int _rbspMaxSize)
+{
+    _writer->cache = 0;
+    _writer->cacheLength = 0;
+    _writer->rbspSize = 0;
+    _writer->rbspMaxSize = _rbspMaxSize;
+}
+
+
+/* Write the start code and NAL unit header, the RBSP follows in the RBSP buffer */
+static inline int bitstreamStartNalu(ARSTREAM2_H264Writer_t* _writer, uint8_t _nalUnitHeader, uint8_t *_pbOutputBuf, unsigned int _outputBufSize)
+{
+    _writer->pNaluBuf = _pbOutputBuf;
+    _writer->naluBufSize = _outputBufSize;
+    _writer->naluSize = 0;
+
+    if (_outputBufSize < ((_writer->config.naluPrefix) ? 5 : 1))
+    {
+        return -1;
+    }
+
+    // NALU start code
+    if (_writer->config.naluPrefix)
+    {
+        *(_writer->pNaluBuf++) = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 24) & 0xFF;
+        *(_writer->pNaluBuf++) = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 16) & 0xFF;
+        *(_writer->pNaluBuf++) = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 8) & 0xFF;
+        *(_writer->pNaluBuf++) = ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE & 0xFF;
+        _writer->naluSize += 4;
+    }
+
+    // forbidden_zero_bit
+    // nal_ref_idc
+    // nal_unit_type
+    *(_writer->pNaluBuf++) = _nalUnitHeader;
+    _writer->naluSize++;
+
+    // The RBSP cannot be larger than the NAL unit
+    bitstreamReset(_writer, _outputBufSize - _writer->naluSize);
+    _writer->zeroCount = 0;
+
+    return 0;
+}
+
+
+/* Write the (byte aligned) RBSP buffer to the NAL unit with emulation prevention */
+static inline int bitstreamFlushNalu(ARSTREAM2_H264Writer_t* _writer)
+{
+    int _ret;
+
+    _ret = ARSTREAM2_H264_EmulationPrevention(_writer->pRbspBuf, _writer->rbspSize, _writer->pNaluBuf,
+                                              _writer->naluBufSize - _writer->naluSize, &_writer->zeroCount);
+    if (_ret < 0)
+    {
+        return -1;
+    }
+    _writer->pNaluBuf += _ret;
+    _writer->naluSize += _ret;
+    _writer->rbspSize = 0;
+
+    return 0;
+}
+
+
+static inline int writeBits_expGolomb_code(ARSTREAM2_H264Writer_t* _writer, uint32_t _value)
 {
-    int _ret, _leadingZeroBits, _halfLength, _bitsWritten = 0;
-    uint32_t _val;
+    int _halfLength;
 
     if (_value == 0)
     {
@@ -199,59 +297,53 @@ static inline int writeBits_expGolomb_code(ARSTREAM2_H264Writer_t* _writer, uint
     }
     else
     {
-        // Count leading zeros in _value
-        for (_val = _value, _leadingZeroBits = 0; _val; _val <<= 1)
+        _halfLength = 31 - __builtin_clz(_value);
+
+        if (_halfLength < 16)
         {
-            if (_val & 0x80000000)
-            {
-                break;
-            }
-            _leadingZeroBits++;
+            // Prefix and suffix at once
+            if (writeBits(_writer, _halfLength * 2 + 1, _value) < 0) return -41;
         }
+        else
+        {
+            // Prefix
+            if (writeBits(_writer, _halfLength, 0) < 0) return -41;
 
-        _halfLength = 31 - _leadingZeroBits;
-
-        // Prefix
-        _ret = writeBits(_writer, _halfLength, 0, _emulationPrevention);
-        if (_ret != _halfLength) return -41;
-        _bitsWritten += _ret;
-
-        // Suffix
-        _ret = writeBits(_writer, _halfLength + 1, _value, _emulationPrevention);
-        if (_ret != _halfLength + 1) return -42;
-        _bitsWritten += _ret;
+            // Suffix
+            if (writeBits(_writer, _halfLength + 1, _value) < 0) return -42;
+        }
     }
 
     return _halfLength * 2 + 1;
 }
 
 
-static inline int writeBits_expGolomb_ue(ARSTREAM2_H264Writer_t* _writer, uint32_t _value, int _emulationPrevention)
+static inline int writeBits_expGolomb_ue(ARSTREAM2_H264Writer_t* _writer, uint32_t _value)
 {
     if (_value == 0)
     {
-        return writeBits(_writer, 1, 1, _emulationPrevention);
+        return writeBits(_writer, 1, 1);
     }
     else
     {
-        return writeBits_expGolomb_code(_writer, _value + 1, _emulationPrevention);
+        return writeBits_expGolomb_code(_writer, _value + 1);
     }
 }
 
 
-static inline int writeBits_expGolomb_se(ARSTREAM2_H264Writer_t* _writer, int32_t _value, int _emulationPrevention)
+static inline int writeBits_expGolomb_se(ARSTREAM2_H264Writer_t* _writer, int32_t _value)
 {
     if (_value == 0)
     {
-        return writeBits(_writer, 1, 1, _emulationPrevention);
+        return writeBits(_writer, 1, 1);
     }
     else if (_value < 0)
     {
-        return writeBits_expGolomb_code(_writer, (uint32_t)(-_value * 2 + 1), _emulationPrevention);
+        return writeBits_expGolomb_code(_writer, (uint32_t)(-_value * 2 + 1));
     }
     else
     {
-        return writeBits_expGolomb_code(_writer, (uint32_t)(_value * 2), _emulationPrevention);
+        return writeBits_expGolomb_code(_writer, (uint32_t)(_value * 2));
     }
 }
 
@@ -355,7 +447,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
     /*while (payloadType > 255) // logically dead code
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -364,7 +456,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
         payloadType -= 255;
     }*/
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadType, 1);
+    ret = writeBits(writer, 8, payloadType);
     if (ret < 0)
     {
         return -1;
@@ -374,7 +466,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
     while (payloadSize > 255)
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -383,7 +475,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
         payloadSize -= 255;
     }
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadSize, 1);
+    ret = writeBits(writer, 8, payloadSize);
     if (ret < 0)
     {
         return -1;
@@ -393,7 +485,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
     if ((writer->spsContext.nal_hrd_parameters_present_flag) || (writer->spsContext.vcl_hrd_parameters_present_flag))
     {
         // cpb_removal_delay
-        ret = writeBits(writer, writer->spsContext.cpb_removal_delay_length_minus1 + 1, pictureTiming->cpbRemovalDelay, 1);
+        ret = writeBits(writer, writer->spsContext.cpb_removal_delay_length_minus1 + 1, pictureTiming->cpbRemovalDelay);
         if (ret < 0)
         {
             return -1;
@@ -401,7 +493,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
         _bitsWritten += ret;
 
         // dpb_output_delay
-        ret = writeBits(writer, writer->spsContext.dpb_output_delay_length_minus1 + 1, pictureTiming->dpbOutputDelay, 1);
+        ret = writeBits(writer, writer->spsContext.dpb_output_delay_length_minus1 + 1, pictureTiming->dpbOutputDelay);
         if (ret < 0)
         {
             return -1;
@@ -412,7 +504,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
     if (writer->spsContext.pic_struct_present_flag)
     {
         // pic_struct
-        ret = writeBits(writer, 4, pictureTiming->picStruct, 1);
+        ret = writeBits(writer, 4, pictureTiming->picStruct);
         if (ret < 0)
         {
             return -1;
@@ -423,7 +515,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
         //for (i = 0; i < NumClockTS; i++)
         {
             // clock_timestamp_flag[i]
-            ret = writeBits(writer, 1, 1, 1);
+            ret = writeBits(writer, 1, 1);
             if (ret < 0)
             {
                 return -1;
@@ -433,7 +525,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
             //if (clock_timestamp_flag[i])
             {
                 // ct_type
-                ret = writeBits(writer, 2, pictureTiming->ctType, 1);
+                ret = writeBits(writer, 2, pictureTiming->ctType);
                 if (ret < 0)
                 {
                     return -1;
@@ -441,7 +533,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // nuit_field_based_flag
-                ret = writeBits(writer, 1, pictureTiming->nuitFieldBasedFlag, 1);
+                ret = writeBits(writer, 1, pictureTiming->nuitFieldBasedFlag);
                 if (ret < 0)
                 {
                     return -1;
@@ -449,7 +541,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // counting_type
-                ret = writeBits(writer, 5, pictureTiming->countingType, 1);
+                ret = writeBits(writer, 5, pictureTiming->countingType);
                 if (ret < 0)
                 {
                     return -1;
@@ -457,7 +549,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // full_timestamp_flag
-                ret = writeBits(writer, 1, pictureTiming->fullTimestampFlag, 1);
+                ret = writeBits(writer, 1, pictureTiming->fullTimestampFlag);
                 if (ret < 0)
                 {
                     return -1;
@@ -465,7 +557,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // discontinuity_flag
-                ret = writeBits(writer, 1, pictureTiming->discontinuityFlag, 1);
+                ret = writeBits(writer, 1, pictureTiming->discontinuityFlag);
                 if (ret < 0)
                 {
                     return -1;
@@ -473,7 +565,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // cnt_dropped_flag
-                ret = writeBits(writer, 1, pictureTiming->cntDroppedFlag, 1);
+                ret = writeBits(writer, 1, pictureTiming->cntDroppedFlag);
                 if (ret < 0)
                 {
                     return -1;
@@ -481,7 +573,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 _bitsWritten += ret;
 
                 // n_frames
-                ret = writeBits(writer, 8, pictureTiming->nFrames, 1);
+                ret = writeBits(writer, 8, pictureTiming->nFrames);
                 if (ret < 0)
                 {
                     return -1;
@@ -491,7 +583,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 if (pictureTiming->fullTimestampFlag)
                 {
                     // seconds_value
-                    ret = writeBits(writer, 6, pictureTiming->secondsValue, 1);
+                    ret = writeBits(writer, 6, pictureTiming->secondsValue);
                     if (ret < 0)
                     {
                         return -1;
@@ -499,7 +591,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                     _bitsWritten += ret;
 
                     // minutes_value
-                    ret = writeBits(writer, 6, pictureTiming->minutesValue, 1);
+                    ret = writeBits(writer, 6, pictureTiming->minutesValue);
                     if (ret < 0)
                     {
                         return -1;
@@ -507,7 +599,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                     _bitsWritten += ret;
 
                     // hours_value
-                    ret = writeBits(writer, 5, pictureTiming->hoursValue, 1);
+                    ret = writeBits(writer, 5, pictureTiming->hoursValue);
                     if (ret < 0)
                     {
                         return -1;
@@ -517,7 +609,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 else
                 {
                     // seconds_flag
-                    ret = writeBits(writer, 1, pictureTiming->secondsFlag, 1);
+                    ret = writeBits(writer, 1, pictureTiming->secondsFlag);
                     if (ret < 0)
                     {
                         return -1;
@@ -527,7 +619,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                     if (pictureTiming->secondsFlag)
                     {
                         // seconds_value
-                        ret = writeBits(writer, 6, pictureTiming->secondsValue, 1);
+                        ret = writeBits(writer, 6, pictureTiming->secondsValue);
                         if (ret < 0)
                         {
                             return -1;
@@ -535,7 +627,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                         _bitsWritten += ret;
 
                         // minutes_flag
-                        ret = writeBits(writer, 1, pictureTiming->minutesFlag, 1);
+                        ret = writeBits(writer, 1, pictureTiming->minutesFlag);
                         if (ret < 0)
                         {
                             return -1;
@@ -545,7 +637,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                         if (pictureTiming->minutesFlag)
                         {
                             // minutes_value
-                            ret = writeBits(writer, 6, pictureTiming->minutesValue, 1);
+                            ret = writeBits(writer, 6, pictureTiming->minutesValue);
                             if (ret < 0)
                             {
                                 return -1;
@@ -553,7 +645,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                             _bitsWritten += ret;
 
                             // hours_flag
-                            ret = writeBits(writer, 1, pictureTiming->hoursFlag, 1);
+                            ret = writeBits(writer, 1, pictureTiming->hoursFlag);
                             if (ret < 0)
                             {
                                 return -1;
@@ -563,7 +655,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                             if (pictureTiming->hoursFlag)
                             {
                                 // hours_value
-                                ret = writeBits(writer, 5, pictureTiming->hoursValue, 1);
+                                ret = writeBits(writer, 5, pictureTiming->hoursValue);
                                 if (ret < 0)
                                 {
                                     return -1;
@@ -576,7 +668,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
                 if (writer->spsContext.time_offset_length > 0)
                 {
                     // time_offset
-                    ret = writeBits(writer, writer->spsContext.time_offset_length, (uint32_t)pictureTiming->timeOffset, 1);
+                    ret = writeBits(writer, writer->spsContext.time_offset_length, (uint32_t)pictureTiming->timeOffset);
                     if (ret < 0)
                     {
                         return -1;
@@ -587,7 +679,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_pictureTiming(ARSTREAM2_H264Writ
         }
     }
 
-    ret = bitstreamByteAlign(writer, 1);
+    ret = bitstreamByteAlign(writer);
     if (ret < 0)
     {
         return -1;
@@ -634,7 +726,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     /*while (payloadType > 255) // logically dead code
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -643,7 +735,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
         payloadType -= 255;
     }*/
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadType, 1);
+    ret = writeBits(writer, 8, payloadType);
     if (ret < 0)
     {
         return -1;
@@ -653,7 +745,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     /*while (payloadSize > 255) // logically dead code
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -662,7 +754,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
         payloadSize -= 255;
     }*/
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadSize, 1);
+    ret = writeBits(writer, 8, payloadSize);
     if (ret < 0)
     {
         return -1;
@@ -670,7 +762,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     _bitsWritten += ret;
 
     // recovery_frame_cnt
-    ret = writeBits_expGolomb_ue(writer, recoveryPoint->recoveryFrameCnt, 1);
+    ret = writeBits_expGolomb_ue(writer, recoveryPoint->recoveryFrameCnt);
     if (ret < 0)
     {
         return -1;
@@ -678,7 +770,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     _bitsWritten += ret;
 
     // exact_match_flag
-    ret = writeBits(writer, 1, recoveryPoint->exactMatchFlag, 1);
+    ret = writeBits(writer, 1, recoveryPoint->exactMatchFlag);
     if (ret < 0)
     {
         return -1;
@@ -686,7 +778,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     _bitsWritten += ret;
 
     // broken_link_flag
-    ret = writeBits(writer, 1, recoveryPoint->brokenLinkFlag, 1);
+    ret = writeBits(writer, 1, recoveryPoint->brokenLinkFlag);
     if (ret < 0)
     {
         return -1;
@@ -694,14 +786,14 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_recoveryPoint(ARSTREAM2_H264Writ
     _bitsWritten += ret;
 
     // changing_slice_group_idc
-    ret = writeBits(writer, 2, recoveryPoint->changingSliceGroupIdc, 1);
+    ret = writeBits(writer, 2, recoveryPoint->changingSliceGroupIdc);
     if (ret < 0)
     {
         return -1;
     }
     _bitsWritten += ret;
 
-    ret = bitstreamByteAlign(writer, 1);
+    ret = bitstreamByteAlign(writer);
     if (ret < 0)
     {
         return -1;
@@ -725,7 +817,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
     /* while (payloadType > 255) // logically dead code
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -734,7 +826,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
         payloadType -= 255;
     }*/
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadType, 1);
+    ret = writeBits(writer, 8, payloadType);
     if (ret < 0)
     {
         return -1;
@@ -744,7 +836,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
     while (payloadSize2 > 255)
     {
         // ff_byte
-        ret = writeBits(writer, 8, 0xFF, 1);
+        ret = writeBits(writer, 8, 0xFF);
         if (ret < 0)
         {
             return -1;
@@ -753,7 +845,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
         payloadSize2 -= 255;
     }
     // last_payload_type_byte
-    ret = writeBits(writer, 8, payloadSize2, 1);
+    ret = writeBits(writer, 8, payloadSize2);
     if (ret < 0)
     {
         return -1;
@@ -763,7 +855,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
     // user_data_unregistered
     for (i = 0; i < payloadSize; i++)
     {
-        ret = writeBits(writer, 8, (uint32_t)(*pbPayload++), 1);
+        ret = writeBits(writer, 8, (uint32_t)(*pbPayload++));
         if (ret < 0)
         {
             return ret;
@@ -771,7 +863,7 @@ static int ARSTREAM2_H264Writer_WriteSeiPayload_userDataUnregistered(ARSTREAM2_H
         _bitsWritten += ret;
     }
 
-    ret = bitstreamByteAlign(writer, 1);
+    ret = bitstreamByteAlign(writer);
     if (ret < 0)
     {
         return -1;
@@ -796,35 +888,15 @@ int ARSTREAM2_H264Writer_WriteSeiNalu(ARSTREAM2_H264Writer_Handle writerHandle,
         return -1;
     }
 
-    writer->pNaluBuf = pbOutputBuf;
-    writer->naluBufSize = outputBufSize;
-    writer->naluSize = 0;
-
-    // Reset the bitstream cache
-    writer->cache = 0;
-    writer->cacheLength = 0;
-    writer->oldZeroCount = 0;
-
     // NALU start code
-    if (writer->config.naluPrefix)
-    {
-        ret = writeBits(writer, 32, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE, 0);
-        if (ret < 0)
-        {
-            return -1;
-        }
-        bitsWritten += ret;
-    }
-
     // forbidden_zero_bit = 0
     // nal_ref_idc = 0
     // nal_unit_type = 6
-    ret = writeBits(writer, 8, ARSTREAM2_H264_NALU_TYPE_SEI, 0);
+    ret = bitstreamStartNalu(writer, ARSTREAM2_H264_NALU_TYPE_SEI, pbOutputBuf, outputBufSize);
     if (ret < 0)
     {
         return -1;
     }
-    bitsWritten += ret;
 
     if (pictureTiming)
     {
@@ -863,146 +935,151 @@ int ARSTREAM2_H264Writer_WriteSeiNalu(ARSTREAM2_H264Writer_Handle writerHandle,
     }
 
     // rbsp_trailing_bits
-    ret = writeBits(writer, 1, 1, 1);
+    ret = writeBits(writer, 1, 1);
     if (ret < 0)
     {
         return -1;
     }
     bitsWritten += ret;
 
-    ret = bitstreamByteAlign(writer, 1);
+    ret = bitstreamByteAlign(writer);
     if (ret < 0)
     {
         return -1;
     }
     bitsWritten += ret;
 
+    ret = bitstreamFlushNalu(writer);
+    if (ret < 0)
+    {
+        return -1;
+    }
+
     *outputSize = writer->naluSize;
 
     return 0;
 }
 
 
-static int ARSTREAM2_H264Writer_WriteRefPicListModification(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
+static inline int ARSTREAM2_H264Writer_HasChromaFormat(unsigned int profileIdc)
+{
+    return ((profileIdc == 100) || (profileIdc == 110) || (profileIdc == 122) || (profileIdc == 244) || (profileIdc == 44)
+            || (profileIdc == 83) || (profileIdc == 86) || (profileIdc == 118) || (profileIdc == 128)
+            || (profileIdc == 138) || (profileIdc == 139) || (profileIdc == 134) || (profileIdc == 135)) ? 1 : 0;
+}
+
+
+static int ARSTREAM2_H264Writer_WriteSpsRbsp(ARSTREAM2_H264Writer_t* writer, const ARSTREAM2_H264Writer_Sps_t *sps)
 {
     int ret = 0;
     int bitsWritten = 0;
 
-    if ((slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_I) && (slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_SI))
+    // profile_idc
+    ret = writeBits(writer, 8, sps->profileIdc);
+    if (ret < 0)
     {
-        // ref_pic_list_modification_flag_l0
-        ret = writeBits(writer, 1, slice->ref_pic_list_modification_flag_l0, 1);
-        if (ret < 0)
-        {
-            return -1;
-        }
-        bitsWritten += ret;
+        return -1;
+    }
+    bitsWritten += ret;
 
-        if (slice->ref_pic_list_modification_flag_l0)
-        {
-            // UNSUPPORTED
-            return -1;
-        }
+    // constraint_set0_flag to constraint_set5_flag, reserved_zero_2bits
+    ret = writeBits(writer, 8, sps->constraintSetFlags & 0xFC);
+    if (ret < 0)
+    {
+        return -1;
     }
+    bitsWritten += ret;
 
-    if (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
+    // level_idc
+    ret = writeBits(writer, 8, sps->levelIdc);
+    if (ret < 0)
     {
-        // ref_pic_list_modification_flag_l1
-        ret = writeBits(writer, 1, slice->ref_pic_list_modification_flag_l1, 1);
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // seq_parameter_set_id
+    ret = writeBits_expGolomb_ue(writer, sps->seqParameterSetId);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (ARSTREAM2_H264Writer_HasChromaFormat(sps->profileIdc))
+    {
+        // chroma_format_idc
+        ret = writeBits_expGolomb_ue(writer, sps->chromaFormatIdc);
         if (ret < 0)
         {
             return -1;
         }
         bitsWritten += ret;
 
-        if (slice->ref_pic_list_modification_flag_l1)
+        if (sps->chromaFormatIdc == 3)
         {
-            // UNSUPPORTED
-            return -1;
+            // separate_colour_plane_flag
+            ret = writeBits(writer, 1, 0);
+            if (ret < 0)
+            {
+                return -1;
+            }
+            bitsWritten += ret;
         }
-    }
-
-    return bitsWritten;
-}
-
-
-static int ARSTREAM2_H264Writer_WriteDecRefPicMarking(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
-{
-    int ret = 0;
-    int bitsWritten = 0;
 
-    if (slice->idrPicFlag)
-    {
-        // no_output_of_prior_pics_flag
-        ret = writeBits(writer, 1, slice->no_output_of_prior_pics_flag, 1);
+        // bit_depth_luma_minus8
+        ret = writeBits_expGolomb_ue(writer, 0);
         if (ret < 0)
         {
             return -1;
         }
         bitsWritten += ret;
 
-        // long_term_reference_flag
-        ret = writeBits(writer, 1, slice->long_term_reference_flag, 1);
+        // bit_depth_chroma_minus8
+        ret = writeBits_expGolomb_ue(writer, 0);
         if (ret < 0)
         {
             return -1;
         }
         bitsWritten += ret;
-    }
-    else
-    {
-        // adaptive_ref_pic_marking_mode_flag
-        ret = writeBits(writer, 1, slice->adaptive_ref_pic_marking_mode_flag, 1);
+
+        // qpprime_y_zero_transform_bypass_flag
+        ret = writeBits(writer, 1, 0);
         if (ret < 0)
         {
             return -1;
         }
         bitsWritten += ret;
 
-        if (slice->adaptive_ref_pic_marking_mode_flag)
+        // seq_scaling_matrix_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
         {
-            // UNSUPPORTED
             return -1;
         }
+        bitsWritten += ret;
     }
 
-    return bitsWritten;
-}
-
-
-static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
-{
-    int ret = 0;
-    int bitsWritten = 0;
-
-    // first_mb_in_slice
-    ret = writeBits_expGolomb_ue(writer, slice->first_mb_in_slice, 1);
-    if (ret < 0)
-    {
-        return -1;
-    }
-    bitsWritten += ret;
-
-    // slice_type
-    ret = writeBits_expGolomb_ue(writer, slice->slice_type, 1);
+    // log2_max_frame_num_minus4
+    ret = writeBits_expGolomb_ue(writer, sps->log2MaxFrameNumMinus4);
     if (ret < 0)
     {
         return -1;
     }
     bitsWritten += ret;
 
-    // pic_parameter_set_id
-    ret = writeBits_expGolomb_ue(writer, slice->pic_parameter_set_id, 1);
+    // pic_order_cnt_type
+    ret = writeBits_expGolomb_ue(writer, sps->picOrderCntType);
     if (ret < 0)
     {
         return -1;
     }
     bitsWritten += ret;
 
-    if (sps->separate_colour_plane_flag == 1)
+    if (sps->picOrderCntType == 0)
     {
-        // colour_plane_id
-        ret = writeBits(writer, 2, slice->colour_plane_id, 1);
+        // log2_max_pic_order_cnt_lsb_minus4
+        ret = writeBits_expGolomb_ue(writer, sps->log2MaxPicOrderCntLsbMinus4);
         if (ret < 0)
         {
             return -1;
@@ -1010,18 +1087,615 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         bitsWritten += ret;
     }
 
-    // frame_num
-    ret = writeBits(writer, sps->log2_max_frame_num_minus4 + 4, slice->frame_num, 1);
+    // max_num_ref_frames
+    ret = writeBits_expGolomb_ue(writer, sps->maxNumRefFrames);
     if (ret < 0)
     {
         return -1;
     }
     bitsWritten += ret;
 
-    if (!sps->frame_mbs_only_flag)
+    // gaps_in_frame_num_value_allowed_flag
+    ret = writeBits(writer, 1, sps->gapsInFrameNumValueAllowedFlag);
+    if (ret < 0)
     {
-        // field_pic_flag
-        ret = writeBits(writer, 1, slice->field_pic_flag, 1);
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // pic_width_in_mbs_minus1
+    ret = writeBits_expGolomb_ue(writer, sps->picWidthInMbsMinus1);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // pic_height_in_map_units_minus1
+    ret = writeBits_expGolomb_ue(writer, sps->picHeightInMapUnitsMinus1);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // frame_mbs_only_flag
+    ret = writeBits(writer, 1, sps->frameMbsOnlyFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (!sps->frameMbsOnlyFlag)
+    {
+        // mb_adaptive_frame_field_flag
+        ret = writeBits(writer, 1, sps->mbAdaptiveFrameFieldFlag);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+    }
+
+    // direct_8x8_inference_flag
+    ret = writeBits(writer, 1, sps->direct8x8InferenceFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // frame_cropping_flag
+    ret = writeBits(writer, 1, sps->frameCroppingFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (sps->frameCroppingFlag)
+    {
+        // frame_crop_left_offset
+        ret = writeBits_expGolomb_ue(writer, sps->frameCropLeftOffset);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // frame_crop_right_offset
+        ret = writeBits_expGolomb_ue(writer, sps->frameCropRightOffset);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // frame_crop_top_offset
+        ret = writeBits_expGolomb_ue(writer, sps->frameCropTopOffset);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // frame_crop_bottom_offset
+        ret = writeBits_expGolomb_ue(writer, sps->frameCropBottomOffset);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+    }
+
+    // vui_parameters_present_flag
+    ret = writeBits(writer, 1, sps->vuiParametersPresentFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (sps->vuiParametersPresentFlag)
+    {
+        // vui_parameters
+        // aspect_ratio_info_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // overscan_info_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // video_signal_type_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // chroma_loc_info_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // timing_info_present_flag
+        ret = writeBits(writer, 1, sps->timingInfoPresentFlag);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        if (sps->timingInfoPresentFlag)
+        {
+            // num_units_in_tick
+            ret = writeBits(writer, 32, sps->numUnitsInTick);
+            if (ret < 0)
+            {
+                return -1;
+            }
+            bitsWritten += ret;
+
+            // time_scale
+            ret = writeBits(writer, 32, sps->timeScale);
+            if (ret < 0)
+            {
+                return -1;
+            }
+            bitsWritten += ret;
+
+            // fixed_frame_rate_flag
+            ret = writeBits(writer, 1, sps->fixedFrameRateFlag);
+            if (ret < 0)
+            {
+                return -1;
+            }
+            bitsWritten += ret;
+        }
+
+        // nal_hrd_parameters_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // vcl_hrd_parameters_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // pic_struct_present_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // bitstream_restriction_flag
+        ret = writeBits(writer, 1, 0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+    }
+
+    return bitsWritten;
+}
+
+
+static int ARSTREAM2_H264Writer_WritePpsRbsp(ARSTREAM2_H264Writer_t* writer, const ARSTREAM2_H264Writer_Pps_t *pps)
+{
+    int ret = 0;
+    int bitsWritten = 0;
+
+    // pic_parameter_set_id
+    ret = writeBits_expGolomb_ue(writer, pps->picParameterSetId);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // seq_parameter_set_id
+    ret = writeBits_expGolomb_ue(writer, pps->seqParameterSetId);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // entropy_coding_mode_flag
+    ret = writeBits(writer, 1, pps->entropyCodingModeFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // bottom_field_pic_order_in_frame_present_flag
+    ret = writeBits(writer, 1, pps->bottomFieldPicOrderInFramePresentFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // num_slice_groups_minus1
+    ret = writeBits_expGolomb_ue(writer, 0);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // num_ref_idx_l0_default_active_minus1
+    ret = writeBits_expGolomb_ue(writer, pps->numRefIdxL0DefaultActiveMinus1);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // num_ref_idx_l1_default_active_minus1
+    ret = writeBits_expGolomb_ue(writer, pps->numRefIdxL1DefaultActiveMinus1);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // weighted_pred_flag
+    ret = writeBits(writer, 1, pps->weightedPredFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // weighted_bipred_idc
+    ret = writeBits(writer, 2, pps->weightedBipredIdc);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // pic_init_qp_minus26
+    ret = writeBits_expGolomb_se(writer, pps->picInitQpMinus26);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // pic_init_qs_minus26
+    ret = writeBits_expGolomb_se(writer, pps->picInitQsMinus26);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // chroma_qp_index_offset
+    ret = writeBits_expGolomb_se(writer, pps->chromaQpIndexOffset);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // deblocking_filter_control_present_flag
+    ret = writeBits(writer, 1, pps->deblockingFilterControlPresentFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // constrained_intra_pred_flag
+    ret = writeBits(writer, 1, pps->constrainedIntraPredFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // redundant_pic_cnt_present_flag
+    ret = writeBits(writer, 1, pps->redundantPicCntPresentFlag);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    return bitsWritten;
+}
+
+
+/* Write the RBSP trailing bits and the RBSP buffer to the NAL unit */
+static int ARSTREAM2_H264Writer_FinishNalu(ARSTREAM2_H264Writer_t* writer)
+{
+    int ret = 0;
+    int bitsWritten = 0;
+
+    // rbsp_trailing_bits
+    ret = writeBits(writer, 1, 1);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    ret = bitstreamByteAlign(writer);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    ret = bitstreamFlushNalu(writer);
+    if (ret < 0)
+    {
+        return -1;
+    }
+
+    return bitsWritten;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSpsNalu(ARSTREAM2_H264Writer_Handle writerHandle, const ARSTREAM2_H264Writer_Sps_t *sps,
+                                                   uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    int ret = 0;
+
+    if ((!writerHandle) || (!sps) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (sps->picOrderCntType == 1)
+    {
+        // UNSUPPORTED
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "SPS: pic_order_cnt_type==1 is not supported");
+        return ARSTREAM2_ERROR_UNSUPPORTED;
+    }
+
+    // NALU start code
+    // forbidden_zero_bit = 0
+    // nal_ref_idc = 3
+    // nal_unit_type = 7
+    ret = bitstreamStartNalu(writer, (3 << 5) | ARSTREAM2_H264_NALU_TYPE_SPS, pbOutputBuf, outputBufSize);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    // seq_parameter_set_data
+    ret = ARSTREAM2_H264Writer_WriteSpsRbsp(writer, sps);
+    if (ret < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Error: ARSTREAM2_H264Writer_WriteSpsRbsp() failed (%d)", ret);
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    ret = ARSTREAM2_H264Writer_FinishNalu(writer);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    *outputSize = writer->naluSize;
+
+    return ARSTREAM2_OK;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WritePpsNalu(ARSTREAM2_H264Writer_Handle writerHandle, const ARSTREAM2_H264Writer_Pps_t *pps,
+                                                   uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    int ret = 0;
+
+    if ((!writerHandle) || (!pps) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    // NALU start code
+    // forbidden_zero_bit = 0
+    // nal_ref_idc = 3
+    // nal_unit_type = 8
+    ret = bitstreamStartNalu(writer, (3 << 5) | ARSTREAM2_H264_NALU_TYPE_PPS, pbOutputBuf, outputBufSize);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    // pic_parameter_set_rbsp
+    ret = ARSTREAM2_H264Writer_WritePpsRbsp(writer, pps);
+    if (ret < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Error: ARSTREAM2_H264Writer_WritePpsRbsp() failed (%d)", ret);
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    ret = ARSTREAM2_H264Writer_FinishNalu(writer);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    *outputSize = writer->naluSize;
+
+    return ARSTREAM2_OK;
+}
+
+
+static int ARSTREAM2_H264Writer_WriteRefPicListModification(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
+{
+    int ret = 0;
+    int bitsWritten = 0;
+
+    if ((slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_I) && (slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_SI))
+    {
+        // ref_pic_list_modification_flag_l0
+        ret = writeBits(writer, 1, slice->ref_pic_list_modification_flag_l0);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        if (slice->ref_pic_list_modification_flag_l0)
+        {
+            // UNSUPPORTED
+            return -1;
+        }
+    }
+
+    if (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
+    {
+        // ref_pic_list_modification_flag_l1
+        ret = writeBits(writer, 1, slice->ref_pic_list_modification_flag_l1);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        if (slice->ref_pic_list_modification_flag_l1)
+        {
+            // UNSUPPORTED
+            return -1;
+        }
+    }
+
+    return bitsWritten;
+}
+
+
+static int ARSTREAM2_H264Writer_WriteDecRefPicMarking(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
+{
+    int ret = 0;
+    int bitsWritten = 0;
+
+    if (slice->idrPicFlag)
+    {
+        // no_output_of_prior_pics_flag
+        ret = writeBits(writer, 1, slice->no_output_of_prior_pics_flag);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        // long_term_reference_flag
+        ret = writeBits(writer, 1, slice->long_term_reference_flag);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+    }
+    else
+    {
+        // adaptive_ref_pic_marking_mode_flag
+        ret = writeBits(writer, 1, slice->adaptive_ref_pic_marking_mode_flag);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+
+        if (slice->adaptive_ref_pic_marking_mode_flag)
+        {
+            // UNSUPPORTED
+            return -1;
+        }
+    }
+
+    return bitsWritten;
+}
+
+
+static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SpsContext_t *sps, ARSTREAM2_H264_PpsContext_t *pps)
+{
+    int ret = 0;
+    int bitsWritten = 0;
+
+    writer->idrPicIdBitOffset = -1;
+    writer->pocLsbBitOffset = -1;
+
+    // first_mb_in_slice
+    ret = writeBits_expGolomb_ue(writer, slice->first_mb_in_slice);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // slice_type
+    ret = writeBits_expGolomb_ue(writer, slice->slice_type);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    // pic_parameter_set_id
+    ret = writeBits_expGolomb_ue(writer, slice->pic_parameter_set_id);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (sps->separate_colour_plane_flag == 1)
+    {
+        // colour_plane_id
+        ret = writeBits(writer, 2, slice->colour_plane_id);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        bitsWritten += ret;
+    }
+
+    // frame_num
+    writer->frameNumBitOffset = bitsWritten;
+    ret = writeBits(writer, sps->log2_max_frame_num_minus4 + 4, slice->frame_num);
+    if (ret < 0)
+    {
+        return -1;
+    }
+    bitsWritten += ret;
+
+    if (!sps->frame_mbs_only_flag)
+    {
+        // field_pic_flag
+        ret = writeBits(writer, 1, slice->field_pic_flag);
         if (ret < 0)
         {
             return -1;
@@ -1031,7 +1705,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if (slice->field_pic_flag)
         {
             // bottom_field_flag
-            ret = writeBits(writer, 1, slice->bottom_field_flag, 1);
+            ret = writeBits(writer, 1, slice->bottom_field_flag);
             if (ret < 0)
             {
                 return -1;
@@ -1043,7 +1717,8 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if (slice->idrPicFlag)
     {
         // idr_pic_id
-        ret = writeBits_expGolomb_ue(writer, slice->idr_pic_id, 1);
+        writer->idrPicIdBitOffset = bitsWritten;
+        ret = writeBits_expGolomb_ue(writer, slice->idr_pic_id);
         if (ret < 0)
         {
             return -1;
@@ -1054,7 +1729,8 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if (sps->pic_order_cnt_type == 0)
     {
         // pic_order_cnt_lsb
-        ret = writeBits(writer, sps->log2_max_pic_order_cnt_lsb_minus4 + 4, slice->pic_order_cnt_lsb, 1);
+        writer->pocLsbBitOffset = bitsWritten;
+        ret = writeBits(writer, sps->log2_max_pic_order_cnt_lsb_minus4 + 4, slice->pic_order_cnt_lsb);
         if (ret < 0)
         {
             return -1;
@@ -1064,7 +1740,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if ((pps->bottom_field_pic_order_in_frame_present_flag) && (!slice->field_pic_flag))
         {
             // delta_pic_order_cnt_bottom
-            ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_bottom, 1);
+            ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_bottom);
             if (ret < 0)
             {
                 return -1;
@@ -1076,7 +1752,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if ((sps->pic_order_cnt_type == 1) && (!sps->delta_pic_order_always_zero_flag))
     {
         // delta_pic_order_cnt[0]
-        ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_0, 1);
+        ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_0);
         if (ret < 0)
         {
             return -1;
@@ -1086,7 +1762,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if ((pps->bottom_field_pic_order_in_frame_present_flag) && (!slice->field_pic_flag))
         {
             // delta_pic_order_cnt[1]
-            ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_1, 1);
+            ret = writeBits_expGolomb_se(writer, slice->delta_pic_order_cnt_1);
             if (ret < 0)
             {
                 return -1;
@@ -1098,7 +1774,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if (pps->redundant_pic_cnt_present_flag)
     {
         // redundant_pic_cnt
-        ret = writeBits_expGolomb_ue(writer, slice->redundant_pic_cnt, 1);
+        ret = writeBits_expGolomb_ue(writer, slice->redundant_pic_cnt);
         if (ret < 0)
         {
             return -1;
@@ -1109,7 +1785,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
     {
         // direct_spatial_mv_pred_flag
-        ret = writeBits(writer, 1, slice->direct_spatial_mv_pred_flag, 1);
+        ret = writeBits(writer, 1, slice->direct_spatial_mv_pred_flag);
         if (ret < 0)
         {
             return -1;
@@ -1120,7 +1796,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if ((slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_P) || (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_SP) || (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B))
     {
         // num_ref_idx_active_override_flag
-        ret = writeBits(writer, 1, slice->num_ref_idx_active_override_flag, 1);
+        ret = writeBits(writer, 1, slice->num_ref_idx_active_override_flag);
         if (ret < 0)
         {
             return -1;
@@ -1130,7 +1806,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if (slice->num_ref_idx_active_override_flag)
         {
             // num_ref_idx_l0_active_minus1
-            ret = writeBits_expGolomb_ue(writer, slice->num_ref_idx_l0_active_minus1, 1);
+            ret = writeBits_expGolomb_ue(writer, slice->num_ref_idx_l0_active_minus1);
             if (ret < 0)
             {
                 return -1;
@@ -1140,7 +1816,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
             if (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_B)
             {
                 // num_ref_idx_l1_active_minus1
-                ret = writeBits_expGolomb_ue(writer, slice->num_ref_idx_l1_active_minus1, 1);
+                ret = writeBits_expGolomb_ue(writer, slice->num_ref_idx_l1_active_minus1);
                 if (ret < 0)
                 {
                     return -1;
@@ -1189,7 +1865,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if ((pps->entropy_coding_mode_flag) && (slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_I) && (slice->sliceTypeMod5 != ARSTREAM2_H264_SLICE_TYPE_SI))
     {
         // cabac_init_idc
-        ret = writeBits_expGolomb_ue(writer, slice->cabac_init_idc, 1);
+        ret = writeBits_expGolomb_ue(writer, slice->cabac_init_idc);
         if (ret < 0)
         {
             return -1;
@@ -1198,7 +1874,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     }
 
     // slice_qp_delta
-    ret = writeBits_expGolomb_se(writer, slice->slice_qp_delta, 1);
+    ret = writeBits_expGolomb_se(writer, slice->slice_qp_delta);
     if (ret < 0)
     {
         return -1;
@@ -1210,7 +1886,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if (slice->sliceTypeMod5 == ARSTREAM2_H264_SLICE_TYPE_SP)
         {
             // sp_for_switch_flag
-            ret = writeBits(writer, 1, slice->sp_for_switch_flag, 1);
+            ret = writeBits(writer, 1, slice->sp_for_switch_flag);
             if (ret < 0)
             {
                 return -1;
@@ -1219,7 +1895,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         }
 
         // slice_qs_delta
-        ret = writeBits_expGolomb_se(writer, slice->slice_qs_delta, 1);
+        ret = writeBits_expGolomb_se(writer, slice->slice_qs_delta);
         if (ret < 0)
         {
             return -1;
@@ -1230,7 +1906,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
     if (pps->deblocking_filter_control_present_flag)
     {
         // disable_deblocking_filter_idc
-        ret = writeBits_expGolomb_ue(writer, slice->disable_deblocking_filter_idc, 1);
+        ret = writeBits_expGolomb_ue(writer, slice->disable_deblocking_filter_idc);
         if (ret < 0)
         {
             return -1;
@@ -1240,7 +1916,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         if (slice->disable_deblocking_filter_idc != 1)
         {
             // slice_alpha_c0_offset_div2
-            ret = writeBits_expGolomb_se(writer, slice->slice_alpha_c0_offset_div2, 1);
+            ret = writeBits_expGolomb_se(writer, slice->slice_alpha_c0_offset_div2);
             if (ret < 0)
             {
                 return -1;
@@ -1248,7 +1924,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
             bitsWritten += ret;
 
             // slice_beta_offset_div2
-            ret = writeBits_expGolomb_se(writer, slice->slice_beta_offset_div2, 1);
+            ret = writeBits_expGolomb_se(writer, slice->slice_beta_offset_div2);
             if (ret < 0)
             {
                 return -1;
@@ -1265,7 +1941,7 @@ static int ARSTREAM2_H264Writer_WriteSliceHeader(ARSTREAM2_H264Writer_t* writer,
         n = ceil(log2((picSizeInMapUnits / (pps->slice_group_change_rate_minus1 + 1)) + 1));
 
         // slice_group_change_cycle
-        ret = writeBits(writer, n, slice->slice_group_change_cycle, 1);
+        ret = writeBits(writer, n, slice->slice_group_change_cycle);
         if (ret < 0)
         {
             return -1;
@@ -1290,7 +1966,7 @@ static int ARSTREAM2_H264Writer_WriteSkippedPSliceData(ARSTREAM2_H264Writer_t* w
     }
 
     // mb_skip_run
-    ret = writeBits_expGolomb_ue(writer, slice->sliceMbCount, 1);
+    ret = writeBits_expGolomb_ue(writer, slice->sliceMbCount);
     if (ret < 0)
     {
         return -1;
@@ -1319,7 +1995,7 @@ static int ARSTREAM2_H264Writer_WriteGrayISliceData(ARSTREAM2_H264Writer_t* writ
     for (i = 0; i < writer->sliceContext.sliceMbCount; i++)
     {
         // mb_type = 3 (I_16x16_2_0_0: Intra16x16PredMode = 2/DC, CodedBlockPatternLuma = 0, CodedBlockPatternChroma = 0)
-        ret = writeBits_expGolomb_ue(writer, 3, 1);
+        ret = writeBits_expGolomb_ue(writer, 3);
         if (ret < 0)
         {
             return -1;
@@ -1327,7 +2003,7 @@ static int ARSTREAM2_H264Writer_WriteGrayISliceData(ARSTREAM2_H264Writer_t* writ
         bitsWritten += ret;
         
         // mb_pred -> intra_chroma_pred_mode = 0 (DC)
-        ret = writeBits_expGolomb_ue(writer, 0, 1);
+        ret = writeBits_expGolomb_ue(writer, 0);
         if (ret < 0)
         {
             return -1;
@@ -1335,7 +2011,7 @@ static int ARSTREAM2_H264Writer_WriteGrayISliceData(ARSTREAM2_H264Writer_t* writ
         bitsWritten += ret;
 
         // mb_qp_delta = 0
-        ret = writeBits_expGolomb_se(writer, 0, 1);
+        ret = writeBits_expGolomb_se(writer, 0);
         if (ret < 0)
         {
             return -1;
@@ -1343,7 +2019,7 @@ static int ARSTREAM2_H264Writer_WriteGrayISliceData(ARSTREAM2_H264Writer_t* writ
         bitsWritten += ret;
 
         // residual(0, 15) -> residual_luma(i16x16DClevel, i16x16AClevel, level4x4, level8x8, 0, 15) -> residual_block_cavlc(i16x16DClevel, 0, 15, 16) -> coeff_token = 1 (nC = 0)
-        ret = writeBits(writer, 1, 1, 1);
+        ret = writeBits(writer, 1, 1);
         if (ret < 0)
         {
             return -1;
@@ -1390,40 +2066,21 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_RewriteNonRefPSliceNalu(ARSTREAM2_H264Writ
         return ARSTREAM2_ERROR_UNSUPPORTED;
     }
 
-    /* NB: changing nal_ref_idc to 0 means that dec_ref_pic_marking() will no more be present in the slice header.
-     * Therefore adaptive_ref_pic_marking_mode_flag will not be present and the original slice_data() syntax must
-     * be shifted left by 1 bit.
-     */
-
-    writer->pNaluBuf = pbOutputBuf;
-    writer->naluBufSize = outputBufSize;
-    writer->naluSize = 0;
-
-    // Reset the bitstream cache
-    writer->cache = 0;
-    writer->cacheLength = 0;
-    writer->oldZeroCount = 0;
-
-    // NALU start code
-    if (writer->config.naluPrefix)
-    {
-        ret = writeBits(writer, 32, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE, 0);
-        if (ret < 0)
-        {
-            return ARSTREAM2_ERROR_INVALID_STATE;
-        }
-        bitsWritten += ret;
-    }
+    /* NB: changing nal_ref_idc to 0 means that dec_ref_pic_marking() will no more be present in the slice header.
+     * Therefore adaptive_ref_pic_marking_mode_flag will not be present and the original slice_data() syntax must
+     * be shifted left by 1 bit.
+     */
 
+    // NALU start code
     // forbidden_zero_bit
     // nal_ref_idc
     // nal_unit_type
-    ret = writeBits(writer, 8, ((writer->sliceContext.nal_ref_idc & 3) << 5) | writer->sliceContext.nal_unit_type, 0);
+    ret = bitstreamStartNalu(writer, ((writer->sliceContext.nal_ref_idc & 3) << 5) | writer->sliceContext.nal_unit_type, pbOutputBuf, outputBufSize);
     if (ret < 0)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
-    bitsWritten += ret;
+    bitsWritten += writer->naluSize * 8;
 
     // slice_header
     ret = ARSTREAM2_H264Writer_WriteSliceHeader(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
@@ -1452,8 +2109,8 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_RewriteNonRefPSliceNalu(ARSTREAM2_H264Writ
 
     int dstBitOffset = bitsWritten & 7;
     int dstOffset = bitsWritten / 8;
-    ret = bitstreamByteAlign(writer, 1);
-    if (ret < 0)
+    ret = bitstreamByteAlign(writer);
+    if ((ret < 0) || (bitstreamFlushNalu(writer) < 0))
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
@@ -1617,123 +2274,235 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_RewriteNonRefPSliceNalu(ARSTREAM2_H264Writ
 }
 
 
-eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSkippedPSliceNalu(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+static inline unsigned int expGolombLength_ue(uint32_t _value)
 {
-    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
-    int ret = 0, bitsWritten = 0;
+    return 2 * (31 - __builtin_clz(_value + 1)) + 1;
+}
 
-    if ((!writerHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
-    {
-        return ARSTREAM2_ERROR_BAD_PARAMETERS;
-    }
 
-    if (!writer->isSpsPpsContextValid)
-    {
-        return ARSTREAM2_ERROR_INVALID_STATE;
-    }
+static void ARSTREAM2_H264Writer_PatchBits(uint8_t *pBuf, unsigned int bitOffset, unsigned int numBits, uint32_t value)
+{
+    unsigned int i, pos, shift;
+    uint8_t mask;
 
-    // Slice context
-    if (sliceContext)
-    {
-        memcpy(&writer->sliceContext, sliceContext, sizeof(ARSTREAM2_H264_SliceContext_t));
-        writer->sliceContext.first_mb_in_slice = firstMbInSlice;
-        writer->sliceContext.sliceMbCount = sliceMbCount;
-        writer->sliceContext.slice_type = (writer->sliceContext.slice_type >= 5) ? ARSTREAM2_H264_SLICE_TYPE_P_ALL : ARSTREAM2_H264_SLICE_TYPE_P;
-        writer->sliceContext.sliceTypeMod5 = writer->sliceContext.slice_type % 5;
-        writer->sliceContext.redundant_pic_cnt = 0;
-        writer->sliceContext.direct_spatial_mv_pred_flag = 0;
-        writer->sliceContext.slice_qp_delta = 0;
-        writer->sliceContext.disable_deblocking_filter_idc = 2; // disable deblocking across slice boundaries
-        writer->sliceContext.slice_alpha_c0_offset_div2 = 0;
-        writer->sliceContext.slice_beta_offset_div2 = 0;
-    }
-    else
+    for (i = 0; i < numBits; i++)
     {
-        // UNSUPPORTED
-        return ARSTREAM2_ERROR_UNSUPPORTED;
+        pos = bitOffset + i;
+        mask = 0x80 >> (pos & 7);
+        shift = numBits - 1 - i;
+        // Exp-Golomb codes can be up to 33 bits long, the leading bits are zeros
+        if ((shift < 32) && ((value >> shift) & 1))
+        {
+            pBuf[pos >> 3] |= mask;
+        }
+        else
+        {
+            pBuf[pos >> 3] &= ~mask;
+        }
     }
+}
 
-    writer->pNaluBuf = pbOutputBuf;
-    writer->naluBufSize = outputBufSize;
-    writer->naluSize = 0;
 
-    // Reset the bitstream cache
-    writer->cache = 0;
-    writer->cacheLength = 0;
-    writer->oldZeroCount = 0;
+static void ARSTREAM2_H264Writer_GetSliceTemplateKey(const ARSTREAM2_H264_SliceContext_t *slice, ARSTREAM2_H264_SliceContext_t *key)
+{
+    memcpy(key, slice, sizeof(ARSTREAM2_H264_SliceContext_t));
+    key->sliceHeaderLengthInBits = 0;
+    key->frame_num = 0;
+    key->idr_pic_id = 0;
+    key->pic_order_cnt_lsb = 0;
+}
 
-    // NALU start code
-    if (writer->config.naluPrefix)
+
+static int ARSTREAM2_H264Writer_BuildSliceTemplate(ARSTREAM2_H264Writer_t* writer, ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate, eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE type)
+{
+    int ret = 0;
+    unsigned int bufSize;
+    uint8_t *pBuf;
+
+    // The gray I-slice data is one byte per macroblock
+    bufSize = ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_HEADER_MAX_SIZE + ((type == ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I) ? writer->sliceContext.sliceMbCount : 8);
+    if (sliceTemplate->rbspBufSize < bufSize)
     {
-        ret = writeBits(writer, 32, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE, 0);
-        if (ret < 0)
+        pBuf = realloc(sliceTemplate->pRbspBuf, bufSize);
+        if (!pBuf)
         {
-            return ARSTREAM2_ERROR_INVALID_STATE;
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Slice template allocation failed (size %d)", bufSize);
+            return -1;
         }
-        bitsWritten += ret;
+        sliceTemplate->pRbspBuf = pBuf;
+        sliceTemplate->rbspBufSize = bufSize;
     }
 
-    // forbidden_zero_bit
-    // nal_ref_idc
-    // nal_unit_type
-    ret = writeBits(writer, 8, ((writer->sliceContext.nal_ref_idc & 3) << 5) | writer->sliceContext.nal_unit_type, 0);
-    if (ret < 0)
-    {
-        return ARSTREAM2_ERROR_INVALID_STATE;
-    }
-    bitsWritten += ret;
+    // Reset the bitstream cache
+    bitstreamReset(writer, sliceTemplate->rbspBufSize - 1);
 
     // slice_header
     ret = ARSTREAM2_H264Writer_WriteSliceHeader(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
     if (ret < 0)
     {
-        return ARSTREAM2_ERROR_INVALID_STATE;
+        return -1;
     }
-    bitsWritten += ret;
 
     // slice_data
-    ret = ARSTREAM2_H264Writer_WriteSkippedPSliceData(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
+    if (type == ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I)
+    {
+        ret = ARSTREAM2_H264Writer_WriteGrayISliceData(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
+    }
+    else
+    {
+        ret = ARSTREAM2_H264Writer_WriteSkippedPSliceData(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
+    }
     if (ret < 0)
     {
-        return ARSTREAM2_ERROR_INVALID_STATE;
+        return -1;
     }
-    bitsWritten += ret;
 
     // rbsp_slice_trailing_bits
 
     // rbsp_trailing_bits
-    ret = writeBits(writer, 1, 1, 1);
+    ret = writeBits(writer, 1, 1);
     if (ret < 0)
     {
-        return ARSTREAM2_ERROR_INVALID_STATE;
+        return -1;
     }
-    bitsWritten += ret;
 
-    ret = bitstreamByteAlign(writer, 1);
+    ret = bitstreamByteAlign(writer);
     if (ret < 0)
     {
-        return ARSTREAM2_ERROR_INVALID_STATE;
+        return -1;
     }
-    bitsWritten += ret;
 
     //TODO: cabac_zero_word
 
-    *outputSize = writer->naluSize;
+    // Keep the RBSP without emulation prevention so that fields can be patched at fixed bit positions
 
-    return ARSTREAM2_OK;
+    // forbidden_zero_bit
+    // nal_ref_idc
+    // nal_unit_type
+    sliceTemplate->pRbspBuf[0] = ((writer->sliceContext.nal_ref_idc & 3) << 5) | writer->sliceContext.nal_unit_type;
+    memcpy(sliceTemplate->pRbspBuf + 1, writer->pRbspBuf, writer->rbspSize);
+    sliceTemplate->rbspSize = 1 + writer->rbspSize;
+    writer->rbspSize = 0;
+
+    sliceTemplate->frameNumOffset = 8 + writer->frameNumBitOffset;
+    sliceTemplate->frameNumLength = writer->spsContext.log2_max_frame_num_minus4 + 4;
+    sliceTemplate->pocLsbLength = writer->spsContext.log2_max_pic_order_cnt_lsb_minus4 + 4;
+    sliceTemplate->idrPicIdOffset = (writer->idrPicIdBitOffset >= 0) ? 8 + writer->idrPicIdBitOffset : -1;
+    sliceTemplate->pocLsbOffset = (writer->pocLsbBitOffset >= 0) ? 8 + writer->pocLsbBitOffset : -1;
+
+    return 0;
 }
 
 
-eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+static ARSTREAM2_H264Writer_SliceTemplate_t* ARSTREAM2_H264Writer_GetSliceTemplate(ARSTREAM2_H264Writer_t* writer, eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE type)
 {
-    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
-    int ret = 0, bitsWritten = 0;
+    ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate;
+    ARSTREAM2_H264_SliceContext_t key;
+    unsigned int idrPicIdLength, i;
 
-    if ((!writerHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    ARSTREAM2_H264Writer_GetSliceTemplateKey(&writer->sliceContext, &key);
+    idrPicIdLength = (writer->sliceContext.idrPicFlag) ? expGolombLength_ue(writer->sliceContext.idr_pic_id) : 0;
+
+    for (i = 0; i < ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT; i++)
     {
-        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        sliceTemplate = &writer->sliceTemplate[i];
+        if ((sliceTemplate->valid) && (sliceTemplate->type == type)
+                && (sliceTemplate->key.first_mb_in_slice == key.first_mb_in_slice)
+                && (sliceTemplate->key.sliceMbCount == key.sliceMbCount)
+                && (sliceTemplate->idrPicIdLength == idrPicIdLength)
+                && (memcmp(&sliceTemplate->key, &key, sizeof(ARSTREAM2_H264_SliceContext_t)) == 0))
+        {
+            return sliceTemplate;
+        }
+    }
+
+    // Not found: replace the oldest template
+    sliceTemplate = &writer->sliceTemplate[writer->nextSliceTemplate];
+    writer->nextSliceTemplate = (writer->nextSliceTemplate + 1) % ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT;
+    sliceTemplate->valid = 0;
+
+    if (ARSTREAM2_H264Writer_BuildSliceTemplate(writer, sliceTemplate, type) != 0)
+    {
+        return NULL;
+    }
+
+    sliceTemplate->type = type;
+    memcpy(&sliceTemplate->key, &key, sizeof(ARSTREAM2_H264_SliceContext_t));
+    sliceTemplate->idrPicIdLength = idrPicIdLength;
+    sliceTemplate->valid = 1;
+
+    return sliceTemplate;
+}
+
+
+static eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSliceTemplateNalu(ARSTREAM2_H264Writer_t* writer, const ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate, unsigned int frameNum, unsigned int idrPicId, unsigned int picOrderCntLsb, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    uint8_t head[ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_HEADER_MAX_SIZE];
+    unsigned int headSize, size = 0;
+    int ret, zeroCount = 0;
+
+    // Patch the fields that vary from one picture to the next in a copy of the slice header start
+    headSize = sliceTemplate->frameNumOffset + sliceTemplate->frameNumLength;
+    if ((sliceTemplate->idrPicIdOffset >= 0) && (sliceTemplate->idrPicIdOffset + sliceTemplate->idrPicIdLength > headSize))
+    {
+        headSize = sliceTemplate->idrPicIdOffset + sliceTemplate->idrPicIdLength;
+    }
+    if ((sliceTemplate->pocLsbOffset >= 0) && (sliceTemplate->pocLsbOffset + sliceTemplate->pocLsbLength > headSize))
+    {
+        headSize = sliceTemplate->pocLsbOffset + sliceTemplate->pocLsbLength;
+    }
+    headSize = (headSize + 7) / 8;
+    memcpy(head, sliceTemplate->pRbspBuf, headSize);
+
+    ARSTREAM2_H264Writer_PatchBits(head, sliceTemplate->frameNumOffset, sliceTemplate->frameNumLength, frameNum);
+    if (sliceTemplate->idrPicIdOffset >= 0)
+    {
+        ARSTREAM2_H264Writer_PatchBits(head, sliceTemplate->idrPicIdOffset, sliceTemplate->idrPicIdLength, idrPicId + 1);
+    }
+    if (sliceTemplate->pocLsbOffset >= 0)
+    {
+        ARSTREAM2_H264Writer_PatchBits(head, sliceTemplate->pocLsbOffset, sliceTemplate->pocLsbLength, picOrderCntLsb);
+    }
+
+    if (outputBufSize < sliceTemplate->rbspSize + ((writer->config.naluPrefix) ? 4 : 0))
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    // NALU start code
+    if (writer->config.naluPrefix)
+    {
+        pbOutputBuf[size++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 24) & 0xFF;
+        pbOutputBuf[size++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 16) & 0xFF;
+        pbOutputBuf[size++] = (ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE >> 8) & 0xFF;
+        pbOutputBuf[size++] = ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE & 0xFF;
+    }
+
+    // NAL unit header
+    pbOutputBuf[size++] = head[0];
+
+    // RBSP with emulation prevention
+    ret = ARSTREAM2_H264_EmulationPrevention(head + 1, headSize - 1, pbOutputBuf + size, outputBufSize - size, &zeroCount);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+    size += ret;
+    ret = ARSTREAM2_H264_EmulationPrevention(sliceTemplate->pRbspBuf + headSize, sliceTemplate->rbspSize - headSize, pbOutputBuf + size, outputBufSize - size, &zeroCount);
+    if (ret < 0)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
     }
+    size += ret;
 
+    *outputSize = size;
+
+    return ARSTREAM2_OK;
+}
+
+
+static eARSTREAM2_ERROR ARSTREAM2_H264Writer_SetConcealmentSliceContext(ARSTREAM2_H264Writer_t* writer, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE type)
+{
     if (!writer->isSpsPpsContextValid)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
@@ -1745,7 +2514,14 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_H
         memcpy(&writer->sliceContext, sliceContext, sizeof(ARSTREAM2_H264_SliceContext_t));
         writer->sliceContext.first_mb_in_slice = firstMbInSlice;
         writer->sliceContext.sliceMbCount = sliceMbCount;
-        writer->sliceContext.slice_type = (writer->sliceContext.slice_type >= 5) ? ARSTREAM2_H264_SLICE_TYPE_I_ALL : ARSTREAM2_H264_SLICE_TYPE_I;
+        if (type == ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I)
+        {
+            writer->sliceContext.slice_type = (writer->sliceContext.slice_type >= 5) ? ARSTREAM2_H264_SLICE_TYPE_I_ALL : ARSTREAM2_H264_SLICE_TYPE_I;
+        }
+        else
+        {
+            writer->sliceContext.slice_type = (writer->sliceContext.slice_type >= 5) ? ARSTREAM2_H264_SLICE_TYPE_P_ALL : ARSTREAM2_H264_SLICE_TYPE_P;
+        }
         writer->sliceContext.sliceTypeMod5 = writer->sliceContext.slice_type % 5;
         writer->sliceContext.redundant_pic_cnt = 0;
         writer->sliceContext.direct_spatial_mv_pred_flag = 0;
@@ -1760,80 +2536,192 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_H
         return ARSTREAM2_ERROR_UNSUPPORTED;
     }
 
-    writer->pNaluBuf = pbOutputBuf;
-    writer->naluBufSize = outputBufSize;
-    writer->naluSize = 0;
+    return ARSTREAM2_OK;
+}
 
-    // Reset the bitstream cache
-    writer->cache = 0;
-    writer->cacheLength = 0;
-    writer->oldZeroCount = 0;
 
-    // NALU start code
-    if (writer->config.naluPrefix)
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSkippedPSliceNalu(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate;
+    eARSTREAM2_ERROR err;
+
+    if ((!writerHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
     {
-        ret = writeBits(writer, 32, ARSTREAM2_H264_BYTE_STREAM_NALU_START_CODE, 0);
-        if (ret < 0)
-        {
-            return ARSTREAM2_ERROR_INVALID_STATE;
-        }
-        bitsWritten += ret;
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-    // forbidden_zero_bit
-    // nal_ref_idc
-    // nal_unit_type
-    ret = writeBits(writer, 8, ((writer->sliceContext.nal_ref_idc & 3) << 5) | writer->sliceContext.nal_unit_type, 0);
-    if (ret < 0)
+    err = ARSTREAM2_H264Writer_SetConcealmentSliceContext(writer, firstMbInSlice, sliceMbCount, sliceContext, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_SKIPPED_P);
+    if (err != ARSTREAM2_OK)
     {
-        return ARSTREAM2_ERROR_INVALID_STATE;
+        return err;
     }
-    bitsWritten += ret;
 
-    // slice_header
-    ret = ARSTREAM2_H264Writer_WriteSliceHeader(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
-    if (ret < 0)
+    sliceTemplate = ARSTREAM2_H264Writer_GetSliceTemplate(writer, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_SKIPPED_P);
+    if (!sliceTemplate)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
-    bitsWritten += ret;
 
-    // slice_data
-    ret = ARSTREAM2_H264Writer_WriteGrayISliceData(writer, &writer->sliceContext, &writer->spsContext, &writer->ppsContext);
-    if (ret < 0)
+    return ARSTREAM2_H264Writer_WriteSliceTemplateNalu(writer, sliceTemplate, writer->sliceContext.frame_num, writer->sliceContext.idr_pic_id,
+                                                       writer->sliceContext.pic_order_cnt_lsb, pbOutputBuf, outputBufSize, outputSize);
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceNalu(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate;
+    eARSTREAM2_ERROR err;
+
+    if ((!writerHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    err = ARSTREAM2_H264Writer_SetConcealmentSliceContext(writer, firstMbInSlice, sliceMbCount, sliceContext, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I);
+    if (err != ARSTREAM2_OK)
+    {
+        return err;
+    }
+
+    sliceTemplate = ARSTREAM2_H264Writer_GetSliceTemplate(writer, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I);
+    if (!sliceTemplate)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
-    bitsWritten += ret;
 
-    // rbsp_slice_trailing_bits
+    return ARSTREAM2_H264Writer_WriteSliceTemplateNalu(writer, sliceTemplate, writer->sliceContext.frame_num, writer->sliceContext.idr_pic_id,
+                                                       writer->sliceContext.pic_order_cnt_lsb, pbOutputBuf, outputBufSize, outputSize);
+}
 
-    // rbsp_trailing_bits
-    ret = writeBits(writer, 1, 1, 1);
-    if (ret < 0)
+
+static eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSliceTemplate(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, eARSTREAM2_H264_WRITER_SLICE_TEMPLATE_TYPE type, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    ARSTREAM2_H264Writer_SliceTemplate_t *sliceTemplate;
+    eARSTREAM2_ERROR err;
+    uint32_t header[ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE / 4];
+
+    if ((!writerHandle) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    err = ARSTREAM2_H264Writer_SetConcealmentSliceContext(writer, firstMbInSlice, sliceMbCount, sliceContext, type);
+    if (err != ARSTREAM2_OK)
+    {
+        return err;
+    }
+
+    sliceTemplate = ARSTREAM2_H264Writer_GetSliceTemplate(writer, type);
+    if (!sliceTemplate)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
-    bitsWritten += ret;
 
-    ret = bitstreamByteAlign(writer, 1);
-    if (ret < 0)
+    if (outputBufSize < ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE + sliceTemplate->rbspSize)
     {
         return ARSTREAM2_ERROR_INVALID_STATE;
     }
-    bitsWritten += ret;
 
-    //TODO: cabac_zero_word
+    // Header of big-endian 32-bit words, then the NAL unit header and RBSP
+    header[0] = htonl(ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_MAGIC);
+    header[1] = htonl(ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_VERSION);
+    header[2] = htonl(sliceTemplate->rbspSize);
+    header[3] = htonl((uint32_t)sliceTemplate->frameNumOffset);
+    header[4] = htonl(sliceTemplate->frameNumLength);
+    header[5] = htonl((uint32_t)sliceTemplate->idrPicIdOffset);
+    header[6] = htonl(sliceTemplate->idrPicIdLength);
+    header[7] = htonl((uint32_t)sliceTemplate->pocLsbOffset);
+    header[8] = htonl(sliceTemplate->pocLsbLength);
+    memcpy(pbOutputBuf, header, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE);
+    memcpy(pbOutputBuf + ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE, sliceTemplate->pRbspBuf, sliceTemplate->rbspSize);
 
-    *outputSize = writer->naluSize;
+    *outputSize = ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE + sliceTemplate->rbspSize;
 
     return ARSTREAM2_OK;
 }
 
 
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteGrayISliceTemplate(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    return ARSTREAM2_H264Writer_WriteSliceTemplate(writerHandle, firstMbInSlice, sliceMbCount, sliceContext, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_GRAY_I, pbOutputBuf, outputBufSize, outputSize);
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSkippedPSliceTemplate(ARSTREAM2_H264Writer_Handle writerHandle, unsigned int firstMbInSlice, unsigned int sliceMbCount, void *sliceContext, uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    return ARSTREAM2_H264Writer_WriteSliceTemplate(writerHandle, firstMbInSlice, sliceMbCount, sliceContext, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_SKIPPED_P, pbOutputBuf, outputBufSize, outputSize);
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_H264Writer_WriteSliceNaluFromTemplate(ARSTREAM2_H264Writer_Handle writerHandle, const uint8_t *pbTemplate, unsigned int templateSize,
+                                                                unsigned int frameNum, unsigned int idrPicId, unsigned int picOrderCntLsb,
+                                                                uint8_t *pbOutputBuf, unsigned int outputBufSize, unsigned int *outputSize)
+{
+    ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    ARSTREAM2_H264Writer_SliceTemplate_t sliceTemplate;
+    uint32_t header[ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE / 4];
+    unsigned int maxBits;
+
+    if ((!writerHandle) || (!pbTemplate) || (!pbOutputBuf) || (outputBufSize == 0) || (!outputSize))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (templateSize <= ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    memcpy(header, pbTemplate, ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE);
+    if ((ntohl(header[0]) != ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_MAGIC) || (ntohl(header[1]) != ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_VERSION))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Invalid slice template");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    memset(&sliceTemplate, 0, sizeof(sliceTemplate));
+    sliceTemplate.rbspSize = ntohl(header[2]);
+    sliceTemplate.frameNumOffset = (int)ntohl(header[3]);
+    sliceTemplate.frameNumLength = ntohl(header[4]);
+    sliceTemplate.idrPicIdOffset = (int)ntohl(header[5]);
+    sliceTemplate.idrPicIdLength = ntohl(header[6]);
+    sliceTemplate.pocLsbOffset = (int)ntohl(header[7]);
+    sliceTemplate.pocLsbLength = ntohl(header[8]);
+    sliceTemplate.pRbspBuf = (uint8_t*)pbTemplate + ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE;
+
+    // The patched fields must lie in the slice header
+    maxBits = ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_HEADER_MAX_SIZE * 8;
+    if (sliceTemplate.rbspSize * 8 < maxBits)
+    {
+        maxBits = sliceTemplate.rbspSize * 8;
+    }
+    if ((sliceTemplate.rbspSize != templateSize - ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_FILE_HEADER_SIZE)
+            || (sliceTemplate.frameNumOffset < 8) || (sliceTemplate.frameNumLength > 16)
+            || ((unsigned int)sliceTemplate.frameNumOffset + sliceTemplate.frameNumLength > maxBits)
+            || ((sliceTemplate.idrPicIdOffset >= 0) && ((sliceTemplate.idrPicIdLength > 31) || ((unsigned int)sliceTemplate.idrPicIdOffset + sliceTemplate.idrPicIdLength > maxBits)))
+            || ((sliceTemplate.pocLsbOffset >= 0) && ((sliceTemplate.pocLsbLength > 16) || ((unsigned int)sliceTemplate.pocLsbOffset + sliceTemplate.pocLsbLength > maxBits))))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Invalid slice template");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((sliceTemplate.idrPicIdOffset >= 0) && (expGolombLength_ue(idrPicId) != sliceTemplate.idrPicIdLength))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_H264_WRITER_TAG, "Unsupported idr_pic_id value %d for the slice template", idrPicId);
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    return ARSTREAM2_H264Writer_WriteSliceTemplateNalu(writer, &sliceTemplate, frameNum, idrPicId, picOrderCntLsb, pbOutputBuf, outputBufSize, outputSize);
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_H264Writer_SetSpsPpsContext(ARSTREAM2_H264Writer_Handle writerHandle, const void *spsContext, const void *ppsContext)
 {
     ARSTREAM2_H264Writer_t *writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    int i;
 
     if ((!writerHandle) || (!spsContext) || (!ppsContext))
     {
@@ -1844,6 +2732,12 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_SetSpsPpsContext(ARSTREAM2_H264Writer_Hand
     memcpy(&writer->ppsContext, ppsContext, sizeof(ARSTREAM2_H264_PpsContext_t));
     writer->isSpsPpsContextValid = 1;
 
+    // The slice templates depend on the SPS and PPS
+    for (i = 0; i < ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT; i++)
+    {
+        writer->sliceTemplate[i].valid = 0;
+    }
+
     return ARSTREAM2_OK;
 }
 
@@ -1878,12 +2772,19 @@ eARSTREAM2_ERROR ARSTREAM2_H264Writer_Init(ARSTREAM2_H264Writer_Handle* writerHa
 eARSTREAM2_ERROR ARSTREAM2_H264Writer_Free(ARSTREAM2_H264Writer_Handle writerHandle)
 {
     ARSTREAM2_H264Writer_t* writer = (ARSTREAM2_H264Writer_t*)writerHandle;
+    int i;
 
     if (!writerHandle)
     {
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
+    for (i = 0; i < ARSTREAM2_H264_WRITER_SLICE_TEMPLATE_COUNT; i++)
+    {
+        free(writer->sliceTemplate[i].pRbspBuf);
+    }
+    free(writer->pRbspBuf);
+
     free(writer);
 
     return ARSTREAM2_OK;
@@ -0,0 +1,875 @@
+/**
+ * @file arstream2_mp4_writer.c
+ * @brief Parrot Streaming Library - Fragmented MP4 Writer
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "arstream2_mp4_writer.h"
+
+
+#define ARSTREAM2_MP4_WRITER_TAG "ARSTREAM2_Mp4Writer"
+
+#define ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID (1)
+#define ARSTREAM2_MP4_WRITER_METADATA_TRACK_ID (2)
+
+/* seconds between 1904-01-01 and 1970-01-01 */
+#define ARSTREAM2_MP4_WRITER_MAC_TIME_OFFSET (2082844800ULL)
+
+/* 'und' packed ISO-639-2/T language code */
+#define ARSTREAM2_MP4_WRITER_LANGUAGE_UND (0x55C4)
+
+#define ARSTREAM2_MP4_WRITER_SAMPLE_FLAGS_SYNC (0x02000000)
+#define ARSTREAM2_MP4_WRITER_SAMPLE_FLAGS_NON_SYNC (0x01010000)
+
+#define ARSTREAM2_MP4_WRITER_TFHD_DEFAULT_BASE_IS_MOOF (0x020000)
+#define ARSTREAM2_MP4_WRITER_TRUN_DATA_OFFSET (0x000001)
+#define ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_DURATION (0x000100)
+#define ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_SIZE (0x000200)
+#define ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_FLAGS (0x000400)
+
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+
+/**
+ * @brief Box serialization buffer.
+ */
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t offset;
+    int overflow;
+
+} ARSTREAM2_Mp4Writer_Buffer_t;
+
+
+static void ARSTREAM2_Mp4Writer_PutBytes(ARSTREAM2_Mp4Writer_Buffer_t *buf, const void *data, size_t size)
+{
+    if (buf->offset + size > buf->size)
+    {
+        buf->overflow = 1;
+        return;
+    }
+    if (data)
+    {
+        memcpy(buf->data + buf->offset, data, size);
+    }
+    else
+    {
+        memset(buf->data + buf->offset, 0, size);
+    }
+    buf->offset += size;
+}
+
+
+static void ARSTREAM2_Mp4Writer_Put8(ARSTREAM2_Mp4Writer_Buffer_t *buf, uint8_t val)
+{
+    ARSTREAM2_Mp4Writer_PutBytes(buf, &val, 1);
+}
+
+
+static void ARSTREAM2_Mp4Writer_Put16(ARSTREAM2_Mp4Writer_Buffer_t *buf, uint16_t val)
+{
+    uint8_t b[2] = { (uint8_t)(val >> 8), (uint8_t)val };
+    ARSTREAM2_Mp4Writer_PutBytes(buf, b, 2);
+}
+
+
+static void ARSTREAM2_Mp4Writer_Put32(ARSTREAM2_Mp4Writer_Buffer_t *buf, uint32_t val)
+{
+    uint8_t b[4] = { (uint8_t)(val >> 24), (uint8_t)(val >> 16), (uint8_t)(val >> 8), (uint8_t)val };
+    ARSTREAM2_Mp4Writer_PutBytes(buf, b, 4);
+}
+
+
+static void ARSTREAM2_Mp4Writer_Put64(ARSTREAM2_Mp4Writer_Buffer_t *buf, uint64_t val)
+{
+    ARSTREAM2_Mp4Writer_Put32(buf, (uint32_t)(val >> 32));
+    ARSTREAM2_Mp4Writer_Put32(buf, (uint32_t)val);
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutString(ARSTREAM2_Mp4Writer_Buffer_t *buf, const char *str)
+{
+    /* null-terminated */
+    ARSTREAM2_Mp4Writer_PutBytes(buf, str, strlen(str) + 1);
+}
+
+
+static size_t ARSTREAM2_Mp4Writer_BoxStart(ARSTREAM2_Mp4Writer_Buffer_t *buf, const char *type)
+{
+    size_t start = buf->offset;
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_PutBytes(buf, type, 4);
+    return start;
+}
+
+
+static size_t ARSTREAM2_Mp4Writer_FullBoxStart(ARSTREAM2_Mp4Writer_Buffer_t *buf, const char *type, uint8_t version, uint32_t flags)
+{
+    size_t start = ARSTREAM2_Mp4Writer_BoxStart(buf, type);
+    ARSTREAM2_Mp4Writer_Put32(buf, ((uint32_t)version << 24) | (flags & 0xFFFFFF));
+    return start;
+}
+
+
+static void ARSTREAM2_Mp4Writer_BoxEnd(ARSTREAM2_Mp4Writer_Buffer_t *buf, size_t start)
+{
+    if (!buf->overflow)
+    {
+        uint32_t size = (uint32_t)(buf->offset - start);
+        buf->data[start] = (uint8_t)(size >> 24);
+        buf->data[start + 1] = (uint8_t)(size >> 16);
+        buf->data[start + 2] = (uint8_t)(size >> 8);
+        buf->data[start + 3] = (uint8_t)size;
+    }
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutMatrix(ARSTREAM2_Mp4Writer_Buffer_t *buf)
+{
+    ARSTREAM2_Mp4Writer_Put32(buf, 0x00010000);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0x00010000);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0x40000000);
+}
+
+
+static unsigned int ARSTREAM2_Mp4Writer_StartCodeLength(const uint8_t *data, unsigned int size)
+{
+    if ((size >= 4) && (data[0] == 0) && (data[1] == 0) && (data[2] == 0) && (data[3] == 1))
+    {
+        return 4;
+    }
+    else if ((size >= 3) && (data[0] == 0) && (data[1] == 0) && (data[2] == 1))
+    {
+        return 3;
+    }
+    return 0;
+}
+
+
+static int ARSTREAM2_Mp4Writer_SetParameterSet(uint8_t **dst, uint32_t *dstSize, const uint8_t *src, uint32_t srcSize)
+{
+    unsigned int startCodeLength = ARSTREAM2_Mp4Writer_StartCodeLength(src, srcSize);
+    uint8_t *data;
+
+    src += startCodeLength;
+    srcSize -= startCodeLength;
+    if ((srcSize == 0) || (srcSize > 0xFFFF))
+    {
+        return -1;
+    }
+    if ((*dst) && (*dstSize == srcSize) && (memcmp(*dst, src, srcSize) == 0))
+    {
+        return 0;
+    }
+    data = realloc(*dst, srcSize);
+    if (!data)
+    {
+        return -1;
+    }
+    memcpy(data, src, srcSize);
+    *dst = data;
+    *dstSize = srcSize;
+
+    return 0;
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutTrackHeader(ARSTREAM2_Mp4Writer_Buffer_t *buf, uint32_t trackId, uint32_t flags, uint32_t width, uint32_t height, uint32_t creationTime)
+{
+    size_t tkhd = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "tkhd", 0, flags);
+    ARSTREAM2_Mp4Writer_Put32(buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(buf, trackId);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0); /* reserved */
+    ARSTREAM2_Mp4Writer_Put32(buf, 0); /* duration */
+    ARSTREAM2_Mp4Writer_PutBytes(buf, NULL, 8); /* reserved */
+    ARSTREAM2_Mp4Writer_Put16(buf, 0); /* layer */
+    ARSTREAM2_Mp4Writer_Put16(buf, 0); /* alternate_group */
+    ARSTREAM2_Mp4Writer_Put16(buf, 0); /* volume */
+    ARSTREAM2_Mp4Writer_Put16(buf, 0); /* reserved */
+    ARSTREAM2_Mp4Writer_PutMatrix(buf);
+    ARSTREAM2_Mp4Writer_Put32(buf, width << 16);
+    ARSTREAM2_Mp4Writer_Put32(buf, height << 16);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, tkhd);
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutMediaHeader(ARSTREAM2_Mp4Writer_Buffer_t *buf, const char *handlerType, const char *handlerName, uint32_t creationTime)
+{
+    size_t mdhd = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "mdhd", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(buf, ARSTREAM2_MP4_WRITER_TIMESCALE);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0); /* duration */
+    ARSTREAM2_Mp4Writer_Put16(buf, ARSTREAM2_MP4_WRITER_LANGUAGE_UND);
+    ARSTREAM2_Mp4Writer_Put16(buf, 0);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, mdhd);
+
+    size_t hdlr = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "hdlr", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_PutBytes(buf, handlerType, 4);
+    ARSTREAM2_Mp4Writer_PutBytes(buf, NULL, 12); /* reserved */
+    ARSTREAM2_Mp4Writer_PutString(buf, handlerName);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, hdlr);
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutDataInformation(ARSTREAM2_Mp4Writer_Buffer_t *buf)
+{
+    size_t dinf = ARSTREAM2_Mp4Writer_BoxStart(buf, "dinf");
+    size_t dref = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "dref", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 1);
+    size_t url = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "url ", 0, 1); /* self-contained */
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, url);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, dref);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, dinf);
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutEmptySampleTables(ARSTREAM2_Mp4Writer_Buffer_t *buf)
+{
+    /* the samples are described in the fragments */
+    size_t box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "stts", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "stsc", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "stsz", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "stco", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+}
+
+
+static int ARSTREAM2_Mp4Writer_WriteHeader(ARSTREAM2_Mp4Writer_t *writer)
+{
+    ARSTREAM2_Mp4Writer_Buffer_t buf;
+    uint32_t creationTime = (uint32_t)((uint64_t)time(NULL) + ARSTREAM2_MP4_WRITER_MAC_TIME_OFFSET);
+    size_t moov, trak, mdia, minf, stbl, stsd, box;
+    int i, ret = 0;
+
+    memset(&buf, 0, sizeof(buf));
+    buf.size = 2048 + writer->spsSize + writer->ppsSize;
+    for (i = 0; i < writer->userDataCount; i++)
+    {
+        buf.size += 12 + strlen(writer->userData[i].value);
+    }
+    if (writer->hasMetadataTrack)
+    {
+        buf.size += strlen(writer->metadataContentEncoding) + strlen(writer->metadataMimeFormat);
+    }
+    buf.data = malloc(buf.size);
+    if (!buf.data)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Allocation failed (size %zu)", buf.size);
+        return -1;
+    }
+
+    box = ARSTREAM2_Mp4Writer_BoxStart(&buf, "ftyp");
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, "isom", 4);
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0x200);
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, "isomiso5iso6avc1mp41", 20);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+
+    moov = ARSTREAM2_Mp4Writer_BoxStart(&buf, "moov");
+
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "mvhd", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(&buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(&buf, creationTime);
+    ARSTREAM2_Mp4Writer_Put32(&buf, ARSTREAM2_MP4_WRITER_TIMESCALE);
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0); /* duration */
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0x00010000); /* rate */
+    ARSTREAM2_Mp4Writer_Put16(&buf, 0x0100); /* volume */
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 10); /* reserved */
+    ARSTREAM2_Mp4Writer_PutMatrix(&buf);
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 24); /* pre_defined */
+    ARSTREAM2_Mp4Writer_Put32(&buf, (writer->hasMetadataTrack) ? ARSTREAM2_MP4_WRITER_METADATA_TRACK_ID + 1 : ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID + 1);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+
+    /* video track */
+    trak = ARSTREAM2_Mp4Writer_BoxStart(&buf, "trak");
+    ARSTREAM2_Mp4Writer_PutTrackHeader(&buf, ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID, 0x3, writer->videoWidth, writer->videoHeight, creationTime);
+    mdia = ARSTREAM2_Mp4Writer_BoxStart(&buf, "mdia");
+    ARSTREAM2_Mp4Writer_PutMediaHeader(&buf, "vide", "VideoHandler", creationTime);
+    minf = ARSTREAM2_Mp4Writer_BoxStart(&buf, "minf");
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "vmhd", 0, 1);
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 8); /* graphicsmode and opcolor */
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+    ARSTREAM2_Mp4Writer_PutDataInformation(&buf);
+    stbl = ARSTREAM2_Mp4Writer_BoxStart(&buf, "stbl");
+    stsd = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "stsd", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(&buf, 1);
+    size_t avc1 = ARSTREAM2_Mp4Writer_BoxStart(&buf, "avc1");
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 6); /* reserved */
+    ARSTREAM2_Mp4Writer_Put16(&buf, 1); /* data_reference_index */
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 16); /* pre_defined and reserved */
+    ARSTREAM2_Mp4Writer_Put16(&buf, (uint16_t)writer->videoWidth);
+    ARSTREAM2_Mp4Writer_Put16(&buf, (uint16_t)writer->videoHeight);
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0x00480000); /* 72 dpi */
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0x00480000);
+    ARSTREAM2_Mp4Writer_Put32(&buf, 0); /* reserved */
+    ARSTREAM2_Mp4Writer_Put16(&buf, 1); /* frame_count */
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 32); /* compressorname */
+    ARSTREAM2_Mp4Writer_Put16(&buf, 0x0018); /* depth */
+    ARSTREAM2_Mp4Writer_Put16(&buf, 0xFFFF); /* pre_defined */
+    box = ARSTREAM2_Mp4Writer_BoxStart(&buf, "avcC");
+    ARSTREAM2_Mp4Writer_Put8(&buf, 1); /* configurationVersion */
+    ARSTREAM2_Mp4Writer_Put8(&buf, (writer->spsSize > 1) ? writer->sps[1] : 0); /* AVCProfileIndication */
+    ARSTREAM2_Mp4Writer_Put8(&buf, (writer->spsSize > 2) ? writer->sps[2] : 0); /* profile_compatibility */
+    ARSTREAM2_Mp4Writer_Put8(&buf, (writer->spsSize > 3) ? writer->sps[3] : 0); /* AVCLevelIndication */
+    ARSTREAM2_Mp4Writer_Put8(&buf, 0xFF); /* 4 bytes NAL unit length */
+    ARSTREAM2_Mp4Writer_Put8(&buf, 0xE1); /* 1 SPS */
+    ARSTREAM2_Mp4Writer_Put16(&buf, (uint16_t)writer->spsSize);
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, writer->sps, writer->spsSize);
+    ARSTREAM2_Mp4Writer_Put8(&buf, 1); /* 1 PPS */
+    ARSTREAM2_Mp4Writer_Put16(&buf, (uint16_t)writer->ppsSize);
+    ARSTREAM2_Mp4Writer_PutBytes(&buf, writer->pps, writer->ppsSize);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, avc1);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, stsd);
+    ARSTREAM2_Mp4Writer_PutEmptySampleTables(&buf);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, stbl);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, minf);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, mdia);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, trak);
+
+    /* timed metadata track */
+    if (writer->hasMetadataTrack)
+    {
+        trak = ARSTREAM2_Mp4Writer_BoxStart(&buf, "trak");
+        ARSTREAM2_Mp4Writer_PutTrackHeader(&buf, ARSTREAM2_MP4_WRITER_METADATA_TRACK_ID, 0x1, 0, 0, creationTime);
+        box = ARSTREAM2_Mp4Writer_BoxStart(&buf, "tref");
+        size_t cdsc = ARSTREAM2_Mp4Writer_BoxStart(&buf, "cdsc");
+        ARSTREAM2_Mp4Writer_Put32(&buf, ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, cdsc);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+        mdia = ARSTREAM2_Mp4Writer_BoxStart(&buf, "mdia");
+        ARSTREAM2_Mp4Writer_PutMediaHeader(&buf, "meta", "TimedMetadata", creationTime);
+        minf = ARSTREAM2_Mp4Writer_BoxStart(&buf, "minf");
+        box = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "nmhd", 0, 0);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+        ARSTREAM2_Mp4Writer_PutDataInformation(&buf);
+        stbl = ARSTREAM2_Mp4Writer_BoxStart(&buf, "stbl");
+        stsd = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "stsd", 0, 0);
+        ARSTREAM2_Mp4Writer_Put32(&buf, 1);
+        box = ARSTREAM2_Mp4Writer_BoxStart(&buf, "mett");
+        ARSTREAM2_Mp4Writer_PutBytes(&buf, NULL, 6); /* reserved */
+        ARSTREAM2_Mp4Writer_Put16(&buf, 1); /* data_reference_index */
+        ARSTREAM2_Mp4Writer_PutString(&buf, writer->metadataContentEncoding);
+        ARSTREAM2_Mp4Writer_PutString(&buf, writer->metadataMimeFormat);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, stsd);
+        ARSTREAM2_Mp4Writer_PutEmptySampleTables(&buf);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, stbl);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, minf);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, mdia);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, trak);
+    }
+
+    /* untimed metadata */
+    if (writer->userDataCount > 0)
+    {
+        size_t udta = ARSTREAM2_Mp4Writer_BoxStart(&buf, "udta");
+        for (i = 0; i < writer->userDataCount; i++)
+        {
+            uint8_t type[4] = { (uint8_t)(writer->userData[i].type >> 24), (uint8_t)(writer->userData[i].type >> 16),
+                                (uint8_t)(writer->userData[i].type >> 8), (uint8_t)writer->userData[i].type };
+            size_t len = strlen(writer->userData[i].value);
+            size_t start = buf.offset;
+            ARSTREAM2_Mp4Writer_Put32(&buf, 0);
+            ARSTREAM2_Mp4Writer_PutBytes(&buf, type, 4);
+            ARSTREAM2_Mp4Writer_Put16(&buf, (uint16_t)len);
+            ARSTREAM2_Mp4Writer_Put16(&buf, ARSTREAM2_MP4_WRITER_LANGUAGE_UND);
+            ARSTREAM2_Mp4Writer_PutBytes(&buf, writer->userData[i].value, len);
+            ARSTREAM2_Mp4Writer_BoxEnd(&buf, start);
+        }
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, udta);
+    }
+
+    /* fragments */
+    size_t mvex = ARSTREAM2_Mp4Writer_BoxStart(&buf, "mvex");
+    for (i = ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID; i <= ((writer->hasMetadataTrack) ? ARSTREAM2_MP4_WRITER_METADATA_TRACK_ID : ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID); i++)
+    {
+        box = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "trex", 0, 0);
+        ARSTREAM2_Mp4Writer_Put32(&buf, (uint32_t)i);
+        ARSTREAM2_Mp4Writer_Put32(&buf, 1); /* default_sample_description_index */
+        ARSTREAM2_Mp4Writer_Put32(&buf, 0);
+        ARSTREAM2_Mp4Writer_Put32(&buf, 0);
+        ARSTREAM2_Mp4Writer_Put32(&buf, 0);
+        ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+    }
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, mvex);
+
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, moov);
+
+    if (buf.overflow)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Header buffer overflow");
+        ret = -1;
+    }
+    else if (ARSTREAM2_FileWriter_Write(writer->fileWriter, buf.data, buf.offset) != 0)
+    {
+        ret = -1;
+    }
+    writer->headerWritten = 1;
+
+    free(buf.data);
+    return ret;
+}
+
+
+static uint32_t ARSTREAM2_Mp4Writer_SampleDuration(ARSTREAM2_Mp4Writer_t *writer, const ARSTREAM2_Mp4Writer_Sample_t *sample, const ARSTREAM2_Mp4Writer_Sample_t *next, uint64_t endTime)
+{
+    uint64_t nextTime = (next) ? next->time : endTime;
+
+    if (nextTime > sample->time)
+    {
+        uint64_t duration = nextTime - sample->time;
+        return (duration > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)duration;
+    }
+    return (writer->lastSampleDuration) ? (uint32_t)writer->lastSampleDuration : writer->defaultSampleDuration;
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutTrackFragment(ARSTREAM2_Mp4Writer_t *writer, ARSTREAM2_Mp4Writer_Buffer_t *buf, uint32_t trackId,
+                                                 const ARSTREAM2_Mp4Writer_Sample_t *sample, int sampleCount, int withFlags,
+                                                 uint64_t endTime, size_t *dataOffsetPos)
+{
+    size_t traf, box;
+    int i;
+
+    traf = ARSTREAM2_Mp4Writer_BoxStart(buf, "traf");
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "tfhd", 0, ARSTREAM2_MP4_WRITER_TFHD_DEFAULT_BASE_IS_MOOF);
+    ARSTREAM2_Mp4Writer_Put32(buf, trackId);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "tfdt", 1, 0);
+    ARSTREAM2_Mp4Writer_Put64(buf, sample[0].time);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(buf, "trun", 0, ARSTREAM2_MP4_WRITER_TRUN_DATA_OFFSET | ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_DURATION
+                                           | ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_SIZE | ((withFlags) ? ARSTREAM2_MP4_WRITER_TRUN_SAMPLE_FLAGS : 0));
+    ARSTREAM2_Mp4Writer_Put32(buf, (uint32_t)sampleCount);
+    *dataOffsetPos = buf->offset;
+    ARSTREAM2_Mp4Writer_Put32(buf, 0);
+    for (i = 0; i < sampleCount; i++)
+    {
+        ARSTREAM2_Mp4Writer_Put32(buf, ARSTREAM2_Mp4Writer_SampleDuration(writer, &sample[i], (i + 1 < sampleCount) ? &sample[i + 1] : NULL, endTime));
+        ARSTREAM2_Mp4Writer_Put32(buf, sample[i].size);
+        if (withFlags)
+        {
+            ARSTREAM2_Mp4Writer_Put32(buf, (sample[i].isSync) ? ARSTREAM2_MP4_WRITER_SAMPLE_FLAGS_SYNC : ARSTREAM2_MP4_WRITER_SAMPLE_FLAGS_NON_SYNC);
+        }
+    }
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, box);
+    ARSTREAM2_Mp4Writer_BoxEnd(buf, traf);
+}
+
+
+static void ARSTREAM2_Mp4Writer_PatchU32(ARSTREAM2_Mp4Writer_Buffer_t *buf, size_t pos, uint32_t val)
+{
+    buf->data[pos] = (uint8_t)(val >> 24);
+    buf->data[pos + 1] = (uint8_t)(val >> 16);
+    buf->data[pos + 2] = (uint8_t)(val >> 8);
+    buf->data[pos + 3] = (uint8_t)val;
+}
+
+
+/* endTime is the time of the sample following the fragment */
+static int ARSTREAM2_Mp4Writer_WriteFragment(ARSTREAM2_Mp4Writer_t *writer, uint64_t endTime)
+{
+    ARSTREAM2_Mp4Writer_Buffer_t buf;
+    size_t moof, box, videoDataOffsetPos = 0, metadataDataOffsetPos = 0;
+    uint8_t mdatHeader[8];
+    uint32_t mdatSize;
+    int ret = 0;
+
+    if (writer->videoSampleCount == 0)
+    {
+        return 0;
+    }
+
+    memset(&buf, 0, sizeof(buf));
+    buf.data = writer->moofBuffer;
+    buf.size = writer->moofBufferSize;
+
+    moof = ARSTREAM2_Mp4Writer_BoxStart(&buf, "moof");
+    box = ARSTREAM2_Mp4Writer_FullBoxStart(&buf, "mfhd", 0, 0);
+    ARSTREAM2_Mp4Writer_Put32(&buf, ++writer->sequenceNumber);
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, box);
+    ARSTREAM2_Mp4Writer_PutTrackFragment(writer, &buf, ARSTREAM2_MP4_WRITER_VIDEO_TRACK_ID, writer->videoSample, writer->videoSampleCount, 1, endTime, &videoDataOffsetPos);
+    if (writer->metadataSampleCount > 0)
+    {
+        ARSTREAM2_Mp4Writer_PutTrackFragment(writer, &buf, ARSTREAM2_MP4_WRITER_METADATA_TRACK_ID, writer->metadataSample, writer->metadataSampleCount, 0, endTime, &metadataDataOffsetPos);
+    }
+    ARSTREAM2_Mp4Writer_BoxEnd(&buf, moof);
+
+    if (buf.overflow)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Fragment header buffer overflow");
+        ret = -1;
+    }
+    else
+    {
+        /* the sample data offsets are relative to the start of the 'moof' box */
+        ARSTREAM2_Mp4Writer_PatchU32(&buf, videoDataOffsetPos, (uint32_t)buf.offset + 8);
+        if (writer->metadataSampleCount > 0)
+        {
+            ARSTREAM2_Mp4Writer_PatchU32(&buf, metadataDataOffsetPos, (uint32_t)buf.offset + 8 + writer->videoDataSize);
+        }
+        mdatSize = 8 + writer->videoDataSize + writer->metadataDataSize;
+        mdatHeader[0] = (uint8_t)(mdatSize >> 24);
+        mdatHeader[1] = (uint8_t)(mdatSize >> 16);
+        mdatHeader[2] = (uint8_t)(mdatSize >> 8);
+        mdatHeader[3] = (uint8_t)mdatSize;
+        memcpy(mdatHeader + 4, "mdat", 4);
+
+        if ((ARSTREAM2_FileWriter_Write(writer->fileWriter, buf.data, buf.offset) != 0)
+                || (ARSTREAM2_FileWriter_Write(writer->fileWriter, mdatHeader, sizeof(mdatHeader)) != 0)
+                || (ARSTREAM2_FileWriter_Write(writer->fileWriter, writer->videoData, writer->videoDataSize) != 0)
+                || (ARSTREAM2_FileWriter_Write(writer->fileWriter, writer->metadataData, writer->metadataDataSize) != 0))
+        {
+            ret = -1;
+        }
+    }
+
+    writer->videoSampleCount = 0;
+    writer->videoDataSize = 0;
+    writer->metadataSampleCount = 0;
+    writer->metadataDataSize = 0;
+
+    return ret;
+}
+
+
+static void ARSTREAM2_Mp4Writer_PutNalu(ARSTREAM2_Mp4Writer_t *writer, const uint8_t *data, uint32_t size)
+{
+    uint8_t *p = writer->videoData + writer->videoDataSize;
+    p[0] = (uint8_t)(size >> 24);
+    p[1] = (uint8_t)(size >> 16);
+    p[2] = (uint8_t)(size >> 8);
+    p[3] = (uint8_t)size;
+    memcpy(p + 4, data, size);
+    writer->videoDataSize += 4 + size;
+}
+
+
+ARSTREAM2_Mp4Writer_t* ARSTREAM2_Mp4Writer_New(const ARSTREAM2_Mp4Writer_Config_t *config, eARSTREAM2_ERROR *error)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_Mp4Writer_t *writer = NULL;
+
+    /* ARGS Check */
+    if ((config == NULL) || (!config->sps) || (!config->spsSize) || (!config->pps) || (!config->ppsSize))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Invalid config");
+        SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+        return NULL;
+    }
+
+    /* Alloc new writer */
+    writer = (ARSTREAM2_Mp4Writer_t*)malloc(sizeof(ARSTREAM2_Mp4Writer_t));
+    if (writer == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Allocation failed (size %zu)", sizeof(ARSTREAM2_Mp4Writer_t));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(writer, 0, sizeof(ARSTREAM2_Mp4Writer_t));
+        writer->videoWidth = config->videoWidth;
+        writer->videoHeight = config->videoHeight;
+        writer->defaultSampleDuration = (config->videoFramerate > 0.) ? (uint32_t)(ARSTREAM2_MP4_WRITER_TIMESCALE / config->videoFramerate + 0.5) : ARSTREAM2_MP4_WRITER_TIMESCALE / 30;
+        writer->fragmentDuration = (uint64_t)((config->fragmentDurationMs > 0) ? config->fragmentDurationMs : ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_DURATION_MS) * ARSTREAM2_MP4_WRITER_TIMESCALE / 1000;
+        writer->fragmentMaxSize = (config->fragmentMaxSize > 0) ? (uint32_t)config->fragmentMaxSize : ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_MAX_SIZE;
+        writer->fragmentMaxSampleCount = (config->fragmentMaxSampleCount > 0) ? config->fragmentMaxSampleCount : ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_MAX_SAMPLE_COUNT;
+        if ((ARSTREAM2_Mp4Writer_SetParameterSet(&writer->sps, &writer->spsSize, config->sps, config->spsSize) != 0)
+                || (ARSTREAM2_Mp4Writer_SetParameterSet(&writer->pps, &writer->ppsSize, config->pps, config->ppsSize) != 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Invalid SPS or PPS");
+            ret = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* moof + mfhd + 2 * (traf + tfhd + tfdt + trun) + samples */
+        writer->moofBufferSize = 256 + writer->fragmentMaxSampleCount * 12 * 2;
+        writer->videoSample = malloc(writer->fragmentMaxSampleCount * sizeof(ARSTREAM2_Mp4Writer_Sample_t));
+        writer->metadataSample = malloc(writer->fragmentMaxSampleCount * sizeof(ARSTREAM2_Mp4Writer_Sample_t));
+        writer->videoData = malloc(writer->fragmentMaxSize);
+        writer->moofBuffer = malloc(writer->moofBufferSize);
+        if ((!writer->videoSample) || (!writer->metadataSample) || (!writer->videoData) || (!writer->moofBuffer))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Fragment buffers allocation failed");
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        writer->fileWriter = ARSTREAM2_FileWriter_New(&config->fileWriterConfig, &ret);
+    }
+
+    if ((ret != ARSTREAM2_OK) && (writer))
+    {
+        free(writer->sps);
+        free(writer->pps);
+        free(writer->videoSample);
+        free(writer->metadataSample);
+        free(writer->videoData);
+        free(writer->moofBuffer);
+        free(writer);
+        writer = NULL;
+    }
+
+    SET_WITH_CHECK(error, ret);
+    return writer;
+}
+
+
+int ARSTREAM2_Mp4Writer_SetMetadataTrack(ARSTREAM2_Mp4Writer_t *writer, const char *contentEncoding, const char *mimeFormat, uint32_t sampleMaxSize)
+{
+    if ((!writer) || (!contentEncoding) || (!mimeFormat) || (!sampleMaxSize))
+    {
+        return -1;
+    }
+    if ((writer->headerWritten) || (writer->hasMetadataTrack))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_MP4_WRITER_TAG, "The metadata track can only be declared once before the first sample");
+        return -1;
+    }
+
+    writer->metadataContentEncoding = strdup(contentEncoding);
+    writer->metadataMimeFormat = strdup(mimeFormat);
+    writer->metadataData = malloc(writer->fragmentMaxSampleCount * sampleMaxSize);
+    if ((!writer->metadataContentEncoding) || (!writer->metadataMimeFormat) || (!writer->metadataData))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Metadata track allocation failed");
+        free(writer->metadataContentEncoding);
+        writer->metadataContentEncoding = NULL;
+        free(writer->metadataMimeFormat);
+        writer->metadataMimeFormat = NULL;
+        free(writer->metadataData);
+        writer->metadataData = NULL;
+        return -1;
+    }
+    writer->metadataSampleMaxSize = sampleMaxSize;
+    writer->hasMetadataTrack = 1;
+
+    return 0;
+}
+
+
+int ARSTREAM2_Mp4Writer_AddUserData(ARSTREAM2_Mp4Writer_t *writer, uint32_t type, const char *value)
+{
+    if ((!writer) || (!value) || (strlen(value) > 0xFFFF))
+    {
+        return -1;
+    }
+    if ((writer->headerWritten) || (writer->userDataCount >= ARSTREAM2_MP4_WRITER_MAX_USER_DATA_COUNT))
+    {
+        return -1;
+    }
+
+    writer->userData[writer->userDataCount].value = strdup(value);
+    if (!writer->userData[writer->userDataCount].value)
+    {
+        return -1;
+    }
+    writer->userData[writer->userDataCount].type = type;
+    writer->userDataCount++;
+
+    return 0;
+}
+
+
+int ARSTREAM2_Mp4Writer_AddSample(ARSTREAM2_Mp4Writer_t *writer, const ARSTREAM2_H264_AccessUnit_t *au, const void *metadata, uint32_t metadataSize)
+{
+    ARSTREAM2_H264_NaluFifoItem_t *naluItem;
+    ARSTREAM2_Mp4Writer_Sample_t *sample;
+    uint32_t size = 0, paramSetsSize;
+    int hasSps = 0, hasPps = 0, isSync, ret = 0;
+    uint64_t time;
+
+    if ((!writer) || (!au))
+    {
+        return -1;
+    }
+
+    if ((!writer->headerWritten) && (ARSTREAM2_Mp4Writer_WriteHeader(writer) != 0))
+    {
+        return -1;
+    }
+
+    /* the RTP timestamps use the MP4 timescale */
+    if (!writer->firstTimestampSet)
+    {
+        writer->firstTimestamp = au->extRtpTimestamp;
+        writer->firstTimestampSet = 1;
+    }
+    time = (au->extRtpTimestamp > writer->firstTimestamp) ? au->extRtpTimestamp - writer->firstTimestamp : 0;
+    if (time < writer->lastSampleTime)
+    {
+        time = writer->lastSampleTime;
+    }
+    isSync = (au->syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE) ? 1 : 0;
+
+    for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
+    {
+        unsigned int startCodeLength = ARSTREAM2_Mp4Writer_StartCodeLength(naluItem->nalu.nalu, naluItem->nalu.naluSize);
+        if (naluItem->nalu.naluSize > startCodeLength)
+        {
+            uint8_t naluType = naluItem->nalu.nalu[startCodeLength] & 0x1F;
+            if (naluType == 7)
+            {
+                hasSps = 1;
+                ARSTREAM2_Mp4Writer_SetParameterSet(&writer->sps, &writer->spsSize, naluItem->nalu.nalu, naluItem->nalu.naluSize);
+            }
+            else if (naluType == 8)
+            {
+                hasPps = 1;
+                ARSTREAM2_Mp4Writer_SetParameterSet(&writer->pps, &writer->ppsSize, naluItem->nalu.nalu, naluItem->nalu.naluSize);
+            }
+            size += 4 + naluItem->nalu.naluSize - startCodeLength;
+        }
+    }
+    paramSetsSize = ((hasSps) && (hasPps)) ? 0 : 8 + writer->spsSize + writer->ppsSize;
+    if ((size == 0) || (size + paramSetsSize > writer->fragmentMaxSize))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_MP4_WRITER_TAG, "Invalid sample size (%u), sample dropped", size);
+        return -1;
+    }
+
+    /* start a new fragment on a sync sample once the target duration is
+     * reached, or when a fragment limit would be exceeded */
+    if (writer->videoSampleCount > 0)
+    {
+        uint64_t elapsed = time - writer->videoSample[0].time;
+        if (((isSync) && (elapsed >= writer->fragmentDuration))
+                || (elapsed >= 2 * writer->fragmentDuration)
+                || (writer->videoSampleCount >= writer->fragmentMaxSampleCount)
+                || (writer->videoDataSize + size > writer->fragmentMaxSize))
+        {
+            ret = ARSTREAM2_Mp4Writer_WriteFragment(writer, time);
+        }
+    }
+
+    if ((writer->videoSampleCount > 0) || (writer->sequenceNumber > 0))
+    {
+        writer->lastSampleDuration = time - writer->lastSampleTime;
+    }
+    writer->lastSampleTime = time;
+
+    /* all the fragments start with the parameter sets */
+    if ((writer->videoSampleCount == 0) && (paramSetsSize > 0))
+    {
+        ARSTREAM2_Mp4Writer_PutNalu(writer, writer->sps, writer->spsSize);
+        ARSTREAM2_Mp4Writer_PutNalu(writer, writer->pps, writer->ppsSize);
+        size += paramSetsSize;
+    }
+    for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
+    {
+        unsigned int startCodeLength = ARSTREAM2_Mp4Writer_StartCodeLength(naluItem->nalu.nalu, naluItem->nalu.naluSize);
+        if (naluItem->nalu.naluSize > startCodeLength)
+        {
+            ARSTREAM2_Mp4Writer_PutNalu(writer, naluItem->nalu.nalu + startCodeLength, naluItem->nalu.naluSize - startCodeLength);
+        }
+    }
+    sample = &writer->videoSample[writer->videoSampleCount++];
+    sample->time = time;
+    sample->size = size;
+    sample->isSync = (uint32_t)isSync;
+
+    if ((metadata) && (metadataSize > 0) && (writer->hasMetadataTrack) && (metadataSize <= writer->metadataSampleMaxSize))
+    {
+        memcpy(writer->metadataData + writer->metadataDataSize, metadata, metadataSize);
+        writer->metadataDataSize += metadataSize;
+        sample = &writer->metadataSample[writer->metadataSampleCount++];
+        sample->time = time;
+        sample->size = metadataSize;
+        sample->isSync = 1;
+    }
+
+    return ret;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_Mp4Writer_Delete(ARSTREAM2_Mp4Writer_t **writer)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK, err;
+    ARSTREAM2_Mp4Writer_t *w;
+    int i;
+
+    if ((!writer) || (!*writer))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    w = *writer;
+
+    if ((!w->headerWritten) && (ARSTREAM2_Mp4Writer_WriteHeader(w) != 0))
+    {
+        ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+    }
+    if ((w->videoSampleCount > 0)
+            && (ARSTREAM2_Mp4Writer_WriteFragment(w, w->lastSampleTime + ((w->lastSampleDuration) ? w->lastSampleDuration : w->defaultSampleDuration)) != 0))
+    {
+        ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+    }
+
+    err = ARSTREAM2_FileWriter_Delete(&w->fileWriter);
+    if (err != ARSTREAM2_OK)
+    {
+        ret = err;
+    }
+
+    for (i = 0; i < w->userDataCount; i++)
+    {
+        free(w->userData[i].value);
+    }
+    free(w->metadataContentEncoding);
+    free(w->metadataMimeFormat);
+    free(w->metadataData);
+    free(w->sps);
+    free(w->pps);
+    free(w->videoSample);
+    free(w->metadataSample);
+    free(w->videoData);
+    free(w->moofBuffer);
+    free(w);
+    *writer = NULL;
+
+    return ret;
+}
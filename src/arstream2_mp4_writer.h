@@ -0,0 +1,217 @@
+/**
+ * @file arstream2_mp4_writer.h
+ * @brief Parrot Streaming Library - Fragmented MP4 Writer
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_MP4_WRITER_H_
+#define _ARSTREAM2_MP4_WRITER_H_
+
+#include <config.h>
+
+#include <inttypes.h>
+
+#include <libARStream2/arstream2_error.h>
+#include "arstream2_h264.h"
+#include "arstream2_file_writer.h"
+
+
+/**
+ * Default target fragment duration in milliseconds
+ */
+#define ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_DURATION_MS (1000)
+
+
+/**
+ * Default maximum fragment video data size in bytes
+ */
+#define ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_MAX_SIZE (4 * 1024 * 1024)
+
+
+/**
+ * Default maximum number of samples per fragment
+ */
+#define ARSTREAM2_MP4_WRITER_DEFAULT_FRAGMENT_MAX_SAMPLE_COUNT (256)
+
+
+/**
+ * Maximum number of user data entries
+ */
+#define ARSTREAM2_MP4_WRITER_MAX_USER_DATA_COUNT (8)
+
+
+/**
+ * Media timescale (the H.264 RTP clock rate)
+ */
+#define ARSTREAM2_MP4_WRITER_TIMESCALE (90000)
+
+
+/**
+ * @brief MP4 writer configuration.
+ */
+typedef struct ARSTREAM2_Mp4Writer_Config_s
+{
+    ARSTREAM2_FileWriter_Config_t fileWriterConfig; /**< File writer configuration */
+    float videoFramerate;                   /**< Video framerate (frame/s) (optional, can be 0) */
+    uint32_t videoWidth;                    /**< Video width (pixels) */
+    uint32_t videoHeight;                   /**< Video height (pixels) */
+    const uint8_t *sps;                     /**< H.264 video SPS buffer pointer (with or without start code) */
+    uint32_t spsSize;                       /**< H.264 video SPS buffer size in bytes */
+    const uint8_t *pps;                     /**< H.264 video PPS buffer pointer (with or without start code) */
+    uint32_t ppsSize;                       /**< H.264 video PPS buffer size in bytes */
+    int fragmentDurationMs;                 /**< Target fragment duration in milliseconds (optional, 0 for the default value) */
+    int fragmentMaxSize;                    /**< Maximum fragment video data size in bytes (optional, 0 for the default value) */
+    int fragmentMaxSampleCount;             /**< Maximum number of samples per fragment (optional, 0 for the default value) */
+
+} ARSTREAM2_Mp4Writer_Config_t;
+
+
+/**
+ * @brief MP4 writer sample.
+ */
+typedef struct ARSTREAM2_Mp4Writer_Sample_s
+{
+    uint64_t time;
+    uint32_t size;
+    uint32_t isSync;
+
+} ARSTREAM2_Mp4Writer_Sample_t;
+
+
+/**
+ * @brief MP4 writer user data entry.
+ */
+typedef struct ARSTREAM2_Mp4Writer_UserData_s
+{
+    uint32_t type;
+    char *value;
+
+} ARSTREAM2_Mp4Writer_UserData_t;
+
+
+/**
+ * @brief MP4 writer.
+ *
+ * The file starts with a 'moov' box holding only the sample descriptions, the
+ * samples are then written in 'moof'/'mdat' fragments. The memory usage only
+ * depends on the fragment limits and the file is readable up to the last
+ * complete fragment at any time.
+ */
+typedef struct ARSTREAM2_Mp4Writer_s
+{
+    ARSTREAM2_FileWriter_t *fileWriter;
+    int headerWritten;
+    uint32_t videoWidth;
+    uint32_t videoHeight;
+    uint32_t defaultSampleDuration;
+    uint8_t *sps;
+    uint32_t spsSize;
+    uint8_t *pps;
+    uint32_t ppsSize;
+    ARSTREAM2_Mp4Writer_UserData_t userData[ARSTREAM2_MP4_WRITER_MAX_USER_DATA_COUNT];
+    int userDataCount;
+
+    /* timed metadata track */
+    int hasMetadataTrack;
+    char *metadataContentEncoding;
+    char *metadataMimeFormat;
+    uint32_t metadataSampleMaxSize;
+
+    /* current fragment */
+    uint64_t firstTimestamp;
+    int firstTimestampSet;
+    uint64_t lastSampleTime;
+    uint64_t lastSampleDuration;
+    uint32_t sequenceNumber;
+    uint64_t fragmentDuration;
+    uint32_t fragmentMaxSize;
+    int fragmentMaxSampleCount;
+    ARSTREAM2_Mp4Writer_Sample_t *videoSample;
+    int videoSampleCount;
+    uint8_t *videoData;
+    uint32_t videoDataSize;
+    ARSTREAM2_Mp4Writer_Sample_t *metadataSample;
+    int metadataSampleCount;
+    uint8_t *metadataData;
+    uint32_t metadataDataSize;
+    uint8_t *moofBuffer;
+    uint32_t moofBufferSize;
+
+} ARSTREAM2_Mp4Writer_t;
+
+
+/**
+ * @brief Create a fragmented MP4 writer.
+ *
+ * @param[in] config Configuration
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_Mp4Writer_t, or NULL if an error occured
+ */
+ARSTREAM2_Mp4Writer_t* ARSTREAM2_Mp4Writer_New(const ARSTREAM2_Mp4Writer_Config_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Declare the timed metadata track.
+ *
+ * The function must be called before the first sample is added.
+ *
+ * @param writer The MP4 writer instance
+ * @param contentEncoding Metadata content encoding
+ * @param mimeFormat Metadata MIME format
+ * @param sampleMaxSize Maximum metadata sample size in bytes
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_Mp4Writer_SetMetadataTrack(ARSTREAM2_Mp4Writer_t *writer, const char *contentEncoding, const char *mimeFormat, uint32_t sampleMaxSize);
+
+
+/**
+ * @brief Add a user data text entry.
+ *
+ * The function must be called before the first sample is added.
+ *
+ * @param writer The MP4 writer instance
+ * @param type Entry type (such as '©mak')
+ * @param value Entry text
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_Mp4Writer_AddUserData(ARSTREAM2_Mp4Writer_t *writer, uint32_t type, const char *value);
+
+
+/**
+ * @brief Add an access unit.
+ *
+ * The NAL units start codes are replaced with the NAL units sizes. The SPS
+ * and PPS are inserted in the first sample of each fragment if needed so that
+ * all the fragments can be decoded independently.
+ *
+ * @param writer The MP4 writer instance
+ * @param au Access unit
+ * @param metadata Timed metadata sample (optional, can be NULL)
+ * @param metadataSize Timed metadata sample size in bytes
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_Mp4Writer_AddSample(ARSTREAM2_Mp4Writer_t *writer, const ARSTREAM2_H264_AccessUnit_t *au, const void *metadata, uint32_t metadataSize);
+
+
+/**
+ * @brief Delete an MP4 writer.
+ *
+ * The last fragment is written and the file is closed.
+ *
+ * @param writer Pointer to the MP4 writer instance pointer
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_Mp4Writer_Delete(ARSTREAM2_Mp4Writer_t **writer);
+
+
+#endif /* _ARSTREAM2_MP4_WRITER_H_ */
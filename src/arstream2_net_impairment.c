@@ -0,0 +1,442 @@
+/**
+ * @file arstream2_net_impairment.c
+ * @brief Parrot Streaming Library - Network Impairment Emulation
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "arstream2_net_impairment_internal.h"
+
+
+#define ARSTREAM2_NET_IMPAIRMENT_TAG "ARSTREAM2_NetImpairment"
+
+#define ARSTREAM2_NET_IMPAIRMENT_DEFAULT_SEED (0x9E3779B97F4A7C15ULL)
+
+
+/* xorshift64* generator: the sequence only depends on the seed */
+static uint32_t ARSTREAM2_NetImpairment_Random(ARSTREAM2_NetImpairment_t *impairment)
+{
+    uint64_t x = impairment->rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    impairment->rngState = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+
+/* Convert a probability to a threshold on a 32-bit random value */
+static uint64_t ARSTREAM2_NetImpairment_Threshold(float probability)
+{
+    if (probability <= 0.)
+    {
+        return 0;
+    }
+    else if (probability >= 1.)
+    {
+        return 1ULL << 32;
+    }
+    else
+    {
+        return (uint64_t)((double)probability * 4294967296.);
+    }
+}
+
+
+static inline int ARSTREAM2_NetImpairment_IsBefore(const ARSTREAM2_NetImpairment_Packet_t *a, const ARSTREAM2_NetImpairment_Packet_t *b)
+{
+    return ((a->releaseTime < b->releaseTime) || ((a->releaseTime == b->releaseTime) && (a->order < b->order)));
+}
+
+
+static void ARSTREAM2_NetImpairment_HeapPush(ARSTREAM2_NetImpairment_t *impairment, ARSTREAM2_NetImpairment_Packet_t *packet)
+{
+    unsigned int i = impairment->heapCount++, parent;
+
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (!ARSTREAM2_NetImpairment_IsBefore(packet, impairment->heap[parent]))
+        {
+            break;
+        }
+        impairment->heap[i] = impairment->heap[parent];
+        i = parent;
+    }
+    impairment->heap[i] = packet;
+}
+
+
+static ARSTREAM2_NetImpairment_Packet_t* ARSTREAM2_NetImpairment_HeapPop(ARSTREAM2_NetImpairment_t *impairment)
+{
+    ARSTREAM2_NetImpairment_Packet_t *top, *last;
+    unsigned int i = 0, child;
+
+    if (impairment->heapCount == 0)
+    {
+        return NULL;
+    }
+
+    top = impairment->heap[0];
+    last = impairment->heap[--impairment->heapCount];
+    while ((child = 2 * i + 1) < impairment->heapCount)
+    {
+        if ((child + 1 < impairment->heapCount) && (ARSTREAM2_NetImpairment_IsBefore(impairment->heap[child + 1], impairment->heap[child])))
+        {
+            child++;
+        }
+        if (!ARSTREAM2_NetImpairment_IsBefore(impairment->heap[child], last))
+        {
+            break;
+        }
+        impairment->heap[i] = impairment->heap[child];
+        i = child;
+    }
+    if (impairment->heapCount > 0)
+    {
+        impairment->heap[i] = last;
+    }
+
+    return top;
+}
+
+
+static int ARSTREAM2_NetImpairment_Enqueue(ARSTREAM2_NetImpairment_t *impairment, const struct iovec *iov, int iovCount,
+                                           size_t size, uint64_t curTime, uint32_t jitterRandom, int reorder)
+{
+    ARSTREAM2_NetImpairment_Packet_t *packet;
+    uint64_t releaseTime;
+    size_t offset, len;
+    int i;
+
+    if (impairment->freeCount == 0)
+    {
+        impairment->stats.overflowCount++;
+        return 0;
+    }
+    packet = impairment->freePacket[impairment->freeCount - 1];
+
+    if (packet->capacity < size)
+    {
+        uint8_t *data = realloc(packet->data, size);
+        if (!data)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_NET_IMPAIRMENT_TAG, "Packet allocation failed (size %zu)", size);
+            return -1;
+        }
+        packet->data = data;
+        packet->capacity = size;
+    }
+    for (i = 0, offset = 0; (i < iovCount) && (offset < size); i++)
+    {
+        len = (iov[i].iov_len < size - offset) ? iov[i].iov_len : size - offset;
+        memcpy(packet->data + offset, iov[i].iov_base, len);
+        offset += len;
+    }
+    packet->size = offset;
+    impairment->freeCount--;
+
+    /* rate limitation: the packets are serialized on the link in submission order */
+    releaseTime = curTime;
+    if (impairment->config.rateLimit > 0)
+    {
+        if (impairment->linkFreeTime < curTime)
+        {
+            impairment->linkFreeTime = curTime;
+        }
+        impairment->linkFreeTime += ((uint64_t)packet->size * 8 * 1000000 + impairment->config.rateLimit - 1) / impairment->config.rateLimit;
+        releaseTime = impairment->linkFreeTime;
+    }
+
+    /* delay with jitter, the order is kept except for the reordered packets */
+    if (reorder)
+    {
+        impairment->stats.reorderCount++;
+    }
+    else
+    {
+        releaseTime += impairment->config.delayUs;
+        if (impairment->config.jitterUs > 0)
+        {
+            releaseTime += (uint64_t)jitterRandom % ((uint64_t)impairment->config.jitterUs + 1);
+        }
+        if (releaseTime < impairment->lastReleaseTime)
+        {
+            releaseTime = impairment->lastReleaseTime;
+        }
+        impairment->lastReleaseTime = releaseTime;
+    }
+
+    packet->releaseTime = releaseTime;
+    packet->order = impairment->order++;
+    ARSTREAM2_NetImpairment_HeapPush(impairment, packet);
+
+    return 1;
+}
+
+
+ARSTREAM2_NetImpairment_t* ARSTREAM2_NetImpairment_New(const ARSTREAM2_NetImpairment_Config_t *config, eARSTREAM2_ERROR *error)
+{
+    ARSTREAM2_NetImpairment_t *retImpairment = NULL;
+    eARSTREAM2_ERROR internalError = ARSTREAM2_OK;
+    unsigned int i;
+
+    /* ARGS Check */
+    if (config == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_NET_IMPAIRMENT_TAG, "Invalid pointer for config");
+        if (error != NULL)
+        {
+            *error = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        return NULL;
+    }
+    if ((config->burstStartProbability > 0.) && (config->burstEndProbability <= 0.))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_NET_IMPAIRMENT_TAG, "Invalid burst loss model: the bad state is never left");
+        if (error != NULL)
+        {
+            *error = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        return NULL;
+    }
+
+    /* Alloc new impairment stage */
+    retImpairment = malloc(sizeof(ARSTREAM2_NetImpairment_t));
+    if (retImpairment == NULL)
+    {
+        internalError = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (internalError == ARSTREAM2_OK)
+    {
+        memset(retImpairment, 0, sizeof(ARSTREAM2_NetImpairment_t));
+        memcpy(&retImpairment->config, config, sizeof(ARSTREAM2_NetImpairment_Config_t));
+        retImpairment->queueSize = (config->queueSize > 0) ? config->queueSize : ARSTREAM2_NET_IMPAIRMENT_DEFAULT_QUEUE_SIZE;
+        retImpairment->rngState = ((uint64_t)config->seed << 32 | config->seed) ^ ARSTREAM2_NET_IMPAIRMENT_DEFAULT_SEED;
+        if (retImpairment->rngState == 0)
+        {
+            retImpairment->rngState = ARSTREAM2_NET_IMPAIRMENT_DEFAULT_SEED;
+        }
+        retImpairment->lossThreshold = ARSTREAM2_NetImpairment_Threshold(config->lossProbability);
+        retImpairment->burstStartThreshold = ARSTREAM2_NetImpairment_Threshold(config->burstStartProbability);
+        retImpairment->burstEndThreshold = ARSTREAM2_NetImpairment_Threshold(config->burstEndProbability);
+        retImpairment->burstLossThreshold = ARSTREAM2_NetImpairment_Threshold(config->burstLossProbability);
+        retImpairment->duplicateThreshold = ARSTREAM2_NetImpairment_Threshold(config->duplicateProbability);
+        retImpairment->reorderThreshold = ARSTREAM2_NetImpairment_Threshold(config->reorderProbability);
+
+        retImpairment->packet = calloc(retImpairment->queueSize, sizeof(ARSTREAM2_NetImpairment_Packet_t));
+        retImpairment->heap = malloc(retImpairment->queueSize * sizeof(ARSTREAM2_NetImpairment_Packet_t*));
+        retImpairment->freePacket = malloc(retImpairment->queueSize * sizeof(ARSTREAM2_NetImpairment_Packet_t*));
+        if ((!retImpairment->packet) || (!retImpairment->heap) || (!retImpairment->freePacket))
+        {
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if (internalError == ARSTREAM2_OK)
+    {
+        for (i = 0; i < retImpairment->queueSize; i++)
+        {
+            retImpairment->freePacket[i] = &retImpairment->packet[retImpairment->queueSize - 1 - i];
+        }
+        retImpairment->freeCount = retImpairment->queueSize;
+
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_NET_IMPAIRMENT_TAG, "Network impairment enabled: seed=%u loss=%.3f burst=%.3f/%.3f/%.3f dup=%.3f delay=%uus jitter=%uus reorder=%.3f rate=%ubit/s",
+                    config->seed, config->lossProbability, config->burstStartProbability, config->burstEndProbability, config->burstLossProbability,
+                    config->duplicateProbability, config->delayUs, config->jitterUs, config->reorderProbability, config->rateLimit);
+    }
+
+    if ((internalError != ARSTREAM2_OK) && (retImpairment != NULL))
+    {
+        ARSTREAM2_NetImpairment_Delete(&retImpairment);
+    }
+
+    if (error != NULL)
+    {
+        *error = internalError;
+    }
+
+    return retImpairment;
+}
+
+
+int ARSTREAM2_NetImpairment_Submit(ARSTREAM2_NetImpairment_t *impairment, const struct iovec *iov, int iovCount,
+                                   size_t size, uint64_t curTime)
+{
+    uint32_t lossRandom, burstLossRandom, burstTransitionRandom, duplicateRandom, jitterRandom[2], reorderRandom[2];
+    int ret, count = 0;
+
+    if ((!impairment) || ((!iov) && (iovCount > 0)))
+    {
+        return -1;
+    }
+
+    /* draw the same number of random values for each packet so that each
+     * impairment sequence does not depend on the other settings */
+    lossRandom = ARSTREAM2_NetImpairment_Random(impairment);
+    burstLossRandom = ARSTREAM2_NetImpairment_Random(impairment);
+    burstTransitionRandom = ARSTREAM2_NetImpairment_Random(impairment);
+    duplicateRandom = ARSTREAM2_NetImpairment_Random(impairment);
+    jitterRandom[0] = ARSTREAM2_NetImpairment_Random(impairment);
+    jitterRandom[1] = ARSTREAM2_NetImpairment_Random(impairment);
+    reorderRandom[0] = ARSTREAM2_NetImpairment_Random(impairment);
+    reorderRandom[1] = ARSTREAM2_NetImpairment_Random(impairment);
+
+    impairment->stats.inputCount++;
+
+    if ((uint64_t)lossRandom < impairment->lossThreshold)
+    {
+        impairment->stats.randomLossCount++;
+        return 0;
+    }
+
+    /* Gilbert-Elliott model: the loss depends on the current state, then the state changes */
+    if (impairment->burstStartThreshold > 0)
+    {
+        int lost = ((impairment->burstState) && ((uint64_t)burstLossRandom < impairment->burstLossThreshold));
+        if (impairment->burstState)
+        {
+            if ((uint64_t)burstTransitionRandom < impairment->burstEndThreshold)
+            {
+                impairment->burstState = 0;
+            }
+        }
+        else
+        {
+            if ((uint64_t)burstTransitionRandom < impairment->burstStartThreshold)
+            {
+                impairment->burstState = 1;
+            }
+        }
+        if (lost)
+        {
+            impairment->stats.burstLossCount++;
+            return 0;
+        }
+    }
+
+    ret = ARSTREAM2_NetImpairment_Enqueue(impairment, iov, iovCount, size, curTime, jitterRandom[0],
+                                          ((impairment->config.delayUs > 0) && ((uint64_t)reorderRandom[0] < impairment->reorderThreshold)));
+    if (ret < 0)
+    {
+        return ret;
+    }
+    count += ret;
+
+    if ((uint64_t)duplicateRandom < impairment->duplicateThreshold)
+    {
+        ret = ARSTREAM2_NetImpairment_Enqueue(impairment, iov, iovCount, size, curTime, jitterRandom[1],
+                                              ((impairment->config.delayUs > 0) && ((uint64_t)reorderRandom[1] < impairment->reorderThreshold)));
+        if (ret < 0)
+        {
+            return ret;
+        }
+        impairment->stats.duplicateCount += ret;
+        count += ret;
+    }
+
+    return count;
+}
+
+
+int ARSTREAM2_NetImpairment_Peek(ARSTREAM2_NetImpairment_t *impairment, uint64_t curTime, const uint8_t **data, size_t *size)
+{
+    ARSTREAM2_NetImpairment_Packet_t *packet;
+
+    if ((!impairment) || (impairment->heapCount == 0))
+    {
+        return 0;
+    }
+
+    packet = impairment->heap[0];
+    if (packet->releaseTime > curTime)
+    {
+        return 0;
+    }
+
+    if (data) *data = packet->data;
+    if (size) *size = packet->size;
+
+    return 1;
+}
+
+
+void ARSTREAM2_NetImpairment_Pop(ARSTREAM2_NetImpairment_t *impairment)
+{
+    ARSTREAM2_NetImpairment_Packet_t *packet;
+
+    if (!impairment)
+    {
+        return;
+    }
+
+    packet = ARSTREAM2_NetImpairment_HeapPop(impairment);
+    if (packet)
+    {
+        impairment->freePacket[impairment->freeCount++] = packet;
+        impairment->stats.outputCount++;
+    }
+}
+
+
+uint32_t ARSTREAM2_NetImpairment_GetNextTimeout(ARSTREAM2_NetImpairment_t *impairment, uint64_t curTime, uint32_t maxTimeout)
+{
+    uint64_t releaseTime;
+
+    if ((!impairment) || (impairment->heapCount == 0))
+    {
+        return maxTimeout;
+    }
+
+    releaseTime = impairment->heap[0]->releaseTime;
+    if (releaseTime <= curTime)
+    {
+        return 0;
+    }
+
+    return (releaseTime - curTime < maxTimeout) ? (uint32_t)(releaseTime - curTime) : maxTimeout;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_NetImpairment_Delete(ARSTREAM2_NetImpairment_t **impairment)
+{
+    unsigned int i;
+
+    if ((!impairment) || (!*impairment))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if ((*impairment)->stats.inputCount > 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_NET_IMPAIRMENT_TAG, "Impairment stats: in=%llu out=%llu randomLoss=%llu burstLoss=%llu duplicate=%llu reorder=%llu overflow=%llu",
+                    (long long unsigned int)(*impairment)->stats.inputCount, (long long unsigned int)(*impairment)->stats.outputCount,
+                    (long long unsigned int)(*impairment)->stats.randomLossCount, (long long unsigned int)(*impairment)->stats.burstLossCount,
+                    (long long unsigned int)(*impairment)->stats.duplicateCount, (long long unsigned int)(*impairment)->stats.reorderCount,
+                    (long long unsigned int)(*impairment)->stats.overflowCount);
+    }
+
+    if ((*impairment)->packet)
+    {
+        for (i = 0; i < (*impairment)->queueSize; i++)
+        {
+            free((*impairment)->packet[i].data);
+        }
+    }
+    free((*impairment)->packet);
+    free((*impairment)->heap);
+    free((*impairment)->freePacket);
+    free(*impairment);
+    *impairment = NULL;
+
+    return ARSTREAM2_OK;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file arstream2_net_impairment_internal.h
+ * @brief Parrot Streaming Library - Network Impairment Emulation
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_NET_IMPAIRMENT_INTERNAL_H_
+#define _ARSTREAM2_NET_IMPAIRMENT_INTERNAL_H_
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#include <libARStream2/arstream2_error.h>
+#include <libARStream2/arstream2_net_impairment.h>
+
+
+/**
+ * @brief Impairment stage statistics.
+ */
+typedef struct ARSTREAM2_NetImpairment_Stats_s
+{
+    uint64_t inputCount;                    /**< Number of submitted packets */
+    uint64_t outputCount;                   /**< Number of released packets */
+    uint64_t randomLossCount;               /**< Number of packets dropped by the random loss */
+    uint64_t burstLossCount;                /**< Number of packets dropped in the bad state of the burst loss model */
+    uint64_t duplicateCount;                /**< Number of duplicated packets */
+    uint64_t reorderCount;                  /**< Number of packets which skipped the delay */
+    uint64_t overflowCount;                 /**< Number of packets dropped because the queue was full */
+
+} ARSTREAM2_NetImpairment_Stats_t;
+
+
+/**
+ * @brief Held packet.
+ */
+typedef struct ARSTREAM2_NetImpairment_Packet_s
+{
+    uint64_t releaseTime;
+    uint64_t order;
+    size_t size;
+    size_t capacity;
+    uint8_t *data;
+
+} ARSTREAM2_NetImpairment_Packet_t;
+
+
+/**
+ * @brief Impairment stage.
+ *
+ * The packets are copied on submission and held in a queue ordered by
+ * release time. The time is always provided by the caller so that the
+ * impairments only depend on the seed and the packet arrival times.
+ */
+typedef struct ARSTREAM2_NetImpairment_s
+{
+    ARSTREAM2_NetImpairment_Config_t config;
+    uint64_t rngState;
+    uint64_t lossThreshold;
+    uint64_t burstStartThreshold;
+    uint64_t burstEndThreshold;
+    uint64_t burstLossThreshold;
+    uint64_t duplicateThreshold;
+    uint64_t reorderThreshold;
+    int burstState;
+    uint64_t linkFreeTime;
+    uint64_t lastReleaseTime;
+    uint64_t order;
+    ARSTREAM2_NetImpairment_Packet_t *packet;
+    ARSTREAM2_NetImpairment_Packet_t **heap;
+    ARSTREAM2_NetImpairment_Packet_t **freePacket;
+    unsigned int queueSize;
+    unsigned int heapCount;
+    unsigned int freeCount;
+    ARSTREAM2_NetImpairment_Stats_t stats;
+
+} ARSTREAM2_NetImpairment_t;
+
+
+/**
+ * @brief Create an impairment stage.
+ *
+ * @param[in] config Configuration
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_NetImpairment_t, or NULL if an error occured
+ */
+ARSTREAM2_NetImpairment_t* ARSTREAM2_NetImpairment_New(const ARSTREAM2_NetImpairment_Config_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Submit a packet.
+ *
+ * The packet data is copied.
+ *
+ * @param impairment The impairment stage instance
+ * @param iov Packet data scatter array
+ * @param iovCount Number of elements in the scatter array
+ * @param size Packet size in bytes
+ * @param curTime Current time in microseconds
+ *
+ * @return the number of queued packets (0 if the packet was dropped, 2 if it was duplicated).
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_NetImpairment_Submit(ARSTREAM2_NetImpairment_t *impairment, const struct iovec *iov, int iovCount,
+                                   size_t size, uint64_t curTime);
+
+
+/**
+ * @brief Get the next packet due for release.
+ *
+ * The packet stays queued until ARSTREAM2_NetImpairment_Pop() is called.
+ *
+ * @param impairment The impairment stage instance
+ * @param curTime Current time in microseconds
+ * @param[out] data Pointer to the packet data (valid until the packet is popped)
+ * @param[out] size Packet size in bytes
+ *
+ * @return 1 if a packet is due.
+ * @return 0 if no packet is due.
+ */
+int ARSTREAM2_NetImpairment_Peek(ARSTREAM2_NetImpairment_t *impairment, uint64_t curTime, const uint8_t **data, size_t *size);
+
+
+/**
+ * @brief Remove the packet returned by ARSTREAM2_NetImpairment_Peek().
+ *
+ * @param impairment The impairment stage instance
+ */
+void ARSTREAM2_NetImpairment_Pop(ARSTREAM2_NetImpairment_t *impairment);
+
+
+/**
+ * @brief Get the time until the next packet release.
+ *
+ * @param impairment The impairment stage instance
+ * @param curTime Current time in microseconds
+ * @param maxTimeout Value returned when no packet is queued
+ *
+ * @return the time until the next release in microseconds, bounded by maxTimeout.
+ */
+uint32_t ARSTREAM2_NetImpairment_GetNextTimeout(ARSTREAM2_NetImpairment_t *impairment, uint64_t curTime, uint32_t maxTimeout);
+
+
+/**
+ * @brief Delete an impairment stage.
+ *
+ * The queued packets are discarded.
+ *
+ * @param impairment Pointer to the impairment stage instance pointer
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_NetImpairment_Delete(ARSTREAM2_NetImpairment_t **impairment);
+
+
+#endif /* _ARSTREAM2_NET_IMPAIRMENT_INTERNAL_H_ */
@@ -0,0 +1,701 @@
+/**
+ * @file arstream2_pcap.c
+ * @brief Parrot Streaming Library - pcapng Capture Writer and Reader
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "arstream2_pcap.h"
+
+
+#define ARSTREAM2_PCAP_TAG "ARSTREAM2_Pcap"
+
+#define ARSTREAM2_PCAP_BLOCK_SHB (0x0A0D0D0A)
+#define ARSTREAM2_PCAP_BLOCK_IDB (0x00000001)
+#define ARSTREAM2_PCAP_BLOCK_EPB (0x00000006)
+#define ARSTREAM2_PCAP_BYTE_ORDER_MAGIC (0x1A2B3C4D)
+#define ARSTREAM2_PCAP_BYTE_ORDER_MAGIC_SWAPPED (0x4D3C2B1A)
+
+#define ARSTREAM2_PCAP_OPT_ENDOFOPT (0)
+#define ARSTREAM2_PCAP_OPT_SHB_USERAPPL (4)
+#define ARSTREAM2_PCAP_OPT_IF_NAME (2)
+#define ARSTREAM2_PCAP_OPT_IF_TSRESOL (9)
+
+#define ARSTREAM2_PCAP_LINKTYPE_ETHERNET (1)
+#define ARSTREAM2_PCAP_LINKTYPE_RAW (101)
+#define ARSTREAM2_PCAP_LINKTYPE_LINUX_SLL (113)
+#define ARSTREAM2_PCAP_LINKTYPE_IPV4 (228)
+
+#define ARSTREAM2_PCAP_ETHERTYPE_IPV4 (0x0800)
+#define ARSTREAM2_PCAP_ETHERTYPE_VLAN (0x8100)
+
+#define ARSTREAM2_PCAP_IP_HEADER_SIZE (20)
+#define ARSTREAM2_PCAP_UDP_HEADER_SIZE (8)
+#define ARSTREAM2_PCAP_IP_PROTO_UDP (17)
+#define ARSTREAM2_PCAP_IP_TTL (64)
+
+/* block type, total length, interface id, timestamp, captured and original lengths */
+#define ARSTREAM2_PCAP_EPB_HEADER_SIZE (28)
+
+#define ARSTREAM2_PCAP_OPTIONS_MAX_SIZE (256)
+
+
+/**
+ * Sets *PTR to VAL if PTR is not null
+ */
+#define SET_WITH_CHECK(PTR,VAL)                 \
+    do                                          \
+    {                                           \
+        if (PTR != NULL)                        \
+        {                                       \
+            *PTR = VAL;                         \
+        }                                       \
+    } while (0)
+
+
+static const char *ARSTREAM2_Pcap_channelName[ARSTREAM2_PCAP_CHANNEL_MAX] =
+{
+    "rtp",
+    "rtcp",
+};
+
+
+static inline void ARSTREAM2_Pcap_Write16(uint8_t *p, uint16_t val)
+{
+    memcpy(p, &val, sizeof(val));
+}
+
+
+static inline void ARSTREAM2_Pcap_Write32(uint8_t *p, uint32_t val)
+{
+    memcpy(p, &val, sizeof(val));
+}
+
+
+static inline uint16_t ARSTREAM2_Pcap_Read16(const uint8_t *p)
+{
+    uint16_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+
+static inline uint32_t ARSTREAM2_Pcap_Read32(const uint8_t *p)
+{
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+
+static inline uint16_t ARSTREAM2_Pcap_ReadBe16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+
+/* Append an option padded to 32 bits, returns the new offset */
+static size_t ARSTREAM2_Pcap_PutOption(uint8_t *buf, size_t offset, uint16_t code, const void *value, uint16_t len)
+{
+    size_t padded = ((size_t)len + 3) & ~(size_t)3;
+
+    if (offset + 4 + padded + 4 > ARSTREAM2_PCAP_OPTIONS_MAX_SIZE)
+    {
+        /* keep room for the end of options */
+        return offset;
+    }
+    ARSTREAM2_Pcap_Write16(buf + offset, code);
+    ARSTREAM2_Pcap_Write16(buf + offset + 2, len);
+    memset(buf + offset + 4, 0, padded);
+    if (len > 0)
+    {
+        memcpy(buf + offset + 4, value, len);
+    }
+    return offset + 4 + padded;
+}
+
+
+/* Write a block with a fixed part and options */
+static int ARSTREAM2_PcapWriter_WriteBlock(ARSTREAM2_PcapWriter_t *writer, uint32_t type, const uint8_t *body, size_t bodySize,
+                                           const uint8_t *options, size_t optionsSize)
+{
+    uint8_t header[8], trailer[4];
+    uint32_t totalLength = (uint32_t)(8 + bodySize + optionsSize + 4);
+    int err = 0;
+
+    ARSTREAM2_Pcap_Write32(header, type);
+    ARSTREAM2_Pcap_Write32(header + 4, totalLength);
+    ARSTREAM2_Pcap_Write32(trailer, totalLength);
+
+    err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, header, sizeof(header));
+    err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, body, bodySize);
+    if (optionsSize > 0)
+    {
+        err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, options, optionsSize);
+    }
+    err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, trailer, sizeof(trailer));
+
+    return (err) ? -1 : 0;
+}
+
+
+static int ARSTREAM2_PcapWriter_WriteHeader(ARSTREAM2_PcapWriter_t *writer, const char *applicationName)
+{
+    uint8_t body[16], options[ARSTREAM2_PCAP_OPTIONS_MAX_SIZE];
+    size_t optionsSize = 0;
+    int i;
+
+    /* section header block: byte order magic, version 1.0, unspecified section length */
+    ARSTREAM2_Pcap_Write32(body, ARSTREAM2_PCAP_BYTE_ORDER_MAGIC);
+    ARSTREAM2_Pcap_Write16(body + 4, 1);
+    ARSTREAM2_Pcap_Write16(body + 6, 0);
+    memset(body + 8, 0xFF, 8);
+    if ((applicationName) && (strlen(applicationName)))
+    {
+        optionsSize = ARSTREAM2_Pcap_PutOption(options, optionsSize, ARSTREAM2_PCAP_OPT_SHB_USERAPPL,
+                                               applicationName, (uint16_t)strnlen(applicationName, 128));
+        optionsSize = ARSTREAM2_Pcap_PutOption(options, optionsSize, ARSTREAM2_PCAP_OPT_ENDOFOPT, NULL, 0);
+    }
+    if (ARSTREAM2_PcapWriter_WriteBlock(writer, ARSTREAM2_PCAP_BLOCK_SHB, body, 16, options, optionsSize) != 0)
+    {
+        return -1;
+    }
+
+    /* one interface description block per channel, microsecond resolution (default) */
+    for (i = 0; i < ARSTREAM2_PCAP_CHANNEL_MAX; i++)
+    {
+        ARSTREAM2_Pcap_Write16(body, ARSTREAM2_PCAP_LINKTYPE_IPV4);
+        ARSTREAM2_Pcap_Write16(body + 2, 0);
+        ARSTREAM2_Pcap_Write32(body + 4, writer->snapLength);
+        optionsSize = 0;
+        optionsSize = ARSTREAM2_Pcap_PutOption(options, optionsSize, ARSTREAM2_PCAP_OPT_IF_NAME,
+                                               ARSTREAM2_Pcap_channelName[i], (uint16_t)strlen(ARSTREAM2_Pcap_channelName[i]));
+        optionsSize = ARSTREAM2_Pcap_PutOption(options, optionsSize, ARSTREAM2_PCAP_OPT_ENDOFOPT, NULL, 0);
+        if (ARSTREAM2_PcapWriter_WriteBlock(writer, ARSTREAM2_PCAP_BLOCK_IDB, body, 8, options, optionsSize) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+static uint16_t ARSTREAM2_Pcap_IpChecksum(const uint8_t *header)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < ARSTREAM2_PCAP_IP_HEADER_SIZE; i += 2)
+    {
+        sum += ((uint32_t)header[i] << 8) | header[i + 1];
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+
+ARSTREAM2_PcapWriter_t* ARSTREAM2_PcapWriter_New(const ARSTREAM2_PcapWriter_Config_t *config, eARSTREAM2_ERROR *error)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_PcapWriter_t *writer = NULL;
+
+    /* ARGS Check */
+    if (config == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Invalid config");
+        SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+        return NULL;
+    }
+
+    /* Alloc new writer */
+    writer = (ARSTREAM2_PcapWriter_t*)malloc(sizeof(ARSTREAM2_PcapWriter_t));
+    if (writer == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Allocation failed (size %zu)", sizeof(ARSTREAM2_PcapWriter_t));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(writer, 0, sizeof(ARSTREAM2_PcapWriter_t));
+        writer->srcAddr = config->srcAddr;
+        writer->dstAddr = config->dstAddr;
+        memcpy(writer->srcPort, config->srcPort, sizeof(writer->srcPort));
+        memcpy(writer->dstPort, config->dstPort, sizeof(writer->dstPort));
+        writer->snapLength = ((config->snapLength > 0) && (config->snapLength < ARSTREAM2_PCAP_DEFAULT_SNAP_LENGTH)) ? config->snapLength : ARSTREAM2_PCAP_DEFAULT_SNAP_LENGTH;
+        if (writer->snapLength < ARSTREAM2_PCAP_IP_HEADER_SIZE + ARSTREAM2_PCAP_UDP_HEADER_SIZE)
+        {
+            writer->snapLength = ARSTREAM2_PCAP_IP_HEADER_SIZE + ARSTREAM2_PCAP_UDP_HEADER_SIZE;
+        }
+        writer->fileWriter = ARSTREAM2_FileWriter_New(&config->fileWriterConfig, &ret);
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        if (ARSTREAM2_PcapWriter_WriteHeader(writer, config->applicationName) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Failed to write the capture header");
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if ((ret != ARSTREAM2_OK) && (writer))
+    {
+        if (writer->fileWriter)
+        {
+            ARSTREAM2_FileWriter_Delete(&writer->fileWriter);
+        }
+        free(writer);
+        writer = NULL;
+    }
+
+    SET_WITH_CHECK(error, ret);
+    return writer;
+}
+
+
+int ARSTREAM2_PcapWriter_WritePacket(ARSTREAM2_PcapWriter_t *writer, eARSTREAM2_PCAP_CHANNEL channel, uint64_t timestamp,
+                                     const struct iovec *iov, int iovCount, size_t size)
+{
+    uint8_t header[ARSTREAM2_PCAP_EPB_HEADER_SIZE + ARSTREAM2_PCAP_IP_HEADER_SIZE + ARSTREAM2_PCAP_UDP_HEADER_SIZE];
+    uint8_t trailer[3 + 4];
+    uint8_t *ip = header + ARSTREAM2_PCAP_EPB_HEADER_SIZE;
+    uint8_t *udp = ip + ARSTREAM2_PCAP_IP_HEADER_SIZE;
+    size_t origLength, capLength, payloadLength, len;
+    uint32_t totalLength, padding;
+    uint16_t val16;
+    int i, err = 0;
+
+    if ((!writer) || ((!iov) && (iovCount > 0)) || ((int)channel < 0) || (channel >= ARSTREAM2_PCAP_CHANNEL_MAX))
+    {
+        return -1;
+    }
+    if (size > 0xFFFF - ARSTREAM2_PCAP_IP_HEADER_SIZE - ARSTREAM2_PCAP_UDP_HEADER_SIZE)
+    {
+        size = 0xFFFF - ARSTREAM2_PCAP_IP_HEADER_SIZE - ARSTREAM2_PCAP_UDP_HEADER_SIZE;
+    }
+
+    origLength = ARSTREAM2_PCAP_IP_HEADER_SIZE + ARSTREAM2_PCAP_UDP_HEADER_SIZE + size;
+    capLength = (origLength > writer->snapLength) ? writer->snapLength : origLength;
+    payloadLength = capLength - ARSTREAM2_PCAP_IP_HEADER_SIZE - ARSTREAM2_PCAP_UDP_HEADER_SIZE;
+    padding = (uint32_t)((4 - (capLength & 3)) & 3);
+    totalLength = (uint32_t)(ARSTREAM2_PCAP_EPB_HEADER_SIZE + capLength + padding + 4);
+
+    /* enhanced packet block */
+    ARSTREAM2_Pcap_Write32(header, ARSTREAM2_PCAP_BLOCK_EPB);
+    ARSTREAM2_Pcap_Write32(header + 4, totalLength);
+    ARSTREAM2_Pcap_Write32(header + 8, (uint32_t)channel);
+    ARSTREAM2_Pcap_Write32(header + 12, (uint32_t)(timestamp >> 32));
+    ARSTREAM2_Pcap_Write32(header + 16, (uint32_t)(timestamp & 0xFFFFFFFF));
+    ARSTREAM2_Pcap_Write32(header + 20, (uint32_t)capLength);
+    ARSTREAM2_Pcap_Write32(header + 24, (uint32_t)origLength);
+
+    /* IPv4 header (don't fragment) */
+    ip[0] = 0x45;
+    ip[1] = 0;
+    val16 = htons((uint16_t)origLength);
+    memcpy(ip + 2, &val16, 2);
+    val16 = htons(writer->ipId++);
+    memcpy(ip + 4, &val16, 2);
+    val16 = htons(0x4000);
+    memcpy(ip + 6, &val16, 2);
+    ip[8] = ARSTREAM2_PCAP_IP_TTL;
+    ip[9] = ARSTREAM2_PCAP_IP_PROTO_UDP;
+    ip[10] = ip[11] = 0;
+    memcpy(ip + 12, &writer->srcAddr, 4);
+    memcpy(ip + 16, &writer->dstAddr, 4);
+    val16 = htons(ARSTREAM2_Pcap_IpChecksum(ip));
+    memcpy(ip + 10, &val16, 2);
+
+    /* UDP header (no checksum) */
+    val16 = htons(writer->srcPort[channel]);
+    memcpy(udp, &val16, 2);
+    val16 = htons(writer->dstPort[channel]);
+    memcpy(udp + 2, &val16, 2);
+    val16 = htons((uint16_t)(ARSTREAM2_PCAP_UDP_HEADER_SIZE + size));
+    memcpy(udp + 4, &val16, 2);
+    udp[6] = udp[7] = 0;
+
+    err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, header, sizeof(header));
+    for (i = 0; (i < iovCount) && (payloadLength > 0); i++)
+    {
+        len = (iov[i].iov_len < payloadLength) ? iov[i].iov_len : payloadLength;
+        if (len > 0)
+        {
+            err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, iov[i].iov_base, len);
+            payloadLength -= len;
+        }
+    }
+    if (payloadLength > 0)
+    {
+        /* the scatter array is shorter than the packet size: keep the block consistent */
+        uint8_t zero[64];
+        memset(zero, 0, sizeof(zero));
+        while ((payloadLength > 0) && (!err))
+        {
+            len = (payloadLength < sizeof(zero)) ? payloadLength : sizeof(zero);
+            err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, zero, len);
+            payloadLength -= len;
+        }
+    }
+    memset(trailer, 0, padding);
+    ARSTREAM2_Pcap_Write32(trailer + padding, totalLength);
+    err |= ARSTREAM2_FileWriter_Write(writer->fileWriter, trailer, padding + 4);
+
+    if (err)
+    {
+        return -1;
+    }
+
+    writer->packetCount++;
+    writer->byteCount += totalLength;
+
+    return 0;
+}
+
+
+int ARSTREAM2_PcapWriter_Poll(ARSTREAM2_PcapWriter_t *writer)
+{
+    if (!writer)
+    {
+        return -1;
+    }
+
+    return ARSTREAM2_FileWriter_Poll(writer->fileWriter);
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_PcapWriter_Delete(ARSTREAM2_PcapWriter_t **writer)
+{
+    eARSTREAM2_ERROR ret;
+
+    if ((!writer) || (!*writer))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_PCAP_TAG, "Captured %llu packets (%llu bytes)",
+                (long long unsigned int)(*writer)->packetCount, (long long unsigned int)(*writer)->byteCount);
+
+    ret = ARSTREAM2_FileWriter_Delete(&(*writer)->fileWriter);
+    free(*writer);
+    *writer = NULL;
+
+    return ret;
+}
+
+
+ARSTREAM2_PcapReader_t* ARSTREAM2_PcapReader_New(const char *fileName, eARSTREAM2_ERROR *error)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_PcapReader_t *reader = NULL;
+    struct stat st;
+    void *map;
+
+    /* ARGS Check */
+    if ((fileName == NULL) || (!strlen(fileName)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Invalid file name");
+        SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+        return NULL;
+    }
+
+    /* Alloc new reader */
+    reader = (ARSTREAM2_PcapReader_t*)malloc(sizeof(ARSTREAM2_PcapReader_t));
+    if (reader == NULL)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Allocation failed (size %zu)", sizeof(ARSTREAM2_PcapReader_t));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(reader, 0, sizeof(ARSTREAM2_PcapReader_t));
+        reader->fd = open(fileName, O_RDONLY);
+        if (reader->fd < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Failed to open file '%s': %s", fileName, strerror(errno));
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        if ((fstat(reader->fd, &st) != 0) || (st.st_size < 28))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Invalid capture file '%s'", fileName);
+            ret = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, reader->fd, 0);
+        if (map == MAP_FAILED)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Failed to map file '%s': %s", fileName, strerror(errno));
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+        else
+        {
+            reader->data = (const uint8_t*)map;
+            reader->size = (size_t)st.st_size;
+            madvise(map, reader->size, MADV_SEQUENTIAL);
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        if ((ARSTREAM2_Pcap_Read32(reader->data) != ARSTREAM2_PCAP_BLOCK_SHB)
+                || (ARSTREAM2_Pcap_Read32(reader->data + 8) != ARSTREAM2_PCAP_BYTE_ORDER_MAGIC))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "'%s' is not a pcapng file in the host byte order", fileName);
+            ret = ARSTREAM2_ERROR_UNSUPPORTED;
+        }
+    }
+
+    if ((ret != ARSTREAM2_OK) && (reader))
+    {
+        if (reader->data)
+        {
+            munmap((void*)reader->data, reader->size);
+        }
+        if (reader->fd >= 0)
+        {
+            close(reader->fd);
+        }
+        free(reader);
+        reader = NULL;
+    }
+
+    SET_WITH_CHECK(error, ret);
+    return reader;
+}
+
+
+static void ARSTREAM2_PcapReader_ParseInterface(ARSTREAM2_PcapReader_t *reader, const uint8_t *block, uint32_t totalLength)
+{
+    ARSTREAM2_PcapReader_Interface_t *iface;
+    uint32_t offset = 16;
+    uint16_t code, len;
+    uint8_t resol;
+    int i;
+
+    if ((reader->interfaceCount >= ARSTREAM2_PCAP_MAX_INTERFACE_COUNT) || (totalLength < 20))
+    {
+        /* the packets of the extra interfaces are skipped */
+        reader->interfaceCount++;
+        return;
+    }
+
+    iface = &reader->interface[reader->interfaceCount++];
+    iface->linkType = ARSTREAM2_Pcap_Read16(block + 8);
+    iface->tsUnitsPerSecond = 1000000;
+
+    while (offset + 4 <= totalLength - 4)
+    {
+        code = ARSTREAM2_Pcap_Read16(block + offset);
+        len = ARSTREAM2_Pcap_Read16(block + offset + 2);
+        if ((code == ARSTREAM2_PCAP_OPT_ENDOFOPT) || (offset + 4 + len > totalLength - 4))
+        {
+            break;
+        }
+        if ((code == ARSTREAM2_PCAP_OPT_IF_TSRESOL) && (len >= 1))
+        {
+            resol = block[offset + 4];
+            iface->tsUnitsPerSecond = 1;
+            for (i = 0; i < (resol & 0x7F) && (i < 63); i++)
+            {
+                iface->tsUnitsPerSecond *= (resol & 0x80) ? 2 : 10;
+            }
+        }
+        offset += 4 + (((uint32_t)len + 3) & ~(uint32_t)3);
+    }
+}
+
+
+/* Locate the UDP payload in a link-layer packet, returns 0 on success */
+static int ARSTREAM2_PcapReader_ParsePacket(uint16_t linkType, const uint8_t *pkt, size_t capLength,
+                                            const uint8_t **payload, size_t *payloadSize)
+{
+    size_t offset, ipHeaderSize, ipLength, udpLength;
+    uint16_t etherType;
+
+    switch (linkType)
+    {
+        case ARSTREAM2_PCAP_LINKTYPE_IPV4:
+        case ARSTREAM2_PCAP_LINKTYPE_RAW:
+            offset = 0;
+            break;
+        case ARSTREAM2_PCAP_LINKTYPE_ETHERNET:
+            if (capLength < 14)
+            {
+                return -1;
+            }
+            etherType = ARSTREAM2_Pcap_ReadBe16(pkt + 12);
+            offset = 14;
+            if ((etherType == ARSTREAM2_PCAP_ETHERTYPE_VLAN) && (capLength >= 18))
+            {
+                etherType = ARSTREAM2_Pcap_ReadBe16(pkt + 16);
+                offset = 18;
+            }
+            if (etherType != ARSTREAM2_PCAP_ETHERTYPE_IPV4)
+            {
+                return -1;
+            }
+            break;
+        case ARSTREAM2_PCAP_LINKTYPE_LINUX_SLL:
+            if ((capLength < 16) || (ARSTREAM2_Pcap_ReadBe16(pkt + 14) != ARSTREAM2_PCAP_ETHERTYPE_IPV4))
+            {
+                return -1;
+            }
+            offset = 16;
+            break;
+        default:
+            return -1;
+    }
+
+    /* IPv4, UDP, not fragmented */
+    if ((capLength < offset + ARSTREAM2_PCAP_IP_HEADER_SIZE) || ((pkt[offset] >> 4) != 4))
+    {
+        return -1;
+    }
+    ipHeaderSize = (size_t)(pkt[offset] & 0x0F) * 4;
+    ipLength = ARSTREAM2_Pcap_ReadBe16(pkt + offset + 2);
+    if ((ipHeaderSize < ARSTREAM2_PCAP_IP_HEADER_SIZE) || (pkt[offset + 9] != ARSTREAM2_PCAP_IP_PROTO_UDP)
+            || (ARSTREAM2_Pcap_ReadBe16(pkt + offset + 6) & 0x3FFF)
+            || (capLength < offset + ipHeaderSize + ARSTREAM2_PCAP_UDP_HEADER_SIZE))
+    {
+        return -1;
+    }
+    udpLength = ARSTREAM2_Pcap_ReadBe16(pkt + offset + ipHeaderSize + 4);
+    if ((udpLength < ARSTREAM2_PCAP_UDP_HEADER_SIZE) || (ipLength < ipHeaderSize + udpLength))
+    {
+        return -1;
+    }
+    offset += ipHeaderSize + ARSTREAM2_PCAP_UDP_HEADER_SIZE;
+    udpLength -= ARSTREAM2_PCAP_UDP_HEADER_SIZE;
+    if (offset + udpLength > capLength)
+    {
+        /* truncated by the snapshot length */
+        udpLength = capLength - offset;
+    }
+
+    *payload = pkt + offset;
+    *payloadSize = udpLength;
+
+    return 0;
+}
+
+
+int ARSTREAM2_PcapReader_ReadPacket(ARSTREAM2_PcapReader_t *reader, eARSTREAM2_PCAP_CHANNEL *channel, uint64_t *timestamp,
+                                    const uint8_t **data, size_t *size)
+{
+    const uint8_t *block, *payload;
+    uint32_t type, totalLength, interfaceId, capLength;
+    uint64_t ts, units;
+    size_t payloadSize;
+
+    if ((!reader) || (!channel) || (!timestamp) || (!data) || (!size))
+    {
+        return -1;
+    }
+
+    while (reader->offset + 12 <= reader->size)
+    {
+        block = reader->data + reader->offset;
+        type = ARSTREAM2_Pcap_Read32(block);
+        totalLength = ARSTREAM2_Pcap_Read32(block + 4);
+        if (type == ARSTREAM2_PCAP_BLOCK_SHB)
+        {
+            if (ARSTREAM2_Pcap_Read32(block + 8) != ARSTREAM2_PCAP_BYTE_ORDER_MAGIC)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Unsupported section byte order at offset %zu", reader->offset);
+                return -1;
+            }
+            reader->interfaceCount = 0;
+        }
+        if ((totalLength < 12) || (totalLength & 3) || (totalLength > reader->size - reader->offset))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_PCAP_TAG, "Invalid block length %u at offset %zu", totalLength, reader->offset);
+            return -1;
+        }
+        reader->offset += totalLength;
+
+        if (type == ARSTREAM2_PCAP_BLOCK_IDB)
+        {
+            ARSTREAM2_PcapReader_ParseInterface(reader, block, totalLength);
+        }
+        else if ((type == ARSTREAM2_PCAP_BLOCK_EPB) && (totalLength >= ARSTREAM2_PCAP_EPB_HEADER_SIZE + 4))
+        {
+            interfaceId = ARSTREAM2_Pcap_Read32(block + 8);
+            capLength = ARSTREAM2_Pcap_Read32(block + 20);
+            if ((interfaceId >= (uint32_t)reader->interfaceCount) || (interfaceId >= ARSTREAM2_PCAP_MAX_INTERFACE_COUNT)
+                    || (capLength > totalLength - ARSTREAM2_PCAP_EPB_HEADER_SIZE - 4)
+                    || (ARSTREAM2_PcapReader_ParsePacket(reader->interface[interfaceId].linkType, block + ARSTREAM2_PCAP_EPB_HEADER_SIZE,
+                                                         capLength, &payload, &payloadSize) != 0))
+            {
+                reader->skippedCount++;
+                continue;
+            }
+
+            ts = ((uint64_t)ARSTREAM2_Pcap_Read32(block + 12) << 32) | (uint64_t)ARSTREAM2_Pcap_Read32(block + 16);
+            units = reader->interface[interfaceId].tsUnitsPerSecond;
+            *timestamp = (units == 1000000) ? ts : (ts / units) * 1000000 + (ts % units) * 1000000 / units;
+
+            /* RTCP packet types 192-223 do not collide with the dynamic RTP payload types (RFC 5761) */
+            *channel = ((payloadSize >= 2) && (payload[1] >= 192) && (payload[1] <= 223)) ? ARSTREAM2_PCAP_CHANNEL_CONTROL : ARSTREAM2_PCAP_CHANNEL_STREAM;
+            *data = payload;
+            *size = payloadSize;
+            reader->packetCount++;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+void ARSTREAM2_PcapReader_Rewind(ARSTREAM2_PcapReader_t *reader)
+{
+    if (reader)
+    {
+        reader->offset = 0;
+        reader->interfaceCount = 0;
+    }
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_PcapReader_Delete(ARSTREAM2_PcapReader_t **reader)
+{
+    if ((!reader) || (!*reader))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    munmap((void*)(*reader)->data, (*reader)->size);
+    close((*reader)->fd);
+    free(*reader);
+    *reader = NULL;
+
+    return ARSTREAM2_OK;
+}
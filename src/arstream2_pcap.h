@@ -0,0 +1,230 @@
+/**
+ * @file arstream2_pcap.h
+ * @brief Parrot Streaming Library - pcapng Capture Writer and Reader
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_PCAP_H_
+#define _ARSTREAM2_PCAP_H_
+
+#include <config.h>
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#include <libARStream2/arstream2_error.h>
+#include "arstream2_file_writer.h"
+
+
+/**
+ * Default capture snapshot length in bytes
+ */
+#define ARSTREAM2_PCAP_DEFAULT_SNAP_LENGTH (65535)
+
+
+/**
+ * Maximum number of interfaces in a capture section
+ */
+#define ARSTREAM2_PCAP_MAX_INTERFACE_COUNT (16)
+
+
+/**
+ * @brief Capture channels.
+ *
+ * Each channel is written as a pcapng interface.
+ */
+typedef enum
+{
+    ARSTREAM2_PCAP_CHANNEL_STREAM = 0,      /**< RTP stream channel */
+    ARSTREAM2_PCAP_CHANNEL_CONTROL,         /**< RTCP control channel */
+    ARSTREAM2_PCAP_CHANNEL_MAX,
+
+} eARSTREAM2_PCAP_CHANNEL;
+
+
+/**
+ * @brief pcapng writer configuration.
+ */
+typedef struct ARSTREAM2_PcapWriter_Config_s
+{
+    ARSTREAM2_FileWriter_Config_t fileWriterConfig; /**< File writer configuration */
+    const char *applicationName;            /**< Name of the capturing application (optional, can be NULL) */
+    uint32_t srcAddr;                       /**< Source IPv4 address in network byte order (optional, can be 0) */
+    uint32_t dstAddr;                       /**< Destination IPv4 address in network byte order (optional, can be 0) */
+    uint16_t srcPort[ARSTREAM2_PCAP_CHANNEL_MAX];   /**< Source UDP port for each channel */
+    uint16_t dstPort[ARSTREAM2_PCAP_CHANNEL_MAX];   /**< Destination UDP port for each channel */
+    uint32_t snapLength;                    /**< Maximum captured packet size in bytes (optional, 0 for the default value) */
+
+} ARSTREAM2_PcapWriter_Config_t;
+
+
+/**
+ * @brief pcapng writer.
+ *
+ * The packets are written as IPv4 datagrams with synthesized IP and UDP
+ * headers in enhanced packet blocks with microsecond timestamps. The writes
+ * go through an asynchronous file writer so that capturing does not block
+ * the reception.
+ */
+typedef struct ARSTREAM2_PcapWriter_s
+{
+    ARSTREAM2_FileWriter_t *fileWriter;
+    uint32_t srcAddr;
+    uint32_t dstAddr;
+    uint16_t srcPort[ARSTREAM2_PCAP_CHANNEL_MAX];
+    uint16_t dstPort[ARSTREAM2_PCAP_CHANNEL_MAX];
+    uint32_t snapLength;
+    uint16_t ipId;
+    uint64_t packetCount;
+    uint64_t byteCount;
+
+} ARSTREAM2_PcapWriter_t;
+
+
+/**
+ * @brief pcapng reader interface.
+ */
+typedef struct ARSTREAM2_PcapReader_Interface_s
+{
+    uint16_t linkType;
+    uint64_t tsUnitsPerSecond;
+
+} ARSTREAM2_PcapReader_Interface_t;
+
+
+/**
+ * @brief pcapng reader.
+ *
+ * The file is mapped in memory; the UDP payloads of the IPv4 packets are
+ * returned without copy.
+ */
+typedef struct ARSTREAM2_PcapReader_s
+{
+    int fd;
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+    ARSTREAM2_PcapReader_Interface_t interface[ARSTREAM2_PCAP_MAX_INTERFACE_COUNT];
+    int interfaceCount;
+    uint64_t packetCount;
+    uint64_t skippedCount;
+
+} ARSTREAM2_PcapReader_t;
+
+
+/**
+ * @brief Create a pcapng writer.
+ *
+ * The section header and the interface description blocks are written
+ * immediately.
+ *
+ * @param[in] config Configuration
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_PcapWriter_t, or NULL if an error occured
+ */
+ARSTREAM2_PcapWriter_t* ARSTREAM2_PcapWriter_New(const ARSTREAM2_PcapWriter_Config_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Write a packet.
+ *
+ * The packet data is copied; packets larger than the snapshot length are truncated.
+ *
+ * @param writer The pcapng writer instance
+ * @param channel Channel on which the packet was received
+ * @param timestamp Reception timestamp in microseconds since the Unix epoch
+ * @param iov Packet data scatter array
+ * @param iovCount Number of elements in the scatter array
+ * @param size Packet size in bytes
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_PcapWriter_WritePacket(ARSTREAM2_PcapWriter_t *writer, eARSTREAM2_PCAP_CHANNEL channel, uint64_t timestamp,
+                                     const struct iovec *iov, int iovCount, size_t size);
+
+
+/**
+ * @brief Process the completed writes.
+ *
+ * The function should be called periodically when no packet is written.
+ *
+ * @param writer The pcapng writer instance
+ *
+ * @return 0 if no error occurred.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_PcapWriter_Poll(ARSTREAM2_PcapWriter_t *writer);
+
+
+/**
+ * @brief Delete a pcapng writer.
+ *
+ * The remaining data is written and the file is closed.
+ *
+ * @param writer Pointer to the pcapng writer instance pointer
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_PcapWriter_Delete(ARSTREAM2_PcapWriter_t **writer);
+
+
+/**
+ * @brief Create a pcapng reader.
+ *
+ * Only sections in the host byte order are supported. The supported link
+ * types are IPv4, raw IP, Ethernet and Linux cooked captures.
+ *
+ * @param[in] fileName Capture file name
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_PcapReader_t, or NULL if an error occured
+ */
+ARSTREAM2_PcapReader_t* ARSTREAM2_PcapReader_New(const char *fileName, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Read the next UDP packet.
+ *
+ * The non-UDP and fragmented packets are skipped. The channel is guessed from
+ * the payload (RTCP packet types are distinguished from RTP payload types as
+ * in RFC 5761) so that captures made by other tools can be read as well.
+ *
+ * @param reader The pcapng reader instance
+ * @param[out] channel Channel of the packet
+ * @param[out] timestamp Capture timestamp in microseconds
+ * @param[out] data Pointer to the UDP payload (valid until the reader is deleted)
+ * @param[out] size UDP payload size in bytes
+ *
+ * @return 1 if a packet was read.
+ * @return 0 at the end of the file.
+ * @return -1 if an error occurred.
+ */
+int ARSTREAM2_PcapReader_ReadPacket(ARSTREAM2_PcapReader_t *reader, eARSTREAM2_PCAP_CHANNEL *channel, uint64_t *timestamp,
+                                    const uint8_t **data, size_t *size);
+
+
+/**
+ * @brief Restart reading from the beginning of the file.
+ *
+ * @param reader The pcapng reader instance
+ */
+void ARSTREAM2_PcapReader_Rewind(ARSTREAM2_PcapReader_t *reader);
+
+
+/**
+ * @brief Delete a pcapng reader.
+ *
+ * @param reader Pointer to the pcapng reader instance pointer
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_PcapReader_Delete(ARSTREAM2_PcapReader_t **reader);
+
+
+#endif /* _ARSTREAM2_PCAP_H_ */
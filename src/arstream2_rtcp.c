@@ -744,6 +744,37 @@ int ARSTREAM2_RTCP_GetApplicationPacketSubtype(const uint8_t *buffer, unsigned i
 }
 
 
+int ARSTREAM2_RTCP_GetMediaSourceSsrc(const uint8_t *packet, unsigned int packetSize, uint32_t *ssrc)
+{
+    if ((!packet) || (!ssrc))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTCP_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    /* Compound packets always start with a SR or a RR (see RFC3550 section 6.1);
+     * no logging here, malformed packets are reported when processed */
+    if ((packetSize < 8) || (((*packet >> 6) & 0x3) != 2))
+    {
+        return -1;
+    }
+
+    if (*(packet + 1) == ARSTREAM2_RTCP_SENDER_REPORT_PACKET_TYPE)
+    {
+        *ssrc = ntohl(((const ARSTREAM2_RTCP_SenderReport_t*)packet)->ssrc);
+        return 0;
+    }
+    else if ((*(packet + 1) == ARSTREAM2_RTCP_RECEIVER_REPORT_PACKET_TYPE) && ((*packet & 0x1F) > 0)
+             && (packetSize >= sizeof(ARSTREAM2_RTCP_ReceiverReport_t) + sizeof(ARSTREAM2_RTCP_ReceptionReportBlock_t)))
+    {
+        *ssrc = ntohl(((const ARSTREAM2_RTCP_ReceptionReportBlock_t*)(packet + sizeof(ARSTREAM2_RTCP_ReceiverReport_t)))->ssrc);
+        return 0;
+    }
+
+    return -1;
+}
+
+
 int ARSTREAM2_RTCP_GenerateApplicationClockDelta(ARSTREAM2_RTCP_Application_t *app, ARSTREAM2_RTCP_ClockDelta_t *clockDelta,
                                                  uint64_t sendTimestamp, uint32_t ssrc,
                                                  ARSTREAM2_RTCP_ClockDeltaContext_t *context)
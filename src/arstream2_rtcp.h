@@ -297,6 +297,14 @@ int ARSTREAM2_RTCP_GetPacketType(const uint8_t *buffer, unsigned int bufferSize,
 
 int ARSTREAM2_RTCP_GetApplicationPacketSubtype(const uint8_t *buffer, unsigned int bufferSize);
 
+/**
+ * @brief Get the SSRC of the media source a compound RTCP packet relates to
+ * This is the sender SSRC of a leading SR, or the SSRC of the first reception report block of a leading RR.
+ *
+ * @return 0 on success, -1 if the packet does not start with a SR or a non-empty RR
+ */
+int ARSTREAM2_RTCP_GetMediaSourceSsrc(const uint8_t *packet, unsigned int packetSize, uint32_t *ssrc);
+
 int ARSTREAM2_RTCP_Sender_ProcessReceiverReport(const uint8_t *buffer, unsigned int bufferSize,
                                                 uint64_t receptionTimestamp,
                                                 ARSTREAM2_RTCP_SenderContext_t *context,
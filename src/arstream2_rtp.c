@@ -27,24 +27,24 @@ void ARSTREAM2_RTP_PacketReset(ARSTREAM2_RTP_Packet_t *packet)
         return;
     }
 
-    packet->inputTimestamp = 0;
+    packet->info->inputTimestamp = 0;
     packet->timeoutTimestamp = 0;
-    packet->ntpTimestamp = 0;
-    packet->ntpTimestampRaw = 0;
-    packet->ntpTimestampLocal = 0;
-    packet->extRtpTimestamp = 0;
+    packet->info->ntpTimestamp = 0;
+    packet->info->ntpTimestampRaw = 0;
+    packet->info->ntpTimestampLocal = 0;
+    packet->info->extRtpTimestamp = 0;
     packet->rtpTimestamp = 0;
     packet->seqNum = 0;
     packet->extSeqNum = 0;
     packet->markerBit = 0;
-    packet->header = NULL;
-    packet->headerExtension = NULL;
-    packet->headerExtensionSize = 0;
-    packet->payload = NULL;
-    packet->payloadSize = 0;
-    packet->importance = 0;
+    packet->info->header = NULL;
+    packet->info->headerExtension = NULL;
+    packet->info->headerExtensionSize = 0;
+    packet->info->payload = NULL;
+    packet->info->payloadSize = 0;
+    packet->info->importance = 0;
     packet->priority = 0;
-    packet->msgIovLength = 0;
+    packet->info->msgIovLength = 0;
 }
 
 
@@ -56,28 +56,21 @@ void ARSTREAM2_RTP_PacketCopy(ARSTREAM2_RTP_Packet_t *dst, const ARSTREAM2_RTP_P
     }
 
     dst->buffer = src->buffer;
-    dst->inputTimestamp = src->inputTimestamp;
     dst->timeoutTimestamp = src->timeoutTimestamp;
-    dst->ntpTimestamp = src->ntpTimestamp;
-    dst->ntpTimestampRaw = src->ntpTimestampRaw;
-    dst->ntpTimestampLocal = src->ntpTimestampLocal;
-    dst->extRtpTimestamp = src->extRtpTimestamp;
     dst->rtpTimestamp = src->rtpTimestamp;
     dst->seqNum = src->seqNum;
     dst->extSeqNum = src->extSeqNum;
     dst->markerBit = src->markerBit;
-    dst->header = src->header;
-    dst->headerExtension = src->headerExtension;
-    dst->headerExtensionSize = src->headerExtensionSize;
-    dst->payload = src->payload;
-    dst->payloadSize = src->payloadSize;
-    dst->importance = src->importance;
     dst->priority = src->priority;
-    dst->msgIovLength = src->msgIovLength;
+    if ((dst->info) && (src->info))
+    {
+        *dst->info = *src->info;
+    }
 }
 
 
-int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCount, int bufferMaxCount, int packetBufferSize)
+int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCount, int bufferMaxCount, int packetBufferSize,
+                                 int jumboBufferMaxCount, int jumboPacketBufferSize)
 {
     int i;
     ARSTREAM2_RTP_PacketFifoItem_t* curItem = NULL;
@@ -93,16 +86,24 @@ int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCo
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid item max count (%d)", itemMaxCount);
         return -1;
     }
-    if (bufferMaxCount <= 0)
+    if (bufferMaxCount < 0)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid buffer max count (%d)", bufferMaxCount);
         return -1;
     }
+    if ((jumboBufferMaxCount > 0) && (jumboPacketBufferSize <= packetBufferSize))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid jumbo buffer size (%d)", jumboPacketBufferSize);
+        return -1;
+    }
 
     memset(fifo, 0, sizeof(ARSTREAM2_RTP_PacketFifo_t));
 
     fifo->itemPoolSize = itemMaxCount;
-    fifo->itemPool = malloc(itemMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoItem_t));
+    if (posix_memalign((void**)&fifo->itemPool, ARSTREAM2_RTP_CACHE_LINE_SIZE, itemMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoItem_t)) != 0)
+    {
+        fifo->itemPool = NULL;
+    }
     if (!fifo->itemPool)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "FIFO allocation failed (size %zu)", itemMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoItem_t));
@@ -111,9 +112,19 @@ int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCo
     }
     memset(fifo->itemPool, 0, itemMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoItem_t));
 
+    fifo->itemInfoPool = malloc(itemMaxCount * sizeof(ARSTREAM2_RTP_PacketInfo_t));
+    if (!fifo->itemInfoPool)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "FIFO allocation failed (size %zu)", itemMaxCount * sizeof(ARSTREAM2_RTP_PacketInfo_t));
+        ARSTREAM2_RTP_PacketFifoFree(fifo);
+        return -1;
+    }
+    memset(fifo->itemInfoPool, 0, itemMaxCount * sizeof(ARSTREAM2_RTP_PacketInfo_t));
+
     for (i = 0; i < itemMaxCount; i++)
     {
         curItem = &fifo->itemPool[i];
+        curItem->packet.info = &fifo->itemInfoPool[i];
         if (fifo->itemFree)
         {
             fifo->itemFree->prev = curItem;
@@ -123,6 +134,12 @@ int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCo
         fifo->itemFree = curItem;
     }
 
+    if (bufferMaxCount == 0)
+    {
+        /* items-only FIFO */
+        return 0;
+    }
+
     fifo->bufferPoolSize = bufferMaxCount;
     fifo->bufferPool = malloc(bufferMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoBuffer_t));
     if (!fifo->bufferPool)
@@ -136,6 +153,7 @@ int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCo
     for (i = 0; i < bufferMaxCount; i++)
     {
         curBuffer = &fifo->bufferPool[i];
+        curBuffer->owner = fifo;
         if (fifo->bufferFree)
         {
             fifo->bufferFree->prev = curBuffer;
@@ -172,6 +190,53 @@ int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCo
         fifo->bufferPool[i].headerSize = sizeof(ARSTREAM2_RTP_Header_t);
     }
 
+    if (jumboBufferMaxCount > 0)
+    {
+        fifo->jumboBufferPoolSize = jumboBufferMaxCount;
+        fifo->jumboBufferPool = malloc(jumboBufferMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoBuffer_t));
+        if (!fifo->jumboBufferPool)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "FIFO allocation failed (size %zu)", jumboBufferMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoBuffer_t));
+            ARSTREAM2_RTP_PacketFifoFree(fifo);
+            return -1;
+        }
+        memset(fifo->jumboBufferPool, 0, jumboBufferMaxCount * sizeof(ARSTREAM2_RTP_PacketFifoBuffer_t));
+
+        for (i = 0; i < jumboBufferMaxCount; i++)
+        {
+            curBuffer = &fifo->jumboBufferPool[i];
+            curBuffer->isJumbo = 1;
+            curBuffer->owner = fifo;
+            if (fifo->jumboBufferFree)
+            {
+                fifo->jumboBufferFree->prev = curBuffer;
+            }
+            curBuffer->next = fifo->jumboBufferFree;
+            curBuffer->prev = NULL;
+            fifo->jumboBufferFree = curBuffer;
+        }
+
+        for (i = 0; i < jumboBufferMaxCount; i++)
+        {
+            fifo->jumboBufferPool[i].buffer = malloc(jumboPacketBufferSize);
+            if (!fifo->jumboBufferPool[i].buffer)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "FIFO jumbo packet buffer allocation failed (size %d)", jumboPacketBufferSize);
+                ARSTREAM2_RTP_PacketFifoFree(fifo);
+                return -1;
+            }
+            fifo->jumboBufferPool[i].bufferSize = jumboPacketBufferSize;
+            fifo->jumboBufferPool[i].header = malloc(sizeof(ARSTREAM2_RTP_Header_t));
+            if (!fifo->jumboBufferPool[i].header)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "FIFO packet buffer allocation failed (size %zu)", sizeof(ARSTREAM2_RTP_Header_t));
+                ARSTREAM2_RTP_PacketFifoFree(fifo);
+                return -1;
+            }
+            fifo->jumboBufferPool[i].headerSize = sizeof(ARSTREAM2_RTP_Header_t);
+        }
+    }
+
     return 0;
 }
 
@@ -187,6 +252,7 @@ int ARSTREAM2_RTP_PacketFifoFree(ARSTREAM2_RTP_PacketFifo_t *fifo)
     }
 
     free(fifo->itemPool);
+    free(fifo->itemInfoPool);
 
     if (fifo->bufferPool)
     {
@@ -201,6 +267,19 @@ int ARSTREAM2_RTP_PacketFifoFree(ARSTREAM2_RTP_PacketFifo_t *fifo)
         free(fifo->bufferPool);
     }
 
+    if (fifo->jumboBufferPool)
+    {
+        for (i = 0; i < fifo->jumboBufferPoolSize; i++)
+        {
+            free(fifo->jumboBufferPool[i].buffer);
+            fifo->jumboBufferPool[i].buffer = NULL;
+            free(fifo->jumboBufferPool[i].header);
+            fifo->jumboBufferPool[i].header = NULL;
+        }
+
+        free(fifo->jumboBufferPool);
+    }
+
     memset(fifo, 0, sizeof(ARSTREAM2_RTP_PacketFifo_t));
 
     return 0;
@@ -278,7 +357,7 @@ ARSTREAM2_RTP_PacketFifoBuffer_t* ARSTREAM2_RTP_PacketFifoGetBuffer(ARSTREAM2_RT
         if (cur->next) cur->next->prev = NULL;
         cur->prev = NULL;
         cur->next = NULL;
-        cur->refCount = 1;
+        __atomic_store_n(&cur->refCount, 1, __ATOMIC_RELAXED);
         return cur;
     }
     else
@@ -297,48 +376,113 @@ int ARSTREAM2_RTP_PacketFifoBufferAddRef(ARSTREAM2_RTP_PacketFifoBuffer_t *buffe
         return -1;
     }
 
-    buffer->refCount++;
+    __atomic_add_fetch(&buffer->refCount, 1, __ATOMIC_RELAXED);
 
     return 0;
 }
 
 
+static void ARSTREAM2_RTP_PacketFifoPushFreeBuffer(ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoBuffer_t *buffer)
+{
+    ARSTREAM2_RTP_PacketFifoBuffer_t **freeList = (buffer->isJumbo) ? &fifo->jumboBufferFree : &fifo->bufferFree;
+    if (*freeList)
+    {
+        (*freeList)->prev = buffer;
+        buffer->next = *freeList;
+    }
+    else
+    {
+        buffer->next = NULL;
+    }
+    *freeList = buffer;
+    buffer->prev = NULL;
+}
+
+
+static void ARSTREAM2_RTP_PacketFifoReclaimBuffers(ARSTREAM2_RTP_PacketFifo_t *fifo)
+{
+    ARSTREAM2_RTP_PacketFifoBuffer_t *buffer, *next;
+
+    if (!__atomic_load_n(&fifo->bufferReturn, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    /* move the buffers released by other threads back to the free lists */
+    for (buffer = __atomic_exchange_n(&fifo->bufferReturn, NULL, __ATOMIC_ACQUIRE); buffer; buffer = next)
+    {
+        next = buffer->next;
+        ARSTREAM2_RTP_PacketFifoPushFreeBuffer(fifo, buffer);
+    }
+}
+
+
 int ARSTREAM2_RTP_PacketFifoUnrefBuffer(ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoBuffer_t *buffer)
 {
+    unsigned int refCount;
+
     if ((!fifo) || (!buffer))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
         return -1;
     }
 
-    if (buffer->refCount != 0)
-    {
-        buffer->refCount--;
-    }
-    else
+    refCount = __atomic_load_n(&buffer->refCount, __ATOMIC_RELAXED);
+    do
     {
-        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_TAG, "FIXME! Ref count is already null, this should not happen!");
+        if (refCount == 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_TAG, "FIXME! Ref count is already null, this should not happen!");
+            return 0;
+        }
     }
+    while (!__atomic_compare_exchange_n(&buffer->refCount, &refCount, refCount - 1, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
 
-    if (buffer->refCount == 0)
+    if (refCount == 1)
     {
-        if (fifo->bufferFree)
+        ARSTREAM2_RTP_PacketFifo_t *owner = (buffer->owner) ? buffer->owner : fifo;
+        if (owner == fifo)
         {
-            fifo->bufferFree->prev = buffer;
-            buffer->next = fifo->bufferFree;
+            ARSTREAM2_RTP_PacketFifoPushFreeBuffer(fifo, buffer);
         }
         else
         {
-            buffer->next = NULL;
+            /* last reference released from another thread: return the buffer to its owner */
+            ARSTREAM2_RTP_PacketFifoBuffer_t *head = __atomic_load_n(&owner->bufferReturn, __ATOMIC_RELAXED);
+            buffer->prev = NULL;
+            do
+            {
+                buffer->next = head;
+            }
+            while (!__atomic_compare_exchange_n(&owner->bufferReturn, &head, buffer, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
         }
-        fifo->bufferFree = buffer;
-        buffer->prev = NULL;
     }
 
     return 0;
 }
 
 
+static void ARSTREAM2_RTP_PacketFifoTakeJumboBuffer(ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoBuffer_t *buffer)
+{
+    /* remove a given buffer from the jumbo free list */
+    if (buffer->prev)
+    {
+        buffer->prev->next = buffer->next;
+    }
+    else
+    {
+        fifo->jumboBufferFree = buffer->next;
+    }
+    if (buffer->next)
+    {
+        buffer->next->prev = buffer->prev;
+    }
+    buffer->prev = NULL;
+    buffer->next = NULL;
+    __atomic_store_n(&buffer->refCount, 1, __ATOMIC_RELAXED);
+}
+
+
 ARSTREAM2_RTP_PacketFifoItem_t* ARSTREAM2_RTP_PacketFifoPopFreeItem(ARSTREAM2_RTP_PacketFifo_t *fifo)
 {
     if (!fifo)
@@ -632,6 +776,150 @@ ARSTREAM2_RTP_PacketFifoItem_t* ARSTREAM2_RTP_PacketFifoDuplicateItem(ARSTREAM2_
 }
 
 
+int ARSTREAM2_RTP_PacketRingInit(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int size)
+{
+    unsigned int i;
+
+    if (!ring)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
+        return -1;
+    }
+    if ((size == 0) || (size > (1U << 31)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid ring size (%u)", size);
+        return -1;
+    }
+
+    memset(ring, 0, sizeof(ARSTREAM2_RTP_PacketRing_t));
+
+    /* round up to a power of 2 so that the free-running indexes can be masked */
+    for (ring->size = 1; ring->size < size; ring->size <<= 1);
+
+    ring->entry = malloc(ring->size * sizeof(ARSTREAM2_RTP_PacketRingEntry_t));
+    if (!ring->entry)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Ring allocation failed (size %zu)", ring->size * sizeof(ARSTREAM2_RTP_PacketRingEntry_t));
+        ring->size = 0;
+        return -1;
+    }
+    memset(ring->entry, 0, ring->size * sizeof(ARSTREAM2_RTP_PacketRingEntry_t));
+
+    for (i = 0; i < ring->size; i++)
+    {
+        ring->entry[i].packet.info = &ring->entry[i].info;
+    }
+
+    return 0;
+}
+
+
+int ARSTREAM2_RTP_PacketRingFree(ARSTREAM2_RTP_PacketRing_t *ring)
+{
+    if (!ring)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    free(ring->entry);
+    memset(ring, 0, sizeof(ARSTREAM2_RTP_PacketRing_t));
+
+    return 0;
+}
+
+
+int ARSTREAM2_RTP_PacketRingPush(ARSTREAM2_RTP_PacketRing_t *ring, const ARSTREAM2_RTP_PacketFifoItem_t *item)
+{
+    ARSTREAM2_RTP_PacketRingEntry_t *entry;
+    unsigned int head, tail;
+
+    if ((!ring) || (!item))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    head = ring->head;
+    tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= ring->size)
+    {
+        __atomic_add_fetch(&ring->dropCount, 1, __ATOMIC_RELAXED);
+        return -2;
+    }
+
+    entry = &ring->entry[head & (ring->size - 1)];
+    ARSTREAM2_RTP_PacketFifoBufferAddRef(item->packet.buffer);
+    ARSTREAM2_RTP_PacketCopy(&entry->packet, &item->packet);
+    entry->packet.buffer = item->packet.buffer;
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+
+int ARSTREAM2_RTP_PacketRingGetPending(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int *tail)
+{
+    unsigned int head;
+
+    if ((!ring) || (!tail))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    *tail = ring->tail;
+
+    return (int)(head - *tail);
+}
+
+
+ARSTREAM2_RTP_PacketRingEntry_t* ARSTREAM2_RTP_PacketRingGetEntry(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int index)
+{
+    return &ring->entry[index & (ring->size - 1)];
+}
+
+
+int ARSTREAM2_RTP_PacketRingRelease(ARSTREAM2_RTP_PacketRing_t *ring, ARSTREAM2_RTP_PacketFifo_t *fifo, unsigned int count)
+{
+    ARSTREAM2_RTP_PacketRingEntry_t *entry;
+    unsigned int tail, i;
+
+    if ((!ring) || (!fifo))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    for (i = 0, tail = ring->tail; i < count; i++, tail++)
+    {
+        entry = &ring->entry[tail & (ring->size - 1)];
+        ARSTREAM2_RTP_PacketFifoUnrefBuffer(fifo, entry->packet.buffer);
+        entry->packet.buffer = NULL;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+
+int ARSTREAM2_RTP_PacketRingFlush(ARSTREAM2_RTP_PacketRing_t *ring, ARSTREAM2_RTP_PacketFifo_t *fifo)
+{
+    unsigned int tail;
+    int count;
+
+    count = ARSTREAM2_RTP_PacketRingGetPending(ring, &tail);
+    if (count > 0)
+    {
+        ARSTREAM2_RTP_PacketRingRelease(ring, fifo, (unsigned int)count);
+    }
+
+    return count;
+}
+
+
 int ARSTREAM2_RTP_Sender_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifoQueue_t *queue, struct mmsghdr *msgVec, unsigned int msgVecCount, void *msgName, socklen_t msgNamelen)
 {
     ARSTREAM2_RTP_PacketFifoItem_t* cur = NULL;
@@ -659,7 +947,7 @@ int ARSTREAM2_RTP_Sender_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifoQueue_t *q
         msgVec[i].msg_hdr.msg_name = msgName;
         msgVec[i].msg_hdr.msg_namelen = msgNamelen;
         msgVec[i].msg_hdr.msg_iov = cur->packet.buffer->msgIov;
-        msgVec[i].msg_hdr.msg_iovlen = cur->packet.msgIovLength;
+        msgVec[i].msg_hdr.msg_iovlen = cur->packet.info->msgIovLength;
         msgVec[i].msg_hdr.msg_control = NULL;
         msgVec[i].msg_hdr.msg_controllen = 0;
         msgVec[i].msg_hdr.msg_flags = 0;
@@ -705,9 +993,9 @@ int ARSTREAM2_RTP_Sender_PacketFifoCleanFromMsgVec(ARSTREAM2_RTP_SenderContext_t
         /* call the monitoringCallback */
         if (context->monitoringCallback != NULL)
         {
-            context->monitoringCallback(cur->packet.inputTimestamp, curTime, cur->packet.ntpTimestamp, cur->packet.rtpTimestamp,
-                                        cur->packet.seqNum, cur->packet.markerBit, cur->packet.importance, cur->packet.priority,
-                                        cur->packet.payloadSize, 0, context->monitoringCallbackUserPtr);
+            context->monitoringCallback(cur->packet.info->inputTimestamp, curTime, cur->packet.info->ntpTimestamp, cur->packet.rtpTimestamp,
+                                        cur->packet.seqNum, cur->packet.markerBit, cur->packet.info->importance, cur->packet.priority,
+                                        cur->packet.info->payloadSize, 0, context->monitoringCallbackUserPtr);
         }
 
         if (cur->next)
@@ -782,17 +1070,17 @@ int ARSTREAM2_RTP_Sender_PacketFifoCleanFromTimeout(ARSTREAM2_RTP_SenderContext_
     {
         if ((cur->packet.timeoutTimestamp != 0) && (cur->packet.timeoutTimestamp <= curTime))
         {
-            if ((dropCount) && (cur->packet.importance < importanceLevelCount))
+            if ((dropCount) && (cur->packet.info->importance < importanceLevelCount))
             {
-                dropCount[cur->packet.importance]++;
+                dropCount[cur->packet.info->importance]++;
             }
 
             /* call the monitoringCallback */
             if (context->monitoringCallback != NULL)
             {
-                context->monitoringCallback(cur->packet.inputTimestamp, curTime, cur->packet.ntpTimestamp, cur->packet.rtpTimestamp, cur->packet.seqNum,
-                                            cur->packet.markerBit, cur->packet.importance, cur->packet.priority,
-                                            0, cur->packet.payloadSize, context->monitoringCallbackUserPtr);
+                context->monitoringCallback(cur->packet.info->inputTimestamp, curTime, cur->packet.info->ntpTimestamp, cur->packet.rtpTimestamp, cur->packet.seqNum,
+                                            cur->packet.markerBit, cur->packet.info->importance, cur->packet.priority,
+                                            0, cur->packet.info->payloadSize, context->monitoringCallbackUserPtr);
             }
 
             if (cur->next)
@@ -873,9 +1161,9 @@ int ARSTREAM2_RTP_Sender_PacketFifoRandomDrop(ARSTREAM2_RTP_SenderContext_t *con
             /* call the monitoringCallback */
             if (context->monitoringCallback != NULL)
             {
-                context->monitoringCallback(cur->packet.inputTimestamp, curTime, cur->packet.ntpTimestamp, cur->packet.rtpTimestamp, cur->packet.seqNum,
-                                            cur->packet.markerBit, cur->packet.importance, cur->packet.priority,
-                                            0, cur->packet.payloadSize, context->monitoringCallbackUserPtr);
+                context->monitoringCallback(cur->packet.info->inputTimestamp, curTime, cur->packet.info->ntpTimestamp, cur->packet.rtpTimestamp, cur->packet.seqNum,
+                                            cur->packet.markerBit, cur->packet.info->importance, cur->packet.priority,
+                                            0, cur->packet.info->payloadSize, context->monitoringCallbackUserPtr);
             }
 
             if (cur->next)
@@ -951,9 +1239,9 @@ int ARSTREAM2_RTP_Sender_PacketFifoFlushQueue(ARSTREAM2_RTP_SenderContext_t *con
             /* call the monitoringCallback */
             if (context->monitoringCallback != NULL)
             {
-                context->monitoringCallback(item->packet.inputTimestamp, curTime, item->packet.ntpTimestamp, item->packet.rtpTimestamp, item->packet.seqNum,
-                                            item->packet.markerBit, item->packet.importance, item->packet.priority,
-                                            0, item->packet.payloadSize, context->monitoringCallbackUserPtr);
+                context->monitoringCallback(item->packet.info->inputTimestamp, curTime, item->packet.info->ntpTimestamp, item->packet.rtpTimestamp, item->packet.seqNum,
+                                            item->packet.markerBit, item->packet.info->importance, item->packet.priority,
+                                            0, item->packet.info->payloadSize, context->monitoringCallbackUserPtr);
             }
 
             if (item->packet.buffer)
@@ -1012,9 +1300,9 @@ int ARSTREAM2_RTP_Sender_PacketFifoFlush(ARSTREAM2_RTP_SenderContext_t *context,
                 /* call the monitoringCallback */
                 if (context->monitoringCallback != NULL)
                 {
-                    context->monitoringCallback(item->packet.inputTimestamp, curTime, item->packet.ntpTimestamp, item->packet.rtpTimestamp, item->packet.seqNum,
-                                                item->packet.markerBit, item->packet.importance, item->packet.priority,
-                                                0, item->packet.payloadSize, context->monitoringCallbackUserPtr);
+                    context->monitoringCallback(item->packet.info->inputTimestamp, curTime, item->packet.info->ntpTimestamp, item->packet.rtpTimestamp, item->packet.seqNum,
+                                                item->packet.markerBit, item->packet.info->importance, item->packet.priority,
+                                                0, item->packet.info->payloadSize, context->monitoringCallbackUserPtr);
                 }
 
                 if (item->packet.buffer)
@@ -1063,26 +1351,26 @@ int ARSTREAM2_RTP_Sender_GeneratePacket(ARSTREAM2_RTP_SenderContext_t *context,
     }
 
     /* Timestamps and sequence number */
-    packet->inputTimestamp = inputTimestamp;
+    packet->info->inputTimestamp = inputTimestamp;
     packet->timeoutTimestamp = timeoutTimestamp;
-    packet->ntpTimestamp = ntpTimestamp;
+    packet->info->ntpTimestamp = ntpTimestamp;
     packet->rtpTimestamp = (ntpTimestamp * context->rtpClockRate + (uint64_t)context->rtpTimestampOffset + 500000) / 1000000;
     packet->seqNum = seqNum;
     packet->markerBit = markerBit;
-    packet->importance = importance;
+    packet->info->importance = importance;
     packet->priority = priority;
 
     /* Data */
     if ((headerExtension) && (headerExtensionSize > 0))
     {
-        packet->headerExtension = headerExtension;
-        packet->headerExtensionSize = headerExtensionSize;
+        packet->info->headerExtension = headerExtension;
+        packet->info->headerExtensionSize = headerExtensionSize;
     }
-    packet->payload = payload;
-    packet->payloadSize = payloadSize;
+    packet->info->payload = payload;
+    packet->info->payloadSize = payloadSize;
 
     /* Fill RTP packet header */
-    packet->header = (ARSTREAM2_RTP_Header_t*)packet->buffer->header;
+    packet->info->header = (ARSTREAM2_RTP_Header_t*)packet->buffer->header;
     flags = 0x8060; /* with PT=96 */
     if (headerExtensionSize > 0)
     {
@@ -1094,25 +1382,25 @@ int ARSTREAM2_RTP_Sender_GeneratePacket(ARSTREAM2_RTP_SenderContext_t *context,
         /* set the marker bit */
         flags |= (1 << 7);
     }
-    packet->header->flags = htons(flags);
-    packet->header->seqNum = htons(seqNum);
-    packet->header->timestamp = htonl(packet->rtpTimestamp);
-    packet->header->ssrc = htonl(context->senderSsrc);
+    packet->info->header->flags = htons(flags);
+    packet->info->header->seqNum = htons(seqNum);
+    packet->info->header->timestamp = htonl(packet->rtpTimestamp);
+    packet->info->header->ssrc = htonl(context->senderSsrc);
 
     /* Fill the IOV array */
-    packet->msgIovLength = 0;
-    packet->buffer->msgIov[packet->msgIovLength].iov_base = (void*)packet->header;
-    packet->buffer->msgIov[packet->msgIovLength].iov_len = (size_t)sizeof(ARSTREAM2_RTP_Header_t);
-    packet->msgIovLength++;
+    packet->info->msgIovLength = 0;
+    packet->buffer->msgIov[packet->info->msgIovLength].iov_base = (void*)packet->info->header;
+    packet->buffer->msgIov[packet->info->msgIovLength].iov_len = (size_t)sizeof(ARSTREAM2_RTP_Header_t);
+    packet->info->msgIovLength++;
     if (headerExtensionSize > 0)
     {
-        packet->buffer->msgIov[packet->msgIovLength].iov_base = (void*)packet->headerExtension;
-        packet->buffer->msgIov[packet->msgIovLength].iov_len = (size_t)headerExtensionSize;
-        packet->msgIovLength++;
+        packet->buffer->msgIov[packet->info->msgIovLength].iov_base = (void*)packet->info->headerExtension;
+        packet->buffer->msgIov[packet->info->msgIovLength].iov_len = (size_t)headerExtensionSize;
+        packet->info->msgIovLength++;
     }
-    packet->buffer->msgIov[packet->msgIovLength].iov_base = (void*)packet->payload;
-    packet->buffer->msgIov[packet->msgIovLength].iov_len = (size_t)payloadSize;
-    packet->msgIovLength++;
+    packet->buffer->msgIov[packet->info->msgIovLength].iov_base = (void*)packet->info->payload;
+    packet->buffer->msgIov[packet->info->msgIovLength].iov_len = (size_t)payloadSize;
+    packet->info->msgIovLength++;
 
     return 0;
 }
@@ -1123,6 +1411,7 @@ int ARSTREAM2_RTP_Sender_GeneratePacket(ARSTREAM2_RTP_SenderContext_t *context,
 int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo, struct mmsghdr *msgVec, unsigned int msgVecCount)
 {
     ARSTREAM2_RTP_PacketFifoBuffer_t* cur = NULL;
+    ARSTREAM2_RTP_PacketFifoBuffer_t* jumbo = NULL;
     unsigned int i;
 
     if (!fifo)
@@ -1131,6 +1420,8 @@ int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo
         return -1;
     }
 
+    ARSTREAM2_RTP_PacketFifoReclaimBuffers(fifo);
+
     if (!fifo->bufferFree)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Packet FIFO is full => flush to recover");
@@ -1145,8 +1436,15 @@ int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo
         }
     }
 
-    for (cur = fifo->bufferFree, i = 0; ((cur) && (i < msgVecCount)); cur = cur->next, i++)
+    for (cur = fifo->bufferFree, jumbo = fifo->jumboBufferFree, i = 0; ((cur) && (i < msgVecCount)); cur = cur->next, i++)
     {
+        if ((fifo->jumboPacketCountdown > 0) && (!jumbo) && (i > 0))
+        {
+            /* jumbo packets have been received recently: only receive as many
+               packets as there are free jumbo buffers to avoid truncation */
+            break;
+        }
+
         /* RTP header */
         cur->msgIov[0].iov_base = cur->header;
         cur->msgIov[0].iov_len = cur->headerSize;
@@ -1155,10 +1453,20 @@ int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo
         cur->msgIov[1].iov_base = cur->buffer;
         cur->msgIov[1].iov_len = cur->bufferSize;
 
+        /* Spill to a jumbo buffer for oversized datagrams (the first bufferSize bytes
+           of the jumbo buffer are left free to copy the beginning of the payload) */
+        cur->spill = jumbo;
+        if (jumbo)
+        {
+            cur->msgIov[2].iov_base = jumbo->buffer + cur->bufferSize;
+            cur->msgIov[2].iov_len = jumbo->bufferSize - cur->bufferSize;
+            jumbo = jumbo->next;
+        }
+
         msgVec[i].msg_hdr.msg_name = NULL;
         msgVec[i].msg_hdr.msg_namelen = 0;
         msgVec[i].msg_hdr.msg_iov = cur->msgIov;
-        msgVec[i].msg_hdr.msg_iovlen = 2;
+        msgVec[i].msg_hdr.msg_iovlen = (cur->spill) ? 3 : 2;
         msgVec[i].msg_hdr.msg_control = NULL;
         msgVec[i].msg_hdr.msg_controllen = 0;
         msgVec[i].msg_hdr.msg_flags = 0;
@@ -1169,88 +1477,19 @@ int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo
 }
 
 
-static int ARSTREAM2_RTP_Receiver_PacketFifoResendEnqueue(ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoQueue_t *queue, ARSTREAM2_RTP_PacketFifoItem_t *item, uint64_t curTime, uint32_t timeout)
-{
-    int err = 0, ret = 0, needUnref = 0, needFree = 0;
-    ARSTREAM2_RTP_PacketFifoItem_t *resendItem = NULL;
-
-    /* add ref to packet buffer */
-    ret = ARSTREAM2_RTP_PacketFifoBufferAddRef(item->packet.buffer);
-    if (ret < 0)
-    {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "ARSTREAM2_RTP_PacketFifoBufferAddRef() failed (%d)", ret);
-    }
-    if (ret == 0)
-    {
-        /* duplicate the packet item */
-        resendItem = ARSTREAM2_RTP_PacketFifoDuplicateItem(fifo, item);
-        if (resendItem)
-        {
-            ARSTREAM2_RTP_Packet_t *packet = &resendItem->packet;
-            packet->buffer = item->packet.buffer;
-            packet->timeoutTimestamp = curTime + timeout; //TODO: compute the expected arrival time
-        }
-        else
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Failed to pop free item from the packet FIFO");
-            ret = -1;
-            needUnref = 1;
-        }
-    }
-
-    if ((ret == 0) && (resendItem))
-    {
-        /* enqueue the AU */
-        ret = ARSTREAM2_RTP_PacketFifoEnqueueItem(queue, resendItem);
-        if (ret < 0)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "ARSTREAM2_RTP_PacketFifoEnqueueItem() failed (%d)", ret);
-            err = -1;
-            needUnref = 1;
-            needFree = 1;
-        }
-    }
-    else
-    {
-        err = -1;
-    }
-
-    /* error handling */
-    if (needFree)
-    {
-        ret = ARSTREAM2_RTP_PacketFifoPushFreeItem(fifo, resendItem);
-        if (ret != 0)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Failed to push free item in the packet FIFO (%d)", ret);
-        }
-        needFree = 0;
-    }
-    if (needUnref)
-    {
-        ret = ARSTREAM2_RTP_PacketFifoUnrefBuffer(fifo, item->packet.buffer);
-        if (ret != 0)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Failed to unref buffer (%d)", ret);
-        }
-        needUnref = 0;
-    }
-
-    return err;
-}
-
-
 /* WARNING: the call sequence ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec -> recvmmsg -> ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec
    must not be broken (no change made to the free items list) */
 int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext_t *context,
                                                    ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoQueue_t *queue,
-                                                   ARSTREAM2_RTP_PacketFifoQueue_t **resendQueue, uint32_t *resendTimeout, unsigned int resendCount,
+                                                   ARSTREAM2_RTP_PacketRing_t **resendRing, unsigned int resendCount,
                                                    struct mmsghdr *msgVec, unsigned int msgVecCount, uint64_t curTime,
                                                    ARSTREAM2_RTCP_ReceiverContext_t *rtcpContext)
 {
     ARSTREAM2_RTP_PacketFifoItem_t* item = NULL;
     ARSTREAM2_RTP_PacketFifoBuffer_t *buffer = NULL;
     ARSTREAM2_RTP_PacketFifoItem_t* garbage = NULL;
-    int ret = 0, resendRet, garbageCount = 0, garbageCount2 = 0;
+    ARSTREAM2_RTP_PacketFifoBuffer_t *spilled = NULL;
+    int ret = 0, garbageCount = 0, garbageCount2 = 0;
     unsigned int i, k, popCount = 0, enqueueCount = 0;
 
     if ((!context) || (!fifo) || (!rtcpContext))
@@ -1259,9 +1498,9 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
         return -1;
     }
 
-    if ((resendCount > 0) && (!resendQueue))
+    if ((resendCount > 0) && (!resendRing))
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid resend queue list");
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Invalid resend ring list");
         return -1;
     }
 
@@ -1282,16 +1521,43 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
             ARSTREAM2_RTP_PacketReset(&item->packet);
             item->packet.buffer = buffer;
             popCount++;
-            if (msgVec[i].msg_len > sizeof(ARSTREAM2_RTP_Header_t))
+            if (msgVec[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_TAG, "Truncated RTP packet received (%d bytes)", msgVec[i].msg_len);
+                fifo->jumboPacketCountdown = ARSTREAM2_RTP_JUMBO_MODE_PACKET_COUNT;
+            }
+            else if (fifo->jumboPacketCountdown > 0)
+            {
+                fifo->jumboPacketCountdown--;
+            }
+            if ((msgVec[i].msg_len > sizeof(ARSTREAM2_RTP_Header_t)) && (!(msgVec[i].msg_hdr.msg_flags & MSG_TRUNC)))
             {
                 uint16_t flags;
                 int seqNumDelta = 0;
 
-                item->packet.header = (ARSTREAM2_RTP_Header_t*)item->packet.buffer->header;
-                item->packet.inputTimestamp = curTime;
-                item->packet.rtpTimestamp = ntohl(item->packet.header->timestamp);
-                item->packet.seqNum = ntohs(item->packet.header->seqNum);
-                item->packet.importance = 0; //TODO: how to get this value on the receiver side for resenders?
+                if ((msgVec[i].msg_len > sizeof(ARSTREAM2_RTP_Header_t) + buffer->bufferSize) && (buffer->spill))
+                {
+                    /* the datagram spilled into the jumbo buffer: move the packet to the jumbo buffer */
+                    ARSTREAM2_RTP_PacketFifoBuffer_t *jumbo = buffer->spill;
+                    ARSTREAM2_RTP_PacketFifoTakeJumboBuffer(fifo, jumbo);
+                    memcpy(jumbo->header, buffer->header, sizeof(ARSTREAM2_RTP_Header_t));
+                    memcpy(jumbo->buffer, buffer->buffer, buffer->bufferSize);
+                    jumbo->msgIov[0].iov_base = jumbo->header;
+                    jumbo->msgIov[1].iov_base = jumbo->buffer;
+                    item->packet.buffer = jumbo;
+
+                    /* the MTU-sized buffer is released after the loop to keep the free list unchanged */
+                    buffer->prev = NULL;
+                    buffer->next = spilled;
+                    spilled = buffer;
+                    fifo->jumboPacketCountdown = ARSTREAM2_RTP_JUMBO_MODE_PACKET_COUNT;
+                }
+
+                item->packet.info->header = (ARSTREAM2_RTP_Header_t*)item->packet.buffer->header;
+                item->packet.info->inputTimestamp = curTime;
+                item->packet.rtpTimestamp = ntohl(item->packet.info->header->timestamp);
+                item->packet.seqNum = ntohs(item->packet.info->header->seqNum);
+                item->packet.info->importance = 0; //TODO: how to get this value on the receiver side for resenders?
                 item->packet.priority = 0; //TODO: how to get this value on the receiver side for resenders?
                 if (context->previousExtSeqNum != -1)
                 {
@@ -1310,39 +1576,39 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
                         context->extHighestSeqNum = item->packet.extSeqNum;
                         rtcpContext->extHighestSeqNum = context->extHighestSeqNum;
                     }
-                    item->packet.extRtpTimestamp = (context->extHighestRtpTimestamp & 0xFFFFFFFF00000000ULL) | ((uint64_t)item->packet.rtpTimestamp & 0xFFFFFFFFULL);
-                    if ((int64_t)item->packet.extRtpTimestamp - (int64_t)context->previousExtRtpTimestamp < -2147483648LL)
+                    item->packet.info->extRtpTimestamp = (context->extHighestRtpTimestamp & 0xFFFFFFFF00000000ULL) | ((uint64_t)item->packet.rtpTimestamp & 0xFFFFFFFFULL);
+                    if ((int64_t)item->packet.info->extRtpTimestamp - (int64_t)context->previousExtRtpTimestamp < -2147483648LL)
                     {
-                        item->packet.extRtpTimestamp += 0x100000000ULL;
+                        item->packet.info->extRtpTimestamp += 0x100000000ULL;
                     }
-                    else if ((int64_t)item->packet.extRtpTimestamp - (int64_t)context->previousExtRtpTimestamp > 2147483648LL)
+                    else if ((int64_t)item->packet.info->extRtpTimestamp - (int64_t)context->previousExtRtpTimestamp > 2147483648LL)
                     {
-                        item->packet.extRtpTimestamp -= 0x100000000ULL;
+                        item->packet.info->extRtpTimestamp -= 0x100000000ULL;
                     }
-                    if (item->packet.extRtpTimestamp > context->extHighestRtpTimestamp)
+                    if (item->packet.info->extRtpTimestamp > context->extHighestRtpTimestamp)
                     {
-                        context->extHighestRtpTimestamp = item->packet.extRtpTimestamp;
+                        context->extHighestRtpTimestamp = item->packet.info->extRtpTimestamp;
                     }
                 }
                 else
                 {
                     /* first packet received */
                     item->packet.extSeqNum = item->packet.seqNum;
-                    item->packet.extRtpTimestamp = item->packet.rtpTimestamp;
+                    item->packet.info->extRtpTimestamp = item->packet.rtpTimestamp;
                     context->extHighestSeqNum = item->packet.extSeqNum;
-                    context->extHighestRtpTimestamp = item->packet.extRtpTimestamp;
+                    context->extHighestRtpTimestamp = item->packet.info->extRtpTimestamp;
                     context->previousRecvRtpTimestamp = recvRtpTimestamp;
-                    context->previousExtRtpTimestamp = item->packet.extRtpTimestamp;
+                    context->previousExtRtpTimestamp = item->packet.info->extRtpTimestamp;
                     context->firstRecvRtpTimestamp = recvRtpTimestamp;
-                    context->firstExtRtpTimestamp = item->packet.extRtpTimestamp;
-                    rtcpContext->senderSsrc = ntohl(item->packet.header->ssrc);
+                    context->firstExtRtpTimestamp = item->packet.info->extRtpTimestamp;
+                    rtcpContext->senderSsrc = ntohl(item->packet.info->header->ssrc);
                     rtcpContext->firstSeqNum = item->packet.seqNum;
                     rtcpContext->extHighestSeqNum = context->extHighestSeqNum;
                     rtcpContext->packetsReceived = 0;
                     rtcpContext->packetsLost = 0;
                 }
                 context->previousExtSeqNum = (int32_t)item->packet.extSeqNum;
-                flags = ntohs(item->packet.header->flags);
+                flags = ntohs(item->packet.info->header->flags);
                 if (flags & (1 << 7))
                 {
                     /* the marker bit is set */
@@ -1351,20 +1617,20 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
                 if (flags & (1 << 12))
                 {
                     /* the extention bit is set */
-                    item->packet.headerExtension = item->packet.buffer->buffer;
-                    uint16_t length = ntohs(*((uint16_t*)(item->packet.headerExtension + 2)));
-                    item->packet.headerExtensionSize = length * 4 + 4;
+                    item->packet.info->headerExtension = item->packet.buffer->buffer;
+                    uint16_t length = ntohs(*((uint16_t*)(item->packet.info->headerExtension + 2)));
+                    item->packet.info->headerExtensionSize = length * 4 + 4;
                 }
                 else
                 {
-                    item->packet.headerExtension = NULL;
-                    item->packet.headerExtensionSize = 0;
+                    item->packet.info->headerExtension = NULL;
+                    item->packet.info->headerExtensionSize = 0;
                 }
-                item->packet.payload = item->packet.buffer->buffer + item->packet.headerExtensionSize;
-                item->packet.payloadSize = msgVec[i].msg_len - sizeof(ARSTREAM2_RTP_Header_t) - item->packet.headerExtensionSize;
+                item->packet.info->payload = item->packet.buffer->buffer + item->packet.info->headerExtensionSize;
+                item->packet.info->payloadSize = msgVec[i].msg_len - sizeof(ARSTREAM2_RTP_Header_t) - item->packet.info->headerExtensionSize;
                 item->packet.buffer->msgIov[0].iov_len = sizeof(ARSTREAM2_RTP_Header_t);
-                item->packet.buffer->msgIov[1].iov_len = item->packet.headerExtensionSize + item->packet.payloadSize;
-                item->packet.msgIovLength = 2;
+                item->packet.buffer->msgIov[1].iov_len = item->packet.info->headerExtensionSize + item->packet.info->payloadSize;
+                item->packet.info->msgIovLength = 2;
 
                 ret = ARSTREAM2_RTP_PacketFifoEnqueueItemOrderedBySeqNum(queue, item);
                 if (ret < 0)
@@ -1400,11 +1666,11 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
                 }
                 else
                 {
-                    if ((recvRtpTimestamp != context->previousRecvRtpTimestamp) && (item->packet.extRtpTimestamp != context->previousExtRtpTimestamp))
+                    if ((recvRtpTimestamp != context->previousRecvRtpTimestamp) && (item->packet.info->extRtpTimestamp != context->previousExtRtpTimestamp))
                     {
                         /* clock skew computation */
                         int64_t clockSkew = ((int64_t)recvRtpTimestamp - (int64_t)context->firstRecvRtpTimestamp)
-                                            - ((int64_t)item->packet.extRtpTimestamp - (int64_t)context->firstExtRtpTimestamp);
+                                            - ((int64_t)item->packet.info->extRtpTimestamp - (int64_t)context->firstExtRtpTimestamp);
 
                         /* initialize the window */
                         if (context->clockSkewWindowSize == 0)
@@ -1454,38 +1720,40 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
 
                     /* interarrival jitter computation */
                     int64_t d = ((int64_t)context->previousRecvRtpTimestamp - (int64_t)context->previousExtRtpTimestamp)
-                                - ((int64_t)recvRtpTimestamp - (int64_t)item->packet.extRtpTimestamp);
+                                - ((int64_t)recvRtpTimestamp - (int64_t)item->packet.info->extRtpTimestamp);
                     if (d < 0) d = -d;
                     rtcpContext->interarrivalJitter = (uint32_t)((int64_t)rtcpContext->interarrivalJitter
                                                       + (d - (int64_t)rtcpContext->interarrivalJitter) / 16);
 
                     context->previousRecvRtpTimestamp = recvRtpTimestamp;
-                    context->previousExtRtpTimestamp = item->packet.extRtpTimestamp;
+                    context->previousExtRtpTimestamp = item->packet.info->extRtpTimestamp;
                     enqueueCount++;
                 }
-                item->packet.ntpTimestampRaw = (item->packet.extRtpTimestamp * 1000000 + context->rtpClockRate / 2) / context->rtpClockRate;
-                item->packet.ntpTimestampRawUnskewed = ((int64_t)item->packet.ntpTimestampRaw + context->clockSkew >= 0) ? item->packet.ntpTimestampRaw + context->clockSkew : 0;
-                item->packet.ntpTimestamp = ARSTREAM2_RTCP_Receiver_GetNtpTimestampFromRtpTimestamp(rtcpContext, item->packet.rtpTimestamp);
-                item->packet.ntpTimestampUnskewed = ((int64_t)item->packet.ntpTimestamp + context->clockSkew >= 0) ? item->packet.ntpTimestamp + context->clockSkew : 0;
-                item->packet.ntpTimestampLocal = ((rtcpContext->clockDeltaCtx.clockDeltaAvg != 0) && (item->packet.ntpTimestamp != 0)) ? (item->packet.ntpTimestamp - rtcpContext->clockDeltaCtx.clockDeltaAvg) : 0;
+                item->packet.info->ntpTimestampRaw = (item->packet.info->extRtpTimestamp * 1000000 + context->rtpClockRate / 2) / context->rtpClockRate;
+                item->packet.info->ntpTimestampRawUnskewed = ((int64_t)item->packet.info->ntpTimestampRaw + context->clockSkew >= 0) ? item->packet.info->ntpTimestampRaw + context->clockSkew : 0;
+                item->packet.info->ntpTimestamp = ARSTREAM2_RTCP_Receiver_GetNtpTimestampFromRtpTimestamp(rtcpContext, item->packet.rtpTimestamp);
+                item->packet.info->ntpTimestampUnskewed = ((int64_t)item->packet.info->ntpTimestamp + context->clockSkew >= 0) ? item->packet.info->ntpTimestamp + context->clockSkew : 0;
+                item->packet.info->ntpTimestampLocal = ((rtcpContext->clockDeltaCtx.clockDeltaAvg != 0) && (item->packet.info->ntpTimestamp != 0)) ? (item->packet.info->ntpTimestamp - rtcpContext->clockDeltaCtx.clockDeltaAvg) : 0;
                 item->packet.timeoutTimestamp = curTime + context->nominalDelay; //TODO: compute the expected arrival time
 
                 if (ret >= 0)
                 {
+                    /* hand over a reference to the resender threads; a full ring drops
+                       the packet for that resender only (counted in the ring) */
                     for (k = 0; k < resendCount; k++)
                     {
-                        resendRet = ARSTREAM2_RTP_Receiver_PacketFifoResendEnqueue(fifo, resendQueue[k], item, curTime, resendTimeout[k]);
-                        if (resendRet != 0)
-                        {
-                            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Failed to enqueue packet into resend queue #%d (%d)", k, resendRet);
-                        }
+                        ARSTREAM2_RTP_PacketRingPush(resendRing[k], item);
                     }
                 }
             }
             else
             {
-                /* invalid payload, flag the item for garbage collection */
-                rtcpContext->packetsLost++;
+                /* invalid payload, flag the item for garbage collection;
+                 * empty messages were handed over to another receiver sharing the socket */
+                if (msgVec[i].msg_len > 0)
+                {
+                    rtcpContext->packetsLost++;
+                }
                 garbageCount++;
                 if (!garbage)
                 {
@@ -1527,6 +1795,16 @@ int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext
         }
         garbage = next;
     }
+    while (spilled)
+    {
+        ARSTREAM2_RTP_PacketFifoBuffer_t* next = spilled->next;
+        int spilledRet = ARSTREAM2_RTP_PacketFifoUnrefBuffer(fifo, spilled);
+        if (spilledRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "ARSTREAM2_RTP_PacketFifoUnrefBuffer() failed (%d)", spilledRet);
+        }
+        spilled = next;
+    }
     if (garbageCount != garbageCount2)
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_TAG, "Garbage count mismatch: %d vs. %d", garbageCount, garbageCount2);
@@ -58,6 +58,13 @@ typedef struct {
 #define ARSTREAM2_RTP_TOTAL_HEADERS_SIZE (sizeof(ARSTREAM2_RTP_Header_t) + ARSTREAM2_RTP_UDP_HEADER_SIZE + ARSTREAM2_RTP_IP_HEADER_SIZE)
 #define ARSTREAM2_RTP_MAX_PAYLOAD_SIZE (0xFFFF - ARSTREAM2_RTP_TOTAL_HEADERS_SIZE)
 
+#define ARSTREAM2_RTP_MTU (1500)
+#define ARSTREAM2_RTP_MTU_PAYLOAD_SIZE (ARSTREAM2_RTP_MTU - ARSTREAM2_RTP_TOTAL_HEADERS_SIZE)
+#define ARSTREAM2_RTP_JUMBO_MODE_PACKET_COUNT (1000)
+
+/* Alignment of the packet FIFO items */
+#define ARSTREAM2_RTP_CACHE_LINE_SIZE (64)
+
 
 /**
  * @brief Source description item
@@ -92,8 +99,13 @@ typedef struct ARSTREAM2_RTP_PacketFifoBuffer_s
     uint8_t *header;
     unsigned int headerSize;
     struct iovec msgIov[3];
+    int isJumbo;
+    struct ARSTREAM2_RTP_PacketFifoBuffer_s* spill;
 
+    /* the reference count is atomic: the last reference can be released
+       from another thread, the buffer then goes back to its owner FIFO */
     unsigned int refCount;
+    struct ARSTREAM2_RTP_PacketFifo_s* owner;
     struct ARSTREAM2_RTP_PacketFifoBuffer_s* prev;
     struct ARSTREAM2_RTP_PacketFifoBuffer_s* next;
 
@@ -101,32 +113,47 @@ typedef struct ARSTREAM2_RTP_PacketFifoBuffer_s
 
 
 /**
- * @brief RTP packet data
+ * @brief RTP packet info (cold data)
  */
-typedef struct ARSTREAM2_RTP_Packet_s
+typedef struct ARSTREAM2_RTP_PacketInfo_s
 {
-    ARSTREAM2_RTP_PacketFifoBuffer_t *buffer;
     uint64_t inputTimestamp;
-    uint64_t timeoutTimestamp;
     uint64_t ntpTimestamp;
     uint64_t ntpTimestampUnskewed;
     uint64_t ntpTimestampRaw;
     uint64_t ntpTimestampRawUnskewed;
     uint64_t ntpTimestampLocal;
     uint64_t extRtpTimestamp;
-    uint32_t rtpTimestamp;
-    uint16_t seqNum;
-    uint32_t extSeqNum;
-    uint32_t markerBit;
     ARSTREAM2_RTP_Header_t *header;
     uint8_t *headerExtension;
     unsigned int headerExtensionSize;
     uint8_t *payload;
     unsigned int payloadSize;
     uint32_t importance;
-    uint32_t priority;
     size_t msgIovLength;
 
+} ARSTREAM2_RTP_PacketInfo_t;
+
+
+/**
+ * @brief RTP packet data
+ *
+ * Only the fields used when walking the FIFO queues (ordered insertion,
+ * timeout cleaning, depayloading lookahead) are stored here so that an
+ * item fits in a single cache line; the rest of the packet data is in
+ * the info side table which is bound to the FIFO item.
+ */
+typedef struct ARSTREAM2_RTP_Packet_s
+{
+    ARSTREAM2_RTP_PacketFifoBuffer_t *buffer;
+    ARSTREAM2_RTP_PacketInfo_t *info;
+    uint64_t timeoutTimestamp;
+    uint32_t rtpTimestamp;
+    uint32_t extSeqNum;
+    uint32_t priority;
+    uint16_t seqNum;
+    uint16_t markerBit;
+
 } ARSTREAM2_RTP_Packet_t;
 
 
@@ -140,7 +167,7 @@ typedef struct ARSTREAM2_RTP_PacketFifoItem_s
     struct ARSTREAM2_RTP_PacketFifoItem_s* prev;
     struct ARSTREAM2_RTP_PacketFifoItem_s* next;
 
-} ARSTREAM2_RTP_PacketFifoItem_t;
+} __attribute__ ((aligned (ARSTREAM2_RTP_CACHE_LINE_SIZE))) ARSTREAM2_RTP_PacketFifoItem_t;
 
 
 /**
@@ -167,14 +194,54 @@ typedef struct ARSTREAM2_RTP_PacketFifo_s
     ARSTREAM2_RTP_PacketFifoQueue_t *queue;
     int itemPoolSize;
     ARSTREAM2_RTP_PacketFifoItem_t *itemPool;
+    ARSTREAM2_RTP_PacketInfo_t *itemInfoPool;
     ARSTREAM2_RTP_PacketFifoItem_t *itemFree;
     int bufferPoolSize;
     ARSTREAM2_RTP_PacketFifoBuffer_t *bufferPool;
     ARSTREAM2_RTP_PacketFifoBuffer_t *bufferFree;
+    int jumboBufferPoolSize;
+    ARSTREAM2_RTP_PacketFifoBuffer_t *jumboBufferPool;
+    ARSTREAM2_RTP_PacketFifoBuffer_t *jumboBufferFree;
+    int jumboPacketCountdown;
+
+    /* buffers released from other threads (lock-free stack), moved
+       back to the free lists by the owner thread */
+    ARSTREAM2_RTP_PacketFifoBuffer_t *bufferReturn;
 
 } ARSTREAM2_RTP_PacketFifo_t;
 
 
+/**
+ * @brief RTP packet ring entry
+ */
+typedef struct ARSTREAM2_RTP_PacketRingEntry_s
+{
+    ARSTREAM2_RTP_Packet_t packet;
+    ARSTREAM2_RTP_PacketInfo_t info;
+
+} ARSTREAM2_RTP_PacketRingEntry_t;
+
+
+/**
+ * @brief RTP packet ring
+ *
+ * Lock-free single producer / single consumer ring used to hand over
+ * packet references to another thread. Each entry holds a reference on
+ * the packet buffer, which stays owned by the producer packet FIFO.
+ */
+typedef struct ARSTREAM2_RTP_PacketRing_s
+{
+    unsigned int size;
+    ARSTREAM2_RTP_PacketRingEntry_t *entry;
+    unsigned int dropCount;
+
+    /* producer and consumer indexes in separate cache lines */
+    unsigned int head __attribute__ ((aligned (ARSTREAM2_RTP_CACHE_LINE_SIZE)));
+    unsigned int tail __attribute__ ((aligned (ARSTREAM2_RTP_CACHE_LINE_SIZE)));
+
+} ARSTREAM2_RTP_PacketRing_t;
+
+
 typedef void (*ARSTREAM2_RTP_SenderMonitoringCallback_t)(uint64_t inputTimestamp, uint64_t outputTimestamp,
                                                          uint64_t ntpTimestamp, uint32_t rtpTimestamp,
                                                          uint16_t seqNum, uint16_t markerBit,
@@ -261,7 +328,12 @@ void ARSTREAM2_RTP_PacketReset(ARSTREAM2_RTP_Packet_t *packet);
 
 void ARSTREAM2_RTP_PacketCopy(ARSTREAM2_RTP_Packet_t *dst, const ARSTREAM2_RTP_Packet_t *src);
 
-int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCount, int bufferMaxCount, int packetBufferSize);
+/* The jumbo buffer pool is optional (jumboBufferMaxCount = 0): on the receiver side, when the packet buffers
+   are MTU-sized, jumbo buffers are used as spill buffers for the (rare) datagrams that do not fit;
+   the buffer pool is also optional (bufferMaxCount = 0) for a FIFO that only queues packets whose
+   buffers are owned by another FIFO */
+int ARSTREAM2_RTP_PacketFifoInit(ARSTREAM2_RTP_PacketFifo_t *fifo, int itemMaxCount, int bufferMaxCount, int packetBufferSize,
+                                 int jumboBufferMaxCount, int jumboPacketBufferSize);
 
 int ARSTREAM2_RTP_PacketFifoFree(ARSTREAM2_RTP_PacketFifo_t *fifo);
 
@@ -292,6 +364,25 @@ ARSTREAM2_RTP_PacketFifoItem_t* ARSTREAM2_RTP_PacketFifoPeekItem(ARSTREAM2_RTP_P
 ARSTREAM2_RTP_PacketFifoItem_t* ARSTREAM2_RTP_PacketFifoDuplicateItem(ARSTREAM2_RTP_PacketFifo_t *fifo,
                                                                       ARSTREAM2_RTP_PacketFifoItem_t *item);
 
+int ARSTREAM2_RTP_PacketRingInit(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int size);
+
+int ARSTREAM2_RTP_PacketRingFree(ARSTREAM2_RTP_PacketRing_t *ring);
+
+/* Producer side: returns -2 if the ring is full (the packet is then dropped) */
+int ARSTREAM2_RTP_PacketRingPush(ARSTREAM2_RTP_PacketRing_t *ring, const ARSTREAM2_RTP_PacketFifoItem_t *item);
+
+/* Consumer side: the entries are used in place; returns the number of published entries
+   starting at the index returned in tail (entries are accessed with ARSTREAM2_RTP_PacketRingGetEntry()) */
+int ARSTREAM2_RTP_PacketRingGetPending(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int *tail);
+
+ARSTREAM2_RTP_PacketRingEntry_t* ARSTREAM2_RTP_PacketRingGetEntry(ARSTREAM2_RTP_PacketRing_t *ring, unsigned int index);
+
+/* Consumer side: release the references of the count oldest entries (the buffers go back to their owner FIFO) */
+int ARSTREAM2_RTP_PacketRingRelease(ARSTREAM2_RTP_PacketRing_t *ring, ARSTREAM2_RTP_PacketFifo_t *fifo, unsigned int count);
+
+/* Consumer side: release all the pending entries; returns the released packet count */
+int ARSTREAM2_RTP_PacketRingFlush(ARSTREAM2_RTP_PacketRing_t *ring, ARSTREAM2_RTP_PacketFifo_t *fifo);
+
 int ARSTREAM2_RTP_Sender_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifoQueue_t *queue, struct mmsghdr *msgVec, unsigned int msgVecCount, void *msgName, socklen_t msgNamelen);
 
 int ARSTREAM2_RTP_Sender_PacketFifoCleanFromMsgVec(ARSTREAM2_RTP_SenderContext_t *context,
@@ -330,7 +421,7 @@ int ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(ARSTREAM2_RTP_PacketFifo_t *fifo
    must not be broken (no change made to the free items list) */
 int ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(ARSTREAM2_RTP_ReceiverContext_t *context,
                                                    ARSTREAM2_RTP_PacketFifo_t *fifo, ARSTREAM2_RTP_PacketFifoQueue_t *queue,
-                                                   ARSTREAM2_RTP_PacketFifoQueue_t **resendQueue, uint32_t *resendTimeout, unsigned int resendCount,
+                                                   ARSTREAM2_RTP_PacketRing_t **resendRing, unsigned int resendCount,
                                                    struct mmsghdr *msgVec, unsigned int msgVecCount, uint64_t curTime,
                                                    ARSTREAM2_RTCP_ReceiverContext_t *rtcpContext);
 
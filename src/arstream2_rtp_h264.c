@@ -677,18 +677,18 @@ static int ARSTREAM2_RTPH264_Receiver_SingleNaluPacket(ARSTREAM2_RTPH264_Receive
     }
 
     /* metadata as RTP header extension */
-    if ((packet->headerExtension) && (packet->headerExtensionSize > 0)
-            && (packet->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
+    if ((packet->info->headerExtension) && (packet->info->headerExtensionSize > 0)
+            && (packet->info->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
     {
-        memcpy(context->auItem->au.buffer->metadataBuffer, packet->headerExtension, packet->headerExtensionSize);
-        context->auItem->au.metadataSize = packet->headerExtensionSize;
+        memcpy(context->auItem->au.buffer->metadataBuffer, packet->info->headerExtension, packet->info->headerExtensionSize);
+        context->auItem->au.metadataSize = packet->info->headerExtensionSize;
     }
 
     ARSTREAM2_H264_NaluFifoItem_t *item = ARSTREAM2_H264_AuNaluFifoPopFreeItem(&context->auItem->au);
     if (item)
     {
         ARSTREAM2_H264_NaluReset(&item->nalu);
-        err = ARSTREAM2_H264_AuCheckSizeRealloc(&context->auItem->au, context->startCodeLength + packet->payloadSize);
+        err = ARSTREAM2_H264_AuCheckSizeRealloc(&context->auItem->au, context->startCodeLength + packet->info->payloadSize);
         if (err != 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTPH264_TAG, "Access unit buffer is too small");
@@ -709,16 +709,16 @@ static int ARSTREAM2_RTPH264_Receiver_SingleNaluPacket(ARSTREAM2_RTPH264_Receive
             item->nalu.naluSize += context->startCodeLength;
             context->auItem->au.auSize += context->startCodeLength;
         }
-        memcpy(context->auItem->au.buffer->auBuffer + context->auItem->au.auSize, packet->payload, packet->payloadSize);
-        item->nalu.naluSize += packet->payloadSize;
-        context->auItem->au.auSize += packet->payloadSize;
+        memcpy(context->auItem->au.buffer->auBuffer + context->auItem->au.auSize, packet->info->payload, packet->info->payloadSize);
+        item->nalu.naluSize += packet->info->payloadSize;
+        context->auItem->au.auSize += packet->info->payloadSize;
 
-        item->nalu.inputTimestamp = packet->inputTimestamp;
+        item->nalu.inputTimestamp = packet->info->inputTimestamp;
         item->nalu.timeoutTimestamp = packet->timeoutTimestamp;
-        item->nalu.ntpTimestamp = packet->ntpTimestamp;
-        item->nalu.ntpTimestampRaw = packet->ntpTimestampRaw;
-        item->nalu.ntpTimestampLocal = packet->ntpTimestampLocal;
-        item->nalu.extRtpTimestamp = packet->extRtpTimestamp;
+        item->nalu.ntpTimestamp = packet->info->ntpTimestamp;
+        item->nalu.ntpTimestampRaw = packet->info->ntpTimestampRaw;
+        item->nalu.ntpTimestampLocal = packet->info->ntpTimestampLocal;
+        item->nalu.extRtpTimestamp = packet->info->extRtpTimestamp;
         item->nalu.rtpTimestamp = packet->rtpTimestamp;
         item->nalu.isLastInAu = packet->markerBit;
         item->nalu.missingPacketsBefore = missingPacketsBefore;
@@ -750,8 +750,8 @@ static int ARSTREAM2_RTPH264_Receiver_StapAPacket(ARSTREAM2_RTPH264_ReceiverCont
                                                   uint32_t missingPacketsBefore)
 {
     int ret = 0, err, first;
-    uint8_t *packetBuf = packet->payload + 1;
-    unsigned int sizeLeft = packet->payloadSize - 1, naluSize;
+    uint8_t *packetBuf = packet->info->payload + 1;
+    unsigned int sizeLeft = packet->info->payloadSize - 1, naluSize;
 
     if (!context->auItem)
     {
@@ -760,11 +760,11 @@ static int ARSTREAM2_RTPH264_Receiver_StapAPacket(ARSTREAM2_RTPH264_ReceiverCont
     }
 
     /* metadata as RTP header extension */
-    if ((packet->headerExtension) && (packet->headerExtensionSize > 0)
-            && (packet->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
+    if ((packet->info->headerExtension) && (packet->info->headerExtensionSize > 0)
+            && (packet->info->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
     {
-        memcpy(context->auItem->au.buffer->metadataBuffer, packet->headerExtension, packet->headerExtensionSize);
-        context->auItem->au.metadataSize = packet->headerExtensionSize;
+        memcpy(context->auItem->au.buffer->metadataBuffer, packet->info->headerExtension, packet->info->headerExtensionSize);
+        context->auItem->au.metadataSize = packet->info->headerExtensionSize;
     }
 
     naluSize = (((uint16_t)(*packetBuf) << 8) & 0xFF00) | (((uint16_t)(*(packetBuf + 1))) & 0x00FF);
@@ -803,12 +803,12 @@ static int ARSTREAM2_RTPH264_Receiver_StapAPacket(ARSTREAM2_RTPH264_ReceiverCont
             item->nalu.naluSize += naluSize;
             context->auItem->au.auSize += naluSize;
 
-            item->nalu.inputTimestamp = packet->inputTimestamp;
+            item->nalu.inputTimestamp = packet->info->inputTimestamp;
             item->nalu.timeoutTimestamp = packet->timeoutTimestamp;
-            item->nalu.ntpTimestamp = packet->ntpTimestamp;
-            item->nalu.ntpTimestampRaw = packet->ntpTimestampRaw;
-            item->nalu.ntpTimestampLocal = packet->ntpTimestampLocal;
-            item->nalu.extRtpTimestamp = packet->extRtpTimestamp;
+            item->nalu.ntpTimestamp = packet->info->ntpTimestamp;
+            item->nalu.ntpTimestampRaw = packet->info->ntpTimestampRaw;
+            item->nalu.ntpTimestampLocal = packet->info->ntpTimestampLocal;
+            item->nalu.extRtpTimestamp = packet->info->extRtpTimestamp;
             item->nalu.rtpTimestamp = packet->rtpTimestamp;
             item->nalu.isLastInAu = (sizeLeft - naluSize >= 2) ? 0 : packet->markerBit;
             item->nalu.missingPacketsBefore = (first) ? missingPacketsBefore : 0;
@@ -866,11 +866,11 @@ static int ARSTREAM2_RTPH264_Receiver_BeginFuAPackets(ARSTREAM2_RTPH264_Receiver
     }
 
     /* metadata as RTP header extension */
-    if ((packet->headerExtension) && (packet->headerExtensionSize > 0)
-            && (packet->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
+    if ((packet->info->headerExtension) && (packet->info->headerExtensionSize > 0)
+            && (packet->info->headerExtensionSize <= context->auItem->au.buffer->metadataBufferSize))
     {
-        memcpy(context->auItem->au.buffer->metadataBuffer, packet->headerExtension, packet->headerExtensionSize);
-        context->auItem->au.metadataSize = packet->headerExtensionSize;
+        memcpy(context->auItem->au.buffer->metadataBuffer, packet->info->headerExtension, packet->info->headerExtensionSize);
+        context->auItem->au.metadataSize = packet->info->headerExtensionSize;
     }
 
     context->fuNaluItem = ARSTREAM2_H264_AuNaluFifoPopFreeItem(&context->auItem->au);
@@ -880,12 +880,12 @@ static int ARSTREAM2_RTPH264_Receiver_BeginFuAPackets(ARSTREAM2_RTPH264_Receiver
         context->fuNaluItem->nalu.nalu = context->auItem->au.buffer->auBuffer + context->auItem->au.auSize;
         context->fuNaluItem->nalu.naluSize = 0;
 
-        context->fuNaluItem->nalu.inputTimestamp = packet->inputTimestamp;
+        context->fuNaluItem->nalu.inputTimestamp = packet->info->inputTimestamp;
         context->fuNaluItem->nalu.timeoutTimestamp = packet->timeoutTimestamp;
-        context->fuNaluItem->nalu.ntpTimestamp = packet->ntpTimestamp;
-        context->fuNaluItem->nalu.ntpTimestampRaw = packet->ntpTimestampRaw;
-        context->fuNaluItem->nalu.ntpTimestampLocal = packet->ntpTimestampLocal;
-        context->fuNaluItem->nalu.extRtpTimestamp = packet->extRtpTimestamp;
+        context->fuNaluItem->nalu.ntpTimestamp = packet->info->ntpTimestamp;
+        context->fuNaluItem->nalu.ntpTimestampRaw = packet->info->ntpTimestampRaw;
+        context->fuNaluItem->nalu.ntpTimestampLocal = packet->info->ntpTimestampLocal;
+        context->fuNaluItem->nalu.extRtpTimestamp = packet->info->extRtpTimestamp;
         context->fuNaluItem->nalu.rtpTimestamp = packet->rtpTimestamp;
         context->fuNaluItem->nalu.missingPacketsBefore = missingPacketsBefore;
 
@@ -914,8 +914,8 @@ static int ARSTREAM2_RTPH264_Receiver_AppendPacketToFuA(ARSTREAM2_RTPH264_Receiv
                                                         int isFirst, uint8_t headerByte)
 {
     int ret = 0, err;
-    uint8_t *packetBuf = packet->payload + ((isFirst) ? 1 : 2);
-    unsigned int packetSize = packet->payloadSize - ((isFirst) ? 1 : 2);
+    uint8_t *packetBuf = packet->info->payload + ((isFirst) ? 1 : 2);
+    unsigned int packetSize = packet->info->payloadSize - ((isFirst) ? 1 : 2);
 
     if ((!context->auItem) || (!context->fuNaluItem))
     {
@@ -1040,7 +1040,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
 
                     /* AU change detection */
                     if ((ret == 0) && (context->auItem != NULL) && (context->previousDepayloadExtRtpTimestamp != 0)
-                            && (packet->extRtpTimestamp != context->previousDepayloadExtRtpTimestamp))
+                            && (packet->info->extRtpTimestamp != context->previousDepayloadExtRtpTimestamp))
                     {
                         /* drop the previous incomplete FU-A */
                         //ARSAL_PRINT(ARSAL_PRINT_VERBOSE, ARSTREAM2_RTPH264_TAG, "Incomplete FU-A packet before extSeqNum %d", packet->extSeqNum);
@@ -1103,18 +1103,18 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
 
                     if ((ret == 0) && (context->auItem != NULL))
                     {
-                        if ((packet->payload) && (packet->payloadSize >= 1))
+                        if ((packet->info->payload) && (packet->info->payloadSize >= 1))
                         {
-                            uint8_t headByte = *(packet->payload);
+                            uint8_t headByte = *(packet->info->payload);
 
                             if ((headByte & 0x1F) == ARSTREAM2_RTPH264_NALU_TYPE_FUA)
                             {
                                 /* Fragmentation (FU-A) */
-                                if (packet->payloadSize >= 2)
+                                if (packet->info->payloadSize >= 2)
                                 {
                                     uint8_t fuIndicator, fuHeader, startBit, endBit;
                                     fuIndicator = headByte;
-                                    fuHeader = *(packet->payload + 1);
+                                    fuHeader = *(packet->info->payload + 1);
                                     startBit = fuHeader & 0x80;
                                     endBit = fuHeader & 0x40;
 
@@ -1187,7 +1187,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
                                 }
                                 else
                                 {
-                                    ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for FU-A packet at extSeqNum %d", packet->payloadSize, packet->extSeqNum);
+                                    ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for FU-A packet at extSeqNum %d", packet->info->payloadSize, packet->extSeqNum);
                                 }
                             }
                             else if ((headByte & 0x1F) == ARSTREAM2_RTPH264_NALU_TYPE_STAPA)
@@ -1206,7 +1206,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
                                     }
                                 }
 
-                                if (packet->payloadSize >= 3)
+                                if (packet->info->payloadSize >= 3)
                                 {
                                     err = ARSTREAM2_RTPH264_Receiver_StapAPacket(context, packet, missingPacketsBefore + context->missingBeforePending);
                                     if (err != 0)
@@ -1221,7 +1221,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
                                 }
                                 else
                                 {
-                                    ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for STAP-A packet at extSeqNum %d", packet->payloadSize, packet->extSeqNum);
+                                    ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for STAP-A packet at extSeqNum %d", packet->info->payloadSize, packet->extSeqNum);
                                 }
                             }
                             else
@@ -1254,7 +1254,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
                         }
                         else
                         {
-                            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for packet at extSeqNum %d", packet->payloadSize, packet->extSeqNum);
+                            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTPH264_TAG, "Invalid payload size (%d) for packet at extSeqNum %d", packet->info->payloadSize, packet->extSeqNum);
                         }
                     }
 
@@ -1293,7 +1293,7 @@ int ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(ARSTREAM2_RTPH264_ReceiverCont
 
                     rtcpContext->packetsReceived++;
                     context->previousDepayloadExtSeqNum = packet->extSeqNum;
-                    context->previousDepayloadExtRtpTimestamp = packet->extRtpTimestamp;
+                    context->previousDepayloadExtRtpTimestamp = packet->info->extRtpTimestamp;
                     packetCount++;
                 }
                 else
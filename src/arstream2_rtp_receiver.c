@@ -689,6 +689,84 @@ static int ARSTREAM2_RtpReceiver_NetRecvMmsg(ARSTREAM2_RtpReceiver_t *receiver,
     }
 }
 
+static int ARSTREAM2_RtpReceiver_StreamIngestSetup(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    if (receiver == NULL)
+        return -EINVAL;
+
+    /* the stream socket is owned by the caller */
+    receiver->net.streamSocket = -1;
+    memset(&receiver->ingest, 0, sizeof(receiver->ingest));
+
+    return 0;
+}
+
+static int ARSTREAM2_RtpReceiver_StreamIngestTeardown(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    if (receiver == NULL)
+        return -EINVAL;
+
+    receiver->ingest.msgVec = NULL;
+    receiver->ingest.msgCount = 0;
+    receiver->ingest.msgIndex = 0;
+
+    return 0;
+}
+
+static int ARSTREAM2_RtpReceiver_IngestRecvMmsg(ARSTREAM2_RtpReceiver_t *receiver, struct mmsghdr *msgvec, unsigned int vlen, int blocking)
+{
+    unsigned int i, k, j;
+    size_t offset, size, len, dstOffset, srcOffset;
+    struct mmsghdr *src;
+    struct iovec *dstIov, *srcIov;
+
+    if ((!receiver) || (!msgvec))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    /* scatter each pending packet into the packet FIFO buffers as recvmmsg() would */
+    for (i = 0; (i < vlen) && (receiver->ingest.msgIndex < receiver->ingest.msgCount); i++, receiver->ingest.msgIndex++)
+    {
+        src = receiver->ingest.msgVec[receiver->ingest.msgIndex];
+        size = src->msg_len;
+        for (k = 0, j = 0, offset = 0, dstOffset = 0, srcOffset = 0;
+             (k < msgvec[i].msg_hdr.msg_iovlen) && (j < src->msg_hdr.msg_iovlen) && (offset < size); )
+        {
+            dstIov = &msgvec[i].msg_hdr.msg_iov[k];
+            srcIov = &src->msg_hdr.msg_iov[j];
+            len = size - offset;
+            if (len > dstIov->iov_len - dstOffset)
+            {
+                len = dstIov->iov_len - dstOffset;
+            }
+            if (len > srcIov->iov_len - srcOffset)
+            {
+                len = srcIov->iov_len - srcOffset;
+            }
+            memcpy((uint8_t*)dstIov->iov_base + dstOffset, (uint8_t*)srcIov->iov_base + srcOffset, len);
+            offset += len;
+            dstOffset += len;
+            srcOffset += len;
+            if (dstOffset >= dstIov->iov_len)
+            {
+                k++;
+                dstOffset = 0;
+            }
+            if (srcOffset >= srcIov->iov_len)
+            {
+                j++;
+                srcOffset = 0;
+            }
+        }
+        msgvec[i].msg_len = (unsigned int)offset;
+        msgvec[i].msg_hdr.msg_flags = ((offset < size) || (src->msg_hdr.msg_flags & MSG_TRUNC)) ? MSG_TRUNC : 0;
+    }
+
+    return (int)i;
+}
+
 static int ARSTREAM2_RtpReceiver_MuxSendControlData(ARSTREAM2_RtpReceiver_t *receiver,
                                                     uint8_t *buffer,
                                                     int size)
@@ -790,6 +868,261 @@ static int ARSTREAM2_RtpReceiver_NetReadControlData(ARSTREAM2_RtpReceiver_t *rec
 }
 
 
+static int ARSTREAM2_RtpReceiver_SharedControlSetup(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    if (receiver == NULL)
+        return -EINVAL;
+
+    /* the control socket is owned by the transport receiver */
+    receiver->net.controlSocket = -1;
+
+    return 0;
+}
+
+static int ARSTREAM2_RtpReceiver_SharedControlTeardown(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    if (receiver == NULL)
+        return -EINVAL;
+
+    return 0;
+}
+
+static int ARSTREAM2_RtpReceiver_SharedSendControlData(ARSTREAM2_RtpReceiver_t *receiver, uint8_t *buffer, int size)
+{
+    ARSTREAM2_RtpReceiver_t *transport;
+
+    if ((receiver == NULL) || (receiver->shared.transport == NULL))
+        return -EINVAL;
+
+    transport = receiver->shared.transport;
+    return transport->ops.controlChannelSend(transport, buffer, size);
+}
+
+static int ARSTREAM2_RtpReceiver_SharedReadControlData(ARSTREAM2_RtpReceiver_t *receiver, uint8_t *buffer, int size)
+{
+    /* the RTCP packets are read and routed by the transport receiver */
+    errno = EAGAIN;
+    return -1;
+}
+
+static void ARSTREAM2_RtpReceiver_DemuxSharedStreams(ARSTREAM2_RtpReceiver_t *receiver, unsigned int msgCount)
+{
+    ARSTREAM2_RtpReceiver_t *stream;
+    ARSTREAM2_RTP_Header_t *header;
+    uint32_t ssrc;
+    unsigned int i;
+    int k;
+
+    ARSAL_Mutex_Lock(&(receiver->shared.mutex));
+
+    for (k = 0; k < receiver->shared.streamCount; k++)
+    {
+        receiver->shared.stream[k]->shared.msgCount = 0;
+    }
+
+    for (i = 0; i < msgCount; i++)
+    {
+        if (receiver->msgVec[i].msg_len <= sizeof(ARSTREAM2_RTP_Header_t))
+        {
+            continue;
+        }
+        header = (ARSTREAM2_RTP_Header_t*)receiver->msgVec[i].msg_hdr.msg_iov[0].iov_base;
+        ssrc = ntohl(header->ssrc);
+        for (k = 0; k < receiver->shared.streamCount; k++)
+        {
+            stream = receiver->shared.stream[k];
+            if ((stream->shared.ssrc == ssrc) && (stream->shared.msgCount < receiver->msgVecCount))
+            {
+                /* the packet data stays in the transport FIFO buffer until the next reception */
+                stream->shared.msgVec[stream->shared.msgCount] = receiver->msgVec[i];
+                stream->shared.msgPtr[stream->shared.msgCount] = &stream->shared.msgVec[stream->shared.msgCount];
+                stream->shared.msgCount++;
+                receiver->msgVec[i].msg_len = 0;
+                break;
+            }
+        }
+    }
+
+    for (k = 0; k < receiver->shared.streamCount; k++)
+    {
+        stream = receiver->shared.stream[k];
+        if (stream->shared.msgCount > 0)
+        {
+            ARSTREAM2_RtpReceiver_IngestPackets(stream, stream->shared.msgPtr, stream->shared.msgCount);
+        }
+    }
+
+    ARSAL_Mutex_Unlock(&(receiver->shared.mutex));
+}
+
+
+static int ARSTREAM2_RtpReceiver_CaptureSetup(ARSTREAM2_RtpReceiver_t *receiver, const char *fileName)
+{
+    ARSTREAM2_PcapWriter_Config_t captureConfig;
+    eARSTREAM2_ERROR err = ARSTREAM2_OK;
+    uint32_t serverAddr = 0;
+
+    memset(&captureConfig, 0, sizeof(captureConfig));
+    captureConfig.fileWriterConfig.fileName = fileName;
+    captureConfig.fileWriterConfig.batchSize = ARSTREAM2_RTP_RECEIVER_CAPTURE_BATCH_SIZE;
+    captureConfig.applicationName = receiver->applicationName;
+    if ((receiver->net.serverAddr) && (inet_addr(receiver->net.serverAddr) != INADDR_NONE))
+    {
+        serverAddr = inet_addr(receiver->net.serverAddr);
+    }
+    if (receiver->net.isMulticast)
+    {
+        captureConfig.dstAddr = serverAddr;
+    }
+    else
+    {
+        captureConfig.srcAddr = serverAddr;
+    }
+    captureConfig.srcPort[ARSTREAM2_PCAP_CHANNEL_STREAM] = (uint16_t)receiver->net.serverStreamPort;
+    captureConfig.dstPort[ARSTREAM2_PCAP_CHANNEL_STREAM] = (uint16_t)receiver->net.clientStreamPort;
+    captureConfig.srcPort[ARSTREAM2_PCAP_CHANNEL_CONTROL] = (uint16_t)receiver->net.serverControlPort;
+    captureConfig.dstPort[ARSTREAM2_PCAP_CHANNEL_CONTROL] = (uint16_t)receiver->net.clientControlPort;
+
+    receiver->capture = ARSTREAM2_PcapWriter_New(&captureConfig, &err);
+    if (!receiver->capture)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to create the capture file '%s' (%d)", fileName, err);
+        return -1;
+    }
+
+#ifdef SO_TIMESTAMPNS
+    /* use the kernel reception timestamps when the receiver owns the stream socket */
+    if ((!receiver->useMux) && (!receiver->useIngest) && (!receiver->useCustomOps) && (receiver->net.streamSocket >= 0))
+    {
+        int on = 1;
+        if (setsockopt(receiver->net.streamSocket, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to enable the kernel timestamps, using local timestamps (%d): %s", errno, strerror(errno));
+        }
+        else
+        {
+            receiver->captureControlSize = CMSG_SPACE(sizeof(struct timespec));
+            receiver->captureControlBuffer = malloc(receiver->msgVecCount * receiver->captureControlSize);
+            if (!receiver->captureControlBuffer)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RECEIVER_TAG, "Capture control buffer allocation failed, using local timestamps");
+                receiver->captureControlSize = 0;
+            }
+        }
+    }
+#endif
+
+    return 0;
+}
+
+
+static void ARSTREAM2_RtpReceiver_CaptureStreamPackets(ARSTREAM2_RtpReceiver_t *receiver, unsigned int msgCount)
+{
+    struct timespec t;
+    struct cmsghdr *cmsg;
+    uint64_t localTime, timestamp;
+    unsigned int i;
+
+    clock_gettime(CLOCK_REALTIME, &t);
+    localTime = (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_nsec / 1000;
+
+    for (i = 0; i < msgCount; i++)
+    {
+        if (receiver->msgVec[i].msg_len == 0)
+        {
+            continue;
+        }
+        timestamp = localTime;
+#ifdef SO_TIMESTAMPNS
+        if (receiver->captureControlBuffer)
+        {
+            for (cmsg = CMSG_FIRSTHDR(&receiver->msgVec[i].msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&receiver->msgVec[i].msg_hdr, cmsg))
+            {
+                if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPNS))
+                {
+                    memcpy(&t, CMSG_DATA(cmsg), sizeof(t));
+                    timestamp = (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_nsec / 1000;
+                    break;
+                }
+            }
+        }
+#else
+        (void)cmsg;
+#endif
+        if (ARSTREAM2_PcapWriter_WritePacket(receiver->capture, ARSTREAM2_PCAP_CHANNEL_STREAM, timestamp,
+                                             receiver->msgVec[i].msg_hdr.msg_iov, (int)receiver->msgVec[i].msg_hdr.msg_iovlen,
+                                             receiver->msgVec[i].msg_len) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Capture write failed, capture stopped");
+            ARSTREAM2_PcapWriter_Delete(&receiver->capture);
+            break;
+        }
+    }
+}
+
+
+static void ARSTREAM2_RtpReceiver_CaptureControlPacket(ARSTREAM2_RtpReceiver_t *receiver, unsigned int size)
+{
+    struct timespec t;
+    struct iovec iov;
+
+    clock_gettime(CLOCK_REALTIME, &t);
+    iov.iov_base = receiver->rtcpMsgBuffer;
+    iov.iov_len = size;
+    if (ARSTREAM2_PcapWriter_WritePacket(receiver->capture, ARSTREAM2_PCAP_CHANNEL_CONTROL,
+                                         (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_nsec / 1000, &iov, 1, size) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Capture write failed, capture stopped");
+        ARSTREAM2_PcapWriter_Delete(&receiver->capture);
+    }
+}
+
+
+/* Pass the received packets through the impairment stage, then scatter the
+ * packets due for release into the msgVec entries; returns the number of
+ * packets to process */
+static unsigned int ARSTREAM2_RtpReceiver_ImpairStreamPackets(ARSTREAM2_RtpReceiver_t *receiver, unsigned int recvMsgCount,
+                                                              unsigned int msgCount, uint64_t curTime)
+{
+    const uint8_t *data;
+    size_t size, offset, len;
+    unsigned int i, k;
+
+    for (i = 0; i < recvMsgCount; i++)
+    {
+        if (receiver->msgVec[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            /* the truncation cannot be carried through the impairment stage */
+            continue;
+        }
+        if (ARSTREAM2_NetImpairment_Submit(receiver->impairment, receiver->msgVec[i].msg_hdr.msg_iov, (int)receiver->msgVec[i].msg_hdr.msg_iovlen,
+                                           receiver->msgVec[i].msg_len, curTime) < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "ARSTREAM2_NetImpairment_Submit() failed");
+        }
+    }
+
+    for (i = 0; (i < msgCount) && (ARSTREAM2_NetImpairment_Peek(receiver->impairment, curTime, &data, &size) > 0); i++)
+    {
+        for (k = 0, offset = 0; (k < receiver->msgVec[i].msg_hdr.msg_iovlen) && (offset < size); k++)
+        {
+            len = receiver->msgVec[i].msg_hdr.msg_iov[k].iov_len;
+            if (len > size - offset)
+            {
+                len = size - offset;
+            }
+            memcpy(receiver->msgVec[i].msg_hdr.msg_iov[k].iov_base, data + offset, len);
+            offset += len;
+        }
+        receiver->msgVec[i].msg_len = (unsigned int)offset;
+        receiver->msgVec[i].msg_hdr.msg_flags = (offset < size) ? MSG_TRUNC : 0;
+        ARSTREAM2_NetImpairment_Pop(receiver->impairment);
+    }
+
+    return i;
+}
+
+
 void ARSTREAM2_RtpReceiver_Stop(ARSTREAM2_RtpReceiver_t *receiver)
 {
     int ret;
@@ -822,6 +1155,7 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
 {
     ARSTREAM2_RtpReceiver_t *retReceiver = NULL;
     int monitoringMutexWasInit = 0;
+    int sharedMutexWasInit = 0;
     eARSTREAM2_ERROR internalError = ARSTREAM2_OK;
 
     /* ARGS Check */
@@ -871,7 +1205,39 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
     }
 
 
-    if (net_config != NULL)
+    if ((net_config != NULL) && (net_config->transport != NULL))
+    {
+        if (net_config->transport->shared.transport != NULL)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Config: the transport receiver is already sharing another receiver transport");
+            SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+            return retReceiver;
+        }
+        if ((net_config->transport->useMux) || (net_config->transport->useIngest))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Config: the transport receiver must own its sockets");
+            SET_WITH_CHECK(error, ARSTREAM2_ERROR_UNSUPPORTED);
+            return retReceiver;
+        }
+        if (net_config->ssrc == 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Config: no SSRC provided for the shared transport");
+            SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+            return retReceiver;
+        }
+    }
+    else if ((net_config != NULL) && (net_config->ops != NULL))
+    {
+        if ((!net_config->ops->streamChannelSetup) || (!net_config->ops->streamChannelTeardown) || (!net_config->ops->streamChannelRecvMmsg)
+                || (!net_config->ops->controlChannelSetup) || (!net_config->ops->controlChannelTeardown)
+                || (!net_config->ops->controlChannelSend) || (!net_config->ops->controlChannelRead))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Config: incomplete custom channel operations");
+            SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+            return retReceiver;
+        }
+    }
+    else if (net_config != NULL)
     {
         if (((net_config->serverAddr == NULL) || (!strlen(net_config->serverAddr)))
                 && (((net_config->mcastAddr == NULL) || (!strlen(net_config->mcastAddr))) || ((net_config->mcastIfaceAddr == NULL) || (!strlen(net_config->mcastIfaceAddr)))))
@@ -937,6 +1303,7 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
         retReceiver->rtpReceiverContext.maxPacketSize = (config->maxPacketSize > 0) ? config->maxPacketSize - ARSTREAM2_RTP_TOTAL_HEADERS_SIZE : ARSTREAM2_RTP_MAX_PAYLOAD_SIZE;
         retReceiver->insertStartCodes = (config->insertStartCodes > 0) ? 1 : 0;
         retReceiver->generateReceiverReports = (config->generateReceiverReports > 0) ? 1 : 0;
+        if (config->clock) retReceiver->clock = *config->clock;
         retReceiver->rtpReceiverContext.rtpClockRate = 90000;
         retReceiver->rtpReceiverContext.nominalDelay = 30000; //TODO
         retReceiver->rtpReceiverContext.previousExtSeqNum = -1;
@@ -979,7 +1346,50 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
             internalError = ARSTREAM2_ERROR_BAD_PARAMETERS;
         }
 
-        if (net_config)
+        if ((net_config) && (net_config->transport))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_RTP_RECEIVER_TAG, "New RTP Receiver sharing a transport (SSRC 0x%08X)", net_config->ssrc);
+            retReceiver->shared.transport = net_config->transport;
+            retReceiver->shared.ssrc = net_config->ssrc;
+            retReceiver->net.isMulticast = net_config->transport->net.isMulticast;
+            if (retReceiver->net.isMulticast)
+            {
+                retReceiver->generateReceiverReports = 0; // Force not sending RTCP receiver reports in multicast mode
+            }
+            retReceiver->net.streamSocket = -1;
+            retReceiver->net.controlSocket = -1;
+
+            /* the packets are demultiplexed by the transport receiver and ingested */
+            retReceiver->useMux = 0;
+            retReceiver->useIngest = 1;
+
+            retReceiver->ops.streamChannelSetup = ARSTREAM2_RtpReceiver_StreamIngestSetup;
+            retReceiver->ops.streamChannelRecvMmsg = ARSTREAM2_RtpReceiver_IngestRecvMmsg;
+            retReceiver->ops.streamChannelTeardown = ARSTREAM2_RtpReceiver_StreamIngestTeardown;
+
+            retReceiver->ops.controlChannelSetup = ARSTREAM2_RtpReceiver_SharedControlSetup;
+            retReceiver->ops.controlChannelSend = ARSTREAM2_RtpReceiver_SharedSendControlData;
+            retReceiver->ops.controlChannelRead = ARSTREAM2_RtpReceiver_SharedReadControlData;
+            retReceiver->ops.controlChannelTeardown = ARSTREAM2_RtpReceiver_SharedControlTeardown;
+        }
+        else if ((net_config) && (net_config->ops))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_RTP_RECEIVER_TAG, "New RTP Receiver using custom channel operations");
+            retReceiver->net.isMulticast = 0;
+            retReceiver->net.streamSocket = -1;
+            retReceiver->net.controlSocket = -1;
+            retReceiver->net.serverStreamPort = net_config->serverStreamPort;
+            retReceiver->net.serverControlPort = net_config->serverControlPort;
+            retReceiver->net.clientStreamPort = (net_config->clientStreamPort > 0) ? net_config->clientStreamPort : ARSTREAM2_RTP_RECEIVER_DEFAULT_CLIENT_STREAM_PORT;
+            retReceiver->net.clientControlPort = (net_config->clientControlPort > 0) ? net_config->clientControlPort : ARSTREAM2_RTP_RECEIVER_DEFAULT_CLIENT_CONTROL_PORT;
+
+            retReceiver->useMux = 0;
+            retReceiver->useIngest = 0;
+            retReceiver->useCustomOps = 1;
+            retReceiver->opsUserPtr = net_config->opsUserPtr;
+            retReceiver->ops = *net_config->ops;
+        }
+        else if (net_config)
         {
             ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_RTP_RECEIVER_TAG, "New RTP Receiver using sockets");
             retReceiver->net.isMulticast = 0;
@@ -1007,10 +1417,20 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
             retReceiver->net.classSelector = net_config->classSelector;
 
             retReceiver->useMux = 0;
+            retReceiver->useIngest = (net_config->streamIngest > 0) ? 1 : 0;
 
-            retReceiver->ops.streamChannelSetup = ARSTREAM2_RtpReceiver_StreamSocketSetup;
-            retReceiver->ops.streamChannelRecvMmsg = ARSTREAM2_RtpReceiver_NetRecvMmsg;
-            retReceiver->ops.streamChannelTeardown = ARSTREAM2_RtpReceiver_StreamSocketTeardown;
+            if (retReceiver->useIngest)
+            {
+                retReceiver->ops.streamChannelSetup = ARSTREAM2_RtpReceiver_StreamIngestSetup;
+                retReceiver->ops.streamChannelRecvMmsg = ARSTREAM2_RtpReceiver_IngestRecvMmsg;
+                retReceiver->ops.streamChannelTeardown = ARSTREAM2_RtpReceiver_StreamIngestTeardown;
+            }
+            else
+            {
+                retReceiver->ops.streamChannelSetup = ARSTREAM2_RtpReceiver_StreamSocketSetup;
+                retReceiver->ops.streamChannelRecvMmsg = ARSTREAM2_RtpReceiver_NetRecvMmsg;
+                retReceiver->ops.streamChannelTeardown = ARSTREAM2_RtpReceiver_StreamSocketTeardown;
+            }
 
             retReceiver->ops.controlChannelSetup = ARSTREAM2_RtpReceiver_ControlSocketSetup;
             retReceiver->ops.controlChannelSend = ARSTREAM2_RtpReceiver_NetSendControlData;
@@ -1052,6 +1472,18 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
             monitoringMutexWasInit = 1;
         }
     }
+    if (internalError == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(retReceiver->shared.mutex));
+        if (mutexInitRet != 0)
+        {
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            sharedMutexWasInit = 1;
+        }
+    }
 
     /* MsgVec array */
     if (internalError == ARSTREAM2_OK)
@@ -1076,6 +1508,19 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
         }
     }
 
+    /* Shared transport demultiplexing array */
+    if ((internalError == ARSTREAM2_OK) && (retReceiver->shared.transport))
+    {
+        unsigned int count = retReceiver->shared.transport->msgVecCount;
+        retReceiver->shared.msgVec = malloc(count * sizeof(struct mmsghdr));
+        retReceiver->shared.msgPtr = malloc(count * sizeof(struct mmsghdr*));
+        if ((!retReceiver->shared.msgVec) || (!retReceiver->shared.msgPtr))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Shared msgVec allocation failed (size %ld)", (long)count * sizeof(struct mmsghdr));
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
     /* Stream channel setup */
     if (internalError == ARSTREAM2_OK)
     {
@@ -1109,6 +1554,57 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
         }
     }
 
+    /* Capture file */
+    if ((internalError == ARSTREAM2_OK) && (config->captureFileName))
+    {
+        int ret = ARSTREAM2_RtpReceiver_CaptureSetup(retReceiver, config->captureFileName);
+        if (ret != 0)
+        {
+            internalError = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    /* Network impairment emulation */
+    if ((internalError == ARSTREAM2_OK) && (!retReceiver->shared.transport) && (config->impairment))
+    {
+        retReceiver->impairment = ARSTREAM2_NetImpairment_New(config->impairment, &internalError);
+        if (internalError != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to create the impairment stage (%d)", internalError);
+        }
+    }
+
+    /* Attach to the shared transport */
+    if ((internalError == ARSTREAM2_OK) && (retReceiver->shared.transport))
+    {
+        ARSTREAM2_RtpReceiver_t *transport = retReceiver->shared.transport;
+        int k;
+
+        ARSAL_Mutex_Lock(&(transport->shared.mutex));
+        for (k = 0; k < transport->shared.streamCount; k++)
+        {
+            if (transport->shared.stream[k]->shared.ssrc == retReceiver->shared.ssrc)
+            {
+                break;
+            }
+        }
+        if (k < transport->shared.streamCount)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "SSRC 0x%08X is already used on the shared transport", retReceiver->shared.ssrc);
+            internalError = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        else if (transport->shared.streamCount >= ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Too many receivers on the shared transport (max %d)", ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS);
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            transport->shared.stream[transport->shared.streamCount++] = retReceiver;
+        }
+        ARSAL_Mutex_Unlock(&(transport->shared.mutex));
+    }
+
     if ((internalError != ARSTREAM2_OK) &&
         (retReceiver != NULL))
     {
@@ -1126,6 +1622,21 @@ ARSTREAM2_RtpReceiver_t* ARSTREAM2_RtpReceiver_New(ARSTREAM2_RtpReceiver_Config_
         {
             ARSAL_Mutex_Destroy(&(retReceiver->monitoringMutex));
         }
+        if (sharedMutexWasInit == 1)
+        {
+            ARSAL_Mutex_Destroy(&(retReceiver->shared.mutex));
+        }
+        if (retReceiver->capture)
+        {
+            ARSTREAM2_PcapWriter_Delete(&retReceiver->capture);
+        }
+        if (retReceiver->impairment)
+        {
+            ARSTREAM2_NetImpairment_Delete(&retReceiver->impairment);
+        }
+        free(retReceiver->captureControlBuffer);
+        free(retReceiver->shared.msgVec);
+        free(retReceiver->shared.msgPtr);
         free(retReceiver->msgVec);
         free(retReceiver->rtcpMsgBuffer);
         free(retReceiver->canonicalName);
@@ -1156,6 +1667,28 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_Delete(ARSTREAM2_RtpReceiver_t **receiver
     if ((receiver != NULL) &&
         (*receiver != NULL))
     {
+        if (ARSTREAM2_RtpReceiver_GetSharedStreamCount(*receiver) > 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Other receivers are still sharing the receiver transport");
+            return ARSTREAM2_ERROR_BUSY;
+        }
+        if ((*receiver)->shared.transport)
+        {
+            ARSTREAM2_RtpReceiver_t *transport = (*receiver)->shared.transport;
+            int k;
+
+            ARSAL_Mutex_Lock(&(transport->shared.mutex));
+            for (k = 0; k < transport->shared.streamCount; k++)
+            {
+                if (transport->shared.stream[k] == *receiver)
+                {
+                    transport->shared.stream[k] = transport->shared.stream[--transport->shared.streamCount];
+                    break;
+                }
+            }
+            ARSAL_Mutex_Unlock(&(transport->shared.mutex));
+        }
+
         int ret = (*receiver)->ops.streamChannelTeardown((*receiver));
         if (ret != 0)
         {
@@ -1167,6 +1700,18 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_Delete(ARSTREAM2_RtpReceiver_t **receiver
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to teardown the control channel (error %d : %s).\n", -ret, strerror(-ret));
         }
         ARSAL_Mutex_Destroy(&((*receiver)->monitoringMutex));
+        ARSAL_Mutex_Destroy(&((*receiver)->shared.mutex));
+        if ((*receiver)->capture)
+        {
+            ARSTREAM2_PcapWriter_Delete(&(*receiver)->capture);
+        }
+        if ((*receiver)->impairment)
+        {
+            ARSTREAM2_NetImpairment_Delete(&(*receiver)->impairment);
+        }
+        free((*receiver)->captureControlBuffer);
+        free((*receiver)->shared.msgVec);
+        free((*receiver)->shared.msgPtr);
         free((*receiver)->msgVec);
         free((*receiver)->rtcpMsgBuffer);
         free((*receiver)->canonicalName);
@@ -1190,6 +1735,24 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_Delete(ARSTREAM2_RtpReceiver_t **receiver
 }
 
 
+int ARSTREAM2_RtpReceiver_GetSharedStreamCount(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    int count;
+
+    // Args check
+    if (receiver == NULL)
+    {
+        return -1;
+    }
+
+    ARSAL_Mutex_Lock(&(receiver->shared.mutex));
+    count = receiver->shared.streamCount;
+    ARSAL_Mutex_Unlock(&(receiver->shared.mutex));
+
+    return count;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_GetSelectParams(ARSTREAM2_RtpReceiver_t *receiver, fd_set **readSet, fd_set **writeSet, fd_set **exceptSet, int *maxFd, uint32_t *nextTimeout)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
@@ -1201,19 +1764,24 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_GetSelectParams(ARSTREAM2_RtpReceiver_t *
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-    if (!receiver->useMux)
+    if (receiver->shared.transport)
+    {
+        /* the sockets are monitored by the transport receiver */
+        _maxFd = -1;
+    }
+    else if ((!receiver->useMux) && (!receiver->useCustomOps))
     {
         _maxFd = -1;
         if (receiver->net.streamSocket > _maxFd) _maxFd = receiver->net.streamSocket;
         if (receiver->net.controlSocket > _maxFd) _maxFd = receiver->net.controlSocket;
         if (readSet)
         {
-            FD_SET(receiver->net.streamSocket, *readSet);
+            if (!receiver->useIngest) FD_SET(receiver->net.streamSocket, *readSet);
             FD_SET(receiver->net.controlSocket, *readSet);
         }
         if (exceptSet)
         {
-            FD_SET(receiver->net.streamSocket, *exceptSet);
+            if (!receiver->useIngest) FD_SET(receiver->net.streamSocket, *exceptSet);
             FD_SET(receiver->net.controlSocket, *exceptSet);
         }
     }
@@ -1228,19 +1796,33 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_GetSelectParams(ARSTREAM2_RtpReceiver_t *
     }
 
     if (maxFd) *maxFd = _maxFd;
-    if (nextTimeout) *nextTimeout = (receiver->generateReceiverReports) ? ((receiver->nextRrDelay < ARSTREAM2_RTP_RECEIVER_TIMEOUT_US) ? receiver->nextRrDelay : ARSTREAM2_RTP_RECEIVER_TIMEOUT_US) : ARSTREAM2_RTP_RECEIVER_TIMEOUT_US;
+    if (nextTimeout)
+    {
+        uint64_t curTime = ARSTREAM2_Clock_GetTime(&receiver->clock);
+        *nextTimeout = ARSTREAM2_RTP_RECEIVER_TIMEOUT_US;
+        /* the receiver reports wait for a first sender report */
+        if ((receiver->generateReceiverReports) && (receiver->rtcpReceiverContext.prevSrNtpTimestamp != 0))
+        {
+            uint64_t rrTime = receiver->rtcpReceiverContext.lastRtcpTimestamp + receiver->nextRrDelay;
+            uint32_t rrTimeout = (rrTime > curTime) ? (uint32_t)(rrTime - curTime) : 0;
+            if (rrTimeout < *nextTimeout) *nextTimeout = rrTimeout;
+        }
+        if (receiver->impairment)
+        {
+            *nextTimeout = ARSTREAM2_NetImpairment_GetNextTimeout(receiver->impairment, curTime, *nextTimeout);
+        }
+    }
 
     return retVal;
 }
 
 
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *receiver, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
-                                                  int *shouldStop, ARSTREAM2_RTP_PacketFifoQueue_t **resendQueue, uint32_t *resendTimeout, unsigned int resendCount)
+                                                  int *shouldStop, ARSTREAM2_RTP_PacketRing_t **resendRing, unsigned int resendCount)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
-    struct timespec t1;
     uint64_t curTime;
-    int ret;
+    int ret, streamReadable;
 
     // Args check
     if (receiver == NULL)
@@ -1248,16 +1830,17 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *recei
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-    if ((exceptSet) && (FD_ISSET(receiver->net.streamSocket, exceptSet)))
+    if ((!receiver->useIngest) && (!receiver->useCustomOps) && (exceptSet) && (FD_ISSET(receiver->net.streamSocket, exceptSet)))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Exception on stream socket");
     }
 
-    ARSAL_Time_GetTime(&t1);
-    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+    curTime = ARSTREAM2_Clock_GetTime(&receiver->clock);
 
     /* RTP packets reception */
-    if ((!readSet) || ((selectRet >= 0) && (FD_ISSET(receiver->net.streamSocket, readSet))))
+    streamReadable = (receiver->useIngest) ? (receiver->ingest.msgIndex < receiver->ingest.msgCount)
+            : ((receiver->useCustomOps) || (!readSet) || ((selectRet >= 0) && (FD_ISSET(receiver->net.streamSocket, readSet))));
+    if ((streamReadable) || (receiver->impairment))
     {
         ret = ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(receiver->packetFifo, receiver->msgVec, receiver->msgVecCount);
         if (ret < 0)
@@ -1268,26 +1851,57 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *recei
         {
             unsigned int msgCount = (unsigned  int)ret;
 
-            ret = receiver->ops.streamChannelRecvMmsg(receiver, receiver->msgVec, msgCount, receiver->useMux);
-            if (ret < 0)
+            ret = 0;
+            if (streamReadable)
             {
-                if (ret == -EPIPE && receiver->useMux == 1)
+                if (receiver->captureControlBuffer)
                 {
-                    /* EPIPE with the mux means that we should no longer use the channel */
-                    ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_RTP_RECEIVER_TAG, "Got an EPIPE for stream channel, stopping thread");
-                    if (shouldStop) *shouldStop = 1;
+                    unsigned int i;
+                    for (i = 0; i < msgCount; i++)
+                    {
+                        receiver->msgVec[i].msg_hdr.msg_control = receiver->captureControlBuffer + i * receiver->captureControlSize;
+                        receiver->msgVec[i].msg_hdr.msg_controllen = receiver->captureControlSize;
+                    }
                 }
-                if (ret != -ETIMEDOUT)
+
+                ret = receiver->ops.streamChannelRecvMmsg(receiver, receiver->msgVec, msgCount, receiver->useMux);
+                if (ret < 0)
                 {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to read data (%d)", ret);
+                    if (ret == -EPIPE && receiver->useMux == 1)
+                    {
+                        /* EPIPE with the mux means that we should no longer use the channel */
+                        ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_RTP_RECEIVER_TAG, "Got an EPIPE for stream channel, stopping thread");
+                        if (shouldStop) *shouldStop = 1;
+                    }
+                    if (ret != -ETIMEDOUT)
+                    {
+                        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to read data (%d)", ret);
+                    }
+                }
+                else if ((ret > 0) && (receiver->capture))
+                {
+                    /* the capture holds the packets as received, before any impairment */
+                    ARSTREAM2_RtpReceiver_CaptureStreamPackets(receiver, (unsigned int)ret);
                 }
             }
-            else if (ret > 0)
+
+            if ((ret >= 0) && (receiver->impairment))
+            {
+                ret = (int)ARSTREAM2_RtpReceiver_ImpairStreamPackets(receiver, (unsigned int)ret, msgCount, curTime);
+            }
+
+            if (ret > 0)
             {
                 unsigned int recvMsgCount = (unsigned int)ret;
 
+                if (receiver->shared.streamCount > 0)
+                {
+                    /* hand over the packets of the receivers sharing the socket */
+                    ARSTREAM2_RtpReceiver_DemuxSharedStreams(receiver, recvMsgCount);
+                }
+
                 ret = ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(&receiver->rtpReceiverContext, receiver->packetFifo,
-                                                                     receiver->packetFifoQueue, resendQueue, resendTimeout, resendCount,
+                                                                     receiver->packetFifoQueue, resendRing, resendCount,
                                                                      receiver->msgVec, recvMsgCount, curTime,
                                                                      &receiver->rtcpReceiverContext);
                 if (ret < 0)
@@ -1298,6 +1912,25 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *recei
         }
     }
 
+    if (receiver->useIngest)
+    {
+        /* the pending messages are only valid for this processing pass */
+        if (receiver->ingest.msgIndex < receiver->ingest.msgCount)
+        {
+            receiver->ingest.dropCount += receiver->ingest.msgCount - receiver->ingest.msgIndex;
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RECEIVER_TAG, "Packet FIFO full, %d ingested packets dropped (total %d)",
+                        receiver->ingest.msgCount - receiver->ingest.msgIndex, receiver->ingest.dropCount);
+        }
+        receiver->ingest.msgVec = NULL;
+        receiver->ingest.msgCount = 0;
+        receiver->ingest.msgIndex = 0;
+    }
+
+    if (receiver->capture)
+    {
+        ARSTREAM2_PcapWriter_Poll(receiver->capture);
+    }
+
     /* RTP packets processing */
     ret = ARSTREAM2_RTPH264_Receiver_PacketFifoToAuFifo(&receiver->rtph264ReceiverContext, receiver->packetFifo,
                                                         receiver->packetFifoQueue, receiver->auFifo,
@@ -1311,10 +1944,29 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *recei
 }
 
 
+eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_IngestPackets(ARSTREAM2_RtpReceiver_t *receiver, struct mmsghdr **msgVec, unsigned int msgCount)
+{
+    // Args check
+    if ((receiver == NULL) || ((msgVec == NULL) && (msgCount > 0)))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (!receiver->useIngest)
+    {
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    receiver->ingest.msgVec = msgVec;
+    receiver->ingest.msgCount = msgCount;
+    receiver->ingest.msgIndex = 0;
+
+    return ARSTREAM2_OK;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtcp(ARSTREAM2_RtpReceiver_t *receiver, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet, int *shouldStop)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
-    struct timespec t1;
     uint64_t curTime;
     uint32_t rrDelay = 0;
     int ret;
@@ -1325,16 +1977,15 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtcp(ARSTREAM2_RtpReceiver_t *rece
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-    if ((exceptSet) && (FD_ISSET(receiver->net.controlSocket, exceptSet)))
+    if ((!receiver->shared.transport) && (!receiver->useCustomOps) && (exceptSet) && (FD_ISSET(receiver->net.controlSocket, exceptSet)))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Exception on control socket");
     }
 
-    ARSAL_Time_GetTime(&t1);
-    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+    curTime = ARSTREAM2_Clock_GetTime(&receiver->clock);
 
     /* RTCP sender reports */
-    if ((!readSet) || ((selectRet >= 0) && (FD_ISSET(receiver->net.controlSocket, readSet))))
+    if ((!receiver->shared.transport) && ((receiver->useCustomOps) || (!readSet) || ((selectRet >= 0) && (FD_ISSET(receiver->net.controlSocket, readSet)))))
     {
         /* The control channel is ready for reading */
         ssize_t bytes = receiver->ops.controlChannelRead(receiver, receiver->rtcpMsgBuffer, receiver->rtpReceiverContext.maxPacketSize);
@@ -1350,8 +2001,32 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtcp(ARSTREAM2_RtpReceiver_t *rece
         }
         while (bytes > 0)
         {
+            ARSTREAM2_RTCP_ReceiverContext_t *rtcpContext = &receiver->rtcpReceiverContext;
+            uint32_t ssrc;
+            int k;
+
+            if (receiver->capture)
+            {
+                ARSTREAM2_RtpReceiver_CaptureControlPacket(receiver, (unsigned int)bytes);
+            }
+
+            /* route the packet to the receiver sharing the socket for this media source, if any */
+            ARSAL_Mutex_Lock(&(receiver->shared.mutex));
+            if ((receiver->shared.streamCount > 0)
+                    && (ARSTREAM2_RTCP_GetMediaSourceSsrc(receiver->rtcpMsgBuffer, (unsigned int)bytes, &ssrc) == 0))
+            {
+                for (k = 0; k < receiver->shared.streamCount; k++)
+                {
+                    if (receiver->shared.stream[k]->shared.ssrc == ssrc)
+                    {
+                        rtcpContext = &receiver->shared.stream[k]->rtcpReceiverContext;
+                        break;
+                    }
+                }
+            }
             ret = ARSTREAM2_RTCP_Receiver_ProcessCompoundPacket(receiver->rtcpMsgBuffer, (unsigned int)bytes,
-                                                                curTime, &receiver->rtcpReceiverContext);
+                                                                curTime, rtcpContext);
+            ARSAL_Mutex_Unlock(&(receiver->shared.mutex));
             if (ret != 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RECEIVER_TAG, "Failed to process compound RTCP packet (%d)", ret);
@@ -1427,11 +2102,9 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtcp(ARSTREAM2_RtpReceiver_t *rece
             }
 
             receiver->rtcpReceiverContext.lastRtcpTimestamp = curTime;
-            rrDelay = 0;
             receiver->nextRrDelay = (size + ARSTREAM2_RTP_UDP_HEADER_SIZE + ARSTREAM2_RTP_IP_HEADER_SIZE) * 1000000 / receiver->rtcpReceiverContext.rtcpByteRate;
             if (receiver->nextRrDelay < ARSTREAM2_RTCP_RECEIVER_MIN_PACKET_TIME_INTERVAL) receiver->nextRrDelay = ARSTREAM2_RTCP_RECEIVER_MIN_PACKET_TIME_INTERVAL;
         }
-        receiver->nextRrDelay = receiver->nextRrDelay - rrDelay;
     }
 
     return retVal;
@@ -1634,9 +2307,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_GetMonitoring(ARSTREAM2_RtpReceiver_t *re
 
     if (startTime == 0)
     {
-        struct timespec t1;
-        ARSAL_Time_GetTime(&t1);
-        startTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+        startTime = ARSTREAM2_Clock_GetTime(&receiver->clock);
     }
     endTime = startTime;
 
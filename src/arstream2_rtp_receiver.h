@@ -30,6 +30,9 @@
 #include "arstream2_rtp_h264.h"
 #include "arstream2_rtcp.h"
 #include "arstream2_h264.h"
+#include "arstream2_pcap.h"
+#include "arstream2_net_impairment_internal.h"
+#include "arstream2_clock_internal.h"
 
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Mutex.h>
@@ -54,6 +57,16 @@
 
 #define ARSTREAM2_RTP_RECEIVER_RTCP_DROP_LOG_INTERVAL (10)
 
+/**
+ * Capture file write batch size in bytes
+ */
+#define ARSTREAM2_RTP_RECEIVER_CAPTURE_BATCH_SIZE (256 * 1024)
+
+/**
+ * Maximum number of receivers sharing the transport of another receiver
+ */
+#define ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS (8)
+
 
 /**
  * @brief RtpReceiver net configuration parameters
@@ -68,6 +81,11 @@ typedef struct ARSTREAM2_RtpReceiver_NetConfig_t
     int clientStreamPort;                           /**< Client stream port */
     int clientControlPort;                          /**< Client control port */
     eARSAL_SOCKET_CLASS_SELECTOR classSelector;     /**< Type of Service class selector */
+    int streamIngest;                               /**< Boolean-like (0-1) flag: if active no stream socket is opened, RTP packets are provided through ARSTREAM2_RtpReceiver_IngestPackets() */
+    struct ARSTREAM2_RtpReceiver_t *transport;      /**< Receiver whose channels are shared, the streams being demultiplexed by SSRC (optional, can be NULL; the other net config parameters are then ignored) */
+    uint32_t ssrc;                                  /**< Stream SSRC (required with a shared transport) */
+    const struct ARSTREAM2_RtpReceiver_Ops_t *ops;  /**< Custom channel operations, e.g. to replay a capture (optional, can be NULL; the addresses are then ignored and the ports are only used for the capture file) */
+    void *opsUserPtr;                               /**< Custom channel operations user pointer */
 } ARSTREAM2_RtpReceiver_NetConfig_t;
 
 // Forward declaration of the mux_ctx structure
@@ -97,6 +115,9 @@ typedef struct ARSTREAM2_RtpReceiver_Config_t
     int insertStartCodes;                           /**< Boolean-like (0-1) flag: if active insert a start code prefix before NAL units */
     int generateReceiverReports;                    /**< Boolean-like (0-1) flag: if active generate RTCP receiver reports */
     uint32_t videoStatsSendTimeInterval;            /**< Time interval for sending video stats in compound RTCP packets (optional, can be null) */
+    const char *captureFileName;                    /**< pcapng capture file of the received RTP and RTCP packets (optional, NULL to disable) */
+    const ARSTREAM2_NetImpairment_Config_t *impairment;  /**< Network impairment emulation on the received RTP packets (optional, can be NULL; ignored for a receiver sharing a transport) */
+    const ARSTREAM2_Clock_t *clock;                 /**< Time source (optional, NULL for the monotonic clock) */
 } ARSTREAM2_RtpReceiver_Config_t;
 
 
@@ -139,6 +160,39 @@ struct ARSTREAM2_RtpReceiver_MuxInfos_t {
     struct mux_queue *data;
 };
 
+struct ARSTREAM2_RtpReceiver_IngestInfos_t {
+    /* Packets received by the caller for the current processing pass */
+    struct mmsghdr **msgVec;
+    unsigned int msgCount;
+    unsigned int msgIndex;
+    unsigned int dropCount;
+};
+
+struct ARSTREAM2_RtpReceiver_SharedInfos_t {
+    /* Receiver owning the channels (NULL if the receiver owns its channels) */
+    struct ARSTREAM2_RtpReceiver_t *transport;
+    uint32_t ssrc;
+
+    /* Copies of the packets demultiplexed by the transport for the current processing pass */
+    struct mmsghdr *msgVec;
+    struct mmsghdr **msgPtr;
+    unsigned int msgCount;
+
+    /* Receivers sharing the channels */
+    ARSAL_Mutex_t mutex;
+    struct ARSTREAM2_RtpReceiver_t *stream[ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS];
+    int streamCount;
+};
+
+/**
+ * @brief RtpReceiver channel operations
+ *
+ * The functions return 0 or a positive value on success and a negative value on error.
+ * streamChannelRecvMmsg() fills the messages as recvmmsg() would and returns the number
+ * of messages; controlChannelRead() returns the packet size or -1 with errno set to EAGAIN
+ * when no packet is available. The user pointer of custom operations is available as
+ * the receiver opsUserPtr.
+ */
 struct ARSTREAM2_RtpReceiver_Ops_t {
     /* Stream channel */
     int (*streamChannelSetup)(ARSTREAM2_RtpReceiver_t *);
@@ -163,8 +217,13 @@ struct ARSTREAM2_RtpReceiver_Ops_t {
 struct ARSTREAM2_RtpReceiver_t {
     /* Configuration on New */
     int useMux;
+    int useIngest;
+    int useCustomOps;
+    void *opsUserPtr;
     struct ARSTREAM2_RtpReceiver_NetInfos_t net;
     struct ARSTREAM2_RtpReceiver_MuxInfos_t mux;
+    struct ARSTREAM2_RtpReceiver_IngestInfos_t ingest;
+    struct ARSTREAM2_RtpReceiver_SharedInfos_t shared;
     struct ARSTREAM2_RtpReceiver_Ops_t ops;
 
     /* Process context */
@@ -196,6 +255,17 @@ struct ARSTREAM2_RtpReceiver_t {
     unsigned int rtcpDropCount;
     unsigned int rtcpDropStatsTotalPackets;
     uint64_t rtcpDropLogStartTime;
+
+    /* Capture */
+    ARSTREAM2_PcapWriter_t *capture;
+    uint8_t *captureControlBuffer;
+    size_t captureControlSize;
+
+    /* Network impairment emulation */
+    ARSTREAM2_NetImpairment_t *impairment;
+
+    /* Time source */
+    ARSTREAM2_Clock_t clock;
 };
 
 
@@ -243,11 +313,39 @@ void ARSTREAM2_RtpReceiver_Stop(ARSTREAM2_RtpReceiver_t *receiver);
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_Delete(ARSTREAM2_RtpReceiver_t **receiver);
 
 
+/**
+ * @brief Get the number of receivers sharing the receiver transport
+ *
+ * @param[in] receiver The receiver instance
+ *
+ * @return The number of receivers that were created with this receiver as transport, or -1 on error
+ */
+int ARSTREAM2_RtpReceiver_GetSharedStreamCount(ARSTREAM2_RtpReceiver_t *receiver);
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_GetSelectParams(ARSTREAM2_RtpReceiver_t *receiver, fd_set **readSet, fd_set **writeSet, fd_set **exceptSet, int *maxFd, uint32_t *nextTimeout);
 
 
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtp(ARSTREAM2_RtpReceiver_t *receiver, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
-                                                  int *shouldStop, ARSTREAM2_RTP_PacketFifoQueue_t **resendQueue, uint32_t *resendTimeout, unsigned int resendCount);
+                                                  int *shouldStop, ARSTREAM2_RTP_PacketRing_t **resendRing, unsigned int resendCount);
+
+
+/**
+ * @brief Provide the RTP packets for the next ARSTREAM2_RtpReceiver_ProcessRtp() call
+ *
+ * Only valid for a receiver created with the streamIngest net config flag.
+ * The packets are copied into the packet FIFO
+ * during the next call to ARSTREAM2_RtpReceiver_ProcessRtp(), after which the messages
+ * are no longer referenced. Packets that do not fit in the packet FIFO are dropped.
+ *
+ * @param[in] receiver The receiver instance
+ * @param[in] msgVec Array of pointers to the received messages
+ * @param[in] msgCount Number of messages
+ *
+ * @return ARSTREAM2_OK if no error occurred.
+ * @return an eARSTREAM2_ERROR error code if an error occurred.
+ */
+eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_IngestPackets(ARSTREAM2_RtpReceiver_t *receiver, struct mmsghdr **msgVec, unsigned int msgCount);
 
 
 eARSTREAM2_ERROR ARSTREAM2_RtpReceiver_ProcessRtcp(ARSTREAM2_RtpReceiver_t *receiver, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet, int *shouldStop);
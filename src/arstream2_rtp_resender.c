@@ -0,0 +1,862 @@
+/**
+ * @file arstream2_rtp_resender.c
+ * @brief Parrot Streaming Library - RTP Resender
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#define __USE_GNU
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Time.h>
+
+#include "arstream2_rtp_resender.h"
+
+
+#define ARSTREAM2_RTP_RESENDER_TAG "ARSTREAM2_RtpResender"
+
+#define ARSTREAM2_RTP_RESENDER_IDLE_TIMEOUT_US (100000)
+
+
+static int ARSTREAM2_RtpResender_SameLocalAddr(const ARSTREAM2_RtpResender_t *r1, const ARSTREAM2_RtpResender_t *r2)
+{
+    return ((r1->localAddrLen > 0) && (r1->localAddrLen == r2->localAddrLen)
+            && (memcmp(&r1->localAddr, &r2->localAddr, r1->localAddrLen) == 0)) ? 1 : 0;
+}
+
+
+static void ARSTREAM2_RtpResender_FanOutUpdateBatchSockets(ARSTREAM2_RtpResender_FanOut_t *fanOut)
+{
+    ARSTREAM2_RtpResender_t *r, *lead;
+    int sendBufferSize[ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS];
+    int i, j;
+
+    /* the sockets may change: retry the blocked destinations */
+    fanOut->blockedMask = 0;
+
+    /* the unicast destinations whose sockets share the same local address and port
+       are sent through the socket of the first one (the destination address is set
+       per message), so that the RTP source port stays the configured one; multicast
+       destinations keep their own socket which is bound to the multicast interface */
+    memset(sendBufferSize, 0, sizeof(sendBufferSize));
+    for (i = 0; i < ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS; i++)
+    {
+        r = fanOut->destination[i];
+        if (!r)
+        {
+            continue;
+        }
+        lead = r;
+        for (j = 0; (j < i) && (!r->isMulticast); j++)
+        {
+            if ((fanOut->destination[j]) && (!fanOut->destination[j]->isMulticast)
+                    && (fanOut->destination[j]->batchSocket == fanOut->destination[j]->streamSocket)
+                    && (ARSTREAM2_RtpResender_SameLocalAddr(fanOut->destination[j], r)))
+            {
+                lead = fanOut->destination[j];
+                break;
+            }
+        }
+        r->batchSocket = lead->streamSocket;
+        sendBufferSize[lead->index] += r->streamSocketSendBufferSize;
+    }
+
+    for (i = 0; i < ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS; i++)
+    {
+        lead = fanOut->destination[i];
+        if ((lead) && (lead->batchSocket == lead->streamSocket) && (sendBufferSize[i] > lead->streamSocketSendBufferSize))
+        {
+            int err = setsockopt(lead->streamSocket, SOL_SOCKET, SO_SNDBUF, (void*)&sendBufferSize[i], sizeof(sendBufferSize[i]));
+            if (err != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RESENDER_TAG, "Failed to set the send socket buffer size: error=%d (%s)", errno, strerror(errno));
+            }
+        }
+    }
+}
+
+
+static int ARSTREAM2_RtpResender_FanOutSendBatch(ARSTREAM2_RtpResender_FanOut_t *fanOut, unsigned int tail, unsigned int end,
+                                                 int batchSocket, uint64_t socketMask)
+{
+    ARSTREAM2_RTP_PacketRing_t *ring = &fanOut->packetRing;
+    ARSTREAM2_RTP_PacketRingEntry_t *entry;
+    ARSTREAM2_RtpResender_Slot_t *slot;
+    ARSTREAM2_RtpResender_t *r;
+    uint32_t sentPackets[ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS];
+    uint64_t sentBytes[ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS];
+    unsigned int idx, mask = ring->size - 1;
+    uint64_t m;
+    int n = 0, i, d, ret, sentCount, dropUnsent = 0, more = 0;
+
+    /* one message per pending (packet, destination) pair, packet-major so that a
+       partial send leaves the oldest packets sent to every destination */
+    for (idx = tail; (idx != end) && (n < fanOut->batchSize); idx++)
+    {
+        m = fanOut->pendingMask[idx & mask] & socketMask;
+        if (!m)
+        {
+            continue;
+        }
+        entry = ARSTREAM2_RTP_PacketRingGetEntry(ring, idx);
+        for (; (m) && (n < fanOut->batchSize); m &= m - 1)
+        {
+            d = __builtin_ctzll(m);
+            r = fanOut->destination[d];
+            slot = &fanOut->slot[n];
+
+            /* only the RTP header is rewritten, the payload iovec points to the received buffer */
+            memcpy(&slot->header, entry->packet.buffer->header, sizeof(ARSTREAM2_RTP_Header_t));
+            slot->header.seqNum = htons((uint16_t)(entry->packet.seqNum + r->seqNumOffset));
+            slot->header.ssrc = htonl(r->ssrc);
+            slot->iov[0].iov_base = &slot->header;
+            slot->iov[0].iov_len = sizeof(ARSTREAM2_RTP_Header_t);
+            slot->iov[1] = entry->packet.buffer->msgIov[1];
+            slot->entryIndex = idx;
+            slot->destination = d;
+
+            fanOut->msgVec[n].msg_hdr.msg_name = (void*)r->sendAddr;
+            fanOut->msgVec[n].msg_hdr.msg_namelen = r->sendAddrLen;
+            fanOut->msgVec[n].msg_hdr.msg_iov = slot->iov;
+            fanOut->msgVec[n].msg_hdr.msg_iovlen = 2;
+            fanOut->msgVec[n].msg_hdr.msg_control = NULL;
+            fanOut->msgVec[n].msg_hdr.msg_controllen = 0;
+            fanOut->msgVec[n].msg_hdr.msg_flags = 0;
+            fanOut->msgVec[n].msg_len = 0;
+            n++;
+        }
+    }
+
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    while (((ret = sendmmsg(batchSocket, fanOut->msgVec, n, 0)) == -1) && (errno == EINTR));
+    if (ret < 0)
+    {
+        sentCount = 0;
+        if (errno != EAGAIN)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Stream socket - sendmmsg error (%d): %s", errno, strerror(errno));
+            dropUnsent = 1;
+        }
+    }
+    else
+    {
+        sentCount = ret;
+    }
+
+    memset(sentPackets, 0, sizeof(sentPackets));
+    memset(sentBytes, 0, sizeof(sentBytes));
+    for (i = 0; i < n; i++)
+    {
+        slot = &fanOut->slot[i];
+        if (i < sentCount)
+        {
+            sentPackets[slot->destination]++;
+            sentBytes[slot->destination] += slot->iov[1].iov_len;
+        }
+        else if (dropUnsent)
+        {
+            fanOut->destination[slot->destination]->dropCount++;
+        }
+        else
+        {
+            continue;
+        }
+        fanOut->pendingMask[slot->entryIndex & mask] &= ~(1ULL << slot->destination);
+    }
+    for (m = socketMask; m; m &= m - 1)
+    {
+        d = __builtin_ctzll(m);
+        if (sentPackets[d])
+        {
+            ARSTREAM2_RtpSender_AddSentPackets(fanOut->destination[d]->sender, sentPackets[d], sentBytes[d]);
+        }
+    }
+
+    if ((sentCount < n) && (!dropUnsent))
+    {
+        /* socket buffer full: wait for the socket to be writable */
+        fanOut->blockedMask |= socketMask;
+    }
+    else if (n == fanOut->batchSize)
+    {
+        more = 1;
+    }
+
+    return more;
+}
+
+
+static int ARSTREAM2_RtpResender_FanOutProcessPackets(ARSTREAM2_RtpResender_FanOut_t *fanOut, uint64_t curTime)
+{
+    ARSTREAM2_RTP_PacketRing_t *ring = &fanOut->packetRing;
+    ARSTREAM2_RTP_PacketRingEntry_t *entry;
+    ARSTREAM2_RtpResender_t *r;
+    unsigned int tail, end, idx, released, mask = ring->size - 1;
+    uint64_t m, remaining, socketMask;
+    int pending, d, batchSocket, more = 0;
+
+    pending = ARSTREAM2_RTP_PacketRingGetPending(ring, &tail);
+    if (pending <= 0)
+    {
+        return 0;
+    }
+    end = tail + (unsigned int)pending;
+
+    /* the new packets are pending for all the current destinations */
+    for (idx = fanOut->maskedHead; idx != end; idx++)
+    {
+        fanOut->pendingMask[idx & mask] = fanOut->activeMask;
+    }
+    fanOut->maskedHead = end;
+
+    /* single timeout walk for all the destinations */
+    for (idx = tail; idx != end; idx++)
+    {
+        entry = ARSTREAM2_RTP_PacketRingGetEntry(ring, idx);
+        for (m = fanOut->pendingMask[idx & mask]; m; m &= m - 1)
+        {
+            d = __builtin_ctzll(m);
+            r = fanOut->destination[d];
+            if ((r->maxNetworkLatencyUs) && (curTime > entry->info.inputTimestamp + r->maxNetworkLatencyUs))
+            {
+                fanOut->pendingMask[idx & mask] &= ~(1ULL << d);
+                r->dropCount++;
+            }
+        }
+    }
+
+    /* one sendmmsg() batch per socket */
+    remaining = fanOut->activeMask & ~fanOut->blockedMask;
+    while (remaining)
+    {
+        batchSocket = fanOut->destination[__builtin_ctzll(remaining)]->batchSocket;
+        for (m = remaining, socketMask = 0; m; m &= m - 1)
+        {
+            d = __builtin_ctzll(m);
+            if (fanOut->destination[d]->batchSocket == batchSocket)
+            {
+                socketMask |= (1ULL << d);
+            }
+        }
+        remaining &= ~socketMask;
+        more |= ARSTREAM2_RtpResender_FanOutSendBatch(fanOut, tail, end, batchSocket, socketMask);
+    }
+
+    /* release the packets that are no longer pending for any destination */
+    for (idx = tail, released = 0; (idx != end) && (fanOut->pendingMask[idx & mask] == 0); idx++)
+    {
+        released++;
+    }
+    if (released > 0)
+    {
+        ARSTREAM2_RTP_PacketRingRelease(ring, &fanOut->packetFifo, released);
+    }
+
+    return more;
+}
+
+
+static void* ARSTREAM2_RtpResender_FanOutRunThread(void *fanOutPtr)
+{
+    ARSTREAM2_RtpResender_FanOut_t *fanOut = (ARSTREAM2_RtpResender_FanOut_t*)fanOutPtr;
+    ARSTREAM2_RtpResender_t *r;
+    fd_set readSet, writeSet, exceptSet;
+    fd_set *pReadSet = &readSet, *pWriteSet = &writeSet, *pExceptSet = &exceptSet;
+    int shouldStop, selectRet, maxFd, _maxFd, more = 0;
+    unsigned int dropCount;
+    uint32_t nextTimeout, _timeout;
+    struct timeval tv;
+    uint64_t curTime;
+    eARSTREAM2_ERROR err;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_RTP_RESENDER_TAG, "Fan-out thread running");
+
+    ARSAL_Mutex_Lock(&(fanOut->mutex));
+    shouldStop = fanOut->threadShouldStop;
+    ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+    while (shouldStop == 0)
+    {
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        FD_ZERO(&exceptSet);
+        FD_SET(fanOut->signalPipe[0], &readSet);
+        maxFd = fanOut->signalPipe[0];
+        nextTimeout = ARSTREAM2_RTP_RESENDER_IDLE_TIMEOUT_US;
+
+        ARSAL_Mutex_Lock(&(fanOut->mutex));
+        for (r = fanOut->resender; r; r = r->next)
+        {
+            err = ARSTREAM2_RtpSender_GetSelectParams(r->sender, &pReadSet, &pWriteSet, &pExceptSet, &_maxFd, &_timeout);
+            if (err != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSTREAM2_RtpSender_GetSelectParams() failed (%d)", err);
+                continue;
+            }
+            if (_maxFd > maxFd) maxFd = _maxFd;
+            if (_timeout < nextTimeout) nextTimeout = _timeout;
+            if (fanOut->blockedMask & (1ULL << r->index))
+            {
+                FD_SET(r->batchSocket, &writeSet);
+                if (r->batchSocket > maxFd) maxFd = r->batchSocket;
+            }
+        }
+        /* the sets no longer contain the sockets of the removed destinations */
+        fanOut->selectGeneration++;
+        ARSAL_Cond_Broadcast(&(fanOut->selectCond));
+        ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+        if (more)
+        {
+            nextTimeout = 0;
+        }
+        tv.tv_sec = nextTimeout / 1000000;
+        tv.tv_usec = nextTimeout % 1000000;
+        while (((selectRet = select(maxFd + 1, &readSet, &writeSet, &exceptSet, &tv)) == -1) && (errno == EINTR));
+        if (selectRet < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Select error (%d): %s", errno, strerror(errno));
+        }
+
+        if ((selectRet > 0) && (FD_ISSET(fanOut->signalPipe[0], &readSet)))
+        {
+            /* Dump bytes (so it won't be ready next time) */
+            char dump[10];
+            int readRet;
+            while (((readRet = read(fanOut->signalPipe[0], &dump, 10)) == -1) && (errno == EINTR));
+            if ((readRet < 0) && (errno != EAGAIN))
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Failed to read from pipe (%d): %s", errno, strerror(errno));
+            }
+        }
+
+        /* re-arm the wake-up before processing so that no push can be missed */
+        __atomic_store_n(&fanOut->wakeupPending, 0, __ATOMIC_SEQ_CST);
+
+        curTime = ARSTREAM2_Clock_GetTime(&fanOut->clock);
+
+        ARSAL_Mutex_Lock(&(fanOut->mutex));
+        for (r = fanOut->resender; r; r = r->next)
+        {
+            if (selectRet >= 0)
+            {
+                err = ARSTREAM2_RtpSender_ProcessRtcp(r->sender, selectRet, &readSet, &writeSet, &exceptSet);
+                if (err != ARSTREAM2_OK)
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSTREAM2_RtpSender_ProcessRtcp() failed (%d)", err);
+                }
+            }
+            if ((selectRet > 0) && (fanOut->blockedMask & (1ULL << r->index)) && (FD_ISSET(r->batchSocket, &writeSet)))
+            {
+                fanOut->blockedMask &= ~(1ULL << r->index);
+            }
+        }
+
+        more = ARSTREAM2_RtpResender_FanOutProcessPackets(fanOut, curTime);
+
+        for (r = fanOut->resender; r; r = r->next)
+        {
+            if (r->dropCount != r->reportedDropCount)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RESENDER_TAG, "Destination #%d: %u packets dropped on timeout or error (%u total)",
+                            r->index, r->dropCount - r->reportedDropCount, r->dropCount);
+                r->reportedDropCount = r->dropCount;
+            }
+        }
+        shouldStop = fanOut->threadShouldStop;
+        ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+        dropCount = __atomic_load_n(&fanOut->packetRing.dropCount, __ATOMIC_RELAXED);
+        if (dropCount != fanOut->reportedDropCount)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RESENDER_TAG, "Fan-out is late: %u packets dropped (%u total)",
+                        dropCount - fanOut->reportedDropCount, dropCount);
+            fanOut->reportedDropCount = dropCount;
+        }
+    }
+
+    ARSAL_Mutex_Lock(&(fanOut->mutex));
+    fanOut->threadEnded = 1;
+    ARSAL_Cond_Broadcast(&(fanOut->selectCond));
+    ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_RTP_RESENDER_TAG, "Fan-out thread has ended");
+
+    return (void*)0;
+}
+
+
+void ARSTREAM2_RtpResender_FanOutSignal(ARSTREAM2_RtpResender_FanOut_t *fanOut)
+{
+    unsigned int head;
+    char * buff = "x";
+    int ret;
+
+    if (!fanOut)
+    {
+        return;
+    }
+
+    head = __atomic_load_n(&fanOut->packetRing.head, __ATOMIC_RELAXED);
+    if (head == fanOut->signaledHead)
+    {
+        return;
+    }
+    fanOut->signaledHead = head;
+
+    /* at most one byte in flight: the non-blocking write cannot stall the caller */
+    if (!__atomic_exchange_n(&fanOut->wakeupPending, 1, __ATOMIC_SEQ_CST))
+    {
+        while (((ret = write(fanOut->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
+    }
+}
+
+
+ARSTREAM2_RtpResender_FanOut_t* ARSTREAM2_RtpResender_FanOutNew(const ARSTREAM2_RtpResender_FanOutConfig_t *config, eARSTREAM2_ERROR *error)
+{
+    ARSTREAM2_RtpResender_FanOut_t *fanOut = NULL;
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    int mutexWasInit = 0, condWasInit = 0, packetFifoWasInit = 0, packetRingWasInit = 0;
+
+    if ((!config) || (config->packetRingSize <= 0) || (config->batchSize < 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Invalid configuration");
+        ret = ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* keep the producer and consumer ring indexes on their own cache lines */
+        if (posix_memalign((void**)&fanOut, ARSTREAM2_RTP_CACHE_LINE_SIZE, sizeof(*fanOut)) != 0)
+        {
+            fanOut = NULL;
+        }
+        if (!fanOut)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Allocation failed (size %zu)", sizeof(*fanOut));
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            memset(fanOut, 0, sizeof(*fanOut));
+            fanOut->signalPipe[0] = -1;
+            fanOut->signalPipe[1] = -1;
+            fanOut->batchSize = ((config->batchSize > 0) && (config->batchSize < ARSTREAM2_RTP_RESENDER_MAX_BATCH_SIZE)) ? config->batchSize : ARSTREAM2_RTP_RESENDER_MAX_BATCH_SIZE;
+            if (config->clock) fanOut->clock = *config->clock;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(fanOut->mutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            mutexWasInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int condInitRet = ARSAL_Cond_Init(&(fanOut->selectCond));
+        if (condInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Cond creation failed (%d)", condInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            condWasInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int ringRet = ARSTREAM2_RTP_PacketRingInit(&fanOut->packetRing, (unsigned int)config->packetRingSize);
+        if (ringRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSTREAM2_RTP_PacketRingInit() failed (%d)", ringRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            packetRingWasInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        fanOut->pendingMask = malloc(fanOut->packetRing.size * sizeof(uint64_t));
+        fanOut->msgVec = malloc(fanOut->batchSize * sizeof(struct mmsghdr));
+        fanOut->slot = malloc(fanOut->batchSize * sizeof(ARSTREAM2_RtpResender_Slot_t));
+        if ((!fanOut->pendingMask) || (!fanOut->msgVec) || (!fanOut->slot))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Fan-out allocation failed");
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* items-only FIFO: the packet buffers belong to the receiver FIFO */
+        int packetFifoRet = ARSTREAM2_RTP_PacketFifoInit(&fanOut->packetFifo, 1, 0, 0, 0, 0);
+        if (packetFifoRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSTREAM2_RTP_PacketFifoInit() failed (%d)", packetFifoRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            packetFifoWasInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        if (pipe(fanOut->signalPipe) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Failed to create pipe (%d): %s", errno, strerror(errno));
+            fanOut->signalPipe[0] = -1;
+            fanOut->signalPipe[1] = -1;
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+        else
+        {
+            fcntl(fanOut->signalPipe[0], F_SETFL, fcntl(fanOut->signalPipe[0], F_GETFL, 0) | O_NONBLOCK);
+            fcntl(fanOut->signalPipe[1], F_SETFL, fcntl(fanOut->signalPipe[1], F_GETFL, 0) | O_NONBLOCK);
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int thErr = ARSAL_Thread_Create(&fanOut->thread, ARSTREAM2_RtpResender_FanOutRunThread, (void*)fanOut);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Fan-out thread creation failed (%d)", thErr);
+            fanOut->thread = NULL;
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if ((ret != ARSTREAM2_OK) && (fanOut))
+    {
+        if (fanOut->signalPipe[0] != -1) close(fanOut->signalPipe[0]);
+        if (fanOut->signalPipe[1] != -1) close(fanOut->signalPipe[1]);
+        if (packetFifoWasInit) ARSTREAM2_RTP_PacketFifoFree(&fanOut->packetFifo);
+        if (packetRingWasInit) ARSTREAM2_RTP_PacketRingFree(&fanOut->packetRing);
+        if (condWasInit) ARSAL_Cond_Destroy(&(fanOut->selectCond));
+        if (mutexWasInit) ARSAL_Mutex_Destroy(&(fanOut->mutex));
+        free(fanOut->pendingMask);
+        free(fanOut->msgVec);
+        free(fanOut->slot);
+        free(fanOut);
+        fanOut = NULL;
+    }
+
+    if (error)
+    {
+        *error = ret;
+    }
+
+    return fanOut;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_RtpResender_FanOutDelete(ARSTREAM2_RtpResender_FanOut_t **fanOut)
+{
+    ARSTREAM2_RtpResender_FanOut_t *f;
+    ARSTREAM2_RtpResender_t *r;
+    char * buff = "x";
+    int err;
+
+    if ((!fanOut) || (!*fanOut))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    f = *fanOut;
+
+    ARSAL_Mutex_Lock(&(f->mutex));
+    f->threadShouldStop = 1;
+    ARSAL_Mutex_Unlock(&(f->mutex));
+    while (((err = write(f->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
+
+    err = ARSAL_Thread_Join(f->thread, NULL);
+    if (err != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSAL_Thread_Join() failed (%d)", err);
+    }
+    err = ARSAL_Thread_Destroy(&(f->thread));
+    if (err != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSAL_Thread_Destroy() failed (%d)", err);
+    }
+
+    while ((r = f->resender) != NULL)
+    {
+        ARSTREAM2_RtpResender_Delete(&r);
+    }
+
+    /* release the pending packets (the buffers go back to their owner FIFO) */
+    ARSTREAM2_RTP_PacketRingFlush(&f->packetRing, &f->packetFifo);
+
+    ARSTREAM2_RTP_PacketFifoFree(&f->packetFifo);
+    ARSTREAM2_RTP_PacketRingFree(&f->packetRing);
+    while (((err = close(f->signalPipe[0])) == -1) && (errno == EINTR));
+    while (((err = close(f->signalPipe[1])) == -1) && (errno == EINTR));
+    ARSAL_Cond_Destroy(&(f->selectCond));
+    ARSAL_Mutex_Destroy(&(f->mutex));
+    free(f->pendingMask);
+    free(f->msgVec);
+    free(f->slot);
+
+    free(f);
+    *fanOut = NULL;
+
+    return ARSTREAM2_OK;
+}
+
+
+int ARSTREAM2_RtpResender_FanOutGetDestinationCount(ARSTREAM2_RtpResender_FanOut_t *fanOut)
+{
+    int count;
+
+    if (!fanOut)
+    {
+        return -1;
+    }
+
+    ARSAL_Mutex_Lock(&(fanOut->mutex));
+    count = __builtin_popcountll(fanOut->activeMask);
+    ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+    return count;
+}
+
+
+ARSTREAM2_RtpResender_t* ARSTREAM2_RtpResender_New(ARSTREAM2_RtpResender_FanOut_t *fanOut, const ARSTREAM2_RtpResender_Config_t *config, eARSTREAM2_ERROR *error)
+{
+    ARSTREAM2_RtpResender_t *resender = NULL;
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    int packetFifoQueueCreated = 0;
+
+    if ((!fanOut) || (!config))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Invalid pointer");
+        if (error)
+        {
+            *error = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        return NULL;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        resender = malloc(sizeof(*resender));
+        if (!resender)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Allocation failed (size %zu)", sizeof(*resender));
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            memset(resender, 0, sizeof(*resender));
+            resender->fanOut = fanOut;
+            resender->index = -1;
+            resender->streamSocketSendBufferSize = config->senderConfig.streamSocketSendBufferSize;
+            resender->maxNetworkLatencyUs = config->maxNetworkLatencyUs;
+            /* each relayed session starts at a random sequence number (RFC3550) */
+            resender->seqNumOffset = (uint16_t)(rand() & 0xFFFF);
+        }
+    }
+
+    ARSAL_Mutex_Lock(&(fanOut->mutex));
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int i;
+        for (i = 0; i < ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS; i++)
+        {
+            if (!fanOut->destination[i])
+            {
+                resender->index = i;
+                break;
+            }
+        }
+        if (resender->index < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Too many destinations (max %d)", ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS);
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int packetFifoRet = ARSTREAM2_RTP_PacketFifoAddQueue(&fanOut->packetFifo, &resender->packetFifoQueue);
+        if (packetFifoRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "ARSTREAM2_RTP_PacketFifoAddQueue() failed (%d)", packetFifoRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            packetFifoQueueCreated = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* the sender handles RTCP, the RTP packets are sent by the fan-out */
+        ARSTREAM2_RtpSender_Config_t senderConfig = config->senderConfig;
+        senderConfig.naluFifo = NULL;
+        senderConfig.packetFifo = &fanOut->packetFifo;
+        senderConfig.packetFifoQueue = &resender->packetFifoQueue;
+        senderConfig.msgVecCount = 1;
+
+        resender->sender = ARSTREAM2_RtpSender_New(&senderConfig, &ret);
+        if (ret != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Error while creating sender : %s", ARSTREAM2_Error_ToString(ret));
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        ret = ARSTREAM2_RtpSender_GetStreamParams(resender->sender, &resender->streamSocket, &resender->sendAddr, &resender->sendAddrLen,
+                                                  &resender->ssrc, &resender->isMulticast);
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* the local address decides which destinations can share a sendmmsg() batch */
+        resender->localAddrLen = sizeof(resender->localAddr);
+        if (getsockname(resender->streamSocket, (struct sockaddr*)&resender->localAddr, &resender->localAddrLen) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_RESENDER_TAG, "Failed to get the stream socket address: error=%d (%s)", errno, strerror(errno));
+            resender->localAddrLen = 0;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        fanOut->destination[resender->index] = resender;
+        fanOut->activeMask |= (1ULL << resender->index);
+        resender->prev = NULL;
+        resender->next = fanOut->resender;
+        if (resender->next)
+        {
+            resender->next->prev = resender;
+        }
+        fanOut->resender = resender;
+        ARSTREAM2_RtpResender_FanOutUpdateBatchSockets(fanOut);
+    }
+    else if (resender)
+    {
+        if (resender->sender) ARSTREAM2_RtpSender_Delete(&(resender->sender));
+        if (packetFifoQueueCreated) ARSTREAM2_RTP_PacketFifoRemoveQueue(&fanOut->packetFifo, &resender->packetFifoQueue);
+        free(resender);
+        resender = NULL;
+    }
+
+    ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+    if (error)
+    {
+        *error = ret;
+    }
+
+    return resender;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_RtpResender_Delete(ARSTREAM2_RtpResender_t **resender)
+{
+    ARSTREAM2_RtpResender_t *r;
+    ARSTREAM2_RtpResender_FanOut_t *fanOut;
+    unsigned int tail, idx, mask, generation;
+    char * buff = "x";
+    int err;
+    eARSTREAM2_ERROR ret;
+
+    if ((!resender) || (!*resender))
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    r = *resender;
+    fanOut = r->fanOut;
+
+    ARSAL_Mutex_Lock(&(fanOut->mutex));
+
+    /* the packets are no longer pending for this destination */
+    if (ARSTREAM2_RTP_PacketRingGetPending(&fanOut->packetRing, &tail) >= 0)
+    {
+        mask = fanOut->packetRing.size - 1;
+        for (idx = tail; idx != fanOut->maskedHead; idx++)
+        {
+            fanOut->pendingMask[idx & mask] &= ~(1ULL << r->index);
+        }
+    }
+    fanOut->destination[r->index] = NULL;
+    fanOut->activeMask &= ~(1ULL << r->index);
+    fanOut->blockedMask &= ~(1ULL << r->index);
+
+    if (r->prev)
+    {
+        r->prev->next = r->next;
+    }
+    if (r->next)
+    {
+        r->next->prev = r->prev;
+    }
+    if (r == fanOut->resender)
+    {
+        fanOut->resender = r->next;
+    }
+    ARSTREAM2_RtpResender_FanOutUpdateBatchSockets(fanOut);
+
+    /* the sender sockets are closed only once the fan-out thread has rebuilt
+       its select sets without them: wake it up and wait for the new sets */
+    generation = fanOut->selectGeneration;
+    if (!fanOut->threadEnded)
+    {
+        while (((err = write(fanOut->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
+    }
+    while ((fanOut->selectGeneration == generation) && (!fanOut->threadEnded))
+    {
+        ARSAL_Cond_Wait(&(fanOut->selectCond), &(fanOut->mutex));
+    }
+
+    ret = ARSTREAM2_RtpSender_Delete(&r->sender);
+    if (ret != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_RESENDER_TAG, "Unable to delete sender: %s", ARSTREAM2_Error_ToString(ret));
+    }
+    ARSTREAM2_RTP_PacketFifoRemoveQueue(&fanOut->packetFifo, &r->packetFifoQueue);
+
+    ARSAL_Mutex_Unlock(&(fanOut->mutex));
+
+    free(r);
+    *resender = NULL;
+
+    return ARSTREAM2_OK;
+}
@@ -12,6 +12,9 @@
 
 #include <inttypes.h>
 
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+
 #include <libARStream2/arstream2_error.h>
 #include "arstream2_rtp_sender.h"
 #include "arstream2_rtp.h"
@@ -26,17 +29,199 @@
 #define ARSTREAM2_RTP_RESENDER_DEFAULT_STREAM_SOCKET_SEND_BUFFER_SIZE (10000000 * 100 / 1000 / 8)
 
 
+/**
+ * Maximum number of destinations of a fan-out (bits of the pending packet masks)
+ */
+#define ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS (64)
+
+
+/**
+ * Maximum number of messages in a sendmmsg() batch
+ */
+#define ARSTREAM2_RTP_RESENDER_MAX_BATCH_SIZE (1024)
+
+
+/**
+ * @brief RtpResender fan-out configuration parameters
+ */
+typedef struct ARSTREAM2_RtpResender_FanOutConfig_t
+{
+    int packetRingSize;                             /**< Maximum number of packets pending between the receiver and the fan-out threads */
+    int batchSize;                                  /**< Maximum number of messages per sendmmsg() call (optional, 0 for the maximum) */
+    const ARSTREAM2_Clock_t *clock;                 /**< Time source (optional, NULL for the monotonic clock) */
+
+} ARSTREAM2_RtpResender_FanOutConfig_t;
+
+
+/**
+ * @brief RtpResender (fan-out destination) configuration parameters
+ */
+typedef struct ARSTREAM2_RtpResender_Config_t
+{
+    ARSTREAM2_RtpSender_Config_t senderConfig;      /**< Sender configuration (the packet and NALU FIFOs are provided by the fan-out) */
+    uint32_t maxNetworkLatencyUs;                   /**< Maximum network latency in microseconds (0 for no timeout) */
+
+} ARSTREAM2_RtpResender_Config_t;
+
+
+/**
+ * @brief RtpResender fan-out message slot
+ */
+typedef struct ARSTREAM2_RtpResender_Slot_s
+{
+    ARSTREAM2_RTP_Header_t header;
+    struct iovec iov[2];
+    unsigned int entryIndex;
+    int destination;
+
+} ARSTREAM2_RtpResender_Slot_t;
+
+
+/**
+ * @brief RtpResender context (a destination of a fan-out)
+ */
 typedef struct ARSTREAM2_RtpResender_s
 {
+    struct ARSTREAM2_RtpResender_FanOut_s *fanOut;
+    int index;
+
+    /* the sender handles RTCP and provides the destination address */
     ARSTREAM2_RtpSender_t *sender;
     ARSTREAM2_RTP_PacketFifoQueue_t packetFifoQueue;
     int streamSocketSendBufferSize;
     uint32_t maxNetworkLatencyUs;
 
+    /* per-destination header rewriting */
+    uint32_t ssrc;
+    uint16_t seqNumOffset;
+    const struct sockaddr *sendAddr;
+    socklen_t sendAddrLen;
+    int streamSocket;
+    int isMulticast;
+    int batchSocket;
+    struct sockaddr_storage localAddr;
+    socklen_t localAddrLen;
+
+    unsigned int dropCount;
+    unsigned int reportedDropCount;
+
     struct ARSTREAM2_RtpResender_s *prev;
     struct ARSTREAM2_RtpResender_s *next;
 
 } ARSTREAM2_RtpResender_t;
 
 
+/**
+ * @brief RtpResender fan-out context
+ *
+ * A fan-out relays the received packets to all its destinations from a
+ * dedicated thread. The receiving thread hands over references on the
+ * packet buffers through a lock-free ring; the ring entries are the only
+ * copy of the packets, each with a bitmap of the destinations it is still
+ * pending for. The packets for all the unicast destinations whose sockets
+ * share the same local address are sent with a single sendmmsg() batch,
+ * only the RTP header being rewritten per destination.
+ */
+typedef struct ARSTREAM2_RtpResender_FanOut_s
+{
+    /* packet ring (producer: receiver thread, consumer: fan-out thread) */
+    ARSTREAM2_RTP_PacketRing_t packetRing;
+
+    /* items-only FIFO for the destination senders and the buffer releases */
+    ARSTREAM2_RTP_PacketFifo_t packetFifo;
+
+    /* fan-out thread state, protected by the mutex */
+    ARSAL_Mutex_t mutex;
+    ARSTREAM2_RtpResender_t *resender;
+    ARSTREAM2_RtpResender_t *destination[ARSTREAM2_RTP_RESENDER_MAX_DESTINATIONS];
+    uint64_t activeMask;
+    uint64_t blockedMask;
+    uint64_t *pendingMask;
+    unsigned int maskedHead;
+    int batchSize;
+    struct mmsghdr *msgVec;
+    ARSTREAM2_RtpResender_Slot_t *slot;
+
+    /* fan-out thread */
+    ARSAL_Thread_t thread;
+    int threadShouldStop;
+    int threadEnded;
+    unsigned int selectGeneration;
+    ARSAL_Cond_t selectCond;
+    int signalPipe[2];
+    int wakeupPending;
+    unsigned int signaledHead;
+    unsigned int reportedDropCount;
+    ARSTREAM2_Clock_t clock;
+
+} ARSTREAM2_RtpResender_FanOut_t;
+
+
+/**
+ * @brief Create and start an RtpResender fan-out
+ *
+ * @param[in] config Pointer to a configuration structure
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_RtpResender_FanOut_t, or NULL if an error occured
+ */
+ARSTREAM2_RtpResender_FanOut_t* ARSTREAM2_RtpResender_FanOutNew(const ARSTREAM2_RtpResender_FanOutConfig_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Stop and delete an RtpResender fan-out and all its destinations
+ *
+ * The pending packets are released; the buffers go back to their owner FIFO.
+ *
+ * @param fanOut Pointer to an ARSTREAM2_RtpResender_FanOut_t* (will be set to NULL)
+ *
+ * @return ARSTREAM2_OK if no error occured
+ */
+eARSTREAM2_ERROR ARSTREAM2_RtpResender_FanOutDelete(ARSTREAM2_RtpResender_FanOut_t **fanOut);
+
+
+/**
+ * @brief Get the number of destinations of an RtpResender fan-out
+ *
+ * @param fanOut The fan-out instance
+ *
+ * @return The number of destinations, or -1 on error
+ */
+int ARSTREAM2_RtpResender_FanOutGetDestinationCount(ARSTREAM2_RtpResender_FanOut_t *fanOut);
+
+
+/**
+ * @brief Wake up the fan-out thread after packets have been pushed into its ring
+ *
+ * This function must be called from the producer thread; it never blocks.
+ *
+ * @param fanOut The fan-out instance
+ */
+void ARSTREAM2_RtpResender_FanOutSignal(ARSTREAM2_RtpResender_FanOut_t *fanOut);
+
+
+/**
+ * @brief Create an RtpResender, i.e. add a destination to a fan-out
+ *
+ * The destination receives the packets pushed into the fan-out ring after this call.
+ *
+ * @param[in] fanOut The fan-out instance
+ * @param[in] config Pointer to a configuration structure
+ * @param[out] error Optionnal pointer to an eARSTREAM2_ERROR to hold the error code
+ *
+ * @return A pointer to the new ARSTREAM2_RtpResender_t, or NULL if an error occured
+ */
+ARSTREAM2_RtpResender_t* ARSTREAM2_RtpResender_New(ARSTREAM2_RtpResender_FanOut_t *fanOut, const ARSTREAM2_RtpResender_Config_t *config, eARSTREAM2_ERROR *error);
+
+
+/**
+ * @brief Delete an RtpResender, i.e. remove a destination from its fan-out
+ *
+ * @param resender Pointer to an ARSTREAM2_RtpResender_t* (will be set to NULL)
+ *
+ * @return ARSTREAM2_OK if no error occured
+ */
+eARSTREAM2_ERROR ARSTREAM2_RtpResender_Delete(ARSTREAM2_RtpResender_t **resender);
+
+
 #endif /* _ARSTREAM2_RTP_RESENDER_H_ */
@@ -73,6 +73,12 @@
 #define ARSTREAM2_RTP_SENDER_DEFAULT_MIN_STREAM_SOCKET_SEND_BUFFER_SIZE (31250)
 
 
+/**
+ * Maximum number of senders sharing the transport of another sender
+ */
+#define ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS (8)
+
+
 /**
  * Sets *PTR to VAL if PTR is not null
  */
@@ -138,6 +144,11 @@ struct ARSTREAM2_RtpSender_t {
     int controlSocket;
     int packetsPending;
     int previouslySending;
+    ARSTREAM2_NetImpairment_t *impairment;
+    int impairmentPending;
+
+    /* Time source */
+    ARSTREAM2_Clock_t clock;
     uint32_t nextSrDelay;
 
     /* NALU and packet FIFO */
@@ -163,6 +174,13 @@ struct ARSTREAM2_RtpSender_t {
     unsigned int rtcpDropCount;
     unsigned int rtcpDropStatsTotalPackets;
     uint64_t rtcpDropLogStartTime;
+
+    /* Streams multiplexed by SSRC on the same socket pair */
+    struct ARSTREAM2_RtpSender_t *transport;
+    ARSAL_Mutex_t sharedStreamMutex;
+    struct ARSTREAM2_RtpSender_t *sharedStream[ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS];
+    int sharedStreamCount;
+    unsigned int sharedStreamNext;
 };
 
 
@@ -556,7 +574,7 @@ static void ARSTREAM2_RtpSender_UpdateMonitoring(uint64_t inputTimestamp, uint64
 ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_t *config, eARSTREAM2_ERROR *error)
 {
     ARSTREAM2_RtpSender_t *retSender = NULL;
-    int monitoringMutexWasInit = 0;
+    int monitoringMutexWasInit = 0, sharedStreamMutexWasInit = 0;
     eARSTREAM2_ERROR internalError = ARSTREAM2_OK;
 
     /* ARGS Check */
@@ -572,14 +590,20 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
         SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
         return retSender;
     }
-    if (((config->clientAddr == NULL) || (!strlen(config->clientAddr)))
+    if ((config->transport) && (config->transport->transport))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Config: the transport sender is itself using a shared transport");
+        SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
+        return retSender;
+    }
+    if ((!config->transport) && ((config->clientAddr == NULL) || (!strlen(config->clientAddr)))
             && (((config->mcastAddr == NULL) || (!strlen(config->mcastAddr))) || ((config->mcastIfaceAddr == NULL) || (!strlen(config->mcastIfaceAddr)))))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Config: no destination address provided");
         SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
         return retSender;
     }
-    if ((config->clientStreamPort <= 0) || (config->clientControlPort <= 0))
+    if ((!config->transport) && ((config->clientStreamPort <= 0) || (config->clientControlPort <= 0)))
     {
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Config: no client ports provided");
         SET_WITH_CHECK(error, ARSTREAM2_ERROR_BAD_PARAMETERS);
@@ -651,16 +675,18 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
         retSender->naluFifo = config->naluFifo;
         retSender->packetFifo = config->packetFifo;
         retSender->packetFifoQueue = config->packetFifoQueue;
-        retSender->msgVecCount = retSender->packetFifo->bufferPoolSize;
+        retSender->msgVecCount = (config->msgVecCount > 0) ? (unsigned int)config->msgVecCount : (unsigned int)retSender->packetFifo->bufferPoolSize;
         retSender->rtpSenderContext.maxPacketSize = config->maxPacketSize;
         retSender->rtpSenderContext.targetPacketSize = config->targetPacketSize;
         retSender->maxBitrate = config->maxBitrate;
         retSender->streamSocketSendBufferSize = config->streamSocketSendBufferSize;
         retSender->rtpSenderContext.useRtpHeaderExtensions = (config->useRtpHeaderExtensions > 0) ? 1 : 0;
-        retSender->rtpSenderContext.senderSsrc = ARSTREAM2_RTP_SENDER_SSRC;
+        retSender->transport = config->transport;
+        if (config->clock) retSender->clock = *config->clock;
+        retSender->rtpSenderContext.senderSsrc = (config->ssrc != 0) ? config->ssrc : ARSTREAM2_RTP_SENDER_SSRC;
         retSender->rtpSenderContext.rtpClockRate = 90000;
         retSender->rtpSenderContext.rtpTimestampOffset = 0;
-        retSender->rtcpSenderContext.senderSsrc = ARSTREAM2_RTP_SENDER_SSRC;
+        retSender->rtcpSenderContext.senderSsrc = retSender->rtpSenderContext.senderSsrc;
         retSender->rtcpSenderContext.sdesItemCount = 0;
         if ((retSender->canonicalName) && (strlen(retSender->canonicalName)))
         {
@@ -726,9 +752,21 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
             monitoringMutexWasInit = 1;
         }
     }
+    if (internalError == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(retSender->sharedStreamMutex));
+        if (mutexInitRet != 0)
+        {
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            sharedStreamMutexWasInit = 1;
+        }
+    }
 
     /* MsgVec array */
-    if (internalError == ARSTREAM2_OK)
+    if ((internalError == ARSTREAM2_OK) && (!retSender->transport))
     {
         if (retSender->msgVecCount > 0)
         {
@@ -751,7 +789,7 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
     }
 
     /* Stream socket setup */
-    if (internalError == ARSTREAM2_OK)
+    if ((internalError == ARSTREAM2_OK) && (!retSender->transport))
     {
         int socketRet = ARSTREAM2_RtpSender_StreamSocketSetup(retSender);
         if (socketRet != 0)
@@ -762,7 +800,7 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
     }
 
     /* Control socket setup */
-    if (internalError == ARSTREAM2_OK)
+    if ((internalError == ARSTREAM2_OK) && (!retSender->transport))
     {
         int socketRet = ARSTREAM2_RtpSender_ControlSocketSetup(retSender);
         if (socketRet != 0)
@@ -772,6 +810,16 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
         }
     }
 
+    /* Network impairment emulation */
+    if ((internalError == ARSTREAM2_OK) && (!retSender->transport) && (config->impairment))
+    {
+        retSender->impairment = ARSTREAM2_NetImpairment_New(config->impairment, &internalError);
+        if (internalError != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to create the impairment stage (%d)", internalError);
+        }
+    }
+
     /* RTCP message buffer */
     if (internalError == ARSTREAM2_OK)
     {
@@ -826,6 +874,39 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
         }
     }
 
+    /* Attach to the shared transport */
+    if ((internalError == ARSTREAM2_OK) && (retSender->transport))
+    {
+        ARSTREAM2_RtpSender_t *transport = retSender->transport;
+        int i;
+        ARSAL_Mutex_Lock(&(transport->sharedStreamMutex));
+        if (retSender->rtpSenderContext.senderSsrc == transport->rtpSenderContext.senderSsrc)
+        {
+            internalError = ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        for (i = 0; i < transport->sharedStreamCount; i++)
+        {
+            if (retSender->rtpSenderContext.senderSsrc == transport->sharedStream[i]->rtpSenderContext.senderSsrc)
+            {
+                internalError = ARSTREAM2_ERROR_BAD_PARAMETERS;
+            }
+        }
+        if (internalError != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "SSRC 0x%08X is already in use on the shared transport", retSender->rtpSenderContext.senderSsrc);
+        }
+        else if (transport->sharedStreamCount >= ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Too many streams on the shared transport (max %d)", ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS);
+            internalError = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            transport->sharedStream[transport->sharedStreamCount++] = retSender;
+        }
+        ARSAL_Mutex_Unlock(&(transport->sharedStreamMutex));
+    }
+
     if ((internalError != ARSTREAM2_OK) &&
         (retSender != NULL))
     {
@@ -840,7 +921,12 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
             while (((err = close(retSender->controlSocket)) == -1) && (errno == EINTR));
             retSender->controlSocket = -1;
         }
+        if (retSender->impairment)
+        {
+            ARSTREAM2_NetImpairment_Delete(&retSender->impairment);
+        }
         if (monitoringMutexWasInit == 1) ARSAL_Mutex_Destroy(&(retSender->monitoringMutex));
+        if (sharedStreamMutexWasInit == 1) ARSAL_Mutex_Destroy(&(retSender->sharedStreamMutex));
         free(retSender->msgVec);
         free(retSender->rtcpMsgBuffer);
         free(retSender->canonicalName);
@@ -867,10 +953,36 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_Delete(ARSTREAM2_RtpSender_t **sender)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_ERROR_BAD_PARAMETERS;
     if ((sender != NULL) &&
-        (*sender != NULL))
+        (*sender != NULL) &&
+        (ARSTREAM2_RtpSender_GetSharedStreamCount(*sender) > 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "The senders sharing the transport must be deleted first");
+        retVal = ARSTREAM2_ERROR_BUSY;
+    }
+    else if ((sender != NULL) &&
+             (*sender != NULL))
     {
         int err;
+        if ((*sender)->transport)
+        {
+            ARSTREAM2_RtpSender_t *transport = (*sender)->transport;
+            int i;
+            ARSAL_Mutex_Lock(&(transport->sharedStreamMutex));
+            for (i = 0; i < transport->sharedStreamCount; i++)
+            {
+                if (transport->sharedStream[i] == *sender)
+                {
+                    transport->sharedStream[i] = transport->sharedStream[--transport->sharedStreamCount];
+                    break;
+                }
+            }
+            ARSAL_Mutex_Unlock(&(transport->sharedStreamMutex));
+
+            /* no sender thread of its own: flush the queues now that the transport has released them */
+            ARSTREAM2_RtpSender_ProcessEnd(*sender, 0);
+        }
         ARSAL_Mutex_Destroy(&((*sender)->monitoringMutex));
+        ARSAL_Mutex_Destroy(&((*sender)->sharedStreamMutex));
         if ((*sender)->streamSocket != -1)
         {
             while (((err = close((*sender)->streamSocket)) == -1) && (errno == EINTR));
@@ -881,8 +993,13 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_Delete(ARSTREAM2_RtpSender_t **sender)
             while (((err = close((*sender)->controlSocket)) == -1) && (errno == EINTR));
             (*sender)->controlSocket = -1;
         }
+        if ((*sender)->impairment)
+        {
+            ARSTREAM2_NetImpairment_Delete(&(*sender)->impairment);
+        }
         free((*sender)->msgVec);
         free((*sender)->rtcpMsgBuffer);
+        free((*sender)->canonicalName);
         free((*sender)->friendlyName);
         free((*sender)->applicationName);
         free((*sender)->clientAddr);
@@ -901,10 +1018,26 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_Delete(ARSTREAM2_RtpSender_t **sender)
 }
 
 
+int ARSTREAM2_RtpSender_GetSharedStreamCount(ARSTREAM2_RtpSender_t *sender)
+{
+    int count;
+
+    if (sender == NULL)
+    {
+        return -1;
+    }
+
+    ARSAL_Mutex_Lock(&(sender->sharedStreamMutex));
+    count = sender->sharedStreamCount;
+    ARSAL_Mutex_Unlock(&(sender->sharedStreamMutex));
+
+    return count;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_FlushNaluQueue(ARSTREAM2_RtpSender_t *sender)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
-    struct timespec t1;
     uint64_t curTime;
 
     // Args check
@@ -915,8 +1048,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_FlushNaluQueue(ARSTREAM2_RtpSender_t *sende
 
     if (retVal == ARSTREAM2_OK)
     {
-        ARSAL_Time_GetTime(&t1);
-        curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+        curTime = ARSTREAM2_Clock_GetTime(&sender->clock);
 
         int ret = ARSTREAM2_RTPH264_Sender_FifoFlush(&sender->rtpSenderContext, sender->naluFifo, curTime);
         if (ret != 0)
@@ -929,6 +1061,47 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_FlushNaluQueue(ARSTREAM2_RtpSender_t *sende
 }
 
 
+eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetStreamParams(ARSTREAM2_RtpSender_t *sender, int *streamSocket, const struct sockaddr **sendAddr,
+                                                     socklen_t *sendAddrLen, uint32_t *ssrc, int *isMulticast)
+{
+    // Args check
+    if (sender == NULL)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (streamSocket) *streamSocket = sender->streamSocket;
+    if (sendAddr) *sendAddr = (const struct sockaddr*)&sender->streamSendSin;
+    if (sendAddrLen) *sendAddrLen = sizeof(sender->streamSendSin);
+    if (ssrc) *ssrc = sender->rtpSenderContext.senderSsrc;
+    if (isMulticast) *isMulticast = sender->isMulticast;
+
+    return ARSTREAM2_OK;
+}
+
+
+void ARSTREAM2_RtpSender_AddSentPackets(ARSTREAM2_RtpSender_t *sender, uint32_t packetCount, uint64_t byteCount)
+{
+    if (sender == NULL)
+    {
+        return;
+    }
+
+    sender->rtpSenderContext.packetCount += packetCount;
+    sender->rtpSenderContext.byteCount += byteCount;
+}
+
+
+/* Time left before the next RTCP sender report (the delay since the last one
+ * only depends on the clock, not on how often the thread loops) */
+static uint32_t ARSTREAM2_RtpSender_GetSrTimeout(ARSTREAM2_RtpSender_t *sender, uint64_t curTime)
+{
+    uint64_t srTime = sender->rtcpSenderContext.lastRtcpTimestamp + sender->nextSrDelay;
+
+    return (srTime > curTime) ? (uint32_t)(srTime - curTime) : 0;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetSelectParams(ARSTREAM2_RtpSender_t *sender, fd_set **readSet, fd_set **writeSet, fd_set **exceptSet, int *maxFd, uint32_t *nextTimeout)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
@@ -939,6 +1112,11 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetSelectParams(ARSTREAM2_RtpSender_t *send
     {
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
+    if (sender->transport)
+    {
+        /* Processed by the transport sender */
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
 
     _maxFd = -1;
     if (sender->streamSocket > _maxFd) _maxFd = sender->streamSocket;
@@ -950,7 +1128,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetSelectParams(ARSTREAM2_RtpSender_t *send
     }
     if (writeSet)
     {
-        if (sender->packetsPending)
+        if ((sender->packetsPending) || (sender->impairmentPending))
             FD_SET(sender->streamSocket, *writeSet);
     }
     if (exceptSet)
@@ -960,34 +1138,35 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetSelectParams(ARSTREAM2_RtpSender_t *send
     }
 
     if (maxFd) *maxFd = _maxFd;
-    if (nextTimeout) *nextTimeout = (sender->nextSrDelay < ARSTREAM2_RTP_SENDER_TIMEOUT_US) ? sender->nextSrDelay : ARSTREAM2_RTP_SENDER_TIMEOUT_US;
+    if (nextTimeout)
+    {
+        uint64_t curTime = ARSTREAM2_Clock_GetTime(&sender->clock);
+        uint32_t srTimeout = ARSTREAM2_RtpSender_GetSrTimeout(sender, curTime);
+        uint32_t _nextTimeout = (srTimeout < ARSTREAM2_RTP_SENDER_TIMEOUT_US) ? srTimeout : ARSTREAM2_RTP_SENDER_TIMEOUT_US;
+        int i;
+        ARSAL_Mutex_Lock(&(sender->sharedStreamMutex));
+        for (i = 0; i < sender->sharedStreamCount; i++)
+        {
+            srTimeout = ARSTREAM2_RtpSender_GetSrTimeout(sender->sharedStream[i], curTime);
+            if (srTimeout < _nextTimeout) _nextTimeout = srTimeout;
+        }
+        if ((sender->impairment) && (!sender->impairmentPending))
+        {
+            _nextTimeout = ARSTREAM2_NetImpairment_GetNextTimeout(sender->impairment, curTime, _nextTimeout);
+        }
+        ARSAL_Mutex_Unlock(&(sender->sharedStreamMutex));
+        *nextTimeout = _nextTimeout;
+    }
 
     return retVal;
 }
 
 
-eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtp(ARSTREAM2_RtpSender_t *sender, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet)
+static void ARSTREAM2_RtpSender_PrepareRtp(ARSTREAM2_RtpSender_t *sender, uint64_t curTime)
 {
-    eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
     unsigned int dropCount[ARSTREAM2_STREAM_SENDER_MAX_IMPORTANCE_LEVELS];
-    struct timespec t1;
-    uint64_t curTime;
     int ret;
 
-    // Args check
-    if (sender == NULL)
-    {
-        return ARSTREAM2_ERROR_BAD_PARAMETERS;
-    }
-
-    if ((exceptSet) && (FD_ISSET(sender->streamSocket, exceptSet)))
-    {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Exception on stream socket");
-    }
-
-    ARSAL_Time_GetTime(&t1);
-    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
-
     /* RTP packet FIFO cleanup (packets on timeout) */
     ret = ARSTREAM2_RTP_Sender_PacketFifoCleanFromTimeout(&sender->rtpSenderContext, sender->packetFifo, sender->packetFifoQueue,
                                                           curTime, dropCount, ARSTREAM2_STREAM_SENDER_MAX_IMPORTANCE_LEVELS);
@@ -1080,6 +1259,157 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtp(ARSTREAM2_RtpSender_t *sender, i
         }
     }
 #endif
+}
+
+
+/* Fill the msgVec from the packet queues of all the streams sharing the transport;
+ * each stream gets an equal share first, then the remaining entries are given in
+ * round-robin order; the packets of a stream are contiguous in the msgVec */
+static int ARSTREAM2_RtpSender_FillSharedMsgVec(ARSTREAM2_RtpSender_t *sender, ARSTREAM2_RtpSender_t **stream,
+                                                unsigned int *streamMsgCount, int *streamCount)
+{
+    unsigned int available[ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS + 1];
+    unsigned int share, count, total = 0;
+    int i, k, ret, _streamCount = sender->sharedStreamCount + 1;
+
+    for (i = 0; i < _streamCount; i++)
+    {
+        k = (int)((sender->sharedStreamNext + i) % _streamCount);
+        stream[i] = (k == 0) ? sender : sender->sharedStream[k - 1];
+        available[i] = stream[i]->packetFifoQueue->count;
+        streamMsgCount[i] = 0;
+    }
+    sender->sharedStreamNext = (sender->sharedStreamNext + 1) % _streamCount;
+
+    share = sender->msgVecCount / _streamCount;
+    if (share == 0) share = 1;
+    for (i = 0; (i < _streamCount) && (total < sender->msgVecCount); i++)
+    {
+        count = (available[i] < share) ? available[i] : share;
+        if (count > sender->msgVecCount - total) count = sender->msgVecCount - total;
+        streamMsgCount[i] = count;
+        total += count;
+    }
+    for (i = 0; (i < _streamCount) && (total < sender->msgVecCount); i++)
+    {
+        count = available[i] - streamMsgCount[i];
+        if (count > sender->msgVecCount - total) count = sender->msgVecCount - total;
+        streamMsgCount[i] += count;
+        total += count;
+    }
+
+    for (i = 0, total = 0; i < _streamCount; i++)
+    {
+        if (streamMsgCount[i] > 0)
+        {
+            ret = ARSTREAM2_RTP_Sender_PacketFifoFillMsgVec(stream[i]->packetFifoQueue, sender->msgVec + total, streamMsgCount[i],
+                                                            (void*)&sender->streamSendSin, sizeof(sender->streamSendSin));
+            if (ret < 0)
+            {
+                if (ret != -2)
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to fill msgVec (%d)", ret);
+                }
+                ret = 0;
+            }
+            streamMsgCount[i] = (unsigned int)ret;
+            total += streamMsgCount[i];
+        }
+    }
+
+    *streamCount = _streamCount;
+    return (total > 0) ? (int)total : -2;
+}
+
+
+/* Hand the packets over to the impairment stage instead of the socket; the
+ * packets are accepted even when the impairment stage drops them */
+static int ARSTREAM2_RtpSender_ImpairmentSubmit(ARSTREAM2_RtpSender_t *sender, int msgVecCount, uint64_t curTime)
+{
+    size_t size;
+    int i, ret;
+    unsigned int k;
+
+    for (i = 0; i < msgVecCount; i++)
+    {
+        for (k = 0, size = 0; k < sender->msgVec[i].msg_hdr.msg_iovlen; k++)
+        {
+            size += sender->msgVec[i].msg_hdr.msg_iov[k].iov_len;
+        }
+        ret = ARSTREAM2_NetImpairment_Submit(sender->impairment, sender->msgVec[i].msg_hdr.msg_iov,
+                                             (int)sender->msgVec[i].msg_hdr.msg_iovlen, size, curTime);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "ARSTREAM2_NetImpairment_Submit() failed (%d)", ret);
+        }
+        sender->msgVec[i].msg_len = (unsigned int)size;
+    }
+
+    return msgVecCount;
+}
+
+
+/* Send the packets released by the impairment stage */
+static void ARSTREAM2_RtpSender_ImpairmentFlush(ARSTREAM2_RtpSender_t *sender, uint64_t curTime)
+{
+    const uint8_t *data;
+    size_t size;
+    ssize_t ret;
+
+    sender->impairmentPending = 0;
+    while (ARSTREAM2_NetImpairment_Peek(sender->impairment, curTime, &data, &size) > 0)
+    {
+        while (((ret = sendto(sender->streamSocket, data, size, 0, (struct sockaddr*)&sender->streamSendSin, sizeof(sender->streamSendSin))) == -1) && (errno == EINTR));
+        if (ret < 0)
+        {
+            if (errno == EAGAIN)
+            {
+                /* wait for the socket to be writable */
+                sender->impairmentPending = 1;
+                break;
+            }
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Stream socket - sendto error (%d): %s", errno, strerror(errno));
+        }
+        ARSTREAM2_NetImpairment_Pop(sender->impairment);
+    }
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtp(ARSTREAM2_RtpSender_t *sender, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet)
+{
+    eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
+    ARSTREAM2_RtpSender_t *stream[ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS + 1];
+    unsigned int streamMsgCount[ARSTREAM2_RTP_SENDER_MAX_SHARED_STREAMS + 1];
+    int streamCount = 0;
+    uint64_t curTime;
+    int ret, i;
+
+    // Args check
+    if (sender == NULL)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (sender->transport)
+    {
+        /* Processed by the transport sender */
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    if ((exceptSet) && (FD_ISSET(sender->streamSocket, exceptSet)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Exception on stream socket");
+    }
+
+    curTime = ARSTREAM2_Clock_GetTime(&sender->clock);
+
+    ARSAL_Mutex_Lock(&(sender->sharedStreamMutex));
+
+    /* RTP packet FIFO cleanup and RTP packets creation */
+    ARSTREAM2_RtpSender_PrepareRtp(sender, curTime);
+    for (i = 0; i < sender->sharedStreamCount; i++)
+    {
+        ARSTREAM2_RtpSender_PrepareRtp(sender->sharedStream[i], curTime);
+    }
 
 #ifdef ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION
     uint32_t waitTime = ((uint64_t)rand() * (ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_WAIT_MAX - ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_WAIT_MIN) / RAND_MAX + ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_WAIT_MIN);
@@ -1089,31 +1419,31 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtp(ARSTREAM2_RtpSender_t *sender, i
     /* RTP packets sending */
     if ((!sender->packetsPending) || ((sender->packetsPending) && ((!writeSet) || ((selectRet >= 0) && (FD_ISSET(sender->streamSocket, writeSet))))))
     {
-        ret = ARSTREAM2_RTP_Sender_PacketFifoFillMsgVec(sender->packetFifoQueue, sender->msgVec, sender->msgVecCount, (void*)&sender->streamSendSin, sizeof(sender->streamSendSin));
-        if (ret < 0)
-        {
-            if (ret != -2)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to fill msgVec (%d)", ret);
-            }
-        }
-        else if (ret > 0)
+        ret = ARSTREAM2_RtpSender_FillSharedMsgVec(sender, stream, streamMsgCount, &streamCount);
+        if (ret > 0)
         {
             int msgVecCount = ret;
             int msgVecSentCount = 0;
+            int offset;
 
 #ifdef ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION
             msgVecCount = round((float)msgVecCount * ((float)rand() * (ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_MSG_MAX - ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_MSG_MIN) / RAND_MAX + ARSTREAM2_RTP_SENDER_RANDOM_CONGESTION_MSG_MIN));
 #endif
 
             sender->packetsPending = 1;
-            while (((ret = sendmmsg(sender->streamSocket, sender->msgVec, msgVecCount, 0)) == -1) && (errno == EINTR));
+            if (sender->impairment)
+            {
+                ret = ARSTREAM2_RtpSender_ImpairmentSubmit(sender, msgVecCount, curTime);
+            }
+            else
+            {
+                while (((ret = sendmmsg(sender->streamSocket, sender->msgVec, msgVecCount, 0)) == -1) && (errno == EINTR));
+            }
             if (ret < 0)
             {
                 if (errno == EAGAIN)
                 {
                     //ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_SENDER_TAG, "Stream socket buffer full (no packets dropped, will retry later) - sendmmsg error (%d): %s", errno, strerror(errno)); //TODO: debug
-                    int i;
                     for (i = 0, msgVecSentCount = 0; i < msgVecCount; i++)
                     {
                         if (sender->msgVec[i].msg_len > 0) msgVecSentCount++;
@@ -1139,106 +1469,89 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtp(ARSTREAM2_RtpSender_t *sender, i
                 //if (sender->packetsPending) ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_RTP_SENDER_TAG, "Sent %d packets out of %d", msgVecSentCount, msgVecCount); //TODO: debug
             }
 
-            ret = ARSTREAM2_RTP_Sender_PacketFifoCleanFromMsgVec(&sender->rtpSenderContext, sender->packetFifo,
-                                                                 sender->packetFifoQueue, sender->msgVec,
-                                                                 msgVecSentCount, curTime);
-            if (ret < 0)
+            /* sendmmsg() sends in order, so each stream gets the sent part of its msgVec slice */
+            for (i = 0, offset = 0; i < streamCount; offset += streamMsgCount[i], i++)
             {
-                if (ret != -2)
+                int sentCount = msgVecSentCount - offset;
+                if (sentCount > (int)streamMsgCount[i]) sentCount = (int)streamMsgCount[i];
+                if (sentCount <= 0)
                 {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to clean FIFO from msgVec (%d)", ret);
+                    continue;
+                }
+                ret = ARSTREAM2_RTP_Sender_PacketFifoCleanFromMsgVec(&stream[i]->rtpSenderContext, stream[i]->packetFifo,
+                                                                     stream[i]->packetFifoQueue, sender->msgVec + offset,
+                                                                     (unsigned int)sentCount, curTime);
+                if (ret < 0)
+                {
+                    if (ret != -2)
+                    {
+                        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to clean FIFO from msgVec (%d)", ret);
+                    }
                 }
             }
         }
     }
 
+    if (sender->impairment)
+    {
+        ARSTREAM2_RtpSender_ImpairmentFlush(sender, curTime);
+    }
+
+    ARSAL_Mutex_Unlock(&(sender->sharedStreamMutex));
+
     return retVal;
 }
 
 
-eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtcp(ARSTREAM2_RtpSender_t *sender, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet)
+static void ARSTREAM2_RtpSender_ProcessRtcpPacket(ARSTREAM2_RtpSender_t *sender, const uint8_t *buffer, unsigned int size, uint64_t curTime)
 {
-    eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
-    struct timespec t1;
-    uint64_t curTime;
+    int gotReceptionReport = 0;
+    int gotVideoStats = 0;
     int ret;
 
-    // Args check
-    if (sender == NULL)
+    ret = ARSTREAM2_RTCP_Sender_ProcessCompoundPacket(buffer, size,
+                                                      curTime, &sender->rtcpSenderContext,
+                                                      &gotReceptionReport, &gotVideoStats);
+    if ((ret != 0) && (size != 24)) /* workaround to avoid logging when it's an old clockSync packet with old FF or SC versions */
     {
-        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to process compound RTCP packet (%d)", ret);
     }
 
-    if ((exceptSet) && (FD_ISSET(sender->controlSocket, exceptSet)))
+    if ((gotVideoStats) && (sender->videoStatsCallback != NULL))
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Exception on control socket");
+        /* Call the receiver report callback function */
+        sender->videoStatsCallback(&sender->rtcpSenderContext.videoStatsCtx.videoStats, sender->videoStatsCallbackUserPtr);
     }
 
-    ARSAL_Time_GetTime(&t1);
-    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
-
-    /* RTCP receiver reports */
-    if ((!readSet) || ((selectRet >= 0) && (FD_ISSET(sender->controlSocket, readSet))))
+    if ((gotReceptionReport) && (sender->rtpStatsCallback != NULL))
     {
-        /* The control socket is ready for reading */
-        //TODO: recvmmsg?
-        ssize_t bytes;
-        while (((bytes = recv(sender->controlSocket, sender->rtcpMsgBuffer, sender->rtpSenderContext.maxPacketSize, 0)) == -1) && (errno == EINTR));
-        if ((bytes < 0) && (errno != EAGAIN))
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Control socket - read error (%d): %s", errno, strerror(errno));
-        }
-        while (bytes > 0)
-        {
-            int gotReceptionReport = 0;
-            int gotVideoStats = 0;
+        ARSTREAM2_RTP_RtpStats_t rtpStats;
 
-            ret = ARSTREAM2_RTCP_Sender_ProcessCompoundPacket(sender->rtcpMsgBuffer, (unsigned int)bytes,
-                                                              curTime, &sender->rtcpSenderContext,
-                                                              &gotReceptionReport, &gotVideoStats);
-            if ((ret != 0) && (bytes != 24)) /* workaround to avoid logging when it's an old clockSync packet with old FF or SC versions */
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Failed to process compound RTCP packet (%d)", ret);
-            }
+        memset(&rtpStats, 0, sizeof(ARSTREAM2_RTP_RtpStats_t));
+        rtpStats.timestamp = sender->rtcpSenderContext.lastRrReceptionTimestamp;
+        rtpStats.roundTripDelay = sender->rtcpSenderContext.roundTripDelay;
+        rtpStats.interarrivalJitter = sender->rtcpSenderContext.interarrivalJitter;
+        rtpStats.receiverLostCount = sender->rtcpSenderContext.receiverLostCount;
+        rtpStats.receiverFractionLost = sender->rtcpSenderContext.receiverFractionLost;
+        rtpStats.receiverExtHighestSeqNum = sender->rtcpSenderContext.receiverExtHighestSeqNum;
+        rtpStats.lastSenderReportInterval = sender->rtcpSenderContext.lastSrInterval;
+        rtpStats.senderReportIntervalPacketCount = sender->rtcpSenderContext.srIntervalPacketCount;
+        rtpStats.senderReportIntervalByteCount = sender->rtcpSenderContext.srIntervalByteCount;
+        rtpStats.senderPacketCount = sender->rtpSenderContext.packetCount;
+        rtpStats.senderByteCount = sender->rtpSenderContext.byteCount;
+        rtpStats.peerClockDelta = sender->rtcpSenderContext.clockDeltaCtx.clockDeltaAvg;
+        rtpStats.roundTripDelayFromClockDelta = (uint32_t)sender->rtcpSenderContext.clockDeltaCtx.rtDelay;
 
-            if ((gotVideoStats) && (sender->videoStatsCallback != NULL))
-            {
-                /* Call the receiver report callback function */
-                sender->videoStatsCallback(&sender->rtcpSenderContext.videoStatsCtx.videoStats, sender->videoStatsCallbackUserPtr);
-            }
+        /* Call the receiver report callback function */
+        sender->rtpStatsCallback(&rtpStats, sender->rtpStatsCallbackUserPtr);
+    }
+}
 
-            if ((gotReceptionReport) && (sender->rtpStatsCallback != NULL))
-            {
-                ARSTREAM2_RTP_RtpStats_t rtpStats;
-
-                memset(&rtpStats, 0, sizeof(ARSTREAM2_RTP_RtpStats_t));
-                rtpStats.timestamp = sender->rtcpSenderContext.lastRrReceptionTimestamp;
-                rtpStats.roundTripDelay = sender->rtcpSenderContext.roundTripDelay;
-                rtpStats.interarrivalJitter = sender->rtcpSenderContext.interarrivalJitter;
-                rtpStats.receiverLostCount = sender->rtcpSenderContext.receiverLostCount;
-                rtpStats.receiverFractionLost = sender->rtcpSenderContext.receiverFractionLost;
-                rtpStats.receiverExtHighestSeqNum = sender->rtcpSenderContext.receiverExtHighestSeqNum;
-                rtpStats.lastSenderReportInterval = sender->rtcpSenderContext.lastSrInterval;
-                rtpStats.senderReportIntervalPacketCount = sender->rtcpSenderContext.srIntervalPacketCount;
-                rtpStats.senderReportIntervalByteCount = sender->rtcpSenderContext.srIntervalByteCount;
-                rtpStats.senderPacketCount = sender->rtpSenderContext.packetCount;
-                rtpStats.senderByteCount = sender->rtpSenderContext.byteCount;
-                rtpStats.peerClockDelta = sender->rtcpSenderContext.clockDeltaCtx.clockDeltaAvg;
-                rtpStats.roundTripDelayFromClockDelta = (uint32_t)sender->rtcpSenderContext.clockDeltaCtx.rtDelay;
-
-                /* Call the receiver report callback function */
-                sender->rtpStatsCallback(&rtpStats, sender->rtpStatsCallbackUserPtr);
-            }
 
-            while (((bytes = recv(sender->controlSocket, sender->rtcpMsgBuffer, sender->rtpSenderContext.maxPacketSize, 0)) == -1) && (errno == EINTR));
-            if ((bytes < 0) && (errno != EAGAIN))
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Control socket - read error (%d): %s", errno, strerror(errno));
-            }
-        }
-    }
+static void ARSTREAM2_RtpSender_SendRtcp(ARSTREAM2_RtpSender_t *sender, ARSTREAM2_RtpSender_t *transport, uint64_t curTime)
+{
+    int ret;
 
-    /* RTCP sender reports */
     uint32_t srDelay = (uint32_t)(curTime - sender->rtcpSenderContext.lastRtcpTimestamp);
     if (srDelay >= sender->nextSrDelay)
     {
@@ -1252,7 +1565,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtcp(ARSTREAM2_RtpSender_t *sender,
         {
             sender->rtcpDropStatsTotalPackets++;
             ssize_t bytes;
-            while (((bytes = sendto(sender->controlSocket, sender->rtcpMsgBuffer, size, 0, (struct sockaddr*)&sender->controlSendSin, sizeof(sender->controlSendSin))) == -1) && (errno == EINTR));
+            while (((bytes = sendto(transport->controlSocket, sender->rtcpMsgBuffer, size, 0, (struct sockaddr*)&transport->controlSendSin, sizeof(transport->controlSendSin))) == -1) && (errno == EINTR));
             if (bytes < 0)
             {
                 if (errno == EAGAIN)
@@ -1284,12 +1597,85 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtcp(ARSTREAM2_RtpSender_t *sender,
         }
 
         sender->rtcpSenderContext.lastRtcpTimestamp = curTime;
-        srDelay = 0;
         sender->nextSrDelay = (size + ARSTREAM2_RTP_UDP_HEADER_SIZE + ARSTREAM2_RTP_IP_HEADER_SIZE) * 1000000 / sender->rtcpSenderContext.rtcpByteRate;
         if (sender->nextSrDelay < ARSTREAM2_RTCP_SENDER_MIN_PACKET_TIME_INTERVAL) sender->nextSrDelay = ARSTREAM2_RTCP_SENDER_MIN_PACKET_TIME_INTERVAL;
     }
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtcp(ARSTREAM2_RtpSender_t *sender, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet)
+{
+    eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
+    uint64_t curTime;
+    int i;
+
+    // Args check
+    if (sender == NULL)
+    {
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (sender->transport)
+    {
+        /* Processed by the transport sender */
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    if ((exceptSet) && (FD_ISSET(sender->controlSocket, exceptSet)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Exception on control socket");
+    }
+
+    curTime = ARSTREAM2_Clock_GetTime(&sender->clock);
+
+    ARSAL_Mutex_Lock(&(sender->sharedStreamMutex));
 
-    sender->nextSrDelay = sender->nextSrDelay - srDelay;
+    /* RTCP receiver reports */
+    if ((!readSet) || ((selectRet >= 0) && (FD_ISSET(sender->controlSocket, readSet))))
+    {
+        /* The control socket is ready for reading */
+        //TODO: recvmmsg?
+        ssize_t bytes;
+        while (((bytes = recv(sender->controlSocket, sender->rtcpMsgBuffer, sender->rtpSenderContext.maxPacketSize, 0)) == -1) && (errno == EINTR));
+        if ((bytes < 0) && (errno != EAGAIN))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Control socket - read error (%d): %s", errno, strerror(errno));
+        }
+        while (bytes > 0)
+        {
+            ARSTREAM2_RtpSender_t *stream = sender;
+            uint32_t ssrc;
+
+            /* Route the reports to the stream sharing the transport they relate to */
+            if ((sender->sharedStreamCount > 0) && (ARSTREAM2_RTCP_GetMediaSourceSsrc(sender->rtcpMsgBuffer, (unsigned int)bytes, &ssrc) == 0))
+            {
+                for (i = 0; i < sender->sharedStreamCount; i++)
+                {
+                    if (sender->sharedStream[i]->rtpSenderContext.senderSsrc == ssrc)
+                    {
+                        stream = sender->sharedStream[i];
+                        break;
+                    }
+                }
+            }
+
+            ARSTREAM2_RtpSender_ProcessRtcpPacket(stream, sender->rtcpMsgBuffer, (unsigned int)bytes, curTime);
+
+            while (((bytes = recv(sender->controlSocket, sender->rtcpMsgBuffer, sender->rtpSenderContext.maxPacketSize, 0)) == -1) && (errno == EINTR));
+            if ((bytes < 0) && (errno != EAGAIN))
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_RTP_SENDER_TAG, "Control socket - read error (%d): %s", errno, strerror(errno));
+            }
+        }
+    }
+
+    /* RTCP sender reports */
+    ARSTREAM2_RtpSender_SendRtcp(sender, sender, curTime);
+    for (i = 0; i < sender->sharedStreamCount; i++)
+    {
+        ARSTREAM2_RtpSender_SendRtcp(sender->sharedStream[i], sender, curTime);
+    }
+
+    ARSAL_Mutex_Unlock(&(sender->sharedStreamMutex));
 
     return retVal;
 }
@@ -1298,7 +1684,6 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessRtcp(ARSTREAM2_RtpSender_t *sender,
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessEnd(ARSTREAM2_RtpSender_t *sender, int queueOnly)
 {
     eARSTREAM2_ERROR retVal = ARSTREAM2_OK;
-    struct timespec t1;
     uint64_t curTime;
 
     // Args check
@@ -1308,8 +1693,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_ProcessEnd(ARSTREAM2_RtpSender_t *sender, i
     }
 
     /* flush the NALU FIFO and packet FIFO */
-    ARSAL_Time_GetTime(&t1);
-    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+    curTime = ARSTREAM2_Clock_GetTime(&sender->clock);
     if (sender->naluFifo != NULL) ARSTREAM2_RTPH264_Sender_FifoFlush(&sender->rtpSenderContext, sender->naluFifo, curTime);
     if (queueOnly)
         ARSTREAM2_RTP_Sender_PacketFifoFlushQueue(&sender->rtpSenderContext, sender->packetFifo, sender->packetFifoQueue, curTime);
@@ -1526,9 +1910,7 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetMonitoring(ARSTREAM2_RtpSender_t *sender
 
     if (startTime == 0)
     {
-        struct timespec t1;
-        ARSAL_Time_GetTime(&t1);
-        startTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+        startTime = ARSTREAM2_Clock_GetTime(&sender->clock);
     }
     endTime = startTime;
 
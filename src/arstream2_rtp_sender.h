@@ -18,6 +18,8 @@ extern "C" {
 #include "arstream2_rtp.h"
 #include "arstream2_rtcp.h"
 #include "arstream2_h264.h"
+#include "arstream2_net_impairment_internal.h"
+#include "arstream2_clock_internal.h"
 
 
 /**
@@ -82,10 +84,15 @@ typedef struct ARSTREAM2_RtpSender_Config_t
     ARSTREAM2_H264_NaluFifo_t *naluFifo;            /**< Optional user-provided NALU FIFO */
     ARSTREAM2_RTP_PacketFifo_t *packetFifo;         /**< User-provided packet FIFO */
     ARSTREAM2_RTP_PacketFifoQueue_t *packetFifoQueue;  /**< User-provided packet FIFO queue */
+    int msgVecCount;                                /**< Maximum number of packets per sendmmsg() call (optional, 0 for the packet FIFO buffer count) */
     int maxPacketSize;                              /**< Maximum network packet size in bytes (example: the interface MTU) */
     int targetPacketSize;                           /**< Target network packet size in bytes */
     int maxBitrate;                                 /**< Maximum streaming bitrate in bit/s (optional, can be 0) */
     int useRtpHeaderExtensions;                     /**< Boolean-like (0-1) flag: if active insert access unit metadata as RTP header extensions */
+    uint32_t ssrc;                                  /**< RTP synchronization source identifier (optional, 0 for default) */
+    struct ARSTREAM2_RtpSender_t *transport;        /**< Sender whose socket pair is shared, the streams being multiplexed by SSRC (optional, can be NULL) */
+    const ARSTREAM2_NetImpairment_Config_t *impairment;  /**< Network impairment emulation on the sent RTP packets (optional, can be NULL; ignored with a transport sender) */
+    const ARSTREAM2_Clock_t *clock;                 /**< Time source (optional, NULL for the monotonic clock) */
     const char *dateAndTime;
     const char *debugPath;
 
@@ -138,6 +145,16 @@ ARSTREAM2_RtpSender_t* ARSTREAM2_RtpSender_New(const ARSTREAM2_RtpSender_Config_
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_Delete(ARSTREAM2_RtpSender_t **sender);
 
 
+/**
+ * @brief Get the number of senders sharing the sender transport
+ *
+ * @param[in] sender The sender instance
+ *
+ * @return The number of senders that were created with this sender as transport, or -1 on error
+ */
+int ARSTREAM2_RtpSender_GetSharedStreamCount(ARSTREAM2_RtpSender_t *sender);
+
+
 /**
  * @brief Flush all currently queued NAL units
  *
@@ -149,6 +166,33 @@ eARSTREAM2_ERROR ARSTREAM2_RtpSender_Delete(ARSTREAM2_RtpSender_t **sender);
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_FlushNaluQueue(ARSTREAM2_RtpSender_t *sender);
 
 
+/**
+ * @brief Get the stream socket parameters for sending RTP packets on behalf of the sender
+ *
+ * @param[in] sender The sender instance
+ * @param[out] streamSocket Optional pointer to the stream socket
+ * @param[out] sendAddr Optional pointer to the stream destination address
+ * @param[out] sendAddrLen Optional pointer to the stream destination address length
+ * @param[out] ssrc Optional pointer to the RTP synchronization source identifier
+ * @param[out] isMulticast Optional pointer to the multicast flag
+ *
+ * @return ARSTREAM2_OK if no error happened
+ * @return ARSTREAM2_ERROR_BAD_PARAMETERS if the sender is invalid
+ */
+eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetStreamParams(ARSTREAM2_RtpSender_t *sender, int *streamSocket, const struct sockaddr **sendAddr,
+                                                     socklen_t *sendAddrLen, uint32_t *ssrc, int *isMulticast);
+
+
+/**
+ * @brief Account for RTP packets sent on behalf of the sender (reported in the RTCP sender reports)
+ *
+ * @param[in] sender The sender instance
+ * @param[in] packetCount Number of packets sent
+ * @param[in] byteCount Number of payload bytes sent
+ */
+void ARSTREAM2_RtpSender_AddSentPackets(ARSTREAM2_RtpSender_t *sender, uint32_t packetCount, uint64_t byteCount);
+
+
 eARSTREAM2_ERROR ARSTREAM2_RtpSender_GetSelectParams(ARSTREAM2_RtpSender_t *sender, fd_set **readSet, fd_set **writeSet, fd_set **exceptSet, int *maxFd, uint32_t *nextTimeout);
 
 
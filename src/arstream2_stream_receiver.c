@@ -19,6 +19,7 @@
 #include "arstream2_h264_filter.h"
 #include "arstream2_h264.h"
 #include "arstream2_stream_stats_internal.h"
+#include "arstream2_stream_receiver_internal.h"
 
 
 #define ARSTREAM2_STREAM_RECEIVER_TAG "ARSTREAM2_StreamReceiver"
@@ -26,11 +27,16 @@
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_MIN_PACKET_FIFO_BUFFER_COUNT (500)
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_PACKET_FIFO_BUFFER_TO_ITEM_FACTOR (4)
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_MIN_PACKET_FIFO_ITEM_COUNT (ARSTREAM2_STREAM_RECEIVER_DEFAULT_MIN_PACKET_FIFO_BUFFER_COUNT * ARSTREAM2_STREAM_RECEIVER_DEFAULT_PACKET_FIFO_BUFFER_TO_ITEM_FACTOR)
+#define ARSTREAM2_STREAM_RECEIVER_DEFAULT_PACKET_FIFO_JUMBO_BUFFER_COUNT (16)
 
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_ITEM_COUNT (200)
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_ITEM_NALU_COUNT (128)
 #define ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_BUFFER_COUNT (60)
 
+#define ARSTREAM2_STREAM_RECEIVER_DEFAULT_FILTER_QUEUE_MAX_SIZE (20)
+
+#define ARSTREAM2_STREAM_RECEIVER_DEFAULT_RECORDER_PRE_EVENT_BYTE_BUDGET (32 * 1024 * 1024)
+
 #define ARSTREAM2_STREAM_RECEIVER_AU_BUFFER_SIZE (128 * 1024)
 #define ARSTREAM2_STREAM_RECEIVER_AU_METADATA_BUFFER_SIZE (1024)
 #define ARSTREAM2_STREAM_RECEIVER_AU_USER_DATA_BUFFER_SIZE (1024)
@@ -50,10 +56,7 @@ typedef struct ARSTREAM2_StreamReceiver_s
     ARSTREAM2_H264_AuFifo_t auFifo;
     ARSTREAM2_H264Filter_Handle filter;
     ARSTREAM2_RtpReceiver_t *receiver;
-    ARSTREAM2_RtpResender_t *resender;
-    ARSTREAM2_RTP_PacketFifoQueue_t **resendQueue;
-    uint32_t *resendTimeout;
-    unsigned int resendCount;
+    ARSTREAM2_RtpResender_FanOut_t *resendFanOut;
     ARSAL_Mutex_t resendMutex;
 
     int maxPacketSize;
@@ -65,6 +68,7 @@ typedef struct ARSTREAM2_StreamReceiver_s
     uint64_t lastAuNtpTimestamp;
     uint64_t lastAuNtpTimestampRaw;
     uint64_t lastAuOutputTimestamp;
+    ARSTREAM2_Clock_t clock;
     uint64_t timestampDeltaIntegral;
     uint64_t timestampDeltaIntegralSq;
     uint64_t timingErrorIntegral;
@@ -72,12 +76,42 @@ typedef struct ARSTREAM2_StreamReceiver_s
     uint64_t estimatedLatencyIntegral;
     uint64_t estimatedLatencyIntegralSq;
 
+    /* Engine running the instance (NULL if the application runs the threads) */
+    ARSTREAM2_StreamReceiverEngine_Handle engine;
+
+    /* Instance whose sockets are shared (NULL if the instance owns its sockets) */
+    struct ARSTREAM2_StreamReceiver_s *transport;
+
+    /* Instances sharing the sockets, run from the network thread */
+    ARSAL_Mutex_t sharedStreamMutex;
+    struct ARSTREAM2_StreamReceiver_s *sharedStream[ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS];
+    int sharedStreamCount;
+
     /* Network thread status */
     ARSAL_Mutex_t threadMutex;
     int threadStarted;
     int threadShouldStop;
     int signalPipe[2];
 
+    struct
+    {
+        int threadEnabled;
+        int queueMaxSize;
+        ARSTREAM2_H264_AuFifoQueue_t auFifoQueue;
+        ARSAL_Thread_t thread;
+        ARSAL_Mutex_t threadMutex;
+        ARSAL_Cond_t threadCond;
+        int threadShouldStop;
+
+        /* Queue depth monitoring */
+        ARSAL_Mutex_t statsMutex;
+        int filterQueuePeakDepth;
+        uint32_t filterQueueDropCount;
+        int appOutputQueuePeakDepth;
+        int recorderQueuePeakDepth;
+
+    } pipeline;
+
     struct
     {
         ARSTREAM2_H264_AuFifoQueue_t auFifoQueue;
@@ -109,6 +143,13 @@ typedef struct ARSTREAM2_StreamReceiver_s
     {
         ARSTREAM2_H264_AuFifoQueue_t auFifoQueue;
         char *fileName;
+        int directIo;
+        int writeBatchSize;
+        int syncIntervalMs;
+        int syncByteBudget;
+        int segmentDurationMs;
+        int segmentMaxSize;
+        uint64_t diskQuota;
         time_t startTime;
         int startPending;
         int running;
@@ -118,6 +159,14 @@ typedef struct ARSTREAM2_StreamReceiver_s
         ARSAL_Cond_t threadCond;
         ARSTREAM2_StreamRecorder_Handle recorder;
 
+        /* pre-event buffer (protected by threadMutex) */
+        int preEventEnabled;
+        uint64_t preEventDuration;
+        int preEventMaxAuCount;
+        ARSTREAM2_H264_AuFifoQueue_t preEventQueue;
+        int preEventSyncCount;
+        uint64_t preEventByteCount;
+
     } recorder;
 
     /* Debug files */
@@ -130,7 +179,9 @@ typedef struct ARSTREAM2_StreamReceiver_s
 
 
 static int ARSTREAM2_StreamReceiver_GenerateGrayIdrFrame(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AccessUnit_t *nextAu);
+static int ARSTREAM2_StreamReceiver_FilterAu(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem);
 static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoItem_t *auItem, void *userPtr);
+static void* ARSTREAM2_StreamReceiver_RunFilterThread(void *streamReceiverHandle);
 static int ARSTREAM2_StreamReceiver_H264FilterSpsPpsCallback(uint8_t *spsBuffer, int spsSize, uint8_t *ppsBuffer, int ppsSize, void *userPtr);
 static int ARSTREAM2_StreamReceiver_StreamRecorderInit(ARSTREAM2_StreamReceiver_t *streamReceiver);
 static int ARSTREAM2_StreamReceiver_StreamRecorderStop(ARSTREAM2_StreamReceiver_t *streamReceiver);
@@ -149,7 +200,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
     int appOutputThreadMutexInit = 0, appOutputThreadCondInit = 0;
     int appOutputCallbackMutexInit = 0, appOutputCallbackCondInit = 0;
     int recorderThreadMutexInit = 0, recorderThreadCondInit = 0;
-    int threadMutexInit = 0, resendMutexInit = 0;
+    int threadMutexInit = 0, resendMutexInit = 0, sharedStreamMutexInit = 0;
+    int pipelineStatsMutexInit = 0, pipelineThreadMutexInit = 0, pipelineThreadCondInit = 0, pipelineQueueCreated = 0;
+    int preEventQueueCreated = 0;
 
     if (!streamReceiverHandle)
     {
@@ -174,6 +227,53 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
 
     int usemux = mux_config != NULL;
 
+    if ((config->engine) && (usemux))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "An engine cannot run a mux receiver");
+        return ARSTREAM2_ERROR_UNSUPPORTED;
+    }
+
+    if (config->transport)
+    {
+        if ((config->engine) || (usemux))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "A shared transport cannot be used with an engine or a mux receiver");
+            return ARSTREAM2_ERROR_UNSUPPORTED;
+        }
+        if (config->transport->transport)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "The transport instance is already sharing another instance transport");
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        if (net_config->serverSsrc == 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "A server SSRC is required with a shared transport");
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+    }
+
+    /* with sharded ingest the RTP packets are received by the engine and identified by their source or SSRC */
+    int useIngest = ARSTREAM2_StreamReceiverEngine_IsIngestEnabled(config->engine);
+    ARSTREAM2_StreamReceiverEngine_IngestKey_t ingestKey;
+    memset(&ingestKey, 0, sizeof(ingestKey));
+    if (useIngest)
+    {
+        struct in_addr serverAddr;
+        if (net_config->mcastAddr)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Multicast is not supported with sharded ingest");
+            return ARSTREAM2_ERROR_UNSUPPORTED;
+        }
+        if ((!net_config->serverAddr) || (inet_pton(AF_INET, net_config->serverAddr, &serverAddr) <= 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Sharded ingest requires a numeric server address");
+            return ARSTREAM2_ERROR_BAD_PARAMETERS;
+        }
+        ingestKey.sourceAddr = ntohl(serverAddr.s_addr);
+        ingestKey.sourcePort = (uint16_t)net_config->serverStreamPort;
+        ingestKey.ssrc = net_config->serverSsrc;
+    }
+
     streamReceiver = (ARSTREAM2_StreamReceiver_t*)malloc(sizeof(*streamReceiver));
     if (!streamReceiver)
     {
@@ -190,6 +290,35 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         streamReceiver->appOutput.filterOutSpsPps = (config->filterOutSpsPps > 0) ? 1 : 0;
         streamReceiver->appOutput.filterOutSei = (config->filterOutSei > 0) ? 1 : 0;
         streamReceiver->appOutput.replaceStartCodesWithNaluSize = (config->replaceStartCodesWithNaluSize > 0) ? 1 : 0;
+        streamReceiver->engine = config->engine;
+        streamReceiver->pipeline.threadEnabled = ((config->filterThread > 0) && (!config->engine) && (!config->transport)) ? 1 : 0;
+        if ((config->filterThread > 0) && ((config->engine) || (config->transport)))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_TAG, "The filter thread is not supported with an engine or a shared transport, the filter runs in the network thread");
+        }
+        streamReceiver->pipeline.queueMaxSize = (config->filterQueueMaxSize > 0) ? config->filterQueueMaxSize : ARSTREAM2_STREAM_RECEIVER_DEFAULT_FILTER_QUEUE_MAX_SIZE;
+        streamReceiver->recorder.directIo = (config->recorderDirectIo > 0) ? 1 : 0;
+        streamReceiver->recorder.writeBatchSize = config->recorderWriteBatchSize;
+        streamReceiver->recorder.syncIntervalMs = config->recorderSyncIntervalMs;
+        streamReceiver->recorder.syncByteBudget = config->recorderSyncByteBudget;
+        streamReceiver->recorder.segmentDurationMs = config->recorderSegmentDurationMs;
+        streamReceiver->recorder.segmentMaxSize = config->recorderSegmentMaxSize;
+        streamReceiver->recorder.diskQuota = config->recorderDiskQuota;
+        if (config->recorderPreEventDurationMs > 0)
+        {
+            /* the pre-event access units hold AU FIFO buffers which are
+             * allocated on top of the buffers used by the live pipeline */
+            int byteBudget = (config->recorderPreEventByteBudget > 0) ? config->recorderPreEventByteBudget : ARSTREAM2_STREAM_RECEIVER_DEFAULT_RECORDER_PRE_EVENT_BYTE_BUDGET;
+            streamReceiver->recorder.preEventEnabled = 1;
+            streamReceiver->recorder.preEventDuration = (uint64_t)config->recorderPreEventDurationMs * 90;
+            streamReceiver->recorder.preEventMaxAuCount = byteBudget / ARSTREAM2_STREAM_RECEIVER_AU_BUFFER_SIZE;
+            if (streamReceiver->recorder.preEventMaxAuCount < 1)
+            {
+                streamReceiver->recorder.preEventMaxAuCount = 1;
+            }
+        }
+        streamReceiver->clock.getTime = config->clockCallback;
+        streamReceiver->clock.userPtr = config->clockCallbackUserPtr;
         if ((config->debugPath) && (strlen(config->debugPath)))
         {
             streamReceiver->debugPath = strdup(config->debugPath);
@@ -251,6 +380,20 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         }
     }
 
+    if (ret == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(streamReceiver->sharedStreamMutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            sharedStreamMutexInit = 1;
+        }
+    }
+
     if (ret == ARSTREAM2_OK)
     {
         int mutexInitRet = ARSAL_Mutex_Init(&(streamReceiver->resendMutex));
@@ -349,12 +492,29 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         }
     }
 
+    if (ret == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(streamReceiver->pipeline.statsMutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            pipelineStatsMutexInit = 1;
+        }
+    }
+
     /* Setup the packet FIFO */
     if (ret == ARSTREAM2_OK)
     {
+        /* MTU-sized packet buffers, larger datagrams spill into the jumbo buffers */
+        int packetBufferSize = (streamReceiver->maxPacketSize > (int)ARSTREAM2_RTP_MTU_PAYLOAD_SIZE) ? (int)ARSTREAM2_RTP_MTU_PAYLOAD_SIZE : streamReceiver->maxPacketSize;
+        int jumboBufferCount = (streamReceiver->maxPacketSize > packetBufferSize) ? ARSTREAM2_STREAM_RECEIVER_DEFAULT_PACKET_FIFO_JUMBO_BUFFER_COUNT : 0;
         int packetFifoRet = ARSTREAM2_RTP_PacketFifoInit(&streamReceiver->packetFifo, ARSTREAM2_STREAM_RECEIVER_DEFAULT_MIN_PACKET_FIFO_ITEM_COUNT,
                                                          ARSTREAM2_STREAM_RECEIVER_DEFAULT_MIN_PACKET_FIFO_BUFFER_COUNT,
-                                                         streamReceiver->maxPacketSize);
+                                                         packetBufferSize, jumboBufferCount, streamReceiver->maxPacketSize);
         if (packetFifoRet != 0)
         {
             ret = ARSTREAM2_ERROR_ALLOC;
@@ -375,9 +535,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
     if (ret == ARSTREAM2_OK)
     {
         int auFifoRet = ARSTREAM2_H264_AuFifoInit(&streamReceiver->auFifo,
-                                                  ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_ITEM_COUNT,
+                                                  ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_ITEM_COUNT + streamReceiver->recorder.preEventMaxAuCount,
                                                   ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_ITEM_NALU_COUNT,
-                                                  ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_BUFFER_COUNT,
+                                                  ARSTREAM2_STREAM_RECEIVER_DEFAULT_AU_FIFO_BUFFER_COUNT + streamReceiver->recorder.preEventMaxAuCount,
                                                   ARSTREAM2_STREAM_RECEIVER_AU_BUFFER_SIZE,
                                                   ARSTREAM2_STREAM_RECEIVER_AU_METADATA_BUFFER_SIZE,
                                                   ARSTREAM2_STREAM_RECEIVER_AU_USER_DATA_BUFFER_SIZE,
@@ -415,6 +575,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         receiverConfig.insertStartCodes = 1;
         receiverConfig.generateReceiverReports = config->generateReceiverReports;
         receiverConfig.videoStatsSendTimeInterval = ARSTREAM2_STREAM_RECEIVER_VIDEO_STATS_RTCP_SEND_INTERVAL;
+        receiverConfig.captureFileName = config->rtpCaptureFileName;
+        receiverConfig.impairment = config->impairment;
+        receiverConfig.clock = &streamReceiver->clock;
 
         if (usemux) {
             receiver_mux_config.mux = mux_config->mux;
@@ -428,6 +591,12 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
             receiver_net_config.clientStreamPort = net_config->clientStreamPort;
             receiver_net_config.clientControlPort = net_config->clientControlPort;
             receiver_net_config.classSelector = net_config->classSelector;
+            receiver_net_config.streamIngest = useIngest;
+            if (config->transport)
+            {
+                receiver_net_config.transport = config->transport->receiver;
+                receiver_net_config.ssrc = net_config->serverSsrc;
+            }
             streamReceiver->receiver = ARSTREAM2_RtpReceiver_New(&receiverConfig, &receiver_net_config, NULL, &ret);
         }
 
@@ -445,6 +614,8 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         filterConfig.spsPpsCallbackUserPtr = streamReceiver;
         filterConfig.outputIncompleteAu = config->outputIncompleteAu;
         filterConfig.generateSkippedPSlices = config->generateSkippedPSlices;
+        filterConfig.grayIdrCachePath = config->grayIFrameCachePath;
+        filterConfig.clock = &streamReceiver->clock;
 
         ret = ARSTREAM2_H264Filter_Init(&streamReceiver->filter, &filterConfig);
         if (ret != 0)
@@ -453,6 +624,104 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         }
     }
 
+    /* Setup the filter thread */
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->pipeline.threadEnabled))
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(streamReceiver->pipeline.threadMutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            pipelineThreadMutexInit = 1;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->pipeline.threadEnabled))
+    {
+        int condInitRet = ARSAL_Cond_Init(&(streamReceiver->pipeline.threadCond));
+        if (condInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Cond creation failed (%d)", condInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            pipelineThreadCondInit = 1;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->pipeline.threadEnabled))
+    {
+        int auFifoRet = ARSTREAM2_H264_AuFifoAddQueue(&streamReceiver->auFifo, &streamReceiver->pipeline.auFifoQueue);
+        if (auFifoRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoAddQueue() failed (%d)", auFifoRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            pipelineQueueCreated = 1;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->recorder.preEventEnabled))
+    {
+        int auFifoRet = ARSTREAM2_H264_AuFifoAddQueue(&streamReceiver->auFifo, &streamReceiver->recorder.preEventQueue);
+        if (auFifoRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoAddQueue() failed (%d)", auFifoRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            preEventQueueCreated = 1;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->pipeline.threadEnabled))
+    {
+        int thErr = ARSAL_Thread_Create(&streamReceiver->pipeline.thread, ARSTREAM2_StreamReceiver_RunFilterThread, (void*)streamReceiver);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Filter thread creation failed (%d)", thErr);
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamReceiver->engine))
+    {
+        /* the engine workers play the role of the network thread from now on */
+        streamReceiver->threadStarted = 1;
+        int engineRet = ARSTREAM2_StreamReceiverEngine_AddReceiver(streamReceiver->engine, streamReceiver, (useIngest) ? &ingestKey : NULL);
+        if (engineRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiverEngine_AddReceiver() failed (%d)", engineRet);
+            ret = (engineRet == -2) ? ARSTREAM2_ERROR_BAD_PARAMETERS : ARSTREAM2_ERROR_ALLOC;
+        }
+    }
+
+    if ((ret == ARSTREAM2_OK) && (config->transport))
+    {
+        /* the transport instance network thread plays the role of the network thread from now on */
+        ARSTREAM2_StreamReceiver_t *transport = config->transport;
+        ARSAL_Mutex_Lock(&(transport->sharedStreamMutex));
+        if (transport->sharedStreamCount < ARSTREAM2_RTP_RECEIVER_MAX_SHARED_STREAMS)
+        {
+            streamReceiver->transport = transport;
+            streamReceiver->threadStarted = 1;
+            transport->sharedStream[transport->sharedStreamCount++] = streamReceiver;
+        }
+        else
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Too many instances sharing the transport");
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        ARSAL_Mutex_Unlock(&(transport->sharedStreamMutex));
+    }
+
     if (ret == ARSTREAM2_OK)
     {
         *streamReceiverHandle = streamReceiver;
@@ -462,8 +731,19 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
         if (streamReceiver)
         {
             int err;
+            if (streamReceiver->pipeline.thread)
+            {
+                ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+                streamReceiver->pipeline.threadShouldStop = 1;
+                ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+                ARSAL_Cond_Signal(&(streamReceiver->pipeline.threadCond));
+                ARSAL_Thread_Join(streamReceiver->pipeline.thread, NULL);
+                ARSAL_Thread_Destroy(&(streamReceiver->pipeline.thread));
+            }
             if (streamReceiver->receiver) ARSTREAM2_RtpReceiver_Delete(&(streamReceiver->receiver));
             if (streamReceiver->filter) ARSTREAM2_H264Filter_Free(&(streamReceiver->filter));
+            if (pipelineQueueCreated) ARSTREAM2_H264_AuFifoRemoveQueue(&(streamReceiver->auFifo), &(streamReceiver->pipeline.auFifoQueue));
+            if (preEventQueueCreated) ARSTREAM2_H264_AuFifoRemoveQueue(&(streamReceiver->auFifo), &(streamReceiver->recorder.preEventQueue));
             if (packetFifoWasCreated) ARSTREAM2_RTP_PacketFifoFree(&(streamReceiver->packetFifo));
             if (auFifoCreated) ARSTREAM2_H264_AuFifoFree(&(streamReceiver->auFifo));
             if (streamReceiver->signalPipe[0] != -1)
@@ -478,12 +758,16 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Init(ARSTREAM2_StreamReceiver_Handle *
             }
             if (threadMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->threadMutex));
             if (resendMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->resendMutex));
+            if (sharedStreamMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->sharedStreamMutex));
             if (appOutputThreadMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->appOutput.threadMutex));
             if (appOutputThreadCondInit) ARSAL_Cond_Destroy(&(streamReceiver->appOutput.threadCond));
             if (appOutputCallbackMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->appOutput.callbackMutex));
             if (appOutputCallbackCondInit) ARSAL_Cond_Destroy(&(streamReceiver->appOutput.callbackCond));
             if (recorderThreadMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->recorder.threadMutex));
             if (recorderThreadCondInit) ARSAL_Cond_Destroy(&(streamReceiver->recorder.threadCond));
+            if (pipelineStatsMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->pipeline.statsMutex));
+            if (pipelineThreadMutexInit) ARSAL_Mutex_Destroy(&(streamReceiver->pipeline.threadMutex));
+            if (pipelineThreadCondInit) ARSAL_Cond_Destroy(&(streamReceiver->pipeline.threadCond));
             ARSTREAM2_StreamStats_VideoStatsFileClose(&streamReceiver->videoStatsCtx);
             free(streamReceiver->debugPath);
             free(streamReceiver->friendlyName);
@@ -519,8 +803,17 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
         return ARSTREAM2_ERROR_BUSY;
     }
 
+    ARSAL_Mutex_Lock(&(streamReceiver->sharedStreamMutex));
+    if (streamReceiver->sharedStreamCount > 0)
+    {
+        ARSAL_Mutex_Unlock(&(streamReceiver->sharedStreamMutex));
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Free the instances sharing the transport before calling this function");
+        return ARSTREAM2_ERROR_BUSY;
+    }
+    ARSAL_Mutex_Unlock(&(streamReceiver->sharedStreamMutex));
+
     ARSAL_Mutex_Lock(&(streamReceiver->threadMutex));
-    if (streamReceiver->threadStarted == 1)
+    if ((streamReceiver->threadStarted == 1) && (((!streamReceiver->engine) && (!streamReceiver->transport)) || (!streamReceiver->threadShouldStop)))
     {
         ARSAL_Mutex_Unlock(&(streamReceiver->threadMutex));
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Call ARSTREAM2_StreamReceiver_Stop() before calling this function");
@@ -528,6 +821,74 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
     }
     ARSAL_Mutex_Unlock(&(streamReceiver->threadMutex));
 
+    if (streamReceiver->engine)
+    {
+        int engineRet = ARSTREAM2_StreamReceiverEngine_RemoveReceiver(streamReceiver->engine, streamReceiver);
+        if (engineRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiverEngine_RemoveReceiver() failed (%d)", engineRet);
+        }
+        if (streamReceiver->threadStarted)
+        {
+            /* the stop request has not been processed by the worker yet */
+            streamReceiver->threadStarted = 0;
+            ret = ARSTREAM2_RtpReceiver_ProcessEnd(streamReceiver->receiver, 0);
+            if (ret != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessEnd() failed (%d)", ret);
+            }
+        }
+        streamReceiver->engine = NULL;
+    }
+
+    if (streamReceiver->transport)
+    {
+        ARSTREAM2_StreamReceiver_t *transport = streamReceiver->transport;
+        int k;
+
+        ARSAL_Mutex_Lock(&(transport->sharedStreamMutex));
+        for (k = 0; k < transport->sharedStreamCount; k++)
+        {
+            if (transport->sharedStream[k] == streamReceiver)
+            {
+                transport->sharedStream[k] = transport->sharedStream[--transport->sharedStreamCount];
+                break;
+            }
+        }
+        ARSAL_Mutex_Unlock(&(transport->sharedStreamMutex));
+        if (streamReceiver->threadStarted)
+        {
+            /* the stop request has not been processed by the transport network thread yet */
+            streamReceiver->threadStarted = 0;
+            ret = ARSTREAM2_RtpReceiver_ProcessEnd(streamReceiver->receiver, 0);
+            if (ret != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessEnd() failed (%d)", ret);
+            }
+        }
+        streamReceiver->transport = NULL;
+    }
+
+    if (streamReceiver->pipeline.thread)
+    {
+        int thErr;
+        ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+        streamReceiver->pipeline.threadShouldStop = 1;
+        ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+        ARSAL_Cond_Signal(&(streamReceiver->pipeline.threadCond));
+
+        thErr = ARSAL_Thread_Join(streamReceiver->pipeline.thread, NULL);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSAL_Thread_Join() failed (%d)", thErr);
+        }
+        thErr = ARSAL_Thread_Destroy(&streamReceiver->pipeline.thread);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSAL_Thread_Destroy() failed (%d)", thErr);
+        }
+        streamReceiver->pipeline.thread = NULL;
+    }
 
     int recErr = ARSTREAM2_StreamReceiver_StreamRecorderFree(streamReceiver);
     if (recErr != 0)
@@ -535,19 +896,14 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiver_StreamRecorderFree() failed (%d)", recErr);
     }
 
-    ARSTREAM2_RtpResender_t *resender, *next;
-    for (resender = streamReceiver->resender; resender; resender = next)
+    if (streamReceiver->resendFanOut)
     {
-        ret = ARSTREAM2_RtpSender_Delete(&resender->sender);
+        ret = ARSTREAM2_RtpResender_FanOutDelete(&streamReceiver->resendFanOut);
         if (ret != ARSTREAM2_OK)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Unable to delete sender: %s", ARSTREAM2_Error_ToString(ret));
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Unable to delete resender fan-out: %s", ARSTREAM2_Error_ToString(ret));
         }
-        next = resender->next;
-        free(resender);
     }
-    free(streamReceiver->resendQueue);
-    free(streamReceiver->resendTimeout);
 
     ret = ARSTREAM2_RtpReceiver_Delete(&streamReceiver->receiver);
     if (ret != ARSTREAM2_OK)
@@ -561,10 +917,26 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Unable to delete H264Filter: %s", ARSTREAM2_Error_ToString(ret));
     }
 
+    if (streamReceiver->pipeline.threadEnabled)
+    {
+        ARSTREAM2_H264_AuFifoFlushQueue(&(streamReceiver->auFifo), &(streamReceiver->pipeline.auFifoQueue));
+        ARSTREAM2_H264_AuFifoRemoveQueue(&(streamReceiver->auFifo), &(streamReceiver->pipeline.auFifoQueue));
+        ARSAL_Mutex_Destroy(&(streamReceiver->pipeline.threadMutex));
+        ARSAL_Cond_Destroy(&(streamReceiver->pipeline.threadCond));
+    }
+
+    if (streamReceiver->recorder.preEventEnabled)
+    {
+        ARSTREAM2_H264_AuFifoFlushQueue(&(streamReceiver->auFifo), &(streamReceiver->recorder.preEventQueue));
+        ARSTREAM2_H264_AuFifoRemoveQueue(&(streamReceiver->auFifo), &(streamReceiver->recorder.preEventQueue));
+    }
+
     ARSTREAM2_RTP_PacketFifoFree(&(streamReceiver->packetFifo));
     ARSTREAM2_H264_AuFifoFree(&(streamReceiver->auFifo));
+    ARSAL_Mutex_Destroy(&(streamReceiver->pipeline.statsMutex));
     ARSAL_Mutex_Destroy(&(streamReceiver->threadMutex));
     ARSAL_Mutex_Destroy(&(streamReceiver->resendMutex));
+    ARSAL_Mutex_Destroy(&(streamReceiver->sharedStreamMutex));
     ARSAL_Mutex_Destroy(&(streamReceiver->appOutput.threadMutex));
     ARSAL_Cond_Destroy(&(streamReceiver->appOutput.threadCond));
     ARSAL_Mutex_Destroy(&(streamReceiver->appOutput.callbackMutex));
@@ -598,6 +970,23 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Free(ARSTREAM2_StreamReceiver_Handle *
 }
 
 
+static void ARSTREAM2_StreamReceiver_UpdateQueuePeakDepth(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoQueue_t *queue, int *peakDepth)
+{
+    int depth;
+
+    ARSAL_Mutex_Lock(&(queue->mutex));
+    depth = queue->count;
+    ARSAL_Mutex_Unlock(&(queue->mutex));
+
+    ARSAL_Mutex_Lock(&(streamReceiver->pipeline.statsMutex));
+    if (depth > *peakDepth)
+    {
+        *peakDepth = depth;
+    }
+    ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.statsMutex));
+}
+
+
 static int ARSTREAM2_StreamReceiver_AppOutputAuEnqueue(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem)
 {
     int err = 0, ret = 0, needUnref = 0, needFree = 0;
@@ -638,6 +1027,7 @@ static int ARSTREAM2_StreamReceiver_AppOutputAuEnqueue(ARSTREAM2_StreamReceiver_
         }
         else
         {
+            ARSTREAM2_StreamReceiver_UpdateQueuePeakDepth(streamReceiver, &streamReceiver->appOutput.auFifoQueue, &streamReceiver->pipeline.appOutputQueuePeakDepth);
             ARSAL_Cond_Signal(&(streamReceiver->appOutput.threadCond));
         }
     }
@@ -670,87 +1060,289 @@ static int ARSTREAM2_StreamReceiver_AppOutputAuEnqueue(ARSTREAM2_StreamReceiver_
 }
 
 
-static int ARSTREAM2_StreamReceiver_RecorderAuEnqueue(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem)
+static void ARSTREAM2_StreamReceiver_PreEventDropGop(ARSTREAM2_StreamReceiver_t *streamReceiver)
 {
-    int err = 0, ret = 0, needUnref = 0, needFree = 0;
-    ARSTREAM2_H264_AuFifoItem_t *recordtAuItem = NULL;
+    ARSTREAM2_H264_AuFifoQueue_t *queue = &streamReceiver->recorder.preEventQueue;
+    ARSTREAM2_H264_AuFifoItem_t *item;
+    int ret, first = 1;
 
-    ret = ARSTREAM2_H264_AuFifoBufferAddRef(&streamReceiver->auFifo, auItem->au.buffer);
-    if (ret < 0)
-    {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoBufferAddRef() failed (%d)", ret);
-    }
-    if (ret == 0)
+    /* drop the oldest access unit and all the following ones up to the next sync access unit */
+    do
     {
-        /* duplicate the AU and associated NALUs */
-        recordtAuItem = ARSTREAM2_H264_AuFifoDuplicateItem(&streamReceiver->auFifo, auItem);
-        if (recordtAuItem)
+        ARSAL_Mutex_Lock(&(queue->mutex));
+        item = queue->head;
+        ARSAL_Mutex_Unlock(&(queue->mutex));
+        if ((!item) || ((!first) && (item->au.syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE)))
         {
-            recordtAuItem->au.buffer = auItem->au.buffer;
+            break;
         }
-        else
+        item = ARSTREAM2_H264_AuFifoDequeueItem(queue);
+        if (item)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to pop free item from the AU FIFO");
-            ret = -1;
-            needUnref = 1;
+            if (item->au.syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE)
+            {
+                streamReceiver->recorder.preEventSyncCount--;
+            }
+            streamReceiver->recorder.preEventByteCount -= item->au.auSize;
+            ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, item->au.buffer);
+            if (ret != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+            }
+            ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, item);
+            if (ret != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+            }
         }
+        first = 0;
     }
+    while (item);
+}
 
-    if ((ret == 0) && (recordtAuItem))
+
+static int ARSTREAM2_StreamReceiver_PreEventSecondSyncTime(ARSTREAM2_StreamReceiver_t *streamReceiver, uint64_t *time)
+{
+    ARSTREAM2_H264_AuFifoQueue_t *queue = &streamReceiver->recorder.preEventQueue;
+    ARSTREAM2_H264_AuFifoItem_t *item;
+    int found = 0;
+
+    ARSAL_Mutex_Lock(&(queue->mutex));
+    for (item = (queue->head) ? queue->head->next : NULL; item; item = item->next)
     {
-        /* enqueue the AU */
-        ret = ARSTREAM2_H264_AuFifoEnqueueItem(&streamReceiver->recorder.auFifoQueue, recordtAuItem);
-        if (ret < 0)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoEnqueueItem() failed (%d)", ret);
-            err = -1;
-            needUnref = 1;
-            needFree = 1;
-        }
-        else
+        if (item->au.syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE)
         {
-            ARSAL_Cond_Signal(&(streamReceiver->recorder.threadCond));
+            *time = item->au.extRtpTimestamp;
+            found = 1;
+            break;
         }
     }
-    else
+    ARSAL_Mutex_Unlock(&(queue->mutex));
+
+    return found;
+}
+
+
+/* must be called with the recorder threadMutex held */
+static int ARSTREAM2_StreamReceiver_PreEventAuPush(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem)
+{
+    int ret = 0;
+    int isSync = (auItem->au.syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE);
+    uint64_t syncTime;
+    ARSTREAM2_H264_AuFifoItem_t *preEventAuItem = NULL;
+
+    ARSAL_Mutex_Lock(&(streamReceiver->recorder.preEventQueue.mutex));
+    int count = streamReceiver->recorder.preEventQueue.count;
+    ARSAL_Mutex_Unlock(&(streamReceiver->recorder.preEventQueue.mutex));
+    if (count == 0)
     {
-        err = -1;
+        /* the queue may have been flushed on AU FIFO exhaustion */
+        streamReceiver->recorder.preEventSyncCount = 0;
+        streamReceiver->recorder.preEventByteCount = 0;
     }
 
-    /* error handling */
-    if (needFree)
+    /* keep whole GOPs within the memory budget */
+    if (count >= streamReceiver->recorder.preEventMaxAuCount)
     {
-        ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, recordtAuItem);
-        if (ret != 0)
+        if (streamReceiver->recorder.preEventSyncCount >= 2)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+            ARSTREAM2_StreamReceiver_PreEventDropGop(streamReceiver);
         }
-        needFree = 0;
-    }
-    if (needUnref)
-    {
-        ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
-        if (ret != 0)
+        else
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+            /* a single GOP does not fit: start over at the next sync access unit */
+            ARSTREAM2_H264_AuFifoFlushQueue(&streamReceiver->auFifo, &streamReceiver->recorder.preEventQueue);
+            streamReceiver->recorder.preEventSyncCount = 0;
+            streamReceiver->recorder.preEventByteCount = 0;
         }
-        needUnref = 0;
     }
 
-    return err;
-}
-
-
-static int ARSTREAM2_StreamReceiver_GenerateGrayIdrFrame(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AccessUnit_t *nextAu)
-{
-    int err = 0, ret;
-
-    ARSTREAM2_H264_AuFifoBuffer_t *auBuffer = ARSTREAM2_H264_AuFifoGetBuffer(&streamReceiver->auFifo);
-    ARSTREAM2_H264_AuFifoItem_t *auItem = ARSTREAM2_H264_AuFifoPopFreeItem(&streamReceiver->auFifo);
+    /* the buffer always starts with a sync access unit */
+    if ((!isSync) && (streamReceiver->recorder.preEventSyncCount == 0))
+    {
+        return 0;
+    }
 
-    if ((!auBuffer) || (!auItem))
+    /* drop the oldest GOP once the following ones cover the duration */
+    while ((streamReceiver->recorder.preEventSyncCount >= 2)
+           && (ARSTREAM2_StreamReceiver_PreEventSecondSyncTime(streamReceiver, &syncTime))
+           && (auItem->au.extRtpTimestamp >= syncTime + streamReceiver->recorder.preEventDuration))
     {
-        if (auBuffer)
+        ARSTREAM2_StreamReceiver_PreEventDropGop(streamReceiver);
+    }
+
+    ret = ARSTREAM2_H264_AuFifoBufferAddRef(&streamReceiver->auFifo, auItem->au.buffer);
+    if (ret < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoBufferAddRef() failed (%d)", ret);
+        return -1;
+    }
+
+    /* duplicate the AU and associated NALUs */
+    preEventAuItem = ARSTREAM2_H264_AuFifoDuplicateItem(&streamReceiver->auFifo, auItem);
+    if (!preEventAuItem)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to pop free item from the AU FIFO");
+        ret = -1;
+    }
+    else
+    {
+        preEventAuItem->au.buffer = auItem->au.buffer;
+        ret = ARSTREAM2_H264_AuFifoEnqueueItem(&streamReceiver->recorder.preEventQueue, preEventAuItem);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoEnqueueItem() failed (%d)", ret);
+            int fifoErr = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, preEventAuItem);
+            if (fifoErr != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", fifoErr);
+            }
+        }
+    }
+
+    if (ret < 0)
+    {
+        int fifoErr = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
+        if (fifoErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", fifoErr);
+        }
+        return -1;
+    }
+
+    if (isSync)
+    {
+        streamReceiver->recorder.preEventSyncCount++;
+    }
+    streamReceiver->recorder.preEventByteCount += auItem->au.auSize;
+
+    return 0;
+}
+
+
+/* must be called with the recorder threadMutex held */
+static int ARSTREAM2_StreamReceiver_PreEventSplice(ARSTREAM2_StreamReceiver_t *streamReceiver)
+{
+    ARSTREAM2_H264_AuFifoItem_t *item;
+    int count = 0, ret;
+
+    /* the access units are moved, not copied: the buffers references are handed over to the recorder */
+    while ((item = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->recorder.preEventQueue)) != NULL)
+    {
+        ret = ARSTREAM2_H264_AuFifoEnqueueItem(&streamReceiver->recorder.auFifoQueue, item);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoEnqueueItem() failed (%d)", ret);
+            ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, item->au.buffer);
+            if (ret != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+            }
+            ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, item);
+            if (ret != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+            }
+        }
+        else
+        {
+            count++;
+        }
+    }
+    streamReceiver->recorder.preEventSyncCount = 0;
+    streamReceiver->recorder.preEventByteCount = 0;
+
+    if (count > 0)
+    {
+        ARSTREAM2_StreamReceiver_UpdateQueuePeakDepth(streamReceiver, &streamReceiver->recorder.auFifoQueue, &streamReceiver->pipeline.recorderQueuePeakDepth);
+    }
+
+    return count;
+}
+
+
+static int ARSTREAM2_StreamReceiver_RecorderAuEnqueue(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem)
+{
+    int err = 0, ret = 0, needUnref = 0, needFree = 0;
+    ARSTREAM2_H264_AuFifoItem_t *recordtAuItem = NULL;
+
+    ret = ARSTREAM2_H264_AuFifoBufferAddRef(&streamReceiver->auFifo, auItem->au.buffer);
+    if (ret < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoBufferAddRef() failed (%d)", ret);
+    }
+    if (ret == 0)
+    {
+        /* duplicate the AU and associated NALUs */
+        recordtAuItem = ARSTREAM2_H264_AuFifoDuplicateItem(&streamReceiver->auFifo, auItem);
+        if (recordtAuItem)
+        {
+            recordtAuItem->au.buffer = auItem->au.buffer;
+        }
+        else
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to pop free item from the AU FIFO");
+            ret = -1;
+            needUnref = 1;
+        }
+    }
+
+    if ((ret == 0) && (recordtAuItem))
+    {
+        /* enqueue the AU */
+        ret = ARSTREAM2_H264_AuFifoEnqueueItem(&streamReceiver->recorder.auFifoQueue, recordtAuItem);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoEnqueueItem() failed (%d)", ret);
+            err = -1;
+            needUnref = 1;
+            needFree = 1;
+        }
+        else
+        {
+            ARSTREAM2_StreamReceiver_UpdateQueuePeakDepth(streamReceiver, &streamReceiver->recorder.auFifoQueue, &streamReceiver->pipeline.recorderQueuePeakDepth);
+            ARSAL_Cond_Signal(&(streamReceiver->recorder.threadCond));
+        }
+    }
+    else
+    {
+        err = -1;
+    }
+
+    /* error handling */
+    if (needFree)
+    {
+        ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, recordtAuItem);
+        if (ret != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+        }
+        needFree = 0;
+    }
+    if (needUnref)
+    {
+        ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
+        if (ret != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+        }
+        needUnref = 0;
+    }
+
+    return err;
+}
+
+
+static int ARSTREAM2_StreamReceiver_GenerateGrayIdrFrame(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AccessUnit_t *nextAu)
+{
+    int err = 0, ret;
+
+    ARSTREAM2_H264_AuFifoBuffer_t *auBuffer = ARSTREAM2_H264_AuFifoGetBuffer(&streamReceiver->auFifo);
+    ARSTREAM2_H264_AuFifoItem_t *auItem = ARSTREAM2_H264_AuFifoPopFreeItem(&streamReceiver->auFifo);
+
+    if ((!auBuffer) || (!auItem))
+    {
+        if (auBuffer)
         {
             ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auBuffer);
             if (ret != 0)
@@ -855,17 +1447,10 @@ static int ARSTREAM2_StreamReceiver_GenerateGrayIdrFrame(ARSTREAM2_StreamReceive
 }
 
 
-static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoItem_t *auItem, void *userPtr)
+static int ARSTREAM2_StreamReceiver_FilterAu(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem)
 {
-    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)userPtr;
     int err = 0, ret;
 
-    if ((!auItem) || (!userPtr))
-    {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid pointer");
-        return -1;
-    }
-
     ret = ARSTREAM2_H264Filter_ProcessAu(streamReceiver->filter, &auItem->au);
     if (ret == 1)
     {
@@ -911,9 +1496,7 @@ static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoI
         }
         else if (auItem->au.videoStatsAvailable)
         {
-            struct timespec t1;
-            ARSAL_Time_GetTime(&t1);
-            uint64_t curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
+            uint64_t curTime = ARSTREAM2_Clock_GetTime(&streamReceiver->clock);
             ARSTREAM2_H264_VideoStats_t *vs = (ARSTREAM2_H264_VideoStats_t*)auItem->au.buffer->videoStatsBuffer;
             uint32_t outputTimestampDelta = (streamReceiver->lastAuOutputTimestamp)
                     ? (uint32_t)(curTime - streamReceiver->lastAuOutputTimestamp) : 0;
@@ -956,6 +1539,14 @@ static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoI
         /* stream recording */
         ARSAL_Mutex_Lock(&(streamReceiver->recorder.threadMutex));
         int recorderRunning = streamReceiver->recorder.running;
+        if ((!recorderRunning) && (streamReceiver->recorder.preEventEnabled))
+        {
+            ret = ARSTREAM2_StreamReceiver_PreEventAuPush(streamReceiver, auItem);
+            if (ret < 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiver_PreEventAuPush() failed (%d)", ret);
+            }
+        }
         ARSAL_Mutex_Unlock(&(streamReceiver->recorder.threadMutex));
         if (recorderRunning)
         {
@@ -990,6 +1581,122 @@ static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoI
 }
 
 
+static int ARSTREAM2_StreamReceiver_RtpReceiverAuCallback(ARSTREAM2_H264_AuFifoItem_t *auItem, void *userPtr)
+{
+    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)userPtr;
+    int err = 0, ret, depth;
+
+    if ((!auItem) || (!userPtr))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    if (!streamReceiver->pipeline.threadEnabled)
+    {
+        /* filter the access unit in the network thread */
+        return ARSTREAM2_StreamReceiver_FilterAu(streamReceiver, auItem);
+    }
+
+    /* hand over the access unit to the filter thread */
+    ARSAL_Mutex_Lock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+    depth = streamReceiver->pipeline.auFifoQueue.count;
+    ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+
+    if (depth < streamReceiver->pipeline.queueMaxSize)
+    {
+        ret = ARSTREAM2_H264_AuFifoEnqueueItem(&streamReceiver->pipeline.auFifoQueue, auItem);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoEnqueueItem() failed (%d)", ret);
+        }
+        else
+        {
+            ARSAL_Mutex_Lock(&(streamReceiver->pipeline.statsMutex));
+            if (depth + 1 > streamReceiver->pipeline.filterQueuePeakDepth)
+            {
+                streamReceiver->pipeline.filterQueuePeakDepth = depth + 1;
+            }
+            ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.statsMutex));
+
+            ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+            ARSAL_Cond_Signal(&(streamReceiver->pipeline.threadCond));
+            ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+            return 0;
+        }
+    }
+    else
+    {
+        /* the filter thread is late: drop the access unit rather than stall the network thread,
+         * the filter handles the missing frame as any other loss */
+        ARSAL_Mutex_Lock(&(streamReceiver->pipeline.statsMutex));
+        streamReceiver->pipeline.filterQueueDropCount++;
+        ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.statsMutex));
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_TAG, "Filter queue is full (%d), dropping access unit", depth);
+        err = -1;
+    }
+
+    /* free the access unit */
+    ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+    }
+    ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, auItem);
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+    }
+
+    return err;
+}
+
+
+static void* ARSTREAM2_StreamReceiver_RunFilterThread(void *streamReceiverHandle)
+{
+    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    ARSTREAM2_H264_AuFifoItem_t *auItem;
+    int shouldStop, ret;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "Filter thread running");
+
+    ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+    shouldStop = streamReceiver->pipeline.threadShouldStop;
+    ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+
+    while (shouldStop == 0)
+    {
+        /* dequeue and filter the access units */
+        while ((auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->pipeline.auFifoQueue)) != NULL)
+        {
+            ret = ARSTREAM2_StreamReceiver_FilterAu(streamReceiver, auItem);
+            if (ret < 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiver_FilterAu() failed (%d)", ret);
+            }
+        }
+
+        ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+        shouldStop = streamReceiver->pipeline.threadShouldStop;
+        if (!shouldStop)
+        {
+            ARSAL_Mutex_Lock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+            int depth = streamReceiver->pipeline.auFifoQueue.count;
+            ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+            if (depth == 0)
+            {
+                ARSAL_Cond_Wait(&(streamReceiver->pipeline.threadCond), &(streamReceiver->pipeline.threadMutex));
+            }
+        }
+        ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "Filter thread has ended");
+
+    return (void*)0;
+}
+
+
 static int ARSTREAM2_StreamReceiver_H264FilterSpsPpsCallback(uint8_t *spsBuffer, int spsSize, uint8_t *ppsBuffer, int ppsSize, void *userPtr)
 {
     ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)userPtr;
@@ -1061,6 +1768,50 @@ static int ARSTREAM2_StreamReceiver_H264FilterSpsPpsCallback(uint8_t *spsBuffer,
 }
 
 
+static void ARSTREAM2_StreamReceiver_StreamRecorderSetUntimedMetadata(ARSTREAM2_StreamReceiver_t *streamReceiver)
+{
+    eARSTREAM2_ERROR err;
+    ARSTREAM2_StreamReceiver_UntimedMetadata_t metadata;
+    memset(&metadata, 0, sizeof(ARSTREAM2_StreamReceiver_UntimedMetadata_t));
+    err = ARSTREAM2_StreamReceiver_GetPeerUntimedMetadata((ARSTREAM2_StreamReceiver_Handle)streamReceiver, &metadata);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiver_GetPeerUntimedMetadata() failed: %d (%s)",
+                    err, ARSTREAM2_Error_ToString(err));
+    }
+    else
+    {
+        /* Date format : <YYYY-MM-DDTHHMMSS+HHMM */
+        #define DATE_SIZE 23
+        #define DATE_FORMAT "%FT%H%M%S%z"
+        char mediaDate[DATE_SIZE];
+        struct tm timeInfo;
+        localtime_r(&streamReceiver->recorder.startTime, &timeInfo);
+        strftime(mediaDate, DATE_SIZE, DATE_FORMAT, &timeInfo);
+
+        ARSTREAM2_StreamRecorder_UntimedMetadata_t meta;
+        memset(&meta, 0, sizeof(ARSTREAM2_StreamRecorder_UntimedMetadata_t));
+        meta.makerAndModel = metadata.friendlyName;
+        meta.serialNumber = metadata.canonicalName;
+        meta.softwareVersion = metadata.applicationName;
+        meta.mediaDate = mediaDate;
+        meta.runDate = metadata.runDate;
+        meta.runUuid = metadata.runUuid;
+        meta.takeoffLatitude = metadata.takeoffLatitude;
+        meta.takeoffLongitude = metadata.takeoffLongitude;
+        meta.takeoffAltitude = metadata.takeoffAltitude;
+        meta.pictureHFov = metadata.pictureHFov;
+        meta.pictureVFov = metadata.pictureVFov;
+        err = ARSTREAM2_StreamRecorder_SetUntimedMetadata(streamReceiver->recorder.recorder, &meta);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamRecorder_SetUntimedMetadata() failed: %d (%s)",
+                        err, ARSTREAM2_Error_ToString(err));
+        }
+    }
+}
+
+
 static int ARSTREAM2_StreamReceiver_StreamRecorderInit(ARSTREAM2_StreamReceiver_t *streamReceiver)
 {
     int ret = -1;
@@ -1092,6 +1843,13 @@ static int ARSTREAM2_StreamReceiver_StreamRecorderInit(ARSTREAM2_StreamReceiver_
         recConfig.pps = streamReceiver->pPps;
         recConfig.ppsSize = streamReceiver->ppsSize;
         recConfig.serviceType = 0; //TODO
+        recConfig.directIo = streamReceiver->recorder.directIo;
+        recConfig.writeBatchSize = streamReceiver->recorder.writeBatchSize;
+        recConfig.syncIntervalMs = streamReceiver->recorder.syncIntervalMs;
+        recConfig.syncByteBudget = streamReceiver->recorder.syncByteBudget;
+        recConfig.segmentDurationMs = streamReceiver->recorder.segmentDurationMs;
+        recConfig.segmentMaxSize = streamReceiver->recorder.segmentMaxSize;
+        recConfig.diskQuota = streamReceiver->recorder.diskQuota;
         recConfig.auFifo = &streamReceiver->auFifo;
         recConfig.auFifoQueue = &streamReceiver->recorder.auFifoQueue;
         recConfig.mutex = &streamReceiver->recorder.threadMutex;
@@ -1105,26 +1863,35 @@ static int ARSTREAM2_StreamReceiver_StreamRecorderInit(ARSTREAM2_StreamReceiver_
         else
         {
             time(&streamReceiver->recorder.startTime);
+            /* the untimed metadata is written in the MP4 file header, before the first frame */
+            ARSTREAM2_StreamReceiver_StreamRecorderSetUntimedMetadata(streamReceiver);
+            /* the queue must exist before the thread starts dequeuing */
+            int auFifoRet = ARSTREAM2_H264_AuFifoAddQueue(&streamReceiver->auFifo, &streamReceiver->recorder.auFifoQueue);
+            if (auFifoRet != 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoAddQueue() failed (%d)", auFifoRet);
+            }
+            else
+            {
+                ARSAL_Mutex_Lock(&(streamReceiver->recorder.threadMutex));
+                /* the pre-event buffer starts with a sync access unit: no gray IDR frame is needed */
+                int preEventCount = (streamReceiver->recorder.preEventEnabled) ? ARSTREAM2_StreamReceiver_PreEventSplice(streamReceiver) : 0;
+                streamReceiver->recorder.grayIFramePending = (preEventCount == 0);
+                streamReceiver->recorder.running = 1;
+                ARSAL_Mutex_Unlock(&(streamReceiver->recorder.threadMutex));
+            }
             int thErr = ARSAL_Thread_Create(&streamReceiver->recorder.thread, ARSTREAM2_StreamRecorder_RunThread, (void*)streamReceiver->recorder.recorder);
             if (thErr != 0)
             {
                 ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Recorder thread creation failed (%d)", thErr);
+                /* the queue is removed when the recorder is freed */
+                ARSAL_Mutex_Lock(&(streamReceiver->recorder.threadMutex));
+                streamReceiver->recorder.running = 0;
+                ARSAL_Mutex_Unlock(&(streamReceiver->recorder.threadMutex));
             }
             else
             {
                 ret = 0;
-                int auFifoRet = ARSTREAM2_H264_AuFifoAddQueue(&streamReceiver->auFifo, &streamReceiver->recorder.auFifoQueue);
-                if (auFifoRet != 0)
-                {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264_AuFifoAddQueue() failed (%d)", auFifoRet);
-                }
-                else
-                {
-                    ARSAL_Mutex_Lock(&(streamReceiver->recorder.threadMutex));
-                    streamReceiver->recorder.grayIFramePending = 1;
-                    streamReceiver->recorder.running = 1;
-                    ARSAL_Mutex_Unlock(&(streamReceiver->recorder.threadMutex));
-                }
             }
         }
     }
@@ -1141,46 +1908,6 @@ static int ARSTREAM2_StreamReceiver_StreamRecorderStop(ARSTREAM2_StreamReceiver_
     {
         eARSTREAM2_ERROR err;
 
-        /* Set the untimed metadata */
-        ARSTREAM2_StreamReceiver_UntimedMetadata_t metadata;
-        memset(&metadata, 0, sizeof(ARSTREAM2_StreamReceiver_UntimedMetadata_t));
-        err = ARSTREAM2_StreamReceiver_GetPeerUntimedMetadata((ARSTREAM2_StreamReceiver_Handle)streamReceiver, &metadata);
-        if (err != ARSTREAM2_OK)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamReceiver_GetPeerUntimedMetadata() failed: %d (%s)",
-                        err, ARSTREAM2_Error_ToString(err));
-        }
-        else
-        {
-            /* Date format : <YYYY-MM-DDTHHMMSS+HHMM */
-            #define DATE_SIZE 23
-            #define DATE_FORMAT "%FT%H%M%S%z"
-            char mediaDate[DATE_SIZE];
-            struct tm timeInfo;
-            localtime_r(&streamReceiver->recorder.startTime, &timeInfo);
-            strftime(mediaDate, DATE_SIZE, DATE_FORMAT, &timeInfo);
-
-            ARSTREAM2_StreamRecorder_UntimedMetadata_t meta;
-            memset(&meta, 0, sizeof(ARSTREAM2_StreamRecorder_UntimedMetadata_t));
-            meta.makerAndModel = metadata.friendlyName;
-            meta.serialNumber = metadata.canonicalName;
-            meta.softwareVersion = metadata.applicationName;
-            meta.mediaDate = mediaDate;
-            meta.runDate = metadata.runDate;
-            meta.runUuid = metadata.runUuid;
-            meta.takeoffLatitude = metadata.takeoffLatitude;
-            meta.takeoffLongitude = metadata.takeoffLongitude;
-            meta.takeoffAltitude = metadata.takeoffAltitude;
-            meta.pictureHFov = metadata.pictureHFov;
-            meta.pictureVFov = metadata.pictureVFov;
-            err = ARSTREAM2_StreamRecorder_SetUntimedMetadata(streamReceiver->recorder.recorder, &meta);
-            if (err != ARSTREAM2_OK)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_StreamRecorder_SetUntimedMetadata() failed: %d (%s)",
-                            err, ARSTREAM2_Error_ToString(err));
-            }
-        }
-
         /* Stop the recorder */
         err = ARSTREAM2_StreamRecorder_Stop(streamReceiver->recorder.recorder);
         if (err != ARSTREAM2_OK)
@@ -1253,59 +1980,75 @@ static int ARSTREAM2_StreamReceiver_StreamRecorderFree(ARSTREAM2_StreamReceiver_
 }
 
 
-void* ARSTREAM2_StreamReceiver_RunAppOutputThread(void *streamReceiverHandle)
+static void ARSTREAM2_StreamReceiver_AppOutputAu(ARSTREAM2_StreamReceiver_t *streamReceiver, ARSTREAM2_H264_AuFifoItem_t *auItem, int running)
 {
-    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
-    int shouldStop, running, ret;
-    struct timespec t1;
     uint64_t curTime;
+    int ret;
 
-    if (!streamReceiverHandle)
+    ARSTREAM2_H264_AccessUnit_t *au = &auItem->au;
+    ARSTREAM2_H264_NaluFifoItem_t *naluItem;
+    unsigned int auSize = 0;
+
+    if ((streamReceiver->appOutput.mbWidth == 0) || (streamReceiver->appOutput.mbHeight == 0))
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid handle");
-        return NULL;
+        int mbWidth = 0, mbHeight = 0;
+        int err = ARSTREAM2_H264Filter_GetVideoParams(streamReceiver->filter, &mbWidth, &mbHeight, NULL, NULL, NULL);
+        if (err != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264Filter_GetVideoParams() failed (%d)",err);
+        }
+        streamReceiver->appOutput.mbWidth = mbWidth;
+        streamReceiver->appOutput.mbHeight = mbHeight;
     }
 
-    streamReceiver->appOutput.threadRunning = 1;
-    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "App output thread running");
+    /* pre-check the access unit size to avoid calling getAuBufferCallback+auReadyCallback for null sized frames */
+    for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
+    {
+        /* filter out unwanted NAL units */
+        if ((streamReceiver->appOutput.filterOutSpsPps) && ((naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SPS) || (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_PPS)))
+        {
+            continue;
+        }
+        if ((streamReceiver->appOutput.filterOutSei) && (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SEI))
+        {
+            continue;
+        }
 
-    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
-    shouldStop = streamReceiver->appOutput.threadShouldStop;
-    running = streamReceiver->appOutput.running;
-    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+        auSize += naluItem->nalu.naluSize;
+    }
 
-    while (shouldStop == 0)
+    if ((running) && (auSize > 0))
     {
-        ARSTREAM2_H264_AuFifoItem_t *auItem = NULL;
+        eARSTREAM2_ERROR cbRet = ARSTREAM2_OK;
+        uint8_t *auBuffer = NULL;
+        int auBufferSize = 0;
+        void *auBufferUserPtr = NULL;
+        ARSTREAM2_StreamReceiver_AuReadyCallbackTimestamps_t auTimestamps;
+        ARSTREAM2_StreamReceiver_AuReadyCallbackMetadata_t auMetadata;
 
-        ARSAL_Time_GetTime(&t1);
-        curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
-
-        if (running)
+        ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
+        streamReceiver->appOutput.callbackInProgress = 1;
+        if (streamReceiver->appOutput.getAuBufferCallback)
         {
-            /* dequeue an access unit */
-            auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->appOutput.auFifoQueue);
+            /* call the getAuBufferCallback */
+            ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
+
+            cbRet = streamReceiver->appOutput.getAuBufferCallback(&auBuffer, &auBufferSize, &auBufferUserPtr, streamReceiver->appOutput.getAuBufferCallbackUserPtr);
+
+            ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
         }
 
-        while (auItem != NULL)
+        if ((cbRet != ARSTREAM2_OK) || (!auBuffer) || (auBufferSize <= 0))
         {
-            ARSTREAM2_H264_AccessUnit_t *au = &auItem->au;
-            ARSTREAM2_H264_NaluFifoItem_t *naluItem;
-            unsigned int auSize = 0;
-
-            if ((streamReceiver->appOutput.mbWidth == 0) || (streamReceiver->appOutput.mbHeight == 0))
-            {
-                int mbWidth = 0, mbHeight = 0;
-                int err = ARSTREAM2_H264Filter_GetVideoParams(streamReceiver->filter, &mbWidth, &mbHeight, NULL, NULL, NULL);
-                if (err != 0)
-                {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_H264Filter_GetVideoParams() failed (%d)",err);
-                }
-                streamReceiver->appOutput.mbWidth = mbWidth;
-                streamReceiver->appOutput.mbHeight = mbHeight;
-            }
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "getAuBufferCallback failed: %s", ARSTREAM2_Error_ToString(cbRet));
+            streamReceiver->appOutput.callbackInProgress = 0;
+            ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
+            ARSAL_Cond_Signal(&(streamReceiver->appOutput.callbackCond));
+        }
+        else
+        {
+            auSize = 0;
 
-            /* pre-check the access unit size to avoid calling getAuBufferCallback+auReadyCallback for null sized frames */
             for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
             {
                 /* filter out unwanted NAL units */
@@ -1313,281 +2056,336 @@ void* ARSTREAM2_StreamReceiver_RunAppOutputThread(void *streamReceiverHandle)
                 {
                     continue;
                 }
+
                 if ((streamReceiver->appOutput.filterOutSei) && (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SEI))
                 {
                     continue;
                 }
 
-                auSize += naluItem->nalu.naluSize;
-            }
-
-            if ((running) && (auSize > 0))
-            {
-                eARSTREAM2_ERROR cbRet = ARSTREAM2_OK;
-                uint8_t *auBuffer = NULL;
-                int auBufferSize = 0;
-                void *auBufferUserPtr = NULL;
-                ARSTREAM2_StreamReceiver_AuReadyCallbackTimestamps_t auTimestamps;
-                ARSTREAM2_StreamReceiver_AuReadyCallbackMetadata_t auMetadata;
-
-                ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
-                streamReceiver->appOutput.callbackInProgress = 1;
-                if (streamReceiver->appOutput.getAuBufferCallback)
+                /* copy to output buffer */
+                if (auSize + naluItem->nalu.naluSize <= (unsigned)auBufferSize)
                 {
-                    /* call the getAuBufferCallback */
-                    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
-
-                    cbRet = streamReceiver->appOutput.getAuBufferCallback(&auBuffer, &auBufferSize, &auBufferUserPtr, streamReceiver->appOutput.getAuBufferCallbackUserPtr);
+                    memcpy(auBuffer + auSize, naluItem->nalu.nalu, naluItem->nalu.naluSize);
 
-                    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
-                }
+                    if ((naluItem->nalu.naluSize >= 4) && (streamReceiver->appOutput.replaceStartCodesWithNaluSize))
+                    {
+                        /* replace the NAL unit 4 bytes start code with the NALU size */
+                        *(auBuffer + auSize + 0) = ((naluItem->nalu.naluSize - 4) >> 24) & 0xFF;
+                        *(auBuffer + auSize + 1) = ((naluItem->nalu.naluSize - 4) >> 16) & 0xFF;
+                        *(auBuffer + auSize + 2) = ((naluItem->nalu.naluSize - 4) >>  8) & 0xFF;
+                        *(auBuffer + auSize + 3) = ((naluItem->nalu.naluSize - 4) >>  0) & 0xFF;
+                    }
 
-                if ((cbRet != ARSTREAM2_OK) || (!auBuffer) || (auBufferSize <= 0))
-                {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "getAuBufferCallback failed: %s", ARSTREAM2_Error_ToString(cbRet));
-                    streamReceiver->appOutput.callbackInProgress = 0;
-                    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
-                    ARSAL_Cond_Signal(&(streamReceiver->appOutput.callbackCond));
+                    auSize += naluItem->nalu.naluSize;
                 }
                 else
                 {
-                    auSize = 0;
-
-                    for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
-                    {
-                        /* filter out unwanted NAL units */
-                        if ((streamReceiver->appOutput.filterOutSpsPps) && ((naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SPS) || (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_PPS)))
-                        {
-                            continue;
-                        }
-
-                        if ((streamReceiver->appOutput.filterOutSei) && (naluItem->nalu.naluType == ARSTREAM2_H264_NALU_TYPE_SEI))
-                        {
-                            continue;
-                        }
-
-                        /* copy to output buffer */
-                        if (auSize + naluItem->nalu.naluSize <= (unsigned)auBufferSize)
-                        {
-                            memcpy(auBuffer + auSize, naluItem->nalu.nalu, naluItem->nalu.naluSize);
+                    break;
+                }
+            }
 
-                            if ((naluItem->nalu.naluSize >= 4) && (streamReceiver->appOutput.replaceStartCodesWithNaluSize))
-                            {
-                                /* replace the NAL unit 4 bytes start code with the NALU size */
-                                *(auBuffer + auSize + 0) = ((naluItem->nalu.naluSize - 4) >> 24) & 0xFF;
-                                *(auBuffer + auSize + 1) = ((naluItem->nalu.naluSize - 4) >> 16) & 0xFF;
-                                *(auBuffer + auSize + 2) = ((naluItem->nalu.naluSize - 4) >>  8) & 0xFF;
-                                *(auBuffer + auSize + 3) = ((naluItem->nalu.naluSize - 4) >>  0) & 0xFF;
-                            }
+            /* map the access unit sync type */
+            eARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE auSyncType;
+            switch (au->syncType)
+            {
+                default:
+                case ARSTREAM2_H264_AU_SYNC_TYPE_NONE:
+                    auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_NONE;
+                    break;
+                case ARSTREAM2_H264_AU_SYNC_TYPE_IDR:
+                    auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_IDR;
+                    break;
+                case ARSTREAM2_H264_AU_SYNC_TYPE_IFRAME:
+                    auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_IFRAME;
+                    break;
+                case ARSTREAM2_H264_AU_SYNC_TYPE_PIR_START:
+                    auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_PIR_START;
+                    break;
+            }
 
-                            auSize += naluItem->nalu.naluSize;
-                        }
-                        else
-                        {
-                            break;
-                        }
-                    }
+            curTime = ARSTREAM2_Clock_GetTime(&streamReceiver->clock);
+            if (au->videoStatsAvailable)
+            {
+                ARSTREAM2_H264_VideoStats_t *vs = (ARSTREAM2_H264_VideoStats_t*)au->buffer->videoStatsBuffer;
+                uint32_t outputTimestampDelta = (streamReceiver->lastAuOutputTimestamp)
+                        ? (uint32_t)(curTime - streamReceiver->lastAuOutputTimestamp) : 0;
+                uint32_t estimatedLatency = ((au->ntpTimestampLocal) && (curTime > au->ntpTimestampLocal))
+                        ? (uint32_t)(curTime - au->ntpTimestampLocal) : 0;
+                int32_t timingError = ((vs->timestampDelta) && (streamReceiver->lastAuOutputTimestamp))
+                        ? ((int32_t)vs->timestampDelta - (int32_t)outputTimestampDelta) : 0;
+                vs->timingError = timingError;
+                streamReceiver->timingErrorIntegral += (timingError < 0) ? (uint32_t)(-timingError) : (uint32_t)timingError;
+                vs->timingErrorIntegral = streamReceiver->timingErrorIntegral;
+                streamReceiver->timingErrorIntegralSq += (int64_t)timingError * (int64_t)timingError;
+                vs->timingErrorIntegralSq = streamReceiver->timingErrorIntegralSq;
+                vs->estimatedLatency = estimatedLatency;
+                streamReceiver->estimatedLatencyIntegral += estimatedLatency;
+                vs->estimatedLatencyIntegral = streamReceiver->estimatedLatencyIntegral;
+                streamReceiver->estimatedLatencyIntegralSq += (uint64_t)estimatedLatency * (uint64_t)estimatedLatency;
+                vs->estimatedLatencyIntegralSq = streamReceiver->estimatedLatencyIntegralSq;
+                vs->timestamp = au->ntpTimestampRaw;
+
+                /* get the RSSI from the streaming metadata */
+                //TODO: remove this hack once we have a better way of getting the RSSI
+                if ((au->metadataSize >= 27) && (ntohs(*((uint16_t*)au->buffer->metadataBuffer)) == 0x5031))
+                {
+                    vs->rssi = (int8_t)au->buffer->metadataBuffer[26];
+                }
+                if ((au->metadataSize >= 55) && (ntohs(*((uint16_t*)au->buffer->metadataBuffer)) == 0x5032))
+                {
+                    vs->rssi = (int8_t)au->buffer->metadataBuffer[54];
+                }
 
-                    /* map the access unit sync type */
-                    eARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE auSyncType;
-                    switch (au->syncType)
-                    {
-                        default:
-                        case ARSTREAM2_H264_AU_SYNC_TYPE_NONE:
-                            auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_NONE;
-                            break;
-                        case ARSTREAM2_H264_AU_SYNC_TYPE_IDR:
-                            auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_IDR;
-                            break;
-                        case ARSTREAM2_H264_AU_SYNC_TYPE_IFRAME:
-                            auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_IFRAME;
-                            break;
-                        case ARSTREAM2_H264_AU_SYNC_TYPE_PIR_START:
-                            auSyncType = ARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE_PIR_START;
-                            break;
-                    }
+                eARSTREAM2_ERROR recvErr = ARSTREAM2_RtpReceiver_UpdateVideoStats(streamReceiver->receiver, vs);
+                if (recvErr != ARSTREAM2_OK)
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_UpdateVideoStats() failed (%d)", recvErr);
+                }
+                ARSTREAM2_StreamStats_VideoStatsFileWrite(&streamReceiver->videoStatsCtx, vs);
+            }
 
-                    ARSAL_Time_GetTime(&t1);
-                    curTime = (uint64_t)t1.tv_sec * 1000000 + (uint64_t)t1.tv_nsec / 1000;
-                    if (au->videoStatsAvailable)
+            /* timestamps and metadata */
+            memset(&auTimestamps, 0, sizeof(auTimestamps));
+            memset(&auMetadata, 0, sizeof(auMetadata));
+            auTimestamps.auNtpTimestamp = au->ntpTimestamp;
+            auTimestamps.auNtpTimestampRaw = au->ntpTimestampRaw;
+            auTimestamps.auNtpTimestampLocal = au->ntpTimestampLocal;
+            auMetadata.isComplete = au->isComplete;
+            auMetadata.hasErrors = au->hasErrors;
+            auMetadata.isRef = au->isRef;
+            auMetadata.auMetadata = (au->metadataSize > 0) ? au->buffer->metadataBuffer : NULL;
+            auMetadata.auMetadataSize = au->metadataSize;
+            auMetadata.auUserData = (au->userDataSize > 0) ? au->buffer->userDataBuffer : NULL;
+            auMetadata.auUserDataSize = au->userDataSize;
+            auMetadata.mbWidth = streamReceiver->appOutput.mbWidth;
+            auMetadata.mbHeight = streamReceiver->appOutput.mbHeight;
+            auMetadata.mbStatus = (au->mbStatusAvailable) ? au->buffer->mbStatusBuffer : NULL;
+            if (au->videoStatsAvailable)
+            {
+                /* Map the video stats */
+                ARSTREAM2_H264_VideoStats_t *vs = (ARSTREAM2_H264_VideoStats_t*)au->buffer->videoStatsBuffer;
+                ARSTREAM2_StreamStats_VideoStats_t *vsOut = &streamReceiver->appOutput.videoStats;
+                uint32_t i, j;
+                vsOut->timestamp = vs->timestamp;
+                vsOut->rssi = vs->rssi;
+                vsOut->totalFrameCount = vs->totalFrameCount;
+                vsOut->outputFrameCount = vs->outputFrameCount;
+                vsOut->erroredOutputFrameCount = vs->erroredOutputFrameCount;
+                vsOut->missedFrameCount = vs->missedFrameCount;
+                vsOut->discardedFrameCount = vs->discardedFrameCount;
+                vsOut->timestampDeltaIntegral = vs->timestampDeltaIntegral;
+                vsOut->timestampDeltaIntegralSq = vs->timestampDeltaIntegralSq;
+                vsOut->timingErrorIntegral = vs->timingErrorIntegral;
+                vsOut->timingErrorIntegralSq = vs->timingErrorIntegralSq;
+                vsOut->estimatedLatencyIntegral = vs->estimatedLatencyIntegral;
+                vsOut->estimatedLatencyIntegralSq = vs->estimatedLatencyIntegralSq;
+                vsOut->erroredSecondCount = vs->erroredSecondCount;
+                vsOut->mbStatusZoneCount = vs->mbStatusZoneCount;
+                vsOut->mbStatusClassCount = vs->mbStatusClassCount;
+                if (vs->mbStatusZoneCount == ARSTREAM2_H264_MB_STATUS_ZONE_COUNT)
+                {
+                    if (vsOut->erroredSecondCountByZone)
                     {
-                        ARSTREAM2_H264_VideoStats_t *vs = (ARSTREAM2_H264_VideoStats_t*)au->buffer->videoStatsBuffer;
-                        uint32_t outputTimestampDelta = (streamReceiver->lastAuOutputTimestamp)
-                                ? (uint32_t)(curTime - streamReceiver->lastAuOutputTimestamp) : 0;
-                        uint32_t estimatedLatency = ((au->ntpTimestampLocal) && (curTime > au->ntpTimestampLocal))
-                                ? (uint32_t)(curTime - au->ntpTimestampLocal) : 0;
-                        int32_t timingError = ((vs->timestampDelta) && (streamReceiver->lastAuOutputTimestamp))
-                                ? ((int32_t)vs->timestampDelta - (int32_t)outputTimestampDelta) : 0;
-                        vs->timingError = timingError;
-                        streamReceiver->timingErrorIntegral += (timingError < 0) ? (uint32_t)(-timingError) : (uint32_t)timingError;
-                        vs->timingErrorIntegral = streamReceiver->timingErrorIntegral;
-                        streamReceiver->timingErrorIntegralSq += (int64_t)timingError * (int64_t)timingError;
-                        vs->timingErrorIntegralSq = streamReceiver->timingErrorIntegralSq;
-                        vs->estimatedLatency = estimatedLatency;
-                        streamReceiver->estimatedLatencyIntegral += estimatedLatency;
-                        vs->estimatedLatencyIntegral = streamReceiver->estimatedLatencyIntegral;
-                        streamReceiver->estimatedLatencyIntegralSq += (uint64_t)estimatedLatency * (uint64_t)estimatedLatency;
-                        vs->estimatedLatencyIntegralSq = streamReceiver->estimatedLatencyIntegralSq;
-                        vs->timestamp = au->ntpTimestampRaw;
-
-                        /* get the RSSI from the streaming metadata */
-                        //TODO: remove this hack once we have a better way of getting the RSSI
-                        if ((au->metadataSize >= 27) && (ntohs(*((uint16_t*)au->buffer->metadataBuffer)) == 0x5031))
+                        for (i = 0; i < vs->mbStatusZoneCount; i++)
                         {
-                            vs->rssi = (int8_t)au->buffer->metadataBuffer[26];
+                            vsOut->erroredSecondCountByZone[i] = vs->erroredSecondCountByZone[i];
                         }
-                        if ((au->metadataSize >= 55) && (ntohs(*((uint16_t*)au->buffer->metadataBuffer)) == 0x5032))
-                        {
-                            vs->rssi = (int8_t)au->buffer->metadataBuffer[54];
-                        }
-
-                        eARSTREAM2_ERROR recvErr = ARSTREAM2_RtpReceiver_UpdateVideoStats(streamReceiver->receiver, vs);
-                        if (recvErr != ARSTREAM2_OK)
-                        {
-                            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_UpdateVideoStats() failed (%d)", recvErr);
-                        }
-                        ARSTREAM2_StreamStats_VideoStatsFileWrite(&streamReceiver->videoStatsCtx, vs);
                     }
-
-                    /* timestamps and metadata */
-                    memset(&auTimestamps, 0, sizeof(auTimestamps));
-                    memset(&auMetadata, 0, sizeof(auMetadata));
-                    auTimestamps.auNtpTimestamp = au->ntpTimestamp;
-                    auTimestamps.auNtpTimestampRaw = au->ntpTimestampRaw;
-                    auTimestamps.auNtpTimestampLocal = au->ntpTimestampLocal;
-                    auMetadata.isComplete = au->isComplete;
-                    auMetadata.hasErrors = au->hasErrors;
-                    auMetadata.isRef = au->isRef;
-                    auMetadata.auMetadata = (au->metadataSize > 0) ? au->buffer->metadataBuffer : NULL;
-                    auMetadata.auMetadataSize = au->metadataSize;
-                    auMetadata.auUserData = (au->userDataSize > 0) ? au->buffer->userDataBuffer : NULL;
-                    auMetadata.auUserDataSize = au->userDataSize;
-                    auMetadata.mbWidth = streamReceiver->appOutput.mbWidth;
-                    auMetadata.mbHeight = streamReceiver->appOutput.mbHeight;
-                    auMetadata.mbStatus = (au->mbStatusAvailable) ? au->buffer->mbStatusBuffer : NULL;
-                    if (au->videoStatsAvailable)
+                    if (vs->mbStatusClassCount == ARSTREAM2_H264_MB_STATUS_CLASS_COUNT)
                     {
-                        /* Map the video stats */
-                        ARSTREAM2_H264_VideoStats_t *vs = (ARSTREAM2_H264_VideoStats_t*)au->buffer->videoStatsBuffer;
-                        ARSTREAM2_StreamStats_VideoStats_t *vsOut = &streamReceiver->appOutput.videoStats;
-                        uint32_t i, j;
-                        vsOut->timestamp = vs->timestamp;
-                        vsOut->rssi = vs->rssi;
-                        vsOut->totalFrameCount = vs->totalFrameCount;
-                        vsOut->outputFrameCount = vs->outputFrameCount;
-                        vsOut->erroredOutputFrameCount = vs->erroredOutputFrameCount;
-                        vsOut->missedFrameCount = vs->missedFrameCount;
-                        vsOut->discardedFrameCount = vs->discardedFrameCount;
-                        vsOut->timestampDeltaIntegral = vs->timestampDeltaIntegral;
-                        vsOut->timestampDeltaIntegralSq = vs->timestampDeltaIntegralSq;
-                        vsOut->timingErrorIntegral = vs->timingErrorIntegral;
-                        vsOut->timingErrorIntegralSq = vs->timingErrorIntegralSq;
-                        vsOut->estimatedLatencyIntegral = vs->estimatedLatencyIntegral;
-                        vsOut->estimatedLatencyIntegralSq = vs->estimatedLatencyIntegralSq;
-                        vsOut->erroredSecondCount = vs->erroredSecondCount;
-                        vsOut->mbStatusZoneCount = vs->mbStatusZoneCount;
-                        vsOut->mbStatusClassCount = vs->mbStatusClassCount;
-                        if (vs->mbStatusZoneCount == ARSTREAM2_H264_MB_STATUS_ZONE_COUNT)
+                        if (vsOut->macroblockStatus)
                         {
-                            if (vsOut->erroredSecondCountByZone)
+                            for (j = 0; j < vs->mbStatusClassCount; j++)
                             {
                                 for (i = 0; i < vs->mbStatusZoneCount; i++)
                                 {
-                                    vsOut->erroredSecondCountByZone[i] = vs->erroredSecondCountByZone[i];
-                                }
-                            }
-                            if (vs->mbStatusClassCount == ARSTREAM2_H264_MB_STATUS_CLASS_COUNT)
-                            {
-                                if (vsOut->macroblockStatus)
-                                {
-                                    for (j = 0; j < vs->mbStatusClassCount; j++)
-                                    {
-                                        for (i = 0; i < vs->mbStatusZoneCount; i++)
-                                        {
-                                            vsOut->macroblockStatus[j * vs->mbStatusZoneCount + i] = vs->macroblockStatus[j][i];
-                                        }
-                                    }
+                                    vsOut->macroblockStatus[j * vs->mbStatusZoneCount + i] = vs->macroblockStatus[j][i];
                                 }
                             }
                         }
-                        auMetadata.videoStats = vsOut;
                     }
-                    else
-                    {
-                        auMetadata.videoStats = NULL;
-                    }
-                    auMetadata.debugString = NULL; //TODO
-
-                    if (streamReceiver->appOutput.auReadyCallback)
-                    {
-                        /* call the auReadyCallback */
-                        ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
-
-                        cbRet = streamReceiver->appOutput.auReadyCallback(auBuffer, auSize, &auTimestamps, auSyncType, &auMetadata,
-                                                                          auBufferUserPtr, streamReceiver->appOutput.auReadyCallbackUserPtr);
-
-                        ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
-                    }
-                    streamReceiver->appOutput.callbackInProgress = 0;
-                    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
-                    ARSAL_Cond_Signal(&(streamReceiver->appOutput.callbackCond));
-
-                    if (cbRet != ARSTREAM2_OK)
-                    {
-                        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_TAG, "auReadyCallback failed: %s", ARSTREAM2_Error_ToString(cbRet));
-                        if (cbRet == ARSTREAM2_ERROR_RESYNC_REQUIRED)
-                        {
-                            /* schedule gray IDR frame */
-                            streamReceiver->appOutput.grayIFramePending = 1;
-                        }
-                    }
-                    streamReceiver->lastAuOutputTimestamp = curTime;
                 }
+                auMetadata.videoStats = vsOut;
+            }
+            else
+            {
+                auMetadata.videoStats = NULL;
             }
+            auMetadata.debugString = NULL; //TODO
 
-            /* free the access unit */
-            ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
-            if (ret != 0)
+            if (streamReceiver->appOutput.auReadyCallback)
             {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+                /* call the auReadyCallback */
+                ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
+
+                cbRet = streamReceiver->appOutput.auReadyCallback(auBuffer, auSize, &auTimestamps, auSyncType, &auMetadata,
+                                                                  auBufferUserPtr, streamReceiver->appOutput.auReadyCallbackUserPtr);
+
+                ARSAL_Mutex_Lock(&(streamReceiver->appOutput.callbackMutex));
             }
-            ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, auItem);
-            if (ret != 0)
+            streamReceiver->appOutput.callbackInProgress = 0;
+            ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.callbackMutex));
+            ARSAL_Cond_Signal(&(streamReceiver->appOutput.callbackCond));
+
+            if (cbRet != ARSTREAM2_OK)
             {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_TAG, "auReadyCallback failed: %s", ARSTREAM2_Error_ToString(cbRet));
+                if (cbRet == ARSTREAM2_ERROR_RESYNC_REQUIRED)
+                {
+                    /* schedule gray IDR frame */
+                    streamReceiver->appOutput.grayIFramePending = 1;
+                }
             }
+            streamReceiver->lastAuOutputTimestamp = curTime;
+        }
+    }
+
+    /* free the access unit */
+    ret = ARSTREAM2_H264_AuFifoUnrefBuffer(&streamReceiver->auFifo, auItem->au.buffer);
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to unref buffer (%d)", ret);
+    }
+    ret = ARSTREAM2_H264_AuFifoPushFreeItem(&streamReceiver->auFifo, auItem);
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Failed to push free item in the AU FIFO (%d)", ret);
+    }
+}
+
+
+void* ARSTREAM2_StreamReceiver_RunAppOutputThread(void *streamReceiverHandle)
+{
+    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    int shouldStop, running;
+
+    if (!streamReceiverHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid handle");
+        return NULL;
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "App output thread running");
+
+    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
+    /* set under the mutex: engine workers stop dequeuing once it is set */
+    streamReceiver->appOutput.threadRunning = 1;
+    shouldStop = streamReceiver->appOutput.threadShouldStop;
+    running = streamReceiver->appOutput.running;
+    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+
+    while (shouldStop == 0)
+    {
+        ARSTREAM2_H264_AuFifoItem_t *auItem = NULL;
+
+        if (running)
+        {
+            /* dequeue an access unit */
+            auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->appOutput.auFifoQueue);
+        }
+
+        while (auItem != NULL)
+        {
+            ARSTREAM2_StreamReceiver_AppOutputAu(streamReceiver, auItem, running);
+
+            /* dequeue the next access unit */
+            auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->appOutput.auFifoQueue);
+        }
+
+        ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
+        shouldStop = streamReceiver->appOutput.threadShouldStop;
+        running = streamReceiver->appOutput.running;
+        if (!shouldStop)
+        {
+            ARSAL_Cond_Wait(&(streamReceiver->appOutput.threadCond), &(streamReceiver->appOutput.threadMutex));
+        }
+        ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "App output thread has ended");
+    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
+    streamReceiver->appOutput.threadRunning = 0;
+    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+
+    return (void*)0;
+}
+
+
+static int ARSTREAM2_StreamReceiver_PrepareSelect(ARSTREAM2_StreamReceiver_t *streamReceiver, fd_set **readSet, fd_set **writeSet, fd_set **exceptSet,
+                                                  int *maxFd, uint32_t *nextTimeout)
+{
+    eARSTREAM2_ERROR err;
 
-            /* dequeue the next access unit */
-            auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->appOutput.auFifoQueue);
-        }
+    /* the resenders run in their own threads */
+    err = ARSTREAM2_RtpReceiver_GetSelectParams(streamReceiver->receiver, readSet, writeSet, exceptSet, maxFd, nextTimeout);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_GetSelectParams() failed (%d)", err);
+        return -1;
+    }
 
-        ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
-        shouldStop = streamReceiver->appOutput.threadShouldStop;
-        running = streamReceiver->appOutput.running;
-        if (!shouldStop)
+    if ((readSet) && (*readSet) && (writeSet) && (*writeSet) && (exceptSet) && (*exceptSet))
+    {
+        int k;
+        ARSAL_Mutex_Lock(&(streamReceiver->sharedStreamMutex));
+        for (k = 0; k < streamReceiver->sharedStreamCount; k++)
         {
-            ARSAL_Cond_Wait(&(streamReceiver->appOutput.threadCond), &(streamReceiver->appOutput.threadMutex));
+            ARSTREAM2_StreamReceiver_EngineGetSelectParams(streamReceiver->sharedStream[k], *readSet, *writeSet, *exceptSet, maxFd, nextTimeout);
         }
-        ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+        ARSAL_Mutex_Unlock(&(streamReceiver->sharedStreamMutex));
     }
 
-    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "App output thread has ended");
-    streamReceiver->appOutput.threadRunning = 0;
+    return 0;
+}
 
-    return (void*)0;
+
+static void ARSTREAM2_StreamReceiver_ProcessNetwork(ARSTREAM2_StreamReceiver_t *streamReceiver, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
+                                                    int *shouldStop)
+{
+    ARSTREAM2_RTP_PacketRing_t *resendRing;
+    eARSTREAM2_ERROR err;
+    int k;
+
+    ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
+
+    err = ARSTREAM2_RtpReceiver_ProcessRtcp(streamReceiver->receiver, selectRet, readSet, writeSet, exceptSet, shouldStop);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessRtcp() failed (%d)", err);
+    }
+    resendRing = (streamReceiver->resendFanOut) ? &streamReceiver->resendFanOut->packetRing : NULL;
+    err = ARSTREAM2_RtpReceiver_ProcessRtp(streamReceiver->receiver, selectRet, readSet, writeSet, exceptSet, shouldStop,
+                                           &resendRing, (streamReceiver->resendFanOut) ? 1 : 0);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessRtp() failed (%d)", err);
+    }
+
+    /* the packets have been handed over, wake up the resender thread */
+    ARSTREAM2_RtpResender_FanOutSignal(streamReceiver->resendFanOut);
+
+    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
+
+    /* process the instances sharing the sockets while the demultiplexed packets are valid */
+    ARSAL_Mutex_Lock(&(streamReceiver->sharedStreamMutex));
+    for (k = 0; k < streamReceiver->sharedStreamCount; k++)
+    {
+        ARSTREAM2_StreamReceiver_EngineProcess(streamReceiver->sharedStream[k], selectRet, readSet, writeSet, exceptSet, NULL, 0);
+        ARSTREAM2_StreamReceiver_EngineOutput(streamReceiver->sharedStream[k]);
+    }
+    ARSAL_Mutex_Unlock(&(streamReceiver->sharedStreamMutex));
 }
 
 
 void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
 {
     ARSTREAM2_StreamReceiver_t *streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
-    ARSTREAM2_RtpResender_t *resender;
     int shouldStop, selectRet = 0;
     fd_set readSet, writeSet, exceptSet;
     fd_set *pReadSet, *pWriteSet, *pExceptSet;
-    int maxFd = 0, _maxFd = 0;
+    int maxFd = 0;
     struct timeval tv;
-    uint32_t nextTimeout = 0, _timeout = 0;
+    uint32_t nextTimeout = 0;
     eARSTREAM2_ERROR err;
 
     if (!streamReceiverHandle)
@@ -1596,6 +2394,17 @@ void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
         return NULL;
     }
 
+    if (streamReceiver->engine)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "Network processing is done by the engine workers");
+        return (void*)0;
+    }
+    if (streamReceiver->transport)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "Network processing is done by the transport instance network thread");
+        return (void*)0;
+    }
+
     ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_TAG, "Receiver thread running");
     ARSAL_Mutex_Lock(&(streamReceiver->threadMutex));
     streamReceiver->threadStarted = 1;
@@ -1609,27 +2418,11 @@ void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
     pWriteSet = &writeSet;
     pExceptSet = &exceptSet;
 
-    err = ARSTREAM2_RtpReceiver_GetSelectParams(streamReceiver->receiver, &pReadSet, &pWriteSet, &pExceptSet, &maxFd, &nextTimeout);
-    if (err != ARSTREAM2_OK)
+    if (ARSTREAM2_StreamReceiver_PrepareSelect(streamReceiver, &pReadSet, &pWriteSet, &pExceptSet, &maxFd, &nextTimeout) != 0)
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_GetSelectParams() failed (%d)", err);
         return (void *)0;
     }
 
-    ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
-    for (resender = streamReceiver->resender; resender; resender = resender->next)
-    {
-        err = ARSTREAM2_RtpSender_GetSelectParams(resender->sender, &pReadSet, &pWriteSet, &pExceptSet, &_maxFd, &_timeout);
-        if (err != ARSTREAM2_OK)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_GetSelectParams() failed (%d)", err);
-            return (void *)0;
-        }
-        if (_timeout < nextTimeout) nextTimeout = _timeout;
-        if (_maxFd > maxFd) maxFd = _maxFd;
-    }
-    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
-
     if (pReadSet)
         FD_SET(streamReceiver->signalPipe[0], pReadSet);
     if (pExceptSet)
@@ -1651,35 +2444,7 @@ void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
             }
         }
 
-        ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
-
-        err = ARSTREAM2_RtpReceiver_ProcessRtcp(streamReceiver->receiver, selectRet, pReadSet, pWriteSet, pExceptSet, &shouldStop);
-        if (err != ARSTREAM2_OK)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessRtcp() failed (%d)", err);
-        }
-        err = ARSTREAM2_RtpReceiver_ProcessRtp(streamReceiver->receiver, selectRet, pReadSet, pWriteSet, pExceptSet, &shouldStop,
-                                               streamReceiver->resendQueue, streamReceiver->resendTimeout, streamReceiver->resendCount);
-        if (err != ARSTREAM2_OK)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessRtp() failed (%d)", err);
-        }
-
-        for (resender = streamReceiver->resender; resender; resender = resender->next)
-        {
-            err = ARSTREAM2_RtpSender_ProcessRtcp(resender->sender, selectRet, pReadSet, pWriteSet, pExceptSet);
-            if (err != ARSTREAM2_OK)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpSender_ProcessRtcp() failed (%d)", err);
-            }
-            err = ARSTREAM2_RtpSender_ProcessRtp(resender->sender, selectRet, pReadSet, pWriteSet, pExceptSet);
-            if (err != ARSTREAM2_OK)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpSender_ProcessRtp() failed (%d)", err);
-            }
-        }
-
-        ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
+        ARSTREAM2_StreamReceiver_ProcessNetwork(streamReceiver, selectRet, pReadSet, pWriteSet, pExceptSet, &shouldStop);
 
         if ((pReadSet) && ((selectRet >= 0) && (FD_ISSET(streamReceiver->signalPipe[0], pReadSet))))
         {
@@ -1710,27 +2475,11 @@ void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
             pWriteSet = &writeSet;
             pExceptSet = &exceptSet;
 
-            err = ARSTREAM2_RtpReceiver_GetSelectParams(streamReceiver->receiver, &pReadSet, &pWriteSet, &pExceptSet, &maxFd, &nextTimeout);
-            if (err != ARSTREAM2_OK)
+            if (ARSTREAM2_StreamReceiver_PrepareSelect(streamReceiver, &pReadSet, &pWriteSet, &pExceptSet, &maxFd, &nextTimeout) != 0)
             {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_GetSelectParams() failed (%d)", err);
                 break;
             }
 
-            ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
-            for (resender = streamReceiver->resender; resender; resender = resender->next)
-            {
-                err = ARSTREAM2_RtpSender_GetSelectParams(resender->sender, &pReadSet, &pWriteSet, &pExceptSet, &_maxFd, &_timeout);
-                if (err != ARSTREAM2_OK)
-                {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_GetSelectParams() failed (%d)", err);
-                    break;
-                }
-                if (_timeout < nextTimeout) nextTimeout = _timeout;
-                if (_maxFd > maxFd) maxFd = _maxFd;
-            }
-            ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
-
             if (pReadSet)
                 FD_SET(streamReceiver->signalPipe[0], pReadSet);
             if (pExceptSet)
@@ -1758,6 +2507,181 @@ void* ARSTREAM2_StreamReceiver_RunNetworkThread(void *streamReceiverHandle)
 }
 
 
+int ARSTREAM2_StreamReceiver_EngineGetSelectParams(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
+                                                   int *maxFd, uint32_t *nextTimeout)
+{
+    ARSTREAM2_StreamReceiver_t *streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    fd_set *pReadSet = readSet, *pWriteSet = writeSet, *pExceptSet = exceptSet;
+    int _maxFd = 0;
+    uint32_t _timeout = 0;
+
+    if (!streamReceiver->threadStarted)
+    {
+        return -1;
+    }
+
+    if (ARSTREAM2_StreamReceiver_PrepareSelect(streamReceiver, &pReadSet, &pWriteSet, &pExceptSet, &_maxFd, &_timeout) != 0)
+    {
+        return -1;
+    }
+    if (_maxFd > *maxFd) *maxFd = _maxFd;
+    if (_timeout < *nextTimeout) *nextTimeout = _timeout;
+
+    return 0;
+}
+
+
+int ARSTREAM2_StreamReceiver_EngineProcess(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
+                                           struct mmsghdr **ingestMsg, unsigned int ingestMsgCount)
+{
+    ARSTREAM2_StreamReceiver_t *streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    int shouldStop = 0;
+    eARSTREAM2_ERROR err;
+
+    if (!streamReceiver->threadStarted)
+    {
+        return 1;
+    }
+
+    ARSAL_Mutex_Lock(&(streamReceiver->threadMutex));
+    shouldStop = streamReceiver->threadShouldStop;
+    ARSAL_Mutex_Unlock(&(streamReceiver->threadMutex));
+
+    if (!shouldStop)
+    {
+        if (ingestMsgCount > 0)
+        {
+            err = ARSTREAM2_RtpReceiver_IngestPackets(streamReceiver->receiver, ingestMsg, ingestMsgCount);
+            if (err != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_IngestPackets() failed (%d)", err);
+            }
+        }
+        ARSTREAM2_StreamReceiver_ProcessNetwork(streamReceiver, selectRet, readSet, writeSet, exceptSet, &shouldStop);
+    }
+
+    if (shouldStop)
+    {
+        ARSAL_Mutex_Lock(&(streamReceiver->threadMutex));
+        streamReceiver->threadStarted = 0;
+        ARSAL_Mutex_Unlock(&(streamReceiver->threadMutex));
+
+        err = ARSTREAM2_RtpReceiver_ProcessEnd(streamReceiver->receiver, 0);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpReceiver_ProcessEnd() failed (%d)", err);
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+
+void ARSTREAM2_StreamReceiver_EngineOutput(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle)
+{
+    ARSTREAM2_StreamReceiver_t *streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    ARSTREAM2_H264_AuFifoItem_t *auItem;
+    int running, threadRunning;
+
+    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
+    running = streamReceiver->appOutput.running;
+    threadRunning = streamReceiver->appOutput.threadRunning;
+    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+
+    /* when the application runs an app output thread the access units
+     * are left in the queue for that thread */
+    if ((running) && (!threadRunning))
+    {
+        while ((auItem = ARSTREAM2_H264_AuFifoDequeueItem(&streamReceiver->appOutput.auFifoQueue)) != NULL)
+        {
+            ARSTREAM2_StreamReceiver_AppOutputAu(streamReceiver, auItem, running);
+        }
+    }
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_GetPipelineStats(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, ARSTREAM2_StreamReceiver_PipelineStats_t *stats)
+{
+    ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+
+    if (!streamReceiverHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (!stats)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid pointer for stats");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    memset(stats, 0, sizeof(ARSTREAM2_StreamReceiver_PipelineStats_t));
+
+    /* the output queues only exist while the corresponding stage is running */
+    if (streamReceiver->pipeline.threadEnabled)
+    {
+        ARSAL_Mutex_Lock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+        stats->filterQueueDepth = streamReceiver->pipeline.auFifoQueue.count;
+        ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.auFifoQueue.mutex));
+    }
+    ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
+    if (streamReceiver->appOutput.running)
+    {
+        ARSAL_Mutex_Lock(&(streamReceiver->appOutput.auFifoQueue.mutex));
+        stats->appOutputQueueDepth = streamReceiver->appOutput.auFifoQueue.count;
+        ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.auFifoQueue.mutex));
+    }
+    ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
+    ARSAL_Mutex_Lock(&(streamReceiver->recorder.threadMutex));
+    if (streamReceiver->recorder.running)
+    {
+        ARSTREAM2_FileWriter_Stats_t writerStats;
+        int i;
+        ARSAL_Mutex_Lock(&(streamReceiver->recorder.auFifoQueue.mutex));
+        stats->recorderQueueDepth = streamReceiver->recorder.auFifoQueue.count;
+        ARSAL_Mutex_Unlock(&(streamReceiver->recorder.auFifoQueue.mutex));
+        if (ARSTREAM2_StreamRecorder_GetStats(streamReceiver->recorder.recorder, &writerStats) == ARSTREAM2_OK)
+        {
+            stats->recorderBytesWritten = writerStats.bytesWritten;
+            stats->recorderPendingWriteCount = writerStats.pendingWriteCount;
+            stats->recorderPendingWritePeakCount = writerStats.pendingWritePeakCount;
+            stats->recorderStallCount = writerStats.stallCount;
+            for (i = 0; (i < ARSTREAM2_STREAM_RECEIVER_RECORDER_LATENCY_BUCKET_COUNT) && (i < ARSTREAM2_FILE_WRITER_LATENCY_BUCKET_COUNT); i++)
+            {
+                stats->recorderWriteLatencyHistogram[i] = writerStats.writeLatencyHistogram[i];
+                stats->recorderSyncLatencyHistogram[i] = writerStats.syncLatencyHistogram[i];
+            }
+        }
+    }
+    else if (streamReceiver->recorder.preEventEnabled)
+    {
+        ARSTREAM2_H264_AuFifoQueue_t *queue = &streamReceiver->recorder.preEventQueue;
+        ARSAL_Mutex_Lock(&(queue->mutex));
+        stats->recorderPreEventAuCount = queue->count;
+        if ((queue->head) && (queue->tail))
+        {
+            stats->recorderPreEventDurationMs = (uint32_t)((queue->tail->au.extRtpTimestamp - queue->head->au.extRtpTimestamp) / 90);
+            stats->recorderPreEventByteCount = streamReceiver->recorder.preEventByteCount;
+        }
+        ARSAL_Mutex_Unlock(&(queue->mutex));
+    }
+    ARSAL_Mutex_Unlock(&(streamReceiver->recorder.threadMutex));
+
+    ARSAL_Mutex_Lock(&(streamReceiver->pipeline.statsMutex));
+    stats->filterQueuePeakDepth = streamReceiver->pipeline.filterQueuePeakDepth;
+    stats->filterQueueDropCount = streamReceiver->pipeline.filterQueueDropCount;
+    stats->appOutputQueuePeakDepth = streamReceiver->pipeline.appOutputQueuePeakDepth;
+    stats->recorderQueuePeakDepth = streamReceiver->pipeline.recorderQueuePeakDepth;
+    streamReceiver->pipeline.filterQueuePeakDepth = stats->filterQueueDepth;
+    streamReceiver->pipeline.appOutputQueuePeakDepth = stats->appOutputQueueDepth;
+    streamReceiver->pipeline.recorderQueuePeakDepth = stats->recorderQueueDepth;
+    ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.statsMutex));
+
+    return ARSTREAM2_OK;
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StartAppOutput(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle,
                                                          ARSTREAM2_StreamReceiver_SpsPpsCallback_t spsPpsCallback, void* spsPpsCallbackUserPtr,
                                                          ARSTREAM2_StreamReceiver_GetAuBufferCallback_t getAuBufferCallback, void* getAuBufferCallbackUserPtr,
@@ -1919,6 +2843,14 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_Stop(ARSTREAM2_StreamReceiver_Handle s
 
     ARSTREAM2_RtpReceiver_Stop(streamReceiver->receiver);
 
+    if (streamReceiver->pipeline.threadEnabled)
+    {
+        ARSAL_Mutex_Lock(&(streamReceiver->pipeline.threadMutex));
+        streamReceiver->pipeline.threadShouldStop = 1;
+        ARSAL_Mutex_Unlock(&(streamReceiver->pipeline.threadMutex));
+        ARSAL_Cond_Signal(&(streamReceiver->pipeline.threadCond));
+    }
+
     ARSAL_Mutex_Lock(&(streamReceiver->appOutput.threadMutex));
     streamReceiver->appOutput.threadShouldStop = 1;
     ARSAL_Mutex_Unlock(&(streamReceiver->appOutput.threadMutex));
@@ -2401,8 +3333,8 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StartResender(ARSTREAM2_StreamReceiver
                                                         const ARSTREAM2_StreamReceiver_ResenderConfig_t *config)
 {
     ARSTREAM2_StreamReceiver_t* streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    ARSTREAM2_RtpResender_FanOut_t *fanOut = NULL;
     ARSTREAM2_RtpResender_t* resender = NULL;
-    int packetFifoQueueCreated = 0;
     eARSTREAM2_ERROR ret = ARSTREAM2_OK;
 
     if (!streamReceiverHandle)
@@ -2421,142 +3353,70 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StartResender(ARSTREAM2_StreamReceiver
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-    resender = (ARSTREAM2_RtpResender_t*)malloc(sizeof(*resender));
-    if (!resender)
-    {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Allocation failed (size %ld)", sizeof(*resender));
-        ret = ARSTREAM2_ERROR_ALLOC;
-    }
-
-    if (ret == ARSTREAM2_OK)
-    {
-        memset(resender, 0, sizeof(*resender));
-        resender->streamSocketSendBufferSize = (config->streamSocketBufferSize > 0) ? config->streamSocketBufferSize : ARSTREAM2_RTP_RESENDER_DEFAULT_STREAM_SOCKET_SEND_BUFFER_SIZE;
-        resender->maxNetworkLatencyUs = (config->maxNetworkLatencyMs > 0) ? config->maxNetworkLatencyMs * 1000 : 0;
-    }
+    ARSTREAM2_RtpResender_Config_t resenderConfig;
+    memset(&resenderConfig, 0, sizeof(resenderConfig));
+    resenderConfig.senderConfig.canonicalName = config->canonicalName;
+    resenderConfig.senderConfig.friendlyName = config->friendlyName;
+    resenderConfig.senderConfig.applicationName = config->applicationName;
+    resenderConfig.senderConfig.clientAddr = config->clientAddr;
+    resenderConfig.senderConfig.mcastAddr = config->mcastAddr;
+    resenderConfig.senderConfig.mcastIfaceAddr = config->mcastIfaceAddr;
+    resenderConfig.senderConfig.serverStreamPort = config->serverStreamPort;
+    resenderConfig.senderConfig.serverControlPort = config->serverControlPort;
+    resenderConfig.senderConfig.clientStreamPort = config->clientStreamPort;
+    resenderConfig.senderConfig.clientControlPort = config->clientControlPort;
+    resenderConfig.senderConfig.classSelector = config->classSelector;
+    resenderConfig.senderConfig.streamSocketSendBufferSize = (config->streamSocketBufferSize > 0) ? config->streamSocketBufferSize : ARSTREAM2_RTP_RESENDER_DEFAULT_STREAM_SOCKET_SEND_BUFFER_SIZE;
+    resenderConfig.senderConfig.maxPacketSize = streamReceiver->maxPacketSize;
+    resenderConfig.senderConfig.debugPath = streamReceiver->debugPath;
+    resenderConfig.senderConfig.dateAndTime = streamReceiver->dateAndTime;
+    resenderConfig.senderConfig.clock = &streamReceiver->clock;
+    resenderConfig.maxNetworkLatencyUs = (config->maxNetworkLatencyMs > 0) ? config->maxNetworkLatencyMs * 1000 : 0;
 
     ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
+    fanOut = streamReceiver->resendFanOut;
+    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
 
-    if (ret == ARSTREAM2_OK)
+    if (!fanOut)
     {
-        int packetFifoRet = ARSTREAM2_RTP_PacketFifoAddQueue(&streamReceiver->packetFifo, &resender->packetFifoQueue);
-        if (packetFifoRet != 0)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RTP_PacketFifoAddQueue() failed (%d)", packetFifoRet);
-            ret = ARSTREAM2_ERROR_ALLOC;
-        }
-        else
-        {
-            packetFifoQueueCreated = 1;
-        }
-    }
+        /* all the resenders share a single fan-out thread */
+        ARSTREAM2_RtpResender_FanOutConfig_t fanOutConfig;
+        memset(&fanOutConfig, 0, sizeof(fanOutConfig));
+        /* a late fan-out can hold at most the whole receiver buffer pool */
+        fanOutConfig.packetRingSize = streamReceiver->packetFifo.bufferPoolSize;
+        fanOutConfig.clock = &streamReceiver->clock;
 
-    if (ret == ARSTREAM2_OK)
-    {
-        ARSTREAM2_RtpSender_Config_t senderConfig;
-        memset(&senderConfig, 0, sizeof(senderConfig));
-        senderConfig.canonicalName = config->canonicalName;
-        senderConfig.friendlyName = config->friendlyName;
-        senderConfig.applicationName = config->applicationName;
-        senderConfig.clientAddr = config->clientAddr;
-        senderConfig.mcastAddr = config->mcastAddr;
-        senderConfig.mcastIfaceAddr = config->mcastIfaceAddr;
-        senderConfig.serverStreamPort = config->serverStreamPort;
-        senderConfig.serverControlPort = config->serverControlPort;
-        senderConfig.clientStreamPort = config->clientStreamPort;
-        senderConfig.clientControlPort = config->clientControlPort;
-        senderConfig.classSelector = config->classSelector;
-        senderConfig.streamSocketSendBufferSize = resender->streamSocketSendBufferSize;
-        senderConfig.maxPacketSize = streamReceiver->maxPacketSize;
-        senderConfig.naluFifo = NULL;
-        senderConfig.packetFifo = &streamReceiver->packetFifo;
-        senderConfig.packetFifoQueue = &resender->packetFifoQueue;
-        senderConfig.debugPath = streamReceiver->debugPath;
-        senderConfig.dateAndTime = streamReceiver->dateAndTime;
-
-        resender->sender = ARSTREAM2_RtpSender_New(&senderConfig, &ret);
+        fanOut = ARSTREAM2_RtpResender_FanOutNew(&fanOutConfig, &ret);
         if (ret != ARSTREAM2_OK)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Error while creating sender : %s", ARSTREAM2_Error_ToString(ret));
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Error while creating resender fan-out : %s", ARSTREAM2_Error_ToString(ret));
         }
     }
 
     if (ret == ARSTREAM2_OK)
     {
-        resender->prev = NULL;
-        resender->next = streamReceiver->resender;
-        if (resender->next)
+        resender = ARSTREAM2_RtpResender_New(fanOut, &resenderConfig, &ret);
+        if (ret != ARSTREAM2_OK)
         {
-            resender->next->prev = resender;
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Error while creating resender : %s", ARSTREAM2_Error_ToString(ret));
         }
-        streamReceiver->resender = resender;
     }
 
-    if (ret == ARSTREAM2_OK)
+    if ((fanOut) && (fanOut != streamReceiver->resendFanOut))
     {
-        ARSTREAM2_RtpResender_t* r;
-        for (r = streamReceiver->resender, streamReceiver->resendCount = 0; r; r = resender->next)
+        if (ret == ARSTREAM2_OK)
         {
-            streamReceiver->resendCount++;
-        }
-        if (streamReceiver->resendCount > 0)
-        {
-            streamReceiver->resendQueue = realloc(streamReceiver->resendQueue, streamReceiver->resendCount * sizeof(ARSTREAM2_RTP_PacketFifoQueue_t*));
-            if (!streamReceiver->resendQueue)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Allocation failed (size %ld)", streamReceiver->resendCount * sizeof(ARSTREAM2_RTP_PacketFifoQueue_t*));
-                ret = ARSTREAM2_ERROR_ALLOC;
-            }
-            else
-            {
-                int k;
-                for (r = streamReceiver->resender, k = 0; r; r = resender->next, k++)
-                    streamReceiver->resendQueue[k] = &r->packetFifoQueue;
-            }
-            streamReceiver->resendTimeout = realloc(streamReceiver->resendTimeout, streamReceiver->resendCount * sizeof(uint32_t));
-            if (!streamReceiver->resendTimeout)
-            {
-                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Allocation failed (size %ld)", streamReceiver->resendCount * sizeof(uint32_t));
-                ret = ARSTREAM2_ERROR_ALLOC;
-            }
-            else
-            {
-                int k;
-                for (r = streamReceiver->resender, k = 0; r; r = resender->next, k++)
-                    streamReceiver->resendTimeout[k] = r->maxNetworkLatencyUs;
-            }
+            ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
+            streamReceiver->resendFanOut = fanOut;
+            ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
         }
         else
         {
-            if (streamReceiver->resendQueue)
-            {
-                free(streamReceiver->resendQueue);
-                streamReceiver->resendQueue = NULL;
-            }
-            if (streamReceiver->resendTimeout)
-            {
-                free(streamReceiver->resendTimeout);
-                streamReceiver->resendTimeout = NULL;
-            }
-        }
-    }
-
-    if (ret == ARSTREAM2_OK)
-    {
-        *streamResenderHandle = resender;
-    }
-    else
-    {
-        if (resender)
-        {
-            if (resender->sender) ARSTREAM2_RtpSender_Delete(&(resender->sender));
-            if (packetFifoQueueCreated) ARSTREAM2_RTP_PacketFifoRemoveQueue(&streamReceiver->packetFifo, &resender->packetFifoQueue);
-            free(resender);
+            ARSTREAM2_RtpResender_FanOutDelete(&fanOut);
         }
-        *streamResenderHandle = NULL;
     }
 
-    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
+    *streamResenderHandle = (ret == ARSTREAM2_OK) ? resender : NULL;
 
     return ret;
 }
@@ -2566,6 +3426,7 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StopResender(ARSTREAM2_StreamReceiver_
                                                        ARSTREAM2_StreamReceiver_ResenderHandle *streamResenderHandle)
 {
     ARSTREAM2_StreamReceiver_t *streamReceiver = (ARSTREAM2_StreamReceiver_t*)streamReceiverHandle;
+    ARSTREAM2_RtpResender_FanOut_t *fanOut = NULL;
     ARSTREAM2_RtpResender_t* resender;
     eARSTREAM2_ERROR ret = ARSTREAM2_OK;
 
@@ -2581,84 +3442,32 @@ eARSTREAM2_ERROR ARSTREAM2_StreamReceiver_StopResender(ARSTREAM2_StreamReceiver_
     }
 
     resender = (ARSTREAM2_RtpResender_t*)*streamResenderHandle;
-
-    ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
-
-    ret = ARSTREAM2_RtpSender_ProcessEnd(resender->sender, 1);
-    if (ret != ARSTREAM2_OK)
+    if (resender->fanOut != streamReceiver->resendFanOut)
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "ARSTREAM2_RtpSender_ProcessEnd() failed (%d)", ret);
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Invalid resender handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
-    ARSTREAM2_RTP_PacketFifoRemoveQueue(&streamReceiver->packetFifo, &resender->packetFifoQueue);
 
-    ret = ARSTREAM2_RtpSender_Delete(&resender->sender);
+    ret = ARSTREAM2_RtpResender_Delete(&resender);
     if (ret != ARSTREAM2_OK)
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Unable to delete sender: %s", ARSTREAM2_Error_ToString(ret));
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Unable to delete resender: %s", ARSTREAM2_Error_ToString(ret));
     }
 
-    if (resender->prev)
-    {
-        resender->prev->next = resender->next;
-    }
-    if (resender->next)
-    {
-        resender->next->prev = resender->prev;
-    }
-    if (resender == streamReceiver->resender)
+    ARSAL_Mutex_Lock(&(streamReceiver->resendMutex));
+    if (ARSTREAM2_RtpResender_FanOutGetDestinationCount(streamReceiver->resendFanOut) == 0)
     {
-        streamReceiver->resender = resender->next;
+        /* no more packets are pushed once the lock is released */
+        fanOut = streamReceiver->resendFanOut;
+        streamReceiver->resendFanOut = NULL;
     }
+    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
 
-    ARSTREAM2_RtpResender_t* r;
-    for (r = streamReceiver->resender, streamReceiver->resendCount = 0; r; r = resender->next)
-    {
-        streamReceiver->resendCount++;
-    }
-    if (streamReceiver->resendCount > 0)
-    {
-        streamReceiver->resendQueue = realloc(streamReceiver->resendQueue, streamReceiver->resendCount * sizeof(ARSTREAM2_RTP_PacketFifoQueue_t*));
-        if (!streamReceiver->resendQueue)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Allocation failed (size %ld)", streamReceiver->resendCount * sizeof(ARSTREAM2_RTP_PacketFifoQueue_t*));
-            ret = ARSTREAM2_ERROR_ALLOC;
-        }
-        else
-        {
-            int k;
-            for (r = streamReceiver->resender, k = 0; r; r = resender->next, k++)
-                streamReceiver->resendQueue[k] = &r->packetFifoQueue;
-        }
-        streamReceiver->resendTimeout = realloc(streamReceiver->resendTimeout, streamReceiver->resendCount * sizeof(uint32_t));
-        if (!streamReceiver->resendTimeout)
-        {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_TAG, "Allocation failed (size %ld)", streamReceiver->resendCount * sizeof(uint32_t));
-            ret = ARSTREAM2_ERROR_ALLOC;
-        }
-        else
-        {
-            int k;
-            for (r = streamReceiver->resender, k = 0; r; r = resender->next, k++)
-                streamReceiver->resendTimeout[k] = r->maxNetworkLatencyUs;
-        }
-    }
-    else
+    if (fanOut)
     {
-        if (streamReceiver->resendQueue)
-        {
-            free(streamReceiver->resendQueue);
-            streamReceiver->resendQueue = NULL;
-        }
-        if (streamReceiver->resendTimeout)
-        {
-            free(streamReceiver->resendTimeout);
-            streamReceiver->resendTimeout = NULL;
-        }
+        ARSTREAM2_RtpResender_FanOutDelete(&fanOut);
     }
 
-    ARSAL_Mutex_Unlock(&(streamReceiver->resendMutex));
-
-    free(resender);
     *streamResenderHandle = NULL;
 
     return ret;
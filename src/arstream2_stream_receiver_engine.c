@@ -0,0 +1,945 @@
+/**
+ * @file arstream2_stream_receiver_engine.c
+ * @brief Parrot Streaming Library - Stream Receiver Engine
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#define __USE_GNU
+#include <sys/socket.h>
+#undef __USE_GNU
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Mutex.h>
+#include <libARSAL/ARSAL_Thread.h>
+
+#include <libARStream2/arstream2_stream_receiver_engine.h>
+#include "arstream2_stream_receiver_internal.h"
+
+
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG "ARSTREAM2_StreamReceiverEngine"
+
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_MAX_WORKER_COUNT (64)
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_IDLE_TIMEOUT_US (100000)
+
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE (32)
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BUFFER_SIZE (0x10000)
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_SOCKET_BUFFER_SIZE (4 * 1024 * 1024)
+#define ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_DROP_LOG_INTERVAL (1000)
+
+
+typedef struct ARSTREAM2_StreamReceiverEngine_Receiver_s
+{
+    ARSTREAM2_StreamReceiver_Handle handle;
+    ARSTREAM2_StreamReceiverEngine_IngestKey_t ingestKey;
+
+} ARSTREAM2_StreamReceiverEngine_Receiver_t;
+
+
+typedef struct ARSTREAM2_StreamReceiverEngine_Worker_s
+{
+    struct ARSTREAM2_StreamReceiverEngine_s *engine;
+    int index;
+    ARSAL_Thread_t thread;
+
+    /* Held while the worker accesses the receivers */
+    ARSAL_Mutex_t mutex;
+    ARSTREAM2_StreamReceiverEngine_Receiver_t *receiver;
+    int receiverCount;
+    int receiverMaxCount;
+    int shouldStop;
+    int signalPipe[2];
+
+    /* Sharded ingest (only accessed by the worker thread) */
+    int ingestSocket;
+    struct mmsghdr *ingestMsgVec;
+    struct mmsghdr **ingestMsgPtr;
+    struct iovec *ingestIov;
+    struct sockaddr_in *ingestAddr;
+    uint8_t *ingestBuffer;
+    int *ingestOwner;
+    unsigned int ingestDropCount;
+
+    /* Receivers whose application output is in progress outside of the mutex */
+    ARSTREAM2_StreamReceiver_Handle *outputReceiver;
+    int outputReceiverCount;
+    int outputInProgress;
+    ARSAL_Cond_t outputCond;
+
+} ARSTREAM2_StreamReceiverEngine_Worker_t;
+
+
+typedef struct ARSTREAM2_StreamReceiverEngine_s
+{
+    ARSTREAM2_StreamReceiverEngine_Worker_t *worker;
+    int workerCount;
+
+    /* Sharded ingest */
+    int ingestPort;
+    eARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING ingestSteering;
+    int ingestSocketCount;
+
+    /* Protects the receiver to worker assignment */
+    ARSAL_Mutex_t mutex;
+
+} ARSTREAM2_StreamReceiverEngine_t;
+
+
+#ifndef HAS_MMSG
+static int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen,
+                    unsigned int flags, struct timespec *timeout)
+{
+    unsigned int i, count;
+    ssize_t ret;
+
+    if (!msgvec)
+    {
+        return -1;
+    }
+
+    for (i = 0, count = 0; i < vlen; i++)
+    {
+        while (((ret = recvmsg(sockfd, &msgvec[i].msg_hdr, flags)) == -1) && (errno == EINTR));
+        if (ret < 0)
+        {
+            if (count == 0)
+            {
+                return ret;
+            }
+            else
+            {
+                break;
+            }
+        }
+        else
+        {
+            count++;
+            msgvec[i].msg_len = (unsigned int)ret;
+        }
+    }
+
+    return count;
+}
+#endif
+
+
+/* Must match the kernel steering programs below */
+static inline uint32_t ARSTREAM2_StreamReceiverEngine_IngestHash(ARSTREAM2_StreamReceiverEngine_t *engine, const ARSTREAM2_StreamReceiverEngine_IngestKey_t *key)
+{
+    if (engine->ingestSteering == ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SSRC)
+    {
+        return key->ssrc;
+    }
+    else
+    {
+        return key->sourceAddr ^ (uint32_t)key->sourcePort;
+    }
+}
+
+
+static int ARSTREAM2_StreamReceiverEngine_IngestKeyMatch(ARSTREAM2_StreamReceiverEngine_t *engine, const ARSTREAM2_StreamReceiverEngine_IngestKey_t *key1,
+                                                         const ARSTREAM2_StreamReceiverEngine_IngestKey_t *key2)
+{
+    if (engine->ingestSteering == ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SSRC)
+    {
+        return (key1->ssrc == key2->ssrc) ? 1 : 0;
+    }
+    else
+    {
+        return ((key1->sourceAddr == key2->sourceAddr) && (key1->sourcePort == key2->sourcePort)) ? 1 : 0;
+    }
+}
+
+
+static int ARSTREAM2_StreamReceiverEngine_AttachSteeringProgram(ARSTREAM2_StreamReceiverEngine_t *engine, int socket)
+{
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(SKF_NET_OFF)
+    /* The program returns the index of the socket in the reuseport group,
+     * which is the order of the bind() calls, i.e. the worker index.
+     * For UDP the packet data starts at the UDP payload. */
+    struct sock_filter bySsrc[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, 8 },                              /* A = RTP SSRC */
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)engine->ingestSocketCount },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_filter bySource[] = {
+        { BPF_LDX | BPF_B | BPF_MSH, 0, 0, (uint32_t)SKF_NET_OFF },          /* X = IP header length */
+        { BPF_LD | BPF_H | BPF_IND, 0, 0, (uint32_t)SKF_NET_OFF },           /* A = UDP source port */
+        { BPF_ST, 0, 0, 0 },                                                /* M[0] = A */
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)SKF_NET_OFF + 12 },      /* A = IP source address */
+        { BPF_LDX | BPF_W | BPF_MEM, 0, 0, 0 },                             /* X = M[0] */
+        { BPF_ALU | BPF_XOR | BPF_X, 0, 0, 0 },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)engine->ingestSocketCount },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog;
+    int err;
+
+    if (engine->ingestSteering == ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SSRC)
+    {
+        prog.len = sizeof(bySsrc) / sizeof(struct sock_filter);
+        prog.filter = bySsrc;
+    }
+    else
+    {
+        prog.len = sizeof(bySource) / sizeof(struct sock_filter);
+        prog.filter = bySource;
+    }
+
+    err = setsockopt(socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+    if (err != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to attach the steering program: error=%d (%s)", errno, strerror(errno));
+        return -1;
+    }
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+
+static int ARSTREAM2_StreamReceiverEngine_IngestSocketSetup(ARSTREAM2_StreamReceiverEngine_t *engine, ARSTREAM2_StreamReceiverEngine_Worker_t *worker)
+{
+    int ret = 0, err, i;
+    struct sockaddr_in recvSin;
+
+    worker->ingestMsgVec = calloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, sizeof(struct mmsghdr));
+    worker->ingestMsgPtr = calloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, sizeof(struct mmsghdr*));
+    worker->ingestIov = calloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, sizeof(struct iovec));
+    worker->ingestAddr = calloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, sizeof(struct sockaddr_in));
+    worker->ingestOwner = calloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, sizeof(int));
+    worker->ingestBuffer = malloc(ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE * ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BUFFER_SIZE);
+    if ((!worker->ingestMsgVec) || (!worker->ingestMsgPtr) || (!worker->ingestIov) || (!worker->ingestAddr) || (!worker->ingestOwner) || (!worker->ingestBuffer))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Ingest buffers allocation failed");
+        return -1;
+    }
+
+    /* create socket */
+    worker->ingestSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (worker->ingestSocket < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to create ingest socket");
+        worker->ingestSocket = -1;
+        return -1;
+    }
+
+    /* set to non-blocking */
+    int flags = fcntl(worker->ingestSocket, F_GETFL, 0);
+    err = fcntl(worker->ingestSocket, F_SETFL, flags | O_NONBLOCK);
+    if (err < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to set to non-blocking: error=%d (%s)", errno, strerror(errno));
+    }
+
+    int size = ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_SOCKET_BUFFER_SIZE;
+    err = setsockopt(worker->ingestSocket, SOL_SOCKET, SO_RCVBUF, (void*)&size, sizeof(size));
+    if (err != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to set receive socket buffer size to %d bytes: error=%d (%s)", size, errno, strerror(errno));
+    }
+
+#ifdef SO_REUSEPORT
+    if (engine->ingestSocketCount > 1)
+    {
+        /* all the workers bind the same port */
+        int yes = 1;
+        err = setsockopt(worker->ingestSocket, SOL_SOCKET, SO_REUSEPORT, (void*)&yes, sizeof(yes));
+        if (err != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to set socket option SO_REUSEPORT: error=%d (%s)", errno, strerror(errno));
+            ret = -1;
+        }
+    }
+#endif
+
+    if (ret == 0)
+    {
+        /* bind the socket */
+        memset(&recvSin, 0, sizeof(struct sockaddr_in));
+        recvSin.sin_family = AF_INET;
+        recvSin.sin_port = htons(engine->ingestPort);
+        recvSin.sin_addr.s_addr = htonl(INADDR_ANY);
+        err = bind(worker->ingestSocket, (struct sockaddr*)&recvSin, sizeof(recvSin));
+        if (err != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Error on ingest socket bind port=%d: error=%d (%s)", engine->ingestPort, errno, strerror(errno));
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+    {
+        for (i = 0; i < ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE; i++)
+        {
+            worker->ingestIov[i].iov_base = worker->ingestBuffer + i * ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BUFFER_SIZE;
+            worker->ingestIov[i].iov_len = ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BUFFER_SIZE;
+        }
+    }
+    else
+    {
+        while (((err = close(worker->ingestSocket)) == -1) && (errno == EINTR));
+        worker->ingestSocket = -1;
+    }
+
+    return ret;
+}
+
+
+static void ARSTREAM2_StreamReceiverEngine_IngestSocketTeardown(ARSTREAM2_StreamReceiverEngine_Worker_t *worker)
+{
+    int err;
+
+    if (worker->ingestSocket != -1)
+    {
+        while (((err = close(worker->ingestSocket)) == -1) && (errno == EINTR));
+        worker->ingestSocket = -1;
+    }
+    free(worker->ingestMsgVec);
+    worker->ingestMsgVec = NULL;
+    free(worker->ingestMsgPtr);
+    worker->ingestMsgPtr = NULL;
+    free(worker->ingestIov);
+    worker->ingestIov = NULL;
+    free(worker->ingestAddr);
+    worker->ingestAddr = NULL;
+    free(worker->ingestOwner);
+    worker->ingestOwner = NULL;
+    free(worker->ingestBuffer);
+    worker->ingestBuffer = NULL;
+}
+
+
+/* Receives a batch of packets on the ingest socket and finds the owning receivers; called with the worker mutex held */
+static int ARSTREAM2_StreamReceiverEngine_IngestReceive(ARSTREAM2_StreamReceiverEngine_Worker_t *worker)
+{
+    ARSTREAM2_StreamReceiverEngine_IngestKey_t key;
+    int i, j, ret;
+
+    for (i = 0; i < ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE; i++)
+    {
+        worker->ingestMsgVec[i].msg_hdr.msg_name = &worker->ingestAddr[i];
+        worker->ingestMsgVec[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        worker->ingestMsgVec[i].msg_hdr.msg_iov = &worker->ingestIov[i];
+        worker->ingestMsgVec[i].msg_hdr.msg_iovlen = 1;
+        worker->ingestMsgVec[i].msg_hdr.msg_control = NULL;
+        worker->ingestMsgVec[i].msg_hdr.msg_controllen = 0;
+        worker->ingestMsgVec[i].msg_hdr.msg_flags = 0;
+        worker->ingestMsgVec[i].msg_len = 0;
+    }
+
+    while (((ret = recvmmsg(worker->ingestSocket, worker->ingestMsgVec, ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_BATCH_SIZE, 0, NULL)) == -1) && (errno == EINTR));
+    if (ret < 0)
+    {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Ingest socket - recvmmsg error (%d): %s", errno, strerror(errno));
+        }
+        return 0;
+    }
+
+    for (i = 0; i < ret; i++)
+    {
+        worker->ingestOwner[i] = -1;
+        if (worker->ingestMsgVec[i].msg_len < 12)
+        {
+            continue;
+        }
+        key.sourceAddr = ntohl(worker->ingestAddr[i].sin_addr.s_addr);
+        key.sourcePort = ntohs(worker->ingestAddr[i].sin_port);
+        key.ssrc = ntohl(*((uint32_t*)((uint8_t*)worker->ingestIov[i].iov_base + 8)));
+        for (j = 0; j < worker->receiverCount; j++)
+        {
+            if (ARSTREAM2_StreamReceiverEngine_IngestKeyMatch(worker->engine, &key, &worker->receiver[j].ingestKey))
+            {
+                worker->ingestOwner[i] = j;
+                break;
+            }
+        }
+        if (worker->ingestOwner[i] < 0)
+        {
+            if ((worker->ingestDropCount % ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_DROP_LOG_INTERVAL) == 0)
+            {
+                char addrStr[INET_ADDRSTRLEN] = "";
+                inet_ntop(AF_INET, &worker->ingestAddr[i].sin_addr, addrStr, sizeof(addrStr));
+                ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Worker #%d: dropping packet from unknown stream %s:%d SSRC 0x%08X (total %d)",
+                            worker->index, addrStr, key.sourcePort, key.ssrc, worker->ingestDropCount + 1);
+            }
+            worker->ingestDropCount++;
+        }
+    }
+
+    return ret;
+}
+
+
+static void ARSTREAM2_StreamReceiverEngine_WakeUpWorker(ARSTREAM2_StreamReceiverEngine_Worker_t *worker)
+{
+    char *buff = "x";
+    int writeRet;
+
+    while (((writeRet = write(worker->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
+    if (writeRet < 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to write to pipe (%d): %s", errno, strerror(errno));
+    }
+}
+
+
+static void* ARSTREAM2_StreamReceiverEngine_RunWorkerThread(void *workerPtr)
+{
+    ARSTREAM2_StreamReceiverEngine_Worker_t *worker = (ARSTREAM2_StreamReceiverEngine_Worker_t*)workerPtr;
+    fd_set readSet, writeSet, exceptSet;
+    int shouldStop, selectRet, maxFd, i, j, ingestCount, ingestMsgCount;
+    uint32_t nextTimeout;
+    struct timeval tv;
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Worker thread #%d running", worker->index);
+
+    ARSAL_Mutex_Lock(&(worker->mutex));
+    shouldStop = worker->shouldStop;
+    ARSAL_Mutex_Unlock(&(worker->mutex));
+
+    while (shouldStop == 0)
+    {
+        /* Gather the file descriptors and timeouts of all the receivers run by this worker */
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        FD_ZERO(&exceptSet);
+        FD_SET(worker->signalPipe[0], &readSet);
+        FD_SET(worker->signalPipe[0], &exceptSet);
+        maxFd = worker->signalPipe[0];
+        if (worker->ingestSocket != -1)
+        {
+            FD_SET(worker->ingestSocket, &readSet);
+            if (worker->ingestSocket > maxFd) maxFd = worker->ingestSocket;
+        }
+        nextTimeout = ARSTREAM2_STREAM_RECEIVER_ENGINE_IDLE_TIMEOUT_US;
+
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        for (i = 0; i < worker->receiverCount; i++)
+        {
+            ARSTREAM2_StreamReceiver_EngineGetSelectParams(worker->receiver[i].handle, &readSet, &writeSet, &exceptSet, &maxFd, &nextTimeout);
+        }
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+
+        /* The receivers may change during the select: the sets only hold non-blocking
+         * sockets so a stale descriptor at worst leads to a spurious EAGAIN */
+        tv.tv_sec = nextTimeout / 1000000;
+        tv.tv_usec = nextTimeout % 1000000;
+        while (((selectRet = select(maxFd + 1, &readSet, &writeSet, &exceptSet, &tv)) == -1) && (errno == EINTR));
+        if (selectRet < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Select error (%d): %s", errno, strerror(errno));
+        }
+
+        if ((selectRet > 0) && (FD_ISSET(worker->signalPipe[0], &readSet)))
+        {
+            /* Dump bytes (so it won't be ready next time) */
+            char dump[10];
+            int readRet;
+            while (((readRet = read(worker->signalPipe[0], &dump, 10)) == -1) && (errno == EINTR));
+            if (readRet < 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Failed to read from pipe (%d): %s", errno, strerror(errno));
+            }
+        }
+
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        ingestCount = 0;
+        if ((selectRet > 0) && (worker->ingestSocket != -1) && (FD_ISSET(worker->ingestSocket, &readSet)))
+        {
+            ingestCount = ARSTREAM2_StreamReceiverEngine_IngestReceive(worker);
+        }
+        for (i = 0; i < worker->receiverCount; i++)
+        {
+            /* Hand each receiver its own packets, in reception order */
+            for (j = 0, ingestMsgCount = 0; j < ingestCount; j++)
+            {
+                if (worker->ingestOwner[j] == i)
+                {
+                    worker->ingestMsgPtr[ingestMsgCount++] = &worker->ingestMsgVec[j];
+                }
+            }
+            ARSTREAM2_StreamReceiver_EngineProcess(worker->receiver[i].handle, selectRet, &readSet, &writeSet, &exceptSet,
+                                                   worker->ingestMsgPtr, (unsigned int)ingestMsgCount);
+        }
+        for (i = 0; i < worker->receiverCount; i++)
+        {
+            worker->outputReceiver[i] = worker->receiver[i].handle;
+        }
+        worker->outputReceiverCount = worker->receiverCount;
+        worker->outputInProgress = 1;
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+
+        /* The application callbacks are called without the worker mutex so that
+         * adding receivers is not blocked by a slow application; removing a
+         * receiver of the snapshot waits for the end of the output */
+        for (i = 0; i < worker->outputReceiverCount; i++)
+        {
+            ARSTREAM2_StreamReceiver_EngineOutput(worker->outputReceiver[i]);
+        }
+
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        worker->outputInProgress = 0;
+        ARSAL_Cond_Broadcast(&(worker->outputCond));
+        shouldStop = worker->shouldStop;
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+    }
+
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Worker thread #%d has ended", worker->index);
+
+    return (void*)0;
+}
+
+
+static void ARSTREAM2_StreamReceiverEngine_WorkerFree(ARSTREAM2_StreamReceiverEngine_Worker_t *worker, int mutexInit)
+{
+    int err;
+
+    if (worker->thread)
+    {
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        worker->shouldStop = 1;
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+        ARSTREAM2_StreamReceiverEngine_WakeUpWorker(worker);
+
+        err = ARSAL_Thread_Join(worker->thread, NULL);
+        if (err != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "ARSAL_Thread_Join() failed (%d)", err);
+        }
+        err = ARSAL_Thread_Destroy(&(worker->thread));
+        if (err != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "ARSAL_Thread_Destroy() failed (%d)", err);
+        }
+        worker->thread = NULL;
+    }
+    ARSTREAM2_StreamReceiverEngine_IngestSocketTeardown(worker);
+    if (worker->signalPipe[0] != -1)
+    {
+        while (((err = close(worker->signalPipe[0])) == -1) && (errno == EINTR));
+        worker->signalPipe[0] = -1;
+    }
+    if (worker->signalPipe[1] != -1)
+    {
+        while (((err = close(worker->signalPipe[1])) == -1) && (errno == EINTR));
+        worker->signalPipe[1] = -1;
+    }
+    if (mutexInit)
+    {
+        ARSAL_Cond_Destroy(&(worker->outputCond));
+        ARSAL_Mutex_Destroy(&(worker->mutex));
+    }
+    free(worker->receiver);
+    worker->receiver = NULL;
+    free(worker->outputReceiver);
+    worker->outputReceiver = NULL;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiverEngine_Init(ARSTREAM2_StreamReceiverEngine_Handle *engineHandle,
+                                                     const ARSTREAM2_StreamReceiverEngine_Config_t *config)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_StreamReceiverEngine_t *engine = NULL;
+    int engineMutexInit = 0, workerMutexInitCount = 0, i;
+
+    if (!engineHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid pointer for handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (!config)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid pointer for config");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if ((config->ingestPort < 0) || (config->ingestPort > 0xFFFF)
+            || (config->ingestSteering < 0) || (config->ingestSteering >= ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_MAX))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid ingest config");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    engine = (ARSTREAM2_StreamReceiverEngine_t*)malloc(sizeof(*engine));
+    if (!engine)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Allocation failed (size %zu)", sizeof(*engine));
+        ret = ARSTREAM2_ERROR_ALLOC;
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        memset(engine, 0, sizeof(*engine));
+        engine->workerCount = config->workerCount;
+        if (engine->workerCount <= 0)
+        {
+            long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+            engine->workerCount = (cpuCount > 0) ? (int)cpuCount : 1;
+        }
+        if (engine->workerCount > ARSTREAM2_STREAM_RECEIVER_ENGINE_MAX_WORKER_COUNT)
+        {
+            engine->workerCount = ARSTREAM2_STREAM_RECEIVER_ENGINE_MAX_WORKER_COUNT;
+        }
+        engine->ingestPort = config->ingestPort;
+        engine->ingestSteering = config->ingestSteering;
+#ifdef SO_REUSEPORT
+        engine->ingestSocketCount = (engine->ingestPort > 0) ? engine->workerCount : 0;
+#else
+        engine->ingestSocketCount = (engine->ingestPort > 0) ? 1 : 0;
+#endif
+
+        engine->worker = (ARSTREAM2_StreamReceiverEngine_Worker_t*)calloc(engine->workerCount, sizeof(ARSTREAM2_StreamReceiverEngine_Worker_t));
+        if (!engine->worker)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Allocation failed (size %zu)",
+                        engine->workerCount * sizeof(ARSTREAM2_StreamReceiverEngine_Worker_t));
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            for (i = 0; i < engine->workerCount; i++)
+            {
+                engine->worker[i].engine = engine;
+                engine->worker[i].index = i;
+                engine->worker[i].signalPipe[0] = -1;
+                engine->worker[i].signalPipe[1] = -1;
+                engine->worker[i].ingestSocket = -1;
+            }
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        int mutexInitRet = ARSAL_Mutex_Init(&(engine->mutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            engineMutexInit = 1;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        /* The sockets are bound in worker order so that the index in the reuseport group is the worker index */
+        for (i = 0; (i < engine->ingestSocketCount) && (ret == ARSTREAM2_OK); i++)
+        {
+            if (ARSTREAM2_StreamReceiverEngine_IngestSocketSetup(engine, &engine->worker[i]) != 0)
+            {
+                ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+            }
+        }
+        if ((ret == ARSTREAM2_OK) && (engine->ingestSocketCount > 1)
+                && (ARSTREAM2_StreamReceiverEngine_AttachSteeringProgram(engine, engine->worker[0].ingestSocket) != 0))
+        {
+            /* Without steering the packets of a stream could reach any socket:
+             * fall back to a single ingest socket */
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Kernel steering is not available, using a single ingest socket");
+            for (i = 1; i < engine->ingestSocketCount; i++)
+            {
+                ARSTREAM2_StreamReceiverEngine_IngestSocketTeardown(&engine->worker[i]);
+            }
+            engine->ingestSocketCount = 1;
+        }
+    }
+
+    for (i = 0; (i < engine->workerCount) && (ret == ARSTREAM2_OK); i++)
+    {
+        ARSTREAM2_StreamReceiverEngine_Worker_t *worker = &engine->worker[i];
+
+        int mutexInitRet = ARSAL_Mutex_Init(&(worker->mutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+            break;
+        }
+        int condInitRet = ARSAL_Cond_Init(&(worker->outputCond));
+        if (condInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Cond creation failed (%d)", condInitRet);
+            ARSAL_Mutex_Destroy(&(worker->mutex));
+            ret = ARSTREAM2_ERROR_ALLOC;
+            break;
+        }
+        workerMutexInitCount++;
+
+        if (pipe(worker->signalPipe) != 0)
+        {
+            worker->signalPipe[0] = -1;
+            worker->signalPipe[1] = -1;
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+            break;
+        }
+
+        int thErr = ARSAL_Thread_Create(&worker->thread, ARSTREAM2_StreamReceiverEngine_RunWorkerThread, (void*)worker);
+        if (thErr != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Worker thread creation failed (%d)", thErr);
+            worker->thread = NULL;
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+            break;
+        }
+    }
+
+    if (ret == ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Engine started with %d workers and %d ingest sockets", engine->workerCount, engine->ingestSocketCount);
+        *engineHandle = engine;
+    }
+    else
+    {
+        if (engine)
+        {
+            if (engine->worker)
+            {
+                for (i = 0; i < engine->workerCount; i++)
+                {
+                    ARSTREAM2_StreamReceiverEngine_WorkerFree(&engine->worker[i], (i < workerMutexInitCount) ? 1 : 0);
+                }
+            }
+            if (engineMutexInit) ARSAL_Mutex_Destroy(&(engine->mutex));
+            free(engine->worker);
+            free(engine);
+        }
+        *engineHandle = NULL;
+    }
+
+    return ret;
+}
+
+
+eARSTREAM2_ERROR ARSTREAM2_StreamReceiverEngine_Free(ARSTREAM2_StreamReceiverEngine_Handle *engineHandle)
+{
+    ARSTREAM2_StreamReceiverEngine_t *engine;
+    int i, receiverCount = 0;
+
+    if ((!engineHandle) || (!*engineHandle))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid pointer for handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    engine = (ARSTREAM2_StreamReceiverEngine_t*)*engineHandle;
+
+    ARSAL_Mutex_Lock(&(engine->mutex));
+    for (i = 0; i < engine->workerCount; i++)
+    {
+        receiverCount += engine->worker[i].receiverCount;
+    }
+    ARSAL_Mutex_Unlock(&(engine->mutex));
+    if (receiverCount > 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Free the %d remaining receivers before calling this function", receiverCount);
+        return ARSTREAM2_ERROR_BUSY;
+    }
+
+    for (i = 0; i < engine->workerCount; i++)
+    {
+        ARSTREAM2_StreamReceiverEngine_WorkerFree(&engine->worker[i], 1);
+    }
+    ARSAL_Mutex_Destroy(&(engine->mutex));
+    free(engine->worker);
+    free(engine);
+    *engineHandle = NULL;
+
+    return ARSTREAM2_OK;
+}
+
+
+int ARSTREAM2_StreamReceiverEngine_IsIngestEnabled(ARSTREAM2_StreamReceiverEngine_Handle engineHandle)
+{
+    ARSTREAM2_StreamReceiverEngine_t *engine = (ARSTREAM2_StreamReceiverEngine_t*)engineHandle;
+
+    return ((engine) && (engine->ingestSocketCount > 0)) ? 1 : 0;
+}
+
+
+int ARSTREAM2_StreamReceiverEngine_AddReceiver(ARSTREAM2_StreamReceiverEngine_Handle engineHandle, ARSTREAM2_StreamReceiver_Handle streamReceiverHandle,
+                                               const ARSTREAM2_StreamReceiverEngine_IngestKey_t *ingestKey)
+{
+    ARSTREAM2_StreamReceiverEngine_t *engine = (ARSTREAM2_StreamReceiverEngine_t*)engineHandle;
+    ARSTREAM2_StreamReceiverEngine_Worker_t *worker;
+    int i, j, ret = 0;
+
+    if ((!engineHandle) || (!streamReceiverHandle) || ((engine->ingestSocketCount > 0) && (!ingestKey)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    ARSAL_Mutex_Lock(&(engine->mutex));
+
+    if (engine->ingestSocketCount > 0)
+    {
+        /* Two receivers cannot share a stream */
+        for (i = 0; (i < engine->workerCount) && (ret == 0); i++)
+        {
+            for (j = 0; j < engine->worker[i].receiverCount; j++)
+            {
+                if (ARSTREAM2_StreamReceiverEngine_IngestKeyMatch(engine, ingestKey, &engine->worker[i].receiver[j].ingestKey))
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "A receiver is already registered for this stream");
+                    ret = -2;
+                    break;
+                }
+            }
+        }
+
+        /* The receiver is run by the worker whose socket gets its packets */
+        worker = &engine->worker[ARSTREAM2_StreamReceiverEngine_IngestHash(engine, ingestKey) % (uint32_t)engine->ingestSocketCount];
+    }
+    else
+    {
+        /* The receiver sticks to the least loaded worker for its whole life */
+        worker = &engine->worker[0];
+        for (i = 1; i < engine->workerCount; i++)
+        {
+            if (engine->worker[i].receiverCount < worker->receiverCount)
+            {
+                worker = &engine->worker[i];
+            }
+        }
+    }
+
+    if (ret == 0)
+    {
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        if (worker->receiverCount >= worker->receiverMaxCount)
+        {
+            int newMaxCount = (worker->receiverMaxCount) ? worker->receiverMaxCount * 2 : 4;
+            ARSTREAM2_StreamReceiverEngine_Receiver_t *newReceiver;
+            ARSTREAM2_StreamReceiver_Handle *newOutputReceiver;
+
+            /* The output snapshot is read without the mutex */
+            while (worker->outputInProgress)
+            {
+                ARSAL_Cond_Wait(&(worker->outputCond), &(worker->mutex));
+            }
+
+            newReceiver = realloc(worker->receiver, newMaxCount * sizeof(ARSTREAM2_StreamReceiverEngine_Receiver_t));
+            if (newReceiver)
+            {
+                worker->receiver = newReceiver;
+            }
+            newOutputReceiver = realloc(worker->outputReceiver, newMaxCount * sizeof(ARSTREAM2_StreamReceiver_Handle));
+            if (newOutputReceiver)
+            {
+                worker->outputReceiver = newOutputReceiver;
+            }
+            if ((!newReceiver) || (!newOutputReceiver))
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Allocation failed (size %zu)", newMaxCount * sizeof(ARSTREAM2_StreamReceiverEngine_Receiver_t));
+                ret = -1;
+            }
+            else
+            {
+                worker->receiverMaxCount = newMaxCount;
+            }
+        }
+        if (ret == 0)
+        {
+            worker->receiver[worker->receiverCount].handle = streamReceiverHandle;
+            if (ingestKey)
+            {
+                worker->receiver[worker->receiverCount].ingestKey = *ingestKey;
+            }
+            else
+            {
+                memset(&worker->receiver[worker->receiverCount].ingestKey, 0, sizeof(ARSTREAM2_StreamReceiverEngine_IngestKey_t));
+            }
+            worker->receiverCount++;
+        }
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+    }
+
+    ARSAL_Mutex_Unlock(&(engine->mutex));
+
+    if (ret == 0)
+    {
+        /* Have the new sockets polled right away */
+        ARSTREAM2_StreamReceiverEngine_WakeUpWorker(worker);
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Receiver added to worker #%d", worker->index);
+    }
+
+    return ret;
+}
+
+
+int ARSTREAM2_StreamReceiverEngine_RemoveReceiver(ARSTREAM2_StreamReceiverEngine_Handle engineHandle, ARSTREAM2_StreamReceiver_Handle streamReceiverHandle)
+{
+    ARSTREAM2_StreamReceiverEngine_t *engine = (ARSTREAM2_StreamReceiverEngine_t*)engineHandle;
+    int i, j, ret = -2;
+
+    if ((!engineHandle) || (!streamReceiverHandle))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Invalid pointer");
+        return -1;
+    }
+
+    ARSAL_Mutex_Lock(&(engine->mutex));
+
+    for (i = 0; (i < engine->workerCount) && (ret != 0); i++)
+    {
+        ARSTREAM2_StreamReceiverEngine_Worker_t *worker = &engine->worker[i];
+
+        /* Taking the worker mutex waits for the end of the current processing */
+        ARSAL_Mutex_Lock(&(worker->mutex));
+        for (j = 0; j < worker->receiverCount; j++)
+        {
+            if (worker->receiver[j].handle == streamReceiverHandle)
+            {
+                worker->receiver[j] = worker->receiver[worker->receiverCount - 1];
+                worker->receiverCount--;
+                ret = 0;
+                break;
+            }
+        }
+        if (ret == 0)
+        {
+            /* Wait for the end of the application output if the receiver is part of it */
+            for (j = 0; (worker->outputInProgress) && (j < worker->outputReceiverCount); j++)
+            {
+                if (worker->outputReceiver[j] == streamReceiverHandle)
+                {
+                    while (worker->outputInProgress)
+                    {
+                        ARSAL_Cond_Wait(&(worker->outputCond), &(worker->mutex));
+                    }
+                }
+            }
+        }
+        ARSAL_Mutex_Unlock(&(worker->mutex));
+    }
+
+    ARSAL_Mutex_Unlock(&(engine->mutex));
+
+    if (ret != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECEIVER_ENGINE_TAG, "Receiver not found");
+    }
+
+    return ret;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file arstream2_stream_receiver_internal.h
+ * @brief Parrot Streaming Library - Stream Receiver internal API
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#ifndef _ARSTREAM2_STREAM_RECEIVER_INTERNAL_H_
+#define _ARSTREAM2_STREAM_RECEIVER_INTERNAL_H_
+
+#include <sys/select.h>
+
+#include <libARStream2/arstream2_stream_receiver.h>
+#include <libARStream2/arstream2_stream_receiver_engine.h>
+
+
+struct mmsghdr;
+
+
+/* Identifies the stream of a receiver on the engine sharded ingest sockets (host byte order) */
+typedef struct ARSTREAM2_StreamReceiverEngine_IngestKey_s
+{
+    uint32_t sourceAddr;
+    uint16_t sourcePort;
+    uint32_t ssrc;
+
+} ARSTREAM2_StreamReceiverEngine_IngestKey_t;
+
+
+/* Stream receiver side, called from the engine workers with the worker mutex held
+ * and from the network thread of a transport instance for the instances sharing it */
+
+/* Adds the instance file descriptors to the sets; returns -1 if the instance no longer needs to be polled */
+int ARSTREAM2_StreamReceiver_EngineGetSelectParams(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
+                                                   int *maxFd, uint32_t *nextTimeout);
+
+/* Processes the network and the filter; returns 1 once the instance has been stopped;
+ * ingestMsg holds the packets received for the instance on the ingest socket, only valid during the call */
+int ARSTREAM2_StreamReceiver_EngineProcess(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle, int selectRet, fd_set *readSet, fd_set *writeSet, fd_set *exceptSet,
+                                           struct mmsghdr **ingestMsg, unsigned int ingestMsgCount);
+
+
+/* Stream receiver side, called from the engine workers without the worker mutex held
+ * and from the network thread of a transport instance */
+
+/* Calls the application output callbacks for the pending access units,
+ * unless the application runs its own app output thread for the instance */
+void ARSTREAM2_StreamReceiver_EngineOutput(ARSTREAM2_StreamReceiver_Handle streamReceiverHandle);
+
+
+/* Engine side, called from ARSTREAM2_StreamReceiver_Init() and ARSTREAM2_StreamReceiver_Free() */
+
+/* Returns 1 if the engine receives the RTP packets of its receivers on sharded ingest sockets */
+int ARSTREAM2_StreamReceiverEngine_IsIngestEnabled(ARSTREAM2_StreamReceiverEngine_Handle engineHandle);
+
+/* The ingest key is only used with sharded ingest (can be NULL otherwise); returns -2 if the stream already has a receiver */
+int ARSTREAM2_StreamReceiverEngine_AddReceiver(ARSTREAM2_StreamReceiverEngine_Handle engineHandle, ARSTREAM2_StreamReceiver_Handle streamReceiverHandle,
+                                               const ARSTREAM2_StreamReceiverEngine_IngestKey_t *ingestKey);
+
+/* When the function returns the instance is no longer accessed by the workers */
+int ARSTREAM2_StreamReceiverEngine_RemoveReceiver(ARSTREAM2_StreamReceiverEngine_Handle engineHandle, ARSTREAM2_StreamReceiver_Handle streamReceiverHandle);
+
+
+#endif /* _ARSTREAM2_STREAM_RECEIVER_INTERNAL_H_ */
@@ -7,14 +7,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <arpa/inet.h>
 #include <math.h>
 
 #include <libARSAL/ARSAL_Print.h>
 #include <libARSAL/ARSAL_Mutex.h>
-#if BUILD_LIBARMEDIA
-#include <libARMedia/ARMedia.h>
-#endif
+#include <libARSAL/ARSAL_Thread.h>
 
 #include "arstream2_stream_recorder.h"
 
@@ -22,7 +23,19 @@
 #define ARSTREAM2_STREAM_RECORDER_TAG "ARSTREAM2_StreamRecorder"
 
 #define ARSTREAM2_STREAM_RECORDER_FIFO_COND_TIMEOUT_MS (500)
-#define ARSTREAM2_STREAM_RECORDER_FILE_SYNC_MAX_INTERVAL (30)
+
+#define ARSTREAM2_STREAM_RECORDER_SEGMENT_COND_TIMEOUT_MS (500)
+
+/* MP4 user data entry types ('©mak', '©swr', '©day', '©xyz' are the usual
+ * QuickTime text atoms, the others are specific) */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_MAKER            (0xA96D616B)      /**< '©mak' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_SERIAL_NUMBER    (0xA9736E6F)      /**< '©sno' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_SOFTWARE_VERSION (0xA9737772)      /**< '©swr' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_MEDIA_DATE       (0xA9646179)      /**< '©day' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_RUN_DATE         (0xA9726474)      /**< '©rdt' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_RUN_UUID         (0xA9727569)      /**< '©rui' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_LOCATION         (0xA978797A)      /**< '©xyz' */
+#define ARSTREAM2_STREAM_RECORDER_USER_DATA_PICTURE_FOV      (0xA9666F76)      /**< '©fov' */
 
 
 //TODO: metadata definitions should be removed when the definitions will be available in a public ARSDK library
@@ -276,6 +289,18 @@ typedef enum
 } eARSTREAM2_STREAM_RECORDER_FILE_TYPE;
 
 
+typedef struct ARSTREAM2_StreamRecorder_Segment_s
+{
+    char *fileName;
+    ARSTREAM2_FileWriter_t *fileWriter;
+    ARSTREAM2_Mp4Writer_t *mp4Writer;
+    uint64_t size;
+
+    struct ARSTREAM2_StreamRecorder_Segment_s *next;
+
+} ARSTREAM2_StreamRecorder_Segment_t;
+
+
 typedef struct ARSTREAM2_StreamRecorder_s
 {
     int threadShouldStop;
@@ -283,22 +308,51 @@ typedef struct ARSTREAM2_StreamRecorder_s
     eARSTREAM2_STREAM_RECORDER_FILE_TYPE fileType;
     uint32_t videoWidth;
     uint32_t videoHeight;
-    FILE *outputFile;
-#if BUILD_LIBARMEDIA
-    ARMEDIA_VideoEncapsuler_t* videoEncap;
-    ARMEDIA_Frame_Header_t videoEncapFrameHeader;
-#endif
+    ARSTREAM2_FileWriter_t *fileWriter;
+    ARSTREAM2_Mp4Writer_t *mp4Writer;
+    int fileWriterError;
     ARSTREAM2_H264_AuFifo_t *auFifo;
     ARSTREAM2_H264_AuFifoQueue_t *auFifoQueue;
     ARSAL_Mutex_t *mutex;
     ARSAL_Cond_t *cond;
     uint32_t auCount;
-    uint32_t lastSyncIndex;
     void *recordingMetadata;
     unsigned int recordingMetadataSize;
     ARSTREAM2_STREAM_RECORDER_VideoMetadataTypes_t recordingMetadataType;
     void *savedMetadata;
     unsigned int savedMetadataSize;
+    int metadataSetupFailed;
+    const char *metadataContentEncoding;
+    const char *metadataMimeFormat;
+    ARSTREAM2_Mp4Writer_Config_t writerConfig;
+    ARSTREAM2_Mp4Writer_UserData_t userData[ARSTREAM2_MP4_WRITER_MAX_USER_DATA_COUNT];
+    int userDataCount;
+
+    /* segmentation */
+    int segmentEnabled;
+    uint64_t segmentDuration;
+    uint64_t segmentMaxSize;
+    uint64_t diskQuota;
+    char *fileNamePrefix;
+    char *fileNameExtension;
+    char *segmentFileName;
+    int segmentStarted;
+    uint64_t segmentStartTime;
+    uint64_t segmentSize;
+    uint64_t closedBytesWritten;
+    uint32_t closedStallCount;
+    ARSAL_Thread_t segmentThread;
+    ARSAL_Mutex_t segmentMutex;
+    ARSAL_Cond_t segmentCond;
+    int segmentThreadShouldStop;
+    unsigned int segmentIndex;
+    int nextSegmentRequested;
+    int nextSegmentFailed;
+    ARSTREAM2_StreamRecorder_Segment_t *nextSegment;
+    ARSTREAM2_StreamRecorder_Segment_t *closingSegment;
+    ARSTREAM2_StreamRecorder_Segment_t *completedSegmentHead;
+    ARSTREAM2_StreamRecorder_Segment_t *completedSegmentTail;
+    uint64_t completedSegmentSize;
 
 } ARSTREAM2_StreamRecorder_t;
 
@@ -451,11 +505,329 @@ static int ARSTREAM2_StreamRecorder_StreamingToRecordingMetadata(uint64_t timest
 }
 
 
+static eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_OpenWriter(ARSTREAM2_StreamRecorder_t *streamRecorder, const char *fileName,
+                                                           ARSTREAM2_FileWriter_t **fileWriter, ARSTREAM2_Mp4Writer_t **mp4Writer)
+{
+    eARSTREAM2_ERROR ret = ARSTREAM2_OK;
+    ARSTREAM2_Mp4Writer_Config_t writerConfig = streamRecorder->writerConfig;
+    int i;
+
+    writerConfig.fileWriterConfig.fileName = fileName;
+
+    if (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4)
+    {
+        *mp4Writer = ARSTREAM2_Mp4Writer_New(&writerConfig, &ret);
+        if (ret != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to create MP4 file '%s': %s", fileName, ARSTREAM2_Error_ToString(ret));
+        }
+        else
+        {
+            for (i = 0; i < streamRecorder->userDataCount; i++)
+            {
+                if (ARSTREAM2_Mp4Writer_AddUserData(*mp4Writer, streamRecorder->userData[i].type, streamRecorder->userData[i].value) != 0)
+                {
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARSTREAM2_Mp4Writer_AddUserData() failed");
+                }
+            }
+        }
+    }
+    else
+    {
+        *fileWriter = ARSTREAM2_FileWriter_New(&writerConfig.fileWriterConfig, &ret);
+        if (ret != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to open file '%s'", fileName);
+        }
+        else if ((ARSTREAM2_FileWriter_Write(*fileWriter, writerConfig.sps, writerConfig.spsSize) != 0)
+                 || (ARSTREAM2_FileWriter_Write(*fileWriter, writerConfig.pps, writerConfig.ppsSize) != 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to write file '%s'", fileName);
+            ARSTREAM2_FileWriter_Delete(fileWriter);
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
+        }
+    }
+
+    return ret;
+}
+
+
+static char* ARSTREAM2_StreamRecorder_SegmentFileName(ARSTREAM2_StreamRecorder_t *streamRecorder, unsigned int index)
+{
+    size_t len = strlen(streamRecorder->fileNamePrefix) + strlen(streamRecorder->fileNameExtension) + 12;
+    char *fileName = malloc(len);
+    if (fileName)
+    {
+        snprintf(fileName, len, "%s_%04u%s", streamRecorder->fileNamePrefix, index, streamRecorder->fileNameExtension);
+    }
+    else
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Allocation failed (size %zu)", len);
+    }
+
+    return fileName;
+}
+
+
+static ARSTREAM2_StreamRecorder_Segment_t* ARSTREAM2_StreamRecorder_OpenSegment(ARSTREAM2_StreamRecorder_t *streamRecorder, unsigned int index)
+{
+    ARSTREAM2_StreamRecorder_Segment_t *segment;
+
+    segment = (ARSTREAM2_StreamRecorder_Segment_t*)malloc(sizeof(*segment));
+    if (!segment)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Allocation failed (size %zu)", sizeof(*segment));
+        return NULL;
+    }
+    memset(segment, 0, sizeof(*segment));
+
+    segment->fileName = ARSTREAM2_StreamRecorder_SegmentFileName(streamRecorder, index);
+    if ((!segment->fileName)
+            || (ARSTREAM2_StreamRecorder_OpenWriter(streamRecorder, segment->fileName, &segment->fileWriter, &segment->mp4Writer) != ARSTREAM2_OK))
+    {
+        free(segment->fileName);
+        free(segment);
+        return NULL;
+    }
+
+    return segment;
+}
+
+
+static void ARSTREAM2_StreamRecorder_CloseSegment(ARSTREAM2_StreamRecorder_Segment_t *segment, int removeFile)
+{
+    eARSTREAM2_ERROR err;
+    struct stat st;
+
+    if (segment->fileWriter)
+    {
+        /* the remaining data is written and synced */
+        err = ARSTREAM2_FileWriter_Delete(&segment->fileWriter);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to close the file: %s", ARSTREAM2_Error_ToString(err));
+        }
+    }
+    if (segment->mp4Writer)
+    {
+        err = ARSTREAM2_Mp4Writer_Delete(&segment->mp4Writer);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to close the file: %s", ARSTREAM2_Error_ToString(err));
+        }
+    }
+
+    if (removeFile)
+    {
+        unlink(segment->fileName);
+    }
+    else if (stat(segment->fileName, &st) == 0)
+    {
+        segment->size = (uint64_t)st.st_size;
+    }
+}
+
+
+static void ARSTREAM2_StreamRecorder_EnforceDiskQuota(ARSTREAM2_StreamRecorder_t *streamRecorder)
+{
+    ARSTREAM2_StreamRecorder_Segment_t *segment;
+    uint64_t reserve;
+
+    if (!streamRecorder->diskQuota)
+    {
+        return;
+    }
+
+    /* keep room for the segment being recorded */
+    reserve = (streamRecorder->segmentMaxSize) ? streamRecorder->segmentMaxSize
+            : ((streamRecorder->completedSegmentTail) ? streamRecorder->completedSegmentTail->size : 0);
+
+    while ((streamRecorder->completedSegmentHead) && (streamRecorder->completedSegmentSize + reserve > streamRecorder->diskQuota))
+    {
+        segment = streamRecorder->completedSegmentHead;
+        streamRecorder->completedSegmentHead = segment->next;
+        if (!streamRecorder->completedSegmentHead)
+        {
+            streamRecorder->completedSegmentTail = NULL;
+        }
+        streamRecorder->completedSegmentSize -= segment->size;
+        if (unlink(segment->fileName) != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_WARNING, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to delete segment '%s'", segment->fileName);
+        }
+        else
+        {
+            ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECORDER_TAG, "Segment '%s' deleted (disk quota)", segment->fileName);
+        }
+        free(segment->fileName);
+        free(segment);
+    }
+}
+
+
+static void* ARSTREAM2_StreamRecorder_RunSegmentThread(void *param)
+{
+    ARSTREAM2_StreamRecorder_t* streamRecorder = (ARSTREAM2_StreamRecorder_t*)param;
+    ARSTREAM2_StreamRecorder_Segment_t *segment;
+    unsigned int index;
+
+    ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+    while (!streamRecorder->segmentThreadShouldStop)
+    {
+        if (streamRecorder->closingSegment)
+        {
+            /* close the previous segment */
+            segment = streamRecorder->closingSegment;
+            ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+            ARSTREAM2_StreamRecorder_CloseSegment(segment, 0);
+            ARSAL_Mutex_Lock(streamRecorder->mutex);
+            streamRecorder->closedBytesWritten += segment->size;
+            ARSAL_Mutex_Unlock(streamRecorder->mutex);
+            if (streamRecorder->completedSegmentTail)
+            {
+                streamRecorder->completedSegmentTail->next = segment;
+            }
+            else
+            {
+                streamRecorder->completedSegmentHead = segment;
+            }
+            streamRecorder->completedSegmentTail = segment;
+            streamRecorder->completedSegmentSize += segment->size;
+            ARSTREAM2_StreamRecorder_EnforceDiskQuota(streamRecorder);
+            ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+            streamRecorder->closingSegment = NULL;
+            ARSAL_Cond_Broadcast(&(streamRecorder->segmentCond));
+        }
+        else if ((streamRecorder->nextSegmentRequested) && (!streamRecorder->nextSegment))
+        {
+            /* open the next segment ahead of time */
+            index = streamRecorder->segmentIndex++;
+            ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+            segment = ARSTREAM2_StreamRecorder_OpenSegment(streamRecorder, index);
+            if (!segment)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to open the next segment, the recording continues in the current segment");
+            }
+            ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+            streamRecorder->nextSegment = segment;
+            streamRecorder->nextSegmentRequested = 0;
+        }
+        else
+        {
+            ARSAL_Cond_Timedwait(&(streamRecorder->segmentCond), &(streamRecorder->segmentMutex), ARSTREAM2_STREAM_RECORDER_SEGMENT_COND_TIMEOUT_MS);
+        }
+    }
+    ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+
+    return (void*)0;
+}
+
+
+static void ARSTREAM2_StreamRecorder_CheckSegment(ARSTREAM2_StreamRecorder_t *streamRecorder, const ARSTREAM2_H264_AccessUnit_t *au)
+{
+    ARSTREAM2_StreamRecorder_Segment_t *segment = NULL;
+    ARSTREAM2_FileWriter_t *fileWriter, *tmpFileWriter;
+    ARSTREAM2_Mp4Writer_t *tmpMp4Writer;
+    ARSTREAM2_FileWriter_Stats_t stats;
+    char *tmpFileName;
+
+    if (!streamRecorder->segmentStarted)
+    {
+        streamRecorder->segmentStartTime = au->extRtpTimestamp;
+        streamRecorder->segmentStarted = 1;
+        return;
+    }
+
+    /* segments start with a frame that can be decoded independently */
+    if ((au->syncType != ARSTREAM2_H264_AU_SYNC_TYPE_IDR) && (au->syncType != ARSTREAM2_H264_AU_SYNC_TYPE_IFRAME))
+    {
+        return;
+    }
+    if (!(((streamRecorder->segmentDuration) && (au->extRtpTimestamp >= streamRecorder->segmentStartTime + streamRecorder->segmentDuration))
+            || ((streamRecorder->segmentMaxSize) && (streamRecorder->segmentSize >= streamRecorder->segmentMaxSize))))
+    {
+        return;
+    }
+
+    ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+    if ((streamRecorder->nextSegment) && (!streamRecorder->closingSegment))
+    {
+        segment = streamRecorder->nextSegment;
+        streamRecorder->nextSegment = NULL;
+    }
+    if ((!streamRecorder->nextSegment) && (!streamRecorder->nextSegmentRequested))
+    {
+        streamRecorder->nextSegmentRequested = 1;
+        ARSAL_Cond_Broadcast(&(streamRecorder->segmentCond));
+    }
+    ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+
+    if (!segment)
+    {
+        /* the next segment is not ready, retry at the next sync frame */
+        return;
+    }
+
+    /* switch to the next segment; the previous one is handed over to the segment thread */
+    fileWriter = (streamRecorder->mp4Writer) ? streamRecorder->mp4Writer->fileWriter : streamRecorder->fileWriter;
+    ARSAL_Mutex_Lock(streamRecorder->mutex);
+    ARSTREAM2_FileWriter_GetStats(fileWriter, &stats);
+    streamRecorder->closedStallCount += stats.stallCount;
+    tmpFileName = streamRecorder->segmentFileName;
+    tmpFileWriter = streamRecorder->fileWriter;
+    tmpMp4Writer = streamRecorder->mp4Writer;
+    streamRecorder->segmentFileName = segment->fileName;
+    streamRecorder->fileWriter = segment->fileWriter;
+    streamRecorder->mp4Writer = segment->mp4Writer;
+    segment->fileName = tmpFileName;
+    segment->fileWriter = tmpFileWriter;
+    segment->mp4Writer = tmpMp4Writer;
+    ARSAL_Mutex_Unlock(streamRecorder->mutex);
+
+    if ((streamRecorder->mp4Writer) && (streamRecorder->recordingMetadataSize > 0)
+            && (ARSTREAM2_Mp4Writer_SetMetadataTrack(streamRecorder->mp4Writer, streamRecorder->metadataContentEncoding,
+                                                     streamRecorder->metadataMimeFormat, streamRecorder->recordingMetadataSize) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARSTREAM2_Mp4Writer_SetMetadataTrack() failed");
+    }
+
+    ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+    streamRecorder->closingSegment = segment;
+    ARSAL_Cond_Broadcast(&(streamRecorder->segmentCond));
+    ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+
+    streamRecorder->segmentStartTime = au->extRtpTimestamp;
+    streamRecorder->segmentSize = 0;
+    ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_RECORDER_TAG, "Recording segment '%s'", streamRecorder->segmentFileName);
+}
+
+
+static int ARSTREAM2_StreamRecorder_AddUserData(ARSTREAM2_StreamRecorder_t *streamRecorder, uint32_t type, const char *value)
+{
+    if (streamRecorder->userDataCount >= ARSTREAM2_MP4_WRITER_MAX_USER_DATA_COUNT)
+    {
+        return -1;
+    }
+
+    /* the entries are kept for the next segments */
+    streamRecorder->userData[streamRecorder->userDataCount].value = strdup(value);
+    if (!streamRecorder->userData[streamRecorder->userDataCount].value)
+    {
+        return -1;
+    }
+    streamRecorder->userData[streamRecorder->userDataCount].type = type;
+    streamRecorder->userDataCount++;
+
+    return ARSTREAM2_Mp4Writer_AddUserData(streamRecorder->mp4Writer, type, value);
+}
+
+
 eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_Init(ARSTREAM2_StreamRecorder_Handle *streamRecorderHandle,
                                                ARSTREAM2_StreamRecorder_Config_t *config)
 {
     eARSTREAM2_ERROR ret = ARSTREAM2_OK;
     ARSTREAM2_StreamRecorder_t *streamRecorder = NULL;
+    int segmentMutexInit = 0, segmentCondInit = 0;
 
     if (!streamRecorderHandle)
     {
@@ -535,54 +907,107 @@ eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_Init(ARSTREAM2_StreamRecorder_Handle *
         {
             streamRecorder->fileType = ARSTREAM2_STREAM_RECORDER_FILE_TYPE_H264_BYTE_STREAM;
         }
+        streamRecorder->writerConfig.fileWriterConfig.directIo = config->directIo;
+        streamRecorder->writerConfig.fileWriterConfig.batchSize = config->writeBatchSize;
+        streamRecorder->writerConfig.fileWriterConfig.syncIntervalMs = config->syncIntervalMs;
+        streamRecorder->writerConfig.fileWriterConfig.syncByteBudget = config->syncByteBudget;
+        streamRecorder->writerConfig.videoFramerate = config->videoFramerate;
+        streamRecorder->writerConfig.videoWidth = config->videoWidth;
+        streamRecorder->writerConfig.videoHeight = config->videoHeight;
+        streamRecorder->writerConfig.spsSize = config->spsSize;
+        streamRecorder->writerConfig.ppsSize = config->ppsSize;
+        if ((config->segmentDurationMs > 0) || (config->segmentMaxSize > 0))
+        {
+            streamRecorder->segmentEnabled = 1;
+            streamRecorder->segmentDuration = (config->segmentDurationMs > 0) ? (uint64_t)config->segmentDurationMs * 90 : 0;
+            streamRecorder->segmentMaxSize = (config->segmentMaxSize > 0) ? (uint64_t)config->segmentMaxSize : 0;
+            streamRecorder->diskQuota = config->diskQuota;
+        }
     }
 
-#if BUILD_LIBARMEDIA
-    if ((ret == ARSTREAM2_OK) && (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4))
+    if (ret == ARSTREAM2_OK)
     {
-        eARMEDIA_ERROR err = ARMEDIA_OK;
-        streamRecorder->videoEncap = ARMEDIA_VideoEncapsuler_New(config->mediaFileName,
-                                                                 round(config->videoFramerate),
-                                                                 "", "", config->serviceType, &err);
-        if (streamRecorder->videoEncap == NULL)
+        /* the parameter sets are kept for the next segments */
+        uint8_t *sps = malloc(config->spsSize);
+        uint8_t *pps = malloc(config->ppsSize);
+        if (sps)
+        {
+            memcpy(sps, config->sps, config->spsSize);
+        }
+        if (pps)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_New() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
-            ret = ARSTREAM2_ERROR_UNSUPPORTED;
+            memcpy(pps, config->pps, config->ppsSize);
+        }
+        streamRecorder->writerConfig.sps = sps;
+        streamRecorder->writerConfig.pps = pps;
+        if ((!sps) || (!pps))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Parameter sets allocation failed");
+            ret = ARSTREAM2_ERROR_ALLOC;
         }
     }
 
-    if ((ret == ARSTREAM2_OK) && (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4))
+    if ((ret == ARSTREAM2_OK) && (streamRecorder->segmentEnabled))
     {
-        eARMEDIA_ERROR err;
-        err = ARMEDIA_VideoEncapsuler_SetAvcParameterSets(streamRecorder->videoEncap, config->sps, config->spsSize, config->pps, config->ppsSize);
-        if (err != ARMEDIA_OK)
+        const char *extension = strrchr(config->mediaFileName, '.');
+        streamRecorder->fileNamePrefix = strndup(config->mediaFileName, extension - config->mediaFileName);
+        streamRecorder->fileNameExtension = strdup(extension);
+        if ((!streamRecorder->fileNamePrefix) || (!streamRecorder->fileNameExtension))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "File name allocation failed");
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_SetAvcParameterSets() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
-            ret = ARSTREAM2_ERROR_UNSUPPORTED;
+            streamRecorder->segmentFileName = ARSTREAM2_StreamRecorder_SegmentFileName(streamRecorder, streamRecorder->segmentIndex++);
+            if (!streamRecorder->segmentFileName)
+            {
+                ret = ARSTREAM2_ERROR_ALLOC;
+            }
         }
     }
-#else
-    if ((ret == ARSTREAM2_OK) && (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4))
+
+    if (ret == ARSTREAM2_OK)
+    {
+        ret = ARSTREAM2_StreamRecorder_OpenWriter(streamRecorder, (streamRecorder->segmentEnabled) ? streamRecorder->segmentFileName : config->mediaFileName,
+                                                  &streamRecorder->fileWriter, &streamRecorder->mp4Writer);
+    }
+
+    if ((ret == ARSTREAM2_OK) && (streamRecorder->segmentEnabled))
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Unsupported file format: MP4");
-        ret = ARSTREAM2_ERROR_UNSUPPORTED;
+        int mutexInitRet = ARSAL_Mutex_Init(&(streamRecorder->segmentMutex));
+        if (mutexInitRet != 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Mutex creation failed (%d)", mutexInitRet);
+            ret = ARSTREAM2_ERROR_ALLOC;
+        }
+        else
+        {
+            segmentMutexInit = 1;
+        }
     }
-#endif
 
-    if ((ret == ARSTREAM2_OK) && (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_H264_BYTE_STREAM))
+    if ((ret == ARSTREAM2_OK) && (streamRecorder->segmentEnabled))
     {
-        streamRecorder->outputFile = fopen(config->mediaFileName, "wb");
-        if (streamRecorder->outputFile == NULL)
+        int condInitRet = ARSAL_Cond_Init(&(streamRecorder->segmentCond));
+        if (condInitRet != 0)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to open file '%s'", config->mediaFileName);
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Cond creation failed (%d)", condInitRet);
             ret = ARSTREAM2_ERROR_ALLOC;
         }
+        else
+        {
+            segmentCondInit = 1;
+        }
+    }
 
-        if (streamRecorder->outputFile)
+    if ((ret == ARSTREAM2_OK) && (streamRecorder->segmentEnabled))
+    {
+        int thErr = ARSAL_Thread_Create(&streamRecorder->segmentThread, ARSTREAM2_StreamRecorder_RunSegmentThread, (void*)streamRecorder);
+        if (thErr != 0)
         {
-            fwrite(config->sps, config->spsSize, 1, streamRecorder->outputFile);
-            fwrite(config->pps, config->ppsSize, 1, streamRecorder->outputFile);
-            fflush(streamRecorder->outputFile);
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Segment thread creation failed (%d)", thErr);
+            ret = ARSTREAM2_ERROR_RESOURCE_UNAVAILABLE;
         }
     }
 
@@ -594,7 +1019,15 @@ eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_Init(ARSTREAM2_StreamRecorder_Handle *
     {
         if (streamRecorder)
         {
-            if (streamRecorder->outputFile) fclose(streamRecorder->outputFile);
+            if (streamRecorder->fileWriter) ARSTREAM2_FileWriter_Delete(&streamRecorder->fileWriter);
+            if (streamRecorder->mp4Writer) ARSTREAM2_Mp4Writer_Delete(&streamRecorder->mp4Writer);
+            if (segmentMutexInit) ARSAL_Mutex_Destroy(&(streamRecorder->segmentMutex));
+            if (segmentCondInit) ARSAL_Cond_Destroy(&(streamRecorder->segmentCond));
+            free((void*)streamRecorder->writerConfig.sps);
+            free((void*)streamRecorder->writerConfig.pps);
+            free(streamRecorder->fileNamePrefix);
+            free(streamRecorder->fileNameExtension);
+            free(streamRecorder->segmentFileName);
             free(streamRecorder);
         }
         *streamRecorderHandle = NULL;
@@ -628,9 +1061,69 @@ eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_Free(ARSTREAM2_StreamRecorder_Handle *
 
     if (canDelete == 1)
     {
-        if (streamRecorder->outputFile) fclose(streamRecorder->outputFile);
+        if (streamRecorder->segmentEnabled)
+        {
+            ARSTREAM2_StreamRecorder_Segment_t *segment, *next;
+
+            ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+            streamRecorder->segmentThreadShouldStop = 1;
+            ARSAL_Cond_Broadcast(&(streamRecorder->segmentCond));
+            ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+            ARSAL_Thread_Join(streamRecorder->segmentThread, NULL);
+            ARSAL_Thread_Destroy(&(streamRecorder->segmentThread));
+
+            if (streamRecorder->closingSegment)
+            {
+                ARSTREAM2_StreamRecorder_CloseSegment(streamRecorder->closingSegment, 0);
+                free(streamRecorder->closingSegment->fileName);
+                free(streamRecorder->closingSegment);
+            }
+            if (streamRecorder->nextSegment)
+            {
+                /* the segment opened ahead of time is empty */
+                ARSTREAM2_StreamRecorder_CloseSegment(streamRecorder->nextSegment, 1);
+                free(streamRecorder->nextSegment->fileName);
+                free(streamRecorder->nextSegment);
+            }
+            for (segment = streamRecorder->completedSegmentHead; segment; segment = next)
+            {
+                next = segment->next;
+                free(segment->fileName);
+                free(segment);
+            }
+            ARSAL_Mutex_Destroy(&(streamRecorder->segmentMutex));
+            ARSAL_Cond_Destroy(&(streamRecorder->segmentCond));
+        }
+        if (streamRecorder->fileWriter)
+        {
+            /* the remaining data is written and synced */
+            ret = ARSTREAM2_FileWriter_Delete(&streamRecorder->fileWriter);
+            if (ret != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to close the file: %s", ARSTREAM2_Error_ToString(ret));
+            }
+        }
+        if (streamRecorder->mp4Writer)
+        {
+            /* the last fragment is written; there is no index to finalize */
+            ret = ARSTREAM2_Mp4Writer_Delete(&streamRecorder->mp4Writer);
+            if (ret != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Failed to close the file: %s", ARSTREAM2_Error_ToString(ret));
+            }
+        }
         free(streamRecorder->recordingMetadata);
         free(streamRecorder->savedMetadata);
+        int i;
+        for (i = 0; i < streamRecorder->userDataCount; i++)
+        {
+            free(streamRecorder->userData[i].value);
+        }
+        free((void*)streamRecorder->writerConfig.sps);
+        free((void*)streamRecorder->writerConfig.pps);
+        free(streamRecorder->fileNamePrefix);
+        free(streamRecorder->fileNameExtension);
+        free(streamRecorder->segmentFileName);
 
         free(streamRecorder);
         *streamRecorderHandle = NULL;
@@ -683,62 +1176,99 @@ eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_SetUntimedMetadata(ARSTREAM2_StreamRec
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
 
-#if BUILD_LIBARMEDIA
-    ARMEDIA_Untimed_Metadata_t meta;
-    memset(&meta, 0, sizeof(ARMEDIA_Untimed_Metadata_t));
-    if (metadata->makerAndModel)
+    if (!streamRecorder->mp4Writer)
+    {
+        /* no untimed metadata in H.264 byte stream files */
+        return ARSTREAM2_OK;
+    }
+    if (streamRecorder->mp4Writer->headerWritten)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "The MP4 file header has already been written");
+        return ARSTREAM2_ERROR_INVALID_STATE;
+    }
+
+    char str[128];
+    int err = 0;
+    if ((metadata->makerAndModel) && (metadata->makerAndModel[0]))
     {
-        snprintf(meta.makerAndModel,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_MAKER_SIZE,
-                 "%s", metadata->makerAndModel);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_MAKER, metadata->makerAndModel);
     }
-    if (metadata->serialNumber)
+    if ((metadata->serialNumber) && (metadata->serialNumber[0]))
     {
-        snprintf(meta.serialNumber,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_SERIAL_NUM_SIZE,
-                 "%s", metadata->serialNumber);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_SERIAL_NUMBER, metadata->serialNumber);
     }
-    if (metadata->softwareVersion)
+    if ((metadata->softwareVersion) && (metadata->softwareVersion[0]))
     {
-        snprintf(meta.softwareVersion,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_SOFT_VER_SIZE,
-                 "%s", metadata->softwareVersion);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_SOFTWARE_VERSION, metadata->softwareVersion);
     }
-    if (metadata->mediaDate)
+    if ((metadata->mediaDate) && (metadata->mediaDate[0]))
     {
-        snprintf(meta.mediaDate,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_MEDIA_DATE_SIZE,
-                 "%s", metadata->mediaDate);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_MEDIA_DATE, metadata->mediaDate);
     }
-    if (metadata->runDate)
+    if ((metadata->runDate) && (metadata->runDate[0]))
     {
-        snprintf(meta.runDate,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_RUN_DATE_SIZE,
-                 "%s", metadata->runDate);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_RUN_DATE, metadata->runDate);
     }
-    if (metadata->runUuid)
+    if ((metadata->runUuid) && (metadata->runUuid[0]))
     {
-        snprintf(meta.runUuid,
-                 ARMEDIA_ENCAPSULER_UNTIMED_METADATA_RUN_UUID_SIZE,
-                 "%s", metadata->runUuid);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_RUN_UUID, metadata->runUuid);
     }
-    meta.takeoffLatitude = metadata->takeoffLatitude;
-    meta.takeoffLongitude = metadata->takeoffLongitude;
-    meta.takeoffAltitude = metadata->takeoffAltitude;
-    meta.pictureHFov = metadata->pictureHFov;
-    meta.pictureVFov = metadata->pictureVFov;
-    eARMEDIA_ERROR err = ARMEDIA_VideoEncapsuler_SetUntimedMetadata(streamRecorder->videoEncap, &meta);
-    if (err != ARMEDIA_OK)
+    if ((metadata->takeoffLatitude != 500.) && (metadata->takeoffLongitude != 500.))
     {
-        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_SetUntimedMetadata() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
+        /* ISO 6709 location */
+        snprintf(str, sizeof(str), "%+.8f%+.8f%+.3f/", metadata->takeoffLatitude, metadata->takeoffLongitude, metadata->takeoffAltitude);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_LOCATION, str);
+    }
+    if ((metadata->pictureHFov != 0.) && (metadata->pictureVFov != 0.))
+    {
+        snprintf(str, sizeof(str), "%.2f,%.2f", metadata->pictureHFov, metadata->pictureVFov);
+        err |= ARSTREAM2_StreamRecorder_AddUserData(streamRecorder, ARSTREAM2_STREAM_RECORDER_USER_DATA_PICTURE_FOV, str);
+    }
+    if (err != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARSTREAM2_StreamRecorder_AddUserData() failed");
         ret = ARSTREAM2_ERROR_INVALID_STATE;
     }
-#endif
 
     return ret;
 }
 
 
+eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_GetStats(ARSTREAM2_StreamRecorder_Handle streamRecorderHandle,
+                                                   ARSTREAM2_FileWriter_Stats_t *stats)
+{
+    ARSTREAM2_StreamRecorder_t* streamRecorder = (ARSTREAM2_StreamRecorder_t*)streamRecorderHandle;
+
+    if (!streamRecorderHandle)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Invalid handle");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+    if (!stats)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "Invalid stats");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
+
+    if (streamRecorder->fileWriter)
+    {
+        ARSTREAM2_FileWriter_GetStats(streamRecorder->fileWriter, stats);
+    }
+    else if (streamRecorder->mp4Writer)
+    {
+        ARSTREAM2_FileWriter_GetStats(streamRecorder->mp4Writer->fileWriter, stats);
+    }
+    else
+    {
+        memset(stats, 0, sizeof(ARSTREAM2_FileWriter_Stats_t));
+    }
+    stats->bytesWritten += streamRecorder->closedBytesWritten;
+    stats->stallCount += streamRecorder->closedStallCount;
+
+    return ARSTREAM2_OK;
+}
+
+
 void* ARSTREAM2_StreamRecorder_RunThread(void *param)
 {
     ARSTREAM2_StreamRecorder_t* streamRecorder = (ARSTREAM2_StreamRecorder_t*)param;
@@ -756,6 +1286,15 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
     shouldStop = streamRecorder->threadShouldStop;
     ARSAL_Mutex_Unlock(streamRecorder->mutex);
 
+    if (streamRecorder->segmentEnabled)
+    {
+        /* open the next segment ahead of time */
+        ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+        streamRecorder->nextSegmentRequested = 1;
+        ARSAL_Cond_Broadcast(&(streamRecorder->segmentCond));
+        ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+    }
+
     while (!shouldStop)
     {
         ARSTREAM2_H264_AuFifoItem_t *auItem;
@@ -768,52 +1307,37 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
             ARSTREAM2_H264_AccessUnit_t *au = &auItem->au;
             ARSTREAM2_H264_NaluFifoItem_t *naluItem;
 
+            if ((streamRecorder->segmentEnabled) && (!streamRecorder->fileWriterError))
+            {
+                ARSTREAM2_StreamRecorder_CheckSegment(streamRecorder, au);
+            }
+
             /* Record the frame */
             switch (streamRecorder->fileType)
             {
             case ARSTREAM2_STREAM_RECORDER_FILE_TYPE_H264_BYTE_STREAM:
             {
-                if (streamRecorder->outputFile)
+                if ((streamRecorder->fileWriter) && (!streamRecorder->fileWriterError))
                 {
+                    /* the data syncs are issued by the file writer on a time and byte budget */
                     for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
                     {
-                        fwrite(naluItem->nalu.nalu, naluItem->nalu.naluSize, 1, streamRecorder->outputFile);
-                    }
-
-                    if ((au->syncType != ARSTREAM2_H264_AU_SYNC_TYPE_NONE)
-                            || (streamRecorder->auCount >= streamRecorder->lastSyncIndex + ARSTREAM2_STREAM_RECORDER_FILE_SYNC_MAX_INTERVAL))
-                    {
-                        fflush(streamRecorder->outputFile);
-                        fsync(fileno(streamRecorder->outputFile));
-                        streamRecorder->lastSyncIndex = streamRecorder->auCount;
+                        if (ARSTREAM2_FileWriter_Write(streamRecorder->fileWriter, naluItem->nalu.nalu, naluItem->nalu.naluSize) != 0)
+                        {
+                            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "File write failed, recording is interrupted");
+                            streamRecorder->fileWriterError = 1;
+                            break;
+                        }
                     }
                 }
                 break;
             }
-#if BUILD_LIBARMEDIA
             case ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4:
             {
                 int gotMetadata = 0;
-                memset(&streamRecorder->videoEncapFrameHeader, 0, sizeof(ARMEDIA_Frame_Header_t));
-                streamRecorder->videoEncapFrameHeader.codec = CODEC_MPEG4_AVC;
-                streamRecorder->videoEncapFrameHeader.frame_size = au->auSize;
-                streamRecorder->videoEncapFrameHeader.frame_number = streamRecorder->auCount;
-                streamRecorder->videoEncapFrameHeader.width = streamRecorder->videoWidth;
-                streamRecorder->videoEncapFrameHeader.height = streamRecorder->videoHeight;
-                streamRecorder->videoEncapFrameHeader.timestamp = au->ntpTimestamp;
-                streamRecorder->videoEncapFrameHeader.frame_type = (au->syncType == ARSTREAM2_H264_AU_SYNC_TYPE_NONE) ? ARMEDIA_ENCAPSULER_FRAME_TYPE_P_FRAME : ARMEDIA_ENCAPSULER_FRAME_TYPE_I_FRAME;
-                streamRecorder->videoEncapFrameHeader.frame = NULL;
-                streamRecorder->videoEncapFrameHeader.avc_insert_ps = 0;
-                unsigned int naluCount = 0;
-                for (naluItem = au->naluHead; naluItem; naluItem = naluItem->next)
-                {
-                    streamRecorder->videoEncapFrameHeader.avc_nalu_size[naluCount] = naluItem->nalu.naluSize;
-                    streamRecorder->videoEncapFrameHeader.avc_nalu_data[naluCount] = naluItem->nalu.nalu;
-                    naluCount++;
-                }
-                streamRecorder->videoEncapFrameHeader.avc_nalu_count = naluCount;
 
-                if ((au->buffer->metadataBuffer) && (au->metadataSize) && (streamRecorder->recordingMetadataSize == 0))
+                if ((au->buffer->metadataBuffer) && (au->metadataSize) && (streamRecorder->recordingMetadataSize == 0)
+                        && (!streamRecorder->metadataSetupFailed))
                 {
                     /* Setup the metadata */
                     int size = 0;
@@ -840,26 +1364,28 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
                         }
                         if (ret == 0)
                         {
-                            eARMEDIA_ERROR err = ARMEDIA_OK;
+                            const char *contentEncoding = NULL, *mimeFormat = NULL;
                             if (streamRecorder->recordingMetadataType == ARSTREAM2_STREAM_RECORDER_VIDEO_METADATA_TYPE_RECORDING_V1)
                             {
-                                err = ARMEDIA_VideoEncapsuler_SetMetadataInfo(streamRecorder->videoEncap,
-                                                                              ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_RECORDING_METADATA_V1_CONTENT_ENCODING,
-                                                                              ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_RECORDING_METADATA_V1_MIME_FORMAT,
-                                                                              size);
+                                contentEncoding = ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_RECORDING_METADATA_V1_CONTENT_ENCODING;
+                                mimeFormat = ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_RECORDING_METADATA_V1_MIME_FORMAT;
                             }
                             else if (streamRecorder->recordingMetadataType == ARSTREAM2_STREAM_RECORDER_VIDEO_METADATA_TYPE_V2)
                             {
-                                err = ARMEDIA_VideoEncapsuler_SetMetadataInfo(streamRecorder->videoEncap,
-                                                                              ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_METADATA_V2_CONTENT_ENCODING,
-                                                                              ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_METADATA_V2_MIME_FORMAT,
-                                                                              size);
+                                contentEncoding = ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_METADATA_V2_CONTENT_ENCODING;
+                                mimeFormat = ARSTREAM2_STREAM_RECORDER_PARROT_VIDEO_METADATA_V2_MIME_FORMAT;
                             }
-                            if (err != ARMEDIA_OK)
+                            if ((!contentEncoding) || (ARSTREAM2_Mp4Writer_SetMetadataTrack(streamRecorder->mp4Writer, contentEncoding, mimeFormat, (uint32_t)size) != 0))
                             {
-                                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_SetMetadataInfo() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
+                                ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARSTREAM2_Mp4Writer_SetMetadataTrack() failed");
                                 ret = -1;
                             }
+                            else
+                            {
+                                /* the next segments get the same metadata track */
+                                streamRecorder->metadataContentEncoding = contentEncoding;
+                                streamRecorder->metadataMimeFormat = mimeFormat;
+                            }
                         }
                         if (ret != 0)
                         {
@@ -869,6 +1395,7 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
                             free(streamRecorder->savedMetadata);
                             streamRecorder->savedMetadata = NULL;
                             streamRecorder->savedMetadataSize = 0;
+                            streamRecorder->metadataSetupFailed = 1;
                         }
                     }
                 }
@@ -890,19 +1417,22 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
                     }
                 }
 
-                eARMEDIA_ERROR err = ARMEDIA_VideoEncapsuler_AddFrame(streamRecorder->videoEncap, &streamRecorder->videoEncapFrameHeader, ((gotMetadata) ? streamRecorder->recordingMetadata : NULL));
-                if (err != ARMEDIA_OK)
+                if ((!streamRecorder->fileWriterError)
+                        && (ARSTREAM2_Mp4Writer_AddSample(streamRecorder->mp4Writer, au, ((gotMetadata) ? streamRecorder->recordingMetadata : NULL),
+                                                          ((gotMetadata) ? streamRecorder->recordingMetadataSize : 0)) != 0)
+                        && (streamRecorder->mp4Writer->fileWriter->error))
                 {
-                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_AddFrame() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
+                    ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "File write failed, recording is interrupted");
+                    streamRecorder->fileWriterError = 1;
                 }
                 break;
             }
-#endif
             default:
                 break;
             }
 
             streamRecorder->auCount++;
+            streamRecorder->segmentSize += au->auSize;
 
             /* free the access unit */
             int ret = ARSTREAM2_H264_AuFifoUnrefBuffer(streamRecorder->auFifo, auItem->au.buffer);
@@ -924,6 +1454,14 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
         shouldStop = streamRecorder->threadShouldStop;
         ARSAL_Mutex_Unlock(streamRecorder->mutex);
 
+        ARSTREAM2_FileWriter_t *fileWriter = (streamRecorder->mp4Writer) ? streamRecorder->mp4Writer->fileWriter : streamRecorder->fileWriter;
+        if ((fileWriter) && (!streamRecorder->fileWriterError)
+                && (ARSTREAM2_FileWriter_Poll(fileWriter) != 0))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "File write failed, recording is interrupted");
+            streamRecorder->fileWriterError = 1;
+        }
+
         if (!shouldStop)
         {
             /* Wake up when a new AU is in the FIFO or when we need to exit */
@@ -933,16 +1471,23 @@ void* ARSTREAM2_StreamRecorder_RunThread(void *param)
         }
     }
 
-#if BUILD_LIBARMEDIA
-    if (streamRecorder->fileType == ARSTREAM2_STREAM_RECORDER_FILE_TYPE_MP4)
+    /* the writes submitted by this thread must complete before it exits */
+    if (streamRecorder->segmentEnabled)
     {
-        eARMEDIA_ERROR err = ARMEDIA_VideoEncapsuler_Finish(&streamRecorder->videoEncap);
-        if (err != ARMEDIA_OK)
+        ARSAL_Mutex_Lock(&(streamRecorder->segmentMutex));
+        while (streamRecorder->closingSegment)
         {
-            ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "ARMEDIA_VideoEncapsuler_AddFrame() failed: %d (%s)", err, ARMEDIA_Error_ToString(err));
+            ARSAL_Cond_Timedwait(&(streamRecorder->segmentCond), &(streamRecorder->segmentMutex), ARSTREAM2_STREAM_RECORDER_SEGMENT_COND_TIMEOUT_MS);
         }
+        ARSAL_Mutex_Unlock(&(streamRecorder->segmentMutex));
+    }
+    ARSTREAM2_FileWriter_t *fileWriter = (streamRecorder->mp4Writer) ? streamRecorder->mp4Writer->fileWriter : streamRecorder->fileWriter;
+    if ((fileWriter) && (!streamRecorder->fileWriterError)
+            && (ARSTREAM2_FileWriter_Drain(fileWriter) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_RECORDER_TAG, "File write failed, recording is interrupted");
+        streamRecorder->fileWriterError = 1;
     }
-#endif
 
     ARSAL_Mutex_Lock(streamRecorder->mutex);
     streamRecorder->threadStarted = 0;
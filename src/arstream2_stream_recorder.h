@@ -15,6 +15,8 @@ extern "C" {
 #include <inttypes.h>
 #include <libARStream2/arstream2_error.h>
 #include "arstream2_h264.h"
+#include "arstream2_file_writer.h"
+#include "arstream2_mp4_writer.h"
 
 
 /**
@@ -37,6 +39,13 @@ typedef struct
     const uint8_t *pps;                     /**< H.264 video PPS buffer pointer */
     uint32_t ppsSize;                       /**< H.264 video PPS buffer size in bytes */
     int serviceType;                        /**< ARDiscovery service type */
+    int directIo;                           /**< if true, write the file with direct I/O */
+    int writeBatchSize;                     /**< Write batch size in bytes (optional, 0 for the default value) */
+    int syncIntervalMs;                     /**< Maximum interval between two data syncs in milliseconds (optional, 0 for the default value, -1 to disable) */
+    int syncByteBudget;                     /**< Maximum amount of written data between two data syncs in bytes (optional, 0 for the default value, -1 to disable) */
+    int segmentDurationMs;                  /**< Segment duration in milliseconds (optional, 0 to disable time-based segmentation) */
+    int segmentMaxSize;                     /**< Maximum segment size in bytes (optional, 0 to disable size-based segmentation) */
+    uint64_t diskQuota;                     /**< Maximum size of the segments kept on disk in bytes, the oldest segments are deleted (optional, 0 for no limit, only used with segmentation) */
     ARSTREAM2_H264_AuFifo_t *auFifo;
     ARSTREAM2_H264_AuFifoQueue_t *auFifoQueue;
     ARSAL_Mutex_t *mutex;
@@ -67,6 +76,12 @@ typedef struct
  *
  * The library allocates the required resources. The user must call ARSTREAM2_StreamRecorder_Free() to free the resources.
  *
+ * When segmentation is enabled the recording is split at sync frames into files
+ * named after mediaFileName with a segment index before the extension (e.g.
+ * "rec_0000.mp4", "rec_0001.mp4"); each segment can be played independently.
+ * The next segment file is opened ahead of time and the previous one is closed
+ * by a helper thread so that the rollover does not block the recorder thread.
+ *
  * @param streamRecorderHandle Pointer to the handle used in future calls to the library.
  * @param config The instance configuration.
  *
@@ -106,16 +121,33 @@ eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_Stop(ARSTREAM2_StreamRecorder_Handle s
 /**
  * @brief Set the untimed metadata
  *
+ * For MP4 files the untimed metadata is written in the file header, therefore
+ * the function must be called before the StreamRecorder thread is started.
+ *
  * @param streamRecorderHandle Instance handle.
  * @param[in] metadata Untimed metadata structure
  *
  * @return ARSTREAM2_OK if no error happened
  * @return ARSTREAM2_ERROR_BAD_PARAMETERS if the streamRecorderHandle or metadata pointer are invalid
+ * @return ARSTREAM2_ERROR_INVALID_STATE if the MP4 file header has already been written
  */
 eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_SetUntimedMetadata(ARSTREAM2_StreamRecorder_Handle streamRecorderHandle,
                                                              const ARSTREAM2_StreamRecorder_UntimedMetadata_t *metadata);
 
 
+/**
+ * @brief Get the StreamRecorder file write statistics.
+ *
+ * @param streamRecorderHandle Instance handle.
+ * @param[out] stats File write statistics
+ *
+ * @return ARSTREAM2_OK if no error happened
+ * @return ARSTREAM2_ERROR_BAD_PARAMETERS if the streamRecorderHandle or stats pointer are invalid
+ */
+eARSTREAM2_ERROR ARSTREAM2_StreamRecorder_GetStats(ARSTREAM2_StreamRecorder_Handle streamRecorderHandle,
+                                                   ARSTREAM2_FileWriter_Stats_t *stats);
+
+
 /**
  * @brief Run a StreamRecorder thread.
  *
@@ -44,6 +44,7 @@
 typedef struct ARSTREAM2_StreamSender_s
 {
     ARSTREAM2_RtpSender_t *sender;
+    struct ARSTREAM2_StreamSender_s *transport;
     ARSTREAM2_StreamSender_RtpStatsCallback_t rtpStatsCallback;
     void *rtpStatsCallbackUserPtr;
     ARSTREAM2_StreamSender_VideoStatsCallback_t videoStatsCallback;
@@ -101,6 +102,11 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
         ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_SENDER_TAG, "Invalid pointer for config");
         return ARSTREAM2_ERROR_BAD_PARAMETERS;
     }
+    if ((config->transport) && (config->transport->transport))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_SENDER_TAG, "The transport instance is itself using a shared transport");
+        return ARSTREAM2_ERROR_BAD_PARAMETERS;
+    }
 
     streamSender = (ARSTREAM2_StreamSender_t*)malloc(sizeof(*streamSender));
     if (!streamSender)
@@ -114,6 +120,7 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
         memset(streamSender, 0, sizeof(*streamSender));
         streamSender->signalPipe[0] = -1;
         streamSender->signalPipe[1] = -1;
+        streamSender->transport = config->transport;
         streamSender->rtpStatsCallback = config->rtpStatsCallback;
         streamSender->rtpStatsCallbackUserPtr = config->rtpStatsCallbackUserPtr;
         streamSender->videoStatsCallback = config->videoStatsCallback;
@@ -205,7 +212,7 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
         {
             packetFifoItemCount = ARSTREAM2_STREAM_SENDER_DEFAULT_MIN_PACKET_FIFO_ITEM_COUNT;
         }
-        int packetFifoRet = ARSTREAM2_RTP_PacketFifoInit(&streamSender->packetFifo, packetFifoItemCount, packetFifoBufferCount, streamSender->maxPacketSize);
+        int packetFifoRet = ARSTREAM2_RTP_PacketFifoInit(&streamSender->packetFifo, packetFifoItemCount, packetFifoBufferCount, streamSender->maxPacketSize, 0, 0);
         if (packetFifoRet != 0)
         {
             ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_SENDER_TAG, "ARSTREAM2_RTP_PacketFifoAddQueue() failed (%d)", packetFifoRet);
@@ -226,6 +233,9 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
     if (ret == ARSTREAM2_OK)
     {
         ARSTREAM2_RtpSender_Config_t senderConfig;
+        ARSTREAM2_Clock_t clock;
+        clock.getTime = config->clockCallback;
+        clock.userPtr = config->clockCallbackUserPtr;
         memset(&senderConfig, 0, sizeof(senderConfig));
         senderConfig.canonicalName = config->canonicalName;
         senderConfig.friendlyName = config->friendlyName;
@@ -256,6 +266,10 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
         senderConfig.streamSocketSendBufferSize = streamSender->streamSocketSendBufferSize;
         senderConfig.maxBitrate = streamSender->maxBitrate;
         senderConfig.useRtpHeaderExtensions = config->useRtpHeaderExtensions;
+        senderConfig.ssrc = config->ssrc;
+        senderConfig.transport = (streamSender->transport) ? streamSender->transport->sender : NULL;
+        senderConfig.impairment = config->impairment;
+        senderConfig.clock = &clock;
         senderConfig.debugPath = streamSender->debugPath;
         senderConfig.dateAndTime = streamSender->dateAndTime;
 
@@ -287,6 +301,12 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Init(ARSTREAM2_StreamSender_Handle *stre
         }
     }
 
+    if ((ret == ARSTREAM2_OK) && (streamSender->transport))
+    {
+        /* the transport instance thread plays the role of the sender thread */
+        streamSender->threadStarted = 1;
+    }
+
     if (ret == ARSTREAM2_OK)
     {
         *streamSenderHandle = streamSender;
@@ -363,9 +383,15 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_Free(ARSTREAM2_StreamSender_Handle *stre
 
     streamSender = (ARSTREAM2_StreamSender_t*)*streamSenderHandle;
 
+    if (ARSTREAM2_RtpSender_GetSharedStreamCount(streamSender->sender) > 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, ARSTREAM2_STREAM_SENDER_TAG, "Free the instances sharing the transport before calling this function");
+        return ARSTREAM2_ERROR_BUSY;
+    }
+
     int canDelete = 0;
     ARSAL_Mutex_Lock(&(streamSender->threadMutex));
-    if (streamSender->threadStarted == 0)
+    if ((streamSender->threadStarted == 0) || ((streamSender->transport) && (streamSender->threadShouldStop)))
     {
         canDelete = 1;
     }
@@ -511,11 +537,13 @@ eARSTREAM2_ERROR ARSTREAM2_StreamSender_SendNNewNalu(ARSTREAM2_StreamSender_Hand
             }
         }
 
-        if (streamSender->signalPipe[1] != -1)
+        /* wake up the thread that sends the packets */
+        ARSTREAM2_StreamSender_t *thread = (streamSender->transport) ? streamSender->transport : streamSender;
+        if (thread->signalPipe[1] != -1)
         {
             char * buff = "x";
             ssize_t err;
-            while (((err = write(streamSender->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
+            while (((err = write(thread->signalPipe[1], buff, 1)) == -1) && (errno == EINTR));
         }
     }
 
@@ -554,6 +582,12 @@ void* ARSTREAM2_StreamSender_RunThread(void *streamSenderHandle)
         return (void*)NULL;
     }
 
+    if (streamSender->transport)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_INFO, ARSTREAM2_STREAM_SENDER_TAG, "Packets are sent by the transport instance thread");
+        return (void*)0;
+    }
+
     ARSAL_PRINT(ARSAL_PRINT_DEBUG, ARSTREAM2_STREAM_SENDER_TAG, "Sender thread running");
     ARSAL_Mutex_Lock(&(streamSender->threadMutex));
     streamSender->threadStarted = 1;
@@ -0,0 +1,408 @@
+/**
+ * @file arstream2_h264_parser_bench.c
+ * @brief Parrot Streaming Library - H.264 parser benchmark program
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <getopt.h>
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream2/arstream2_h264_parser.h>
+#include <libARStream2/arstream2_h264_writer.h>
+#include <libARStream2/arstream2_h264_sei.h>
+
+#include "arstream2_h264.h"
+
+
+#define TAG "ARSTREAM2_H264Parser_Bench"
+
+#define BENCH_DEFAULT_AU_COUNT (500)
+#define BENCH_DEFAULT_SLICE_COUNT (30)
+#define BENCH_DEFAULT_ROUNDS (20)
+#define BENCH_DEFAULT_SLICE_DATA_SIZE (1000)
+#define BENCH_MAX_SLICE_COUNT (ARSTREAM2_H264_SEI_PARROT_STREAMING_MAX_SLICE_COUNT)
+#define BENCH_USER_DATA_SIZE (64)
+#define BENCH_MAX_SLICE_DATA_SIZE (16384)
+#define BENCH_MAX_HEADER_SIZE (1024)
+#define BENCH_NALU_BUFFER_SIZE(_dataSize) (BENCH_MAX_HEADER_SIZE + (_dataSize) * 3 / 2 + 1)
+#define BENCH_MB_COUNT (80 * 45)
+
+
+/* High profile 1280x720 SPS with VUI and NAL HRD parameters, CAVLC PPS */
+static const uint8_t bench_sps[] =
+{
+    0x67, 0x64, 0x00, 0x1F, 0xAC, 0x2C, 0xA8, 0x05, 0x00, 0x5B, 0xA1, 0x00, 0x00, 0x03, 0x03, 0xE8,
+    0x00, 0x00, 0xEA, 0x60, 0xE4, 0x60, 0x00, 0xC3, 0x50, 0x00, 0x04, 0x93, 0xE2, 0xF7, 0xBE, 0x0A
+};
+static const uint8_t bench_pps[] = { 0x68, 0xCE, 0x3C, 0x80 };
+
+
+typedef struct
+{
+    uint8_t *nalu;
+    unsigned int naluSize;
+} bench_nalu_t;
+
+
+static const char short_options[] = "ha:s:d:r:";
+
+
+static const struct option
+long_options[] = {
+    { "help"            , no_argument        , NULL, 'h' },
+    { "au"              , required_argument  , NULL, 'a' },
+    { "slices"          , required_argument  , NULL, 's' },
+    { "data"            , required_argument  , NULL, 'd' },
+    { "rounds"          , required_argument  , NULL, 'r' },
+    { 0, 0, 0, 0 }
+};
+
+
+static void usage(int argc, char *argv[])
+{
+    printf("Usage: %s [options]\n"
+           "Options:\n"
+           "-h | --help                        Print this message\n"
+           "-a | --au <count>                  Number of access units in the stream (default %d)\n"
+           "-s | --slices <count>              Number of slices per access unit (default %d, max %d)\n"
+           "-d | --data <size>                 Slice data size in bytes (default %d, max %d)\n"
+           "-r | --rounds <count>              Number of parsing rounds (default %d)\n"
+           "\n",
+           argv[0], BENCH_DEFAULT_AU_COUNT, BENCH_DEFAULT_SLICE_COUNT, BENCH_MAX_SLICE_COUNT,
+           BENCH_DEFAULT_SLICE_DATA_SIZE, BENCH_MAX_SLICE_DATA_SIZE, BENCH_DEFAULT_ROUNDS);
+}
+
+
+/* Cycle counter if available, nanoseconds otherwise */
+static inline uint64_t getTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+/* Append pseudo-random slice data, with emulation prevention, so that the NALU sizes are realistic;
+ * the slice data is never parsed */
+static unsigned int appendSliceData(uint8_t *buf, int size, uint32_t *rng)
+{
+    unsigned int outSize = 0;
+    int i, zeroCount = 0;
+    uint8_t val;
+
+    for (i = 0; i < size; i++)
+    {
+        *rng = *rng * 1664525 + 1013904223;
+        val = (uint8_t)(*rng >> 24);
+        if ((*rng & 0xF000) == 0) val = 0;
+        if ((zeroCount >= 2) && (val <= 3))
+        {
+            buf[outSize++] = 0x03;
+            zeroCount = 0;
+        }
+        buf[outSize++] = val;
+        zeroCount = (val == 0) ? zeroCount + 1 : 0;
+    }
+    /* the last byte must not be zero */
+    buf[outSize++] = 0x80;
+
+    return outSize;
+}
+
+
+/* Generate the access units: SEI (picture timing, recovery point, user data) followed by the slices */
+static int generateStream(ARSTREAM2_H264Parser_Handle parser, bench_nalu_t *nalus, uint8_t *buf, int auCount, int sliceCount, int sliceDataSize)
+{
+    ARSTREAM2_H264Writer_Handle writer = NULL;
+    ARSTREAM2_H264Writer_Config_t writerConfig;
+    ARSTREAM2_H264Writer_PictureTimingSei_t pictureTiming;
+    ARSTREAM2_H264Writer_RecoveryPointSei_t recoveryPoint;
+    ARSTREAM2_H264_SliceContext_t sliceContext;
+    uint8_t userData[BENCH_USER_DATA_SIZE];
+    const uint8_t *pUserData[1] = { userData };
+    unsigned int userDataSize[1] = { BENCH_USER_DATA_SIZE };
+    void *spsContext = NULL, *ppsContext = NULL;
+    unsigned int outputSize;
+    eARSTREAM2_ERROR err;
+    uint32_t rng = 0x12345678;
+    int i, j, k, sliceMbCount, ret = 0;
+
+    err = ARSTREAM2_H264Parser_SetupNalu_buffer(parser, (void*)bench_sps, sizeof(bench_sps));
+    if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Parser_ParseNalu(parser, NULL);
+    if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Parser_SetupNalu_buffer(parser, (void*)bench_pps, sizeof(bench_pps));
+    if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Parser_ParseNalu(parser, NULL);
+    if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Parser_GetSpsPpsContext(parser, &spsContext, &ppsContext);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Failed to parse the SPS/PPS (%d)", err);
+        return -1;
+    }
+
+    memset(&writerConfig, 0, sizeof(writerConfig));
+    writerConfig.naluPrefix = 1;
+    err = ARSTREAM2_H264Writer_Init(&writer, &writerConfig);
+    if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Writer_SetSpsPpsContext(writer, spsContext, ppsContext);
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Failed to initialize the writer (%d)", err);
+        if (writer) ARSTREAM2_H264Writer_Free(writer);
+        return -1;
+    }
+
+    memset(&pictureTiming, 0, sizeof(pictureTiming));
+    memset(&recoveryPoint, 0, sizeof(recoveryPoint));
+    memset(&sliceContext, 0, sizeof(sliceContext));
+    for (k = 0; k < BENCH_USER_DATA_SIZE; k++)
+    {
+        userData[k] = (uint8_t)(k * 7);
+    }
+    sliceContext.nal_ref_idc = 2;
+    sliceContext.nal_unit_type = ARSTREAM2_H264_NALU_TYPE_SLICE;
+    sliceContext.slice_type = ARSTREAM2_H264_SLICE_TYPE_P_ALL;
+    sliceMbCount = (BENCH_MB_COUNT + sliceCount - 1) / sliceCount;
+
+    for (i = 0, k = 0; (i < auCount) && (ret == 0); i++)
+    {
+        pictureTiming.cpbRemovalDelay = 2;
+        pictureTiming.dpbOutputDelay = 4;
+        recoveryPoint.recoveryFrameCnt = i % 30;
+        err = ARSTREAM2_H264Writer_WriteSeiNalu(writer, &pictureTiming, &recoveryPoint, 1, pUserData, userDataSize,
+                                                buf, BENCH_MAX_HEADER_SIZE, &outputSize);
+        if (err != ARSTREAM2_OK)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_H264Writer_WriteSeiNalu() failed (%d)", err);
+            ret = -1;
+            break;
+        }
+        nalus[k].nalu = buf;
+        nalus[k++].naluSize = outputSize;
+        buf += outputSize;
+
+        sliceContext.frame_num = i & 0xFF;
+        sliceContext.pic_order_cnt_lsb = (i * 2) & 0xFF;
+        for (j = 0; j < sliceCount; j++)
+        {
+            err = ARSTREAM2_H264Writer_WriteSkippedPSliceNalu(writer, j * sliceMbCount,
+                                                              (j < sliceCount - 1) ? sliceMbCount : BENCH_MB_COUNT - j * sliceMbCount,
+                                                              &sliceContext, buf, BENCH_MAX_HEADER_SIZE, &outputSize);
+            if (err != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_H264Writer_WriteSkippedPSliceNalu() failed (%d)", err);
+                ret = -1;
+                break;
+            }
+            if (sliceDataSize > 0)
+            {
+                outputSize += appendSliceData(buf + outputSize, sliceDataSize, &rng);
+            }
+            nalus[k].nalu = buf;
+            nalus[k++].naluSize = outputSize;
+            buf += outputSize;
+        }
+    }
+
+    ARSTREAM2_H264Writer_Free(writer);
+
+    return ret;
+}
+
+
+/* Parse the access units as the H.264 filter does: the full slice context is only requested for the first slice */
+static int parseStream(ARSTREAM2_H264Parser_Handle parser, bench_nalu_t *nalus, int auCount, int sliceCount, int getSliceContext,
+                       ARSTREAM2_H264_SliceContext_t *firstSliceContexts, uint64_t *ticks)
+{
+    ARSTREAM2_H264Parser_SliceInfo_t sliceInfo;
+    void *sliceContext;
+    eARSTREAM2_ERROR err;
+    uint64_t t0;
+    int i, j, k;
+
+    for (i = 0, k = 0; i < auCount; i++)
+    {
+        t0 = getTicks();
+        for (j = 0; j < sliceCount + 1; j++, k++)
+        {
+            err = ARSTREAM2_H264Parser_SetupNalu_buffer(parser, nalus[k].nalu + 4, nalus[k].naluSize - 4);
+            if (err == ARSTREAM2_OK) err = ARSTREAM2_H264Parser_ParseNalu(parser, NULL);
+            if ((err == ARSTREAM2_OK) && (j > 0))
+            {
+                err = ARSTREAM2_H264Parser_GetSliceInfo(parser, &sliceInfo);
+                if ((err == ARSTREAM2_OK) && (sliceInfo.frame_num != (unsigned int)(i & 0xFF)))
+                {
+                    err = ARSTREAM2_ERROR_INVALID_STATE;
+                }
+                if ((err == ARSTREAM2_OK) && (j == 1) && (getSliceContext))
+                {
+                    err = ARSTREAM2_H264Parser_GetSliceContext(parser, &sliceContext);
+                    if ((err == ARSTREAM2_OK) && (firstSliceContexts))
+                    {
+                        memcpy(&firstSliceContexts[i], sliceContext, sizeof(ARSTREAM2_H264_SliceContext_t));
+                    }
+                }
+            }
+            if (err != ARSTREAM2_OK)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Parsing failed on NALU #%d (%d)", k, err);
+                return -1;
+            }
+        }
+        *ticks += getTicks() - t0;
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int idx, c, round;
+    int auCount = BENCH_DEFAULT_AU_COUNT;
+    int sliceCount = BENCH_DEFAULT_SLICE_COUNT;
+    int sliceDataSize = BENCH_DEFAULT_SLICE_DATA_SIZE;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+    ARSTREAM2_H264Parser_Handle fullParser = NULL, lazyParser = NULL;
+    ARSTREAM2_H264Parser_Config_t parserConfig;
+    ARSTREAM2_H264_SliceContext_t *fullContexts = NULL, *lazyContexts = NULL;
+    bench_nalu_t *nalus = NULL;
+    uint8_t *streamBuf = NULL;
+    uint64_t fullTicks = 0, lazyTicks = 0, lazyFilterTicks = 0;
+    uint64_t parsedAuCount;
+    eARSTREAM2_ERROR err;
+
+    printf("ARStream2 H.264 Parser Benchmark\n\n");
+
+    while ((c = getopt_long(argc, argv, short_options, long_options, &idx)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+                break;
+
+            case 'h':
+                usage(argc, argv);
+                exit(0);
+                break;
+
+            case 'a':
+                sscanf(optarg, "%d", &auCount);
+                break;
+
+            case 's':
+                sscanf(optarg, "%d", &sliceCount);
+                break;
+
+            case 'd':
+                sscanf(optarg, "%d", &sliceDataSize);
+                break;
+
+            case 'r':
+                sscanf(optarg, "%d", &rounds);
+                break;
+
+            default:
+                usage(argc, argv);
+                exit(-1);
+                break;
+        }
+    }
+
+    if ((auCount <= 0) || (sliceCount <= 0) || (sliceCount > BENCH_MAX_SLICE_COUNT)
+            || (sliceDataSize < 0) || (sliceDataSize > BENCH_MAX_SLICE_DATA_SIZE) || (rounds <= 0))
+    {
+        usage(argc, argv);
+        exit(-1);
+    }
+
+    memset(&parserConfig, 0, sizeof(parserConfig));
+    parserConfig.extractUserDataSei = 1;
+    err = ARSTREAM2_H264Parser_Init(&fullParser, &parserConfig);
+    if (err == ARSTREAM2_OK)
+    {
+        parserConfig.lazyParsing = 1;
+        err = ARSTREAM2_H264Parser_Init(&lazyParser, &parserConfig);
+    }
+    if (err != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_H264Parser_Init() failed (%d)", err);
+        failed = 1;
+    }
+
+    if (!failed)
+    {
+        nalus = malloc(auCount * (sliceCount + 1) * sizeof(bench_nalu_t));
+        streamBuf = malloc((size_t)auCount * (sliceCount + 1) * BENCH_NALU_BUFFER_SIZE(sliceDataSize));
+        fullContexts = malloc(auCount * sizeof(ARSTREAM2_H264_SliceContext_t));
+        lazyContexts = malloc(auCount * sizeof(ARSTREAM2_H264_SliceContext_t));
+        if ((!nalus) || (!streamBuf) || (!fullContexts) || (!lazyContexts))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Allocation failed");
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        /* the lazy parser needs the SPS/PPS too */
+        if ((generateStream(fullParser, nalus, streamBuf, auCount, sliceCount, sliceDataSize) != 0)
+                || (ARSTREAM2_H264Parser_SetupNalu_buffer(lazyParser, (void*)bench_sps, sizeof(bench_sps)) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Parser_ParseNalu(lazyParser, NULL) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Parser_SetupNalu_buffer(lazyParser, (void*)bench_pps, sizeof(bench_pps)) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Parser_ParseNalu(lazyParser, NULL) != ARSTREAM2_OK))
+        {
+            failed = 1;
+        }
+    }
+
+    /* the on-demand full parse must give the same slice context as the full parse */
+    if ((!failed) && ((parseStream(fullParser, nalus, auCount, sliceCount, 1, fullContexts, &fullTicks) != 0)
+            || (parseStream(lazyParser, nalus, auCount, sliceCount, 1, lazyContexts, &lazyFilterTicks) != 0)
+            || (memcmp(fullContexts, lazyContexts, auCount * sizeof(ARSTREAM2_H264_SliceContext_t)) != 0)))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Lazy parsing slice context mismatch");
+        failed = 1;
+    }
+
+    fullTicks = lazyTicks = lazyFilterTicks = 0;
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        if ((parseStream(fullParser, nalus, auCount, sliceCount, 0, NULL, &fullTicks) != 0)
+                || (parseStream(lazyParser, nalus, auCount, sliceCount, 0, NULL, &lazyTicks) != 0)
+                || (parseStream(lazyParser, nalus, auCount, sliceCount, 1, NULL, &lazyFilterTicks) != 0))
+        {
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        parsedAuCount = (uint64_t)auCount * rounds;
+#if defined(__x86_64__) || defined(__i386__)
+        printf("%d slices per AU, %d bytes of slice data, unit: TSC cycles per AU\n", sliceCount, sliceDataSize);
+#else
+        printf("%d slices per AU, %d bytes of slice data, unit: ns per AU\n", sliceCount, sliceDataSize);
+#endif
+        printf("Full parsing:                    %.0f\n", (double)fullTicks / parsedAuCount);
+        printf("Lazy parsing:                    %.0f\n", (double)lazyTicks / parsedAuCount);
+        printf("Lazy parsing + 1 slice context:  %.0f\n", (double)lazyFilterTicks / parsedAuCount);
+    }
+
+    free(nalus);
+    free(streamBuf);
+    free(fullContexts);
+    free(lazyContexts);
+    if (fullParser) ARSTREAM2_H264Parser_Free(fullParser);
+    if (lazyParser) ARSTREAM2_H264Parser_Free(lazyParser);
+
+    return (failed) ? -1 : 0;
+}
@@ -0,0 +1,1346 @@
+/**
+ * @file arstream2_loopback_bench.c
+ * @brief Parrot Streaming Library - Loopback end-to-end benchmark program
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARSAL/ARSAL_Time.h>
+#include <libARSAL/ARSAL_Thread.h>
+#include <libARSAL/ARSAL_Mutex.h>
+
+#include <libARStream2/arstream2_stream_sender.h>
+#include <libARStream2/arstream2_stream_receiver.h>
+#include <libARStream2/arstream2_h264_generator.h>
+
+
+#define TAG "ARSTREAM2_Loopback_Bench"
+
+#define BENCH_DEFAULT_WIDTH (1280)
+#define BENCH_DEFAULT_HEIGHT (720)
+#define BENCH_DEFAULT_FRAMERATE (30)
+#define BENCH_DEFAULT_BITRATE (4000)
+#define BENCH_DEFAULT_SLICE_COUNT (1)
+#define BENCH_DEFAULT_STREAM_COUNT (1)
+#define BENCH_DEFAULT_DURATION (10)
+#define BENCH_DEFAULT_GOP_LENGTH (30)
+#define BENCH_DEFAULT_MAX_PACKET_SIZE (1500)
+#define BENCH_DEFAULT_BASE_PORT (59000)
+#define BENCH_MAX_STREAM_COUNT (16)
+#define BENCH_MONITORING_INTERVAL_US (1000000)
+#define BENCH_STARTUP_TIME_US (100000)
+#define BENCH_DRAIN_TIME_US (500000)
+#define BENCH_SEND_HISTORY_SIZE (256)
+#define BENCH_RTP_CLOCK_RATE (90000)
+#define BENCH_ENGINE_MIN_STREAM_COUNT (4)
+#define BENCH_SSRC_BASE (0x4c420000)
+#define BENCH_RELAY_COUNT (2)
+#define BENCH_RELAY_MAX_LATENCY_MS (200)
+#define BENCH_SIM_START_TIME_US (1000000000)
+#define BENCH_SIM_DELIVERY_TIMEOUT_US (1000000)
+#define BENCH_SIM_WAIT_MS (10)
+#define BENCH_RTCP_MIN_INTERVAL_US (100000)
+
+
+/* Pre-built access unit: the sender only references the NAL units */
+typedef struct
+{
+    int isIdr;
+    uint8_t *buffer;
+    unsigned int size;
+    ARSTREAM2_StreamSender_H264NaluDesc_t *nalu;
+    unsigned int naluCount;
+
+} bench_au_t;
+
+
+/* Access unit send time, keyed by RTP timestamp */
+typedef struct
+{
+    uint32_t rtpTimestamp;
+    uint64_t sendTime;
+
+} bench_send_time_t;
+
+
+/* Simulated clock: the time only moves when the feeding thread advances it */
+typedef struct
+{
+    ARSAL_Mutex_t mutex;
+    ARSAL_Cond_t cond;
+    uint64_t time;
+
+} bench_clock_t;
+
+
+typedef struct
+{
+    void* (*run)(void*);
+    void *handle;
+    ARSAL_Thread_t thread;
+    uint64_t cpuTime;
+
+} bench_thread_t;
+
+
+typedef struct
+{
+    int index;
+    ARSTREAM2_StreamSender_Handle sender;
+    ARSTREAM2_StreamReceiver_Handle receiver;
+    bench_thread_t senderThread;
+    bench_thread_t receiverThread;
+    bench_thread_t appOutputThread;
+    uint8_t *auBuffer;
+    int auBufferSize;
+    bench_clock_t *clock;
+
+    /* send times (written in the feeding thread, read in the app output thread) */
+    ARSAL_Mutex_t sendHistoryMutex;
+    int sendHistoryMutexInit;
+    bench_send_time_t sendHistory[BENCH_SEND_HISTORY_SIZE];
+    unsigned int sendHistoryIndex;
+
+    /* receiver statistics (updated in the app output thread) */
+    uint64_t auCount;
+    uint64_t auByteCount;
+    uint64_t incompleteAuCount;
+    uint64_t errorAuCount;
+    uint32_t *latency;
+    int latencyCount;
+    int latencyMaxCount;
+    uint64_t lastDeliveryTime;
+
+    /* receiver report statistics (updated in the sender thread) */
+    uint64_t rrCount;
+    uint64_t rrLastTime;
+    uint32_t rrMinInterval;
+    uint32_t rrMaxInterval;
+
+    /* sender statistics */
+    uint64_t packetsSent;
+    uint64_t bytesSent;
+    uint64_t packetsDropped;
+    uint64_t monitoringTime;
+
+} bench_stream_t;
+
+
+static const char short_options[] = "hW:H:f:b:s:n:d:g:m:p:te:Tj:S:l:B:D:J:R:U:r:";
+
+
+static const struct option
+long_options[] = {
+    { "help"            , no_argument        , NULL, 'h' },
+    { "width"           , required_argument  , NULL, 'W' },
+    { "height"          , required_argument  , NULL, 'H' },
+    { "framerate"       , required_argument  , NULL, 'f' },
+    { "bitrate"         , required_argument  , NULL, 'b' },
+    { "slices"          , required_argument  , NULL, 's' },
+    { "streams"         , required_argument  , NULL, 'n' },
+    { "duration"        , required_argument  , NULL, 'd' },
+    { "gop"             , required_argument  , NULL, 'g' },
+    { "mtu"             , required_argument  , NULL, 'm' },
+    { "port"            , required_argument  , NULL, 'p' },
+    { "filter-thread"   , no_argument        , NULL, 't' },
+    { "engine"          , required_argument  , NULL, 'e' },
+    { "simulated-time"  , no_argument        , NULL, 'T' },
+    { "seed"            , required_argument  , NULL, 'S' },
+    { "loss"            , required_argument  , NULL, 'l' },
+    { "burst"           , required_argument  , NULL, 'B' },
+    { "delay"           , required_argument  , NULL, 'D' },
+    { "jitter"          , required_argument  , NULL, 'J' },
+    { "reorder"         , required_argument  , NULL, 'R' },
+    { "duplicate"       , required_argument  , NULL, 'U' },
+    { "rate"            , required_argument  , NULL, 'r' },
+    { "json"            , required_argument  , NULL, 'j' },
+    { 0, 0, 0, 0 }
+};
+
+
+static void usage(int argc, char *argv[])
+{
+    (void)argc;
+
+    printf("Usage: %s [options]\n"
+           "Options:\n"
+           "-h | --help                        Print this message\n"
+           "-W | --width <pixels>              Video width (default %d)\n"
+           "-H | --height <pixels>             Video height (default %d)\n"
+           "-f | --framerate <fps>             Video framerate (default %d)\n"
+           "-b | --bitrate <kbit/s>            Video bitrate per stream (default %d)\n"
+           "-s | --slices <count>              Number of slices per frame (default %d)\n"
+           "-n | --streams <count>             Number of concurrent streams (default %d, max %d)\n"
+           "-d | --duration <seconds>          Streaming duration (default %d)\n"
+           "-g | --gop <frames>                IDR period in frames (default %d)\n"
+           "-m | --mtu <bytes>                 Maximum network packet size (default %d)\n"
+           "-p | --port <port>                 First UDP port, each stream uses 4 ports (default %d)\n"
+           "-t | --filter-thread               Run the receiver H.264 filter in a dedicated thread\n"
+           "-e | --engine <workers>            Run the first half of the streams in an engine with sharded ingest,\n"
+           "                                   the other half over a shared transport, and relay the first stream\n"
+           "                                   to %d resender destinations (at least %d streams)\n"
+           "-T | --simulated-time              Drive the senders and receivers from a simulated clock advanced\n"
+           "                                   frame by frame once every stream has received the previous frame,\n"
+           "                                   and check the RTCP receiver report timing in simulated time\n"
+           "                                   (not compatible with the engine and network impairment options)\n"
+           "-S | --seed <seed>                 Network impairment random seed (default 0)\n"
+           "-l | --loss <percent>              Random packet loss\n"
+           "-B | --burst <p>,<r>[,<h>]         Gilbert-Elliott burst loss: good to bad and bad to good transition\n"
+           "                                   percentages and loss percentage in the bad state (default 100)\n"
+           "-D | --delay <ms>                  Network delay\n"
+           "-J | --jitter <ms>                 Network delay jitter\n"
+           "-R | --reorder <percent>           Packets skipping the delay\n"
+           "-U | --duplicate <percent>         Duplicated packets\n"
+           "-r | --rate <kbit/s>               Network rate limit\n"
+           "-j | --json <file>                 Write the results as JSON to a file ('-' for stdout)\n"
+           "\n",
+           argv[0], BENCH_DEFAULT_WIDTH, BENCH_DEFAULT_HEIGHT, BENCH_DEFAULT_FRAMERATE, BENCH_DEFAULT_BITRATE,
+           BENCH_DEFAULT_SLICE_COUNT, BENCH_DEFAULT_STREAM_COUNT, BENCH_MAX_STREAM_COUNT, BENCH_DEFAULT_DURATION,
+           BENCH_DEFAULT_GOP_LENGTH, BENCH_DEFAULT_MAX_PACKET_SIZE, BENCH_DEFAULT_BASE_PORT,
+           BENCH_RELAY_COUNT, BENCH_ENGINE_MIN_STREAM_COUNT);
+}
+
+
+static inline uint64_t getTimeUs(void)
+{
+    struct timespec ts;
+    ARSAL_Time_GetTime(&ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+
+static inline uint64_t getThreadCpuTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+
+static uint64_t getProcessCpuTimeUs(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+            + (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+
+static long getPeakRssKiB(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+static uint64_t simClockGetTime(void *userPtr)
+{
+    bench_clock_t *clock = (bench_clock_t*)userPtr;
+    uint64_t t;
+
+    ARSAL_Mutex_Lock(&clock->mutex);
+    t = clock->time;
+    ARSAL_Mutex_Unlock(&clock->mutex);
+
+    return t;
+}
+
+
+static void simClockSetTime(bench_clock_t *clock, uint64_t t)
+{
+    ARSAL_Mutex_Lock(&clock->mutex);
+    clock->time = t;
+    ARSAL_Mutex_Unlock(&clock->mutex);
+}
+
+
+/* Current time of the bench, in the timebase given to the library */
+static inline uint64_t getBenchTimeUs(bench_clock_t *clock)
+{
+    return (clock) ? simClockGetTime(clock) : getTimeUs();
+}
+
+
+static void freeGop(bench_au_t *gop, int gopLength)
+{
+    int i;
+
+    if (!gop)
+    {
+        return;
+    }
+    for (i = 0; i < 2 * gopLength; i++)
+    {
+        free(gop[i].buffer);
+        free(gop[i].nalu);
+    }
+    free(gop);
+}
+
+
+/* Generate the access units shared by all the streams; two GOPs are
+ * generated so that the idr_pic_id alternates when looping */
+static bench_au_t* buildGop(int gopLength, int width, int height, int framerate, int bitrate, int sliceCount, int *maxAuSize, int *maxNaluCount)
+{
+    ARSTREAM2_H264Generator_Handle generator = NULL;
+    ARSTREAM2_H264Generator_Config_t generatorConfig;
+    bench_au_t *gop;
+    unsigned int auSize, naluCount;
+    int i, ret = 0;
+
+    memset(&generatorConfig, 0, sizeof(generatorConfig));
+    generatorConfig.width = width;
+    generatorConfig.height = height;
+    generatorConfig.framerate = (float)framerate;
+    generatorConfig.bitrate = bitrate * 1000;
+    generatorConfig.sliceCount = sliceCount;
+    generatorConfig.gopLength = gopLength;
+    generatorConfig.streamingInfoSei = 1;
+    if (ARSTREAM2_H264Generator_Init(&generator, &generatorConfig) != ARSTREAM2_OK)
+    {
+        return NULL;
+    }
+    ARSTREAM2_H264Generator_GetMaxAuSize(generator, &auSize, &naluCount);
+    *maxAuSize = (int)auSize;
+    *maxNaluCount = (int)naluCount;
+
+    gop = calloc(2 * gopLength, sizeof(bench_au_t));
+    for (i = 0; (gop) && (i < 2 * gopLength) && (ret == 0); i++)
+    {
+        gop[i].buffer = malloc(auSize);
+        gop[i].nalu = calloc(naluCount, sizeof(ARSTREAM2_StreamSender_H264NaluDesc_t));
+        if ((!gop[i].buffer) || (!gop[i].nalu)
+                || (ARSTREAM2_H264Generator_GenerateAu(generator, 0, gop[i].buffer, auSize, &gop[i].size,
+                                                       gop[i].nalu, naluCount, &gop[i].naluCount, &gop[i].isIdr) != ARSTREAM2_OK))
+        {
+            ret = -1;
+        }
+    }
+
+    ARSTREAM2_H264Generator_Free(generator);
+    if ((!gop) || (ret != 0))
+    {
+        freeGop(gop, gopLength);
+        return NULL;
+    }
+
+    return gop;
+}
+
+
+static void* benchThreadRun(void *arg)
+{
+    bench_thread_t *t = (bench_thread_t*)arg;
+
+    t->run(t->handle);
+    t->cpuTime = getThreadCpuTimeUs();
+
+    return NULL;
+}
+
+
+static int benchThreadStart(bench_thread_t *t, void* (*run)(void*), void *handle)
+{
+    t->run = run;
+    t->handle = handle;
+    t->cpuTime = 0;
+    return ARSAL_Thread_Create(&t->thread, benchThreadRun, t);
+}
+
+
+static void benchThreadJoin(bench_thread_t *t)
+{
+    if (t->thread)
+    {
+        ARSAL_Thread_Join(t->thread, NULL);
+        ARSAL_Thread_Destroy(&t->thread);
+    }
+}
+
+
+/* RTP timestamp of an access unit timestamp, as computed by the sender */
+static inline uint32_t getRtpTimestamp(uint64_t auTimestamp)
+{
+    return (uint32_t)((auTimestamp * BENCH_RTP_CLOCK_RATE + 500000) / 1000000);
+}
+
+
+static void recordSendTime(bench_stream_t *stream, uint64_t auTimestamp)
+{
+    ARSAL_Mutex_Lock(&stream->sendHistoryMutex);
+    stream->sendHistory[stream->sendHistoryIndex].rtpTimestamp = getRtpTimestamp(auTimestamp);
+    stream->sendHistory[stream->sendHistoryIndex].sendTime = auTimestamp;
+    stream->sendHistoryIndex = (stream->sendHistoryIndex + 1) % BENCH_SEND_HISTORY_SIZE;
+    ARSAL_Mutex_Unlock(&stream->sendHistoryMutex);
+}
+
+
+static uint64_t getSendTime(bench_stream_t *stream, uint32_t rtpTimestamp)
+{
+    uint64_t sendTime = 0;
+    unsigned int i, idx;
+
+    /* search from the most recent access unit */
+    ARSAL_Mutex_Lock(&stream->sendHistoryMutex);
+    for (i = 0, idx = stream->sendHistoryIndex; i < BENCH_SEND_HISTORY_SIZE; i++)
+    {
+        idx = (idx + BENCH_SEND_HISTORY_SIZE - 1) % BENCH_SEND_HISTORY_SIZE;
+        if ((stream->sendHistory[idx].sendTime != 0) && (stream->sendHistory[idx].rtpTimestamp == rtpTimestamp))
+        {
+            sendTime = stream->sendHistory[idx].sendTime;
+            break;
+        }
+    }
+    ARSAL_Mutex_Unlock(&stream->sendHistoryMutex);
+
+    return sendTime;
+}
+
+
+static eARSTREAM2_ERROR getAuBufferCallback(uint8_t **auBuffer, int *auBufferSize, void **auBufferUserPtr, void *userPtr)
+{
+    bench_stream_t *stream = (bench_stream_t*)userPtr;
+
+    *auBuffer = stream->auBuffer;
+    *auBufferSize = stream->auBufferSize;
+    *auBufferUserPtr = NULL;
+
+    return ARSTREAM2_OK;
+}
+
+
+static eARSTREAM2_ERROR auReadyCallback(uint8_t *auBuffer, int auSize, ARSTREAM2_StreamReceiver_AuReadyCallbackTimestamps_t *auTimestamps,
+                                        eARSTREAM2_STREAM_RECEIVER_AU_SYNC_TYPE auSyncType, ARSTREAM2_StreamReceiver_AuReadyCallbackMetadata_t *auMetadata,
+                                        void *auBufferUserPtr, void *userPtr)
+{
+    bench_stream_t *stream = (bench_stream_t*)userPtr;
+    uint64_t now = getBenchTimeUs(stream->clock), sendTime;
+
+    (void)auBuffer;
+    (void)auSyncType;
+    (void)auBufferUserPtr;
+
+    stream->auCount++;
+    stream->auByteCount += auSize;
+    if (!auMetadata->isComplete)
+    {
+        stream->incompleteAuCount++;
+    }
+    /* the macroblocks of unknown status (before the first IDR frame) are not errors */
+    if (auMetadata->mbStatus)
+    {
+        int k, mbCount = auMetadata->mbWidth * auMetadata->mbHeight;
+        for (k = 0; k < mbCount; k++)
+        {
+            if ((auMetadata->mbStatus[k] == ARSTREAM2_STREAM_STATS_MACROBLOCK_STATUS_MISSING_CONCEALED)
+                    || (auMetadata->mbStatus[k] == ARSTREAM2_STREAM_STATS_MACROBLOCK_STATUS_MISSING)
+                    || (auMetadata->mbStatus[k] == ARSTREAM2_STREAM_STATS_MACROBLOCK_STATUS_ERROR_PROPAGATION))
+            {
+                stream->errorAuCount++;
+                break;
+            }
+        }
+    }
+
+    /* the sender and the receiver share the clock: the send time is found
+     * from the RTP timestamp, recovered from the raw NTP timestamp */
+    sendTime = getSendTime(stream, getRtpTimestamp(auTimestamps->auNtpTimestampRaw));
+    if (stream->clock)
+    {
+        /* the feeding thread waits for the delivery before advancing the time */
+        ARSAL_Mutex_Lock(&stream->clock->mutex);
+    }
+    if ((sendTime != 0) && (now >= sendTime) && (stream->latencyCount < stream->latencyMaxCount))
+    {
+        stream->latency[stream->latencyCount++] = (uint32_t)(now - sendTime);
+        stream->lastDeliveryTime = sendTime;
+    }
+    if (stream->clock)
+    {
+        ARSAL_Cond_Broadcast(&stream->clock->cond);
+        ARSAL_Mutex_Unlock(&stream->clock->mutex);
+    }
+
+    return ARSTREAM2_OK;
+}
+
+
+static void rtpStatsCallback(const ARSTREAM2_StreamStats_RtpStats_t *rtpStats, void *userPtr)
+{
+    bench_stream_t *stream = (bench_stream_t*)userPtr;
+    uint32_t interval;
+
+    /* the timestamp is the receiver report reception time */
+    if ((stream->rrCount > 0) && (rtpStats->timestamp >= stream->rrLastTime))
+    {
+        interval = (uint32_t)(rtpStats->timestamp - stream->rrLastTime);
+        if ((stream->rrCount == 1) || (interval < stream->rrMinInterval))
+        {
+            stream->rrMinInterval = interval;
+        }
+        if (interval > stream->rrMaxInterval)
+        {
+            stream->rrMaxInterval = interval;
+        }
+    }
+    stream->rrLastTime = rtpStats->timestamp;
+    stream->rrCount++;
+}
+
+
+/* Wait until every stream has received the access unit sent at the given
+ * time, or until the delivery timeout in wall time; returns 0 on success */
+static int simWaitDelivery(bench_clock_t *clock, bench_stream_t *stream, int streamCount, uint64_t sendTime)
+{
+    uint64_t deadline = getTimeUs() + BENCH_SIM_DELIVERY_TIMEOUT_US;
+    int i, delivered = 0;
+
+    ARSAL_Mutex_Lock(&clock->mutex);
+    while (!delivered)
+    {
+        for (i = 0, delivered = 1; i < streamCount; i++)
+        {
+            if (stream[i].lastDeliveryTime < sendTime)
+            {
+                delivered = 0;
+                break;
+            }
+        }
+        if ((!delivered) && (getTimeUs() >= deadline))
+        {
+            break;
+        }
+        if (!delivered)
+        {
+            ARSAL_Cond_Timedwait(&clock->cond, &clock->mutex, BENCH_SIM_WAIT_MS);
+        }
+    }
+    ARSAL_Mutex_Unlock(&clock->mutex);
+
+    return (delivered) ? 0 : -1;
+}
+
+
+static void pollSenderMonitoring(bench_stream_t *stream, uint32_t interval)
+{
+    ARSTREAM2_StreamSender_MonitoringData_t monitoring;
+
+    memset(&monitoring, 0, sizeof(monitoring));
+    if (ARSTREAM2_StreamSender_GetMonitoring(stream->sender, 0, interval, &monitoring) == ARSTREAM2_OK)
+    {
+        stream->packetsSent += monitoring.packetsSent;
+        stream->bytesSent += monitoring.bytesSent;
+        stream->packetsDropped += monitoring.packetsDropped;
+        stream->monitoringTime += monitoring.timeInterval;
+    }
+}
+
+
+/* Start a receiver fed by a resender of the source receiver; the relay
+ * receiver has no sender, hence no latency samples */
+static int startRelay(bench_stream_t *relay, ARSTREAM2_StreamReceiver_Handle source, ARSTREAM2_StreamReceiver_ResenderHandle *resender,
+                      int port, int maxPacketSize, int maxAuSize)
+{
+    ARSTREAM2_StreamReceiver_Config_t receiverConfig;
+    ARSTREAM2_StreamReceiver_NetConfig_t receiverNetConfig;
+    ARSTREAM2_StreamReceiver_ResenderConfig_t resenderConfig;
+    eARSTREAM2_ERROR err;
+
+    relay->auBufferSize = maxAuSize * 2;
+    relay->auBuffer = malloc(relay->auBufferSize);
+    relay->sendHistoryMutexInit = (ARSAL_Mutex_Init(&relay->sendHistoryMutex) == 0) ? 1 : 0;
+    if ((!relay->auBuffer) || (!relay->sendHistoryMutexInit))
+    {
+        fprintf(stderr, "Relay %d allocation failed\n", relay->index);
+        return -1;
+    }
+
+    memset(&receiverConfig, 0, sizeof(receiverConfig));
+    memset(&receiverNetConfig, 0, sizeof(receiverNetConfig));
+    receiverConfig.canonicalName = "ARStream2LoopbackBenchRelay";
+    receiverConfig.maxPacketSize = maxPacketSize;
+    receiverConfig.generateReceiverReports = 1;
+    receiverNetConfig.serverAddr = "127.0.0.1";
+    receiverNetConfig.serverStreamPort = port;
+    receiverNetConfig.serverControlPort = port + 1;
+    receiverNetConfig.clientStreamPort = port + 2;
+    receiverNetConfig.clientControlPort = port + 3;
+    err = ARSTREAM2_StreamReceiver_Init(&relay->receiver, &receiverConfig, &receiverNetConfig, NULL);
+    if (err != ARSTREAM2_OK)
+    {
+        fprintf(stderr, "Relay %d: receiver initialization failed (%s)\n", relay->index, ARSTREAM2_Error_ToString(err));
+        return -1;
+    }
+
+    err = ARSTREAM2_StreamReceiver_StartAppOutput(relay->receiver, NULL, NULL, getAuBufferCallback, relay,
+                                                  auReadyCallback, relay);
+    if ((err != ARSTREAM2_OK)
+            || (benchThreadStart(&relay->receiverThread, ARSTREAM2_StreamReceiver_RunNetworkThread, relay->receiver) != 0)
+            || (benchThreadStart(&relay->appOutputThread, ARSTREAM2_StreamReceiver_RunAppOutputThread, relay->receiver) != 0))
+    {
+        fprintf(stderr, "Relay %d: failed to start\n", relay->index);
+        return -1;
+    }
+
+    memset(&resenderConfig, 0, sizeof(resenderConfig));
+    resenderConfig.canonicalName = "ARStream2LoopbackBenchResender";
+    resenderConfig.clientAddr = "127.0.0.1";
+    resenderConfig.serverStreamPort = port;
+    resenderConfig.serverControlPort = port + 1;
+    resenderConfig.clientStreamPort = port + 2;
+    resenderConfig.clientControlPort = port + 3;
+    resenderConfig.maxNetworkLatencyMs = BENCH_RELAY_MAX_LATENCY_MS;
+    err = ARSTREAM2_StreamReceiver_StartResender(source, resender, &resenderConfig);
+    if (err != ARSTREAM2_OK)
+    {
+        fprintf(stderr, "Relay %d: resender start failed (%s)\n", relay->index, ARSTREAM2_Error_ToString(err));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int compareLatency(const void *a, const void *b)
+{
+    uint32_t la = *(const uint32_t*)a, lb = *(const uint32_t*)b;
+    return (la > lb) - (la < lb);
+}
+
+
+static uint32_t percentile(const uint32_t *sorted, int count, int pct)
+{
+    int idx;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    idx = (int)(((int64_t)count * pct + 99) / 100) - 1;
+    if (idx < 0)
+    {
+        idx = 0;
+    }
+    return sorted[(idx < count) ? idx : count - 1];
+}
+
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int idx, c, i, k;
+    int width = BENCH_DEFAULT_WIDTH, height = BENCH_DEFAULT_HEIGHT;
+    int framerate = BENCH_DEFAULT_FRAMERATE, bitrate = BENCH_DEFAULT_BITRATE;
+    int sliceCount = BENCH_DEFAULT_SLICE_COUNT, streamCount = BENCH_DEFAULT_STREAM_COUNT;
+    int duration = BENCH_DEFAULT_DURATION, gopLength = BENCH_DEFAULT_GOP_LENGTH;
+    int maxPacketSize = BENCH_DEFAULT_MAX_PACKET_SIZE, basePort = BENCH_DEFAULT_BASE_PORT;
+    int filterThread = 0, frameCount, maxAuSize = 0, maxNaluCount = 0, naluDescCount;
+    int engineWorkerCount = 0, engineStreamCount = 0, ingestPort = 0, relayCount = 0;
+    int simulatedTime = 0, simDeliveryTimeoutCount = 0;
+    bench_clock_t simClock, *benchClock = NULL;
+    const char *jsonFileName = NULL;
+    ARSTREAM2_NetImpairment_Config_t impairment;
+    int useImpairment = 0;
+    bench_stream_t stream[BENCH_MAX_STREAM_COUNT];
+    bench_stream_t relay[BENCH_RELAY_COUNT];
+    ARSTREAM2_StreamReceiver_ResenderHandle resender[BENCH_RELAY_COUNT];
+    ARSTREAM2_StreamReceiverEngine_Handle engine = NULL;
+    bench_au_t *gop = NULL;
+    ARSTREAM2_StreamSender_H264NaluDesc_t *naluDesc = NULL;
+    uint64_t startTime, frameTime, nextMonitoringTime, now, elapsed = 0, wallStartTime, wallElapsed = 0;
+    uint64_t processCpuStart = 0, feederCpuStart, feederCpu = 0, senderCpu, receiverCpu;
+    uint64_t framesSent = 0, auCount = 0, auByteCount = 0, incompleteAuCount = 0, errorAuCount = 0;
+    uint64_t relayAuCount = 0, relayErrorAuCount = 0, rrCount = 0;
+    uint32_t rrMinInterval = 0, rrMaxInterval = 0;
+    uint64_t packetsSent = 0, bytesSent = 0, packetsDropped = 0, monitoringTime = 0;
+    uint32_t *latency = NULL;
+    int latencyCount = 0;
+    long rssStart, rssPeak = 0;
+    double mbits;
+    FILE *json = NULL;
+
+    memset(stream, 0, sizeof(stream));
+    memset(relay, 0, sizeof(relay));
+    memset(resender, 0, sizeof(resender));
+    memset(&impairment, 0, sizeof(impairment));
+    memset(&simClock, 0, sizeof(simClock));
+    impairment.burstLossProbability = 1.;
+
+    printf("ARStream2 Loopback Benchmark\n\n");
+
+    while ((c = getopt_long(argc, argv, short_options, long_options, &idx)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+                break;
+
+            case 'h':
+                usage(argc, argv);
+                exit(0);
+                break;
+
+            case 'W':
+                width = atoi(optarg);
+                break;
+
+            case 'H':
+                height = atoi(optarg);
+                break;
+
+            case 'f':
+                framerate = atoi(optarg);
+                break;
+
+            case 'b':
+                bitrate = atoi(optarg);
+                break;
+
+            case 's':
+                sliceCount = atoi(optarg);
+                break;
+
+            case 'n':
+                streamCount = atoi(optarg);
+                break;
+
+            case 'd':
+                duration = atoi(optarg);
+                break;
+
+            case 'g':
+                gopLength = atoi(optarg);
+                break;
+
+            case 'm':
+                maxPacketSize = atoi(optarg);
+                break;
+
+            case 'p':
+                basePort = atoi(optarg);
+                break;
+
+            case 't':
+                filterThread = 1;
+                break;
+
+            case 'e':
+                engineWorkerCount = atoi(optarg);
+                break;
+
+            case 'T':
+                simulatedTime = 1;
+                break;
+
+            case 'j':
+                jsonFileName = optarg;
+                break;
+
+            case 'S':
+                impairment.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'l':
+                impairment.lossProbability = atof(optarg) / 100.;
+                useImpairment = 1;
+                break;
+
+            case 'B':
+            {
+                float p = 0., r = 0., h = 100.;
+                if (sscanf(optarg, "%f,%f,%f", &p, &r, &h) < 2)
+                {
+                    usage(argc, argv);
+                    exit(1);
+                }
+                impairment.burstStartProbability = p / 100.;
+                impairment.burstEndProbability = r / 100.;
+                impairment.burstLossProbability = h / 100.;
+                useImpairment = 1;
+                break;
+            }
+
+            case 'D':
+                impairment.delayUs = (uint32_t)(atof(optarg) * 1000.);
+                useImpairment = 1;
+                break;
+
+            case 'J':
+                impairment.jitterUs = (uint32_t)(atof(optarg) * 1000.);
+                useImpairment = 1;
+                break;
+
+            case 'R':
+                impairment.reorderProbability = atof(optarg) / 100.;
+                useImpairment = 1;
+                break;
+
+            case 'U':
+                impairment.duplicateProbability = atof(optarg) / 100.;
+                useImpairment = 1;
+                break;
+
+            case 'r':
+                impairment.rateLimit = (uint32_t)(atof(optarg) * 1000.);
+                useImpairment = 1;
+                break;
+
+            default:
+                usage(argc, argv);
+                exit(1);
+                break;
+        }
+    }
+
+    if ((width < 16) || (height < 16) || (framerate <= 0) || (bitrate <= 0) || (sliceCount <= 0)
+            || (streamCount <= 0) || (streamCount > BENCH_MAX_STREAM_COUNT) || (duration <= 0)
+            || (gopLength <= 0) || (maxPacketSize <= 0) || (basePort <= 0) || (basePort + 4 * streamCount > 65535)
+            || (engineWorkerCount < 0) || ((engineWorkerCount > 0) && (streamCount < BENCH_ENGINE_MIN_STREAM_COUNT))
+            || ((engineWorkerCount > 0) && (basePort + 4 * streamCount + 4 * BENCH_RELAY_COUNT + 1 > 65535))
+            || ((simulatedTime) && ((engineWorkerCount > 0) || (useImpairment))))
+    {
+        usage(argc, argv);
+        exit(1);
+    }
+
+    if (engineWorkerCount > 0)
+    {
+        /* the streams [0, engineStreamCount) are received through the engine
+         * sharded ingest, the others share the transport of the first of them */
+        engineStreamCount = (streamCount + 1) / 2;
+        ingestPort = basePort + 4 * streamCount + 4 * BENCH_RELAY_COUNT;
+        relayCount = BENCH_RELAY_COUNT;
+    }
+
+    frameCount = duration * framerate;
+    rssStart = getPeakRssKiB();
+
+    gop = buildGop(gopLength, width, height, framerate, bitrate, sliceCount, &maxAuSize, &maxNaluCount);
+    naluDesc = (gop) ? calloc(maxNaluCount, sizeof(ARSTREAM2_StreamSender_H264NaluDesc_t)) : NULL;
+    if ((!gop) || (!naluDesc))
+    {
+        fprintf(stderr, "Synthetic stream allocation failed\n");
+        failed = 1;
+    }
+
+    printf("%d stream(s) of %dx%d at %d fps, %d kbit/s, %d slice(s) per frame, GOP %d, MTU %d, %d s%s\n\n",
+           streamCount, width, height, framerate, bitrate, sliceCount, gopLength, maxPacketSize, duration,
+           (simulatedTime) ? " of simulated time" : "");
+
+    if ((!failed) && (simulatedTime))
+    {
+        simClock.time = BENCH_SIM_START_TIME_US;
+        if (ARSAL_Mutex_Init(&simClock.mutex) != 0)
+        {
+            fprintf(stderr, "Simulated clock mutex creation failed\n");
+            failed = 1;
+        }
+        else if (ARSAL_Cond_Init(&simClock.cond) != 0)
+        {
+            fprintf(stderr, "Simulated clock condition creation failed\n");
+            ARSAL_Mutex_Destroy(&simClock.mutex);
+            failed = 1;
+        }
+        else
+        {
+            benchClock = &simClock;
+        }
+    }
+
+    if ((!failed) && (engineWorkerCount > 0))
+    {
+        ARSTREAM2_StreamReceiverEngine_Config_t engineConfig;
+        eARSTREAM2_ERROR err;
+
+        printf("Engine: %d worker(s), %d stream(s) on ingest port %d, %d stream(s) on a shared transport, %d relay(s)\n\n",
+               engineWorkerCount, engineStreamCount, ingestPort, streamCount - engineStreamCount, relayCount);
+
+        memset(&engineConfig, 0, sizeof(engineConfig));
+        engineConfig.workerCount = engineWorkerCount;
+        engineConfig.ingestPort = ingestPort;
+        engineConfig.ingestSteering = ARSTREAM2_STREAM_RECEIVER_ENGINE_INGEST_STEERING_BY_SSRC;
+        err = ARSTREAM2_StreamReceiverEngine_Init(&engine, &engineConfig);
+        if (err != ARSTREAM2_OK)
+        {
+            fprintf(stderr, "Engine initialization failed (%s)\n", ARSTREAM2_Error_ToString(err));
+            failed = 1;
+        }
+    }
+
+    for (i = 0; (i < streamCount) && (!failed); i++)
+    {
+        ARSTREAM2_StreamSender_Config_t senderConfig;
+        ARSTREAM2_StreamReceiver_Config_t receiverConfig;
+        ARSTREAM2_StreamReceiver_NetConfig_t receiverNetConfig;
+        ARSTREAM2_NetImpairment_Config_t streamImpairment;
+        eARSTREAM2_ERROR err;
+        int port = basePort + 4 * i;
+        int isEngineStream = ((engine) && (i < engineStreamCount)) ? 1 : 0;
+        int transportIndex = ((engine) && (i > engineStreamCount)) ? engineStreamCount : -1;
+        uint32_t ssrc = (engine) ? BENCH_SSRC_BASE + i : 0;
+        /* in engine mode the odd streams leave the application output to
+         * the engine worker or transport network thread */
+        int appOutputThread = ((!engine) || (i == engineStreamCount) || ((i & 1) == 0)) ? 1 : 0;
+
+        stream[i].index = i;
+        stream[i].clock = benchClock;
+        stream[i].auBufferSize = maxAuSize * 2;
+        stream[i].auBuffer = malloc(stream[i].auBufferSize);
+        stream[i].latencyMaxCount = frameCount;
+        stream[i].latency = malloc(frameCount * sizeof(uint32_t));
+        stream[i].sendHistoryMutexInit = (ARSAL_Mutex_Init(&stream[i].sendHistoryMutex) == 0) ? 1 : 0;
+        if ((!stream[i].auBuffer) || (!stream[i].latency) || (!stream[i].sendHistoryMutexInit))
+        {
+            fprintf(stderr, "Stream %d allocation failed\n", i);
+            failed = 1;
+            break;
+        }
+
+        memset(&receiverConfig, 0, sizeof(receiverConfig));
+        memset(&receiverNetConfig, 0, sizeof(receiverNetConfig));
+        receiverConfig.canonicalName = "ARStream2LoopbackBench";
+        receiverConfig.maxPacketSize = maxPacketSize;
+        receiverConfig.generateReceiverReports = 1;
+        receiverConfig.filterThread = filterThread;
+        receiverConfig.engine = (isEngineStream) ? engine : NULL;
+        receiverConfig.transport = (transportIndex >= 0) ? stream[transportIndex].receiver : NULL;
+        receiverNetConfig.serverAddr = "127.0.0.1";
+        receiverNetConfig.serverStreamPort = port;
+        receiverNetConfig.serverControlPort = port + 1;
+        receiverNetConfig.clientStreamPort = port + 2;
+        receiverNetConfig.clientControlPort = port + 3;
+        receiverNetConfig.serverSsrc = ssrc;
+        if (benchClock)
+        {
+            receiverConfig.clockCallback = simClockGetTime;
+            receiverConfig.clockCallbackUserPtr = benchClock;
+        }
+        err = ARSTREAM2_StreamReceiver_Init(&stream[i].receiver, &receiverConfig, &receiverNetConfig, NULL);
+        if (err != ARSTREAM2_OK)
+        {
+            fprintf(stderr, "Stream %d: receiver initialization failed (%s)\n", i, ARSTREAM2_Error_ToString(err));
+            failed = 1;
+            break;
+        }
+
+        memset(&senderConfig, 0, sizeof(senderConfig));
+        senderConfig.canonicalName = "ARStream2LoopbackBench";
+        senderConfig.clientAddr = "127.0.0.1";
+        senderConfig.serverStreamPort = port;
+        senderConfig.serverControlPort = port + 1;
+        senderConfig.clientStreamPort = (isEngineStream) ? ingestPort : port + 2;
+        senderConfig.clientControlPort = port + 3;
+        senderConfig.ssrc = ssrc;
+        senderConfig.transport = (transportIndex >= 0) ? stream[transportIndex].sender : NULL;
+        senderConfig.naluFifoSize = (sliceCount + 2) * 16;
+        senderConfig.maxPacketSize = maxPacketSize;
+        senderConfig.targetPacketSize = maxPacketSize;
+        senderConfig.rtpStatsCallback = rtpStatsCallback;
+        senderConfig.rtpStatsCallbackUserPtr = &stream[i];
+        if (benchClock)
+        {
+            senderConfig.clockCallback = simClockGetTime;
+            senderConfig.clockCallbackUserPtr = benchClock;
+        }
+        if (useImpairment)
+        {
+            /* each stream gets its own impairment sequence */
+            streamImpairment = impairment;
+            streamImpairment.seed += i;
+            senderConfig.impairment = &streamImpairment;
+        }
+        err = ARSTREAM2_StreamSender_Init(&stream[i].sender, &senderConfig);
+        if (err != ARSTREAM2_OK)
+        {
+            fprintf(stderr, "Stream %d: sender initialization failed (%s)\n", i, ARSTREAM2_Error_ToString(err));
+            failed = 1;
+            break;
+        }
+
+        err = ARSTREAM2_StreamReceiver_StartAppOutput(stream[i].receiver, NULL, NULL, getAuBufferCallback, &stream[i],
+                                                      auReadyCallback, &stream[i]);
+        if ((err != ARSTREAM2_OK)
+                || (benchThreadStart(&stream[i].senderThread, ARSTREAM2_StreamSender_RunThread, stream[i].sender) != 0)
+                || (benchThreadStart(&stream[i].receiverThread, ARSTREAM2_StreamReceiver_RunNetworkThread, stream[i].receiver) != 0)
+                || ((appOutputThread) && (benchThreadStart(&stream[i].appOutputThread, ARSTREAM2_StreamReceiver_RunAppOutputThread, stream[i].receiver) != 0)))
+        {
+            fprintf(stderr, "Stream %d: failed to start\n", i);
+            failed = 1;
+            break;
+        }
+    }
+
+    for (i = 0; (i < relayCount) && (!failed); i++)
+    {
+        relay[i].index = i;
+        if (startRelay(&relay[i], stream[0].receiver, &resender[i], basePort + 4 * streamCount + 4 * i, maxPacketSize, maxAuSize) != 0)
+        {
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        /* the sender rejects the NAL units until its thread is running */
+        usleep(BENCH_STARTUP_TIME_US);
+
+        /* feed all the streams from this thread at the nominal framerate;
+         * in simulated time the clock jumps to the next frame time instead
+         * of sleeping, once every stream has received the previous frame */
+        processCpuStart = getProcessCpuTimeUs();
+        feederCpuStart = getThreadCpuTimeUs();
+        startTime = getBenchTimeUs(benchClock);
+        wallStartTime = getTimeUs();
+        nextMonitoringTime = startTime + BENCH_MONITORING_INTERVAL_US;
+
+        for (k = 0; k < frameCount; k++)
+        {
+            bench_au_t *au = &gop[k % (2 * gopLength)];
+
+            frameTime = startTime + (uint64_t)k * 1000000 / framerate;
+            if (benchClock)
+            {
+                simClockSetTime(benchClock, frameTime);
+            }
+            else
+            {
+                now = getTimeUs();
+                if (frameTime > now)
+                {
+                    usleep((useconds_t)(frameTime - now));
+                }
+            }
+
+            for (i = 0; i < streamCount; i++)
+            {
+                now = getBenchTimeUs(benchClock);
+                for (naluDescCount = 0; naluDescCount < (int)au->naluCount; naluDescCount++)
+                {
+                    naluDesc[naluDescCount] = au->nalu[naluDescCount];
+                    naluDesc[naluDescCount].auTimestamp = now;
+                    naluDesc[naluDescCount].importance = (au->isIdr) ? 0 : 1;
+                }
+                recordSendTime(&stream[i], now);
+                if (ARSTREAM2_StreamSender_SendNNewNalu(stream[i].sender, naluDesc, naluDescCount, now) == ARSTREAM2_OK)
+                {
+                    framesSent++;
+                }
+            }
+
+            if ((benchClock) && (simWaitDelivery(benchClock, stream, streamCount, frameTime) != 0))
+            {
+                simDeliveryTimeoutCount++;
+            }
+
+            now = getBenchTimeUs(benchClock);
+            if (now >= nextMonitoringTime)
+            {
+                for (i = 0; i < streamCount; i++)
+                {
+                    pollSenderMonitoring(&stream[i], BENCH_MONITORING_INTERVAL_US);
+                }
+                nextMonitoringTime += BENCH_MONITORING_INTERVAL_US;
+            }
+        }
+
+        if (benchClock)
+        {
+            /* every frame was received: end on the last frame period */
+            simClockSetTime(benchClock, startTime + (uint64_t)frameCount * 1000000 / framerate);
+        }
+        else
+        {
+            usleep(BENCH_DRAIN_TIME_US);
+        }
+        elapsed = getBenchTimeUs(benchClock) - startTime;
+        wallElapsed = getTimeUs() - wallStartTime;
+        for (i = 0; i < streamCount; i++)
+        {
+            pollSenderMonitoring(&stream[i], (uint32_t)(getBenchTimeUs(benchClock) - (nextMonitoringTime - BENCH_MONITORING_INTERVAL_US)));
+        }
+        feederCpu = getThreadCpuTimeUs() - feederCpuStart;
+    }
+
+    /* stop and join all the threads before accounting the CPU time */
+    for (i = 0; i < relayCount; i++)
+    {
+        if (resender[i])
+        {
+            ARSTREAM2_StreamReceiver_StopResender(stream[0].receiver, &resender[i]);
+        }
+        if (relay[i].receiver)
+        {
+            ARSTREAM2_StreamReceiver_StopAppOutput(relay[i].receiver);
+            ARSTREAM2_StreamReceiver_Stop(relay[i].receiver);
+        }
+    }
+    for (i = 0; i < streamCount; i++)
+    {
+        if (stream[i].sender)
+        {
+            ARSTREAM2_StreamSender_Stop(stream[i].sender);
+        }
+        if (stream[i].receiver)
+        {
+            ARSTREAM2_StreamReceiver_StopAppOutput(stream[i].receiver);
+            ARSTREAM2_StreamReceiver_Stop(stream[i].receiver);
+        }
+    }
+    for (i = 0; i < streamCount; i++)
+    {
+        benchThreadJoin(&stream[i].senderThread);
+        benchThreadJoin(&stream[i].receiverThread);
+        benchThreadJoin(&stream[i].appOutputThread);
+    }
+    for (i = 0; i < relayCount; i++)
+    {
+        benchThreadJoin(&relay[i].receiverThread);
+        benchThreadJoin(&relay[i].appOutputThread);
+    }
+
+    if (!failed)
+    {
+        rssPeak = getPeakRssKiB();
+        senderCpu = feederCpu;
+        for (i = 0; i < streamCount; i++)
+        {
+            senderCpu += stream[i].senderThread.cpuTime;
+            auCount += stream[i].auCount;
+            auByteCount += stream[i].auByteCount;
+            incompleteAuCount += stream[i].incompleteAuCount;
+            errorAuCount += stream[i].errorAuCount;
+            packetsSent += stream[i].packetsSent;
+            bytesSent += stream[i].bytesSent;
+            packetsDropped += stream[i].packetsDropped;
+            monitoringTime += stream[i].monitoringTime;
+            latencyCount += stream[i].latencyCount;
+            if (stream[i].rrCount > 1)
+            {
+                if ((rrMinInterval == 0) || (stream[i].rrMinInterval < rrMinInterval))
+                {
+                    rrMinInterval = stream[i].rrMinInterval;
+                }
+                if (stream[i].rrMaxInterval > rrMaxInterval)
+                {
+                    rrMaxInterval = stream[i].rrMaxInterval;
+                }
+            }
+            rrCount += stream[i].rrCount;
+        }
+        for (i = 0; i < relayCount; i++)
+        {
+            relayAuCount += relay[i].auCount;
+            relayErrorAuCount += relay[i].errorAuCount;
+        }
+        /* the receiver time includes its internal threads; the thread CPU times
+         * were sampled when the threads ended, after the feeding loop started */
+        receiverCpu = getProcessCpuTimeUs() - processCpuStart;
+        receiverCpu = (receiverCpu > senderCpu) ? receiverCpu - senderCpu : 0;
+
+        latency = malloc((latencyCount > 0 ? latencyCount : 1) * sizeof(uint32_t));
+        if (!latency)
+        {
+            fprintf(stderr, "Latency array allocation failed\n");
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        for (i = 0, k = 0; i < streamCount; i++)
+        {
+            memcpy(latency + k, stream[i].latency, stream[i].latencyCount * sizeof(uint32_t));
+            k += stream[i].latencyCount;
+        }
+        qsort(latency, latencyCount, sizeof(uint32_t), compareLatency);
+        mbits = (double)auByteCount * 8. / 1000000.;
+
+        printf("Frames:               %llu sent, %llu received (%llu incomplete, %llu with errors)\n",
+               (long long unsigned int)framesSent, (long long unsigned int)auCount,
+               (long long unsigned int)incompleteAuCount, (long long unsigned int)errorAuCount);
+        printf("Throughput:           %.2f Mbit/s received\n", mbits * 1000000. / (double)elapsed);
+        printf("Packets:              %llu sent (%.0f packets/s), %llu dropped\n", (long long unsigned int)packetsSent,
+               (monitoringTime > 0) ? (double)packetsSent * 1000000. * streamCount / (double)monitoringTime : 0.,
+               (long long unsigned int)packetsDropped);
+        printf("Sender CPU:           %.3f s (%.3f ms/Mbit)\n", (double)senderCpu / 1000000.,
+               (mbits > 0.) ? (double)senderCpu / 1000. / mbits : 0.);
+        printf("Receiver CPU:         %.3f s (%.3f ms/Mbit)\n", (double)receiverCpu / 1000000.,
+               (mbits > 0.) ? (double)receiverCpu / 1000. / mbits : 0.);
+        printf("Latency (us):         p50 %u, p90 %u, p99 %u, max %u (%d samples)\n",
+               percentile(latency, latencyCount, 50), percentile(latency, latencyCount, 90),
+               percentile(latency, latencyCount, 99), percentile(latency, latencyCount, 100), latencyCount);
+        printf("Receiver reports:     %llu received (interval min %u us, max %u us)\n",
+               (long long unsigned int)rrCount, rrMinInterval, rrMaxInterval);
+        if (benchClock)
+        {
+            printf("Simulated time:       %.3f s in %.3f s of wall time (x%.1f)\n", (double)elapsed / 1000000.,
+                   (double)wallElapsed / 1000000., (wallElapsed > 0) ? (double)elapsed / (double)wallElapsed : 0.);
+        }
+        if (relayCount > 0)
+        {
+            printf("Relayed frames:       %llu received by %d destination(s) (%llu with errors)\n",
+                   (long long unsigned int)relayAuCount, relayCount, (long long unsigned int)relayErrorAuCount);
+        }
+        printf("Peak RSS:             %ld KiB (+%ld KiB)\n", rssPeak, rssPeak - rssStart);
+
+        if (engine)
+        {
+            /* every stream must have been demultiplexed and decoded, and every
+             * resender destination must have received the relayed stream; without
+             * impairment errors are only expected on the streams which lost frames
+             * (e.g. socket receive buffer overflows on the shared transport), i.e.
+             * which did not get a latency sample for every frame sent */
+            for (i = 0; i < streamCount; i++)
+            {
+                if ((stream[i].auCount == 0) || ((!useImpairment) && (stream[i].errorAuCount > 0) && (stream[i].latencyCount >= frameCount)))
+                {
+                    fprintf(stderr, "Stream %d: %llu frame(s) received, %llu with errors\n", i,
+                            (long long unsigned int)stream[i].auCount, (long long unsigned int)stream[i].errorAuCount);
+                    failed = 1;
+                }
+            }
+            for (i = 0; i < relayCount; i++)
+            {
+                if (relay[i].auCount == 0)
+                {
+                    fprintf(stderr, "Relay %d: no frame received\n", i);
+                    failed = 1;
+                }
+            }
+        }
+
+        if (benchClock)
+        {
+            /* in simulated time every frame is received before the clock moves,
+             * hence a zero latency, and the receiver reports are paced by the
+             * simulated clock: at most one per RTCP minimum interval, and far
+             * more than the wall time of the run would allow */
+            if ((simDeliveryTimeoutCount > 0) || (latencyCount < frameCount * streamCount) || (percentile(latency, latencyCount, 100) != 0))
+            {
+                fprintf(stderr, "Simulated time: %d frame(s) not received in time, %d latency sample(s), max latency %u us\n",
+                        simDeliveryTimeoutCount, latencyCount, percentile(latency, latencyCount, 100));
+                failed = 1;
+            }
+            for (i = 0; i < streamCount; i++)
+            {
+                if ((stream[i].rrCount > elapsed / BENCH_RTCP_MIN_INTERVAL_US + 1)
+                        || (stream[i].rrCount < elapsed / (4 * BENCH_RTCP_MIN_INTERVAL_US)))
+                {
+                    fprintf(stderr, "Stream %d: %llu receiver report(s) in %.3f s of simulated time\n", i,
+                            (long long unsigned int)stream[i].rrCount, (double)elapsed / 1000000.);
+                    failed = 1;
+                }
+            }
+        }
+
+        if (jsonFileName)
+        {
+            json = (strcmp(jsonFileName, "-") == 0) ? stdout : fopen(jsonFileName, "w");
+            if (!json)
+            {
+                fprintf(stderr, "Failed to open the JSON output file '%s'\n", jsonFileName);
+                failed = 1;
+            }
+        }
+        if (json)
+        {
+            fprintf(json, "{\"config\": {\"width\": %d, \"height\": %d, \"framerate\": %d, \"bitrate_kbps\": %d, "
+                    "\"slices\": %d, \"streams\": %d, \"duration_s\": %d, \"gop\": %d, \"mtu\": %d, \"filter_thread\": %d, "
+                    "\"engine_workers\": %d, \"simulated_time\": %d}, ",
+                    width, height, framerate, bitrate, sliceCount, streamCount, duration, gopLength, maxPacketSize, filterThread,
+                    engineWorkerCount, simulatedTime);
+            if (useImpairment)
+            {
+                fprintf(json, "\"impairment\": {\"seed\": %u, \"loss\": %.4f, \"burst_start\": %.4f, \"burst_end\": %.4f, \"burst_loss\": %.4f, "
+                        "\"delay_us\": %u, \"jitter_us\": %u, \"reorder\": %.4f, \"duplicate\": %.4f, \"rate_bps\": %u}, ",
+                        impairment.seed, impairment.lossProbability, impairment.burstStartProbability, impairment.burstEndProbability,
+                        impairment.burstLossProbability, impairment.delayUs, impairment.jitterUs, impairment.reorderProbability,
+                        impairment.duplicateProbability, impairment.rateLimit);
+            }
+            fprintf(json, "\"frames_sent\": %llu, \"frames_received\": %llu, \"frames_incomplete\": %llu, \"frames_with_errors\": %llu, ",
+                    (long long unsigned int)framesSent, (long long unsigned int)auCount,
+                    (long long unsigned int)incompleteAuCount, (long long unsigned int)errorAuCount);
+            if (relayCount > 0)
+            {
+                fprintf(json, "\"relays\": %d, \"relayed_frames_received\": %llu, \"relayed_frames_with_errors\": %llu, ",
+                        relayCount, (long long unsigned int)relayAuCount, (long long unsigned int)relayErrorAuCount);
+            }
+            fprintf(json, "\"received_mbit\": %.3f, \"received_mbps\": %.3f, \"wall_time_s\": %.6f, ",
+                    mbits, mbits * 1000000. / (double)elapsed, (double)wallElapsed / 1000000.);
+            fprintf(json, "\"receiver_reports\": %llu, \"receiver_report_interval_us\": {\"min\": %u, \"max\": %u}, ",
+                    (long long unsigned int)rrCount, rrMinInterval, rrMaxInterval);
+            fprintf(json, "\"packets_sent\": %llu, \"packets_per_s\": %.1f, \"packets_dropped\": %llu, ",
+                    (long long unsigned int)packetsSent,
+                    (monitoringTime > 0) ? (double)packetsSent * 1000000. * streamCount / (double)monitoringTime : 0.,
+                    (long long unsigned int)packetsDropped);
+            fprintf(json, "\"sender_cpu_s\": %.6f, \"sender_cpu_ms_per_mbit\": %.4f, \"receiver_cpu_s\": %.6f, \"receiver_cpu_ms_per_mbit\": %.4f, ",
+                    (double)senderCpu / 1000000., (mbits > 0.) ? (double)senderCpu / 1000. / mbits : 0.,
+                    (double)receiverCpu / 1000000., (mbits > 0.) ? (double)receiverCpu / 1000. / mbits : 0.);
+            fprintf(json, "\"latency_us\": {\"samples\": %d, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u}, ",
+                    latencyCount, percentile(latency, latencyCount, 50), percentile(latency, latencyCount, 90),
+                    percentile(latency, latencyCount, 99), percentile(latency, latencyCount, 100));
+            fprintf(json, "\"peak_rss_kib\": %ld, \"rss_increase_kib\": %ld}\n", rssPeak, rssPeak - rssStart);
+            if (json != stdout)
+            {
+                fclose(json);
+            }
+        }
+    }
+
+    for (i = 0; i < relayCount; i++)
+    {
+        if (relay[i].receiver)
+        {
+            ARSTREAM2_StreamReceiver_Free(&relay[i].receiver);
+        }
+        free(relay[i].auBuffer);
+        if (relay[i].sendHistoryMutexInit)
+        {
+            ARSAL_Mutex_Destroy(&relay[i].sendHistoryMutex);
+        }
+    }
+    /* the instances sharing a transport are freed before the transport instance */
+    for (i = streamCount - 1; i >= 0; i--)
+    {
+        if (stream[i].sender)
+        {
+            ARSTREAM2_StreamSender_Free(&stream[i].sender);
+        }
+        if (stream[i].receiver)
+        {
+            ARSTREAM2_StreamReceiver_Free(&stream[i].receiver);
+        }
+        free(stream[i].auBuffer);
+        free(stream[i].latency);
+        if (stream[i].sendHistoryMutexInit)
+        {
+            ARSAL_Mutex_Destroy(&stream[i].sendHistoryMutex);
+        }
+    }
+    if (engine)
+    {
+        ARSTREAM2_StreamReceiverEngine_Free(&engine);
+    }
+    if (benchClock)
+    {
+        ARSAL_Cond_Destroy(&simClock.cond);
+        ARSAL_Mutex_Destroy(&simClock.mutex);
+    }
+    free(latency);
+    free(naluDesc);
+    freeGop(gop, gopLength);
+
+    return (failed) ? 1 : 0;
+}
@@ -0,0 +1,813 @@
+/**
+ * @file arstream2_micro_bench.c
+ * @brief Parrot Streaming Library - Microbenchmark program
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+/* included first for struct mmsghdr */
+#include "arstream2_rtp.h"
+#include "arstream2_rtcp.h"
+#include "arstream2_h264.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <getopt.h>
+#include <arpa/inet.h>
+
+#include <libARSAL/ARSAL_Print.h>
+#include <libARStream2/arstream2_h264_parser.h>
+#include <libARStream2/arstream2_h264_writer.h>
+
+#include "arstream2_micro_bench_corpus.h"
+
+
+#define TAG "ARSTREAM2_Micro_Bench"
+
+#define BENCH_DEFAULT_ROUNDS (2000)
+#define BENCH_RTCP_BATCH_SIZE (64)
+#define BENCH_PACKET_FIFO_SIZE (256)
+#define BENCH_PACKET_BUFFER_SIZE (1500)
+#define BENCH_OUTPUT_BUFFER_SIZE (4096)
+#define BENCH_ROUND_DURATION_US (200000)
+#define BENCH_ROUND_DURATION_RTP ((uint32_t)(BENCH_ROUND_DURATION_US * 9 / 100))
+
+
+/* Allocation counting: the allocation functions are interposed (glibc only, not with sanitizers) */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_HAS_ALLOC_COUNT
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static uint64_t bench_allocCount = 0;
+
+void *malloc(size_t size)
+{
+    bench_allocCount++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    bench_allocCount++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    bench_allocCount++;
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *ptr;
+
+    bench_allocCount++;
+    ptr = __libc_memalign(alignment, size);
+    if (!ptr)
+    {
+        return ENOMEM;
+    }
+    *memptr = ptr;
+    return 0;
+}
+#else
+static uint64_t bench_allocCount = 0;
+#endif
+
+
+typedef struct
+{
+    uint64_t ops;
+    uint64_t ticks;
+    uint64_t ns;
+    uint64_t allocs;
+
+    /* current measurement */
+    uint64_t startTicks;
+    uint64_t startNs;
+    uint64_t startAllocs;
+
+} bench_result_t;
+
+
+typedef int (*bench_func_t)(bench_result_t *result, int rounds);
+
+
+typedef struct
+{
+    const char *name;
+    bench_func_t func;
+
+} bench_t;
+
+
+static const char short_options[] = "hr:b:";
+
+
+static const struct option
+long_options[] = {
+    { "help"            , no_argument        , NULL, 'h' },
+    { "rounds"          , required_argument  , NULL, 'r' },
+    { "bench"           , required_argument  , NULL, 'b' },
+    { 0, 0, 0, 0 }
+};
+
+
+static void usage(int argc, char *argv[])
+{
+    (void)argc;
+
+    printf("Usage: %s [options]\n"
+           "Options:\n"
+           "-h | --help                        Print this message\n"
+           "-r | --rounds <count>              Number of rounds over the corpus (default %d)\n"
+           "-b | --bench <name>                Only run the benchmarks whose name contains this string\n"
+           "\n",
+           argv[0], BENCH_DEFAULT_ROUNDS);
+}
+
+
+/* Cycle counter if available, 0 otherwise */
+static inline uint64_t getTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+static inline uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+
+static inline void benchStart(bench_result_t *result)
+{
+    result->startAllocs = bench_allocCount;
+    result->startNs = getTimeNs();
+    result->startTicks = getTicks();
+}
+
+
+static inline void benchStop(bench_result_t *result, uint64_t ops)
+{
+    uint64_t ticks = getTicks();
+    uint64_t ns = getTimeNs();
+
+    result->ticks += ticks - result->startTicks;
+    result->ns += ns - result->startNs;
+    result->allocs += bench_allocCount - result->startAllocs;
+    result->ops += ops;
+}
+
+
+static int setupParser(ARSTREAM2_H264Parser_Handle *parser, int lazyParsing)
+{
+    ARSTREAM2_H264Parser_Config_t parserConfig;
+
+    memset(&parserConfig, 0, sizeof(parserConfig));
+    parserConfig.lazyParsing = lazyParsing;
+
+    if (ARSTREAM2_H264Parser_Init(parser, &parserConfig) != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_H264Parser_Init() failed");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static const uint8_t* getCorpusNalu(unsigned int index, unsigned int *size)
+{
+    unsigned int i, offset = 0;
+
+    for (i = 0; i < index; i++)
+    {
+        offset += bench_corpus_h264_nalu_size[i];
+    }
+    *size = bench_corpus_h264_nalu_size[index];
+
+    return bench_corpus_h264 + offset;
+}
+
+
+/* readBits: the user data SEI payload is skipped one 8-bit read at a time */
+static int bench_readBits(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_H264Parser_Handle parser = NULL;
+    int round, failed = 0;
+
+    if (setupParser(&parser, 0) != 0)
+    {
+        return -1;
+    }
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        benchStart(result);
+        if ((ARSTREAM2_H264Parser_SetupNalu_buffer(parser, (void*)bench_corpus_sei, sizeof(bench_corpus_sei)) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Parser_ParseNalu(parser, NULL) != ARSTREAM2_OK))
+        {
+            failed = 1;
+        }
+        /* one read per byte after the NAL unit header */
+        benchStop(result, sizeof(bench_corpus_sei) - 1);
+    }
+
+    ARSTREAM2_H264Parser_Free(parser);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_parseNalu(bench_result_t *result, int rounds, int lazyParsing)
+{
+    ARSTREAM2_H264Parser_Handle parser = NULL;
+    unsigned int i, offset;
+    int round, failed = 0;
+
+    if (setupParser(&parser, lazyParsing) != 0)
+    {
+        return -1;
+    }
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        benchStart(result);
+        for (i = 0, offset = 0; i < BENCH_CORPUS_H264_NALU_COUNT; offset += bench_corpus_h264_nalu_size[i++])
+        {
+            if ((ARSTREAM2_H264Parser_SetupNalu_buffer(parser, (void*)(bench_corpus_h264 + offset), bench_corpus_h264_nalu_size[i]) != ARSTREAM2_OK)
+                    || (ARSTREAM2_H264Parser_ParseNalu(parser, NULL) != ARSTREAM2_OK))
+            {
+                failed = 1;
+                break;
+            }
+        }
+        benchStop(result, BENCH_CORPUS_H264_NALU_COUNT);
+    }
+
+    ARSTREAM2_H264Parser_Free(parser);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_parseNaluFull(bench_result_t *result, int rounds)
+{
+    return bench_parseNalu(result, rounds, 0);
+}
+
+
+static int bench_parseNaluLazy(bench_result_t *result, int rounds)
+{
+    return bench_parseNalu(result, rounds, 1);
+}
+
+
+static int bench_writeSkippedPSlice(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_H264Parser_Handle parser = NULL;
+    ARSTREAM2_H264Writer_Handle writer = NULL;
+    ARSTREAM2_H264Writer_Config_t writerConfig;
+    void *spsContext = NULL, *ppsContext = NULL, *sliceContext = NULL;
+    uint8_t *outputBuf = NULL;
+    unsigned int outputSize, size, k, sliceMbCount = BENCH_CORPUS_H264_MB_COUNT / BENCH_CORPUS_H264_SLICE_COUNT;
+    const uint8_t *nalu;
+    int round, failed = 0;
+
+    if (setupParser(&parser, 0) != 0)
+    {
+        return -1;
+    }
+
+    memset(&writerConfig, 0, sizeof(writerConfig));
+    if (ARSTREAM2_H264Writer_Init(&writer, &writerConfig) != ARSTREAM2_OK)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_H264Writer_Init() failed");
+        failed = 1;
+    }
+
+    if (!failed)
+    {
+        const unsigned int index[3] = { BENCH_CORPUS_H264_SPS_INDEX, BENCH_CORPUS_H264_PPS_INDEX, BENCH_CORPUS_H264_REF_P_SLICE_INDEX };
+        for (k = 0; (k < 3) && (!failed); k++)
+        {
+            nalu = getCorpusNalu(index[k], &size);
+            if ((ARSTREAM2_H264Parser_SetupNalu_buffer(parser, (void*)nalu, size) != ARSTREAM2_OK)
+                    || (ARSTREAM2_H264Parser_ParseNalu(parser, NULL) != ARSTREAM2_OK))
+            {
+                failed = 1;
+            }
+        }
+        if ((failed) || (ARSTREAM2_H264Parser_GetSpsPpsContext(parser, &spsContext, &ppsContext) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Parser_GetSliceContext(parser, &sliceContext) != ARSTREAM2_OK)
+                || (ARSTREAM2_H264Writer_SetSpsPpsContext(writer, spsContext, ppsContext) != ARSTREAM2_OK))
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Failed to setup the writer context");
+            failed = 1;
+        }
+    }
+
+    outputBuf = malloc(BENCH_OUTPUT_BUFFER_SIZE);
+    if (!outputBuf)
+    {
+        failed = 1;
+    }
+
+    /* the first round builds the writer slice templates and is not measured */
+    for (round = -1; (round < rounds) && (!failed); round++)
+    {
+        if (round >= 0)
+        {
+            benchStart(result);
+        }
+        for (k = 0; k < BENCH_CORPUS_H264_SLICE_COUNT; k++)
+        {
+            if (ARSTREAM2_H264Writer_WriteSkippedPSliceNalu(writer, k * sliceMbCount, sliceMbCount, sliceContext,
+                                                           outputBuf, BENCH_OUTPUT_BUFFER_SIZE, &outputSize) != ARSTREAM2_OK)
+            {
+                failed = 1;
+                break;
+            }
+        }
+        if (round >= 0)
+        {
+            benchStop(result, BENCH_CORPUS_H264_SLICE_COUNT);
+        }
+    }
+
+    free(outputBuf);
+    if (writer) ARSTREAM2_H264Writer_Free(writer);
+    ARSTREAM2_H264Parser_Free(parser);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_packetFifoOrderedInsert(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTP_PacketFifo_t fifo;
+    ARSTREAM2_RTP_PacketFifoQueue_t queue;
+    ARSTREAM2_RTP_PacketFifoItem_t *item[BENCH_CORPUS_RTP_PACKET_COUNT];
+    unsigned int i;
+    int round, ret, failed = 0;
+
+    memset(&queue, 0, sizeof(queue));
+    if (ARSTREAM2_RTP_PacketFifoInit(&fifo, BENCH_PACKET_FIFO_SIZE, 0, 0, 0, 0) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_RTP_PacketFifoInit() failed");
+        return -1;
+    }
+    ARSTREAM2_RTP_PacketFifoAddQueue(&fifo, &queue);
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        /* the sequence numbers continue from one round to the next */
+        for (i = 0; i < BENCH_CORPUS_RTP_PACKET_COUNT; i++)
+        {
+            item[i] = ARSTREAM2_RTP_PacketFifoPopFreeItem(&fifo);
+            if (!item[i])
+            {
+                failed = 1;
+                break;
+            }
+            item[i]->packet.extSeqNum = bench_corpus_rtp[i].seqNum + round * BENCH_CORPUS_RTP_PACKET_COUNT;
+            item[i]->packet.seqNum = item[i]->packet.extSeqNum & 0xFFFF;
+            item[i]->packet.rtpTimestamp = bench_corpus_rtp[i].rtpTimestamp + (uint32_t)round * BENCH_ROUND_DURATION_RTP;
+            item[i]->packet.markerBit = bench_corpus_rtp[i].markerBit;
+        }
+        if (failed)
+        {
+            break;
+        }
+
+        benchStart(result);
+        for (i = 0; i < BENCH_CORPUS_RTP_PACKET_COUNT; i++)
+        {
+            ret = ARSTREAM2_RTP_PacketFifoEnqueueItemOrderedBySeqNum(&queue, item[i]);
+            if (ret < 0)
+            {
+                /* duplicate packet */
+                ARSTREAM2_RTP_PacketFifoPushFreeItem(&fifo, item[i]);
+            }
+        }
+        benchStop(result, BENCH_CORPUS_RTP_PACKET_COUNT);
+
+        ARSTREAM2_RTP_Receiver_PacketFifoFlushQueue(&fifo, &queue);
+    }
+
+    ARSTREAM2_RTP_PacketFifoRemoveQueue(&fifo, &queue);
+    ARSTREAM2_RTP_PacketFifoFree(&fifo);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_packetFifoAddFromMsgVec(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTP_PacketFifo_t fifo;
+    ARSTREAM2_RTP_PacketFifoQueue_t queue;
+    ARSTREAM2_RTP_ReceiverContext_t rtpContext;
+    ARSTREAM2_RTCP_ReceiverContext_t *rtcpContext = NULL;
+    struct mmsghdr *msgVec = NULL;
+    ARSTREAM2_RTP_Header_t *header;
+    uint64_t curTime = 1000000;
+    unsigned int i;
+    int round, ret, failed = 0;
+
+    memset(&queue, 0, sizeof(queue));
+    memset(&rtpContext, 0, sizeof(rtpContext));
+    rtpContext.rtpClockRate = 90000;
+    rtpContext.maxPacketSize = BENCH_PACKET_BUFFER_SIZE;
+    rtpContext.previousExtSeqNum = -1;
+
+    if (ARSTREAM2_RTP_PacketFifoInit(&fifo, BENCH_PACKET_FIFO_SIZE, BENCH_PACKET_FIFO_SIZE, BENCH_PACKET_BUFFER_SIZE, 0, 0) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_RTP_PacketFifoInit() failed");
+        return -1;
+    }
+    ARSTREAM2_RTP_PacketFifoAddQueue(&fifo, &queue);
+
+    msgVec = calloc(BENCH_CORPUS_RTP_PACKET_COUNT, sizeof(struct mmsghdr));
+    rtcpContext = calloc(1, sizeof(ARSTREAM2_RTCP_ReceiverContext_t));
+    if ((!msgVec) || (!rtcpContext))
+    {
+        failed = 1;
+    }
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        ret = ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec(&fifo, msgVec, BENCH_CORPUS_RTP_PACKET_COUNT);
+        if (ret != (int)BENCH_CORPUS_RTP_PACKET_COUNT)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_RTP_Receiver_PacketFifoFillMsgVec() failed (%d)", ret);
+            failed = 1;
+            break;
+        }
+
+        /* emulate the reception: only the RTP headers and sizes matter */
+        for (i = 0; i < BENCH_CORPUS_RTP_PACKET_COUNT; i++)
+        {
+            header = (ARSTREAM2_RTP_Header_t*)msgVec[i].msg_hdr.msg_iov[0].iov_base;
+            header->flags = htons(0x8060 | ((bench_corpus_rtp[i].markerBit) ? (1 << 7) : 0));
+            header->seqNum = htons((uint16_t)(bench_corpus_rtp[i].seqNum + round * BENCH_CORPUS_RTP_PACKET_COUNT));
+            header->timestamp = htonl(bench_corpus_rtp[i].rtpTimestamp + (uint32_t)round * BENCH_ROUND_DURATION_RTP);
+            header->ssrc = htonl(ARSTREAM2_RTP_SENDER_SSRC);
+            msgVec[i].msg_len = sizeof(ARSTREAM2_RTP_Header_t) + bench_corpus_rtp[i].payloadSize;
+            msgVec[i].msg_hdr.msg_flags = 0;
+        }
+
+        benchStart(result);
+        ret = ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec(&rtpContext, &fifo, &queue, NULL, 0, msgVec,
+                                                             BENCH_CORPUS_RTP_PACKET_COUNT, curTime, rtcpContext);
+        benchStop(result, BENCH_CORPUS_RTP_PACKET_COUNT);
+        if (ret < 0)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_RTP_Receiver_PacketFifoAddFromMsgVec() failed (%d)", ret);
+            failed = 1;
+        }
+
+        ARSTREAM2_RTP_Receiver_PacketFifoFlushQueue(&fifo, &queue);
+        curTime += BENCH_ROUND_DURATION_US;
+    }
+
+    free(msgVec);
+    free(rtcpContext);
+    ARSTREAM2_RTP_PacketFifoRemoveQueue(&fifo, &queue);
+    ARSTREAM2_RTP_PacketFifoFree(&fifo);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static void setupRtcpContexts(ARSTREAM2_RTCP_SenderContext_t *senderContext, ARSTREAM2_RTCP_ReceiverContext_t *receiverContext)
+{
+    int i, k;
+
+    if (senderContext)
+    {
+        memset(senderContext, 0, sizeof(ARSTREAM2_RTCP_SenderContext_t));
+        senderContext->senderSsrc = ARSTREAM2_RTP_SENDER_SSRC;
+        senderContext->receiverSsrc = ARSTREAM2_RTP_RECEIVER_SSRC;
+        senderContext->rtpClockRate = 90000;
+        senderContext->rtcpByteRate = ARSTREAM2_RTCP_SENDER_DEFAULT_BITRATE / 8;
+        senderContext->sdesItem[0].type = ARSTREAM2_RTCP_SDES_CNAME_ITEM;
+        snprintf(senderContext->sdesItem[0].value, 256, "sender@bench");
+        senderContext->sdesItemCount = 1;
+    }
+
+    if (receiverContext)
+    {
+        memset(receiverContext, 0, sizeof(ARSTREAM2_RTCP_ReceiverContext_t));
+        receiverContext->senderSsrc = ARSTREAM2_RTP_SENDER_SSRC;
+        receiverContext->receiverSsrc = ARSTREAM2_RTP_RECEIVER_SSRC;
+        receiverContext->rtcpByteRate = ARSTREAM2_RTCP_RECEIVER_DEFAULT_BITRATE / 8;
+        receiverContext->sdesItem[0].type = ARSTREAM2_RTCP_SDES_CNAME_ITEM;
+        snprintf(receiverContext->sdesItem[0].value, 256, "receiver@bench");
+        receiverContext->sdesItemCount = 1;
+        receiverContext->firstSeqNum = 1000;
+        receiverContext->extHighestSeqNum = 2000;
+        receiverContext->packetsReceived = 990;
+        receiverContext->packetsLost = 10;
+        receiverContext->videoStatsCtx.videoStats.totalFrameCount = 300;
+        receiverContext->videoStatsCtx.videoStats.outputFrameCount = 298;
+        receiverContext->videoStatsCtx.videoStats.mbStatusClassCount = ARSTREAM2_H264_MB_STATUS_CLASS_COUNT;
+        receiverContext->videoStatsCtx.videoStats.mbStatusZoneCount = ARSTREAM2_H264_MB_STATUS_ZONE_COUNT;
+        for (i = 0; i < ARSTREAM2_H264_MB_STATUS_CLASS_COUNT; i++)
+        {
+            for (k = 0; k < ARSTREAM2_H264_MB_STATUS_ZONE_COUNT; k++)
+            {
+                receiverContext->videoStatsCtx.videoStats.macroblockStatus[i][k] = (i == 0) ? 50000 : i * 10 + k;
+            }
+        }
+    }
+}
+
+
+static int bench_rtcpSenderGenerate(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTCP_SenderContext_t *context;
+    uint8_t packet[BENCH_PACKET_BUFFER_SIZE];
+    uint64_t sendTimestamp = 10000000;
+    unsigned int size;
+    int round, i, failed = 0;
+
+    context = malloc(sizeof(ARSTREAM2_RTCP_SenderContext_t));
+    if (!context)
+    {
+        return -1;
+    }
+    setupRtcpContexts(context, NULL);
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        benchStart(result);
+        for (i = 0; i < BENCH_RTCP_BATCH_SIZE; i++)
+        {
+            /* one packet per clock delta timeout so that all the parts are generated */
+            sendTimestamp += ARSTREAM2_RTCP_CLOCKDELTA_TIMEOUT;
+            if (ARSTREAM2_RTCP_Sender_GenerateCompoundPacket(packet, sizeof(packet), sendTimestamp, 1, 1, 1,
+                                                             1000 * i, 1400000 * i, context, &size) != 0)
+            {
+                failed = 1;
+                break;
+            }
+        }
+        benchStop(result, BENCH_RTCP_BATCH_SIZE);
+    }
+
+    free(context);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_rtcpReceiverProcess(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTCP_ReceiverContext_t *context;
+    ARSTREAM2_RTCP_SenderReport_t *senderReport;
+    uint8_t *packet;
+    uint64_t receptionTimestamp = 10000500;
+    uint32_t ntpTimestampH, rtpTimestamp;
+    int round, i, failed = 0;
+
+    context = malloc(sizeof(ARSTREAM2_RTCP_ReceiverContext_t));
+    packet = malloc(BENCH_RTCP_BATCH_SIZE * sizeof(bench_corpus_rtcp_sender));
+    if ((!context) || (!packet))
+    {
+        free(context);
+        free(packet);
+        return -1;
+    }
+    setupRtcpContexts(NULL, context);
+
+    senderReport = (ARSTREAM2_RTCP_SenderReport_t*)bench_corpus_rtcp_sender;
+    ntpTimestampH = ntohl(senderReport->ntpTimestampH);
+    rtpTimestamp = ntohl(senderReport->rtpTimestamp);
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        /* the sender reports must have increasing timestamps: one second apart */
+        for (i = 0; i < BENCH_RTCP_BATCH_SIZE; i++)
+        {
+            memcpy(packet + i * sizeof(bench_corpus_rtcp_sender), bench_corpus_rtcp_sender, sizeof(bench_corpus_rtcp_sender));
+            senderReport = (ARSTREAM2_RTCP_SenderReport_t*)(packet + i * sizeof(bench_corpus_rtcp_sender));
+            senderReport->ntpTimestampH = htonl(++ntpTimestampH);
+            rtpTimestamp += 90000;
+            senderReport->rtpTimestamp = htonl(rtpTimestamp);
+        }
+
+        benchStart(result);
+        for (i = 0; i < BENCH_RTCP_BATCH_SIZE; i++)
+        {
+            receptionTimestamp += 1000000;
+            if (ARSTREAM2_RTCP_Receiver_ProcessCompoundPacket(packet + i * sizeof(bench_corpus_rtcp_sender), sizeof(bench_corpus_rtcp_sender),
+                                                              receptionTimestamp, context) != 0)
+            {
+                failed = 1;
+                break;
+            }
+        }
+        benchStop(result, BENCH_RTCP_BATCH_SIZE);
+    }
+
+    free(context);
+    free(packet);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_rtcpReceiverGenerate(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTCP_ReceiverContext_t *context;
+    uint8_t packet[BENCH_PACKET_BUFFER_SIZE];
+    uint64_t sendTimestamp = 10020000;
+    unsigned int size;
+    int round, i, failed = 0;
+
+    context = malloc(sizeof(ARSTREAM2_RTCP_ReceiverContext_t));
+    if (!context)
+    {
+        return -1;
+    }
+    setupRtcpContexts(NULL, context);
+
+    /* the receiver reports need a received sender report */
+    if (ARSTREAM2_RTCP_Receiver_ProcessCompoundPacket(bench_corpus_rtcp_sender, sizeof(bench_corpus_rtcp_sender), 10000500, context) != 0)
+    {
+        failed = 1;
+    }
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        benchStart(result);
+        for (i = 0; i < BENCH_RTCP_BATCH_SIZE; i++)
+        {
+            sendTimestamp += ARSTREAM2_RTCP_CLOCKDELTA_TIMEOUT;
+            context->extHighestSeqNum += 30;
+            context->packetsReceived += 30;
+            if (ARSTREAM2_RTCP_Receiver_GenerateCompoundPacket(packet, sizeof(packet), sendTimestamp, 1, 1, 1, 1, context, &size) != 0)
+            {
+                failed = 1;
+                break;
+            }
+        }
+        benchStop(result, BENCH_RTCP_BATCH_SIZE);
+    }
+
+    free(context);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static int bench_rtcpSenderProcess(bench_result_t *result, int rounds)
+{
+    ARSTREAM2_RTCP_SenderContext_t *context;
+    uint64_t receptionTimestamp = 10020500;
+    int gotReceptionReport = 0, gotVideoStats = 0;
+    int round, i, failed = 0;
+
+    context = malloc(sizeof(ARSTREAM2_RTCP_SenderContext_t));
+    if (!context)
+    {
+        return -1;
+    }
+    setupRtcpContexts(context, NULL);
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        benchStart(result);
+        for (i = 0; i < BENCH_RTCP_BATCH_SIZE; i++)
+        {
+            receptionTimestamp += 1000000;
+            if (ARSTREAM2_RTCP_Sender_ProcessCompoundPacket(bench_corpus_rtcp_receiver, sizeof(bench_corpus_rtcp_receiver), receptionTimestamp,
+                                                            context, &gotReceptionReport, &gotVideoStats) != 0)
+            {
+                failed = 1;
+                break;
+            }
+        }
+        benchStop(result, BENCH_RTCP_BATCH_SIZE);
+    }
+
+    free(context);
+
+    return (failed) ? -1 : 0;
+}
+
+
+static const bench_t bench_list[] =
+{
+    { "h264_read_bits_8",                   bench_readBits },
+    { "h264_parse_nalu",                    bench_parseNaluFull },
+    { "h264_parse_nalu_lazy",               bench_parseNaluLazy },
+    { "h264_write_skipped_p_slice",         bench_writeSkippedPSlice },
+    { "rtp_packet_fifo_ordered_insert",     bench_packetFifoOrderedInsert },
+    { "rtp_packet_fifo_add_from_msgvec",    bench_packetFifoAddFromMsgVec },
+    { "rtcp_sender_generate",               bench_rtcpSenderGenerate },
+    { "rtcp_receiver_process",              bench_rtcpReceiverProcess },
+    { "rtcp_receiver_generate",             bench_rtcpReceiverGenerate },
+    { "rtcp_sender_process",                bench_rtcpSenderProcess },
+};
+
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int idx, c, i;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+    const char *filter = NULL;
+    bench_result_t result;
+
+    printf("ARStream2 Microbenchmarks\n\n");
+
+    while ((c = getopt_long(argc, argv, short_options, long_options, &idx)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+                break;
+
+            case 'h':
+                usage(argc, argv);
+                exit(0);
+                break;
+
+            case 'r':
+                sscanf(optarg, "%d", &rounds);
+                break;
+
+            case 'b':
+                filter = optarg;
+                break;
+
+            default:
+                usage(argc, argv);
+                exit(-1);
+                break;
+        }
+    }
+
+    if (rounds <= 0)
+    {
+        usage(argc, argv);
+        exit(-1);
+    }
+
+    printf("%-34s %12s %12s %12s %12s\n", "benchmark", "ops", "cycles/op", "ns/op", "allocs/op");
+
+    for (i = 0; i < (int)(sizeof(bench_list) / sizeof(bench_list[0])); i++)
+    {
+        if ((filter) && (!strstr(bench_list[i].name, filter)))
+        {
+            continue;
+        }
+
+        memset(&result, 0, sizeof(result));
+        if (bench_list[i].func(&result, rounds) != 0)
+        {
+            printf("%-34s failed\n", bench_list[i].name);
+            failed = 1;
+            continue;
+        }
+        if (result.ops == 0)
+        {
+            continue;
+        }
+
+        printf("%-34s %12llu ", bench_list[i].name, (unsigned long long)result.ops);
+#if defined(__x86_64__) || defined(__i386__)
+        printf("%12.1f ", (double)result.ticks / result.ops);
+#else
+        printf("%12s ", "-");
+#endif
+        printf("%12.1f ", (double)result.ns / result.ops);
+#ifdef BENCH_HAS_ALLOC_COUNT
+        printf("%12.3f\n", (double)result.allocs / result.ops);
+#else
+        printf("%12s\n", "-");
+#endif
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    printf("\ncycles: TSC cycles\n");
+#endif
+
+    return (failed) ? -1 : 0;
+}
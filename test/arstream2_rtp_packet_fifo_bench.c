@@ -0,0 +1,260 @@
+/**
+ * @file arstream2_rtp_packet_fifo_bench.c
+ * @brief Parrot Streaming Library - RTP packet FIFO benchmark program
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <getopt.h>
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "arstream2_rtp.h"
+
+
+#define TAG "ARSTREAM2_RtpPacketFifo_Bench"
+
+#define BENCH_DEFAULT_QUEUE_DEPTH (4096)
+#define BENCH_DEFAULT_ROUNDS (200)
+#define BENCH_DEFAULT_REORDER_WINDOW (16)
+#define BENCH_TIMEOUT_WALK_COUNT (8)
+#define BENCH_IMPORTANCE_LEVEL_COUNT (4)
+
+
+static const char short_options[] = "hd:r:w:";
+
+
+static const struct option
+long_options[] = {
+    { "help"            , no_argument        , NULL, 'h' },
+    { "depth"           , required_argument  , NULL, 'd' },
+    { "rounds"          , required_argument  , NULL, 'r' },
+    { "window"          , required_argument  , NULL, 'w' },
+    { 0, 0, 0, 0 }
+};
+
+
+static void usage(int argc, char *argv[])
+{
+    printf("Usage: %s [options]\n"
+           "Options:\n"
+           "-h | --help                        Print this message\n"
+           "-d | --depth <count>               Queue depth in packets (default %d)\n"
+           "-r | --rounds <count>              Number of fill/walk/drain rounds (default %d)\n"
+           "-w | --window <count>              Reordering window in packets (default %d)\n"
+           "\n",
+           argv[0], BENCH_DEFAULT_QUEUE_DEPTH, BENCH_DEFAULT_ROUNDS, BENCH_DEFAULT_REORDER_WINDOW);
+}
+
+
+/* Cycle counter if available, nanoseconds otherwise */
+static inline uint64_t getTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+/* Deterministic pseudo-random generator so that runs are comparable */
+static uint32_t lcgNext(uint32_t *state)
+{
+    *state = *state * 1664525 + 1013904223;
+    return *state >> 8;
+}
+
+
+/* Scatter the free item list so that consecutive packets are not contiguous in memory,
+ * as is the case after some time of operation */
+static int shuffleFreeItems(ARSTREAM2_RTP_PacketFifo_t *fifo, uint32_t *rng)
+{
+    ARSTREAM2_RTP_PacketFifoItem_t **items;
+    ARSTREAM2_RTP_PacketFifoItem_t *tmp;
+    int i, j, count = fifo->itemPoolSize;
+
+    items = malloc(count * sizeof(ARSTREAM2_RTP_PacketFifoItem_t*));
+    if (!items)
+    {
+        return -1;
+    }
+    for (i = 0; i < count; i++)
+    {
+        items[i] = ARSTREAM2_RTP_PacketFifoPopFreeItem(fifo);
+    }
+    for (i = count - 1; i > 0; i--)
+    {
+        j = lcgNext(rng) % (i + 1);
+        tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+    }
+    for (i = 0; i < count; i++)
+    {
+        ARSTREAM2_RTP_PacketFifoPushFreeItem(fifo, items[i]);
+    }
+    free(items);
+
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int idx, c, i, k, round;
+    int depth = BENCH_DEFAULT_QUEUE_DEPTH;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+    int window = BENCH_DEFAULT_REORDER_WINDOW;
+    ARSTREAM2_RTP_PacketFifo_t fifo;
+    ARSTREAM2_RTP_PacketFifoQueue_t queue;
+    ARSTREAM2_RTP_SenderContext_t senderContext;
+    ARSTREAM2_RTP_PacketFifoItem_t *item;
+    unsigned int dropCount[BENCH_IMPORTANCE_LEVEL_COUNT];
+    uint32_t *seqOrder = NULL;
+    uint32_t rng = 0x12345678;
+    uint32_t extSeqNum = 0;
+    uint64_t t0, insertTicks = 0, walkTicks = 0, drainTicks = 0;
+    uint64_t packetCount;
+
+    printf("ARStream2 RTP Packet FIFO Benchmark\n\n");
+
+    while ((c = getopt_long(argc, argv, short_options, long_options, &idx)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+                break;
+
+            case 'h':
+                usage(argc, argv);
+                exit(0);
+                break;
+
+            case 'd':
+                sscanf(optarg, "%d", &depth);
+                break;
+
+            case 'r':
+                sscanf(optarg, "%d", &rounds);
+                break;
+
+            case 'w':
+                sscanf(optarg, "%d", &window);
+                break;
+
+            default:
+                usage(argc, argv);
+                exit(-1);
+                break;
+        }
+    }
+
+    if ((depth <= 0) || (rounds <= 0) || (window <= 0))
+    {
+        usage(argc, argv);
+        exit(-1);
+    }
+
+    memset(&queue, 0, sizeof(queue));
+    memset(&senderContext, 0, sizeof(senderContext));
+
+    if (ARSTREAM2_RTP_PacketFifoInit(&fifo, depth, 1, 64, 0, 0) != 0)
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "ARSTREAM2_RTP_PacketFifoInit() failed");
+        return -1;
+    }
+    ARSTREAM2_RTP_PacketFifoAddQueue(&fifo, &queue);
+
+    seqOrder = malloc(depth * sizeof(uint32_t));
+    if ((!seqOrder) || (shuffleFreeItems(&fifo, &rng) != 0))
+    {
+        ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Allocation failed");
+        failed = 1;
+    }
+
+    for (round = 0; (round < rounds) && (!failed); round++)
+    {
+        /* Sequence numbers with local reordering within the window */
+        for (i = 0; i < depth; i++)
+        {
+            seqOrder[i] = extSeqNum + i;
+        }
+        for (i = 0; i + 1 < depth; i++)
+        {
+            k = i + lcgNext(&rng) % window;
+            if (k < depth)
+            {
+                uint32_t tmp = seqOrder[i];
+                seqOrder[i] = seqOrder[k];
+                seqOrder[k] = tmp;
+            }
+        }
+
+        /* Ordered insertion */
+        t0 = getTicks();
+        for (i = 0; i < depth; i++)
+        {
+            item = ARSTREAM2_RTP_PacketFifoPopFreeItem(&fifo);
+            if (!item)
+            {
+                failed = 1;
+                break;
+            }
+            item->packet.extSeqNum = seqOrder[i];
+            item->packet.seqNum = seqOrder[i] & 0xFFFF;
+            item->packet.rtpTimestamp = seqOrder[i] / 32 * 3000;
+            item->packet.markerBit = ((seqOrder[i] & 31) == 31) ? 1 : 0;
+            item->packet.timeoutTimestamp = (uint64_t)seqOrder[i] + 2;
+            ARSTREAM2_RTP_PacketFifoEnqueueItemOrderedBySeqNum(&queue, item);
+        }
+        insertTicks += getTicks() - t0;
+        extSeqNum += depth;
+
+        /* Timeout walks with no packet expired */
+        t0 = getTicks();
+        for (k = 0; k < BENCH_TIMEOUT_WALK_COUNT; k++)
+        {
+            ARSTREAM2_RTP_Sender_PacketFifoCleanFromTimeout(&senderContext, &fifo, &queue, 1,
+                                                            dropCount, BENCH_IMPORTANCE_LEVEL_COUNT);
+        }
+        walkTicks += getTicks() - t0;
+
+        /* Timeout walk with all packets expired */
+        t0 = getTicks();
+        if (ARSTREAM2_RTP_Sender_PacketFifoCleanFromTimeout(&senderContext, &fifo, &queue, (uint64_t)extSeqNum + 1,
+                                                            dropCount, BENCH_IMPORTANCE_LEVEL_COUNT) != depth)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Unexpected drop count");
+            failed = 1;
+        }
+        drainTicks += getTicks() - t0;
+    }
+
+    if (!failed)
+    {
+        packetCount = (uint64_t)depth * rounds;
+#if defined(__x86_64__) || defined(__i386__)
+        printf("Item size: %zu bytes, unit: TSC cycles per packet\n", sizeof(ARSTREAM2_RTP_PacketFifoItem_t));
+#else
+        printf("Item size: %zu bytes, unit: ns per packet\n", sizeof(ARSTREAM2_RTP_PacketFifoItem_t));
+#endif
+        printf("Ordered insert:   %.1f\n", (double)insertTicks / packetCount);
+        printf("Timeout walk:     %.1f\n", (double)walkTicks / (packetCount * BENCH_TIMEOUT_WALK_COUNT));
+        printf("Timeout drain:    %.1f\n", (double)drainTicks / packetCount);
+    }
+
+    free(seqOrder);
+    ARSTREAM2_RTP_PacketFifoRemoveQueue(&fifo, &queue);
+    ARSTREAM2_RTP_PacketFifoFree(&fifo);
+
+    return (failed) ? -1 : 0;
+}
@@ -0,0 +1,483 @@
+/**
+ * @file arstream2_rtp_replay.c
+ * @brief Parrot Streaming Library - RTP capture replay program
+ * @date 10/19/2026
+ * @author agent@local
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#define __USE_GNU
+#include <sys/socket.h>
+#undef __USE_GNU
+
+#include <libARSAL/ARSAL_Print.h>
+
+#include "arstream2_rtp_receiver.h"
+#include "arstream2_pcap.h"
+
+
+#define TAG "ARSTREAM2_RtpReplay"
+
+#define REPLAY_PACKET_FIFO_BUFFER_COUNT (500)
+#define REPLAY_PACKET_FIFO_ITEM_COUNT (REPLAY_PACKET_FIFO_BUFFER_COUNT * 4)
+#define REPLAY_PACKET_FIFO_JUMBO_BUFFER_COUNT (16)
+#define REPLAY_AU_FIFO_ITEM_COUNT (200)
+#define REPLAY_AU_FIFO_ITEM_NALU_COUNT (128)
+#define REPLAY_AU_FIFO_BUFFER_COUNT (60)
+#define REPLAY_AU_BUFFER_SIZE (128 * 1024)
+#define REPLAY_AU_METADATA_BUFFER_SIZE (1024)
+#define REPLAY_AU_USER_DATA_BUFFER_SIZE (1024)
+#define REPLAY_DRAIN_TIMEOUT_US (200000)
+#define REPLAY_MAX_SLEEP_US (10000)
+
+
+typedef struct
+{
+    ARSTREAM2_PcapReader_t *reader;
+    ARSTREAM2_H264_AuFifo_t *auFifo;
+    FILE *outFile;
+    double speed;
+
+    /* next packet to deliver */
+    int pending;
+    int eof;
+    eARSTREAM2_PCAP_CHANNEL pendingChannel;
+    uint64_t pendingTimestamp;
+    const uint8_t *pendingData;
+    size_t pendingSize;
+
+    /* timing */
+    int started;
+    uint64_t firstCaptureTime;
+    uint64_t lastCaptureTime;
+    uint64_t startTime;
+
+    /* statistics */
+    uint64_t rtpPacketCount;
+    uint64_t rtpByteCount;
+    uint64_t rtcpPacketCount;
+    uint64_t rtcpSentCount;
+    uint64_t auCount;
+    uint64_t auByteCount;
+
+} replay_ctx_t;
+
+
+static const char short_options[] = "hi:s:o:c:";
+
+
+static const struct option
+long_options[] = {
+    { "help"            , no_argument        , NULL, 'h' },
+    { "input"           , required_argument  , NULL, 'i' },
+    { "speed"           , required_argument  , NULL, 's' },
+    { "output"          , required_argument  , NULL, 'o' },
+    { "capture"         , required_argument  , NULL, 'c' },
+    { 0, 0, 0, 0 }
+};
+
+
+static void usage(int argc, char *argv[])
+{
+    (void)argc;
+
+    printf("Usage: %s [options]\n"
+           "Options:\n"
+           "-h | --help                        Print this message\n"
+           "-i | --input <file>                Input pcapng capture file\n"
+           "-s | --speed <factor>              Replay speed relative to the capture timing, 0 for as fast as possible (default 0)\n"
+           "-o | --output <file>               Output H.264 byte stream file (optional)\n"
+           "-c | --capture <file>              Capture the replayed packets to a pcapng file (optional)\n"
+           "\n",
+           argv[0]);
+}
+
+
+static inline uint64_t getTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+
+/* Load the next capture packet if needed, returns 1 if a packet is pending */
+static int replayPeek(replay_ctx_t *ctx)
+{
+    int ret;
+
+    if ((!ctx->pending) && (!ctx->eof))
+    {
+        ret = ARSTREAM2_PcapReader_ReadPacket(ctx->reader, &ctx->pendingChannel, &ctx->pendingTimestamp,
+                                              &ctx->pendingData, &ctx->pendingSize);
+        if (ret == 1)
+        {
+            ctx->pending = 1;
+            if (!ctx->started)
+            {
+                ctx->started = 1;
+                ctx->firstCaptureTime = ctx->pendingTimestamp;
+                ctx->startTime = getTimeUs();
+            }
+            ctx->lastCaptureTime = ctx->pendingTimestamp;
+        }
+        else
+        {
+            if (ret < 0)
+            {
+                ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Capture read error, replay stopped");
+            }
+            ctx->eof = 1;
+        }
+    }
+
+    return ctx->pending;
+}
+
+
+/* Time to wait before the pending packet is due in microseconds (0 if due) */
+static uint64_t replayWaitTime(replay_ctx_t *ctx)
+{
+    uint64_t due, elapsed;
+
+    if ((!ctx->pending) || (ctx->speed <= 0.))
+    {
+        return 0;
+    }
+
+    due = (uint64_t)((double)(ctx->pendingTimestamp - ctx->firstCaptureTime) / ctx->speed);
+    elapsed = getTimeUs() - ctx->startTime;
+
+    return (due > elapsed) ? due - elapsed : 0;
+}
+
+
+static int replayChannelSetup(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    (void)receiver;
+
+    return 0;
+}
+
+
+static int replayChannelTeardown(ARSTREAM2_RtpReceiver_t *receiver)
+{
+    (void)receiver;
+
+    return 0;
+}
+
+
+/* Scatter the due RTP packets into the packet FIFO buffers as recvmmsg() would */
+static int replayStreamRecvMmsg(ARSTREAM2_RtpReceiver_t *receiver, struct mmsghdr *msgvec, unsigned int vlen, int blocking)
+{
+    replay_ctx_t *ctx = (replay_ctx_t*)receiver->opsUserPtr;
+    unsigned int i, k;
+    size_t offset, len;
+
+    (void)blocking;
+
+    for (i = 0; (i < vlen) && (replayPeek(ctx)) && (ctx->pendingChannel == ARSTREAM2_PCAP_CHANNEL_STREAM)
+                && (replayWaitTime(ctx) == 0); i++)
+    {
+        for (k = 0, offset = 0; (k < msgvec[i].msg_hdr.msg_iovlen) && (offset < ctx->pendingSize); k++)
+        {
+            len = ctx->pendingSize - offset;
+            if (len > msgvec[i].msg_hdr.msg_iov[k].iov_len)
+            {
+                len = msgvec[i].msg_hdr.msg_iov[k].iov_len;
+            }
+            memcpy(msgvec[i].msg_hdr.msg_iov[k].iov_base, ctx->pendingData + offset, len);
+            offset += len;
+        }
+        msgvec[i].msg_len = (unsigned int)offset;
+        msgvec[i].msg_hdr.msg_flags = (offset < ctx->pendingSize) ? MSG_TRUNC : 0;
+        ctx->rtpPacketCount++;
+        ctx->rtpByteCount += ctx->pendingSize;
+        ctx->pending = 0;
+    }
+
+    return (int)i;
+}
+
+
+static int replayControlSend(ARSTREAM2_RtpReceiver_t *receiver, uint8_t *buffer, int size)
+{
+    replay_ctx_t *ctx = (replay_ctx_t*)receiver->opsUserPtr;
+
+    (void)buffer;
+
+    /* the receiver reports are discarded */
+    ctx->rtcpSentCount++;
+    return size;
+}
+
+
+static int replayControlRead(ARSTREAM2_RtpReceiver_t *receiver, uint8_t *buffer, int size)
+{
+    replay_ctx_t *ctx = (replay_ctx_t*)receiver->opsUserPtr;
+    size_t len;
+
+    if ((!replayPeek(ctx)) || (ctx->pendingChannel != ARSTREAM2_PCAP_CHANNEL_CONTROL) || (replayWaitTime(ctx) > 0))
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    len = (ctx->pendingSize < (size_t)size) ? ctx->pendingSize : (size_t)size;
+    memcpy(buffer, ctx->pendingData, len);
+    ctx->rtcpPacketCount++;
+    ctx->pending = 0;
+
+    return (int)len;
+}
+
+
+static const struct ARSTREAM2_RtpReceiver_Ops_t replayOps =
+{
+    .streamChannelSetup = replayChannelSetup,
+    .streamChannelTeardown = replayChannelTeardown,
+    .streamChannelRecvMmsg = replayStreamRecvMmsg,
+    .controlChannelSetup = replayChannelSetup,
+    .controlChannelTeardown = replayChannelTeardown,
+    .controlChannelSend = replayControlSend,
+    .controlChannelRead = replayControlRead,
+};
+
+
+static int replayAuCallback(ARSTREAM2_H264_AuFifoItem_t *auItem, void *userPtr)
+{
+    replay_ctx_t *ctx = (replay_ctx_t*)userPtr;
+    int ret = 0;
+
+    ctx->auCount++;
+    ctx->auByteCount += auItem->au.auSize;
+    if ((ctx->outFile) && (auItem->au.auSize > 0))
+    {
+        if (fwrite(auItem->au.buffer->auBuffer, auItem->au.auSize, 1, ctx->outFile) != 1)
+        {
+            ARSAL_PRINT(ARSAL_PRINT_ERROR, TAG, "Output file write failed");
+            ret = -1;
+        }
+    }
+
+    ARSTREAM2_H264_AuFifoUnrefBuffer(ctx->auFifo, auItem->au.buffer);
+    ARSTREAM2_H264_AuFifoPushFreeItem(ctx->auFifo, auItem);
+
+    return ret;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    int idx, c;
+    const char *inputFileName = NULL, *outputFileName = NULL, *captureFileName = NULL;
+    eARSTREAM2_ERROR err = ARSTREAM2_OK;
+    ARSTREAM2_RTP_PacketFifo_t packetFifo;
+    ARSTREAM2_RTP_PacketFifoQueue_t packetFifoQueue;
+    ARSTREAM2_H264_AuFifo_t auFifo;
+    ARSTREAM2_RtpReceiver_Config_t receiverConfig;
+    ARSTREAM2_RtpReceiver_NetConfig_t receiverNetConfig;
+    ARSTREAM2_RtpReceiver_t *receiver = NULL;
+    int packetFifoCreated = 0, auFifoCreated = 0;
+    replay_ctx_t ctx;
+    uint64_t wait, drainStart, elapsed;
+    int shouldStop = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    printf("ARStream2 RTP Capture Replay\n\n");
+
+    while ((c = getopt_long(argc, argv, short_options, long_options, &idx)) != -1)
+    {
+        switch (c)
+        {
+            case 0:
+                break;
+
+            case 'h':
+                usage(argc, argv);
+                exit(0);
+                break;
+
+            case 'i':
+                inputFileName = optarg;
+                break;
+
+            case 's':
+                ctx.speed = atof(optarg);
+                break;
+
+            case 'o':
+                outputFileName = optarg;
+                break;
+
+            case 'c':
+                captureFileName = optarg;
+                break;
+
+            default:
+                usage(argc, argv);
+                exit(1);
+                break;
+        }
+    }
+
+    if (!inputFileName)
+    {
+        usage(argc, argv);
+        exit(1);
+    }
+
+    ctx.reader = ARSTREAM2_PcapReader_New(inputFileName, &err);
+    if (!ctx.reader)
+    {
+        fprintf(stderr, "Failed to open the capture file '%s' (%s)\n", inputFileName, ARSTREAM2_Error_ToString(err));
+        failed = 1;
+    }
+
+    if ((!failed) && (outputFileName))
+    {
+        ctx.outFile = fopen(outputFileName, "wb");
+        if (!ctx.outFile)
+        {
+            fprintf(stderr, "Failed to open the output file '%s'\n", outputFileName);
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        if (ARSTREAM2_RTP_PacketFifoInit(&packetFifo, REPLAY_PACKET_FIFO_ITEM_COUNT, REPLAY_PACKET_FIFO_BUFFER_COUNT,
+                                         ARSTREAM2_RTP_MTU_PAYLOAD_SIZE, REPLAY_PACKET_FIFO_JUMBO_BUFFER_COUNT,
+                                         ARSTREAM2_RTP_MAX_PAYLOAD_SIZE) != 0)
+        {
+            fprintf(stderr, "Packet FIFO allocation failed\n");
+            failed = 1;
+        }
+        else
+        {
+            packetFifoCreated = 1;
+            if (ARSTREAM2_RTP_PacketFifoAddQueue(&packetFifo, &packetFifoQueue) != 0)
+            {
+                fprintf(stderr, "Packet FIFO queue allocation failed\n");
+                failed = 1;
+            }
+        }
+    }
+
+    if (!failed)
+    {
+        if (ARSTREAM2_H264_AuFifoInit(&auFifo, REPLAY_AU_FIFO_ITEM_COUNT, REPLAY_AU_FIFO_ITEM_NALU_COUNT,
+                                      REPLAY_AU_FIFO_BUFFER_COUNT, REPLAY_AU_BUFFER_SIZE,
+                                      REPLAY_AU_METADATA_BUFFER_SIZE, REPLAY_AU_USER_DATA_BUFFER_SIZE,
+                                      sizeof(ARSTREAM2_H264_VideoStats_t)) != 0)
+        {
+            fprintf(stderr, "Access unit FIFO allocation failed\n");
+            failed = 1;
+        }
+        else
+        {
+            auFifoCreated = 1;
+            ctx.auFifo = &auFifo;
+        }
+    }
+
+    if (!failed)
+    {
+        memset(&receiverConfig, 0, sizeof(receiverConfig));
+        memset(&receiverNetConfig, 0, sizeof(receiverNetConfig));
+        receiverConfig.canonicalName = "ARStream2RtpReplay";
+        receiverConfig.applicationName = "ARStream2RtpReplay";
+        receiverConfig.packetFifo = &packetFifo;
+        receiverConfig.packetFifoQueue = &packetFifoQueue;
+        receiverConfig.auFifo = &auFifo;
+        receiverConfig.auCallback = replayAuCallback;
+        receiverConfig.auCallbackUserPtr = &ctx;
+        receiverConfig.insertStartCodes = 1;
+        receiverConfig.generateReceiverReports = 1;
+        receiverConfig.captureFileName = captureFileName;
+        receiverNetConfig.serverStreamPort = ARSTREAM2_RTP_SENDER_DEFAULT_SERVER_STREAM_PORT;
+        receiverNetConfig.serverControlPort = ARSTREAM2_RTP_SENDER_DEFAULT_SERVER_CONTROL_PORT;
+        receiverNetConfig.ops = &replayOps;
+        receiverNetConfig.opsUserPtr = &ctx;
+
+        receiver = ARSTREAM2_RtpReceiver_New(&receiverConfig, &receiverNetConfig, NULL, &err);
+        if (!receiver)
+        {
+            fprintf(stderr, "Failed to create the receiver (%s)\n", ARSTREAM2_Error_ToString(err));
+            failed = 1;
+        }
+    }
+
+    if (!failed)
+    {
+        printf("Replaying '%s' %s\n\n", inputFileName, (ctx.speed > 0.) ? "with the capture timing" : "as fast as possible");
+
+        while ((!shouldStop) && (replayPeek(&ctx)))
+        {
+            ARSTREAM2_RtpReceiver_ProcessRtp(receiver, 0, NULL, NULL, NULL, &shouldStop, NULL, 0);
+            ARSTREAM2_RtpReceiver_ProcessRtcp(receiver, 0, NULL, NULL, NULL, &shouldStop);
+
+            wait = replayWaitTime(&ctx);
+            if (wait > 0)
+            {
+                usleep((wait < REPLAY_MAX_SLEEP_US) ? (useconds_t)wait : REPLAY_MAX_SLEEP_US);
+            }
+        }
+
+        /* let the reordering timeouts expire to output the last access units */
+        drainStart = getTimeUs();
+        while ((packetFifoQueue.count > 0) && (getTimeUs() - drainStart < REPLAY_DRAIN_TIMEOUT_US))
+        {
+            ARSTREAM2_RtpReceiver_ProcessRtp(receiver, 0, NULL, NULL, NULL, &shouldStop, NULL, 0);
+            usleep(1000);
+        }
+        elapsed = getTimeUs() - ctx.startTime;
+        ARSTREAM2_RtpReceiver_ProcessEnd(receiver, 0);
+
+        printf("Capture duration:     %.3f s\n", (double)(ctx.lastCaptureTime - ctx.firstCaptureTime) / 1000000.);
+        printf("Replay duration:      %.3f s (x%.1f)\n", (double)elapsed / 1000000.,
+               (elapsed > 0) ? (double)(ctx.lastCaptureTime - ctx.firstCaptureTime) / (double)elapsed : 0.);
+        printf("RTP packets:          %llu (%llu bytes, %.0f packets/s)\n", (long long unsigned int)ctx.rtpPacketCount,
+               (long long unsigned int)ctx.rtpByteCount, (elapsed > 0) ? (double)ctx.rtpPacketCount * 1000000. / (double)elapsed : 0.);
+        printf("RTCP packets:         %llu received, %llu sent\n", (long long unsigned int)ctx.rtcpPacketCount,
+               (long long unsigned int)ctx.rtcpSentCount);
+        printf("Skipped packets:      %llu\n", (long long unsigned int)ctx.reader->skippedCount);
+        printf("Lost packets:         %u\n", receiver->rtcpReceiverContext.packetsLost);
+        printf("Access units:         %llu (%llu bytes)\n", (long long unsigned int)ctx.auCount,
+               (long long unsigned int)ctx.auByteCount);
+    }
+
+    if (receiver)
+    {
+        ARSTREAM2_RtpReceiver_Stop(receiver);
+        ARSTREAM2_RtpReceiver_Delete(&receiver);
+    }
+    if (auFifoCreated)
+    {
+        ARSTREAM2_H264_AuFifoFree(&auFifo);
+    }
+    if (packetFifoCreated)
+    {
+        ARSTREAM2_RTP_PacketFifoFree(&packetFifo);
+    }
+    if (ctx.outFile)
+    {
+        fclose(ctx.outFile);
+    }
+    if (ctx.reader)
+    {
+        ARSTREAM2_PcapReader_Delete(&ctx.reader);
+    }
+
+    return (failed) ? 1 : 0;
+}
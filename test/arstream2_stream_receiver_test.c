@@ -42,7 +42,7 @@
 #define BD_AU_BUFFER_SIZE (1920 * 1088 * 3 / 2)
 
 
-static const char short_options[] = "hk:K:i:s:c:S:C:";
+static const char short_options[] = "hk:K:i:s:c:S:C:f";
 
 
 static const struct option
@@ -55,6 +55,7 @@ long_options[] = {
     { "sctrlp"          , required_argument  , NULL, 'c' },
     { "cstrmp"          , required_argument  , NULL, 'S' },
     { "cctrlp"          , required_argument  , NULL, 'C' },
+    { "filter-thread"   , no_argument        , NULL, 'f' },
     { 0, 0, 0, 0 }
 };
 
@@ -231,6 +232,7 @@ static void usage(int argc, char *argv[])
             "-c | --sctrlp <port>               Server control port for direct RTP/AVP reception\n"
             "-S | --cstrmp <port>               Client stream port for direct RTP/AVP reception\n"
             "-C | --cctrlp <port>               Client control port for direct RTP/AVP reception\n"
+            "-f | --filter-thread               Run the H.264 filter in a dedicated thread\n"
             "\n",
             argv[0]);
 }
@@ -314,6 +316,10 @@ int main(int argc, char *argv[])
                 sscanf(optarg, "%d", &deviceManager->arstream2ClientControlPort);
                 break;
 
+            case 'f':
+                deviceManager->filterThread = 1;
+                break;
+
             default:
                 usage(argc, argv);
                 exit(-1);
@@ -773,6 +779,7 @@ int startVideo(BD_MANAGER_t *deviceManager)
         streamReceiverConfig.generateSkippedPSlices = 1;
         streamReceiverConfig.generateFirstGrayIFrame = 1;
         streamReceiverConfig.debugPath = "./streamdebug";
+        streamReceiverConfig.filterThread = deviceManager->filterThread;
 
         err = ARSTREAM2_StreamReceiver_Init(&deviceManager->streamReceiver, &streamReceiverConfig, &streamReceiverNetConfig, NULL);
         if (err != ARSTREAM2_OK)
@@ -32,6 +32,7 @@ typedef struct
     int arstream2ClientStreamPort;
     int arstream2ClientControlPort;
     int arstream2MaxPacketSize;
+    int filterThread;
     uint8_t *auBuffer;
     uint32_t auBufferSize;
 
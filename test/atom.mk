@@ -14,4 +14,76 @@ LOCAL_SRC_FILES := arstream2_stream_receiver_test.c
 
 include $(BUILD_EXECUTABLE)
 
+include $(CLEAR_VARS)
+
+LOCAL_CATEGORY_PATH := test
+LOCAL_MODULE := ARStream2RtpPacketFifoBench
+LOCAL_DESCRIPTION := Parrot Streaming Library - RTP packet FIFO benchmark program
+
+LOCAL_LIBRARIES := libARSAL libARStream2
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../src
+
+LOCAL_SRC_FILES := arstream2_rtp_packet_fifo_bench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_CATEGORY_PATH := test
+LOCAL_MODULE := ARStream2H264ParserBench
+LOCAL_DESCRIPTION := Parrot Streaming Library - H.264 parser benchmark program
+
+LOCAL_LIBRARIES := libARSAL libARStream2
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../src
+
+LOCAL_SRC_FILES := arstream2_h264_parser_bench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_CATEGORY_PATH := test
+LOCAL_MODULE := ARStream2RtpReplay
+LOCAL_DESCRIPTION := Parrot Streaming Library - RTP capture replay program
+
+LOCAL_LIBRARIES := libARSAL libARStream2
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../src
+
+LOCAL_SRC_FILES := arstream2_rtp_replay.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_CATEGORY_PATH := test
+LOCAL_MODULE := ARStream2LoopbackBench
+LOCAL_DESCRIPTION := Parrot Streaming Library - Loopback end-to-end benchmark program
+
+LOCAL_LIBRARIES := libARSAL libARStream2
+
+LOCAL_SRC_FILES := arstream2_loopback_bench.c
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_CATEGORY_PATH := test
+LOCAL_MODULE := ARStream2MicroBench
+LOCAL_DESCRIPTION := Parrot Streaming Library - Microbenchmark program
+
+LOCAL_LIBRARIES := libARSAL libARStream2
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../src
+
+ifeq ("$(TARGET_OS)","linux")
+  LOCAL_CFLAGS += -DHAS_MMSG
+endif
+
+LOCAL_SRC_FILES := arstream2_micro_bench.c
+
+include $(BUILD_EXECUTABLE)
+
 endif